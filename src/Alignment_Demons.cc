@@ -1,6 +1,8 @@
 //Alignment_Demons.cc - A part of DICOMautomaton 2026. Written by hal clark.
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <exception>
 #include <optional>
 #include <fstream>
@@ -32,6 +34,7 @@
 #include "Alignment_Rigid.h"
 #include "Alignment_Field.h"
 #include "Alignment_Demons.h"
+#include "Image_Resampling.h"
 
 #if __has_include(<sycl/sycl.hpp>)
     #include <sycl/sycl.hpp>
@@ -49,6 +52,268 @@
 using namespace AlignViaDemonsHelpers;
 
 
+namespace {
+
+// Truncated Gaussian weights for the given sigma (in voxels), or no weights if no smoothing is needed.
+std::vector<double> gaussian_weights(double sigma){
+    if(!std::isfinite(sigma) || (sigma <= 0.0)) return {};
+    const int64_t radius = std::max<int64_t>(1, static_cast<int64_t>(3.0 * sigma));
+    std::vector<double> w(static_cast<size_t>(2 * radius + 1));
+    for(int64_t i = -radius; i <= radius; ++i){
+        w[static_cast<size_t>(i + radius)] = std::exp(-0.5 * static_cast<double>(i * i) / (sigma * sigma));
+    }
+    return w;
+}
+
+// Smooth 'width' interleaved lines of 'n' samples each, where sample i of line j is data[i * stride + j].
+//
+// Non-finite samples and samples beyond the ends of the lines are omitted and the remaining weights are renormalized.
+// Samples without any finite support are left unaltered. The inner loops run over contiguous memory.
+template <class T>
+void smooth_lines(T *data, int64_t n, int64_t stride, int64_t width,
+                  const std::vector<double> &w, std::vector<double> &scratch){
+    const int64_t radius = static_cast<int64_t>(w.size() / 2);
+    scratch.assign(static_cast<size_t>(2 * n * width), 0.0);
+    double *sum = scratch.data();
+    double *wsum = sum + n * width;
+
+    const auto accumulate = [](const T *src, double *s, double *ws, double weight, int64_t N){
+        for(int64_t j = 0; j < N; ++j){
+            const double v = static_cast<double>(src[j]);
+            const bool finite = std::isfinite(v);
+            s[j] += finite ? weight * v : 0.0;
+            ws[j] += finite ? weight : 0.0;
+        }
+    };
+
+    // Each weight is applied to all samples at once. When the lines are packed (i.e., stride == width) the samples
+    // can be traversed as a single contiguous run.
+    for(int64_t k = -radius; k <= radius; ++k){
+        const int64_t i_lo = std::max<int64_t>(0, -k);
+        const int64_t i_hi = std::min<int64_t>(n, n - k);
+        if(i_hi <= i_lo) continue;
+        const double weight = w[static_cast<size_t>(k + radius)];
+        if(stride == width){
+            accumulate(data + (i_lo + k) * stride, sum + i_lo * width, wsum + i_lo * width, weight, (i_hi - i_lo) * width);
+        }else{
+            for(int64_t i = i_lo; i < i_hi; ++i){
+                accumulate(data + (i + k) * stride, sum + i * width, wsum + i * width, weight, width);
+            }
+        }
+    }
+
+    for(int64_t i = 0; i < n; ++i){
+        T *dst = data + i * stride;
+        const double *s = sum + i * width;
+        const double *ws = wsum + i * width;
+        for(int64_t j = 0; j < width; ++j){
+            if(0.0 < ws[j]) dst[j] = static_cast<T>(s[j] / ws[j]);
+        }
+    }
+    return;
+}
+
+// Separable Gaussian smoothing of a dense, channel-interleaved volume using the CPU thread pool. Sigmas are in voxels
+// along the column (x), row (y), and slice (z) axes, respectively. Non-positive sigmas skip the corresponding axis.
+template <class T>
+void smooth_volume(T *data, int64_t slices, int64_t rows, int64_t cols, int64_t channels,
+                   const std::array<double, 3> &sigma){
+    if( (slices <= 0) || (rows <= 0) || (cols <= 0) || (channels <= 0) ) return;
+
+    // The number of interleaved lines filtered together, sized so the accumulators remain in cache, and the minimum
+    // number of samples handled by each task.
+    constexpr int64_t block_width = 256;
+    constexpr int64_t task_samples = 4096;
+    const int64_t row_width = cols * channels;
+    const int64_t plane_width = rows * row_width;
+
+    const auto w_x = gaussian_weights(sigma[0]);
+    const auto w_y = gaussian_weights(sigma[1]);
+    const auto w_z = gaussian_weights(sigma[2]);
+
+    // Along columns. Each image row is a single line of interleaved channels. Rows are processed in batches.
+    if( (1 < cols) && !w_x.empty() ){
+        const int64_t N_rows = slices * rows;
+        const int64_t batch = std::max<int64_t>(1, task_samples / row_width);
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t r = 0; r < N_rows; r += batch){
+            wq.submit_task([&,r]() -> void {
+                std::vector<double> scratch;
+                for(int64_t rr = r; rr < std::min(N_rows, r + batch); ++rr){
+                    smooth_lines(data + rr * row_width, cols, channels, channels, w_x, scratch);
+                }
+            });
+        }
+    } // Wait for all tasks to complete.
+
+    // Along rows. Lines are the (column, channel) pairs of each image, which are contiguous.
+    if( (1 < rows) && !w_y.empty() ){
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t z = 0; z < slices; ++z){
+            for(int64_t j = 0; j < row_width; j += block_width){
+                wq.submit_task([&,z,j]() -> void {
+                    std::vector<double> scratch;
+                    smooth_lines(data + z * plane_width + j, rows, row_width, std::min(block_width, row_width - j), w_y, scratch);
+                });
+            }
+        }
+    } // Wait for all tasks to complete.
+
+    // Along slices. Lines are the (row, column, channel) tuples, which are contiguous within each image.
+    if( (1 < slices) && !w_z.empty() ){
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t j = 0; j < plane_width; j += block_width){
+            wq.submit_task([&,j]() -> void {
+                std::vector<double> scratch;
+                smooth_lines(data + j, slices, plane_width, std::min(block_width, plane_width - j), w_z, scratch);
+            });
+        }
+    } // Wait for all tasks to complete.
+
+    return;
+}
+
+// The minimum number of voxels along an axis in a downsampled pyramid level.
+constexpr int64_t min_pyramid_extent = 8;
+
+// Which axes (x, y, z) of the volume should be halved to form the next coarser pyramid level. Axes that are too short
+// are not halved, nor are axes whose voxels are already much coarser than along other axes (e.g., thick CT slices), so
+// that coarser levels become more isotropic.
+std::array<bool, 3> pyramid_halving(const demons_volume<float> &v){
+    const std::array<int64_t, 3> extent = {{ v.cols, v.rows, v.slices }};
+    const std::array<double, 3> spacing = {{ v.pxl_dx, v.pxl_dy, v.pxl_dz }};
+
+    double finest = std::numeric_limits<double>::infinity();
+    for(size_t i = 0; i < 3; ++i){
+        if(1 < extent[i]) finest = std::min(finest, std::abs(spacing[i]));
+    }
+
+    std::array<bool, 3> halve = {{ false, false, false }};
+    for(size_t i = 0; i < 3; ++i){
+        halve[i] = (2 * min_pyramid_extent <= extent[i])
+                && (std::abs(spacing[i]) <= 2.0 * finest);
+    }
+    return halve;
+}
+
+// Form the next coarser pyramid level. The volume is smoothed along the halved axes and adjacent voxel pairs are then
+// averaged, so coarse voxel i is centred on fine voxel (2i + 0.5) along halved axes. Non-finite voxels are ignored.
+demons_volume<float> downsample_volume(const demons_volume<float> &in, const std::array<bool, 3> &halve){
+    const int64_t fx = halve[0] ? 2 : 1;
+    const int64_t fy = halve[1] ? 2 : 1;
+    const int64_t fz = halve[2] ? 2 : 1;
+
+    auto smoothed = in;
+    smooth_volume(smoothed.data.data(), in.slices, in.rows, in.cols, in.channels,
+                  {{ halve[0] ? 1.0 : 0.0, halve[1] ? 1.0 : 0.0, halve[2] ? 1.0 : 0.0 }});
+
+    demons_volume<float> out;
+    out.slices = (in.slices + fz - 1) / fz;
+    out.rows = (in.rows + fy - 1) / fy;
+    out.cols = (in.cols + fx - 1) / fx;
+    out.channels = in.channels;
+    out.pxl_dx = in.pxl_dx * static_cast<double>(fx);
+    out.pxl_dy = in.pxl_dy * static_cast<double>(fy);
+    out.pxl_dz = in.pxl_dz * static_cast<double>(fz);
+    out.data.resize(static_cast<size_t>(out.slices * out.rows * out.cols * out.channels));
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    {
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t z = 0; z < out.slices; ++z){
+            wq.submit_task([&,z]() -> void {
+                for(int64_t y = 0; y < out.rows; ++y){
+                    for(int64_t x = 0; x < out.cols; ++x){
+                        for(int64_t c = 0; c < out.channels; ++c){
+                            double sum = 0.0;
+                            int64_t N = 0;
+                            for(int64_t zz = z * fz; zz < std::min(in.slices, (z + 1) * fz); ++zz){
+                                for(int64_t yy = y * fy; yy < std::min(in.rows, (y + 1) * fy); ++yy){
+                                    for(int64_t xx = x * fx; xx < std::min(in.cols, (x + 1) * fx); ++xx){
+                                        const float v = smoothed.data[vol_idx(smoothed, zz, yy, xx, c)];
+                                        if(std::isfinite(v)){
+                                            sum += static_cast<double>(v);
+                                            ++N;
+                                        }
+                                    }
+                                }
+                            }
+                            out.data[vol_idx(out, z, y, x, c)] = (0 < N) ? static_cast<float>(sum / static_cast<double>(N)) : nan;
+                        }
+                    }
+                }
+            });
+        }
+    } // Wait for all tasks to complete.
+    return out;
+}
+
+// Interpolate a displacement field from a coarser pyramid level onto the grid of the next finer level. Displacements
+// are in physical units, so they are interpolated without rescaling. The field is extended beyond its edges.
+demons_volume<double> upsample_field(const demons_volume<double> &coarse,
+                                     const demons_volume<float> &fine,
+                                     const std::array<bool, 3> &halve){
+    demons_volume<double> out;
+    out.slices = fine.slices;
+    out.rows = fine.rows;
+    out.cols = fine.cols;
+    out.channels = coarse.channels;
+    out.pxl_dx = fine.pxl_dx;
+    out.pxl_dy = fine.pxl_dy;
+    out.pxl_dz = fine.pxl_dz;
+    out.data.resize(static_cast<size_t>(out.slices * out.rows * out.cols * out.channels));
+
+    // Fractional coarse index, clamped to the coarse grid, along with the bracketing indices.
+    struct sample_t {
+        int64_t i0;
+        int64_t i1;
+        double t;
+    };
+    const auto coarse_sample = [](int64_t i, bool halved, int64_t N) -> sample_t {
+        double s = halved ? (static_cast<double>(i) - 0.5) * 0.5 : static_cast<double>(i);
+        s = std::clamp(s, 0.0, static_cast<double>(N - 1));
+        const auto i0 = static_cast<int64_t>(std::floor(s));
+        const auto i1 = std::min<int64_t>(N - 1, i0 + 1);
+        return { i0, i1, s - static_cast<double>(i0) };
+    };
+
+    {
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t z = 0; z < out.slices; ++z){
+            wq.submit_task([&,z]() -> void {
+                const auto sz = coarse_sample(z, halve[2], coarse.slices);
+                for(int64_t y = 0; y < out.rows; ++y){
+                    const auto sy = coarse_sample(y, halve[1], coarse.rows);
+                    for(int64_t x = 0; x < out.cols; ++x){
+                        const auto sx = coarse_sample(x, halve[0], coarse.cols);
+                        for(int64_t c = 0; c < out.channels; ++c){
+                            double sum = 0.0;
+                            double wsum = 0.0;
+                            for(const auto &[zz, wz] : { std::make_pair(sz.i0, 1.0 - sz.t), std::make_pair(sz.i1, sz.t) }){
+                                for(const auto &[yy, wy] : { std::make_pair(sy.i0, 1.0 - sy.t), std::make_pair(sy.i1, sy.t) }){
+                                    for(const auto &[xx, wx] : { std::make_pair(sx.i0, 1.0 - sx.t), std::make_pair(sx.i1, sx.t) }){
+                                        const double w = wz * wy * wx;
+                                        const double v = coarse.data[vol_idx(coarse, zz, yy, xx, c)];
+                                        if( (0.0 < w) && std::isfinite(v) ){
+                                            sum += w * v;
+                                            wsum += w;
+                                        }
+                                    }
+                                }
+                            }
+                            out.data[vol_idx(out, z, y, x, c)] = (0.0 < wsum) ? (sum / wsum) : 0.0;
+                        }
+                    }
+                }
+            });
+        }
+    } // Wait for all tasks to complete.
+    return out;
+}
+
+} // namespace
+
+
 class sycl_demons_engine {
 public:
     sycl_demons_engine(const demons_volume<float> &fixed_in,
@@ -84,7 +349,7 @@ public:
         this->compute_update_and_mse(mse, n_voxels);
 
         if(params.use_diffeomorphic && params.update_field_smoothing_sigma > 0.0){
-            this->smooth_on_device(this->update_dev, params.update_field_smoothing_sigma);
+            this->smooth_field(this->update_dev, params.update_field_smoothing_sigma);
         }
 
         if(!params.use_diffeomorphic){
@@ -100,13 +365,27 @@ public:
         }
 
         if(params.deformation_field_smoothing_sigma > 0.0){
-            this->smooth_on_device(this->deformation_dev, params.deformation_field_smoothing_sigma);
+            this->smooth_field(this->deformation_dev, params.deformation_field_smoothing_sigma);
         }
 
         this->warp_moving();
         return mse;
     }
 
+    // Replace the deformation field, e.g., with one upsampled from a coarser pyramid level, and re-warp the moving
+    // image accordingly.
+    void import_deformation_volume(const demons_volume<double> &d){
+        if( (d.slices != fixed.slices)
+        ||  (d.rows != fixed.rows)
+        ||  (d.cols != fixed.cols)
+        ||  (d.channels != 3)
+        ||  (d.data.size() != this->vector_volume_size) ){
+            throw std::invalid_argument("Deformation field does not match the registration grid");
+        }
+        this->copy_host_vector_to_device(d, this->deformation_dev);
+        this->warp_moving();
+    }
+
     demons_volume<double> export_deformation_volume(){
         this->copy_device_vector_to_host(this->deformation_dev, deformation);
         return deformation;
@@ -132,8 +411,8 @@ private:
     double *gradient_dev = nullptr;
     double *update_dev = nullptr;
     double *deformation_dev = nullptr;
-    double *mse_term_dev = nullptr;
-    int64_t *valid_dev = nullptr;
+    double *mse_sum_dev = nullptr;
+    int64_t *valid_count_dev = nullptr;
     std::exception_ptr async_exception = nullptr;
     std::mutex async_exception_mutex;
 
@@ -175,8 +454,8 @@ private:
         gradient_dev = dcma_sycl::malloc_shared<double>(this->vector_volume_size, q);
         update_dev = dcma_sycl::malloc_shared<double>(this->vector_volume_size, q);
         deformation_dev = dcma_sycl::malloc_shared<double>(this->vector_volume_size, q);
-        mse_term_dev = dcma_sycl::malloc_shared<double>(this->scalar_voxel_count, q);
-        valid_dev = dcma_sycl::malloc_shared<int64_t>(this->scalar_voxel_count, q);
+        mse_sum_dev = dcma_sycl::malloc_shared<double>(1UL, q);
+        valid_count_dev = dcma_sycl::malloc_shared<int64_t>(1UL, q);
 
         std::copy(fixed.data.begin(), fixed.data.end(), fixed_dev);
         std::copy(moving.data.begin(), moving.data.end(), moving_dev);
@@ -193,16 +472,16 @@ private:
         if(gradient_dev) dcma_sycl::free(gradient_dev, q);
         if(update_dev) dcma_sycl::free(update_dev, q);
         if(deformation_dev) dcma_sycl::free(deformation_dev, q);
-        if(mse_term_dev) dcma_sycl::free(mse_term_dev, q);
-        if(valid_dev) dcma_sycl::free(valid_dev, q);
+        if(mse_sum_dev) dcma_sycl::free(mse_sum_dev, q);
+        if(valid_count_dev) dcma_sycl::free(valid_count_dev, q);
         fixed_dev = nullptr;
         moving_dev = nullptr;
         warped_dev = nullptr;
         gradient_dev = nullptr;
         update_dev = nullptr;
         deformation_dev = nullptr;
-        mse_term_dev = nullptr;
-        valid_dev = nullptr;
+        mse_sum_dev = nullptr;
+        valid_count_dev = nullptr;
     }
 
     void compute_gradient(){
@@ -279,24 +558,24 @@ private:
         const int64_t channels = fixed.channels;
         const double normalization = params.normalization_factor;
         const double max_update = params.max_update_magnitude;
+        const dcma_sycl::property_list init_to_identity{ dcma_sycl::property::reduction::initialize_to_identity() };
 
         q.parallel_for(dcma_sycl::range<3>(static_cast<size_t>(slices),
                                            static_cast<size_t>(rows),
                                            static_cast<size_t>(cols)),
-                       [=](dcma_sycl::id<3> id){
+                       dcma_sycl::reduction(mse_sum_dev, dcma_sycl::plus<double>(), init_to_identity),
+                       dcma_sycl::reduction(valid_count_dev, dcma_sycl::plus<int64_t>(), init_to_identity),
+                       [=](dcma_sycl::id<3> id, auto &mse_sum, auto &valid_count){
             const int64_t z = static_cast<int64_t>(id[0]);
             const int64_t y = static_cast<int64_t>(id[1]);
             const int64_t x = static_cast<int64_t>(id[2]);
 
-            const auto vox_idx = static_cast<size_t>((z * rows + y) * cols + x);
             const auto f_idx = static_cast<size_t>(((z * rows + y) * cols + x) * channels);
             const auto g_idx = static_cast<size_t>(((z * rows + y) * cols + x) * 3);
             const float fixed_val = fixed_dev[f_idx];
             const float moving_val = warped_dev[f_idx];
 
             if(!(dcma_sycl::isfinite(fixed_val) && dcma_sycl::isfinite(moving_val))){
-                mse_term_dev[vox_idx] = 0.0;
-                valid_dev[vox_idx] = 0;
                 update_dev[g_idx + 0] = 0.0;
                 update_dev[g_idx + 1] = 0.0;
                 update_dev[g_idx + 2] = 0.0;
@@ -304,8 +583,8 @@ private:
             }
 
             const double diff = static_cast<double>(fixed_val) - static_cast<double>(moving_val);
-            mse_term_dev[vox_idx] = diff * diff;
-            valid_dev[vox_idx] = 1;
+            mse_sum += diff * diff;
+            ++valid_count;
 
             double ux = 0.0, uy = 0.0, uz = 0.0;
             const double gx = gradient_dev[g_idx + 0];
@@ -331,12 +610,8 @@ private:
         });
         this->wait_and_rethrow();
 
-        mse = 0.0;
-        n_voxels = 0;
-        for(size_t i = 0; i < this->scalar_voxel_count; ++i){
-            mse += mse_term_dev[i];
-            n_voxels += valid_dev[i];
-        }
+        mse = *mse_sum_dev;
+        n_voxels = *valid_count_dev;
         if(n_voxels > 0){
             mse /= static_cast<double>(n_voxels);
         }
@@ -557,148 +832,16 @@ private:
         std::copy(host.data.begin(), host.data.end(), dev);
     }
 
-    // Smooth a vector field on device using separable 3D Gaussian filtering.
-    // Allocates a temporary buffer, applies smoothing along each axis in sequence,
-    // and writes the result back to the input buffer.
-    void smooth_on_device(double *field_dev, double sigma_mm){
+    // Smooth a vector field using separable 3D Gaussian filtering. Shared allocations are host-accessible, so the
+    // passes run on the CPU thread pool, which processes many contiguous lines at once rather than gathering strided
+    // samples voxel-by-voxel.
+    void smooth_field(double *field_dev, double sigma_mm){
         if(sigma_mm <= 0.0){
             return;
         }
-        const int64_t slices = fixed.slices;
-        const int64_t rows = fixed.rows;
-        const int64_t cols = fixed.cols;
-        const double pxl_dx = fixed.pxl_dx;
-        const double pxl_dy = fixed.pxl_dy;
-        const double pxl_dz = fixed.pxl_dz;
-        // Compute kernel radii based on 3-sigma rule.
-        const int64_t rad_x = std::max<int64_t>(1, static_cast<int64_t>(3.0 * sigma_mm / pxl_dx));
-        const int64_t rad_y = std::max<int64_t>(1, static_cast<int64_t>(3.0 * sigma_mm / pxl_dy));
-        const int64_t rad_z = std::max<int64_t>(1, static_cast<int64_t>(3.0 * sigma_mm / pxl_dz));
-        // Sigma in pixel units for each axis.
-        const double sigma_x = sigma_mm / pxl_dx;
-        const double sigma_y = sigma_mm / pxl_dy;
-        const double sigma_z = sigma_mm / pxl_dz;
-        // Allocate temporary buffer on device for intermediate results.
-        double *temp_dev = dcma_sycl::malloc_shared<double>(this->vector_volume_size, q);
-        if(temp_dev == nullptr){
-            throw std::runtime_error("Failed to allocate temporary device buffer for smoothing");
-        }
-        // Helper lambda to create 1D Gaussian weights (precomputed on host, copied to device).
-        auto make_kernel = [](int64_t radius, double sigma_pix) -> std::vector<double> {
-            std::vector<double> k(2 * radius + 1);
-            double sum = 0.0;
-            for(int64_t i = -radius; i <= radius; ++i){
-                double v = dcma_sycl::exp(-0.5 * (static_cast<double>(i * i)) / (sigma_pix * sigma_pix));
-                k[static_cast<size_t>(i + radius)] = v;
-                sum += v;
-            }
-            for(auto &v : k) v /= sum;
-            return k;
-        };
-        const auto kernel_x = make_kernel(rad_x, sigma_x);
-        const auto kernel_y = make_kernel(rad_y, sigma_y);
-        const auto kernel_z = make_kernel(rad_z, sigma_z);
-        // Copy kernels to device (using shared memory for simplicity).
-        double *kx_dev = dcma_sycl::malloc_shared<double>(kernel_x.size(), q);
-        double *ky_dev = dcma_sycl::malloc_shared<double>(kernel_y.size(), q);
-        double *kz_dev = dcma_sycl::malloc_shared<double>(kernel_z.size(), q);
-        std::copy(kernel_x.begin(), kernel_x.end(), kx_dev);
-        std::copy(kernel_y.begin(), kernel_y.end(), ky_dev);
-        std::copy(kernel_z.begin(), kernel_z.end(), kz_dev);
-        // Pass 1: smooth along x (columns).
-        q.parallel_for(dcma_sycl::range<3>(static_cast<size_t>(slices),
-                                           static_cast<size_t>(rows),
-                                           static_cast<size_t>(cols)),
-                       [=](dcma_sycl::id<3> id){
-            const int64_t z = static_cast<int64_t>(id[0]);
-            const int64_t y = static_cast<int64_t>(id[1]);
-            const int64_t x = static_cast<int64_t>(id[2]);
-            const auto vidx = [=](int64_t zz, int64_t yy, int64_t xx, int64_t c) -> size_t {
-                return static_cast<size_t>(((zz * rows + yy) * cols + xx) * 3 + c);
-            };
-            for(int64_t c = 0; c < 3; ++c){
-                double sum = 0.0;
-                double wsum = 0.0;
-                for(int64_t k = -rad_x; k <= rad_x; ++k){
-                    int64_t xx = x + k;
-                    if(xx >= 0 && xx < cols){
-                        double v = field_dev[vidx(z, y, xx, c)];
-                        if(dcma_sycl::isfinite(v)){
-                            double w = kx_dev[static_cast<size_t>(k + rad_x)];
-                            sum += w * v;
-                            wsum += w;
-                        }
-                    }
-                }
-                temp_dev[vidx(z, y, x, c)] = (wsum > 0.0) ? (sum / wsum) : field_dev[vidx(z, y, x, c)];
-            }
-        });
-        this->wait_and_rethrow();
-        // Pass 2: smooth along y (rows), reading from temp_dev, writing to field_dev.
-        q.parallel_for(dcma_sycl::range<3>(static_cast<size_t>(slices),
-                                           static_cast<size_t>(rows),
-                                           static_cast<size_t>(cols)),
-                       [=](dcma_sycl::id<3> id){
-            const int64_t z = static_cast<int64_t>(id[0]);
-            const int64_t y = static_cast<int64_t>(id[1]);
-            const int64_t x = static_cast<int64_t>(id[2]);
-            const auto vidx = [=](int64_t zz, int64_t yy, int64_t xx, int64_t c) -> size_t {
-                return static_cast<size_t>(((zz * rows + yy) * cols + xx) * 3 + c);
-            };
-            for(int64_t c = 0; c < 3; ++c){
-                double sum = 0.0;
-                double wsum = 0.0;
-                for(int64_t k = -rad_y; k <= rad_y; ++k){
-                    int64_t yy = y + k;
-                    if(yy >= 0 && yy < rows){
-                        double v = temp_dev[vidx(z, yy, x, c)];
-                        if(dcma_sycl::isfinite(v)){
-                            double w = ky_dev[static_cast<size_t>(k + rad_y)];
-                            sum += w * v;
-                            wsum += w;
-                        }
-                    }
-                }
-                field_dev[vidx(z, y, x, c)] = (wsum > 0.0) ? (sum / wsum) : temp_dev[vidx(z, y, x, c)];
-            }
-        });
-        this->wait_and_rethrow();
-        // Pass 3: smooth along z (slices), reading from field_dev, writing to temp_dev.
-        q.parallel_for(dcma_sycl::range<3>(static_cast<size_t>(slices),
-                                           static_cast<size_t>(rows),
-                                           static_cast<size_t>(cols)),
-                       [=](dcma_sycl::id<3> id){
-            const int64_t z = static_cast<int64_t>(id[0]);
-            const int64_t y = static_cast<int64_t>(id[1]);
-            const int64_t x = static_cast<int64_t>(id[2]);
-            const auto vidx = [=](int64_t zz, int64_t yy, int64_t xx, int64_t c) -> size_t {
-                return static_cast<size_t>(((zz * rows + yy) * cols + xx) * 3 + c);
-            };
-            for(int64_t c = 0; c < 3; ++c){
-                double sum = 0.0;
-                double wsum = 0.0;
-                for(int64_t k = -rad_z; k <= rad_z; ++k){
-                    int64_t zz = z + k;
-                    if(zz >= 0 && zz < slices){
-                        double v = field_dev[vidx(zz, y, x, c)];
-                        if(dcma_sycl::isfinite(v)){
-                            double w = kz_dev[static_cast<size_t>(k + rad_z)];
-                            sum += w * v;
-                            wsum += w;
-                        }
-                    }
-                }
-                temp_dev[vidx(z, y, x, c)] = (wsum > 0.0) ? (sum / wsum) : field_dev[vidx(z, y, x, c)];
-            }
-        });
         this->wait_and_rethrow();
-        // Copy result back to field_dev.
-        std::copy(temp_dev, temp_dev + this->vector_volume_size, field_dev);
-        // Free temporary buffers.
-        dcma_sycl::free(temp_dev, q);
-        dcma_sycl::free(kx_dev, q);
-        dcma_sycl::free(ky_dev, q);
-        dcma_sycl::free(kz_dev, q);
+        smooth_volume(field_dev, fixed.slices, fixed.rows, fixed.cols, 3,
+                      {{ sigma_mm / fixed.pxl_dx, sigma_mm / fixed.pxl_dy, sigma_mm / fixed.pxl_dz }});
     }
 
 };
@@ -714,6 +857,20 @@ AlignViaDemonsHelpers::resample_image_to_reference_grid(
     if(moving.images.empty() || reference.images.empty()){
         throw std::invalid_argument("Cannot resample: image collection is empty");
     }
+
+    // Regular grids are resampled a row at a time using a precomputed affine mapping between the grids.
+    if(const auto grid = Prepare_Resampling_Grid(moving); grid){
+        planar_image_collection<float, double> resampled = reference;
+        {
+            work_queue<std::function<void(void)>> wq;
+            for(auto &img : resampled.images){
+                wq.submit_task([&grid, &img]() -> void {
+                    Resample_Image(grid.value(), img, -1, std::numeric_limits<float>::quiet_NaN());
+                });
+            }
+        } // Wait for all tasks to complete.
+        return resampled;
+    }
     
     // Create output image collection matching reference geometry
     planar_image_collection<float, double> resampled;
@@ -971,31 +1128,72 @@ AlignViaDemons(AlignViaDemonsParams & params,
             moving = histogram_match(moving, stationary, params.histogram_bins, params.histogram_outlier_fraction);
         }
 
-        // Step 3: Initialize demons algorithm
-        const auto fixed_vol = marshal_collection_to_volume(stationary);
-        const auto moving_vol = marshal_collection_to_volume(moving);
-        sycl_demons_engine engine(fixed_vol, moving_vol, params);
+        // Step 3: Build the image pyramids. Level 0 is full resolution; higher levels are coarser.
+        if(params.pyramid_levels < 1){
+            throw std::invalid_argument("At least one pyramid level is required");
+        }
+        std::vector<demons_volume<float>> fixed_pyramid;
+        std::vector<demons_volume<float>> moving_pyramid;
+        std::vector<std::array<bool, 3>> halving; // How level l+1 was derived from level l.
+        fixed_pyramid.emplace_back( marshal_collection_to_volume(stationary) );
+        moving_pyramid.emplace_back( marshal_collection_to_volume(moving) );
+        while(static_cast<int64_t>(fixed_pyramid.size()) < params.pyramid_levels){
+            const auto halve = pyramid_halving(fixed_pyramid.back());
+            if(!halve[0] && !halve[1] && !halve[2]){
+                if(params.verbosity >= 1){
+                    YLOGINFO("Images are too small for additional pyramid levels; using " << fixed_pyramid.size());
+                }
+                break;
+            }
+            halving.push_back(halve);
+            fixed_pyramid.emplace_back( downsample_volume(fixed_pyramid.back(), halve) );
+            moving_pyramid.emplace_back( downsample_volume(moving_pyramid.back(), halve) );
+        }
+        const auto N_levels = static_cast<int64_t>(fixed_pyramid.size());
+
+        // Step 4: Iterative demons algorithm, from coarse to fine.
+        std::optional<demons_volume<double>> deformation_vol;
+        for(int64_t level = N_levels - 1; 0 <= level; --level){
+            // Per-level controls are ordered from the coarsest requested level to the finest.
+            const auto l = static_cast<size_t>(params.pyramid_levels - 1 - level);
+            const auto max_iterations = (l < params.level_max_iterations.size())
+                                      ? params.level_max_iterations[l] : params.max_iterations;
+            const auto convergence_threshold = (l < params.level_convergence_thresholds.size())
+                                             ? params.level_convergence_thresholds[l] : params.convergence_threshold;
+
+            const auto &fixed_vol = fixed_pyramid[static_cast<size_t>(level)];
+            const auto &moving_vol = moving_pyramid[static_cast<size_t>(level)];
+            if( (params.verbosity >= 1) && (1 < N_levels) ){
+                YLOGINFO("Pyramid level " << level << ": " << fixed_vol.cols << " x " << fixed_vol.rows
+                         << " x " << fixed_vol.slices << " voxels");
+            }
 
-        // Step 4: Iterative demons algorithm
-        double prev_mse = std::numeric_limits<double>::infinity();
-        for(int64_t iter = 0; iter < params.max_iterations; ++iter){
-            const double mse = engine.compute_single_iteration();
-            if(params.verbosity >= 1){
-                YLOGINFO("Iteration " << iter << ": MSE = " << mse);
+            sycl_demons_engine engine(fixed_vol, moving_vol, params);
+            if(deformation_vol){
+                engine.import_deformation_volume( upsample_field(deformation_vol.value(), fixed_vol,
+                                                                 halving[static_cast<size_t>(level)]) );
             }
 
-            const double mse_change = std::abs(prev_mse - mse);
-            if(mse_change < params.convergence_threshold && iter > 0){
+            double prev_mse = std::numeric_limits<double>::infinity();
+            for(int64_t iter = 0; iter < max_iterations; ++iter){
+                const double mse = engine.compute_single_iteration();
                 if(params.verbosity >= 1){
-                    YLOGINFO("Converged after " << iter << " iterations");
+                    YLOGINFO("Iteration " << iter << ": MSE = " << mse);
                 }
-                break;
+
+                const double mse_change = std::abs(prev_mse - mse);
+                if(mse_change < convergence_threshold && iter > 0){
+                    if(params.verbosity >= 1){
+                        YLOGINFO("Converged after " << iter << " iterations");
+                    }
+                    break;
+                }
+                prev_mse = mse;
             }
-            prev_mse = mse;
+            deformation_vol = engine.export_deformation_volume();
         }
 
-        auto deformation_vol = engine.export_deformation_volume();
-        auto def_coll = marshal_volume_to_collection(deformation_vol, stationary);
+        auto def_coll = marshal_volume_to_collection(deformation_vol.value(), stationary);
         return deformation_field(std::move(def_coll));
 
     }catch(const std::exception &e){
@@ -7,6 +7,7 @@
 #include <functional>
 #include <iosfwd>
 #include <cstdint>
+#include <vector>
 
 #include "YgorMisc.h"         //Needed for FUNCINFO, FUNCWARN, FUNCERR macros.
 #include "YgorLog.h"
@@ -14,6 +15,7 @@
 #include "YgorImages.h"
 
 #include "Alignment_Field.h"
+#include "Voxel_Volume.h"
 
 
 // Parameters for controlling the demons registration algorithm.
@@ -24,6 +26,19 @@ struct AlignViaDemonsParams {
     
     // The convergence threshold. Registration stops when the mean squared error change is below this value.
     double convergence_threshold = 0.001;
+
+    // The number of levels in the coarse-to-fine image pyramid. Each coarser level is Gaussian-smoothed and then
+    // downsampled by a factor of two along every axis that is large enough. Registration begins at the coarsest level
+    // and the deformation field is upsampled to seed each finer level. A single level disables the pyramid.
+    //
+    // Fewer levels are used if the images are too small to downsample further.
+    int64_t pyramid_levels = 1;
+
+    // Per-level overrides for max_iterations and convergence_threshold, ordered from the coarsest level to the finest
+    // (full resolution) level. Missing entries fall back to the values above. If fewer pyramid levels can be created
+    // than requested, the leading (coarsest) entries are ignored.
+    std::vector<int64_t> level_max_iterations;
+    std::vector<double> level_convergence_thresholds;
     
     // The standard deviation (in DICOM units, mm) of the Gaussian kernel used to smooth the deformation field.
     // This controls regularization and ensures smooth deformations.
@@ -167,13 +182,7 @@ marshal_collection_to_volume(const planar_image_collection<T, double> &coll){
         if(img.rows != out.rows || img.columns != out.cols || img.channels != out.channels){
             throw std::invalid_argument("Image collection has inconsistent rows/columns/channels and cannot be marshaled as a rectilinear volume");
         }
-        for(int64_t y = 0; y < out.rows; ++y){
-            for(int64_t x = 0; x < out.cols; ++x){
-                for(int64_t c = 0; c < out.channels; ++c){
-                    out.data[vol_idx(out, z, y, x, c)] = static_cast<T>(img.value(y, x, c));
-                }
-            }
-        }
+        copy_image_to_buffer(img, out.data.data() + vol_idx(out, z, 0, 0, 0));
         ++z;
     }
     return out;
@@ -183,22 +192,20 @@ template <class T>
 planar_image_collection<T, double>
 marshal_volume_to_collection(const demons_volume<T> &vol,
                              const planar_image_collection<float, double> &reference_geometry){
+    if(static_cast<int64_t>(reference_geometry.images.size()) < vol.slices){
+        throw std::runtime_error("Requested image index not present, unable to continue");
+    }
     planar_image_collection<T, double> out;
-    for(int64_t z = 0; z < vol.slices; ++z){
-        const auto &ref_img = get_image(reference_geometry.images, static_cast<size_t>(z));
+    auto ref_it = std::begin(reference_geometry.images);
+    for(int64_t z = 0; z < vol.slices; ++z, ++ref_it){
+        const auto &ref_img = *ref_it;
         planar_image<T, double> img;
         img.init_orientation(ref_img.row_unit, ref_img.col_unit);
         img.init_buffer(vol.rows, vol.cols, vol.channels);
         img.init_spatial(ref_img.pxl_dx, ref_img.pxl_dy, ref_img.pxl_dz, ref_img.anchor, ref_img.offset);
         img.metadata = ref_img.metadata;
-        for(int64_t y = 0; y < vol.rows; ++y){
-            for(int64_t x = 0; x < vol.cols; ++x){
-                for(int64_t c = 0; c < vol.channels; ++c){
-                    img.reference(y, x, c) = vol.data[vol_idx(vol, z, y, x, c)];
-                }
-            }
-        }
-        out.images.push_back(img);
+        copy_buffer_to_image(vol.data.data() + vol_idx(vol, z, 0, 0, 0), img);
+        out.images.emplace_back(std::move(img));
     }
     return out;
 }
@@ -654,3 +654,80 @@ TEST_CASE( "AlignViaDemons convergence threshold stops iteration" ){
     // Should have converged, with MSE substantially reduced.
     CHECK(mse_after < mse_before * 0.5);
 }
+
+
+TEST_CASE( "AlignViaDemons multi-resolution pyramid" ){
+    SUBCASE("large shift is recovered coarse-to-fine"){
+        const int64_t N = 64;
+        const auto blob = [](double shift){
+            return [shift](int64_t, int64_t row, int64_t col){
+                const double dr = row - 32.0;
+                const double dc = col - 32.0 - shift;
+                return static_cast<float>(100.0 * std::exp(-(dr * dr + dc * dc) / 72.0));
+            };
+        };
+        auto stationary = make_test_image_collection(1, N, N, blob(0.0));
+        auto moving = make_test_image_collection(1, N, N, blob(6.0));
+
+        const auto [mse_before, count_before] = compute_mse_and_count(stationary, moving);
+
+        AlignViaDemonsParams params;
+        params.pyramid_levels = 3;
+        params.max_iterations = 0;
+        params.level_max_iterations = { 40, 40, 20 };
+        params.convergence_threshold = 0.0;
+        params.deformation_field_smoothing_sigma = 1.0;
+        params.update_field_smoothing_sigma = 0.0;
+        params.max_update_magnitude = 2.0;
+        params.verbosity = 0;
+
+        auto result = AlignViaDemons(params, moving, stationary);
+        REQUIRE(result.has_value());
+        auto warped = warp_image_with_field(moving, *result);
+        const auto [mse_after, count_after] = compute_mse_and_count(stationary, warped);
+
+        CHECK(mse_after < mse_before * 0.1);
+        CHECK(count_after >= count_before - 8 * N);
+    }
+
+    SUBCASE("small images use fewer levels and the finest level controls"){
+        const int64_t N = 16;
+        auto stationary = make_test_image_collection(1, N, N,
+            [](int64_t, int64_t row, int64_t col){
+                const double dr = row - 8.0;
+                const double dc = col - 8.0;
+                return static_cast<float>(100.0 * std::exp(-(dr * dr + dc * dc) / 6.0));
+            });
+        auto moving = make_test_image_collection(1, N, N,
+            [](int64_t, int64_t row, int64_t col){
+                const double dr = row - 8.0;
+                const double dc = col - 8.0 - 1.0;
+                return static_cast<float>(100.0 * std::exp(-(dr * dr + dc * dc) / 6.0));
+            });
+
+        const auto [mse_before, count_before] = compute_mse_and_count(stationary, moving);
+
+        AlignViaDemonsParams params;
+        params.pyramid_levels = 4;
+        params.max_iterations = 0;
+        params.level_max_iterations = { 0, 0, 0, 100 };
+        params.convergence_threshold = 0.0;
+        params.deformation_field_smoothing_sigma = 0.5;
+        params.update_field_smoothing_sigma = 0.0;
+        params.verbosity = 0;
+
+        auto result = AlignViaDemons(params, moving, stationary);
+        REQUIRE(result.has_value());
+        auto warped = warp_image_with_field(moving, *result);
+        const auto [mse_after, count_after] = compute_mse_and_count(stationary, warped);
+        CHECK(mse_after < mse_before * 0.5);
+    }
+
+    SUBCASE("invalid level count is rejected"){
+        auto img = make_test_image_collection(1, 4, 4, [](int64_t, int64_t, int64_t){ return 1.0f; });
+        AlignViaDemonsParams params;
+        params.pyramid_levels = 0;
+        params.verbosity = 0;
+        CHECK(!AlignViaDemons(params, img, img).has_value());
+    }
+}
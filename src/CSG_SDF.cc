@@ -871,6 +871,51 @@ YLOGINFO("Extrusion: using normal " << normal << " and anchor " << anchor );
     return out;
 }
 
+// Upper bound on the Lipschitz constant of the node's SDF.
+double lipschitz_bound(const node &n){
+    const auto max_child_bound = [&](){
+        double L = 0.0;
+        for(const auto& c_it : n.children){
+            if(c_it) L = std::max<double>(L, lipschitz_bound(*c_it));
+        }
+        return L;
+    };
+
+    // The shapes are all exact distance functions.
+    if( (dynamic_cast<const shape::sphere*>(&n) != nullptr)
+    ||  (dynamic_cast<const shape::aa_box*>(&n) != nullptr)
+    ||  (dynamic_cast<const shape::plane*>(&n) != nullptr)
+    ||  (dynamic_cast<const shape::poly_chain*>(&n) != nullptr) ){
+        return 1.0;
+    }
+
+    // Rigid transformations, offsets, and min/max combinations do not increase the bound.
+    if( (dynamic_cast<const op::translate*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::rotate*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::dilate*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::erode*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::join*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::subtract*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::intersect*>(&n) != nullptr) ){
+        return max_child_bound();
+    }
+
+    // The chamfer term (a + b)/sqrt(2) can change by up to sqrt(2) times as much as either child.
+    if( (dynamic_cast<const op::chamfer_join*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::chamfer_subtract*>(&n) != nullptr)
+    ||  (dynamic_cast<const op::chamfer_intersect*>(&n) != nullptr) ){
+        return std::sqrt(2.0) * max_child_bound();
+    }
+
+    // The distance along the plane normal and the in-plane child SDF vary along orthogonal directions, so combining
+    // them does not increase the bound beyond either.
+    if(dynamic_cast<const op::extrude*>(&n) != nullptr){
+        return std::max<double>(1.0, max_child_bound());
+    }
+
+    return std::numeric_limits<double>::infinity();
+}
+
 
 } // namespace csg
 } // namespace sdf
@@ -213,6 +213,13 @@ std::shared_ptr<node> text(const std::string& text,
 // Convert parsed function nodes to an 'SDF' object that can be evaluated.
 std::shared_ptr<node> build_node(const parsed_function& pf);
 
+// Upper bound on the Lipschitz constant of the node's SDF, i.e., the most the SDF can change per unit distance.
+//
+// Exact distance functions have a bound of 1, but some operations (e.g., chamfer-Booleans) can increase it. If the
+// bound is not known, infinity is returned. The bound can be used to safely skip regions that are known to be far from
+// the surface.
+double lipschitz_bound(const node &n);
+
 } // namespace sdf
 } // namespace csg
 
@@ -0,0 +1,540 @@
+//CSG_SDF_Tape.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file compiles constructive solid geometry (CSG) signed distance function (SDF) node trees into flat
+// instruction tapes that evaluate batches of points.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "YgorMath.h"
+
+#include "CSG_SDF.h"
+#include "CSG_SDF_Tape.h"
+
+// The tape is executed by code compiled once for the baseline instruction set and, where supported, once more for
+// AVX2. The latter is selected at runtime if the processor supports it. FMA is deliberately not enabled so that
+// contraction cannot alter results.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define DCMA_SDF_TAPE_AVX2
+    #define DCMA_SDF_TAPE_BODY inline __attribute__((always_inline))
+#else
+    #define DCMA_SDF_TAPE_BODY inline
+#endif
+
+namespace csg {
+namespace sdf {
+
+namespace {
+
+// Equivalent to std::isfinite(), but expressed as a comparison so it can be vectorized. NaNs compare false.
+inline bool is_finite(double x){
+    return std::abs(x) <= std::numeric_limits<double>::max();
+}
+
+// The coefficients of an affine function, row-major: out_i = m[4i+0]*x + m[4i+1]*y + m[4i+2]*z + m[4i+3].
+//
+// The function is recovered by evaluating it at the origin and the unit vectors.
+template <class F>
+std::array<double, 12> affine_coefficients(F f){
+    const auto t  = f(vec3<double>(0.0, 0.0, 0.0));
+    const auto ex = f(vec3<double>(1.0, 0.0, 0.0)) - t;
+    const auto ey = f(vec3<double>(0.0, 1.0, 0.0)) - t;
+    const auto ez = f(vec3<double>(0.0, 0.0, 1.0)) - t;
+    return { ex.x, ey.x, ez.x, t.x,
+             ex.y, ey.y, ez.y, t.y,
+             ex.z, ey.z, ez.z, t.z };
+}
+
+} // namespace
+
+
+compiled_sdf::compiled_sdf(const std::shared_ptr<node> &root){
+    const auto pos = this->allocate_position();
+    this->result = this->compile(root, pos);
+}
+
+int32_t compiled_sdf::allocate_value(){
+    if(!this->free_values.empty()){
+        const auto reg = this->free_values.back();
+        this->free_values.pop_back();
+        return reg;
+    }
+    this->N_registers += 1;
+    return this->N_registers - 1;
+}
+
+int32_t compiled_sdf::allocate_position(){
+    if(!this->free_positions.empty()){
+        const auto reg = this->free_positions.back();
+        this->free_positions.pop_back();
+        return reg;
+    }
+    this->N_registers += 3;
+    return this->N_registers - 3;
+}
+
+int32_t compiled_sdf::add_constants(std::initializer_list<double> l){
+    const auto offset = static_cast<int32_t>(this->constants.size());
+    this->constants.insert(std::end(this->constants), l);
+    return offset;
+}
+
+void compiled_sdf::emit(opcode op, int32_t out, int32_t in, int32_t param, int32_t count){
+    instruction i;
+    i.op = op;
+    i.out = out;
+    i.in = in;
+    i.param = param;
+    i.count = count;
+    this->tape.emplace_back(i);
+}
+
+// Emit the instructions that evaluate the node at the given position, returning the register holding the result.
+int32_t compiled_sdf::compile(const std::shared_ptr<node> &n, int32_t pos){
+    if(!n){
+        throw std::invalid_argument("compiled_sdf: encountered an invalid node");
+    }
+    const auto N_children = n->children.size();
+    const auto *p = n.get();
+
+    // Shapes.
+    if(const auto *s = dynamic_cast<const shape::sphere*>(p)){
+        const auto out = this->allocate_value();
+        this->emit(opcode::sphere, out, pos, this->add_constants({ s->radius }), 1);
+        return out;
+
+    }else if(const auto *s = dynamic_cast<const shape::aa_box*>(p)){
+        const auto out = this->allocate_value();
+        const auto c = this->add_constants({ std::abs(s->radii.x), std::abs(s->radii.y), std::abs(s->radii.z) });
+        this->emit(opcode::aa_box, out, pos, c, 3);
+        return out;
+
+    }else if(const auto *s = dynamic_cast<const shape::plane*>(p)){
+        const auto out = this->allocate_value();
+        const auto c = this->add_constants({ s->point.x, s->point.y, s->point.z,
+                                             s->normal.x, s->normal.y, s->normal.z });
+        this->emit(opcode::plane, out, pos, c, 6);
+        return out;
+
+    }else if(const auto *s = dynamic_cast<const shape::poly_chain*>(p)){
+        if(s->vertices.size() < 2UL){
+            throw std::invalid_argument("poly_chain: this operation requires at least two vertices");
+        }
+        // Each segment is stored as {A, B - A, (B - A).(B - A)}.
+        const auto c = this->add_constants({ s->radius });
+        for(size_t i = 1; i < s->vertices.size(); ++i){
+            const auto A = s->vertices[i - 1];
+            const auto dBA = s->vertices[i] - A;
+            this->add_constants({ A.x, A.y, A.z, dBA.x, dBA.y, dBA.z, dBA.Dot(dBA) });
+        }
+        const auto out = this->allocate_value();
+        this->emit(opcode::poly_chain, out, pos, c, static_cast<int32_t>(s->vertices.size() - 1));
+        return out;
+    }
+
+    // Operations on positions.
+    if(const auto *o = dynamic_cast<const op::translate*>(p)){
+        if(N_children != 1UL){
+            throw std::invalid_argument("translate: this operation requires a single child node");
+        }
+        const auto l_pos = this->allocate_position();
+        this->emit(opcode::translate, l_pos, pos, this->add_constants({ o->dR.x, o->dR.y, o->dR.z }), 3);
+        const auto out = this->compile(n->children[0], l_pos);
+        this->free_positions.emplace_back(l_pos);
+        return out;
+
+    }else if(const auto *o = dynamic_cast<const op::rotate*>(p)){
+        if(N_children != 1UL){
+            throw std::invalid_argument("rotate: this operation requires a single child node");
+        }
+        const auto m = affine_coefficients([&](vec3<double> r){ o->rot.apply_to(r); return r; });
+        const auto c = static_cast<int32_t>(this->constants.size());
+        this->constants.insert(std::end(this->constants), std::begin(m), std::end(m));
+
+        const auto l_pos = this->allocate_position();
+        this->emit(opcode::affine, l_pos, pos, c, 12);
+        const auto out = this->compile(n->children[0], l_pos);
+        this->free_positions.emplace_back(l_pos);
+        return out;
+
+    }else if(const auto *o = dynamic_cast<const op::extrude*>(p)){
+        if(N_children != 1UL){
+            throw std::invalid_argument("extrude: this operation requires a single child node");
+        }
+        const auto m = affine_coefficients([&](const vec3<double> &r){ return o->cut_plane.Project_Onto_Plane_Orthogonally(r); });
+        const auto c_proj = static_cast<int32_t>(this->constants.size());
+        this->constants.insert(std::end(this->constants), std::begin(m), std::end(m));
+
+        const auto d0 = o->cut_plane.Get_Signed_Distance_To_Point(vec3<double>(0.0, 0.0, 0.0));
+        const auto c_dist = this->add_constants({ o->cut_plane.Get_Signed_Distance_To_Point(vec3<double>(1.0, 0.0, 0.0)) - d0,
+                                                  o->cut_plane.Get_Signed_Distance_To_Point(vec3<double>(0.0, 1.0, 0.0)) - d0,
+                                                  o->cut_plane.Get_Signed_Distance_To_Point(vec3<double>(0.0, 0.0, 1.0)) - d0,
+                                                  d0 });
+        const auto dist = this->allocate_value();
+        this->emit(opcode::linear, dist, pos, c_dist, 4);
+
+        const auto l_pos = this->allocate_position();
+        this->emit(opcode::affine, l_pos, pos, c_proj, 12);
+        const auto out = this->compile(n->children[0], l_pos);
+        this->free_positions.emplace_back(l_pos);
+
+        this->emit(opcode::extrude, out, dist, this->add_constants({ o->distance }), 1);
+        this->free_values.emplace_back(dist);
+        return out;
+    }
+
+    // Operations on distances.
+    if( (dynamic_cast<const op::join*>(p) != nullptr)
+    ||  (dynamic_cast<const op::intersect*>(p) != nullptr) ){
+        const bool is_join = (dynamic_cast<const op::join*>(p) != nullptr);
+        if(is_join && (N_children == 0UL)){
+            throw std::invalid_argument("join: no children present");
+        }
+        if(!is_join && (N_children < 2UL)){
+            throw std::invalid_argument("intersect: insufficient children present, cannot compute intersect");
+        }
+        // Accumulate each child in turn so that child registers can be reused.
+        const auto out = this->compile(n->children[0], pos);
+        for(size_t i = 1; i < N_children; ++i){
+            const auto l_out = this->compile(n->children[i], pos);
+            this->emit(is_join ? opcode::join : opcode::intersect, out, l_out);
+            this->free_values.emplace_back(l_out);
+        }
+        return out;
+
+    }else if( (dynamic_cast<const op::subtract*>(p) != nullptr)
+          ||  (dynamic_cast<const op::chamfer_subtract*>(p) != nullptr) ){
+        const auto *cs = dynamic_cast<const op::chamfer_subtract*>(p);
+        if(N_children != 2UL){
+            throw std::invalid_argument( (cs == nullptr) ? "subtract: incorrect number of children present, subtraction requires exactly two"
+                                                         : "chamfer_subtract: incorrect number of children present, chamfer_subtraction requires exactly two" );
+        }
+        const auto out = this->compile(n->children[0], pos);
+        const auto l_out = this->compile(n->children[1], pos);
+        if(cs == nullptr){
+            this->emit(opcode::subtract, out, l_out);
+        }else{
+            this->emit(opcode::chamfer_subtract, out, l_out, this->add_constants({ cs->thickness }), 1);
+        }
+        this->free_values.emplace_back(l_out);
+        return out;
+
+    }else if( (dynamic_cast<const op::chamfer_join*>(p) != nullptr)
+          ||  (dynamic_cast<const op::chamfer_intersect*>(p) != nullptr) ){
+        const auto *cj = dynamic_cast<const op::chamfer_join*>(p);
+        const auto *ci = dynamic_cast<const op::chamfer_intersect*>(p);
+        if(N_children == 0UL){
+            throw std::invalid_argument( (cj != nullptr) ? "chamfer_join: no children present, cannot compute chamfer_join"
+                                                         : "chamfer_intersect: no children present, cannot compute chamfer_intersect" );
+        }
+        // Every pair of children is combined, so all children are needed at once.
+        std::vector<int32_t> l_outs;
+        for(const auto& c : n->children){
+            l_outs.emplace_back( this->compile(c, pos) );
+        }
+        const auto ops = static_cast<int32_t>(this->operands.size());
+        this->operands.insert(std::end(this->operands), std::begin(l_outs), std::end(l_outs));
+        this->add_constants({ (cj != nullptr) ? cj->thickness : ci->thickness });
+
+        const auto out = this->allocate_value();
+        this->emit( (cj != nullptr) ? opcode::chamfer_join : opcode::chamfer_intersect,
+                    out, static_cast<int32_t>(this->constants.size() - 1), ops, static_cast<int32_t>(l_outs.size()) );
+        for(const auto &r : l_outs) this->free_values.emplace_back(r);
+        return out;
+
+    }else if( (dynamic_cast<const op::dilate*>(p) != nullptr)
+          ||  (dynamic_cast<const op::erode*>(p) != nullptr) ){
+        const auto *d = dynamic_cast<const op::dilate*>(p);
+        const auto *e = dynamic_cast<const op::erode*>(p);
+        if(N_children != 1UL){
+            throw std::invalid_argument( (d != nullptr) ? "dilate: this operation requires a single child node"
+                                                        : "erode: this operation requires a single child node" );
+        }
+        const auto out = this->compile(n->children[0], pos);
+        this->emit(opcode::offset, out, out, this->add_constants({ (d != nullptr) ? -(d->offset) : e->offset }), 1);
+        return out;
+    }
+
+    // Anything else is evaluated directly.
+    const auto out = this->allocate_value();
+    this->emit(opcode::fallback, out, pos, static_cast<int32_t>(this->fallback_nodes.size()), 1);
+    this->fallback_nodes.emplace_back(n);
+    return out;
+}
+
+// Execute the tape for all lanes of the registers.
+//
+// Lane loops mirror the arithmetic and comparisons of the corresponding node::evaluate_sdf() implementations, e.g.,
+// std::max(a, b) is written as (a < b) ? b : a, so that NaNs and ties are handled the same way. Registers read by an
+// instruction never overlap the registers it writes, except for in-place updates of 'out'.
+struct tape_executor {
+    static DCMA_SDF_TAPE_BODY void execute(const compiled_sdf &t, double *regs);
+};
+
+inline void tape_executor::execute(const compiled_sdf &t, double *regs){
+    constexpr int64_t lanes = compiled_sdf::lanes;
+    using opcode = compiled_sdf::opcode;
+    const auto reg = [regs](int32_t r){ return regs + static_cast<int64_t>(r) * lanes; };
+    const double *k = t.constants.data();
+
+    for(const auto &i : t.tape){
+        double *__restrict out = reg(i.out);
+        const double *__restrict x = reg(i.in);
+        const double *__restrict y = reg(i.in + 1);
+        const double *__restrict z = reg(i.in + 2);
+        const double *c = k + i.param;
+
+        switch(i.op){
+            case opcode::sphere:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j] = std::sqrt(x[j] * x[j] + y[j] * y[j] + z[j] * z[j]) - c[0];
+                }
+                break;
+
+            case opcode::aa_box:
+                for(int64_t j = 0; j < lanes; ++j){
+                    const double dx = std::abs(x[j]) - c[0];
+                    const double dy = std::abs(y[j]) - c[1];
+                    const double dz = std::abs(z[j]) - c[2];
+                    const double px = (dx < 0.0) ? 0.0 : dx;
+                    const double py = (dy < 0.0) ? 0.0 : dy;
+                    const double pz = (dz < 0.0) ? 0.0 : dz;
+                    double m = dx;
+                    m = (m < dy) ? dy : m;
+                    m = (m < dz) ? dz : m;
+                    m = (0.0 < m) ? 0.0 : m;
+                    out[j] = std::sqrt(px * px + py * py + pz * pz) + m;
+                }
+                break;
+
+            case opcode::plane:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j] = (x[j] - c[0]) * c[3] + (y[j] - c[1]) * c[4] + (z[j] - c[2]) * c[5];
+                }
+                break;
+
+            case opcode::poly_chain:
+                {
+                    // The nearest segment is found using squared distances. Since the square root is monotonic, this
+                    // is equivalent to comparing distances.
+                    std::fill(out, out + lanes, std::numeric_limits<double>::infinity());
+                    for(int32_t s = 0; s < i.count; ++s){
+                        const double *seg = c + 1 + 7 * s;
+                        for(int64_t j = 0; j < lanes; ++j){
+                            const double ax = x[j] - seg[0];
+                            const double ay = y[j] - seg[1];
+                            const double az = z[j] - seg[2];
+                            double u = (ax * seg[3] + ay * seg[4] + az * seg[5]) / seg[6];
+                            u = (u < 0.0) ? 0.0 : ((1.0 < u) ? 1.0 : u);
+                            const double dx = ax - seg[3] * u;
+                            const double dy = ay - seg[4] * u;
+                            const double dz = az - seg[5] * u;
+                            const double sq_dist = dx * dx + dy * dy + dz * dz;
+                            out[j] = (sq_dist < out[j]) ? sq_dist : out[j];
+                        }
+                    }
+                    bool all_finite = true;
+                    for(int64_t j = 0; j < lanes; ++j){
+                        out[j] = std::sqrt(out[j]) - c[0];
+                        all_finite &= is_finite(out[j]);
+                    }
+                    if(!all_finite){
+                        throw std::runtime_error("poly_chain: computed non-finite SDF");
+                    }
+                }
+                break;
+
+            case opcode::translate:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j]             = x[j] - c[0];
+                    out[j + lanes]     = y[j] - c[1];
+                    out[j + 2 * lanes] = z[j] - c[2];
+                }
+                break;
+
+            case opcode::affine:
+                for(int64_t j = 0; j < lanes; ++j){
+                    const double px = x[j];
+                    const double py = y[j];
+                    const double pz = z[j];
+                    out[j]             = c[0] * px + c[1] * py + c[2]  * pz + c[3];
+                    out[j + lanes]     = c[4] * px + c[5] * py + c[6]  * pz + c[7];
+                    out[j + 2 * lanes] = c[8] * px + c[9] * py + c[10] * pz + c[11];
+                }
+                break;
+
+            case opcode::linear:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j] = c[0] * x[j] + c[1] * y[j] + c[2] * z[j] + c[3];
+                }
+                break;
+
+            case opcode::join:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j] = (!is_finite(out[j]) || (x[j] < out[j])) ? x[j] : out[j];
+                }
+                break;
+
+            case opcode::intersect:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j] = (!is_finite(out[j]) || (out[j] < x[j])) ? x[j] : out[j];
+                }
+                break;
+
+            case opcode::subtract:
+                for(int64_t j = 0; j < lanes; ++j){
+                    const double b = -x[j];
+                    out[j] = (out[j] < b) ? b : out[j];
+                }
+                break;
+
+            case opcode::chamfer_subtract:
+                for(int64_t j = 0; j < lanes; ++j){
+                    const double a = out[j];
+                    const double b = -x[j];
+                    const double e = (a - x[j] + c[0]) * std::sqrt(0.5);
+                    double m = a;
+                    m = (m < b) ? b : m;
+                    m = (m < e) ? e : m;
+                    out[j] = m;
+                }
+                break;
+
+            case opcode::chamfer_join:
+            case opcode::chamfer_intersect:
+                {
+                    // For these instructions, 'in' indexes the thickness and 'param' the operand registers.
+                    const bool is_join = (i.op == opcode::chamfer_join);
+                    const double thickness = k[i.in];
+                    const int32_t *ops = t.operands.data() + i.param;
+                    std::fill(out, out + lanes, (is_join ? 1.0 : -1.0) * std::numeric_limits<double>::infinity());
+                    for(int32_t a_i = 0; a_i < i.count; ++a_i){
+                        for(int32_t b_i = a_i + 1; b_i < i.count; ++b_i){
+                            const double *A = reg(ops[a_i]);
+                            const double *B = reg(ops[b_i]);
+                            if(is_join){
+                                for(int64_t j = 0; j < lanes; ++j){
+                                    const double e = (A[j] + B[j] - thickness) * std::sqrt(0.5);
+                                    double m = A[j];
+                                    m = (B[j] < m) ? B[j] : m;
+                                    m = (e < m) ? e : m;
+                                    out[j] = (m < out[j]) ? m : out[j];
+                                }
+                            }else{
+                                for(int64_t j = 0; j < lanes; ++j){
+                                    const double e = (A[j] + B[j] + thickness) * std::sqrt(0.5);
+                                    double m = A[j];
+                                    m = (m < B[j]) ? B[j] : m;
+                                    m = (m < e) ? e : m;
+                                    out[j] = (out[j] < m) ? m : out[j];
+                                }
+                            }
+                        }
+                    }
+                }
+                break;
+
+            case opcode::offset:
+                for(int64_t j = 0; j < lanes; ++j){
+                    out[j] = out[j] + c[0];
+                }
+                break;
+
+            case opcode::extrude:
+                for(int64_t j = 0; j < lanes; ++j){
+                    const double c_sdf = out[j];
+                    const double dz = std::abs(x[j]) - c[0];
+                    double m = (dz < c_sdf) ? c_sdf : dz;
+                    m = (m < 0.0) ? m : 0.0;
+                    out[j] = m + std::hypot( (0.0 < dz) ? dz : 0.0, (0.0 < c_sdf) ? c_sdf : 0.0 );
+                }
+                break;
+
+            case opcode::fallback:
+                {
+                    const auto &f = t.fallback_nodes[static_cast<size_t>(i.param)];
+                    for(int64_t j = 0; j < lanes; ++j){
+                        out[j] = f->evaluate_sdf( vec3<double>(x[j], y[j], z[j]) );
+                    }
+                }
+                break;
+        }
+    }
+    return;
+}
+
+namespace {
+
+void execute_baseline(const compiled_sdf &t, double *regs){ tape_executor::execute(t, regs); }
+
+#if defined(DCMA_SDF_TAPE_AVX2)
+__attribute__((target("avx2"))) void execute_avx2(const compiled_sdf &t, double *regs){ tape_executor::execute(t, regs); }
+#endif
+
+using executor_t = void (*)(const compiled_sdf &, double *);
+executor_t active_executor(){
+    static const executor_t executor = []() -> executor_t {
+#if defined(DCMA_SDF_TAPE_AVX2)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) return &execute_avx2;
+#endif
+        return &execute_baseline;
+    }();
+    return executor;
+}
+
+} // namespace
+
+void compiled_sdf::evaluate(const vec3<double> *pos, double *out, int64_t n) const {
+    if(n <= 0) return;
+    const auto execute = active_executor();
+
+    // Registers are reused between calls on the same thread.
+    thread_local std::vector<double> regs;
+    regs.resize(static_cast<size_t>(this->N_registers) * static_cast<size_t>(lanes));
+
+    // The evaluation position is always held in the first three registers. Partial batches are padded by repeating the
+    // last point, so every lane holds a valid position.
+    double *x = regs.data();
+    double *y = x + lanes;
+    double *z = y + lanes;
+    const double *res = regs.data() + static_cast<int64_t>(this->result) * lanes;
+    for(int64_t b = 0; b < n; b += lanes){
+        const auto l_n = std::min<int64_t>(lanes, n - b);
+        for(int64_t j = 0; j < lanes; ++j){
+            const auto &p = pos[b + std::min<int64_t>(j, l_n - 1)];
+            x[j] = p.x;
+            y[j] = p.y;
+            z[j] = p.z;
+        }
+        execute(*this, regs.data());
+        std::copy(res, res + l_n, out + b);
+    }
+    return;
+}
+
+double compiled_sdf::evaluate(const vec3<double> &pos) const {
+    double out = std::numeric_limits<double>::quiet_NaN();
+    this->evaluate(&pos, &out, 1);
+    return out;
+}
+
+int64_t compiled_sdf::instruction_count() const {
+    return static_cast<int64_t>(this->tape.size());
+}
+
+int64_t compiled_sdf::register_count() const {
+    return static_cast<int64_t>(this->N_registers);
+}
+
+} // namespace sdf
+} // namespace csg
+
@@ -0,0 +1,211 @@
+//CSG_SDF_Tape_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the compiled SDF evaluator defined in CSG_SDF_Tape.cc and the Lipschitz bounds
+// (defined in CSG_SDF.cc) that it is paired with.
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorMath.h"
+
+#include "CSG_SDF.h"
+#include "CSG_SDF_Tape.h"
+
+using namespace csg::sdf;
+
+// Compare the compiled and direct evaluation at a cloud of points.
+static
+void
+require_equivalent(const std::shared_ptr<node> &root, int64_t N_points = 1000){
+    std::mt19937 re(12345);
+    std::uniform_real_distribution<double> rd(-12.0, 12.0);
+    std::vector<vec3<double>> pos;
+    for(int64_t i = 0; i < N_points; ++i){
+        pos.emplace_back( rd(re), rd(re), rd(re) );
+    }
+
+    const compiled_sdf tape(root);
+    std::vector<double> out(pos.size());
+    tape.evaluate(pos.data(), out.data(), static_cast<int64_t>(pos.size()));
+    for(size_t i = 0; i < pos.size(); ++i){
+        const auto expected = root->evaluate_sdf(pos[i]);
+        if(std::isfinite(expected)){
+            REQUIRE( out[i] == doctest::Approx(expected).epsilon(1E-9) );
+        }else{
+            REQUIRE( out[i] == expected );
+        }
+    }
+    REQUIRE( tape.evaluate(pos.back()) == out.back() );
+}
+
+// A node type the compiler does not know about.
+struct custom_node : public node {
+    double evaluate_sdf(const vec3<double>& pos) const override {
+        return std::abs(pos.x) + std::abs(pos.y) + std::abs(pos.z) - 3.0;
+    }
+    aa_bbox evaluate_aa_bbox() const override {
+        return aa_bbox();
+    }
+};
+
+template <class T, class... Args>
+static
+std::shared_ptr<node>
+make(std::initializer_list<std::shared_ptr<node>> children, Args&&... args){
+    std::shared_ptr<node> n = std::make_shared<T>(std::forward<Args>(args)...);
+    n->children = children;
+    return n;
+}
+
+TEST_CASE( "compiled_sdf" ){
+    const auto ball = make<shape::sphere>({}, 4.0);
+    const auto box = make<shape::aa_box>({}, vec3<double>(3.0, -2.0, 5.0));
+    const auto pln = make<shape::plane>({}, vec3<double>(1.0, 2.0, 3.0), vec3<double>(1.0, 1.0, 0.0), 10.0);
+    const auto chain = make<shape::poly_chain>({}, 1.5, std::vector<vec3<double>>{ vec3<double>(0.0, 0.0, 0.0),
+                                                                                   vec3<double>(5.0, 1.0, 0.0),
+                                                                                   vec3<double>(5.0, 6.0, -2.0) });
+
+    SUBCASE("shapes"){
+        require_equivalent(ball);
+        require_equivalent(box);
+        require_equivalent(pln);
+        require_equivalent(chain);
+    }
+
+    SUBCASE("transformations"){
+        const auto moved = make<op::translate>({ box }, vec3<double>(1.0, -2.0, 3.0));
+        require_equivalent(moved);
+        require_equivalent(make<op::rotate>({ moved }, vec3<double>(1.0, 2.0, 3.0), 0.7));
+        require_equivalent(make<op::dilate>({ chain }, 0.5));
+        require_equivalent(make<op::erode>({ box }, 0.5));
+        require_equivalent(make<op::extrude>({ make<op::translate>({ ball }, vec3<double>(0.0, 1.0, 0.0)) },
+                                             2.0, plane<double>(vec3<double>(0.0, 0.3, 1.0), vec3<double>(0.0, 0.0, 1.0))));
+    }
+
+    SUBCASE("Booleans"){
+        require_equivalent(make<op::join>({ ball, box, chain }));
+        require_equivalent(make<op::subtract>({ box, ball }));
+        require_equivalent(make<op::intersect>({ ball, box, pln }));
+        require_equivalent(make<op::chamfer_join>({ ball, box, chain }, 0.8));
+        require_equivalent(make<op::chamfer_subtract>({ box, ball }, 0.8));
+        require_equivalent(make<op::chamfer_intersect>({ ball, box }, 0.8));
+        require_equivalent(make<op::chamfer_join>({ ball }, 0.8));
+    }
+
+    SUBCASE("nested trees reuse registers"){
+        std::shared_ptr<node> root = make<op::join>({});
+        for(int64_t i = 0; i < 50; ++i){
+            const auto d = static_cast<double>(i);
+            root->children.emplace_back( make<op::translate>({ make<op::subtract>({ box, ball }) }, vec3<double>(d, -d, 0.5 * d)) );
+        }
+        require_equivalent(root);
+        REQUIRE( compiled_sdf(root).register_count() < 20 );
+
+        require_equivalent(text("DCMA 2026", 0.5), 300);
+    }
+
+    SUBCASE("unrecognized nodes are evaluated directly"){
+        const std::shared_ptr<node> custom = std::make_shared<custom_node>();
+        require_equivalent(custom);
+        require_equivalent(make<op::chamfer_subtract>({ make<op::rotate>({ custom }, vec3<double>(0.0, 0.0, 1.0), 0.3), ball }, 0.5));
+    }
+
+    SUBCASE("malformed trees are rejected"){
+        REQUIRE_THROWS_AS( compiled_sdf(make<op::join>({})), std::invalid_argument );
+        REQUIRE_THROWS_AS( compiled_sdf(make<op::intersect>({ ball })), std::invalid_argument );
+        REQUIRE_THROWS_AS( compiled_sdf(make<op::subtract>({ ball })), std::invalid_argument );
+        REQUIRE_THROWS_AS( compiled_sdf(make<op::translate>({ ball, box }, vec3<double>(1.0, 0.0, 0.0))), std::invalid_argument );
+        REQUIRE_THROWS_AS( compiled_sdf(make<shape::poly_chain>({}, 1.0, std::vector<vec3<double>>{ vec3<double>() })), std::invalid_argument );
+        REQUIRE_THROWS_AS( compiled_sdf(std::shared_ptr<node>()), std::invalid_argument );
+    }
+}
+
+
+// Require that the SDF never changes faster than the bound between pairs of nearby points.
+static
+void
+require_lipschitz(const std::shared_ptr<node> &root, double L, int64_t N_pairs = 2000){
+    std::mt19937 re(54321);
+    std::uniform_real_distribution<double> rd(-12.0, 12.0);
+    std::uniform_real_distribution<double> rs(-0.5, 0.5);
+    for(int64_t i = 0; i < N_pairs; ++i){
+        const vec3<double> A( rd(re), rd(re), rd(re) );
+        const vec3<double> B = A + vec3<double>( rs(re), rs(re), rs(re) );
+        const auto dsdf = std::abs(root->evaluate_sdf(A) - root->evaluate_sdf(B));
+        REQUIRE( dsdf <= L * A.distance(B) * (1.0 + 1E-9) + 1E-12 );
+    }
+}
+
+TEST_CASE( "lipschitz_bound" ){
+    const auto ball = make<shape::sphere>({}, 4.0);
+    const auto box = make<shape::aa_box>({}, vec3<double>(3.0, 2.0, 5.0));
+    const auto pln = make<shape::plane>({}, vec3<double>(1.0, 2.0, 3.0), vec3<double>(1.0, 1.0, 0.0), 10.0);
+    const auto chain = make<shape::poly_chain>({}, 1.5, std::vector<vec3<double>>{ vec3<double>(0.0, 0.0, 0.0),
+                                                                                   vec3<double>(5.0, 1.0, 0.0),
+                                                                                   vec3<double>(5.0, 6.0, -2.0) });
+    const auto cut = plane<double>(vec3<double>(0.0, 0.3, 1.0), vec3<double>(0.0, 0.0, 1.0));
+    const auto sqrt2 = std::sqrt(2.0);
+
+    SUBCASE("shapes are exact distance functions"){
+        for(const auto &n : { ball, box, pln, chain }){
+            REQUIRE( lipschitz_bound(*n) == 1.0 );
+            require_lipschitz(n, 1.0);
+        }
+    }
+
+    SUBCASE("transformations and min/max combinations do not increase the bound"){
+        const auto moved = make<op::translate>({ box }, vec3<double>(1.0, -2.0, 3.0));
+        const auto turned = make<op::rotate>({ moved }, vec3<double>(1.0, 2.0, 3.0), 0.7);
+        for(const auto &n : { moved,
+                              turned,
+                              make<op::dilate>({ chain }, 0.5),
+                              make<op::erode>({ box }, 0.5),
+                              make<op::join>({ ball, turned, chain }),
+                              make<op::subtract>({ box, ball }),
+                              make<op::intersect>({ ball, box }) }){
+            REQUIRE( lipschitz_bound(*n) == 1.0 );
+            require_lipschitz(n, 1.0);
+        }
+    }
+
+    SUBCASE("chamfer-Booleans scale the bound"){
+        for(const auto &n : { make<op::chamfer_join>({ ball, box }, 0.8),
+                              make<op::chamfer_subtract>({ box, ball }, 0.8),
+                              make<op::chamfer_intersect>({ ball, box }, 0.8) }){
+            REQUIRE( lipschitz_bound(*n) == doctest::Approx(sqrt2) );
+            require_lipschitz(n, lipschitz_bound(*n));
+        }
+
+        // Nested chamfers compound, even through transformations and plain Booleans.
+        const auto inner = make<op::chamfer_join>({ ball, box }, 0.8);
+        const auto outer = make<op::chamfer_subtract>({ make<op::join>({ make<op::translate>({ inner }, vec3<double>(1.0, 0.0, 0.0)), chain }),
+                                                        ball }, 0.5);
+        REQUIRE( lipschitz_bound(*outer) == doctest::Approx(2.0) );
+        require_lipschitz(outer, lipschitz_bound(*outer));
+    }
+
+    SUBCASE("extrusions are bounded by the larger of the child and the plane distance"){
+        const auto plain = make<op::extrude>({ ball }, 2.0, cut);
+        REQUIRE( lipschitz_bound(*plain) == 1.0 );
+        require_lipschitz(plain, 1.0);
+
+        const auto chamfered = make<op::extrude>({ make<op::chamfer_join>({ ball, box }, 0.8) }, 2.0, cut);
+        REQUIRE( lipschitz_bound(*chamfered) == doctest::Approx(sqrt2) );
+        require_lipschitz(chamfered, lipschitz_bound(*chamfered));
+    }
+
+    SUBCASE("unrecognized nodes have an unknown bound"){
+        const std::shared_ptr<node> custom = std::make_shared<custom_node>();
+        REQUIRE( lipschitz_bound(*custom) == std::numeric_limits<double>::infinity() );
+        REQUIRE( lipschitz_bound(*make<op::join>({ ball, custom })) == std::numeric_limits<double>::infinity() );
+        REQUIRE( lipschitz_bound(*make<op::chamfer_join>({ custom, box }, 0.8)) == std::numeric_limits<double>::infinity() );
+        REQUIRE( lipschitz_bound(*make<op::extrude>({ custom }, 2.0, cut)) == std::numeric_limits<double>::infinity() );
+    }
+}
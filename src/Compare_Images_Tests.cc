@@ -0,0 +1,174 @@
+//Compare_Images_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the image comparisons defined in YgorImages_Functors/Compute/Compare_Images.cc.
+// The regular-grid search is compared against the general implementation, which walks rectangular wavefronts through
+// the planar image adjacency.
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "YgorImages_Functors/Compute/Compare_Images.h"
+
+#include "Test_Image_Fixtures.h"
+
+
+struct comparison_t {
+    planar_image_collection<float, double> imgs;
+    int64_t passed = 0;
+    int64_t count = 0;
+};
+
+static comparison_t
+compare(const planar_image_collection<float, double> &test,
+        planar_image_collection<float, double> &ref,
+        contour_collection<double> &roi,
+        ComputeCompareImagesUserData ud,
+        bool use_regular_grid_search){
+    comparison_t out;
+    out.imgs = test;
+    ud.use_regular_grid_search = use_regular_grid_search;
+    std::list<std::reference_wrapper<planar_image_collection<float, double>>> external_imgs = { std::ref(ref) };
+    std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(roi) };
+    REQUIRE(out.imgs.Compute_Images( ComputeCompareImages, external_imgs, ccsl, &ud ));
+    out.passed = ud.passed;
+    out.count = ud.count;
+    return out;
+}
+
+// The number of finite voxels strictly below the threshold.
+static int64_t
+count_below(const planar_image_collection<float, double> &coll, double threshold){
+    int64_t N = 0;
+    for(const auto &img : coll.images){
+        for(int64_t row = 0; row < img.rows; ++row){
+            for(int64_t col = 0; col < img.columns; ++col){
+                const auto v = img.value(row, col, 0);
+                if(std::isfinite(v) && (v < threshold)) ++N;
+            }
+        }
+    }
+    return N;
+}
+
+
+TEST_CASE( "regular-grid comparisons agree with the general implementation" ){
+    // The reference dose is a linear gradient along x, and the test dose is shifted by a row-dependent amount, so
+    // the exact DTA is 0.1 * row (except along the high-dose edge, where no agreement is possible). Discrepancies
+    // and distances both vary, so some voxels pass, some fail the combined gamma criterion, and some fail the
+    // discrepancy criterion alone.
+    const int64_t S = 5;
+    const int64_t R = 10;
+    const int64_t C = 10;
+    const double pxl_dz = 2.0;
+    auto ref = make_regular_grid(S, R, C, pxl_dz,
+        [](int64_t, int64_t, int64_t col){ return 10.0f + static_cast<float>(col); });
+    const auto test = make_regular_grid(S, R, C, pxl_dz,
+        [](int64_t, int64_t row, int64_t col){ return 10.0f + static_cast<float>(col) + 0.1f * static_cast<float>(row); });
+    auto roi = make_roi(S, pxl_dz, -1.0, -1.0, static_cast<double>(C), static_cast<double>(R));
+
+    ComputeCompareImagesUserData ud;
+    ud.channel = 0;
+    ud.discrepancy_type = ComputeCompareImagesUserData::DiscrepancyType::Relative;
+    ud.DTA_vox_val_eq_abs = 1.0E-3;
+    ud.DTA_vox_val_eq_reldiff = 0.0;
+    ud.DTA_max = 3.0;
+    ud.gamma_DTA_threshold = 1.0;
+    ud.gamma_Dis_threshold = 0.05;
+    ud.gamma_terminate_when_max_exceeded = true;
+
+    const auto require_same_voxels = [](const planar_image_collection<float, double> &A,
+                                        const planar_image_collection<float, double> &B){
+        REQUIRE(A.images.size() == B.images.size());
+        auto b_it = std::begin(B.images);
+        for(const auto &a : A.images){
+            const auto &b = *(b_it++);
+            for(int64_t row = 0; row < a.rows; ++row){
+                for(int64_t col = 0; col < a.columns; ++col){
+                    const auto va = a.value(row, col, 0);
+                    const auto vb = b.value(row, col, 0);
+                    REQUIRE(std::isnan(va) == std::isnan(vb));
+                    if(!std::isnan(va)) REQUIRE(va == doctest::Approx(vb).epsilon(1E-4));
+                }
+            }
+        }
+    };
+
+    SUBCASE("gamma index with nearest-neighbour interpolation"){
+        ud.comparison_method = ComputeCompareImagesUserData::ComparisonMethod::GammaIndex;
+        ud.interpolation_method = ComputeCompareImagesUserData::InterpolationMethod::NN;
+        const auto grid = compare(test, ref, roi, ud, true);
+        const auto general = compare(test, ref, roi, ud, false);
+
+        require_same_voxels(grid.imgs, general.imgs);
+        CHECK(grid.passed == general.passed);
+        CHECK(grid.count == general.count);
+        CHECK(0 < grid.passed);
+        CHECK(grid.passed < grid.count);
+        CHECK(count_below(grid.imgs, 1.0) == grid.passed);
+    }
+
+    SUBCASE("DTA with nearest-neighbour interpolation"){
+        ud.comparison_method = ComputeCompareImagesUserData::ComparisonMethod::DTA;
+        ud.interpolation_method = ComputeCompareImagesUserData::InterpolationMethod::NN;
+        const auto grid = compare(test, ref, roi, ud, true);
+        const auto general = compare(test, ref, roi, ud, false);
+
+        require_same_voxels(grid.imgs, general.imgs);
+        CHECK(count_below(grid.imgs, 0.45) == count_below(general.imgs, 0.45));
+
+        for(const auto &img : grid.imgs.images){
+            for(int64_t row = 0; row < R; ++row){
+                for(int64_t col = 0; (col + 1) < C; ++col){
+                    REQUIRE(img.value(row, col, 0) == doctest::Approx(0.1 * static_cast<double>(row)).epsilon(1E-4));
+                }
+            }
+        }
+    }
+
+    SUBCASE("discrepancy"){
+        ud.comparison_method = ComputeCompareImagesUserData::ComparisonMethod::Discrepancy;
+        const auto grid = compare(test, ref, roi, ud, true);
+        const auto general = compare(test, ref, roi, ud, false);
+
+        require_same_voxels(grid.imgs, general.imgs);
+        CHECK(count_below(grid.imgs, 0.05) == count_below(general.imgs, 0.05));
+    }
+
+    SUBCASE("gamma index without interpolation"){
+        // Straddle-based estimates depend on the order voxels are visited, so failing voxels can be labelled
+        // differently. Pass rates and the voxels that pass must agree.
+        ud.comparison_method = ComputeCompareImagesUserData::ComparisonMethod::GammaIndex;
+        ud.interpolation_method = ComputeCompareImagesUserData::InterpolationMethod::None;
+        const auto grid = compare(test, ref, roi, ud, true);
+        const auto general = compare(test, ref, roi, ud, false);
+
+        CHECK(grid.passed == general.passed);
+        CHECK(grid.count == general.count);
+        CHECK(0 < grid.passed);
+
+        auto g_it = std::begin(general.imgs.images);
+        for(const auto &img : grid.imgs.images){
+            const auto &g = *(g_it++);
+            for(int64_t row = 0; row < R; ++row){
+                for(int64_t col = 0; col < C; ++col){
+                    const auto v = img.value(row, col, 0);
+                    const auto gv = g.value(row, col, 0);
+                    const bool v_passed = std::isfinite(v) && (v < 1.0f);
+                    const bool gv_passed = std::isfinite(gv) && (gv < 1.0f);
+                    REQUIRE(v_passed == gv_passed);
+                    if(v_passed) REQUIRE(v == doctest::Approx(gv).epsilon(1E-4));
+                }
+            }
+        }
+    }
+}
+
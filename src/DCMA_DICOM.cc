@@ -21,6 +21,17 @@
 #include <cstring>
 #include <stdexcept>
 #include <cctype>
+#include <memory>
+#include <string_view>
+#include <filesystem>
+#include <iterator>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 #include "YgorMisc.h"
 #include "YgorLog.h"
@@ -111,6 +122,68 @@ static bool has_control_char_except_text(const std::string &val){
     return false;
 }
 
+MappedFile::MappedFile(const std::filesystem::path &fname) : fname(fname) {
+#if !defined(_WIN32) && !defined(_WIN64)
+    const int fd = ::open(fname.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::runtime_error("Unable to open file '"_s + fname.string() + "' for reading.");
+    }
+    struct stat sb;
+    if(::fstat(fd, &sb) != 0){
+        ::close(fd);
+        throw std::runtime_error("Unable to determine size of file '"_s + fname.string() + "'.");
+    }
+    this->size = static_cast<uint64_t>(sb.st_size);
+    if(0 < this->size){
+        void *p = ::mmap(nullptr, static_cast<size_t>(this->size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p != MAP_FAILED){
+            this->data = static_cast<const char *>(p);
+            this->is_mapped = true;
+        }
+    }
+    ::close(fd); // The mapping remains valid after the descriptor is closed.
+    if(this->is_mapped || (this->size == 0)) return;
+    YLOGDEBUG("Unable to memory-map '" << fname << "', reading it into memory instead");
+#endif
+
+    std::ifstream ifs(fname, std::ios::in | std::ios::binary);
+    if(!ifs){
+        throw std::runtime_error("Unable to open file '"_s + fname.string() + "' for reading.");
+    }
+    this->fallback.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    this->data = this->fallback.data();
+    this->size = static_cast<uint64_t>(this->fallback.size());
+}
+
+MappedFile::~MappedFile(){
+#if !defined(_WIN32) && !defined(_WIN64)
+    if(this->is_mapped){
+        ::munmap(const_cast<char *>(this->data), static_cast<size_t>(this->size));
+    }
+#endif
+}
+
+const std::filesystem::path &MappedFile::path() const {
+    return this->fname;
+}
+
+std::string_view MappedFile::bytes() const {
+    return std::string_view(this->data, static_cast<size_t>(this->size));
+}
+
+
+std::string_view ValueView::bytes() const {
+    if(this->file == nullptr){
+        throw std::logic_error("Value view does not refer to a file.");
+    }
+    const auto b = this->file->bytes();
+    if( (b.size() < this->offset) || ((b.size() - this->offset) < this->length) ){
+        throw std::runtime_error("Value view extends beyond the end of the file.");
+    }
+    return b.substr(static_cast<size_t>(this->offset), static_cast<size_t>(this->length));
+}
+
+
 struct Node;
 
 Node::Node() = default;
@@ -147,6 +220,23 @@ bool Node::operator<(const Node &rhs) const {
     return (l < r);
 }
 
+std::string_view Node::value_bytes() const {
+    if(this->val_view){
+        return this->val_view->bytes();
+    }
+    return std::string_view(this->val);
+}
+
+void Node::materialize(){
+    if(this->val_view){
+        this->val = std::string(this->val_view->bytes());
+        this->val_view.reset();
+    }
+    for(auto &c : this->children){
+        c.materialize();
+    }
+}
+
 Node *
 Node::emplace_child_node(Node &&n){
     Node *child_node = &( this->children.emplace_back(std::forward<Node>(n)) ); // Requires C++17.
@@ -407,6 +497,13 @@ uint64_t Node::emit_DICOM(std::ostream &os,
                           bool is_root_node,
                           bool lenient) const {
 
+    // Deferred payloads are copied before emission so the encoding logic below only needs to consider 'val'.
+    if(this->val_view){
+        Node n = *this;
+        n.materialize();
+        return n.emit_DICOM(os, enc, is_root_node, lenient);
+    }
+
     YLOGDEBUG("emit_DICOM: tag " << tag_diag(this->key.group, this->key.tag)
               << " VR='" << this->VR << "'"
               << " is_root=" << is_root_node
@@ -1435,31 +1532,72 @@ std::string decode_binary_value(const std::string &raw, const std::string &vr){
 }
 
 
+// Binary values at least this large are deferred (i.e., not copied) when reading from a memory-mapped file.
+constexpr uint32_t deferred_value_threshold = 1024;
+
+// Returns true for VRs that are stored as raw, undecoded bytes.
+bool vr_is_bulk_binary(const std::string &vr){
+    return (vr == "OB") || (vr == "OD") || (vr == "OF") || (vr == "OL")
+        || (vr == "OV") || (vr == "OW") || (vr == "UN");
+}
+
+// State shared by all the reading routines.
+struct read_context_t {
+    const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts;
+    DCMA_DICOM::DICOMDictionary *mutable_dict = nullptr;
+
+    // If set, the stream reads from this mapping (starting at offset zero) and large binary values are deferred.
+    std::shared_ptr<const DCMA_DICOM::MappedFile> mapped;
+
+    const DCMA_DICOM::ReadOptions &opts;
+};
+
+// Read-only std::streambuf over an in-memory buffer. Supports the seeking needed by the reader.
+class memory_streambuf : public std::streambuf {
+  public:
+    memory_streambuf(const char *begin, size_t size){
+        auto *b = const_cast<char *>(begin);
+        this->setg(b, b, b + size);
+    }
+
+  protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if(!(which & std::ios_base::in)) return pos_type(off_type(-1));
+        char *target = (dir == std::ios_base::beg) ? this->eback() + off
+                     : (dir == std::ios_base::cur) ? this->gptr()  + off
+                                                   : this->egptr() + off;
+        if( (target < this->eback()) || (this->egptr() < target) ) return pos_type(off_type(-1));
+        this->setg(this->eback(), target, this->egptr());
+        return pos_type(target - this->eback());
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return this->seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+
 // Forward declaration.
 DCMA_DICOM::Node read_data_element(std::istream &is,
                                    DCMA_DICOM::Encoding enc,
-                                   const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                   DCMA_DICOM::DICOMDictionary *mutable_dict);
+                                   const read_context_t &ctx);
 
 void read_sequence_items_defined(std::istream &is,
                                  DCMA_DICOM::Node &seq_node,
                                  DCMA_DICOM::Encoding enc,
-                                 const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                 DCMA_DICOM::DICOMDictionary *mutable_dict,
+                                 const read_context_t &ctx,
                                  uint32_t seq_length);
 
 void read_sequence_items_undefined(std::istream &is,
                                    DCMA_DICOM::Node &seq_node,
                                    DCMA_DICOM::Encoding enc,
-                                   const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                   DCMA_DICOM::DICOMDictionary *mutable_dict);
+                                   const read_context_t &ctx);
 
 
 // Read the contents of a single DICOM sequence item (between item tag and item end).
 DCMA_DICOM::Node read_item_contents(std::istream &is,
                                     DCMA_DICOM::Encoding enc,
-                                    const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                    DCMA_DICOM::DICOMDictionary *mutable_dict,
+                                    const read_context_t &ctx,
                                     uint32_t item_length,
                                     uint32_t item_number){
     DCMA_DICOM::Node item_node;
@@ -1485,7 +1623,7 @@ DCMA_DICOM::Node read_item_contents(std::istream &is,
             }
             // Seek back and read as data element.
             is.seekg(pos);
-            auto child = read_data_element(is, enc, dicts, mutable_dict);
+            auto child = read_data_element(is, enc, ctx);
             item_node.children.push_back(std::move(child));
         }
     }else{
@@ -1496,7 +1634,7 @@ DCMA_DICOM::Node read_item_contents(std::istream &is,
             auto bytes_read = static_cast<uint32_t>(current - item_start);
             if(bytes_read >= item_length) break;
 
-            auto child = read_data_element(is, enc, dicts, mutable_dict);
+            auto child = read_data_element(is, enc, ctx);
             item_node.children.push_back(std::move(child));
         }
     }
@@ -1507,8 +1645,7 @@ DCMA_DICOM::Node read_item_contents(std::istream &is,
 void read_sequence_items_defined(std::istream &is,
                                  DCMA_DICOM::Node &seq_node,
                                  DCMA_DICOM::Encoding enc,
-                                 const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                 DCMA_DICOM::DICOMDictionary *mutable_dict,
+                                 const read_context_t &ctx,
                                  uint32_t seq_length){
     auto seq_start = is.tellg();
     uint32_t item_number = 0;
@@ -1523,7 +1660,7 @@ void read_sequence_items_defined(std::istream &is,
         uint32_t item_length = read_uint32_le(is);
 
         if(g == 0xFFFE && e == 0xE000){
-            auto item = read_item_contents(is, enc, dicts, mutable_dict, item_length, item_number);
+            auto item = read_item_contents(is, enc, ctx, item_length, item_number);
             seq_node.children.push_back(std::move(item));
             ++item_number;
         }else if(g == 0xFFFE && e == 0xE0DD){
@@ -1539,8 +1676,7 @@ void read_sequence_items_defined(std::istream &is,
 void read_sequence_items_undefined(std::istream &is,
                                    DCMA_DICOM::Node &seq_node,
                                    DCMA_DICOM::Encoding enc,
-                                   const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                   DCMA_DICOM::DICOMDictionary *mutable_dict){
+                                   const read_context_t &ctx){
     uint32_t item_number = 0;
 
     while(is.good()){
@@ -1549,7 +1685,7 @@ void read_sequence_items_undefined(std::istream &is,
         uint32_t item_length = read_uint32_le(is);
 
         if(g == 0xFFFE && e == 0xE000){
-            auto item = read_item_contents(is, enc, dicts, mutable_dict, item_length, item_number);
+            auto item = read_item_contents(is, enc, ctx, item_length, item_number);
             seq_node.children.push_back(std::move(item));
             ++item_number;
         }else if(g == 0xFFFE && e == 0xE0DD){
@@ -1592,8 +1728,7 @@ void read_encapsulated_data(std::istream &is, DCMA_DICOM::Node &node){
 
 DCMA_DICOM::Node read_data_element(std::istream &is,
                                    DCMA_DICOM::Encoding enc,
-                                   const std::vector<const DCMA_DICOM::DICOMDictionary*> &dicts,
-                                   DCMA_DICOM::DICOMDictionary *mutable_dict){
+                                   const read_context_t &ctx){
     DCMA_DICOM::Node node;
 
     node.key.group = read_uint16_le(is);
@@ -1620,19 +1755,19 @@ DCMA_DICOM::Node read_data_element(std::istream &is,
         }
 
         // Update the mutable dictionary if provided.
-        if(mutable_dict != nullptr){
+        if(ctx.mutable_dict != nullptr){
             DCMA_DICOM::dict_key_t dkey = {node.key.group, node.key.tag};
             // Look up the expected VR from existing dictionaries.
-            std::string expected_vr = DCMA_DICOM::lookup_VR(node.key.group, node.key.tag, dicts);
+            std::string expected_vr = DCMA_DICOM::lookup_VR(node.key.group, node.key.tag, ctx.dicts);
             if(expected_vr.empty() || expected_vr != vr){
-                (*mutable_dict)[dkey] = {vr, ""};
+                (*ctx.mutable_dict)[dkey] = {vr, ""};
             }
         }
 
     }else if(enc == DCMA_DICOM::Encoding::ILE){
         // Implicit VR: look up VR from dictionaries.
         length = read_uint32_le(is);
-        vr = DCMA_DICOM::lookup_VR(node.key.group, node.key.tag, dicts);
+        vr = DCMA_DICOM::lookup_VR(node.key.group, node.key.tag, ctx.dicts);
         if(vr.empty()) vr = "UN"; // Unknown tags default to UN.
     }else{
         throw std::runtime_error("Unsupported encoding for DICOM reading.");
@@ -1643,9 +1778,9 @@ DCMA_DICOM::Node read_data_element(std::istream &is,
     // Handle sequences.
     if(vr == "SQ"){
         if(length == 0xFFFFFFFF){
-            read_sequence_items_undefined(is, node, enc, dicts, mutable_dict);
+            read_sequence_items_undefined(is, node, enc, ctx);
         }else{
-            read_sequence_items_defined(is, node, enc, dicts, mutable_dict, length);
+            read_sequence_items_defined(is, node, enc, ctx, length);
         }
         return node;
     }
@@ -1668,6 +1803,26 @@ DCMA_DICOM::Node read_data_element(std::istream &is,
             "only PixelData (7FE0,0010) with VR OB/OW/UN may be encapsulated.");
     }
 
+    // Defer large binary values when the stream is backed by a mapped file. Only the location is recorded.
+    if( (ctx.mapped != nullptr)
+    &&  (deferred_value_threshold <= length)
+    &&  vr_is_bulk_binary(vr) ){
+        const auto pos = static_cast<int64_t>(is.tellg());
+        const auto avail = static_cast<int64_t>(ctx.mapped->bytes().size());
+        if( (pos < 0) || (avail < (pos + static_cast<int64_t>(length))) ){
+            throw std::runtime_error("Unexpected end of DICOM stream while reading "_s
+                                     + std::to_string(length) + " bytes.");
+        }
+        is.seekg(static_cast<std::streamoff>(length), std::ios_base::cur);
+
+        DCMA_DICOM::ValueView view;
+        view.file = ctx.mapped;
+        view.offset = static_cast<uint64_t>(pos);
+        view.length = static_cast<uint64_t>(length);
+        node.val_view = std::move(view);
+        return node;
+    }
+
     // Read raw value bytes.
     std::string raw = read_bytes(is, length);
 
@@ -1686,22 +1841,53 @@ DCMA_DICOM::Node read_data_element(std::istream &is,
     return node;
 }
 
-} // anonymous namespace
+// Skip over a data element without reading its value.
+void skip_data_element(std::istream &is,
+                       DCMA_DICOM::Encoding enc,
+                       const read_context_t &ctx){
+    const auto pos = is.tellg();
+    [[maybe_unused]] const uint16_t group = read_uint16_le(is);
+    [[maybe_unused]] const uint16_t tag   = read_uint16_le(is);
 
+    uint32_t length = 0;
+    if(enc == DCMA_DICOM::Encoding::ELE){
+        char vr_buf[2];
+        is.read(vr_buf, 2);
+        if(!is) throw std::runtime_error("Unexpected end of DICOM stream while reading VR.");
+        if(vr_has_extended_length(std::string(vr_buf, 2))){
+            [[maybe_unused]] uint16_t reserved = read_uint16_le(is);
+            length = read_uint32_le(is);
+        }else{
+            length = static_cast<uint32_t>(read_uint16_le(is));
+        }
+    }else if(enc == DCMA_DICOM::Encoding::ILE){
+        length = read_uint32_le(is);
+    }else{
+        throw std::runtime_error("Unsupported encoding for DICOM reading.");
+    }
 
-///////////////////////////////////////////////////////////////////////////////
-// Node::read_DICOM
-///////////////////////////////////////////////////////////////////////////////
+    if(length == 0xFFFFFFFF){
+        // The end of an undefined-length value can only be found by parsing it.
+        is.seekg(pos);
+        read_data_element(is, enc, ctx);
+        return;
+    }
+    is.seekg(static_cast<std::streamoff>(length), std::ios_base::cur);
+    if(!is) throw std::runtime_error("Unexpected end of DICOM stream while skipping "_s
+                                     + std::to_string(length) + " bytes.");
+}
 
-void Node::read_DICOM(std::istream &is,
-                      const std::vector<const DICOMDictionary*> &dicts,
-                      DICOMDictionary *mutable_dict){
+// Read a complete DICOM file, populating the provided node as the root.
+void read_DICOM_root(DCMA_DICOM::Node &root,
+                     std::istream &is,
+                     const read_context_t &ctx){
     verify_little_endian();
 
-    // Initialize this node as root.
-    this->VR = "SQ";
-    this->val.clear();
-    this->children.clear();
+    // Initialize the node as root.
+    root.VR = "SQ";
+    root.val.clear();
+    root.val_view.reset();
+    root.children.clear();
 
     // Read the 128-byte preamble.
     {
@@ -1730,23 +1916,23 @@ void Node::read_DICOM(std::istream &is,
 
         if(g != 0x0002) break; // End of meta information.
 
-        auto node = read_data_element(is, Encoding::ELE, dicts, mutable_dict);
-        this->children.push_back(std::move(node));
+        auto node = read_data_element(is, DCMA_DICOM::Encoding::ELE, ctx);
+        root.children.push_back(std::move(node));
     }
 
     // Determine the data encoding from the TransferSyntaxUID (0002,0010).
-    Encoding data_enc = Encoding::ELE; // Default if not specified.
+    DCMA_DICOM::Encoding data_enc = DCMA_DICOM::Encoding::ELE; // Default if not specified.
     {
-        const auto *ts_node = this->find(0x0002, 0x0010);
+        const auto *ts_node = root.find(0x0002, 0x0010);
         if(ts_node != nullptr){
             std::string ts = ts_node->val;
             // Strip trailing padding (nulls/spaces).
             while(!ts.empty() && (ts.back() == '\0' || ts.back() == ' ')) ts.pop_back();
 
             if(ts == "1.2.840.10008.1.2"){
-                data_enc = Encoding::ILE;
+                data_enc = DCMA_DICOM::Encoding::ILE;
             }else if(ts == "1.2.840.10008.1.2.1"){
-                data_enc = Encoding::ELE;
+                data_enc = DCMA_DICOM::Encoding::ELE;
             }else if(ts == "1.2.840.10008.1.2.2"){
                 throw std::runtime_error("Big-endian DICOM transfer syntax is not supported.");
             }
@@ -1756,10 +1942,58 @@ void Node::read_DICOM(std::istream &is,
     }
 
     // Parse remaining data elements using the determined encoding.
+    const auto &opts = ctx.opts;
+    const bool is_selective = !opts.tag_whitelist.empty() || opts.stop_at_group.has_value();
     while(is.good() && (is.peek() != std::char_traits<char>::eof())){
-        auto node = read_data_element(is, data_enc, dicts, mutable_dict);
-        this->children.push_back(std::move(node));
+        if(is_selective){
+            auto pos = is.tellg();
+            uint16_t g = read_uint16_le(is);
+            uint16_t e = read_uint16_le(is);
+            is.seekg(pos);
+
+            if( opts.stop_at_group
+            &&  (opts.stop_at_group.value() <= g) ) break;
+
+            if( !opts.tag_whitelist.empty()
+            &&  (opts.tag_whitelist.count({g, e}) == 0) ){
+                skip_data_element(is, data_enc, ctx);
+                continue;
+            }
+        }
+
+        auto node = read_data_element(is, data_enc, ctx);
+        root.children.push_back(std::move(node));
+    }
+}
+
+} // anonymous namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Node::read_DICOM
+///////////////////////////////////////////////////////////////////////////////
+
+void Node::read_DICOM(std::istream &is,
+                      const std::vector<const DICOMDictionary*> &dicts,
+                      DICOMDictionary *mutable_dict,
+                      const ReadOptions &opts){
+    const read_context_t ctx{dicts, mutable_dict, nullptr, opts};
+    read_DICOM_root(*this, is, ctx);
+}
+
+void Node::read_DICOM(const std::shared_ptr<const MappedFile> &mf,
+                      const std::vector<const DICOMDictionary*> &dicts,
+                      DICOMDictionary *mutable_dict,
+                      const ReadOptions &opts){
+    if(mf == nullptr){
+        throw std::invalid_argument("No mapped file provided. Refusing to continue.");
     }
+    const auto b = mf->bytes();
+    memory_streambuf sb(b.data(), b.size());
+    std::istream is(&sb);
+
+    const read_context_t ctx{dicts, mutable_dict, mf, opts};
+    read_DICOM_root(*this, is, ctx);
 }
 
 
@@ -1881,17 +2115,18 @@ std::string Node::value_str() const {
         return "(sequence with "_s + std::to_string(this->children.size()) + " items)";
     }else{
         // Binary blob VRs (OB, OW, OF, OD, OL, OV, UN): return a summary.
-        if(this->val.size() <= 64){
+        const auto bytes = this->value_bytes();
+        if(bytes.size() <= 64){
             // Short enough to show as hex.
             std::ostringstream ss;
             ss << std::hex << std::setfill('0');
-            for(size_t i = 0; i < this->val.size(); ++i){
+            for(size_t i = 0; i < bytes.size(); ++i){
                 if(i > 0) ss << " ";
-                ss << std::setw(2) << (static_cast<unsigned int>(static_cast<unsigned char>(this->val[i])));
+                ss << std::setw(2) << (static_cast<unsigned int>(static_cast<unsigned char>(bytes[i])));
             }
             return ss.str();
         }
-        return "(" + std::to_string(this->val.size()) + " bytes)";
+        return "(" + std::to_string(bytes.size()) + " bytes)";
     }
 }
 
@@ -8,9 +8,13 @@
 #include <list>
 #include <functional>
 #include <map>
+#include <set>
 #include <vector>
 #include <utility>
 #include <optional>
+#include <memory>
+#include <string_view>
+#include <filesystem>
 
 #include "DCMA_DICOM_Dictionaries.h"
 
@@ -18,6 +22,9 @@ namespace DCMA_DICOM {
 
 struct NodeKey;
 struct Node;
+class MappedFile;
+struct ValueView;
+struct ReadOptions;
 
 //////////////
 
@@ -35,6 +42,51 @@ struct NodeKey {
                           // The instance of the tag. (Modern DICOM prefers explicit sequences.)
 };
 
+// Options that limit how much of a file is parsed. These are useful for scanning headers of many files, e.g., when
+// only a handful of tags are needed to group files into series.
+struct ReadOptions {
+    // If non-empty, only top-level elements with these (group, tag) keys are retained. The values of all other
+    // elements are skipped without being read or decoded. Elements nested within a retained sequence are all
+    // retained. The file meta information group (0002) is always retained, since it determines the encoding.
+    std::set<dict_key_t> tag_whitelist;
+
+    // If provided, parsing stops before the first top-level element with a group number greater than or equal to
+    // this value. For example, 0x7FE0 stops before the pixel data.
+    std::optional<uint16_t> stop_at_group;
+};
+
+//////////////
+
+// A read-only view of a file's contents. Where supported (POSIX), the file is memory-mapped so pages are only read
+// from disk when they are touched. Otherwise the contents are read into memory.
+class MappedFile {
+  private:
+    std::filesystem::path fname;
+    const char *data = nullptr;
+    uint64_t size = 0;
+    bool is_mapped = false;
+    std::string fallback; // Holds the file contents when mapping is unavailable.
+
+  public:
+    explicit MappedFile(const std::filesystem::path &fname);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const std::filesystem::path &path() const;
+    std::string_view bytes() const;
+};
+
+// A contiguous range of bytes within a MappedFile. The view keeps the mapping alive.
+struct ValueView {
+    std::shared_ptr<const MappedFile> file;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+
+    std::string_view bytes() const;
+};
+
 //////////////
 
 struct Node {
@@ -47,6 +99,10 @@ struct Node {
 
     std::string val;   // Payload value for this tag serialized to a string of bytes.
 
+    std::optional<ValueView> val_view; // If present, the payload has not been copied into 'val' and instead
+                                       // resides in a memory-mapped file. Only used for large binary VRs
+                                       // (e.g., PixelData) when reading via a MappedFile. See value_bytes().
+
     std::list<Node> children; // Children nodes if this is a sequence tag.
 
     // Constructors.
@@ -78,9 +134,28 @@ struct Node {
     // If 'mutable_dict' is non-null, it is updated with VRs encountered in
     // explicit-VR files: unknown tags are added, and different-than-expected VRs
     // are recorded. The mutable dictionary can be persisted via write_dictionary.
+    // The options can be used to parse only a subset of the file.
     void read_DICOM(std::istream &is,
                     const std::vector<const DICOMDictionary*> &dicts = {},
-                    DICOMDictionary *mutable_dict = nullptr);
+                    DICOMDictionary *mutable_dict = nullptr,
+                    const ReadOptions &opts = {});
+
+    // Read a DICOM file from a memory-mapped file, populating this node as the root.
+    // Large binary values (OB, OW, OF, OD, OL, OV, UN) are not copied; they are recorded
+    // as views into the mapping (see 'val_view') and only paged in when accessed. The
+    // nodes hold a reference to the mapping, so it outlives the file handle.
+    void read_DICOM(const std::shared_ptr<const MappedFile> &mf,
+                    const std::vector<const DICOMDictionary*> &dicts = {},
+                    DICOMDictionary *mutable_dict = nullptr,
+                    const ReadOptions &opts = {});
+
+    // Access the payload bytes, regardless of whether they are stored in 'val' or 'val_view'.
+    // The returned view is valid as long as this node is alive and unmodified.
+    std::string_view value_bytes() const;
+
+    // Copy any deferred payloads in this node and all descendants into 'val', releasing
+    // references to the underlying mapped file.
+    void materialize();
 
     // Find the first descendant node matching (group, tag).
     Node* find(uint16_t group, uint16_t tag);
@@ -16,6 +16,7 @@
 #include <climits>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <stdexcept>
@@ -440,7 +441,7 @@ bool convert_photometric_to_rgb(planar_image<float,double> &img,
             uint32_t first_mapped = 0;
             uint16_t bits_per_entry = 16;
             if(n_desc != nullptr){
-                const auto &raw_desc = n_desc->val;
+                const auto raw_desc = n_desc->value_bytes();
                 if(raw_desc.size() >= 6u){
                     uint16_t d0 = 0, d1 = 0, d2 = 0;
                     std::memcpy(&d0, raw_desc.data() + 0u, 2u);
@@ -459,7 +460,7 @@ bool convert_photometric_to_rgb(planar_image<float,double> &img,
             // Read raw LUT data entries.
             const auto *n_data = root->find(0x0028, data_tag);
             if(n_data == nullptr) return {};
-            const auto &raw = n_data->val;
+            const auto raw = n_data->value_bytes();
             const size_t entry_count = raw.size() / 2u;
             if(entry_count == 0u) return {};
 
@@ -658,7 +659,7 @@ samples_to_images(const std::vector<double> &samples,
 //
 // See DICOM PS3.5 2026b, Section 8.1.1 and 8.2.1.
 static std::vector<double>
-unpack_native_samples(const std::string &raw,
+unpack_native_samples(std::string_view raw,
                       const PixelDataDesc &desc,
                       uint64_t total_samples){
 
@@ -817,7 +818,7 @@ std::optional<planar_image_collection<float,double>> extract_native_pixel_data(c
         return std::nullopt;
     }
 
-    const auto &raw = pd_node->val;
+    const auto raw = pd_node->value_bytes();
     const uint64_t total_samples = static_cast<uint64_t>(desc.number_of_frames)
                                  * static_cast<uint64_t>(desc.rows)
                                  * static_cast<uint64_t>(desc.columns)
@@ -925,7 +926,7 @@ extract_overlay_data(const Node &root){
         // Unpack the 1-bit overlay bitmap.
         // Each bit corresponds to one pixel. Bits are packed LSB-first within each byte.
         // See DICOM PS3.5 2026b, Section 8.1.2.
-        const auto &raw = data_node->val;
+        const auto raw = data_node->value_bytes();
         const uint64_t total_pixels = static_cast<uint64_t>(od.rows) * static_cast<uint64_t>(od.columns);
         const uint64_t required_bytes = (total_pixels + 7u) / 8u;
 
@@ -1009,7 +1010,7 @@ std::optional<planar_image_collection<float,double>> extract_encapsulated_pixel_
         return std::nullopt;
     }
 
-    const auto &raw = pd_node->val;
+    const auto raw = pd_node->value_bytes();
     if(raw.size() < 4){
         YLOGWARN("Pixel Data tag too small for encapsulated JPEG data");
         return std::nullopt;
@@ -8,6 +8,9 @@
 #include <cstring>
 #include <cmath>
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <list>
 #include <vector>
@@ -377,6 +380,105 @@ TEST_CASE("DCMA_DICOM round-trip with Implicit VR Little Endian"){
 }
 
 
+TEST_CASE("DCMA_DICOM memory-mapped reading defers large binary values"){
+    auto root = create_minimal_dicom_tree(DCMA_DICOM::Encoding::ELE);
+    std::string pixel_data(4096, '\0');
+    for(size_t i = 0; i < pixel_data.size(); ++i) pixel_data[i] = static_cast<char>(i % 251);
+    root.emplace_child_node({{0x7FE0, 0x0010}, "OW", pixel_data});
+
+    const auto fname = std::filesystem::temp_directory_path() / "dcma_dicom_mapped_test.dcm";
+    {
+        std::ofstream ofs(fname, std::ios::out | std::ios::binary | std::ios::trunc);
+        REQUIRE(ofs.good());
+        root.emit_DICOM(ofs, DCMA_DICOM::Encoding::ELE);
+    }
+
+    DCMA_DICOM::Node read_root;
+    read_root.read_DICOM(std::make_shared<const DCMA_DICOM::MappedFile>(fname));
+
+    // Small values are copied as usual.
+    const auto *modality = read_root.find(0x0008, 0x0060);
+    REQUIRE(modality != nullptr);
+    CHECK(modality->val == "CT");
+    const auto *version = read_root.find(0x0002, 0x0001);
+    REQUIRE(version != nullptr);
+    CHECK(!version->val_view);
+
+    // Large values refer to the mapping.
+    const auto *pd = read_root.find(0x7FE0, 0x0010);
+    REQUIRE(pd != nullptr);
+    CHECK(pd->val.empty());
+    REQUIRE(pd->val_view);
+    CHECK(pd->value_bytes() == pixel_data);
+
+    // Emission is identical to a tree read from a stream.
+    DCMA_DICOM::Node stream_root;
+    {
+        std::ifstream ifs(fname, std::ios::in | std::ios::binary);
+        stream_root.read_DICOM(ifs);
+    }
+    std::stringstream ss_mapped;
+    std::stringstream ss_stream;
+    read_root.emit_DICOM(ss_mapped, DCMA_DICOM::Encoding::ELE);
+    stream_root.emit_DICOM(ss_stream, DCMA_DICOM::Encoding::ELE);
+    CHECK(ss_mapped.str() == ss_stream.str());
+
+    // Materializing copies the payload and releases the mapping.
+    read_root.materialize();
+    pd = read_root.find(0x7FE0, 0x0010);
+    REQUIRE(pd != nullptr);
+    CHECK(!pd->val_view);
+    CHECK(pd->val == pixel_data);
+
+    std::filesystem::remove(fname);
+}
+
+
+TEST_CASE("DCMA_DICOM read options limit parsing to a subset of tags"){
+    for(const auto enc : { DCMA_DICOM::Encoding::ELE, DCMA_DICOM::Encoding::ILE }){
+        auto root = create_minimal_dicom_tree(enc);
+        root.emplace_child_node({{0x7FE0, 0x0010}, "OW", std::string(64, '\x01')});
+
+        std::stringstream ss;
+        root.emit_DICOM(ss, enc);
+        REQUIRE(ss.good());
+
+        SUBCASE("tag whitelist"){
+            DCMA_DICOM::ReadOptions opts;
+            opts.tag_whitelist = { {0x0008, 0x0060}, {0x0010, 0x0020} };
+
+            DCMA_DICOM::Node read_root;
+            ss.seekg(0);
+            read_root.read_DICOM(ss, {}, nullptr, opts);
+
+            REQUIRE(read_root.find(0x0008, 0x0060) != nullptr);
+            CHECK(read_root.find(0x0008, 0x0060)->val == "CT");
+            REQUIRE(read_root.find(0x0010, 0x0020) != nullptr);
+            CHECK(read_root.find(0x0010, 0x0020)->val == "12345");
+            CHECK(read_root.find(0x0002, 0x0010) != nullptr); // Meta information is always retained.
+            CHECK(read_root.find(0x0010, 0x0010) == nullptr);
+            CHECK(read_root.find(0x0028, 0x0010) == nullptr);
+            CHECK(read_root.find(0x7FE0, 0x0010) == nullptr);
+        }
+
+        SUBCASE("stop at group"){
+            DCMA_DICOM::ReadOptions opts;
+            opts.stop_at_group = 0x0020;
+
+            DCMA_DICOM::Node read_root;
+            ss.seekg(0);
+            read_root.read_DICOM(ss, {}, nullptr, opts);
+
+            CHECK(read_root.find(0x0008, 0x0060) != nullptr);
+            CHECK(read_root.find(0x0010, 0x0010) != nullptr);
+            CHECK(read_root.find(0x0020, 0x0013) == nullptr);
+            CHECK(read_root.find(0x0028, 0x0010) == nullptr);
+            CHECK(read_root.find(0x7FE0, 0x0010) == nullptr);
+        }
+    }
+}
+
+
 // ============================================================================
 // Tree search tests
 // ============================================================================
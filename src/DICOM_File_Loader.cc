@@ -8,7 +8,10 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>    
+#include <thread>
+#include <vector>
 #include <cstdint>
 //#include <cfenv>              //Needed for std::feclearexcept(FE_ALL_EXCEPT).
 
@@ -20,6 +23,7 @@
 #include "Explicator.h"       //Needed for Explicator class.
 #include "Imebra_Shim.h"      //Wrapper for Imebra library. Black-boxed to speed up compilation.
 #include "Structs.h"
+#include "Thread_Pool.h"
 #include "YgorImages.h"
 #include "YgorMath.h"         //Needed for vec3 class.
 #include "YgorMisc.h"         //Needed for FUNCINFO, FUNCWARN, FUNCERR macros.
@@ -37,14 +41,91 @@ Concatenate_Contour_Data(std::unique_ptr<Contour_Data> A,
 }
 
 
+// The outcome of classifying and decoding a single file. These are populated concurrently (one per file) and then
+// consumed sequentially in the original file order, so the result is identical to a purely serial traversal.
+struct dicom_file_parse_result_t {
+    std::string Modality;
+
+    std::unique_ptr<Transform3>   transform;
+    std::unique_ptr<RTPlan>       rtplan;
+    std::unique_ptr<Contour_Data> contours;
+    std::unique_ptr<Image_Array>  imgs;
+
+    // Any exception thrown while decoding. It is re-thrown when the file is consumed so that error handling matches
+    // the serial traversal exactly.
+    std::exception_ptr eptr;
+};
+
+static
+bool
+modality_is_image(const std::string &Modality){
+    return boost::iequals(Modality,"CT")
+        || boost::iequals(Modality,"OT")
+        || boost::iequals(Modality,"US")
+        || boost::iequals(Modality,"MR")
+        || boost::iequals(Modality,"RTIMAGE")
+        || boost::iequals(Modality,"PT");
+}
+
+static
+void
+Parse_DICOM_File(const std::filesystem::path &Filename,
+                 dicom_file_parse_result_t &res){
+    // The file is read and parsed once, and the parsed file is shared by the modality dispatch and the loaders.
+    std::shared_ptr<Parsed_DICOM_File> pf;
+    try{
+        pf = Open_DICOM_File(Filename);
+        res.Modality = get_modality(*pf);
+    }catch(const std::exception &e){
+        YLOGWARN("Unable to extract modality ('" << e.what() << "')");
+        res.Modality = "";
+    };
+
+    try{
+        if(boost::iequals(res.Modality,"REG")){
+            res.transform = Load_Transform(*pf);
+
+        }else if(boost::iequals(res.Modality,"RTPLAN")){
+            res.rtplan = Load_RTPlan(*pf);
+
+        }else if(boost::iequals(res.Modality,"RTSTRUCT")){
+            res.contours = get_Contour_Data(*pf);
+
+        }else if(boost::iequals(res.Modality,"RTDOSE")){
+            res.imgs = Load_Dose_Array(*pf);
+
+        }else if(modality_is_image(res.Modality)){
+            res.imgs = Load_Image_Array(*pf);
+        }
+    }catch(...){
+        res.eptr = std::current_exception();
+    }
+    return;
+}
+
+// Extract the decoded payload, or re-throw the exception encountered while decoding.
+template <class T>
+static
+T
+take_parse_result(dicom_file_parse_result_t &res, T &payload){
+    if(res.eptr) std::rethrow_exception(res.eptr);
+    return std::move(payload);
+}
+
+
 bool Load_From_DICOM_Files( Drover &DICOM_data,
-                            std::map<std::string,std::string> & /* InvocationMetadata */,
+                            std::map<std::string,std::string> &InvocationMetadata,
                             const std::string &FilenameLex,
                             std::list<std::filesystem::path> &Filenames ){
 
     //This routine will attempt to load DICOM files on an individual file basis. Files that are not successfully loaded
     // are not consumed so that they can be passed on to the next loading stage as needed. 
     //
+    // Files are classified and decoded concurrently using a pool of workers. The number of workers defaults to the
+    // number of available hardware threads, but can be overridden via the 'DICOMLoaderThreads' invocation metadata
+    // key (e.g., '-m DICOMLoaderThreads=1' to load serially). Decoded files are then consumed in the original order,
+    // so the outcome does not depend on the number of workers.
+    //
     // Note: This routine returns false only iff a file is suspected of being suited for this loader, but could not be
     //       loaded (e.g., the file seems appropriate, but a parsing failure was encountered).
     //
@@ -61,22 +142,47 @@ bool Load_From_DICOM_Files( Drover &DICOM_data,
     loaded_imgs_storage.emplace_back();
     loaded_dose_storage.emplace_back();
 
-    size_t i = 0;
     const size_t N = Filenames.size();
 
+    // ------------------------------------------- Concurrent decoding -------------------------------------------
+    std::vector<dicom_file_parse_result_t> parse_results(N);
+    {
+        unsigned int n_workers = std::thread::hardware_concurrency();
+        if(auto it = InvocationMetadata.find("DICOMLoaderThreads"); it != std::end(InvocationMetadata)){
+            try{
+                const auto requested = std::stol(it->second);
+                if(0 < requested) n_workers = static_cast<unsigned int>(requested);
+            }catch(const std::exception &){
+                YLOGWARN("Unable to parse DICOMLoaderThreads = '" << it->second << "', using default");
+            }
+        }
+        n_workers = std::clamp<unsigned int>(n_workers, 1U, static_cast<unsigned int>(N));
+
+        std::mutex printer;
+        size_t completed = 0;
+
+        work_queue<std::function<void(void)>> wq(n_workers);
+        size_t i = 0;
+        for(const auto &Filename : Filenames){
+            auto *res_ptr = &(parse_results[i++]);
+            wq.submit_task([&,Filename,res_ptr]() -> void {
+                Parse_DICOM_File(Filename, *res_ptr);
+
+                std::lock_guard<std::mutex> lock(printer);
+                ++completed;
+                YLOGINFO("Parsed file #" << completed << "/" << N << " = " << 100*completed/N << "% \t" << Filename);
+            });
+        }
+    } // Wait for all tasks to complete.
+
+    // ------------------------------------------- Sequential consumption ----------------------------------------
+    size_t i = 0;
     auto bfit = Filenames.begin();
     while(bfit != Filenames.end()){
-        YLOGINFO("Parsing file #" << i+1 << "/" << N << " = " << 100*(i+1)/N << "% \t" << *bfit);
+        auto &res = parse_results[i];
         ++i;
 
-        const auto Filename = *bfit;
-        std::string Modality;
-        try{
-            Modality = get_modality(Filename);
-        }catch(const std::exception &e){
-            YLOGWARN("Unable to extract modality ('" << e.what() << "')");
-            Modality = "";
-        };
+        const auto &Modality = res.Modality;
 
         if(boost::iequals(Modality,"RTRECORD")){
             YLOGWARN("RTRECORD file encountered. "
@@ -89,9 +195,7 @@ bool Load_From_DICOM_Files( Drover &DICOM_data,
             YLOGWARN("REG file support is experimental");
 
             try{
-                auto t = Load_Transform(Filename);
-if(t == nullptr) YLOGWARN("(t == nullptr)");
-if(std::get_if<std::monostate>(&(t->transform)) != nullptr) YLOGWARN("(std::get_if<std::monostate>(&(t->transform)) != nullptr)");
+                auto t = take_parse_result(res, res.transform);
                 if( (t == nullptr)
                 ||  (std::get_if<std::monostate>(&(t->transform)) != nullptr) ){
                     throw std::runtime_error("unable to extract transformation");
@@ -112,7 +216,7 @@ if(std::get_if<std::monostate>(&(t->transform)) != nullptr) YLOGWARN("(std::get_
         }else if(boost::iequals(Modality,"RTPLAN")){
             YLOGWARN("RTPLAN file support is experimental");
 
-            auto rtplan = Load_RTPlan(Filename);
+            auto rtplan = take_parse_result(res, res.rtplan);
             DICOM_data.rtplan_data.emplace_back( std::move(rtplan) );
 
             bfit = Filenames.erase( bfit ); 
@@ -121,7 +225,7 @@ if(std::get_if<std::monostate>(&(t->transform)) != nullptr) YLOGWARN("(std::get_
             const auto preloadcount = loaded_contour_data_storage->ccs.size();
             try{
                 auto combined = Concatenate_Contour_Data( loaded_contour_data_storage->Duplicate(),
-                                                          get_Contour_Data(Filename));
+                                                          take_parse_result(res, res.contours));
                 loaded_contour_data_storage = std::move(combined);
 
             }catch(const std::exception &e){
@@ -144,7 +248,7 @@ if(std::get_if<std::monostate>(&(t->transform)) != nullptr) YLOGWARN("(std::get_
 
         }else if(boost::iequals(Modality,"RTDOSE")){
             try{
-                loaded_dose_storage.back().push_back( Load_Dose_Array(Filename));
+                loaded_dose_storage.back().push_back( take_parse_result(res, res.imgs) );
             }catch(const std::exception &e){
                 YLOGWARN("Difficulty encountered during dose array loading: '" << e.what() << "'. Ignoring file and continuing");
                 //loaded_dose_storage.back().pop_back();
@@ -154,15 +258,9 @@ if(std::get_if<std::monostate>(&(t->transform)) != nullptr) YLOGWARN("(std::get_
 
             bfit = Filenames.erase( bfit ); 
 
-        }else if(  boost::iequals(Modality,"CT")
-                || boost::iequals(Modality,"OT")
-                || boost::iequals(Modality,"US")
-                || boost::iequals(Modality,"MR")
-                || boost::iequals(Modality,"RTIMAGE")
-                || boost::iequals(Modality,"PT") ){
-
+        }else if(modality_is_image(Modality)){
             try{
-                loaded_imgs_storage.back().push_back( Load_Image_Array(Filename));
+                loaded_imgs_storage.back().push_back( take_parse_result(res, res.imgs) );
             }catch(const std::exception &e){
                 YLOGWARN("Difficulty encountered during image array loading: '" << e.what() << "'. Ignoring file and continuing");
                 //loaded_imgs_storage.back().pop_back();
@@ -38,6 +38,7 @@
 #include "Lexicon_Loader.h"
 
 #include "Operation_Dispatcher.h"
+#include "Operation_Profiler.h"
 #include "DCMA_Version.h"
 
 //extern const std::string DCMA_VERSION_STR;
@@ -320,6 +321,17 @@ try{
       })
     );
 
+    arger.push_back( ygor_arg_handlr_t(650, 'P', "profile", true, "/tmp/profile.json",
+      "Record the wall time, CPU time, peak memory growth, and Drover object counts of every operation"
+      " (including the children of meta-operations) and write them to the given file when the"
+      " operations complete. The file uses the Chrome trace event format, and can be viewed with"
+      " chrome://tracing or Perfetto.",
+      [&](const std::string &optarg) -> void {
+        Enable_Operation_Profiling(optarg);
+        return;
+      })
+    );
+
     arger.push_back( ygor_arg_handlr_t(700, 't', "test", false, "",
       "Run unit tests and terminate.",
       [&](const std::string &) -> void {
@@ -460,7 +472,26 @@ try{
         throw std::runtime_error("No data was loaded, and virtual data switch was not provided. Refusing to proceed");
     }
 
-    if(!Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, Operations)){
+    // Resolve the operations once, reporting likely mistakes before anything runs.
+    bool ops_succeeded = false;
+    operation_plan_t plan;
+    std::list<std::string> diagnostics;
+    try{
+        plan = Compile_Operations(Operations, &diagnostics);
+        ops_succeeded = true;
+    }catch(const std::exception &e){
+        YLOGWARN("Unable to compile operations: '" << e.what() << "'");
+    }
+    for(const auto &d : diagnostics){
+        YLOGWARN(d);
+    }
+    if(ops_succeeded){
+        ops_succeeded = Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan);
+    }
+    if(Operation_Profiling_Enabled()){
+        Write_Operation_Profile();
+    }
+    if(!ops_succeeded){
         throw std::runtime_error("Analysis failed. Cannot continue");
     }
 
@@ -0,0 +1,360 @@
+//FFT.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file provides fast Fourier transforms and FFT-based correlation of real 3D volumes.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Thread_Pool.h"
+#include "FFT.h"
+
+using cplx = std::complex<double>;
+
+int64_t FFT_Size(int64_t n){
+    int64_t out = 1;
+    while(out < n) out *= 2;
+    return out;
+}
+
+
+fft_radix2::fft_radix2(int64_t n) : n(n) {
+    if( (n < 1) || (FFT_Size(n) != n) ){
+        throw std::invalid_argument("FFT length must be a positive power of two");
+    }
+    const double pi = std::acos(-1.0);
+    this->twiddles.reserve(static_cast<size_t>(n / 2));
+    for(int64_t k = 0; k < (n / 2); ++k){
+        this->twiddles.emplace_back( std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(n)) );
+    }
+
+    int64_t bits = 0;
+    while((int64_t(1) << bits) < n) ++bits;
+    this->bit_reversed.resize(static_cast<size_t>(n), 0);
+    for(int64_t i = 0; i < n; ++i){
+        int64_t r = 0;
+        for(int64_t b = 0; b < bits; ++b){
+            if(i & (int64_t(1) << b)) r |= (int64_t(1) << (bits - 1 - b));
+        }
+        this->bit_reversed[i] = r;
+    }
+}
+
+int64_t fft_radix2::size() const {
+    return this->n;
+}
+
+void fft_radix2::transform(cplx *data, bool inverse) const {
+    for(int64_t i = 0; i < this->n; ++i){
+        const auto j = this->bit_reversed[i];
+        if(i < j) std::swap(data[i], data[j]);
+    }
+
+    for(int64_t len = 2; len <= this->n; len *= 2){
+        const int64_t half = len / 2;
+        const int64_t step = this->n / len;
+        for(int64_t i = 0; i < this->n; i += len){
+            for(int64_t k = 0; k < half; ++k){
+                const auto &tw = this->twiddles[k * step];
+                const auto w = inverse ? std::conj(tw) : tw;
+                const auto u = data[i + k];
+                const auto v = data[i + k + half] * w;
+                data[i + k] = u + v;
+                data[i + k + half] = u - v;
+            }
+        }
+    }
+    return;
+}
+
+
+fft_real_radix2::fft_real_radix2(int64_t n) : n(n), half(std::max<int64_t>(n / 2, 1)) {
+    if( (n < 2) || (FFT_Size(n) != n) ){
+        throw std::invalid_argument("Real FFT length must be a power of two, at least two");
+    }
+    const double pi = std::acos(-1.0);
+    this->twiddles.reserve(static_cast<size_t>(n / 2 + 1));
+    for(int64_t k = 0; k <= (n / 2); ++k){
+        this->twiddles.emplace_back( std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(n)) );
+    }
+}
+
+int64_t fft_real_radix2::size() const {
+    return this->n;
+}
+
+void fft_real_radix2::forward(const double *in, cplx *out, std::vector<cplx> &scratch) const {
+    // Pack even and odd samples into the real and imaginary parts of a half-length sequence, transform, and then
+    // separate the interleaved spectra.
+    const int64_t M = this->n / 2;
+    scratch.resize(static_cast<size_t>(M));
+    for(int64_t m = 0; m < M; ++m){
+        scratch[m] = cplx(in[2 * m], in[2 * m + 1]);
+    }
+    this->half.transform(scratch.data(), false);
+
+    const cplx i_unit(0.0, 1.0);
+    for(int64_t k = 0; k <= M; ++k){
+        const auto Zk = scratch[k % M];
+        const auto Zc = std::conj(scratch[(M - k) % M]);
+        const auto E = (Zk + Zc) * 0.5;
+        const auto O = (Zk - Zc) * (-0.5 * i_unit);
+        out[k] = E + this->twiddles[k] * O;
+    }
+    return;
+}
+
+void fft_real_radix2::inverse(const cplx *in, double *out, std::vector<cplx> &scratch) const {
+    const int64_t M = this->n / 2;
+    scratch.resize(static_cast<size_t>(M));
+
+    const cplx i_unit(0.0, 1.0);
+    for(int64_t k = 0; k < M; ++k){
+        const auto Xk = in[k];
+        const auto Xc = std::conj(in[M - k]);
+        const auto E = (Xk + Xc);
+        const auto O = (Xk - Xc) * std::conj(this->twiddles[k]);
+        scratch[k] = E + i_unit * O;
+    }
+    this->half.transform(scratch.data(), true);
+
+    // The factor of two from combining the spectra makes this consistent with an unnormalized length-n inverse.
+    for(int64_t m = 0; m < M; ++m){
+        out[2 * m] = scratch[m].real();
+        out[2 * m + 1] = scratch[m].imag();
+    }
+    return;
+}
+
+
+namespace {
+
+// Tile geometry for overlap-save correlation along each dimension.
+struct fft_tiling_t {
+    volume_dims_t fft_dims;  // Transform size of each tile.
+    volume_dims_t step_dims; // Number of outputs produced by each tile.
+    int64_t tile_count = 0;
+};
+
+fft_tiling_t Choose_Tiling( const volume_dims_t &in_dims,
+                            const volume_dims_t &kernel_dims,
+                            int64_t max_tile_extent ){
+    fft_tiling_t out;
+    out.tile_count = 1;
+    for(size_t d = 0; d < 3; ++d){
+        const auto n = in_dims[d];
+        const auto k = kernel_dims[d];
+
+        // Tiles must be large enough to produce outputs, and are only as large as needed to cover the whole volume.
+        auto F = FFT_Size( std::min<int64_t>( n + k - 1, std::max<int64_t>(max_tile_extent, 2 * k) ) );
+
+        // The real transform runs along the column axis, which requires an even length.
+        if(d == 2) F = std::max<int64_t>(F, 2);
+
+        out.fft_dims[d] = F;
+        out.step_dims[d] = F - k + 1;
+        out.tile_count *= (n + out.step_dims[d] - 1) / out.step_dims[d];
+    }
+    return out;
+}
+
+// A 3D real-to-complex transform of a fixed size. The spectrum has dimensions (slices, rows, columns/2 + 1).
+struct fft_volume_plan_t {
+    volume_dims_t dims;
+    int64_t half_cols;
+    fft_radix2 slice_fft;
+    fft_radix2 row_fft;
+    fft_real_radix2 col_fft;
+
+    explicit fft_volume_plan_t(const volume_dims_t &dims)
+        : dims(dims),
+          half_cols(dims[2] / 2 + 1),
+          slice_fft(dims[0]),
+          row_fft(dims[1]),
+          col_fft(dims[2]) {}
+
+    size_t spectrum_size() const {
+        return static_cast<size_t>(this->dims[0] * this->dims[1] * this->half_cols);
+    }
+
+    // Transform along the slice and row axes of the spectrum.
+    void transform_slices_rows(std::vector<cplx> &spec, bool inverse, std::vector<cplx> &line) const {
+        const int64_t S = this->dims[0];
+        const int64_t R = this->dims[1];
+        const int64_t H = this->half_cols;
+
+        const auto along_rows = [&](){
+            line.resize(static_cast<size_t>(R));
+            for(int64_t z = 0; z < S; ++z){
+                for(int64_t h = 0; h < H; ++h){
+                    cplx *base = spec.data() + (z * R) * H + h;
+                    for(int64_t r = 0; r < R; ++r) line[r] = base[r * H];
+                    this->row_fft.transform(line.data(), inverse);
+                    for(int64_t r = 0; r < R; ++r) base[r * H] = line[r];
+                }
+            }
+        };
+        const auto along_slices = [&](){
+            if(S < 2) return;
+            line.resize(static_cast<size_t>(S));
+            for(int64_t r = 0; r < R; ++r){
+                for(int64_t h = 0; h < H; ++h){
+                    cplx *base = spec.data() + r * H + h;
+                    for(int64_t z = 0; z < S; ++z) line[z] = base[z * R * H];
+                    this->slice_fft.transform(line.data(), inverse);
+                    for(int64_t z = 0; z < S; ++z) base[z * R * H] = line[z];
+                }
+            }
+        };
+
+        if(R >= 2) along_rows();
+        along_slices();
+        return;
+    }
+
+    void forward(const std::vector<double> &in, std::vector<cplx> &spec, std::vector<cplx> &scratch) const {
+        const int64_t C = this->dims[2];
+        const int64_t H = this->half_cols;
+        spec.resize(this->spectrum_size());
+        for(int64_t zr = 0; zr < (this->dims[0] * this->dims[1]); ++zr){
+            this->col_fft.forward(in.data() + zr * C, spec.data() + zr * H, scratch);
+        }
+        this->transform_slices_rows(spec, false, scratch);
+        return;
+    }
+
+    // Note: the spectrum is overwritten.
+    void inverse(std::vector<cplx> &spec, std::vector<double> &out, std::vector<cplx> &scratch) const {
+        const int64_t C = this->dims[2];
+        const int64_t H = this->half_cols;
+        this->transform_slices_rows(spec, true, scratch);
+        out.resize(static_cast<size_t>(this->dims[0] * this->dims[1] * C));
+        for(int64_t zr = 0; zr < (this->dims[0] * this->dims[1]); ++zr){
+            this->col_fft.inverse(spec.data() + zr * H, out.data() + zr * C, scratch);
+        }
+        return;
+    }
+};
+
+} // namespace
+
+
+std::vector<double>
+Correlate_Volume_FFT( const std::vector<double> &in,
+                      const volume_dims_t &in_dims,
+                      const std::vector<double> &kernel,
+                      const volume_dims_t &kernel_dims,
+                      const volume_dims_t &kernel_centre,
+                      int64_t max_tile_extent ){
+    for(size_t d = 0; d < 3; ++d){
+        if( (in_dims[d] < 1) || (kernel_dims[d] < 1) ){
+            throw std::invalid_argument("Volume and kernel dimensions must be positive");
+        }
+    }
+    if( (static_cast<int64_t>(in.size()) != in_dims[0] * in_dims[1] * in_dims[2])
+    ||  (static_cast<int64_t>(kernel.size()) != kernel_dims[0] * kernel_dims[1] * kernel_dims[2]) ){
+        throw std::invalid_argument("Volume or kernel size does not match the provided dimensions");
+    }
+
+    const auto tiling = Choose_Tiling(in_dims, kernel_dims, max_tile_extent);
+    const fft_volume_plan_t plan(tiling.fft_dims);
+    const auto &F = tiling.fft_dims;
+    const auto &S = tiling.step_dims;
+
+    // Transform the zero-padded kernel once. The correlation is formed with its complex conjugate, and the
+    // normalization of the inverse transform is folded in.
+    std::vector<cplx> kernel_spec;
+    {
+        std::vector<double> padded(static_cast<size_t>(F[0] * F[1] * F[2]), 0.0);
+        for(int64_t i = 0; i < kernel_dims[0]; ++i){
+            for(int64_t j = 0; j < kernel_dims[1]; ++j){
+                for(int64_t k = 0; k < kernel_dims[2]; ++k){
+                    padded[(i * F[1] + j) * F[2] + k] = kernel[(i * kernel_dims[1] + j) * kernel_dims[2] + k];
+                }
+            }
+        }
+        std::vector<cplx> scratch;
+        plan.forward(padded, kernel_spec, scratch);
+        const double norm = 1.0 / static_cast<double>(F[0] * F[1] * F[2]);
+        for(auto &v : kernel_spec) v = std::conj(v) * norm;
+    }
+
+    std::vector<double> out(in.size(), 0.0);
+    const auto process_tile = [&](const volume_dims_t &origin){
+        // Gather the input window, which begins at the tile origin offset by the kernel centre.
+        std::vector<double> window(static_cast<size_t>(F[0] * F[1] * F[2]), 0.0);
+        for(int64_t z = 0; z < F[0]; ++z){
+            const auto in_z = origin[0] + z - kernel_centre[0];
+            if( (in_z < 0) || (in_dims[0] <= in_z) ) continue;
+            for(int64_t r = 0; r < F[1]; ++r){
+                const auto in_r = origin[1] + r - kernel_centre[1];
+                if( (in_r < 0) || (in_dims[1] <= in_r) ) continue;
+
+                const auto c_beg = std::max<int64_t>(0, kernel_centre[2] - origin[2]);
+                const auto c_end = std::min<int64_t>(F[2], in_dims[2] + kernel_centre[2] - origin[2]);
+                const auto src_offset = (in_z * in_dims[1] + in_r) * in_dims[2] + (origin[2] - kernel_centre[2]);
+                const auto dest_offset = (z * F[1] + r) * F[2];
+                for(int64_t c = c_beg; c < c_end; ++c) window[dest_offset + c] = in[src_offset + c];
+            }
+        }
+
+        std::vector<cplx> spec;
+        std::vector<cplx> scratch;
+        plan.forward(window, spec, scratch);
+        for(size_t i = 0; i < spec.size(); ++i) spec[i] *= kernel_spec[i];
+        plan.inverse(spec, window, scratch);
+
+        // Only the leading outputs of each tile are free of circular wrap-around.
+        for(int64_t z = 0; (z < S[0]) && (origin[0] + z < in_dims[0]); ++z){
+            for(int64_t r = 0; (r < S[1]) && (origin[1] + r < in_dims[1]); ++r){
+                const double *src = window.data() + (z * F[1] + r) * F[2];
+                double *dest = out.data() + ((origin[0] + z) * in_dims[1] + (origin[1] + r)) * in_dims[2] + origin[2];
+                const auto c_end = std::min<int64_t>(S[2], in_dims[2] - origin[2]);
+                std::copy(src, src + c_end, dest);
+            }
+        }
+    };
+
+    if(tiling.tile_count == 1){
+        process_tile({0, 0, 0});
+
+    }else{
+        // Tiles write to disjoint portions of the output, so no synchronization is needed.
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t z = 0; z < in_dims[0]; z += S[0]){
+            for(int64_t r = 0; r < in_dims[1]; r += S[1]){
+                for(int64_t c = 0; c < in_dims[2]; c += S[2]){
+                    const volume_dims_t origin = {z, r, c};
+                    wq.submit_task([&process_tile, origin]() -> void {
+                        process_tile(origin);
+                    });
+                }
+            }
+        }
+    } // Wait for all tasks to complete.
+
+    return out;
+}
+
+bool Prefer_FFT_Correlation( const volume_dims_t &in_dims,
+                             const volume_dims_t &kernel_dims,
+                             int64_t max_tile_extent ){
+    const auto N = static_cast<double>(in_dims[0] * in_dims[1] * in_dims[2]);
+    const auto K = static_cast<double>(kernel_dims[0] * kernel_dims[1] * kernel_dims[2]);
+
+    // Direct evaluation requires one multiply-add per kernel voxel per output voxel. Each tile requires a forward and
+    // an inverse transform, each costing roughly 5 (n log2 n)/2 operations for a real transform of n values.
+    const auto tiling = Choose_Tiling(in_dims, kernel_dims, max_tile_extent);
+    const auto F = static_cast<double>(tiling.fft_dims[0] * tiling.fft_dims[1] * tiling.fft_dims[2]);
+    const auto fft_cost = static_cast<double>(tiling.tile_count) * 5.0 * F * std::log2(std::max(F, 2.0));
+    const auto direct_cost = N * K;
+    return (fft_cost < direct_cost);
+}
+
@@ -0,0 +1,82 @@
+//FFT.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// Fast Fourier transforms and FFT-based correlation of real 3D volumes.
+//
+
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+
+// The smallest power of two that is not smaller than n.
+int64_t FFT_Size(int64_t n);
+
+// A radix-2 complex FFT of a fixed, power-of-two length.
+//
+// Transforms are unnormalized, so an inverse transform following a forward transform scales the input by the length.
+class fft_radix2 {
+    private:
+        int64_t n;
+        std::vector<std::complex<double>> twiddles; // exp(-2*pi*i*k/n) for k in [0, n/2).
+        std::vector<int64_t> bit_reversed;
+
+    public:
+        explicit fft_radix2(int64_t n);
+
+        int64_t size() const;
+
+        // Transform n contiguous values in-place.
+        void transform(std::complex<double> *data, bool inverse) const;
+};
+
+// A radix-2 FFT of real values with a fixed, power-of-two length n >= 2.
+//
+// Real sequences have Hermitian-symmetric spectra, so only the first (n/2 + 1) coefficients are computed. This is done
+// with a complex FFT of half the length. Like fft_radix2, transforms are unnormalized.
+class fft_real_radix2 {
+    private:
+        int64_t n;
+        fft_radix2 half;
+        std::vector<std::complex<double>> twiddles; // exp(-2*pi*i*k/n) for k in [0, n/2].
+
+    public:
+        explicit fft_real_radix2(int64_t n);
+
+        int64_t size() const;
+
+        // Transform n real values into (n/2 + 1) complex coefficients. The scratch buffer is resized as needed.
+        void forward(const double *in, std::complex<double> *out, std::vector<std::complex<double>> &scratch) const;
+
+        // Transform (n/2 + 1) complex coefficients into n real values.
+        void inverse(const std::complex<double> *in, double *out, std::vector<std::complex<double>> &scratch) const;
+};
+
+
+// Volumes are dense with (slice, row, column) ordering, column fastest.
+using volume_dims_t = std::array<int64_t, 3>;
+
+// Correlate a real volume with a real kernel:
+//
+//   out(z, r, c) = sum_{i,j,k} kernel(i, j, k) * in(z + i - centre[0], r + j - centre[1], c + k - centre[2]),
+//
+// where voxels outside the input volume are treated as zero. Convolution is the same operation with a spatially
+// inverted kernel (and centre).
+//
+// Large volumes are processed in independent tiles using the overlap-save method, so memory use is bounded by the tile
+// size rather than the volume size. Tiles are processed in parallel.
+std::vector<double>
+Correlate_Volume_FFT( const std::vector<double> &in,
+                      const volume_dims_t &in_dims,
+                      const std::vector<double> &kernel,
+                      const volume_dims_t &kernel_dims,
+                      const volume_dims_t &kernel_centre,
+                      int64_t max_tile_extent = 128 );
+
+// Whether Correlate_Volume_FFT() is expected to be faster than evaluating the correlation directly at every voxel.
+bool Prefer_FFT_Correlation( const volume_dims_t &in_dims,
+                             const volume_dims_t &kernel_dims,
+                             int64_t max_tile_extent = 128 );
+
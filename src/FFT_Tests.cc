@@ -0,0 +1,142 @@
+//FFT_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the FFT routines defined in FFT.cc.
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "FFT.h"
+
+
+// Direct evaluation of the correlation, for comparison.
+static
+std::vector<double>
+direct_correlation( const std::vector<double> &in,
+                    const volume_dims_t &in_dims,
+                    const std::vector<double> &kernel,
+                    const volume_dims_t &kernel_dims,
+                    const volume_dims_t &kernel_centre ){
+    std::vector<double> out(in.size(), 0.0);
+    for(int64_t z = 0; z < in_dims[0]; ++z){
+        for(int64_t r = 0; r < in_dims[1]; ++r){
+            for(int64_t c = 0; c < in_dims[2]; ++c){
+                double sum = 0.0;
+                for(int64_t i = 0; i < kernel_dims[0]; ++i){
+                    for(int64_t j = 0; j < kernel_dims[1]; ++j){
+                        for(int64_t k = 0; k < kernel_dims[2]; ++k){
+                            const auto l_z = z + i - kernel_centre[0];
+                            const auto l_r = r + j - kernel_centre[1];
+                            const auto l_c = c + k - kernel_centre[2];
+                            if( (l_z < 0) || (in_dims[0] <= l_z)
+                            ||  (l_r < 0) || (in_dims[1] <= l_r)
+                            ||  (l_c < 0) || (in_dims[2] <= l_c) ) continue;
+                            sum += kernel[(i * kernel_dims[1] + j) * kernel_dims[2] + k]
+                                 * in[(l_z * in_dims[1] + l_r) * in_dims[2] + l_c];
+                        }
+                    }
+                }
+                out[(z * in_dims[1] + r) * in_dims[2] + c] = sum;
+            }
+        }
+    }
+    return out;
+}
+
+
+TEST_CASE( "fft_radix2 and fft_real_radix2" ){
+    std::mt19937 re(123456);
+    std::uniform_real_distribution<double> rd(-10.0, 10.0);
+
+    SUBCASE("complex transforms round-trip"){
+        for(int64_t n : { 1, 2, 4, 8, 64 }){
+            fft_radix2 fft(n);
+            std::vector<std::complex<double>> x;
+            for(int64_t i = 0; i < n; ++i) x.emplace_back(rd(re), rd(re));
+            auto y = x;
+            fft.transform(y.data(), false);
+            fft.transform(y.data(), true);
+            for(int64_t i = 0; i < n; ++i){
+                REQUIRE( std::abs(y[i] / static_cast<double>(n) - x[i]) < 1E-9 );
+            }
+        }
+    }
+
+    SUBCASE("real transforms match complex transforms"){
+        for(int64_t n : { 2, 4, 16, 128 }){
+            fft_radix2 fft(n);
+            fft_real_radix2 rfft(n);
+            std::vector<double> x;
+            std::vector<std::complex<double>> xc;
+            for(int64_t i = 0; i < n; ++i){
+                x.emplace_back(rd(re));
+                xc.emplace_back(x.back(), 0.0);
+            }
+            fft.transform(xc.data(), false);
+
+            std::vector<std::complex<double>> scratch;
+            std::vector<std::complex<double>> X(static_cast<size_t>(n / 2 + 1));
+            rfft.forward(x.data(), X.data(), scratch);
+            for(int64_t k = 0; k <= n / 2; ++k){
+                REQUIRE( std::abs(X[k] - xc[k]) < 1E-9 );
+            }
+
+            std::vector<double> y(static_cast<size_t>(n));
+            rfft.inverse(X.data(), y.data(), scratch);
+            for(int64_t i = 0; i < n; ++i){
+                REQUIRE( std::abs(y[i] / static_cast<double>(n) - x[i]) < 1E-9 );
+            }
+        }
+    }
+
+    SUBCASE("non-power-of-two lengths are rejected"){
+        REQUIRE_THROWS( fft_radix2(3) );
+        REQUIRE_THROWS( fft_real_radix2(1) );
+    }
+}
+
+TEST_CASE( "Correlate_Volume_FFT matches direct correlation" ){
+    std::mt19937 re(654321);
+    std::uniform_real_distribution<double> rd(-1.0, 1.0);
+
+    const auto make_volume = [&](const volume_dims_t &dims){
+        std::vector<double> out;
+        for(int64_t i = 0; i < dims[0] * dims[1] * dims[2]; ++i) out.emplace_back(rd(re));
+        return out;
+    };
+
+    const auto compare = [&](const volume_dims_t &in_dims,
+                             const volume_dims_t &kernel_dims,
+                             const volume_dims_t &kernel_centre,
+                             int64_t max_tile_extent){
+        const auto in = make_volume(in_dims);
+        const auto kernel = make_volume(kernel_dims);
+        const auto expected = direct_correlation(in, in_dims, kernel, kernel_dims, kernel_centre);
+        const auto actual = Correlate_Volume_FFT(in, in_dims, kernel, kernel_dims, kernel_centre, max_tile_extent);
+        REQUIRE( actual.size() == expected.size() );
+        for(size_t i = 0; i < expected.size(); ++i){
+            REQUIRE( std::abs(actual[i] - expected[i]) < 1E-9 );
+        }
+    };
+
+    SUBCASE("single tile"){
+        compare( {5, 7, 9}, {3, 3, 3}, {1, 1, 1}, 128 );
+        compare( {1, 12, 10}, {1, 4, 5}, {0, 2, 2}, 128 );
+        compare( {6, 1, 1}, {3, 1, 1}, {1, 0, 0}, 128 );
+    }
+
+    SUBCASE("multiple overlap-save tiles"){
+        compare( {9, 21, 17}, {3, 5, 4}, {1, 2, 2}, 8 );
+        compare( {7, 13, 30}, {2, 3, 7}, {0, 1, 3}, 4 );
+    }
+
+    SUBCASE("kernels larger than the volume"){
+        compare( {3, 4, 5}, {5, 6, 7}, {2, 3, 3}, 8 );
+    }
+}
+
@@ -0,0 +1,292 @@
+//Gaussian_Filter.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file provides separable Gaussian smoothing of regular voxel volumes.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Thread_Pool.h"
+#include "Voxel_Volume.h"
+#include "Gaussian_Filter.h"
+
+
+namespace {
+
+// The normalized recursive Gaussian coefficients {B, a1, a2, a3} of Young and van Vliet for the given parameter q.
+std::array<double, 4> recursive_coefficients(double q){
+    const double q2 = q * q;
+    const double q3 = q2 * q;
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    const double b3 = 0.422205 * q3;
+    const double a1 = b1 / b0;
+    const double a2 = b2 / b0;
+    const double a3 = b3 / b0;
+    return {{ 1.0 - (a1 + a2 + a3), a1, a2, a3 }};
+}
+
+} // namespace
+
+
+gaussian_line_filter::gaussian_line_filter(double sigma, method m, double truncate) : m(m) {
+    if( !std::isfinite(sigma)
+    ||  (sigma < 0.0)
+    ||  !std::isfinite(truncate)
+    ||  (truncate <= 0.0) ){
+        throw std::invalid_argument("Gaussian sigma and truncation must be finite and non-negative");
+    }
+
+    if( (this->m == method::Recursive)
+    &&  (0.5 <= sigma) ){
+        // Coefficients from Young and van Vliet, Signal Processing 44 (1995) 139-151.
+        const double q = (2.5 <= sigma) ? (0.98711 * sigma - 0.96330)
+                                        : (3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma));
+        const auto c = recursive_coefficients(q);
+        this->B = c[0];
+        this->a1 = c[1];
+        this->a2 = c[2];
+        this->a3 = c[3];
+
+        // Samples beyond the end of a line are zero, but the causal pass does not stop responding there. The tail of
+        // the causal response only depends on the final three causal outputs, so the anti-causal pass can be started
+        // exactly by evaluating the tail once for each of them here.
+        for(int64_t k = 0; k < 3; ++k){
+            std::vector<double> tail = { 0.0, 0.0, 0.0 };
+            tail[static_cast<size_t>(k)] = 1.0; // The causal outputs at offsets (n-3, n-2, n-1).
+            for(int64_t i = 0; i < 1'000'000; ++i){
+                const auto N = tail.size();
+                tail.push_back( this->a1 * tail[N - 1] + this->a2 * tail[N - 2] + this->a3 * tail[N - 3] );
+                if( (std::abs(tail[N]) < 1E-14)
+                &&  (std::abs(tail[N - 1]) < 1E-14)
+                &&  (std::abs(tail[N - 2]) < 1E-14) ) break;
+            }
+            std::vector<double> anticausal(tail.size() + 3, 0.0);
+            for(int64_t i = static_cast<int64_t>(tail.size()) - 1; 3 <= i; --i){
+                anticausal[i] = this->B * tail[i] + this->a1 * anticausal[i + 1]
+                                                  + this->a2 * anticausal[i + 2]
+                                                  + this->a3 * anticausal[i + 3];
+            }
+            for(int64_t l = 0; l < 3; ++l){
+                this->tail_response[static_cast<size_t>(l * 3 + k)] = anticausal[static_cast<size_t>(3 + l)];
+            }
+        }
+        return;
+    }
+
+    // Explicit weights, sampled at integer offsets.
+    this->m = method::Explicit;
+    this->weights = { 1.0 };
+    const auto extent = static_cast<int64_t>(std::ceil(truncate * sigma));
+    if( (0.0 < sigma)
+    &&  (0 < extent) ){
+        this->weights.clear();
+        double sum = 0.0;
+        for(int64_t i = -extent; i <= extent; ++i){
+            const auto x = static_cast<double>(i) / sigma;
+            this->weights.push_back( std::exp(-0.5 * x * x) );
+            sum += this->weights.back();
+        }
+        for(auto &w : this->weights) w /= sum;
+    }
+}
+
+gaussian_line_filter::gaussian_line_filter(std::vector<double> weights) : weights(std::move(weights)) {
+    if( this->weights.empty()
+    ||  ((this->weights.size() % 2) == 0) ){
+        throw std::invalid_argument("Explicit filter weights must have odd length");
+    }
+}
+
+bool gaussian_line_filter::is_identity() const {
+    return (this->m == method::Explicit)
+        && (this->weights.size() == 1)
+        && (this->weights.front() == 1.0);
+}
+
+void gaussian_line_filter::apply(float *data, int64_t n, int64_t stride, int64_t width, std::vector<double> &scratch) const {
+    if( (n <= 0) || (width <= 0) ) return;
+    if(stride < width){
+        throw std::invalid_argument("Line stride must not be smaller than the number of lines");
+    }
+
+    // The numerator and denominator of the normalized convolution are filtered together. Omitted samples contribute
+    // zero to both, so the denominator holds the sum of the weights that were actually used.
+    const int64_t N = n * width;
+    scratch.assign(static_cast<size_t>(4 * N + 7 * width), 0.0);
+    double *val = scratch.data();
+    double *wgt = val + N;
+    double *num = wgt + N;
+    double *den = num + N;
+    double *num_end = den + N;
+    double *den_end = num_end + 3 * width;
+    const double *zero = den_end + 3 * width;
+
+    for(int64_t i = 0; i < n; ++i){
+        const float *d = data + i * stride;
+        double *v = val + i * width;
+        double *w = wgt + i * width;
+        for(int64_t j = 0; j < width; ++j){
+            const bool is_finite = std::isfinite(d[j]);
+            v[j] = is_finite ? static_cast<double>(d[j]) : 0.0;
+            w[j] = is_finite ? 1.0 : 0.0;
+        }
+    }
+
+    if(this->m == method::Explicit){
+        const auto extent = static_cast<int64_t>(this->weights.size() / 2);
+        for(int64_t i = 0; i < n; ++i){
+            double *nr = num + i * width;
+            double *dr = den + i * width;
+            const int64_t k_lo = std::max<int64_t>(-extent, -i);
+            const int64_t k_hi = std::min<int64_t>(extent, n - 1 - i);
+            for(int64_t k = k_lo; k <= k_hi; ++k){
+                const double c = this->weights[static_cast<size_t>(k + extent)];
+                const double *v = val + (i + k) * width;
+                const double *w = wgt + (i + k) * width;
+                for(int64_t j = 0; j < width; ++j){
+                    nr[j] += c * v[j];
+                    dr[j] += c * w[j];
+                }
+            }
+        }
+
+    }else{
+        // Samples beyond the ends of the line are zero (in both numerator and denominator).
+        const auto recurse = [&](const double *in, double *out, const double *p1, const double *p2, const double *p3){
+            for(int64_t j = 0; j < width; ++j){
+                out[j] = this->B * in[j] + this->a1 * p1[j] + this->a2 * p2[j] + this->a3 * p3[j];
+            }
+        };
+        const auto row = [&](const double *base, const double *end, int64_t i) -> const double * {
+            return (i < 0) ? zero
+                           : (n <= i) ? (end + (i - n) * width)
+                                      : (base + i * width);
+        };
+
+        // Causal pass.
+        for(int64_t i = 0; i < n; ++i){
+            recurse(val + i * width, num + i * width, row(num, zero, i - 1), row(num, zero, i - 2), row(num, zero, i - 3));
+            recurse(wgt + i * width, den + i * width, row(den, zero, i - 1), row(den, zero, i - 2), row(den, zero, i - 3));
+        }
+
+        // The anti-causal outputs just beyond the end of the line, which account for the causal response there.
+        const auto extend = [&](const double *base, double *end){
+            for(int64_t l = 0; l < 3; ++l){
+                for(int64_t k = 0; k < 3; ++k){
+                    const double c = this->tail_response[static_cast<size_t>(l * 3 + k)];
+                    const double *w = (n + k - 3 < 0) ? zero : (base + (n + k - 3) * width);
+                    for(int64_t j = 0; j < width; ++j) end[l * width + j] += c * w[j];
+                }
+            }
+        };
+        extend(num, num_end);
+        extend(den, den_end);
+
+        // Anti-causal pass, in-place.
+        for(int64_t i = n - 1; 0 <= i; --i){
+            recurse(num + i * width, num + i * width, row(num, num_end, i + 1), row(num, num_end, i + 2), row(num, num_end, i + 3));
+            recurse(den + i * width, den + i * width, row(den, den_end, i + 1), row(den, den_end, i + 2), row(den, den_end, i + 3));
+        }
+    }
+
+    // Voxels with negligible support are considered inaccessible.
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    for(int64_t i = 0; i < n; ++i){
+        float *d = data + i * stride;
+        const double *nr = num + i * width;
+        const double *dr = den + i * width;
+        for(int64_t j = 0; j < width; ++j){
+            d[j] = (1E-3 < dr[j]) ? static_cast<float>(nr[j] / dr[j]) : nan;
+        }
+    }
+    return;
+}
+
+
+void Gaussian_Blur_Slice( voxel_volume<float> &vol,
+                          int64_t frame,
+                          int64_t slice,
+                          const gaussian_line_filter &along_rows,
+                          const gaussian_line_filter &along_cols ){
+    const int64_t R = vol.rows;
+    const int64_t C = vol.cols;
+    const int64_t N_ch = vol.channels;
+    if( (R <= 0) || (C <= 0) || (N_ch <= 0) ) return;
+    float *img = &vol.reference(frame, slice, 0, 0, 0);
+    std::vector<double> scratch;
+
+    // Along rows. Lines are the (column, channel) pairs, which are contiguous.
+    if( (1 < R) && !along_rows.is_identity() ){
+        along_rows.apply( img, R, vol.row_stride(), vol.row_stride(), scratch );
+    }
+
+    // Along columns. The image is transposed so the (row, channel) pairs become contiguous lines.
+    if( (1 < C) && !along_cols.is_identity() ){
+        std::vector<float> transposed(static_cast<size_t>(R * C * N_ch));
+        for(int64_t r = 0; r < R; ++r){
+            for(int64_t c = 0; c < C; ++c){
+                for(int64_t ch = 0; ch < N_ch; ++ch){
+                    transposed[(c * R + r) * N_ch + ch] = img[(r * C + c) * N_ch + ch];
+                }
+            }
+        }
+        along_cols.apply( transposed.data(), C, R * N_ch, R * N_ch, scratch );
+        for(int64_t r = 0; r < R; ++r){
+            for(int64_t c = 0; c < C; ++c){
+                for(int64_t ch = 0; ch < N_ch; ++ch){
+                    img[(r * C + c) * N_ch + ch] = transposed[(c * R + r) * N_ch + ch];
+                }
+            }
+        }
+    }
+    return;
+}
+
+void Gaussian_Blur_Volume( voxel_volume<float> &vol,
+                           const gaussian_line_filter &along_slices,
+                           const gaussian_line_filter &along_rows,
+                           const gaussian_line_filter &along_cols ){
+    const int64_t F = vol.frames;
+    const int64_t S = vol.slices;
+    const int64_t R = vol.rows;
+    const int64_t C = vol.cols;
+    const int64_t N_ch = vol.channels;
+    if( (F <= 0) || (S <= 0) || (R <= 0) || (C <= 0) || (N_ch <= 0) ) return;
+
+    if( !along_rows.is_identity()
+    ||  !along_cols.is_identity() ){
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t f = 0; f < F; ++f){
+            for(int64_t z = 0; z < S; ++z){
+                wq.submit_task([&,f,z]() -> void {
+                    Gaussian_Blur_Slice(vol, f, z, along_rows, along_cols);
+                });
+            }
+        }
+    } // Wait for all tasks to complete.
+
+    // Along slices. Lines are the (column, channel) pairs of each row, which are contiguous within each image.
+    if( (1 < S) && !along_slices.is_identity() ){
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t f = 0; f < F; ++f){
+            for(int64_t r = 0; r < R; ++r){
+                wq.submit_task([&,f,r]() -> void {
+                    std::vector<double> scratch;
+                    along_slices.apply( &vol.reference(f, 0, r, 0, 0), S, vol.slice_stride(), vol.row_stride(), scratch );
+                });
+            }
+        }
+    } // Wait for all tasks to complete.
+
+    return;
+}
+
@@ -0,0 +1,75 @@
+//Gaussian_Filter.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// Separable Gaussian smoothing of regular voxel volumes.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Voxel_Volume.h"
+
+
+// A one-dimensional smoothing filter that is applied to many parallel lines of samples at once.
+//
+// Non-finite samples, and samples beyond the ends of a line, are omitted and the remaining weights are renormalized
+// (i.e., normalized convolution). Samples without sufficient finite support become NaN.
+class gaussian_line_filter {
+    public:
+        enum class method {
+            Explicit,  // Direct convolution with truncated weights. Cost grows linearly with sigma.
+            Recursive, // Young-van Vliet recursive (IIR) approximation. Cost is independent of sigma.
+        };
+
+    private:
+        method m = method::Explicit;
+
+        // Explicit weights, centred on the middle element.
+        std::vector<double> weights = { 1.0 };
+
+        // Recursive coefficients: y[i] = B * x[i] + a1 * y[i-1] + a2 * y[i-2] + a3 * y[i-3], applied forward and then
+        // backward.
+        double B = 1.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+        double a3 = 0.0;
+
+        // The anti-causal outputs at offsets (n, n+1, n+2) due to unit causal outputs at offsets (n-3, n-2, n-1),
+        // where n is the number of samples in the line, in row-major order.
+        std::array<double, 9> tail_response = {};
+
+    public:
+        // The identity filter.
+        gaussian_line_filter() = default;
+
+        // A Gaussian with the given sigma (in units of samples). Explicit weights extend to 'truncate' sigma. The
+        // recursive approximation is only valid for sigma >= 0.5, so narrower Gaussians use explicit weights.
+        gaussian_line_filter(double sigma, method m, double truncate = 3.0);
+
+        // Explicit weights centred on the middle element. The number of weights must be odd.
+        explicit gaussian_line_filter(std::vector<double> weights);
+
+        bool is_identity() const;
+
+        // Filter 'width' independent lines of 'n' samples each. Sample i of line j is data[i * stride + j], so lines are
+        // interleaved, which lets the inner loops run over contiguous memory. The scratch buffer is resized as needed.
+        void apply(float *data, int64_t n, int64_t stride, int64_t width, std::vector<double> &scratch) const;
+};
+
+
+// Filter all channels of a single image of the volume along the row and column axes successively.
+void Gaussian_Blur_Slice( voxel_volume<float> &vol,
+                          int64_t frame,
+                          int64_t slice,
+                          const gaussian_line_filter &along_rows,
+                          const gaussian_line_filter &along_cols );
+
+// Filter all channels of every frame along the row, column, and slice axes successively. Images and lines are processed
+// in parallel.
+void Gaussian_Blur_Volume( voxel_volume<float> &vol,
+                           const gaussian_line_filter &along_slices,
+                           const gaussian_line_filter &along_rows,
+                           const gaussian_line_filter &along_cols );
+
@@ -0,0 +1,169 @@
+//Gaussian_Filter_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the Gaussian filters defined in Gaussian_Filter.cc.
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "Voxel_Volume.h"
+#include "Gaussian_Filter.h"
+
+
+// Direct evaluation of a truncated, normalized Gaussian along a single line, omitting non-finite samples.
+static
+std::vector<double>
+direct_gaussian(const std::vector<float> &in, double sigma, double truncate){
+    const auto extent = static_cast<int64_t>(std::ceil(truncate * sigma));
+    const auto n = static_cast<int64_t>(in.size());
+    std::vector<double> out;
+    for(int64_t i = 0; i < n; ++i){
+        double num = 0.0;
+        double den = 0.0;
+        double sum = 0.0;
+        for(int64_t k = -extent; k <= extent; ++k){
+            const auto x = static_cast<double>(k) / sigma;
+            const auto w = std::exp(-0.5 * x * x);
+            sum += w;
+            const auto l = i + k;
+            if( (l < 0) || (n <= l) || !std::isfinite(in[l]) ) continue;
+            num += w * in[l];
+            den += w;
+        }
+        out.push_back( (1E-3 < den / sum) ? num / den : std::numeric_limits<double>::quiet_NaN() );
+    }
+    return out;
+}
+
+
+TEST_CASE( "gaussian_line_filter" ){
+    std::mt19937 re(13579);
+    std::uniform_real_distribution<float> rd(-10.0f, 10.0f);
+
+    SUBCASE("identity filters leave lines unaltered"){
+        gaussian_line_filter f;
+        REQUIRE( f.is_identity() );
+        REQUIRE( gaussian_line_filter(0.0, gaussian_line_filter::method::Explicit).is_identity() );
+
+        std::vector<float> x = { 1.0f, 2.0f, 3.0f };
+        std::vector<double> scratch;
+        f.apply(x.data(), 3, 1, 1, scratch);
+        REQUIRE( x == std::vector<float>{ 1.0f, 2.0f, 3.0f } );
+    }
+
+    SUBCASE("explicit filters match direct evaluation on interleaved lines"){
+        const int64_t n = 40;
+        const int64_t width = 3;
+        const int64_t stride = 5;
+        const double sigma = 2.3;
+        std::vector<float> x(static_cast<size_t>(n * stride), -1.0f);
+        std::vector<std::vector<float>> lines(width);
+        for(int64_t i = 0; i < n; ++i){
+            for(int64_t j = 0; j < width; ++j){
+                const auto v = ((i + j) % 7 == 3) ? std::numeric_limits<float>::quiet_NaN() : rd(re);
+                x[i * stride + j] = v;
+                lines[j].push_back(v);
+            }
+        }
+
+        gaussian_line_filter f(sigma, gaussian_line_filter::method::Explicit);
+        std::vector<double> scratch;
+        f.apply(x.data(), n, stride, width, scratch);
+
+        for(int64_t j = 0; j < width; ++j){
+            const auto expected = direct_gaussian(lines[j], sigma, 3.0);
+            for(int64_t i = 0; i < n; ++i){
+                REQUIRE( std::abs(x[i * stride + j] - expected[i]) < 1E-4 );
+            }
+        }
+
+        // Padding between lines must not be touched.
+        for(int64_t i = 0; i < n; ++i){
+            for(int64_t j = width; j < stride; ++j){
+                REQUIRE( x[i * stride + j] == -1.0f );
+            }
+        }
+    }
+
+    SUBCASE("recursive filters approximate Gaussians"){
+        const double pi = std::acos(-1.0);
+        for(const double sigma : { 1.0, 3.0, 8.0 }){
+            const int64_t n = 201;
+            const int64_t mid = n / 2;
+            std::vector<float> impulse(static_cast<size_t>(n), 0.0f);
+            impulse[mid] = 1.0f;
+
+            gaussian_line_filter f(sigma, gaussian_line_filter::method::Recursive);
+            REQUIRE( !f.is_identity() );
+            std::vector<double> scratch;
+            f.apply(impulse.data(), n, 1, 1, scratch);
+
+            const double peak = 1.0 / (sigma * std::sqrt(2.0 * pi));
+            double sum = 0.0;
+            for(int64_t i = 0; i < n; ++i){
+                const auto x = static_cast<double>(i - mid) / sigma;
+                const auto expected = peak * std::exp(-0.5 * x * x);
+                REQUIRE( std::abs(impulse[i] - expected) < 0.1 * peak );
+                sum += impulse[i];
+            }
+            REQUIRE( std::abs(sum - 1.0) < 1E-3 );
+        }
+    }
+
+    SUBCASE("constant lines are preserved, including near the ends"){
+        for(const auto m : { gaussian_line_filter::method::Explicit, gaussian_line_filter::method::Recursive }){
+            std::vector<float> x(50, 7.0f);
+            x[10] = std::numeric_limits<float>::infinity();
+            gaussian_line_filter f(4.0, m);
+            std::vector<double> scratch;
+            f.apply(x.data(), 50, 1, 1, scratch);
+            for(const auto &v : x) REQUIRE( std::abs(v - 7.0f) < 1E-4 );
+        }
+    }
+
+    SUBCASE("invalid parameters are rejected"){
+        REQUIRE_THROWS( gaussian_line_filter(-1.0, gaussian_line_filter::method::Explicit) );
+        REQUIRE_THROWS( gaussian_line_filter(std::vector<double>{ 0.5, 0.5 }) );
+    }
+}
+
+TEST_CASE( "Gaussian_Blur_Volume" ){
+    voxel_volume<float> vol;
+    vol.frames = 1;
+    vol.slices = 6;
+    vol.rows = 7;
+    vol.cols = 8;
+    vol.channels = 2;
+    vol.data.resize(static_cast<size_t>(vol.frame_stride()), 0.0f);
+
+    SUBCASE("blurring is separable and treats each axis independently"){
+        vol.reference(0, 3, 2, 5, 1) = 1.0f;
+
+        const std::vector<double> w = { 0.25, 0.5, 0.25 };
+        Gaussian_Blur_Volume(vol, gaussian_line_filter(w), gaussian_line_filter(w), gaussian_line_filter(w));
+
+        for(int64_t z = 0; z < vol.slices; ++z){
+            for(int64_t r = 0; r < vol.rows; ++r){
+                for(int64_t c = 0; c < vol.cols; ++c){
+                    const auto wz = (std::abs(z - 3) <= 1) ? w[z - 3 + 1] : 0.0;
+                    const auto wr = (std::abs(r - 2) <= 1) ? w[r - 2 + 1] : 0.0;
+                    const auto wc = (std::abs(c - 5) <= 1) ? w[c - 5 + 1] : 0.0;
+                    REQUIRE( std::abs(vol.value(0, z, r, c, 1) - wz * wr * wc) < 1E-6 );
+                    REQUIRE( vol.value(0, z, r, c, 0) == 0.0f );
+                }
+            }
+        }
+    }
+
+    SUBCASE("identity filters leave the volume unaltered"){
+        vol.reference(0, 1, 2, 3, 0) = 5.0f;
+        const auto orig = vol.data;
+        Gaussian_Blur_Volume(vol, gaussian_line_filter(), gaussian_line_filter(), gaussian_line_filter());
+        REQUIRE( vol.data == orig );
+    }
+}
+
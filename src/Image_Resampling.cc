@@ -0,0 +1,223 @@
+//Image_Resampling.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file provides trilinear resampling of regular voxel grids onto the voxels of arbitrary planar images.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "Voxel_Volume.h"
+#include "Image_Resampling.h"
+
+
+namespace {
+
+// Whether a fractional index along an axis with 'n' voxels lies within the extent of the voxels.
+inline bool accessible(double f, int64_t n){
+    return (-0.5 <= f) && (f <= static_cast<double>(n) - 0.5);
+}
+
+inline bool accessible(const resampling_grid &grid, double fx, double fy, double fz){
+    return accessible(fx, grid.vol.cols)
+        && accessible(fy, grid.vol.rows)
+        && (grid.clamp_slices || accessible(fz, grid.vol.slices));
+}
+
+// Split a fractional index into the lower voxel and the interpolation weight of the upper voxel. Indices are clamped
+// to the grid. The upper voxel is only used when its weight is non-zero, so it is always within the grid.
+struct axis_sample {
+    int64_t i0;
+    int64_t i1;
+    double t;
+};
+
+inline axis_sample split_index(double f, int64_t n){
+    const double c = std::clamp(f, 0.0, static_cast<double>(n - 1));
+    const auto i0 = std::min(static_cast<int64_t>(c), n - 1);
+    const double t = c - static_cast<double>(i0);
+    return { i0, (0.0 < t) ? (i0 + 1) : i0, t };
+}
+
+// Trilinearly interpolate an accessible fractional index.
+inline double interpolate(const resampling_grid &grid, double fx, double fy, double fz, int64_t chnl){
+    const auto &vol = grid.vol;
+    const auto X = split_index(fx, vol.cols);
+    const auto Y = split_index(fy, vol.rows);
+    const auto Z = split_index(fz, vol.slices);
+
+    const float *d = vol.data.data();
+    const auto cs = vol.col_stride();
+    const auto rs = vol.row_stride();
+    const auto ss = vol.slice_stride();
+    const auto lerp_x = [&](int64_t z, int64_t y) -> double {
+        const auto base = z * ss + y * rs + chnl;
+        const double a = d[base + X.i0 * cs];
+        if(X.i1 == X.i0) return a;
+        const double b = d[base + X.i1 * cs];
+        return a + X.t * (b - a);
+    };
+    const auto lerp_xy = [&](int64_t z) -> double {
+        const double a = lerp_x(z, Y.i0);
+        if(Y.i1 == Y.i0) return a;
+        const double b = lerp_x(z, Y.i1);
+        return a + Y.t * (b - a);
+    };
+    const double a = lerp_xy(Z.i0);
+    if(Z.i1 == Z.i0) return a;
+    const double b = lerp_xy(Z.i1);
+    return a + Z.t * (b - a);
+}
+
+// The axis of a regular grid along which voxels are separated by 'step', or 'unit' spaced 'spacing' apart if the grid
+// has a single voxel along the axis.
+std::optional<vec3<double>> grid_axis(const vec3<double> &step, int64_t n, const vec3<double> &unit, double spacing){
+    if(1 < n){
+        const auto sq_len = step.Dot(step);
+        if(!std::isfinite(sq_len) || (sq_len <= 0.0)) return {};
+        return step / sq_len;
+    }
+    if(!std::isfinite(spacing) || (spacing <= 0.0)) return {};
+    return unit / spacing;
+}
+
+} // namespace
+
+
+vec3<double> resampling_grid::fractional_index(const vec3<double> &pos) const {
+    const auto d = pos - this->vol.origin;
+    return vec3<double>( d.Dot(this->col_axis), d.Dot(this->row_axis), d.Dot(this->slice_axis) );
+}
+
+float resampling_grid::sample(const vec3<double> &pos, int64_t chnl, float inaccessible_val) const {
+    if( (chnl < 0) || (this->vol.channels <= chnl) || this->vol.data.empty() ) return inaccessible_val;
+    const auto f = this->fractional_index(pos);
+    if(!accessible(*this, f.x, f.y, f.z)) return inaccessible_val;
+    return static_cast<float>(interpolate(*this, f.x, f.y, f.z, chnl));
+}
+
+
+std::optional<resampling_grid>
+Prepare_Resampling_Grid(const planar_image_collection<float,double> &coll,
+                        const std::shared_ptr<const voxel_grid_index<float,double>> &cached_index){
+    // The index refers to the images by (non-const) pointer, but it is only used to copy the voxels, so the images are
+    // never modified.
+    auto &mcoll = const_cast<planar_image_collection<float,double> &>(coll);
+    const auto index = Current_Voxel_Grid_Index(cached_index, mcoll);
+    if(!index || (index->frames != 1)) return {};
+
+    const auto &img0 = coll.images.front();
+    resampling_grid grid;
+    grid.vol = Marshal_To_Voxel_Volume<float>(*index);
+
+    const auto col_axis = grid_axis(grid.vol.col_step, grid.vol.cols, img0.row_unit.unit(), img0.pxl_dx);
+    const auto row_axis = grid_axis(grid.vol.row_step, grid.vol.rows, img0.col_unit.unit(), img0.pxl_dy);
+    const auto slice_axis = grid_axis(grid.vol.slice_step, grid.vol.slices, img0.ortho_unit(), img0.pxl_dz);
+    if(!col_axis || !row_axis || !slice_axis) return {};
+    grid.col_axis = col_axis.value();
+    grid.row_axis = row_axis.value();
+    grid.slice_axis = slice_axis.value();
+    return grid;
+}
+
+
+void Resample_Row(const resampling_grid &grid,
+                  const planar_image<float,double> &img,
+                  int64_t row,
+                  int64_t col_begin,
+                  int64_t col_end,
+                  int64_t chnl,
+                  float inaccessible_val,
+                  float *out){
+    const auto N = col_end - col_begin;
+    if(N <= 0) return;
+    if( (chnl < 0) || (grid.vol.channels <= chnl) || grid.vol.data.empty() ){
+        std::fill(out, out + N, inaccessible_val);
+        return;
+    }
+
+    // Fractional indices advance by a constant increment along the row.
+    const auto p0 = img.position(row, col_begin);
+    const auto A = grid.fractional_index(p0);
+    const auto B = (1 < N) ? (grid.fractional_index(img.position(row, col_begin + 1)) - A)
+                           : vec3<double>(0.0, 0.0, 0.0);
+    const auto frac = [&](int64_t k){
+        const auto dk = static_cast<double>(k);
+        return vec3<double>( A.x + B.x * dk, A.y + B.y * dk, A.z + B.z * dk );
+    };
+    const auto is_accessible = [&](int64_t k){
+        const auto f = frac(k);
+        return accessible(grid, f.x, f.y, f.z);
+    };
+
+    // The accessible voxels form a single contiguous run. Bound it analytically, then refine the endpoints so they
+    // agree exactly with the per-voxel test.
+    double k_lo = 0.0;
+    double k_hi = static_cast<double>(N - 1);
+    const auto constrain = [&](double a, double b, int64_t n){
+        const double lo = -0.5;
+        const double hi = static_cast<double>(n) - 0.5;
+        if(b == 0.0){
+            if((a < lo) || (hi < a)) k_hi = -1.0;
+            return;
+        }
+        auto k1 = (lo - a) / b;
+        auto k2 = (hi - a) / b;
+        if(k2 < k1) std::swap(k1, k2);
+        k_lo = std::max(k_lo, k1);
+        k_hi = std::min(k_hi, k2);
+    };
+    constrain(A.x, B.x, grid.vol.cols);
+    constrain(A.y, B.y, grid.vol.rows);
+    if(!grid.clamp_slices) constrain(A.z, B.z, grid.vol.slices);
+
+    int64_t first = N;
+    int64_t last = -1;
+    if( std::isfinite(k_lo) && std::isfinite(k_hi) && (k_lo <= k_hi) ){
+        first = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(k_lo)), 0, N - 1);
+        last = std::clamp<int64_t>(static_cast<int64_t>(std::floor(k_hi)), 0, N - 1);
+        while( (first <= last) && !is_accessible(first) ) ++first;
+        while( (first <= last) && !is_accessible(last) ) --last;
+        if(first <= last){
+            while( (0 < first) && is_accessible(first - 1) ) --first;
+            while( (last < (N - 1)) && is_accessible(last + 1) ) ++last;
+        }
+    }
+    if(last < first){
+        std::fill(out, out + N, inaccessible_val);
+        return;
+    }
+
+    std::fill(out, out + first, inaccessible_val);
+    for(int64_t k = first; k <= last; ++k){
+        const auto f = frac(k);
+        out[k] = static_cast<float>(interpolate(grid, f.x, f.y, f.z, chnl));
+    }
+    std::fill(out + last + 1, out + N, inaccessible_val);
+    return;
+}
+
+
+void Resample_Image(const resampling_grid &grid,
+                    planar_image<float,double> &img,
+                    int64_t chnl,
+                    float inaccessible_val){
+    std::vector<float> buf(static_cast<size_t>(std::max<int64_t>(img.columns, 0)));
+    for(int64_t c = 0; c < img.channels; ++c){
+        if( (0 <= chnl) && (c != chnl) ) continue;
+        for(int64_t row = 0; row < img.rows; ++row){
+            Resample_Row(grid, img, row, 0, img.columns, c, inaccessible_val, buf.data());
+            for(int64_t col = 0; col < img.columns; ++col){
+                img.reference(row, col, c) = buf[static_cast<size_t>(col)];
+            }
+        }
+    }
+    return;
+}
+
@@ -0,0 +1,72 @@
+//Image_Resampling.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// Trilinear resampling of regular voxel grids onto the voxels of arbitrary planar images.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "Voxel_Volume.h"
+
+
+// A regular voxel grid prepared for resampling.
+//
+// The voxels are copied into a contiguous volume and positions are mapped to fractional (slice, row, column) indices
+// with a single affine transformation, so no per-voxel image lookups are needed. Destination voxels along an image row
+// map to equally-spaced fractional indices, which lets whole rows be resampled incrementally.
+struct resampling_grid {
+    voxel_volume<float> vol;
+
+    // The fractional index of a position p along each axis is (p - vol.origin).Dot(axis).
+    vec3<double> slice_axis;
+    vec3<double> row_axis;
+    vec3<double> col_axis;
+
+    // If true, positions beyond the first or last slice take the value of the nearest slice rather than being
+    // inaccessible. This mirrors slice interpolation, which extrapolates as a constant along the image normal.
+    bool clamp_slices = false;
+
+    // The fractional (column, row, slice) index of a position, in the (x, y, z) components.
+    vec3<double> fractional_index(const vec3<double> &pos) const;
+
+    // Trilinearly interpolate the given channel at a position.
+    //
+    // Positions are accessible if they lie within the extent of the grid's voxels, i.e., up to half a voxel beyond the
+    // outermost voxel centres. Within this margin, the outermost voxels are extended as a constant. The provided value
+    // is returned for inaccessible positions and channels.
+    float sample(const vec3<double> &pos, int64_t chnl, float inaccessible_val) const;
+};
+
+// Prepare the images for resampling. Returns an empty optional if they do not form a regular grid with a single image
+// at each position.
+//
+// An index of the images, e.g., from Image_Array::get_voxel_grid_index(), can optionally be provided. It is used only
+// if it is current, otherwise the images are indexed anew.
+std::optional<resampling_grid>
+Prepare_Resampling_Grid(const planar_image_collection<float,double> &coll,
+                        const std::shared_ptr<const voxel_grid_index<float,double>> &index = nullptr);
+
+// Resample the grid at the voxels [col_begin, col_end) of the given image row, writing one value per voxel for the
+// given channel into 'out'. Values match sample() at each voxel position, up to rounding.
+void Resample_Row(const resampling_grid &grid,
+                  const planar_image<float,double> &img,
+                  int64_t row,
+                  int64_t col_begin,
+                  int64_t col_end,
+                  int64_t chnl,
+                  float inaccessible_val,
+                  float *out);
+
+// Overwrite the voxels of the image with values resampled from the grid. If the channel is negative, all channels are
+// resampled, otherwise only the given channel is.
+void Resample_Image(const resampling_grid &grid,
+                    planar_image<float,double> &img,
+                    int64_t chnl,
+                    float inaccessible_val);
+
@@ -0,0 +1,200 @@
+//Image_Resampling_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the resampling routines defined in Image_Resampling.cc.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "Image_Resampling.h"
+
+
+// A stack of axis-aligned images with voxel values given by a function of the voxel position.
+template <class F>
+static
+planar_image_collection<float,double>
+make_stack(int64_t slices, int64_t rows, int64_t cols, double pxl, const vec3<double> &origin, F f){
+    planar_image_collection<float,double> coll;
+    for(int64_t z = 0; z < slices; ++z){
+        planar_image<float,double> img;
+        img.init_orientation(vec3<double>(1.0, 0.0, 0.0), vec3<double>(0.0, 1.0, 0.0));
+        img.init_buffer(rows, cols, 1);
+        img.init_spatial(pxl, pxl, pxl, vec3<double>(0.0, 0.0, 0.0), origin + vec3<double>(0.0, 0.0, pxl * static_cast<double>(z)));
+        for(int64_t r = 0; r < rows; ++r){
+            for(int64_t c = 0; c < cols; ++c){
+                img.reference(r, c, 0) = static_cast<float>(f(img.position(r, c)));
+            }
+        }
+        coll.images.push_back(img);
+    }
+    return coll;
+}
+
+
+TEST_CASE( "Prepare_Resampling_Grid" ){
+    const auto linear = [](const vec3<double> &p){ return 2.0 * p.x - 3.0 * p.y + 0.5 * p.z; };
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+
+    SUBCASE("identical geometry reproduces the voxels"){
+        auto src = make_stack(3, 4, 5, 1.0, vec3<double>(0.0, 0.0, 0.0), linear);
+        const auto grid = Prepare_Resampling_Grid(src);
+        REQUIRE( grid );
+
+        auto dst = src;
+        for(auto &img : dst.images) img.data.assign(img.data.size(), 0.0f);
+        auto s_it = std::begin(src.images);
+        for(auto &img : dst.images){
+            Resample_Image(grid.value(), img, -1, nan);
+            REQUIRE( img.data == s_it->data );
+            ++s_it;
+        }
+    }
+
+    SUBCASE("linear fields are reproduced and out-of-bounds voxels are inaccessible"){
+        auto src = make_stack(4, 8, 8, 1.0, vec3<double>(0.0, 0.0, 0.0), linear);
+        const auto grid = Prepare_Resampling_Grid(src);
+        REQUIRE( grid );
+
+        // A finer, shifted grid that partially overlaps the source.
+        auto dst = make_stack(1, 12, 12, 0.7, vec3<double>(-1.3, 0.45, 1.2), [](const vec3<double> &){ return 0.0; });
+        auto &img = dst.images.front();
+        Resample_Image(grid.value(), img, 0, nan);
+        int64_t N_accessible = 0;
+        for(int64_t r = 0; r < img.rows; ++r){
+            for(int64_t c = 0; c < img.columns; ++c){
+                const auto p = img.position(r, c);
+                const bool inside = (-0.5 <= p.x) && (p.x <= 7.5) && (-0.5 <= p.y) && (p.y <= 7.5);
+                const auto v = img.value(r, c, 0);
+                REQUIRE( inside == std::isfinite(v) );
+                if(!inside) continue;
+                ++N_accessible;
+
+                // Within the half-voxel margin the outermost voxels are extended as a constant.
+                const vec3<double> clamped( std::clamp(p.x, 0.0, 7.0), std::clamp(p.y, 0.0, 7.0), p.z );
+                REQUIRE( v == doctest::Approx(linear(clamped)).epsilon(1E-5) );
+                REQUIRE( v == doctest::Approx(grid->sample(p, 0, nan)) );
+            }
+        }
+        REQUIRE( 0 < N_accessible );
+        REQUIRE( N_accessible < img.rows * img.columns );
+    }
+
+    SUBCASE("rows match point sampling at the boundaries"){
+        auto src = make_stack(2, 5, 5, 1.0, vec3<double>(0.0, 0.0, 0.0), linear);
+        const auto grid = Prepare_Resampling_Grid(src);
+        REQUIRE( grid );
+
+        // Rows that graze the edges of the grid.
+        auto dst = make_stack(1, 7, 11, 0.5, vec3<double>(-0.5, -1.0, 0.5), [](const vec3<double> &){ return 0.0; });
+        const auto &img = dst.images.front();
+        std::vector<float> out(static_cast<size_t>(img.columns));
+        for(int64_t r = 0; r < img.rows; ++r){
+            Resample_Row(grid.value(), img, r, 0, img.columns, 0, nan, out.data());
+            for(int64_t c = 0; c < img.columns; ++c){
+                const auto expected = grid->sample(img.position(r, c), 0, nan);
+                REQUIRE( std::isnan(expected) == std::isnan(out[c]) );
+                if(!std::isnan(expected)) REQUIRE( out[c] == doctest::Approx(expected) );
+            }
+        }
+
+        // Channels beyond the grid are inaccessible.
+        Resample_Row(grid.value(), img, 3, 0, img.columns, 1, nan, out.data());
+        for(const auto &v : out) REQUIRE( std::isnan(v) );
+    }
+
+    SUBCASE("slices can be clamped"){
+        auto src = make_stack(2, 3, 3, 1.0, vec3<double>(0.0, 0.0, 0.0), linear);
+        auto grid = Prepare_Resampling_Grid(src);
+        REQUIRE( grid );
+        const vec3<double> above(1.0, 1.0, 3.0);
+        REQUIRE( std::isnan(grid->sample(above, 0, nan)) );
+        grid->clamp_slices = true;
+        REQUIRE( grid->sample(above, 0, nan) == doctest::Approx(linear(vec3<double>(1.0, 1.0, 1.0))) );
+    }
+
+    SUBCASE("irregular grids are rejected"){
+        auto src = make_stack(3, 3, 3, 1.0, vec3<double>(0.0, 0.0, 0.0), linear);
+        src.images.back().offset += vec3<double>(0.0, 0.0, 0.5);
+        REQUIRE( !Prepare_Resampling_Grid(src) );
+
+        planar_image_collection<float,double> empty;
+        REQUIRE( !Prepare_Resampling_Grid(empty) );
+    }
+}
+
+TEST_CASE( "Prepare_Resampling_Grid matches planar image adjacency trilinear interpolation" ){
+    // An oblique, anisotropic grid with a non-linear field, so any difference in how voxels are located or weighted
+    // would be noticed.
+    const auto field = [](const vec3<double> &p){ return std::sin(0.7 * p.x) + 0.3 * p.y * p.z + 0.05 * p.x * p.x; };
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+
+    const int64_t S = 6;
+    const int64_t R = 9;
+    const int64_t C = 10;
+    const double theta = 0.3;
+    const vec3<double> row_unit( std::cos(theta), std::sin(theta), 0.0 );
+    const vec3<double> col_unit( -std::sin(theta), std::cos(theta), 0.0 );
+    const vec3<double> normal = row_unit.Cross(col_unit).unit();
+    const vec3<double> origin(2.0, -1.0, 3.0);
+    const double pxl_dx = 1.1;
+    const double pxl_dy = 0.8;
+    const double pxl_dz = 1.7;
+
+    planar_image_collection<float,double> src;
+    for(int64_t z = 0; z < S; ++z){
+        planar_image<float,double> img;
+        img.init_orientation(row_unit, col_unit);
+        img.init_buffer(R, C, 1);
+        img.init_spatial(pxl_dx, pxl_dy, pxl_dz, vec3<double>(0.0, 0.0, 0.0), origin + normal * (pxl_dz * static_cast<double>(z)));
+        for(int64_t r = 0; r < R; ++r){
+            for(int64_t c = 0; c < C; ++c){
+                img.reference(r, c, 0) = static_cast<float>(field(img.position(r, c)));
+            }
+        }
+        src.images.push_back(img);
+    }
+
+    const auto grid = Prepare_Resampling_Grid(src);
+    REQUIRE( grid );
+
+    std::list<std::reference_wrapper<planar_image_collection<float,double>>> colls = { std::ref(src) };
+    planar_image_adjacency<float,double> img_adj( {}, colls, normal );
+
+    // Positions at random fractional voxel indices, at least one voxel from the outermost voxel centres so that
+    // boundary conventions do not matter.
+    const auto &img0 = src.images.front();
+    const auto &img1 = *std::next(std::begin(src.images));
+    const auto p0 = img0.position(0, 0);
+    const auto dc = img0.position(0, 1) - p0;
+    const auto dr = img0.position(1, 0) - p0;
+    const auto ds = img1.position(0, 0) - p0;
+
+    std::mt19937 gen(20260101);
+    std::uniform_real_distribution<double> s_dist(1.0, static_cast<double>(S - 2));
+    std::uniform_real_distribution<double> r_dist(1.0, static_cast<double>(R - 2));
+    std::uniform_real_distribution<double> c_dist(1.0, static_cast<double>(C - 2));
+    for(int64_t i = 0; i < 500; ++i){
+        const auto p = p0 + ds * s_dist(gen) + dr * r_dist(gen) + dc * c_dist(gen);
+        const auto expected = img_adj.trilinearly_interpolate(p, 0, nan);
+        const auto actual = grid->sample(p, 0, nan);
+        REQUIRE( std::isfinite(expected) );
+        REQUIRE( actual == doctest::Approx(expected).epsilon(1E-5) );
+    }
+
+    // Voxel centres are reproduced exactly.
+    auto s_it = std::begin(src.images);
+    for(int64_t z = 0; z < S; ++z, ++s_it){
+        REQUIRE( grid->sample(s_it->position(4, 5), 0, nan) == doctest::Approx(s_it->value(4, 5, 0)) );
+    }
+}
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <exception>
 #include <optional>
@@ -48,6 +49,7 @@
 #include "Imebra_Shim.h"
 
 #include "DCMA_DICOM.h"
+#include "DCMA_DICOM_PixelData.h"
 #include "Structs.h"
 #include "Metadata.h"
 #include "String_Parsing.h"
@@ -878,31 +880,133 @@ YLOGINFO("    This node is a leaf node. Creating a leaf tag");
 
 
 
+//------------------ Parsed files -----------------
+namespace {
+
+// Imebra stream that reads from a mapped file rather than issuing file reads.
+class memory_view_stream : public puntoexe::baseStream {
+  private:
+    std::shared_ptr<const DCMA_DICOM::MappedFile> contents;
+
+  public:
+    explicit memory_view_stream(std::shared_ptr<const DCMA_DICOM::MappedFile> c) : contents(std::move(c)) {}
+
+    void write(imbxUint32, const imbxUint8*, imbxUint32) override {
+        throw std::logic_error("Parsed DICOM files are read-only");
+    }
+
+    imbxUint32 read(imbxUint32 startPosition, imbxUint8* pBuffer, imbxUint32 bufferLength) override {
+        const auto bytes = this->contents->bytes();
+        const auto size = static_cast<uint64_t>(bytes.size());
+        if( (bufferLength == 0) || (size <= startPosition) ) return 0;
+        const auto copy_size = static_cast<imbxUint32>( std::min<uint64_t>(bufferLength, size - startPosition) );
+        std::memcpy(pBuffer, bytes.data() + startPosition, copy_size);
+        return copy_size;
+    }
+};
+
+} // namespace
+
+struct Parsed_DICOM_File::imebra_data_set {
+    puntoexe::ptr<puntoexe::imebra::dataSet> tds;
+};
+
+// When only headers are needed, Imebra does not load values larger than this. They remain in the mapped file and are
+// read on demand.
+constexpr imbxUint32 header_only_max_buffer_load = 1024;
+
+std::shared_ptr<Parsed_DICOM_File> Open_DICOM_File(const std::filesystem::path &filename, bool header_only){
+    auto out = std::make_shared<Parsed_DICOM_File>();
+    out->filename = filename;
+    out->header_only = header_only;
+
+    out->contents = std::make_shared<const DCMA_DICOM::MappedFile>(filename);
+
+    // Parse the tag tree. Failures are not fatal since Imebra is more lenient and can be used instead.
+    try{
+        DCMA_DICOM::ReadOptions opts;
+        if(header_only) opts.stop_at_group = 0x7FE0; // Stop before the pixel data.
+
+        DCMA_DICOM::Node root;
+        root.read_DICOM(out->contents, {}, nullptr, opts);
+        out->root = std::move(root);
+    }catch(const std::exception &e){
+        YLOGDEBUG("Unable to parse '" << filename << "' as DICOM: '" << e.what() << "'");
+    }
+    return out;
+}
+
+// Parse the Imebra data set from the mapped file, or retrieve the cached copy.
+static
+puntoexe::ptr<puntoexe::imebra::dataSet>
+get_imebra_data_set(Parsed_DICOM_File &pf){
+    if(pf.imebra_ds == nullptr){
+        using namespace puntoexe;
+        ptr<baseStream> readStream(new memory_view_stream(pf.contents));
+        ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
+
+        auto ds = std::make_shared<Parsed_DICOM_File::imebra_data_set>();
+        ds->tds = pf.header_only ? imebra::codecs::codecFactory::getCodecFactory()->load(reader, header_only_max_buffer_load)
+                                 : imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+        if(ds->tds == nullptr){
+            throw std::runtime_error("Unable to parse file '"_s + pf.filename.string() + "'. Is it valid DICOM?");
+        }
+        pf.imebra_ds = std::move(ds);
+    }
+    return pf.imebra_ds->tds;
+}
+
+// Locate a top-level (i.e., not nested in a sequence) element in the DCMA_DICOM tag tree.
+static
+const DCMA_DICOM::Node *
+find_top_level_node(const Parsed_DICOM_File &pf, uint16_t group, uint16_t tag){
+    if(!pf.root) return nullptr;
+    for(const auto &c : pf.root->children){
+        if( (c.key.group == group) && (c.key.tag == tag) ) return &c;
+    }
+    return nullptr;
+}
+
+
 //------------------ General ----------------------
 //This is used to grab the contents of a single DICOM tag. It can be used for whatever. Some routines
-// use it to grab specific things. Each invocation involves disk access and file parsing.
+// use it to grab specific things. The filename overload reads and parses the file on each invocation, so prefer the
+// Parsed_DICOM_File overload when several tags are needed.
 //
-//NOTE: On error, the output will be an empty string.
+//NOTE: A tag that is not present produces an empty string. An exception is thrown if the file cannot be read or
+//      parsed.
 std::string get_tag_as_string(const std::filesystem::path &filename, size_t U, size_t L){
-    using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(filename.c_str(), std::ios::in);
-    if(readStream == nullptr) return std::string("");
+    return get_tag_as_string(*Open_DICOM_File(filename, true), U, L);
+}
 
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> TopDataSet = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
-    if(TopDataSet == nullptr) return std::string("");
+std::string get_tag_as_string(Parsed_DICOM_File &pf, size_t U, size_t L){
+    auto TopDataSet = get_imebra_data_set(pf);
     return TopDataSet->getString(U, 0, L, 0);
 }
 
 std::string get_modality(const std::filesystem::path &filename){
+    return get_modality(*Open_DICOM_File(filename, true));
+}
+
+std::string get_modality(Parsed_DICOM_File &pf){
     //Should exist in each DICOM file.
-    return get_tag_as_string(filename,0x0008,0x0060);
+    //
+    // The modality is used for dispatch, so it is read directly from the tag tree when possible. This avoids parsing
+    // the file with Imebra when it will not otherwise be needed.
+    if(const auto *n = find_top_level_node(pf, 0x0008, 0x0060); n != nullptr){
+        const auto first = n->val.substr(0, n->val.find('\\'));
+        return Canonicalize_String2(first, CANONICALIZE::TRIM_ENDS);
+    }
+    return get_tag_as_string(pf,0x0008,0x0060);
 }
 
 std::string get_patient_ID(const std::filesystem::path &filename){
+    return get_patient_ID(*Open_DICOM_File(filename, true));
+}
+
+std::string get_patient_ID(Parsed_DICOM_File &pf){
     //Should exist in each DICOM file.
-    return get_tag_as_string(filename,0x0010,0x0020);
+    return get_tag_as_string(pf,0x0010,0x0020);
 }
 
 //Mass top-level tag enumeration, for ingress into database.
@@ -910,21 +1014,21 @@ std::string get_patient_ID(const std::filesystem::path &filename){
 //NOTE: May not be complete. Add additional tags as needed!
 metadata_map_t
 get_metadata_top_level_tags(const std::filesystem::path &filename){
+    return get_metadata_top_level_tags(*Open_DICOM_File(filename, true));
+}
+
+metadata_map_t
+get_metadata_top_level_tags(Parsed_DICOM_File &pf){
+    if(pf.top_level_tags) return pf.top_level_tags.value();
+
     metadata_map_t out;
     const auto ctrim = CANONICALIZE::TRIM_ENDS;
+    const auto &filename = pf.filename;
 
     //Attempt to parse the DICOM file and harvest the elements of interest. We are only interested in
     // top-level elements specifying metadata (i.e., not pixel data) and will not need to recurse into 
     // any DICOM sequences.
-    puntoexe::ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(filename.c_str(), std::ios::in);
-    if(readStream == nullptr){
-        YLOGWARN("Could not parse file '" << filename << "'. Is it valid DICOM? Cannot continue");
-        return out;
-    }
-
-    puntoexe::ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    puntoexe::ptr<puntoexe::imebra::dataSet> tds = puntoexe::imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+    puntoexe::ptr<puntoexe::imebra::dataSet> tds = get_imebra_data_set(pf);
 
     //We pull out all the data we need as strings. For single element strings, the SQL engine can directly perform
     // the type casting. The benefit of this is twofold: (1) the SQL engine hides the checking code, simplifying
@@ -1576,6 +1680,7 @@ get_metadata_top_level_tags(const std::filesystem::path &filename){
 
     insert_as_string_if_nonempty(0x0008, 0x0090, "ReferringPhysicianName");
 
+    pf.top_level_tags = out;
     return out;
 }
 
@@ -1586,12 +1691,12 @@ get_metadata_top_level_tags(const std::filesystem::path &filename){
 //Returns a bimap with the (raw) ROI tags and their corresponding ROI numbers. The ROI numbers are
 // arbitrary identifiers used within the DICOM file to identify contours more conveniently.
 bimap<std::string,int64_t> get_ROI_tags_and_numbers(const std::filesystem::path &FilenameIn){
-    using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(FilenameIn.c_str(), std::ios::in);
+    return get_ROI_tags_and_numbers(*Open_DICOM_File(FilenameIn));
+}
 
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> TopDataSet = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+bimap<std::string,int64_t> get_ROI_tags_and_numbers(Parsed_DICOM_File &pf){
+    using namespace puntoexe;
+    ptr<imebra::dataSet> TopDataSet = get_imebra_data_set(pf);
     ptr<imebra::dataSet> SecondDataSet;
 
     size_t i=0, j;
@@ -1626,16 +1731,17 @@ bimap<std::string,int64_t> get_ROI_tags_and_numbers(const std::filesystem::path
 
 //Returns contour data from a DICOM RTSTRUCT file sorted into ROI-specific collections.
 std::unique_ptr<Contour_Data> get_Contour_Data(const std::filesystem::path &filename){
+    return get_Contour_Data(*Open_DICOM_File(filename));
+}
+
+std::unique_ptr<Contour_Data> get_Contour_Data(Parsed_DICOM_File &pf){
     auto output = std::make_unique<Contour_Data>();
-    bimap<std::string,int64_t> tags_names_and_numbers = get_ROI_tags_and_numbers(filename);
+    bimap<std::string,int64_t> tags_names_and_numbers = get_ROI_tags_and_numbers(pf);
 
-    auto FileMetadata = get_metadata_top_level_tags(filename);
+    auto FileMetadata = get_metadata_top_level_tags(pf);
 
     using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(filename.c_str(), std::ios::in);
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> TopDataSet = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+    ptr<imebra::dataSet> TopDataSet = get_imebra_data_set(pf);
     ptr<imebra::dataSet> SecondDataSet, ThirdDataSet;
 
     //Collect the data into a container of contours with meta info. It may be unordered (within the file).
@@ -1770,17 +1876,18 @@ std::unique_ptr<Contour_Data> get_Contour_Data(const std::filesystem::path &file
 // Note that individual images loaded as part of a set will likely need to be collated.
 std::unique_ptr<Image_Array>
 Load_Image_Array(const std::filesystem::path &FilenameIn){
+    return Load_Image_Array(*Open_DICOM_File(FilenameIn));
+}
+
+std::unique_ptr<Image_Array>
+Load_Image_Array(Parsed_DICOM_File &pf){
     const auto inf = std::numeric_limits<double>::infinity();
     auto out = std::make_unique<Image_Array>();
 
     using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(FilenameIn.c_str(), std::ios::in);
+    ptr<imebra::dataSet> TopDataSet = get_imebra_data_set(pf);
 
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> TopDataSet = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
-
-    const auto tlm = get_metadata_top_level_tags(FilenameIn);
+    const auto tlm = get_metadata_top_level_tags(pf);
 
     const auto l_coalesce_metadata_as_vector_double = [&tlm](const std::list<std::string>& keys ){
         return convert_to_vector_double( coalesce_metadata_as_string(tlm, keys) );
@@ -1806,6 +1913,11 @@ Load_Image_Array(const std::filesystem::path &FilenameIn){
     const auto modality = l_coalesce_as_string({ { {0x0008, 0x0060, 0} } }).value();
     const auto frame_count = l_coalesce_as_long_int({ { {0x0028, 0x0008, 0} } }).value_or(1);
 
+    // Natively-encoded monochrome pixel data can be extracted directly from the cached tag tree, bypassing Imebra's
+    // decoding. This is only done when the raw stored values would be used anyway (see below).
+    std::optional<planar_image_collection<float,double>> native_imgs;
+    bool native_imgs_attempted = false;
+
     // ---------------------------------------- Image Metadata ----------------------------------------------
 
     for(uint32_t f = 0; f < frame_count; ++f){
@@ -2060,6 +2172,42 @@ Load_Image_Array(const std::filesystem::path &FilenameIn){
 
         const bool real_world_map_present = !!real_world_mapping;
 
+        // -------------------------------------- Native Pixel Data ----------------------------------------
+        // When a real-world mapping is present (or for RTIMAGE) the raw stored values are used, and Imebra does not
+        // need to transform monochrome images. These can be taken from the tag tree directly.
+        const bool raw_values_used = real_world_map_present || (modality == "RTIMAGE");
+        if(raw_values_used && pf.root && !native_imgs_attempted){
+            native_imgs_attempted = true;
+            const auto desc = DCMA_DICOM::get_pixel_data_desc(pf.root.value());
+            if( desc
+            &&  DCMA_DICOM::is_native_transfer_syntax(desc->transfer_syntax)
+            &&  (desc->samples_per_pixel == 1)
+            &&  (desc->photometric_interpretation == "MONOCHROME2")
+            &&  (static_cast<int64_t>(desc->number_of_frames) == frame_count) ){
+                native_imgs = DCMA_DICOM::extract_native_pixel_data(pf.root.value());
+            }
+        }
+        if( raw_values_used
+        &&  native_imgs
+        &&  (f < native_imgs->images.size()) ){
+            auto &n_img = *std::next(std::begin(native_imgs->images), f);
+            if( (n_img.rows == image_rows)
+            &&  (n_img.columns == image_cols)
+            &&  (n_img.channels == 1) ){
+                auto &img = out->imagecoll.images.back();
+                img.metadata = l_meta;
+                img.init_orientation(image_orien_r, image_orien_c);
+                img.init_buffer(image_rows, image_cols, 1);
+                img.init_spatial(image_pxldx, image_pxldy, image_thickness, image_anchor, image_pos);
+
+                std::swap(img.data, n_img.data);
+                if(real_world_map_present){
+                    for(auto &v : img.data) v = real_world_mapping(v);
+                }
+                continue;
+            }
+        }
+
         // -------------------------------------- Image Pixel Data -----------------------------------------
         ptr<puntoexe::imebra::image> firstImage;
         try{
@@ -2301,7 +2449,12 @@ std::unique_ptr<Image_Array> Collate_Image_Arrays(std::list<std::shared_ptr<Imag
 //--------------------- Dose -----------------------
 //This routine reads a single DICOM dose file.
 std::unique_ptr<Image_Array>  Load_Dose_Array(const std::filesystem::path &FilenameIn){
-    auto metadata = get_metadata_top_level_tags(FilenameIn);
+    return Load_Dose_Array(*Open_DICOM_File(FilenameIn));
+}
+
+std::unique_ptr<Image_Array>  Load_Dose_Array(Parsed_DICOM_File &pf){
+    const auto &FilenameIn = pf.filename;
+    auto metadata = get_metadata_top_level_tags(pf);
     if(metadata["Modality"] != "RTDOSE"){
         throw std::runtime_error("Unsupported modality");
     }
@@ -2309,11 +2462,7 @@ std::unique_ptr<Image_Array>  Load_Dose_Array(const std::filesystem::path &Filen
     auto out = std::make_unique<Image_Array>();
 
     using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(FilenameIn.c_str(), std::ios::in);
-
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> TopDataSet = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+    ptr<imebra::dataSet> TopDataSet = get_imebra_data_set(pf);
 
     //These should exist in all files. They appear to be the same for CT and DS files of the same set. Not sure
     // if this is *always* the case.
@@ -2480,18 +2629,19 @@ std::list<std::shared_ptr<Image_Array>>  Load_Dose_Arrays(const std::list<std::f
 
 std::unique_ptr<RTPlan> 
 Load_RTPlan(const std::filesystem::path &FilenameIn){
+    return Load_RTPlan(*Open_DICOM_File(FilenameIn));
+}
+
+std::unique_ptr<RTPlan> 
+Load_RTPlan(Parsed_DICOM_File &pf){
     std::unique_ptr<RTPlan> out(new RTPlan());
 
     using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(FilenameIn.c_str(), std::ios::in);
-
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> base_node_ptr = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+    ptr<imebra::dataSet> base_node_ptr = get_imebra_data_set(pf);
 
 
     // ------------------------------------------- General --------------------------------------------------
-    out->metadata = get_metadata_top_level_tags(FilenameIn);
+    out->metadata = get_metadata_top_level_tags(pf);
     if(out->metadata["Modality"] != "RTPLAN"){
         throw std::runtime_error("Unsupported modality");
     }
@@ -2837,17 +2987,18 @@ Load_RTPlan(const std::filesystem::path &FilenameIn){
 // See DICOM standard, Spatial Registration Module (C.20.2).
 std::unique_ptr<Transform3>
 Load_Transform(const std::filesystem::path &FilenameIn){
+    return Load_Transform(*Open_DICOM_File(FilenameIn));
+}
+
+std::unique_ptr<Transform3>
+Load_Transform(Parsed_DICOM_File &pf){
     std::unique_ptr<Transform3> out(new Transform3());
 
     using namespace puntoexe;
-    ptr<puntoexe::stream> readStream(new puntoexe::stream);
-    readStream->openFile(FilenameIn.c_str(), std::ios::in);
-
-    ptr<puntoexe::streamReader> reader(new puntoexe::streamReader(readStream));
-    ptr<imebra::dataSet> base_node_ptr = imebra::codecs::codecFactory::getCodecFactory()->load(reader);
+    ptr<imebra::dataSet> base_node_ptr = get_imebra_data_set(pf);
 
     // ------------------------------------------- General --------------------------------------------------
-    out->metadata = get_metadata_top_level_tags(FilenameIn);
+    out->metadata = get_metadata_top_level_tags(pf);
     if(out->metadata["Modality"] != "REG"){
         throw std::runtime_error("Unsupported modality");
     }
@@ -7,6 +7,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <filesystem>
@@ -23,29 +24,74 @@ class Contour_Data;
 class Image_Array;
 
 
+//------------------ Parsed files -----------------
+//A DICOM file that has been read from disk and parsed once.
+//
+//The routines below that accept a filename will each open and parse the file anew. When several are needed for the
+// same file (e.g., modality dispatch followed by metadata extraction and pixel loading), open a handle once and pass
+// it to the handle-accepting overloads instead. The file is read into memory exactly once and its header is parsed
+// into a DCMA_DICOM tag tree. The Imebra data set and the top-level metadata are parsed lazily from the in-memory copy
+// (not the filesystem) the first time they are needed, and are then cached.
+//
+//NOTE: A handle is not thread-safe, but distinct handles can be used concurrently.
+struct Parsed_DICOM_File {
+    std::filesystem::path filename;
+
+    // The raw file contents, memory-mapped where possible. Shared with the tag tree, which refers to large binary
+    // values (e.g., pixel data) in place rather than copying them.
+    std::shared_ptr<const DCMA_DICOM::MappedFile> contents;
+
+    // The DCMA_DICOM tag tree. Empty if DCMA_DICOM could not parse the file (e.g., big-endian encoding), in which case
+    // consumers fall back to Imebra.
+    std::optional<DCMA_DICOM::Node> root;
+
+    // If true, only the header was parsed: the tag tree stops before the pixel data and Imebra leaves large values in
+    // the mapped file until they are accessed.
+    bool header_only = false;
+
+    // Lazily-populated caches. These are maintained by the shim.
+    struct imebra_data_set;
+    std::shared_ptr<imebra_data_set> imebra_ds;
+    std::optional<metadata_map_t> top_level_tags;
+};
+
+//Read and parse a file. Throws if the file cannot be read.
+//
+// Set 'header_only' when only metadata is needed (e.g., when scanning many files). Pixel data and other large values
+// are then skipped rather than parsed.
+std::shared_ptr<Parsed_DICOM_File> Open_DICOM_File(const std::filesystem::path &filename, bool header_only = false);
+
+
 //------------------ General ----------------------
 //One-offs.
 std::string get_tag_as_string(const std::filesystem::path &filename, size_t U, size_t L);
+std::string get_tag_as_string(Parsed_DICOM_File &pf, size_t U, size_t L);
 
 std::string get_modality(const std::filesystem::path &filename);
+std::string get_modality(Parsed_DICOM_File &pf);
 
 std::string get_patient_ID(const std::filesystem::path &filename);
+std::string get_patient_ID(Parsed_DICOM_File &pf);
 
 //Mass top-level tag enumeration, for ingress into database.
 //
 //NOTE: May not be complete. Add additional tags as needed!
 metadata_map_t get_metadata_top_level_tags(const std::filesystem::path &filename);
+metadata_map_t get_metadata_top_level_tags(Parsed_DICOM_File &pf);
 
 
 //------------------ Contours ---------------------
 bimap<std::string,int64_t> get_ROI_tags_and_numbers(const std::filesystem::path &filename);
+bimap<std::string,int64_t> get_ROI_tags_and_numbers(Parsed_DICOM_File &pf);
 
 std::unique_ptr<Contour_Data>  get_Contour_Data(const std::filesystem::path &filename);
+std::unique_ptr<Contour_Data>  get_Contour_Data(Parsed_DICOM_File &pf);
 
 
 //-------------------- Images ----------------------
 //This routine will often result in an array with only a single image. So collate output as needed.
 std::unique_ptr<Image_Array> Load_Image_Array(const std::filesystem::path &filename);
+std::unique_ptr<Image_Array> Load_Image_Array(Parsed_DICOM_File &pf);
 
 //These pointers will actually be unique. This just aims to convert from unique_ptr to shared_ptr for you.
 std::list<std::shared_ptr<Image_Array>>  Load_Image_Arrays(const std::list<std::filesystem::path> &filenames);
@@ -56,15 +102,18 @@ std::unique_ptr<Image_Array> Collate_Image_Arrays(std::list<std::shared_ptr<Imag
 
 //--------------------- Dose -----------------------
 std::unique_ptr<Image_Array> Load_Dose_Array(const std::filesystem::path &filename);
+std::unique_ptr<Image_Array> Load_Dose_Array(Parsed_DICOM_File &pf);
 
 //These pointers will actually be unique. This just aims to convert from unique_ptr to shared_ptr for you.
 std::list<std::shared_ptr<Image_Array>>  Load_Dose_Arrays(const std::list<std::filesystem::path> &filenames);
 
 //-------------------- Plans ------------------------
 std::unique_ptr<RTPlan> Load_RTPlan(const std::filesystem::path &filename);
+std::unique_ptr<RTPlan> Load_RTPlan(Parsed_DICOM_File &pf);
 
 //---------------- Registrations --------------------
 std::unique_ptr<Transform3> Load_Transform(const std::filesystem::path &filename);
+std::unique_ptr<Transform3> Load_Transform(Parsed_DICOM_File &pf);
 
 //-------------------- Export -----------------------
 //Writes an Image_Array as if it were a dose matrix.
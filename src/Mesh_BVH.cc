@@ -0,0 +1,558 @@
+//Mesh_BVH.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// A bounding volume hierarchy (BVH) over the faces of a surface mesh, which accelerates geometric queries.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "YgorMath.h"         //Needed for vec3 class and fv_surface_mesh.
+
+#include "Mesh_BVH.h"
+
+namespace dcma_surface_meshes {
+
+static
+double
+component(const vec3<double> &v, int64_t axis){
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+static
+vec3<double>
+elementwise_min(const vec3<double> &a, const vec3<double> &b){
+    return vec3<double>( std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) );
+}
+
+static
+vec3<double>
+elementwise_max(const vec3<double> &a, const vec3<double> &b){
+    return vec3<double>( std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) );
+}
+
+// Squared distance from a point to an axis-aligned box, which is zero inside the box.
+static
+double
+sq_dist_to_box(const vec3<double> &p, const vec3<double> &min, const vec3<double> &max){
+    const auto dx = std::max<double>({ min.x - p.x, 0.0, p.x - max.x });
+    const auto dy = std::max<double>({ min.y - p.y, 0.0, p.y - max.y });
+    const auto dz = std::max<double>({ min.z - p.z, 0.0, p.z - max.z });
+    return dx*dx + dy*dy + dz*dz;
+}
+
+// The interval of ray parameter t for which the ray is within an axis-aligned box. The interval is empty if the ray
+// misses the box.
+static
+std::pair<double, double>
+ray_box_interval(const vec3<double> &o, const vec3<double> &inv_dir, const vec3<double> &dir,
+                 const vec3<double> &min, const vec3<double> &max){
+    double t_near = -std::numeric_limits<double>::infinity();
+    double t_far = std::numeric_limits<double>::infinity();
+    for(int64_t axis = 0; axis < 3; ++axis){
+        const auto o_a = component(o, axis);
+        const auto min_a = component(min, axis);
+        const auto max_a = component(max, axis);
+        if(component(dir, axis) == 0.0){
+            if( (o_a < min_a) || (max_a < o_a) ) return { 1.0, 0.0 };
+            continue;
+        }
+        const auto inv_a = component(inv_dir, axis);
+        auto t0 = (min_a - o_a) * inv_a;
+        auto t1 = (max_a - o_a) * inv_a;
+        if(t1 < t0) std::swap(t0, t1);
+        t_near = std::max(t_near, t0);
+        t_far = std::min(t_far, t1);
+    }
+    return { t_near, t_far };
+}
+
+// Moller-Trumbore ray-triangle intersection. Provides the ray parameter and barycentric coordinates, or nothing if the
+// ray is parallel to the triangle.
+struct ray_triangle_t {
+    double t;
+    double u;
+    double v;
+};
+
+static
+std::optional<ray_triangle_t>
+intersect_ray_triangle(const vec3<double> &o, const vec3<double> &dir, const std::array<vec3<double>, 3> &tri){
+    const auto e1 = tri[1] - tri[0];
+    const auto e2 = tri[2] - tri[0];
+    const auto p = dir.Cross(e2);
+    const auto det = e1.Dot(p);
+
+    // Relative to the magnitude of the vectors involved.
+    const auto scale = e1.length() * e2.length() * dir.length();
+    if(!(std::abs(det) > scale * 1E-12)) return std::nullopt;
+
+    const auto inv_det = 1.0 / det;
+    const auto s = o - tri[0];
+    const auto q = s.Cross(e1);
+    return ray_triangle_t{ e2.Dot(q) * inv_det, s.Dot(p) * inv_det, dir.Dot(q) * inv_det };
+}
+
+// The point on a triangle closest to the given point. Follows Ericson, "Real-Time Collision Detection," section 5.1.5.
+static
+vec3<double>
+closest_point_on_triangle(const vec3<double> &p, const std::array<vec3<double>, 3> &tri){
+    const auto &a = tri[0];
+    const auto &b = tri[1];
+    const auto &c = tri[2];
+    const auto ab = b - a;
+    const auto ac = c - a;
+
+    const auto ap = p - a;
+    const auto d1 = ab.Dot(ap);
+    const auto d2 = ac.Dot(ap);
+    if( (d1 <= 0.0) && (d2 <= 0.0) ) return a;
+
+    const auto bp = p - b;
+    const auto d3 = ab.Dot(bp);
+    const auto d4 = ac.Dot(bp);
+    if( (0.0 <= d3) && (d4 <= d3) ) return b;
+
+    const auto vc = d1*d4 - d3*d2;
+    if( (vc <= 0.0) && (0.0 <= d1) && (d3 <= 0.0) ){
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const auto cp = p - c;
+    const auto d5 = ab.Dot(cp);
+    const auto d6 = ac.Dot(cp);
+    if( (0.0 <= d6) && (d5 <= d6) ) return c;
+
+    const auto vb = d5*d2 - d1*d6;
+    if( (vb <= 0.0) && (0.0 <= d2) && (d6 <= 0.0) ){
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    const auto va = d3*d6 - d5*d4;
+    if( (va <= 0.0) && (0.0 <= (d4 - d3)) && (0.0 <= (d5 - d6)) ){
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    const auto denom = va + vb + vc;
+    if(!(denom != 0.0)){
+        return a; // Degenerate triangle; the edge checks above have already handled the relevant cases.
+    }
+    const auto v = vb / denom;
+    const auto w = vc / denom;
+    return a + ab * v + ac * w;
+}
+
+
+face_bvh::face_bvh(const fv_surface_mesh<double, uint64_t> &mesh) : fp(fingerprint(mesh)) {
+    const auto N_verts = static_cast<uint64_t>(mesh.vertices.size());
+    const auto N_faces = static_cast<uint64_t>(mesh.faces.size());
+
+    std::vector<std::array<vec3<double>, 3>> l_tris;
+    std::vector<std::array<uint64_t, 3>> l_tri_verts;
+    std::vector<uint64_t> l_tri_faces;
+    for(uint64_t f = 0; f < N_faces; ++f){
+        const auto &face = mesh.faces[f];
+        for(size_t i = 1; (i + 1) < face.size(); ++i){
+            const std::array<uint64_t, 3> v {{ face[0], face[i], face[i + 1] }};
+            if( (N_verts <= v[0]) || (N_verts <= v[1]) || (N_verts <= v[2]) ){
+                throw std::invalid_argument("Face refers to a nonexistent vertex. Cannot continue.");
+            }
+            l_tris.push_back({{ mesh.vertices[v[0]], mesh.vertices[v[1]], mesh.vertices[v[2]] }});
+            l_tri_verts.push_back(v);
+            l_tri_faces.push_back(f);
+        }
+    }
+    const auto N_tris = static_cast<int64_t>(l_tris.size());
+    if(N_tris == 0) return;
+
+    std::vector<vec3<double>> centroids;
+    centroids.reserve(N_tris);
+    for(const auto &t : l_tris){
+        centroids.emplace_back( (t[0] + t[1] + t[2]) / 3.0 );
+    }
+
+    std::vector<int64_t> order(N_tris);
+    for(int64_t i = 0; i < N_tris; ++i) order[i] = i;
+
+    this->tris = l_tris;
+    this->nodes.reserve(2 * (N_tris / 2 + 1));
+    this->build(0, N_tris, order, centroids);
+
+    // Store the triangles in leaf order so each leaf refers to a contiguous range.
+    for(int64_t i = 0; i < N_tris; ++i){
+        this->tris[i] = l_tris[order[i]];
+    }
+    this->tri_verts.resize(N_tris);
+    this->tri_faces.resize(N_tris);
+    for(int64_t i = 0; i < N_tris; ++i){
+        this->tri_verts[i] = l_tri_verts[order[i]];
+        this->tri_faces[i] = l_tri_faces[order[i]];
+    }
+}
+
+int64_t
+face_bvh::build(int64_t begin, int64_t end, std::vector<int64_t> &order, const std::vector<vec3<double>> &centroids){
+    constexpr int64_t max_leaf_size = 4;
+
+    const auto n_i = static_cast<int64_t>(this->nodes.size());
+    this->nodes.emplace_back();
+
+    const auto inf = std::numeric_limits<double>::infinity();
+    vec3<double> min(inf, inf, inf);
+    vec3<double> max(-inf, -inf, -inf);
+    vec3<double> c_min = min;
+    vec3<double> c_max = max;
+    for(int64_t i = begin; i < end; ++i){
+        for(const auto &v : this->tris[order[i]]){
+            min = elementwise_min(min, v);
+            max = elementwise_max(max, v);
+        }
+        c_min = elementwise_min(c_min, centroids[order[i]]);
+        c_max = elementwise_max(c_max, centroids[order[i]]);
+    }
+    this->nodes[n_i].min = min;
+    this->nodes[n_i].max = max;
+
+    // Split at the median centroid along the axis with the greatest centroid extent.
+    const auto extent = c_max - c_min;
+    int64_t axis = 0;
+    if(component(extent, axis) < extent.y) axis = 1;
+    if(component(extent, axis) < extent.z) axis = 2;
+    if( ((end - begin) <= max_leaf_size)
+    ||  !(0.0 < component(extent, axis)) ){
+        this->nodes[n_i].index = begin;
+        this->nodes[n_i].count = end - begin;
+        return n_i;
+    }
+
+    const auto mid = begin + (end - begin) / 2;
+    std::nth_element( std::next(std::begin(order), begin),
+                      std::next(std::begin(order), mid),
+                      std::next(std::begin(order), end),
+                      [&](int64_t a, int64_t b){
+                          return component(centroids[a], axis) < component(centroids[b], axis);
+                      });
+
+    this->build(begin, mid, order, centroids);
+    const auto second = this->build(mid, end, order, centroids);
+    this->nodes[n_i].index = second;
+    this->nodes[n_i].count = 0;
+    return n_i;
+}
+
+uint64_t
+face_bvh::fingerprint(const fv_surface_mesh<double, uint64_t> &mesh){
+    uint64_t h = 0;
+    const auto digest = [&h](uint64_t x){
+        // SplitMix64 finalizer applied to the running state.
+        h += x + 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        h = h ^ (h >> 31);
+    };
+    const auto digest_double = [&digest](double d){
+        uint64_t x;
+        std::memcpy(&x, &d, sizeof(x));
+        digest(x);
+    };
+
+    digest(mesh.vertices.size());
+    for(const auto &v : mesh.vertices){
+        digest_double(v.x);
+        digest_double(v.y);
+        digest_double(v.z);
+    }
+    digest(mesh.faces.size());
+    for(const auto &f : mesh.faces){
+        digest(f.size());
+        for(const auto &i : f) digest(i);
+    }
+    return h;
+}
+
+uint64_t
+face_bvh::mesh_fingerprint() const {
+    return this->fp;
+}
+
+int64_t
+face_bvh::triangle_count() const {
+    return static_cast<int64_t>(this->tris.size());
+}
+
+contour_collection<double>
+face_bvh::slice(const plane<double> &p) const {
+    contour_collection<double> cc;
+    if(this->nodes.empty()) return cc;
+
+    const auto N = p.N_0.unit();
+    const auto offset = N.Dot(p.R_0);
+    const auto N_abs = vec3<double>( std::abs(N.x), std::abs(N.y), std::abs(N.z) );
+
+    // Segments are directed and their endpoints are identified by the mesh edge they lie on.
+    using edge_t = std::pair<uint64_t, uint64_t>;
+    struct edge_hash {
+        size_t operator()(const edge_t &e) const {
+            return std::hash<uint64_t>()(e.first * 0x9E3779B97F4A7C15ULL ^ e.second);
+        }
+    };
+    struct segment_t {
+        edge_t A;
+        edge_t B;
+        vec3<double> P_A;
+        vec3<double> P_B;
+    };
+    std::vector<segment_t> segments;
+
+    std::vector<int64_t> stack;
+    stack.push_back(0);
+    while(!stack.empty()){
+        const auto &n = this->nodes[stack.back()];
+        const auto n_i = stack.back();
+        stack.pop_back();
+
+        // Vertices on the plane are treated as being below it, so only boxes that extend above the plane are relevant.
+        const auto centre = (n.min + n.max) * 0.5;
+        const auto radius = N_abs.Dot((n.max - n.min) * 0.5);
+        const auto dist = N.Dot(centre) - offset;
+        if( (radius < dist) || ((dist + radius) <= 0.0) ) continue;
+
+        if(n.count == 0){
+            stack.push_back(n.index);
+            stack.push_back(n_i + 1);
+            continue;
+        }
+
+        for(int64_t i = n.index; i < (n.index + n.count); ++i){
+            const auto &t = this->tris[i];
+            const auto &tv = this->tri_verts[i];
+            const std::array<double, 3> d {{ N.Dot(t[0]) - offset,
+                                             N.Dot(t[1]) - offset,
+                                             N.Dot(t[2]) - offset }};
+            const std::array<bool, 3> above {{ (0.0 < d[0]), (0.0 < d[1]), (0.0 < d[2]) }};
+            if( (above[0] == above[1]) && (above[1] == above[2]) ) continue;
+
+            // The segment is oriented using the face winding rather than geometry, which is unreliable when the
+            // intersection collapses onto a vertex. The face normal points to the right of the segment when viewed
+            // from above the plane.
+            int64_t k = 0;
+            while( (above[k] == above[(k + 1) % 3]) || (above[k] == above[(k + 2) % 3]) ) ++k;
+            std::array<std::array<int64_t, 2>, 2> sides {{ {{ k, (k + 1) % 3 }}, {{ (k + 2) % 3, k }} }};
+            if(!above[k]) std::swap(sides[0], sides[1]);
+
+            std::array<edge_t, 2> keys;
+            std::array<vec3<double>, 2> pts;
+            for(int64_t j = 0; j < 2; ++j){
+                auto a = sides[j][0];
+                auto b = sides[j][1];
+
+                // Interpolate from the lower-numbered vertex so neighbouring faces agree exactly.
+                if(tv[b] < tv[a]) std::swap(a, b);
+                keys[j] = { tv[a], tv[b] };
+                pts[j] = t[a] + (t[b] - t[a]) * (d[a] / (d[a] - d[b]));
+            }
+            segments.push_back({ keys[0], keys[1], pts[0], pts[1] });
+        }
+    }
+
+    // Chain the segments into contours.
+    const auto N_segments = static_cast<int64_t>(segments.size());
+    std::unordered_map<edge_t, int64_t, edge_hash> starts;
+    std::unordered_map<edge_t, int64_t, edge_hash> ends;
+    for(int64_t i = 0; i < N_segments; ++i){
+        starts.emplace(segments[i].A, i);
+        ends.emplace(segments[i].B, i);
+    }
+
+    std::vector<bool> used(N_segments, false);
+    for(int64_t i = 0; i < N_segments; ++i){
+        if(used[i]) continue;
+
+        // Find the beginning of the chain, in case it is not closed.
+        int64_t first = i;
+        for(int64_t steps = 0; steps < N_segments; ++steps){
+            const auto it = ends.find(segments[first].A);
+            if( (it == std::end(ends))
+            ||  (it->second == i)
+            ||  used[it->second] ) break;
+            first = it->second;
+        }
+
+        contour_of_points<double> c;
+        bool closed = false;
+        int64_t s = first;
+        while(true){
+            used[s] = true;
+            if( c.points.empty() || !(c.points.back() == segments[s].P_A) ){
+                c.points.push_back(segments[s].P_A);
+            }
+            const auto it = starts.find(segments[s].B);
+            if(it == std::end(starts)) break;
+            if(it->second == first){
+                closed = true;
+                break;
+            }
+            if(used[it->second]) break;
+            s = it->second;
+        }
+        if( !closed
+        &&  !(c.points.back() == segments[s].P_B) ){
+            c.points.push_back(segments[s].P_B);
+        }
+        if( closed
+        &&  (1 < c.points.size())
+        &&  (c.points.back() == c.points.front()) ){
+            c.points.pop_back();
+        }
+
+        // Disregard degenerate cases.
+        if(c.points.size() < (closed ? 3U : 2U)) continue;
+        c.closed = closed;
+        cc.contours.emplace_back(std::move(c));
+    }
+    return cc;
+}
+
+std::optional<face_bvh::ray_hit>
+face_bvh::ray_cast(const vec3<double> &origin, const vec3<double> &dir, double max_t) const {
+    std::optional<ray_hit> out;
+    if(this->nodes.empty()) return out;
+
+    const vec3<double> inv_dir( 1.0 / dir.x, 1.0 / dir.y, 1.0 / dir.z );
+    double best_t = max_t;
+
+    std::vector<int64_t> stack;
+    stack.push_back(0);
+    while(!stack.empty()){
+        const auto n_i = stack.back();
+        stack.pop_back();
+        const auto &n = this->nodes[n_i];
+
+        const auto [t_near, t_far] = ray_box_interval(origin, inv_dir, dir, n.min, n.max);
+        if( (t_far < t_near) || (t_far < 0.0) || (best_t < t_near) ) continue;
+
+        if(n.count == 0){
+            stack.push_back(n.index);
+            stack.push_back(n_i + 1);
+            continue;
+        }
+        for(int64_t i = n.index; i < (n.index + n.count); ++i){
+            const auto h = intersect_ray_triangle(origin, dir, this->tris[i]);
+            if( !h
+            ||  (h->u < 0.0) || (h->v < 0.0) || (1.0 < (h->u + h->v))
+            ||  (h->t < 0.0) || (best_t < h->t) ) continue;
+
+            best_t = h->t;
+            out = ray_hit{ h->t, this->tri_faces[i], origin + dir * h->t };
+        }
+    }
+    return out;
+}
+
+std::optional<face_bvh::closest_point_t>
+face_bvh::closest_point(const vec3<double> &p) const {
+    std::optional<closest_point_t> out;
+    if(this->nodes.empty()) return out;
+
+    double best_sq_dist = std::numeric_limits<double>::infinity();
+
+    std::vector<int64_t> stack;
+    stack.push_back(0);
+    while(!stack.empty()){
+        const auto n_i = stack.back();
+        stack.pop_back();
+        const auto &n = this->nodes[n_i];
+        if(best_sq_dist <= sq_dist_to_box(p, n.min, n.max)) continue;
+
+        if(n.count == 0){
+            // Visit the nearer child first so more of the tree can be pruned.
+            auto near = n_i + 1;
+            auto far = n.index;
+            const auto &c1 = this->nodes[near];
+            const auto &c2 = this->nodes[far];
+            if(sq_dist_to_box(p, c2.min, c2.max) < sq_dist_to_box(p, c1.min, c1.max)) std::swap(near, far);
+            stack.push_back(far);
+            stack.push_back(near);
+            continue;
+        }
+        for(int64_t i = n.index; i < (n.index + n.count); ++i){
+            const auto q = closest_point_on_triangle(p, this->tris[i]);
+            const auto sq_dist = q.sq_dist(p);
+            if(sq_dist < best_sq_dist){
+                best_sq_dist = sq_dist;
+                out = closest_point_t{ q, this->tri_faces[i], 0.0 };
+            }
+        }
+    }
+    if(out) out->distance = std::sqrt(best_sq_dist);
+    return out;
+}
+
+std::optional<int64_t>
+face_bvh::count_crossings(const vec3<double> &origin, const vec3<double> &dir, bool tolerate_ambiguity) const {
+    constexpr double eps = 1E-9;
+    int64_t crossings = 0;
+    if(this->nodes.empty()) return crossings;
+
+    const vec3<double> inv_dir( 1.0 / dir.x, 1.0 / dir.y, 1.0 / dir.z );
+
+    std::vector<int64_t> stack;
+    stack.push_back(0);
+    while(!stack.empty()){
+        const auto n_i = stack.back();
+        stack.pop_back();
+        const auto &n = this->nodes[n_i];
+
+        const auto [t_near, t_far] = ray_box_interval(origin, inv_dir, dir, n.min, n.max);
+        if( (t_far < t_near) || (t_far < 0.0) ) continue;
+
+        if(n.count == 0){
+            stack.push_back(n.index);
+            stack.push_back(n_i + 1);
+            continue;
+        }
+        for(int64_t i = n.index; i < (n.index + n.count); ++i){
+            const auto h = intersect_ray_triangle(origin, dir, this->tris[i]);
+            if(!h){
+                if(!tolerate_ambiguity) return std::nullopt;
+                continue;
+            }
+            const auto w = 1.0 - h->u - h->v;
+            if( (h->t < -eps) || (h->u < -eps) || (h->v < -eps) || (w < -eps) ) continue;
+            if( (h->t < eps) || (h->u < eps) || (h->v < eps) || (w < eps) ){
+                if(!tolerate_ambiguity) return std::nullopt;
+                if( (h->t < 0.0) || (h->u < 0.0) || (h->v < 0.0) || (w < 0.0) ) continue;
+            }
+            ++crossings;
+        }
+    }
+    return crossings;
+}
+
+bool
+face_bvh::is_inside(const vec3<double> &p) const {
+    // Rays in directions unlikely to align with mesh features.
+    const std::array<vec3<double>, 4> dirs {{ vec3<double>( 0.5377,  0.8247, -0.1754),
+                                              vec3<double>(-0.3313,  0.2859,  0.8992),
+                                              vec3<double>( 0.7071, -0.4987,  0.5014),
+                                              vec3<double>(-0.6158, -0.7032, -0.3551) }};
+    for(const auto &d : dirs){
+        const auto crossings = this->count_crossings(p, d, false);
+        if(crossings) return (crossings.value() % 2) == 1;
+    }
+
+    // Every ray encountered an ambiguous crossing, which can happen if the point lies on the surface.
+    return (this->count_crossings(p, dirs.front(), true).value() % 2) == 1;
+}
+
+} // namespace dcma_surface_meshes
+
@@ -0,0 +1,91 @@
+//Mesh_BVH.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// A bounding volume hierarchy (BVH) over the faces of a surface mesh, which accelerates geometric queries.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "YgorMath.h"         //Needed for vec3 class and fv_surface_mesh.
+
+namespace dcma_surface_meshes {
+
+// A BVH over the faces of an fv_surface_mesh.
+//
+// Faces with more than three vertices are split into triangle fans, and faces with fewer are ignored. The BVH holds
+// a copy of the triangles, so it remains valid if the mesh is later altered or destroyed, but it will then no longer
+// reflect the mesh. Queries are safe to perform concurrently.
+class face_bvh {
+  public:
+    explicit face_bvh(const fv_surface_mesh<double, uint64_t> &mesh);
+
+    // A digest of the mesh vertices and faces, which can be used to detect if a mesh has changed.
+    static uint64_t fingerprint(const fv_surface_mesh<double, uint64_t> &mesh);
+
+    // The fingerprint of the mesh the BVH was built from.
+    uint64_t mesh_fingerprint() const;
+
+    int64_t triangle_count() const;
+
+    // Slice the mesh with a plane, chaining the intersected faces into contours.
+    //
+    // Segments are chained through shared mesh edges, so contours are only closed where the mesh is closed and faces
+    // share vertices. If faces are oriented outward, closed contours are oriented counter-clockwise when viewed from
+    // the positive side of the plane (and holes clockwise). Vertices lying on the plane are treated as being below it.
+    contour_collection<double> slice(const plane<double> &p) const;
+
+    struct ray_hit {
+        double t;           // Distance along the ray, in units of the ray direction's length.
+        uint64_t face;      // Index of the mesh face.
+        vec3<double> point;
+    };
+
+    // Find the first intersection of a ray with the mesh, ignoring intersections beyond 'max_t'.
+    std::optional<ray_hit> ray_cast(const vec3<double> &origin,
+                                    const vec3<double> &dir,
+                                    double max_t = std::numeric_limits<double>::infinity()) const;
+
+    struct closest_point_t {
+        vec3<double> point;
+        uint64_t face;      // Index of the mesh face.
+        double distance;
+    };
+
+    // Find the point on the mesh closest to the given point. Returns nothing if the mesh has no faces.
+    std::optional<closest_point_t> closest_point(const vec3<double> &p) const;
+
+    // Determine whether a point is enclosed by the mesh using the parity of ray crossings. The mesh should be closed;
+    // if it is not, the result depends on the rays used.
+    bool is_inside(const vec3<double> &p) const;
+
+  private:
+    struct node {
+        vec3<double> min;
+        vec3<double> max;
+        int64_t index = 0;  // Index of the first triangle for leaves, or the second child for interior nodes.
+                            // The first child of an interior node immediately follows it.
+        int64_t count = 0;  // Number of triangles for leaves, or zero for interior nodes.
+    };
+
+    std::vector<node> nodes;
+    std::vector<std::array<vec3<double>, 3>> tris;  // Triangle vertex positions, ordered by leaf.
+    std::vector<std::array<uint64_t, 3>> tri_verts; // Mesh vertex indices of each triangle.
+    std::vector<uint64_t> tri_faces;                // Mesh face of each triangle.
+    uint64_t fp = 0;
+
+    int64_t build(int64_t begin, int64_t end, std::vector<int64_t> &order, const std::vector<vec3<double>> &centroids);
+
+    // Count the crossings of a ray. Unless ambiguity is tolerated, returns nothing if any crossing is too close to a
+    // triangle edge (or the triangle is too close to parallel) to be counted reliably.
+    std::optional<int64_t> count_crossings(const vec3<double> &origin,
+                                           const vec3<double> &dir,
+                                           bool tolerate_ambiguity) const;
+};
+
+} // namespace dcma_surface_meshes
+
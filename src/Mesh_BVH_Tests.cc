@@ -0,0 +1,207 @@
+//Mesh_BVH_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the bounding volume hierarchy defined in Mesh_BVH.cc.
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorMath.h"
+
+#include "Mesh_BVH.h"
+
+using namespace dcma_surface_meshes;
+
+
+// A closed, outward-oriented latitude-longitude sphere.
+static
+fv_surface_mesh<double, uint64_t>
+make_sphere(const vec3<double> &centre, double radius, int64_t N_lat, int64_t N_lon){
+    fv_surface_mesh<double, uint64_t> m;
+    m.vertices.emplace_back( centre + vec3<double>(0.0, 0.0, -radius) ); // South pole.
+    for(int64_t i = 1; i < N_lat; ++i){
+        const auto theta = M_PI * static_cast<double>(i) / static_cast<double>(N_lat);
+        for(int64_t j = 0; j < N_lon; ++j){
+            const auto phi = 2.0 * M_PI * static_cast<double>(j) / static_cast<double>(N_lon);
+            m.vertices.emplace_back( centre + vec3<double>( std::sin(theta) * std::cos(phi),
+                                                            std::sin(theta) * std::sin(phi),
+                                                           -std::cos(theta) ) * radius );
+        }
+    }
+    m.vertices.emplace_back( centre + vec3<double>(0.0, 0.0, radius) ); // North pole.
+
+    const auto ring = [&](int64_t i, int64_t j) -> uint64_t {
+        return static_cast<uint64_t>(1 + (i - 1) * N_lon + (j % N_lon));
+    };
+    const auto north = static_cast<uint64_t>(m.vertices.size() - 1);
+    for(int64_t j = 0; j < N_lon; ++j){
+        m.faces.push_back({ 0, ring(1, j + 1), ring(1, j) });
+        for(int64_t i = 1; (i + 1) < N_lat; ++i){
+            // Quads are split into triangles by the BVH.
+            m.faces.push_back({ ring(i, j), ring(i, j + 1), ring(i + 1, j + 1), ring(i + 1, j) });
+        }
+        m.faces.push_back({ ring(N_lat - 1, j), ring(N_lat - 1, j + 1), north });
+    }
+    return m;
+}
+
+static
+void
+append(fv_surface_mesh<double, uint64_t> &a, const fv_surface_mesh<double, uint64_t> &b){
+    const auto offset = static_cast<uint64_t>(a.vertices.size());
+    a.vertices.insert(std::end(a.vertices), std::begin(b.vertices), std::end(b.vertices));
+    for(auto f : b.faces){
+        for(auto &i : f) i += offset;
+        a.faces.push_back(f);
+    }
+}
+
+// Signed area of a planar contour, viewed from the +z direction.
+static
+double
+signed_area_z(const contour_of_points<double> &c){
+    double area = 0.0;
+    auto prev = c.points.back();
+    for(const auto &p : c.points){
+        area += (prev.x * p.y - p.x * prev.y) * 0.5;
+        prev = p;
+    }
+    return area;
+}
+
+// Brute-force triangle list, using the same fan triangulation as the BVH.
+static
+std::vector<std::array<vec3<double>, 3>>
+triangles(const fv_surface_mesh<double, uint64_t> &m){
+    std::vector<std::array<vec3<double>, 3>> out;
+    for(const auto &f : m.faces){
+        for(size_t i = 1; (i + 1) < f.size(); ++i){
+            out.push_back({{ m.vertices[f[0]], m.vertices[f[i]], m.vertices[f[i + 1]] }});
+        }
+    }
+    return out;
+}
+
+
+TEST_CASE( "face_bvh" ){
+    auto mesh = make_sphere(vec3<double>(1.0, -2.0, 0.5), 5.0, 24, 36);
+    append(mesh, make_sphere(vec3<double>(14.0, 0.0, 0.0), 3.0, 12, 20));
+    const face_bvh bvh(mesh);
+
+    std::mt19937 re(12345);
+    std::uniform_real_distribution<double> rd(-10.0, 20.0);
+    std::uniform_real_distribution<double> ru(-1.0, 1.0);
+
+    SUBCASE("slicing produces closed, oriented contours"){
+        const auto cc = bvh.slice(plane<double>(vec3<double>(0.0, 0.0, 1.0), vec3<double>(0.0, 0.0, 1.3)));
+        REQUIRE( cc.contours.size() == 2 );
+        for(const auto &c : cc.contours){
+            REQUIRE( c.closed );
+            REQUIRE( 3 < c.points.size() );
+            REQUIRE( 0.0 < signed_area_z(c) );
+            for(const auto &p : c.points){
+                REQUIRE( p.z == doctest::Approx(1.3) );
+            }
+        }
+
+        // The orientation follows the plane normal.
+        const auto flipped = bvh.slice(plane<double>(vec3<double>(0.0, 0.0, -1.0), vec3<double>(0.0, 0.0, 1.3)));
+        REQUIRE( flipped.contours.size() == 2 );
+        for(const auto &c : flipped.contours){
+            REQUIRE( signed_area_z(c) < 0.0 );
+        }
+
+        // Planes that miss the mesh, or pass through vertices.
+        REQUIRE( bvh.slice(plane<double>(vec3<double>(0.0, 0.0, 1.0), vec3<double>(0.0, 0.0, 9.0))).contours.empty() );
+        const auto on_verts = bvh.slice(plane<double>(vec3<double>(0.0, 0.0, 1.0), vec3<double>(0.0, 0.0, 0.5)));
+        REQUIRE( on_verts.contours.size() == 2 );
+        for(const auto &c : on_verts.contours) REQUIRE( c.closed );
+    }
+
+    SUBCASE("slicing open meshes produces open contours"){
+        auto open = mesh;
+        open.faces.resize(open.faces.size() / 4);
+        const auto cc = face_bvh(open).slice(plane<double>(vec3<double>(0.0, 1.0, 0.0), vec3<double>(0.0, -2.0, 0.0)));
+        REQUIRE( !cc.contours.empty() );
+        for(const auto &c : cc.contours) REQUIRE( !c.closed );
+    }
+
+    SUBCASE("queries agree with brute force"){
+        const auto tris = triangles(mesh);
+        REQUIRE( bvh.triangle_count() == static_cast<int64_t>(tris.size()) );
+
+        for(int64_t n = 0; n < 300; ++n){
+            const vec3<double> p( rd(re), rd(re) * 0.5, rd(re) * 0.5 );
+            const auto dir = vec3<double>( ru(re), ru(re), ru(re) ).unit();
+
+            // Ray casting.
+            double best_t = std::numeric_limits<double>::infinity();
+            for(const auto &t : tris){
+                const auto e1 = t[1] - t[0];
+                const auto e2 = t[2] - t[0];
+                const auto q = dir.Cross(e2);
+                const auto det = e1.Dot(q);
+                if(std::abs(det) < 1E-12) continue;
+                const auto s = p - t[0];
+                const auto u = s.Dot(q) / det;
+                const auto r = s.Cross(e1);
+                const auto v = dir.Dot(r) / det;
+                const auto l = e2.Dot(r) / det;
+                if( (0.0 <= u) && (0.0 <= v) && ((u + v) <= 1.0) && (0.0 <= l) ) best_t = std::min(best_t, l);
+            }
+            const auto hit = bvh.ray_cast(p, dir);
+            REQUIRE( hit.has_value() == std::isfinite(best_t) );
+            if(hit){
+                REQUIRE( hit->t == doctest::Approx(best_t) );
+                REQUIRE( hit->point.distance(p + dir * best_t) < 1E-9 );
+                REQUIRE( hit->face < mesh.faces.size() );
+            }
+            REQUIRE( !bvh.ray_cast(p, dir, best_t * 0.5).has_value() );
+
+            // Closest points and containment.
+            const auto cp = bvh.closest_point(p);
+            REQUIRE( cp );
+            for(const auto &t : tris){
+                // No vertex or edge midpoint may be closer than the reported closest point.
+                for(const auto &v : { t[0], t[1], t[2], (t[0] + t[1]) * 0.5, (t[0] + t[1] + t[2]) / 3.0 }){
+                    REQUIRE( cp->distance <= (p.distance(v) + 1E-9) );
+                }
+            }
+            REQUIRE( cp->distance == doctest::Approx(p.distance(cp->point)) );
+
+            const auto d1 = p.distance(vec3<double>(1.0, -2.0, 0.5)) - 5.0;
+            const auto d2 = p.distance(vec3<double>(14.0, 0.0, 0.0)) - 3.0;
+            if(0.2 < std::min(std::abs(d1), std::abs(d2))){
+                REQUIRE( bvh.is_inside(p) == ((d1 < 0.0) || (d2 < 0.0)) );
+            }
+        }
+    }
+
+    SUBCASE("fingerprints detect changes"){
+        auto altered = mesh;
+        REQUIRE( face_bvh::fingerprint(altered) == bvh.mesh_fingerprint() );
+        altered.vertices[7].z += 1E-12;
+        REQUIRE( face_bvh::fingerprint(altered) != bvh.mesh_fingerprint() );
+    }
+
+    SUBCASE("empty and malformed meshes"){
+        const face_bvh empty(fv_surface_mesh<double, uint64_t>{});
+        REQUIRE( empty.triangle_count() == 0 );
+        REQUIRE( !empty.closest_point(vec3<double>(0.0, 0.0, 0.0)) );
+        REQUIRE( !empty.ray_cast(vec3<double>(0.0, 0.0, 0.0), vec3<double>(1.0, 0.0, 0.0)) );
+        REQUIRE( !empty.is_inside(vec3<double>(0.0, 0.0, 0.0)) );
+        REQUIRE( empty.slice(plane<double>(vec3<double>(0.0, 0.0, 1.0), vec3<double>(0.0, 0.0, 0.0))).contours.empty() );
+
+        auto bad = mesh;
+        bad.faces.push_back({ 0, 1, bad.vertices.size() });
+        REQUIRE_THROWS_AS( face_bvh{bad}, std::invalid_argument );
+    }
+}
+
@@ -0,0 +1,843 @@
+//Mesh_Half_Edge.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// An index-based half-edge representation of triangle surface meshes, which supports local topological edits.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "YgorMath.h"         //Needed for vec3 class and fv_surface_mesh.
+
+#include "Mesh_Half_Edge.h"
+
+namespace dcma_surface_meshes {
+
+using half_edge = half_edge_mesh::half_edge;
+
+static
+void
+link(std::vector<half_edge> &hes, int64_t a, int64_t b){
+    hes[a].next = b;
+    hes[b].prev = a;
+}
+
+// Allocate a pair of twinned half-edges, returning the index of the first.
+static
+int64_t
+add_edge_pair(std::vector<half_edge> &hes){
+    const auto h = static_cast<int64_t>(hes.size());
+    hes.emplace_back();
+    hes.emplace_back();
+    return h;
+}
+
+static
+void
+remove_edge_pair(std::vector<half_edge> &hes, int64_t h){
+    for(const auto i : { h, h ^ 1 }){
+        hes[i] = half_edge();
+    }
+}
+
+half_edge_mesh::half_edge_mesh(const fv_surface_mesh<double, uint64_t> &mesh){
+    const auto N_verts = static_cast<uint64_t>(mesh.vertices.size());
+    this->positions.assign(std::begin(mesh.vertices), std::end(mesh.vertices));
+
+    // Triangulate the faces, dropping degenerate triangles.
+    std::vector<std::array<int64_t, 3>> tris;
+    tris.reserve(mesh.faces.size());
+    for(const auto &face : mesh.faces){
+        for(const auto &v : face){
+            if(N_verts <= v){
+                throw std::invalid_argument("Face refers to a nonexistent vertex. Cannot continue.");
+            }
+        }
+        for(size_t i = 1; (i + 1) < face.size(); ++i){
+            const std::array<int64_t, 3> t {{ static_cast<int64_t>(face[0]),
+                                              static_cast<int64_t>(face[i]),
+                                              static_cast<int64_t>(face[i + 1]) }};
+            if( (t[0] == t[1]) || (t[1] == t[2]) || (t[2] == t[0]) ) continue;
+            tris.push_back(t);
+        }
+    }
+    const auto N_tris = static_cast<int64_t>(tris.size());
+
+    // Make face winding consistent across edges shared by exactly two faces, propagating from the first face of each
+    // connected component. Consistently-wound meshes are not altered.
+    {
+        struct edge_use {
+            int64_t a;
+            int64_t b;
+            int64_t tri;
+        };
+        std::vector<edge_use> uses;
+        uses.reserve(N_tris * 3);
+        for(int64_t f = 0; f < N_tris; ++f){
+            for(int64_t i = 0; i < 3; ++i){
+                const auto u = tris[f][i];
+                const auto v = tris[f][(i + 1) % 3];
+                uses.push_back({ std::min(u, v), std::max(u, v), f });
+            }
+        }
+        std::sort(std::begin(uses), std::end(uses), [](const edge_use &l, const edge_use &r){
+            return std::tie(l.a, l.b, l.tri) < std::tie(r.a, r.b, r.tri);
+        });
+
+        std::vector<std::array<edge_use, 3>> neighbours(N_tris, {{ { invalid, invalid, invalid },
+                                                                   { invalid, invalid, invalid },
+                                                                   { invalid, invalid, invalid } }});
+        const auto add_neighbour = [&](int64_t f, const edge_use &e){
+            for(auto &n : neighbours[f]){
+                if(n.tri == invalid){
+                    n = e;
+                    return;
+                }
+            }
+        };
+        for(size_t i = 0; i < uses.size(); ){
+            size_t j = i;
+            while( (j < uses.size()) && (uses[j].a == uses[i].a) && (uses[j].b == uses[i].b) ) ++j;
+            if( ((j - i) == 2) && (uses[i].tri != uses[i + 1].tri) ){
+                add_neighbour(uses[i].tri, uses[i + 1]);
+                add_neighbour(uses[i + 1].tri, uses[i]);
+            }
+            i = j;
+        }
+
+        // Whether the face traverses the edge from a to b.
+        const auto is_forward = [&](int64_t f, int64_t a, int64_t b){
+            for(int64_t i = 0; i < 3; ++i){
+                if( (tris[f][i] == a) && (tris[f][(i + 1) % 3] == b) ) return true;
+            }
+            return false;
+        };
+
+        std::vector<bool> visited(N_tris, false);
+        std::vector<int64_t> queue;
+        for(int64_t seed = 0; seed < N_tris; ++seed){
+            if(visited[seed]) continue;
+            visited[seed] = true;
+            queue.push_back(seed);
+            while(!queue.empty()){
+                const auto f = queue.back();
+                queue.pop_back();
+                for(const auto &n : neighbours[f]){
+                    if( (n.tri == invalid) || visited[n.tri] ) continue;
+                    if(is_forward(f, n.a, n.b) == is_forward(n.tri, n.a, n.b)){
+                        std::swap(tris[n.tri][1], tris[n.tri][2]);
+                    }
+                    visited[n.tri] = true;
+                    queue.push_back(n.tri);
+                }
+            }
+        }
+    }
+
+    // Create the half-edges, pairing each with an oppositely-directed half-edge where one is available. Edges that
+    // are traversed in the same direction by multiple faces receive separate pairs.
+    {
+        using edge_t = std::pair<int64_t, int64_t>;
+        struct edge_hash {
+            size_t operator()(const edge_t &e) const {
+                return std::hash<uint64_t>()(static_cast<uint64_t>(e.first) * 0x9E3779B97F4A7C15ULL
+                                             ^ static_cast<uint64_t>(e.second));
+            }
+        };
+        std::unordered_map<edge_t, int64_t, edge_hash> unmatched;
+        unmatched.reserve(N_tris * 2);
+
+        this->half_edges.reserve(N_tris * 3 + 6);
+        this->face_half_edge.reserve(N_tris);
+        for(int64_t f = 0; f < N_tris; ++f){
+            std::array<int64_t, 3> fh;
+            for(int64_t i = 0; i < 3; ++i){
+                const auto u = tris[f][i];
+                const auto v = tris[f][(i + 1) % 3];
+                const auto it = unmatched.find({ v, u });
+                if(it != std::end(unmatched)){
+                    fh[i] = it->second ^ 1;
+                    unmatched.erase(it);
+                }else{
+                    fh[i] = add_edge_pair(this->half_edges);
+                    this->half_edges[fh[i]].vertex = v;
+                    this->half_edges[fh[i] ^ 1].vertex = u;
+                    unmatched.emplace(edge_t{ u, v }, fh[i]);
+                }
+                this->half_edges[fh[i]].face = f;
+            }
+            for(int64_t i = 0; i < 3; ++i){
+                link(this->half_edges, fh[i], fh[(i + 1) % 3]);
+            }
+            this->face_half_edge.push_back(fh[0]);
+        }
+    }
+    const auto N_hes = static_cast<int64_t>(this->half_edges.size());
+
+    // Duplicate vertices joining more than one fan of faces.
+    //
+    // Outgoing half-edges are grouped by rotating around their source vertex across faces. Each group is a fan, and
+    // every fan beyond the first at a vertex receives a new copy of the vertex.
+    {
+        std::vector<int64_t> parent(N_hes);
+        std::iota(std::begin(parent), std::end(parent), 0);
+        const auto find = [&](int64_t x){
+            while(parent[x] != x){
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+        for(int64_t h = 0; h < N_hes; ++h){
+            if(this->is_boundary_half_edge(h)) continue;
+            const auto o = this->half_edges[h].prev ^ 1;
+            parent[find(h)] = find(o);
+        }
+
+        std::vector<int64_t> sources(N_hes);
+        for(int64_t h = 0; h < N_hes; ++h){
+            sources[h] = this->source(h);
+        }
+        std::vector<int64_t> fan_vertex(N_hes, invalid);
+        std::vector<bool> vertex_used(N_verts, false);
+        for(int64_t h = 0; h < N_hes; ++h){
+            const auto r = find(h);
+            if(fan_vertex[r] == invalid){
+                const auto s = sources[h];
+                if(!vertex_used[s]){
+                    vertex_used[s] = true;
+                    fan_vertex[r] = s;
+                }else{
+                    fan_vertex[r] = static_cast<int64_t>(this->positions.size());
+                    this->positions.push_back(this->positions[s]);
+                }
+            }
+        }
+        for(int64_t h = 0; h < N_hes; ++h){
+            this->half_edges[h ^ 1].vertex = fan_vertex[find(h)];
+        }
+    }
+    const auto N_all_verts = static_cast<int64_t>(this->positions.size());
+
+    // Link the boundary half-edges into loops. After separating fans, each vertex has at most one outgoing boundary
+    // half-edge.
+    this->vertex_half_edge.assign(N_all_verts, invalid);
+    for(int64_t h = 0; h < N_hes; ++h){
+        const auto s = this->source(h);
+        if( (this->vertex_half_edge[s] == invalid)
+        ||  this->is_boundary_half_edge(h) ){
+            this->vertex_half_edge[s] = h;
+        }
+    }
+    for(int64_t h = 0; h < N_hes; ++h){
+        if(!this->is_boundary_half_edge(h)) continue;
+        const auto n = this->vertex_half_edge[this->target(h)];
+        link(this->half_edges, h, n);
+    }
+}
+
+fv_surface_mesh<double, uint64_t>
+half_edge_mesh::to_fv_surface_mesh() const {
+    fv_surface_mesh<double, uint64_t> out;
+
+    const auto N_verts = static_cast<int64_t>(this->positions.size());
+    std::vector<uint64_t> index(N_verts, 0);
+    for(int64_t v = 0; v < N_verts; ++v){
+        if(this->vertex_half_edge[v] == invalid) continue;
+        index[v] = static_cast<uint64_t>(out.vertices.size());
+        out.vertices.push_back(this->positions[v]);
+    }
+
+    out.faces.reserve(this->face_half_edge.size());
+    for(const auto &h : this->face_half_edge){
+        if(h == invalid) continue;
+        const auto n = this->half_edges[h].next;
+        out.faces.push_back({ index[this->source(h)], index[this->target(h)], index[this->target(n)] });
+    }
+    return out;
+}
+
+void
+half_edge_mesh::compact(){
+    const auto N_verts = static_cast<int64_t>(this->positions.size());
+    const auto N_faces = static_cast<int64_t>(this->face_half_edge.size());
+    const auto N_hes = static_cast<int64_t>(this->half_edges.size());
+
+    std::vector<int64_t> v_index(N_verts, invalid);
+    int64_t N_kept_verts = 0;
+    for(int64_t v = 0; v < N_verts; ++v){
+        if(this->vertex_half_edge[v] != invalid) v_index[v] = N_kept_verts++;
+    }
+    std::vector<int64_t> f_index(N_faces, invalid);
+    int64_t N_kept_faces = 0;
+    for(int64_t f = 0; f < N_faces; ++f){
+        if(this->face_half_edge[f] != invalid) f_index[f] = N_kept_faces++;
+    }
+    std::vector<int64_t> h_index(N_hes, invalid);
+    int64_t N_kept_hes = 0;
+    for(int64_t h = 0; h < N_hes; h += 2){
+        if(this->half_edges[h].vertex == invalid) continue;
+        h_index[h] = N_kept_hes++;
+        h_index[h + 1] = N_kept_hes++;
+    }
+
+    std::vector<vec3<double>> l_positions(N_kept_verts);
+    std::vector<int64_t> l_vertex_half_edge(N_kept_verts);
+    for(int64_t v = 0; v < N_verts; ++v){
+        if(v_index[v] == invalid) continue;
+        l_positions[v_index[v]] = this->positions[v];
+        l_vertex_half_edge[v_index[v]] = h_index[this->vertex_half_edge[v]];
+    }
+    std::vector<int64_t> l_face_half_edge(N_kept_faces);
+    for(int64_t f = 0; f < N_faces; ++f){
+        if(f_index[f] == invalid) continue;
+        l_face_half_edge[f_index[f]] = h_index[this->face_half_edge[f]];
+    }
+    std::vector<half_edge> l_half_edges(N_kept_hes);
+    for(int64_t h = 0; h < N_hes; ++h){
+        if(h_index[h] == invalid) continue;
+        const auto &he = this->half_edges[h];
+        auto &out = l_half_edges[h_index[h]];
+        out.vertex = v_index[he.vertex];
+        out.face = (he.face == invalid) ? invalid : f_index[he.face];
+        out.next = h_index[he.next];
+        out.prev = h_index[he.prev];
+    }
+
+    this->positions = std::move(l_positions);
+    this->vertex_half_edge = std::move(l_vertex_half_edge);
+    this->face_half_edge = std::move(l_face_half_edge);
+    this->half_edges = std::move(l_half_edges);
+}
+
+int64_t
+half_edge_mesh::vertex_count() const {
+    return static_cast<int64_t>(std::count_if(std::begin(this->vertex_half_edge), std::end(this->vertex_half_edge),
+                                              [](int64_t h){ return (h != invalid); }));
+}
+
+int64_t
+half_edge_mesh::face_count() const {
+    return static_cast<int64_t>(std::count_if(std::begin(this->face_half_edge), std::end(this->face_half_edge),
+                                              [](int64_t h){ return (h != invalid); }));
+}
+
+bool
+half_edge_mesh::is_boundary_vertex(int64_t v) const {
+    const auto h = this->vertex_half_edge[v];
+    return (h != invalid) && this->is_boundary_half_edge(h);
+}
+
+int64_t
+half_edge_mesh::valence(int64_t v) const {
+    const auto start = this->vertex_half_edge[v];
+    if(start == invalid) return 0;
+    int64_t count = 0;
+    auto h = start;
+    do{
+        ++count;
+        h = this->half_edges[h ^ 1].next;
+    }while(h != start);
+    return count;
+}
+
+std::vector<int64_t>
+half_edge_mesh::outgoing_half_edges(int64_t v) const {
+    std::vector<int64_t> out;
+    const auto start = this->vertex_half_edge[v];
+    if(start == invalid) return out;
+    auto h = start;
+    do{
+        out.push_back(h);
+        h = this->half_edges[h ^ 1].next;
+    }while(h != start);
+    return out;
+}
+
+void
+half_edge_mesh::adjust_outgoing_half_edge(int64_t v){
+    for(const auto &h : this->outgoing_half_edges(v)){
+        if(this->is_boundary_half_edge(h)){
+            this->vertex_half_edge[v] = h;
+            return;
+        }
+    }
+}
+
+bool
+half_edge_mesh::flip_edge(int64_t h){
+    if( (this->half_edges[h].vertex == invalid)
+    ||  this->is_boundary_edge(h) ) return false;
+
+    // Before: (a, b, c) and (b, a, d). After: (a, d, c) and (b, c, d).
+    const auto t = h ^ 1;
+    const auto h1 = this->half_edges[h].next;
+    const auto h2 = this->half_edges[h].prev;
+    const auto t1 = this->half_edges[t].next;
+    const auto t2 = this->half_edges[t].prev;
+    const auto a = this->target(t);
+    const auto b = this->target(h);
+    const auto c = this->target(h1);
+    const auto d = this->target(t1);
+    if(c == d) return false;
+    for(const auto &o : this->outgoing_half_edges(c)){
+        if(this->target(o) == d) return false;
+    }
+
+    const auto f0 = this->half_edges[h].face;
+    const auto f1 = this->half_edges[t].face;
+    auto &hes = this->half_edges;
+    hes[h].vertex = c;
+    hes[t].vertex = d;
+    link(hes, t1, h);
+    link(hes, h, h2);
+    link(hes, h2, t1);
+    link(hes, h1, t);
+    link(hes, t, t2);
+    link(hes, t2, h1);
+    hes[t1].face = f0;
+    hes[h1].face = f1;
+    this->face_half_edge[f0] = h;
+    this->face_half_edge[f1] = t;
+    if(this->vertex_half_edge[a] == h) this->vertex_half_edge[a] = t1;
+    if(this->vertex_half_edge[b] == t) this->vertex_half_edge[b] = h1;
+    return true;
+}
+
+int64_t
+half_edge_mesh::split_edge(int64_t h, const vec3<double> &pos){
+    if(this->half_edges[h].vertex == invalid){
+        throw std::invalid_argument("Cannot split a removed edge");
+    }
+    auto &hes = this->half_edges;
+    const auto t = h ^ 1;
+    const auto b = this->target(h);
+    const bool h_boundary = this->is_boundary_half_edge(h);
+    const bool t_boundary = this->is_boundary_half_edge(t);
+    const auto hn = hes[h].next;
+    const auto tp = hes[t].prev;
+
+    const auto m = static_cast<int64_t>(this->positions.size());
+    this->positions.push_back(pos);
+    this->vertex_half_edge.push_back(invalid);
+
+    // The original pair becomes (a, m) and a new pair is added for (m, b).
+    const auto e = add_edge_pair(hes);
+    const auto et = e ^ 1;
+    hes[h].vertex = m;
+    hes[e].vertex = b;
+    hes[et].vertex = m;
+
+    if(h_boundary){
+        link(hes, h, e);
+        link(hes, e, hn);
+    }else{
+        // Before: (a, b, c). After: (a, m, c) and (m, b, c).
+        const auto f0 = hes[h].face;
+        const auto h1 = hes[h].next;
+        const auto h2 = hes[h].prev;
+        const auto c = this->target(h1);
+        const auto f2 = static_cast<int64_t>(this->face_half_edge.size());
+        this->face_half_edge.push_back(e);
+
+        const auto s = add_edge_pair(hes);
+        const auto st = s ^ 1;
+        hes[s].vertex = c;
+        hes[st].vertex = m;
+        hes[s].face = f0;
+        hes[e].face = f2;
+        hes[h1].face = f2;
+        hes[st].face = f2;
+        link(hes, h, s);
+        link(hes, s, h2);
+        link(hes, e, h1);
+        link(hes, h1, st);
+        link(hes, st, e);
+        this->face_half_edge[f0] = h;
+    }
+
+    if(t_boundary){
+        link(hes, tp, et);
+        link(hes, et, t);
+    }else{
+        // Before: (b, a, d). After: (m, a, d) and (b, m, d).
+        const auto f1 = hes[t].face;
+        const auto t1 = hes[t].next;
+        const auto t2 = hes[t].prev;
+        const auto d = this->target(t1);
+        const auto f3 = static_cast<int64_t>(this->face_half_edge.size());
+        this->face_half_edge.push_back(et);
+
+        const auto r = add_edge_pair(hes);
+        const auto rt = r ^ 1;
+        hes[r].vertex = m;
+        hes[rt].vertex = d;
+        hes[r].face = f1;
+        hes[et].face = f3;
+        hes[rt].face = f3;
+        hes[t2].face = f3;
+        link(hes, t1, r);
+        link(hes, r, t);
+        link(hes, et, rt);
+        link(hes, rt, t2);
+        link(hes, t2, et);
+        this->face_half_edge[f1] = t;
+    }
+
+    this->vertex_half_edge[m] = t_boundary ? t : e;
+    if(this->vertex_half_edge[b] == t) this->vertex_half_edge[b] = et;
+    return m;
+}
+
+bool
+half_edge_mesh::is_collapse_ok(int64_t h) const {
+    if(this->half_edges[h].vertex == invalid) return false;
+
+    const auto t = h ^ 1;
+    const auto a = this->source(h);
+    const auto b = this->target(h);
+    const auto c = this->is_boundary_half_edge(h) ? invalid : this->target(this->half_edges[h].next);
+    const auto d = this->is_boundary_half_edge(t) ? invalid : this->target(this->half_edges[t].next);
+
+    // Joining two boundaries through the interior would pinch the surface.
+    if( !this->is_boundary_edge(h)
+    &&  this->is_boundary_vertex(a)
+    &&  this->is_boundary_vertex(b) ) return false;
+
+    // The vertices opposite the edge lose an edge, which must not leave them dangling or joined by a doubled face.
+    for(const auto &x : { c, d }){
+        if(x == invalid) continue;
+        const auto minimum = this->is_boundary_vertex(x) ? 3 : 4;
+        if(this->valence(x) < minimum) return false;
+    }
+
+    // Link condition: the only vertices adjacent to both a and b are those opposite the edge.
+    std::vector<int64_t> a_neighbours;
+    for(const auto &o : this->outgoing_half_edges(a)){
+        a_neighbours.push_back(this->target(o));
+    }
+    for(const auto &o : this->outgoing_half_edges(b)){
+        const auto x = this->target(o);
+        if( (x == c) || (x == d) ) continue;
+        if(std::find(std::begin(a_neighbours), std::end(a_neighbours), x) != std::end(a_neighbours)) return false;
+    }
+    return true;
+}
+
+bool
+half_edge_mesh::collapse_edge(int64_t h, const vec3<double> &pos){
+    if(!this->is_collapse_ok(h)) return false;
+
+    auto &hes = this->half_edges;
+    const auto t = h ^ 1;
+    const auto a = this->source(h);
+    const auto b = this->target(h);
+    const bool h_boundary = this->is_boundary_half_edge(h);
+    const bool t_boundary = this->is_boundary_half_edge(t);
+    const auto b_out = hes[h].next; // Survives the collapse, and remains outgoing from b.
+
+    // Half-edge 'keep' takes the place of half-edge 'drop' in its face or boundary loop.
+    const auto replace = [&](int64_t drop, int64_t keep){
+        const auto f = hes[drop].face;
+        const auto n = hes[drop].next;
+        const auto p = hes[drop].prev;
+        hes[keep].face = f;
+        link(hes, p, keep);
+        link(hes, keep, n);
+        if( (f != invalid) && (this->face_half_edge[f] == drop) ) this->face_half_edge[f] = keep;
+    };
+
+    // Redirect half-edges pointing to a so they point to b.
+    for(const auto &o : this->outgoing_half_edges(a)){
+        hes[o ^ 1].vertex = b;
+    }
+
+    std::vector<int64_t> affected { b };
+    if(h_boundary){
+        link(hes, hes[h].prev, hes[h].next);
+    }else{
+        // Face (a, b, c) collapses; edge (c, a) is dropped in favour of edge (b, c).
+        const auto h1 = hes[h].next;
+        const auto h2 = hes[h].prev;
+        const auto c = this->target(h1);
+        this->face_half_edge[hes[h].face] = invalid;
+        replace(h2 ^ 1, h1);
+        if(this->vertex_half_edge[c] == h2) this->vertex_half_edge[c] = h1 ^ 1;
+        remove_edge_pair(hes, h2);
+        affected.push_back(c);
+    }
+    if(t_boundary){
+        link(hes, hes[t].prev, hes[t].next);
+    }else{
+        // Face (b, a, d) collapses; edge (a, d) is dropped in favour of edge (d, b).
+        const auto t1 = hes[t].next;
+        const auto t2 = hes[t].prev;
+        const auto d = this->target(t1);
+        this->face_half_edge[hes[t].face] = invalid;
+        replace(t1 ^ 1, t2);
+        if(this->vertex_half_edge[d] == (t1 ^ 1)) this->vertex_half_edge[d] = t2;
+        remove_edge_pair(hes, t1);
+        affected.push_back(d);
+    }
+    remove_edge_pair(hes, h);
+
+    this->vertex_half_edge[a] = invalid;
+    this->vertex_half_edge[b] = b_out;
+    this->positions[b] = pos;
+    for(const auto &v : affected){
+        this->adjust_outgoing_half_edge(v);
+    }
+    return true;
+}
+
+void
+half_edge_mesh::orient_outward(){
+    const auto N_faces = static_cast<int64_t>(this->face_half_edge.size());
+    std::vector<bool> visited(N_faces, false);
+    std::vector<int64_t> queue;
+    std::vector<int64_t> component;
+    for(int64_t seed = 0; seed < N_faces; ++seed){
+        if( visited[seed]
+        ||  (this->face_half_edge[seed] == invalid) ) continue;
+
+        // Gather the connected component.
+        component.clear();
+        visited[seed] = true;
+        queue.push_back(seed);
+        bool closed = true;
+        while(!queue.empty()){
+            const auto f = queue.back();
+            queue.pop_back();
+            component.push_back(f);
+            auto h = this->face_half_edge[f];
+            for(int64_t i = 0; i < 3; ++i, h = this->half_edges[h].next){
+                const auto n = this->half_edges[h ^ 1].face;
+                if(n == invalid){
+                    closed = false;
+                }else if(!visited[n]){
+                    visited[n] = true;
+                    queue.push_back(n);
+                }
+            }
+        }
+        if(!closed) continue;
+
+        double volume = 0.0;
+        for(const auto &f : component){
+            const auto h = this->face_half_edge[f];
+            const auto &A = this->positions[this->source(h)];
+            const auto &B = this->positions[this->target(h)];
+            const auto &C = this->positions[this->target(this->half_edges[h].next)];
+            volume += A.Dot(B.Cross(C)) / 6.0;
+        }
+        if(0.0 <= volume) continue;
+
+        // Reverse every half-edge in the component. Since the component is closed, all of its half-edges are on faces.
+        std::vector<std::pair<int64_t, int64_t>> new_targets;
+        for(const auto &f : component){
+            auto h = this->face_half_edge[f];
+            for(int64_t i = 0; i < 3; ++i, h = this->half_edges[h].next){
+                new_targets.emplace_back(h, this->source(h));
+            }
+        }
+        for(const auto &[h, v] : new_targets){
+            auto &he = this->half_edges[h];
+            he.vertex = v;
+            std::swap(he.next, he.prev);
+        }
+        for(const auto &[h, v] : new_targets){
+            // Outgoing half-edges are now incoming. Vertices are visited once per incident face, so only update once.
+            if(this->target(this->vertex_half_edge[v]) == v) this->vertex_half_edge[v] ^= 1;
+        }
+    }
+}
+
+// A symmetric 4x4 matrix representing a sum of squared distances to planes.
+namespace {
+struct quadric {
+    std::array<double, 10> q {};
+
+    void add_plane(const vec3<double> &n, double d, double weight){
+        const std::array<double, 4> p {{ n.x, n.y, n.z, d }};
+        int64_t k = 0;
+        for(int64_t i = 0; i < 4; ++i){
+            for(int64_t j = i; j < 4; ++j){
+                q[k++] += weight * p[i] * p[j];
+            }
+        }
+    }
+
+    quadric operator+(const quadric &rhs) const {
+        quadric out;
+        for(size_t i = 0; i < q.size(); ++i) out.q[i] = q[i] + rhs.q[i];
+        return out;
+    }
+
+    double evaluate(const vec3<double> &v) const {
+        return         q[0]*v.x*v.x + 2.0*q[1]*v.x*v.y + 2.0*q[2]*v.x*v.z + 2.0*q[3]*v.x
+                     +                    q[4]*v.y*v.y + 2.0*q[5]*v.y*v.z + 2.0*q[6]*v.y
+                     +                                       q[7]*v.z*v.z + 2.0*q[8]*v.z
+                     + q[9];
+    }
+
+    // The position minimizing the error, if it is well-defined.
+    std::optional<vec3<double>> minimizer() const {
+        const auto a = q[0], b = q[1], c = q[2];
+        const auto e = q[4], f = q[5], i = q[7];
+        const auto det = a * (e * i - f * f) - b * (b * i - f * c) + c * (b * f - e * c);
+        const auto scale = std::abs(a) + std::abs(e) + std::abs(i);
+        if( !(std::abs(det) > 1E-9 * scale * scale * scale) ) return std::nullopt;
+
+        const auto r0 = -q[3], r1 = -q[6], r2 = -q[8];
+        const vec3<double> v( (r0 * (e * i - f * f) - b * (r1 * i - f * r2) + c * (r1 * f - e * r2)) / det,
+                              (a * (r1 * i - f * r2) - r0 * (b * i - f * c) + c * (b * r2 - r1 * c)) / det,
+                              (a * (e * r2 - r1 * f) - b * (b * r2 - r1 * c) + r0 * (b * f - e * c)) / det );
+        if(!v.isfinite()) return std::nullopt;
+        return v;
+    }
+};
+} // namespace
+
+int64_t
+half_edge_mesh::simplify(int64_t target_face_count, double max_error){
+    const auto N_verts = static_cast<int64_t>(this->positions.size());
+    std::vector<quadric> quadrics(N_verts);
+
+    // Accumulate face planes, and planes perpendicular to boundary edges which discourage boundaries from moving.
+    const double boundary_weight = 1000.0;
+    for(const auto &fh : this->face_half_edge){
+        if(fh == invalid) continue;
+        auto h = fh;
+        const auto &A = this->positions[this->source(h)];
+        const auto &B = this->positions[this->target(h)];
+        const auto &C = this->positions[this->target(this->half_edges[h].next)];
+        const auto n = (B - A).Cross(C - A);
+        const auto length = n.length();
+        if( !(0.0 < length) ) continue;
+        const auto N = n / length;
+
+        quadric Q;
+        Q.add_plane(N, -N.Dot(A), 1.0);
+        for(int64_t i = 0; i < 3; ++i, h = this->half_edges[h].next){
+            const auto s = this->source(h);
+            quadrics[s] = quadrics[s] + Q;
+            if(this->is_boundary_half_edge(h ^ 1)){
+                const auto &P0 = this->positions[s];
+                const auto &P1 = this->positions[this->target(h)];
+                const auto e = (P1 - P0).Cross(N);
+                const auto e_length = e.length();
+                if( !(0.0 < e_length) ) continue;
+                quadric B_Q;
+                B_Q.add_plane(e / e_length, -(e / e_length).Dot(P0), boundary_weight);
+                quadrics[s] = quadrics[s] + B_Q;
+                quadrics[this->target(h)] = quadrics[this->target(h)] + B_Q;
+            }
+        }
+    }
+
+    struct candidate {
+        double cost;
+        int64_t pair;
+        uint64_t stamp;
+        vec3<double> pos;
+        bool operator>(const candidate &rhs) const { return (this->cost > rhs.cost); }
+    };
+    std::priority_queue<candidate, std::vector<candidate>, std::greater<candidate>> pq;
+    std::vector<uint64_t> stamps(this->half_edges.size() / 2, 0);
+
+    const auto push_edge = [&](int64_t pair){
+        const auto h = pair * 2;
+        if(this->half_edges[h].vertex == invalid) return;
+        const auto a = this->source(h);
+        const auto b = this->target(h);
+        const auto Q = quadrics[a] + quadrics[b];
+        const auto &A = this->positions[a];
+        const auto &B = this->positions[b];
+
+        candidate c;
+        c.pair = pair;
+        c.stamp = ++stamps[pair];
+        c.cost = std::numeric_limits<double>::infinity();
+        if(const auto v = Q.minimizer(); v){
+            c.pos = v.value();
+            c.cost = Q.evaluate(c.pos);
+        }
+        // Fall back to the endpoints and midpoint if the minimizer is ill-defined, or wanders far from the edge.
+        if( !(c.cost < std::numeric_limits<double>::infinity())
+        ||  (2.0 * A.distance(B) < c.pos.distance((A + B) * 0.5)) ){
+            c.cost = std::numeric_limits<double>::infinity();
+            for(const auto &p : { A, B, (A + B) * 0.5 }){
+                const auto cost = Q.evaluate(p);
+                if(cost < c.cost){
+                    c.cost = cost;
+                    c.pos = p;
+                }
+            }
+        }
+        c.cost = std::max(c.cost, 0.0);
+        pq.push(c);
+    };
+
+    // Whether moving the vertex would flip any of its faces, ignoring the faces adjacent to the edge.
+    const auto flips_faces = [&](int64_t v, int64_t other, const vec3<double> &pos){
+        for(const auto &o : this->outgoing_half_edges(v)){
+            if(this->is_boundary_half_edge(o)) continue;
+            const auto p = this->target(o);
+            const auto q = this->target(this->half_edges[o].next);
+            if( (p == other) || (q == other) ) continue;
+            const auto &P = this->positions[p];
+            const auto &Q = this->positions[q];
+            const auto n_old = (P - this->positions[v]).Cross(Q - this->positions[v]);
+            const auto n_new = (P - pos).Cross(Q - pos);
+            if( !(0.0 < n_old.Dot(n_new)) ) return true;
+        }
+        return false;
+    };
+
+    for(int64_t pair = 0; pair < static_cast<int64_t>(stamps.size()); ++pair){
+        push_edge(pair);
+    }
+
+    auto N_faces = this->face_count();
+    int64_t N_collapsed = 0;
+    while( (target_face_count < N_faces) && !pq.empty() ){
+        const auto c = pq.top();
+        pq.pop();
+        const auto h = c.pair * 2;
+        if( (this->half_edges[h].vertex == invalid)
+        ||  (c.stamp != stamps[c.pair]) ) continue;
+        if(max_error < c.cost) break;
+
+        const auto a = this->source(h);
+        const auto b = this->target(h);
+        if( !this->is_collapse_ok(h)
+        ||  flips_faces(a, b, c.pos)
+        ||  flips_faces(b, a, c.pos) ) continue;
+
+        const auto N_removed = (this->is_boundary_half_edge(h) ? 0 : 1)
+                             + (this->is_boundary_half_edge(h ^ 1) ? 0 : 1);
+        quadrics[b] = quadrics[a] + quadrics[b];
+        this->collapse_edge(h, c.pos);
+        N_faces -= N_removed;
+        ++N_collapsed;
+
+        for(const auto &o : this->outgoing_half_edges(b)){
+            push_edge(o / 2);
+        }
+    }
+    return N_collapsed;
+}
+
+} // namespace dcma_surface_meshes
+
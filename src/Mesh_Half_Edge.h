@@ -0,0 +1,92 @@
+//Mesh_Half_Edge.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// An index-based half-edge representation of triangle surface meshes, which supports local topological edits.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "YgorMath.h"         //Needed for vec3 class and fv_surface_mesh.
+
+namespace dcma_surface_meshes {
+
+// A manifold triangle mesh stored as half-edges.
+//
+// Half-edges are allocated in pairs, so the twin of half-edge 'h' is always 'h ^ 1'. Boundary half-edges have no face
+// and are linked into loops around each hole. Elements removed by edits are only marked as removed, so indices remain
+// stable until compact() is called.
+//
+// Construction repairs the mesh as needed: faces are triangulated, face winding is made consistent where possible,
+// edges shared by more than two faces are separated, and vertices joining separate fans of faces are duplicated.
+class half_edge_mesh {
+  public:
+    static constexpr int64_t invalid = -1;
+
+    struct half_edge {
+        int64_t vertex = invalid; // The vertex the half-edge points to, or invalid if removed.
+        int64_t face = invalid;   // The face to the left of the half-edge, or invalid on a boundary.
+        int64_t next = invalid;
+        int64_t prev = invalid;
+    };
+
+    std::vector<vec3<double>> positions;
+    std::vector<int64_t> vertex_half_edge; // An outgoing half-edge, preferring boundary half-edges. Invalid if unused.
+    std::vector<int64_t> face_half_edge;   // One of the face's half-edges, or invalid if removed.
+    std::vector<half_edge> half_edges;
+
+    explicit half_edge_mesh(const fv_surface_mesh<double, uint64_t> &mesh);
+
+    // Convert to a face-vertex mesh. Only live elements are emitted, and indices match those after compact().
+    fv_surface_mesh<double, uint64_t> to_fv_surface_mesh() const;
+
+    // Drop removed and unused elements, renumbering those that remain.
+    void compact();
+
+    int64_t vertex_count() const;
+    int64_t face_count() const;
+
+    int64_t twin(int64_t h) const { return h ^ 1; }
+    int64_t source(int64_t h) const { return this->half_edges[h ^ 1].vertex; }
+    int64_t target(int64_t h) const { return this->half_edges[h].vertex; }
+    bool is_boundary_half_edge(int64_t h) const { return (this->half_edges[h].face == invalid); }
+    bool is_boundary_edge(int64_t h) const { return this->is_boundary_half_edge(h) || this->is_boundary_half_edge(h ^ 1); }
+    bool is_boundary_vertex(int64_t v) const;
+    int64_t valence(int64_t v) const;
+
+    // The outgoing half-edges of a vertex, in rotational order.
+    std::vector<int64_t> outgoing_half_edges(int64_t v) const;
+
+    // Flip the edge shared by two triangles so that it joins their opposite vertices. Returns false, leaving the mesh
+    // unaltered, if the edge is on a boundary or the flipped edge already exists.
+    bool flip_edge(int64_t h);
+
+    // Split an edge by inserting a vertex at the given position, splitting the adjacent faces. Returns the new vertex.
+    int64_t split_edge(int64_t h, const vec3<double> &pos);
+
+    // Whether collapsing the edge would preserve the mesh topology (i.e., the link condition holds).
+    bool is_collapse_ok(int64_t h) const;
+
+    // Collapse the source vertex of the half-edge into the target vertex, which is moved to the given position.
+    // Returns false, leaving the mesh unaltered, if the collapse would alter the mesh topology.
+    bool collapse_edge(int64_t h, const vec3<double> &pos);
+
+    // Reverse the winding of every closed component that encloses a negative volume.
+    void orient_outward();
+
+    // Simplify the mesh with quadric error metric edge collapses (Garland and Heckbert, 1997), cheapest first.
+    // Simplification stops when the face count reaches the target, or when the next collapse would cause an error
+    // (approximately a squared distance) larger than 'max_error'. Boundaries are preserved where possible. Returns
+    // the number of edges collapsed.
+    int64_t simplify(int64_t target_face_count,
+                     double max_error = std::numeric_limits<double>::infinity());
+
+  private:
+    // Reselect the outgoing half-edge of a vertex so that boundary half-edges are preferred.
+    void adjust_outgoing_half_edge(int64_t v);
+};
+
+} // namespace dcma_surface_meshes
+
@@ -0,0 +1,312 @@
+//Mesh_Half_Edge_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the half-edge mesh defined in Mesh_Half_Edge.cc.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorMath.h"
+
+#include "Mesh_Half_Edge.h"
+
+using namespace dcma_surface_meshes;
+
+
+// A closed, outward-oriented latitude-longitude sphere with quad faces away from the poles.
+static
+fv_surface_mesh<double, uint64_t>
+make_sphere(double radius, int64_t N_lat, int64_t N_lon){
+    fv_surface_mesh<double, uint64_t> m;
+    m.vertices.emplace_back( vec3<double>(0.0, 0.0, -radius) );
+    for(int64_t i = 1; i < N_lat; ++i){
+        const auto theta = M_PI * static_cast<double>(i) / static_cast<double>(N_lat);
+        for(int64_t j = 0; j < N_lon; ++j){
+            const auto phi = 2.0 * M_PI * static_cast<double>(j) / static_cast<double>(N_lon);
+            m.vertices.emplace_back( vec3<double>( std::sin(theta) * std::cos(phi),
+                                                   std::sin(theta) * std::sin(phi),
+                                                  -std::cos(theta) ) * radius );
+        }
+    }
+    m.vertices.emplace_back( vec3<double>(0.0, 0.0, radius) );
+
+    const auto ring = [&](int64_t i, int64_t j) -> uint64_t {
+        return static_cast<uint64_t>(1 + (i - 1) * N_lon + (j % N_lon));
+    };
+    const auto north = static_cast<uint64_t>(m.vertices.size() - 1);
+    for(int64_t j = 0; j < N_lon; ++j){
+        m.faces.push_back({ 0, ring(1, j + 1), ring(1, j) });
+        for(int64_t i = 1; (i + 1) < N_lat; ++i){
+            m.faces.push_back({ ring(i, j), ring(i, j + 1), ring(i + 1, j + 1), ring(i + 1, j) });
+        }
+        m.faces.push_back({ ring(N_lat - 1, j), ring(N_lat - 1, j + 1), north });
+    }
+    return m;
+}
+
+// A flat, open N x N grid of unit squares in the z = 0 plane.
+static
+fv_surface_mesh<double, uint64_t>
+make_grid(int64_t N){
+    fv_surface_mesh<double, uint64_t> m;
+    for(int64_t i = 0; i <= N; ++i){
+        for(int64_t j = 0; j <= N; ++j){
+            m.vertices.emplace_back( vec3<double>(static_cast<double>(j), static_cast<double>(i), 0.0) );
+        }
+    }
+    const auto index = [&](int64_t i, int64_t j){ return static_cast<uint64_t>(i * (N + 1) + j); };
+    for(int64_t i = 0; i < N; ++i){
+        for(int64_t j = 0; j < N; ++j){
+            m.faces.push_back({ index(i, j), index(i, j + 1), index(i + 1, j + 1) });
+            m.faces.push_back({ index(i, j), index(i + 1, j + 1), index(i + 1, j) });
+        }
+    }
+    return m;
+}
+
+// Verify the connectivity of every live element.
+static
+void
+require_valid(const half_edge_mesh &m){
+    const auto N_hes = static_cast<int64_t>(m.half_edges.size());
+    for(int64_t h = 0; h < N_hes; ++h){
+        const auto &he = m.half_edges[h];
+        const bool removed = (he.vertex == half_edge_mesh::invalid);
+        REQUIRE( removed == (m.half_edges[h ^ 1].vertex == half_edge_mesh::invalid) );
+        if(removed) continue;
+
+        REQUIRE( m.half_edges[he.next].prev == h );
+        REQUIRE( m.half_edges[he.prev].next == h );
+        REQUIRE( m.source(he.next) == he.vertex );
+        REQUIRE( m.half_edges[he.next].face == he.face );
+        REQUIRE( m.source(h) != m.target(h) );
+        REQUIRE( m.vertex_half_edge[he.vertex] != half_edge_mesh::invalid );
+        if(he.face != half_edge_mesh::invalid){
+            REQUIRE( m.face_half_edge[he.face] != half_edge_mesh::invalid );
+            REQUIRE( m.half_edges[m.half_edges[he.next].next].next == h );
+        }
+    }
+    for(int64_t v = 0; v < static_cast<int64_t>(m.vertex_half_edge.size()); ++v){
+        if(m.vertex_half_edge[v] == half_edge_mesh::invalid) continue;
+        REQUIRE( m.source(m.vertex_half_edge[v]) == v );
+        int64_t N_boundary = 0;
+        for(const auto &o : m.outgoing_half_edges(v)){
+            REQUIRE( m.source(o) == v );
+            if(m.is_boundary_half_edge(o)) ++N_boundary;
+        }
+        REQUIRE( N_boundary <= 1 );
+        REQUIRE( m.is_boundary_vertex(v) == (N_boundary == 1) );
+    }
+    for(const auto &h : m.face_half_edge){
+        if(h == half_edge_mesh::invalid) continue;
+        REQUIRE( m.half_edges[h].vertex != half_edge_mesh::invalid );
+    }
+}
+
+// Require the face-vertex mesh to be manifold, returning the signed volume and the number of boundary edges.
+static
+std::pair<double, int64_t>
+require_manifold(const fv_surface_mesh<double, uint64_t> &mesh){
+    std::map<std::pair<uint64_t, uint64_t>, int64_t> half_edges;
+    double volume = 0.0;
+    for(const auto &f : mesh.faces){
+        REQUIRE( f.size() == 3 );
+        for(size_t i = 0; i < 3; ++i){
+            half_edges[{ f[i], f[(i + 1) % 3] }] += 1;
+        }
+        volume += mesh.vertices.at(f[0]).Dot( mesh.vertices.at(f[1]).Cross(mesh.vertices.at(f[2])) ) / 6.0;
+    }
+    int64_t N_boundary = 0;
+    for(const auto &[e, n] : half_edges){
+        REQUIRE( n == 1 );
+        if(half_edges.count({ e.second, e.first }) == 0) ++N_boundary;
+    }
+    return { volume, N_boundary };
+}
+
+
+TEST_CASE( "half_edge_mesh construction" ){
+    const double radius = 3.0;
+    const auto sphere = make_sphere(radius, 16, 24);
+    const double expected_volume = 4.0 / 3.0 * M_PI * std::pow(radius, 3.0);
+
+    SUBCASE("well-formed meshes are triangulated without other changes"){
+        half_edge_mesh m(sphere);
+        require_valid(m);
+        REQUIRE( m.vertex_count() == static_cast<int64_t>(sphere.vertices.size()) );
+        REQUIRE( m.face_count() == 2 * 24 + 2 * 24 * 14 );
+
+        const auto out = m.to_fv_surface_mesh();
+        REQUIRE( out.vertices == sphere.vertices );
+        const auto [volume, N_boundary] = require_manifold(out);
+        REQUIRE( N_boundary == 0 );
+        REQUIRE( volume == doctest::Approx(expected_volume).epsilon(0.05) );
+    }
+
+    SUBCASE("inconsistent winding is repaired and can be made outward"){
+        auto flipped = sphere;
+        for(size_t i = 0; i < flipped.faces.size(); i += 3){
+            std::reverse(std::begin(flipped.faces[i]), std::end(flipped.faces[i]));
+        }
+        half_edge_mesh m(flipped);
+        require_valid(m);
+        m.orient_outward();
+        require_valid(m);
+        const auto [volume, N_boundary] = require_manifold(m.to_fv_surface_mesh());
+        REQUIRE( N_boundary == 0 );
+        REQUIRE( volume == doctest::Approx(expected_volume).epsilon(0.05) );
+    }
+
+    SUBCASE("non-manifold vertices and edges are separated"){
+        // Two tetrahedra sharing a single vertex.
+        fv_surface_mesh<double, uint64_t> bowtie;
+        bowtie.vertices = { vec3<double>(0.0, 0.0, 0.0),
+                            vec3<double>(1.0, 0.0, 0.0), vec3<double>(0.0, 1.0, 0.0), vec3<double>(0.0, 0.0, 1.0),
+                            vec3<double>(-1.0, 0.0, 0.0), vec3<double>(0.0, -1.0, 0.0), vec3<double>(0.0, 0.0, -1.0) };
+        for(const uint64_t o : { 0, 3 }){
+            const uint64_t a = 1 + o, b = 2 + o, c = 3 + o;
+            bowtie.faces.push_back({ 0, b, a });
+            bowtie.faces.push_back({ 0, c, b });
+            bowtie.faces.push_back({ 0, a, c });
+            bowtie.faces.push_back({ a, b, c });
+        }
+        half_edge_mesh m(bowtie);
+        require_valid(m);
+        REQUIRE( m.vertex_count() == 8 );
+        REQUIRE( require_manifold(m.to_fv_surface_mesh()).second == 0 );
+
+        // Three triangles sharing a single edge.
+        fv_surface_mesh<double, uint64_t> fin;
+        fin.vertices = { vec3<double>(0.0, 0.0, 0.0), vec3<double>(0.0, 0.0, 1.0),
+                         vec3<double>(1.0, 0.0, 0.0), vec3<double>(-1.0, 1.0, 0.0), vec3<double>(-1.0, -1.0, 0.0) };
+        fin.faces = { { 0, 1, 2 }, { 1, 0, 3 }, { 0, 1, 4 } };
+        half_edge_mesh n(fin);
+        require_valid(n);
+        REQUIRE( n.face_count() == 3 );
+        require_manifold(n.to_fv_surface_mesh());
+    }
+
+    SUBCASE("invalid meshes are rejected and unused vertices dropped"){
+        auto bad = sphere;
+        bad.faces.push_back({ 0, 1, bad.vertices.size() });
+        REQUIRE_THROWS_AS( half_edge_mesh{bad}, std::invalid_argument );
+
+        auto extra = sphere;
+        extra.vertices.emplace_back( vec3<double>(10.0, 10.0, 10.0) );
+        half_edge_mesh m(extra);
+        REQUIRE( m.vertex_count() == static_cast<int64_t>(sphere.vertices.size()) );
+        m.compact();
+        require_valid(m);
+        REQUIRE( m.to_fv_surface_mesh().vertices == sphere.vertices );
+    }
+}
+
+TEST_CASE( "half_edge_mesh edits" ){
+    SUBCASE("random edits preserve validity"){
+        for(const bool open : { false, true }){
+            half_edge_mesh m( open ? make_grid(8) : make_sphere(2.0, 10, 12) );
+            std::mt19937 re(open ? 1 : 2);
+
+            for(int64_t n = 0; n < 400; ++n){
+                const auto N_hes = static_cast<int64_t>(m.half_edges.size());
+                const auto h = std::uniform_int_distribution<int64_t>(0, N_hes - 1)(re);
+                if(m.half_edges[h].vertex == half_edge_mesh::invalid) continue;
+
+                const auto N_faces = m.face_count();
+                const auto N_verts = m.vertex_count();
+                const auto N_sides = (m.is_boundary_half_edge(h) ? 0 : 1) + (m.is_boundary_half_edge(h ^ 1) ? 0 : 1);
+                const auto A = m.positions[m.source(h)];
+                const auto B = m.positions[m.target(h)];
+                switch(n % 3){
+                    case 0:
+                        if(m.flip_edge(h)){
+                            REQUIRE( m.face_count() == N_faces );
+                        }
+                        break;
+                    case 1:
+                        m.split_edge(h, (A + B) * 0.5);
+                        REQUIRE( m.face_count() == N_faces + N_sides );
+                        REQUIRE( m.vertex_count() == N_verts + 1 );
+                        break;
+                    default:
+                        if(m.collapse_edge(h, B)){
+                            REQUIRE( m.face_count() == N_faces - N_sides );
+                            REQUIRE( m.vertex_count() == N_verts - 1 );
+                        }
+                        break;
+                }
+                require_valid(m);
+            }
+            m.compact();
+            require_valid(m);
+            const auto N_boundary = require_manifold(m.to_fv_surface_mesh()).second;
+            REQUIRE( open == (0 < N_boundary) );
+        }
+    }
+
+    SUBCASE("collapses violating the link condition are refused"){
+        // A tetrahedron cannot lose an edge without becoming degenerate.
+        fv_surface_mesh<double, uint64_t> tet;
+        tet.vertices = { vec3<double>(0.0, 0.0, 0.0), vec3<double>(1.0, 0.0, 0.0),
+                         vec3<double>(0.0, 1.0, 0.0), vec3<double>(0.0, 0.0, 1.0) };
+        tet.faces = { { 0, 2, 1 }, { 0, 3, 2 }, { 0, 1, 3 }, { 1, 2, 3 } };
+        half_edge_mesh m(tet);
+        for(int64_t h = 0; h < static_cast<int64_t>(m.half_edges.size()); ++h){
+            REQUIRE( !m.is_collapse_ok(h) );
+            REQUIRE( !m.collapse_edge(h, m.positions[m.target(h)]) );
+        }
+        require_valid(m);
+        REQUIRE( m.face_count() == 4 );
+    }
+}
+
+TEST_CASE( "half_edge_mesh simplification" ){
+    SUBCASE("closed meshes remain closed and retain their shape"){
+        const double radius = 5.0;
+        half_edge_mesh m(make_sphere(radius, 40, 60));
+        const auto N_faces = m.face_count();
+        const auto target = N_faces / 10;
+        REQUIRE( 0 < m.simplify(target) );
+        REQUIRE( m.face_count() <= target );
+        require_valid(m);
+
+        m.compact();
+        const auto [volume, N_boundary] = require_manifold(m.to_fv_surface_mesh());
+        REQUIRE( N_boundary == 0 );
+        REQUIRE( volume == doctest::Approx(4.0 / 3.0 * M_PI * std::pow(radius, 3.0)).epsilon(0.05) );
+        for(const auto &p : m.positions){
+            REQUIRE( p.length() == doctest::Approx(radius).epsilon(0.05) );
+        }
+    }
+
+    SUBCASE("flat regions collapse without error while boundaries are retained"){
+        half_edge_mesh m(make_grid(10));
+        m.simplify(0, 1E-12);
+        require_valid(m);
+        REQUIRE( m.face_count() < 20 );
+
+        m.compact();
+        const auto out = m.to_fv_surface_mesh();
+        const auto [volume, N_boundary] = require_manifold(out);
+        REQUIRE( 0 < N_boundary );
+        double area = 0.0;
+        for(const auto &f : out.faces){
+            const auto &A = out.vertices[f[0]];
+            const auto &B = out.vertices[f[1]];
+            const auto &C = out.vertices[f[2]];
+            area += (B - A).Cross(C - A).z * 0.5;
+        }
+        REQUIRE( area == doctest::Approx(100.0) );
+        for(const auto &p : out.vertices){
+            REQUIRE( std::abs(p.z) < 1E-9 );
+        }
+    }
+}
+
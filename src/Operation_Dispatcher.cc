@@ -4,15 +4,22 @@
 //
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <condition_variable>
 #include <exception>
 #include <functional>
 #include <list>
 #include <map>
+#include <mutex>
 #include <ostream>
+#include <set>
 #include <stdexcept>
 #include <string>    
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <Explicator.h>
 
@@ -21,6 +28,8 @@
 #include <YgorString.h>
 
 #include "Structs.h"
+#include "Thread_Pool.h"
+#include "Operation_Profiler.h"
 
 #include "Operations/AccumulateRowsColumns.h"
 #include "Operations/AnalyzeHistograms.h"
@@ -53,6 +62,7 @@
 #include "Operations/ConvertImageToDose.h"
 #include "Operations/ConvertImageToMeshes.h"
 #include "Operations/ConvertImageToWarp.h"
+#include "Operations/ConvertMeshesToContours.h"
 #include "Operations/ConvertMeshesToPoints.h"
 #include "Operations/ConvertPointsToMeshes.h"
 #include "Operations/ConvertNaNsToAir.h"
@@ -265,6 +275,7 @@
 #include "Operations/WidenTable.h"
 
 #include "Operations/MakeMeshesConvex.h"
+#include "Operations/MakeMeshesManifold.h"
 #include "Operations/OrientMeshes.h"
 #include "Operations/PatchMeshHoles.h"
 #include "Operations/RemeshSurfaceMeshes.h"
@@ -299,10 +310,8 @@
 #ifdef DCMA_USE_CGAL
     #include "Operations/BCCAExtractRadiomicFeatures.h"
     #include "Operations/ContourBooleanOperations.h"
-    #include "Operations/ConvertMeshesToContours.h"
     #include "Operations/DumpROISurfaceMeshes.h"
     #include "Operations/ExtractRadiomicFeatures.h"
-    #include "Operations/MakeMeshesManifold.h"
     #include "Operations/MinkowskiSum3D.h"
     #include "Operations/SeamContours.h"
 #endif // DCMA_USE_CGAL
@@ -317,7 +326,9 @@
 #include "Operation_Dispatcher.h"
 
 
-known_ops_t Known_Operations(){
+static
+known_ops_t
+Build_Known_Operations(){
     known_ops_t out;
 
     out["AccumulateRowsColumns"] = std::make_pair(OpArgDocAccumulateRowsColumns, AccumulateRowsColumns);
@@ -352,6 +363,7 @@ known_ops_t Known_Operations(){
     out["ConvertImageToDose"] = std::make_pair(OpArgDocConvertImageToDose, ConvertImageToDose);
     out["ConvertImageToMeshes"] = std::make_pair(OpArgDocConvertImageToMeshes, ConvertImageToMeshes);
     out["ConvertImageToWarp"] = std::make_pair(OpArgDocConvertImageToWarp, ConvertImageToWarp);
+    out["ConvertMeshesToContours"] = std::make_pair(OpArgDocConvertMeshesToContours, ConvertMeshesToContours);
     out["ConvertMeshesToPoints"] = std::make_pair(OpArgDocConvertMeshesToPoints, ConvertMeshesToPoints);
     out["ConvertPointsToMeshes"] = std::make_pair(OpArgDocConvertPointsToMeshes, ConvertPointsToMeshes);
     out["ConvertNaNsToAir"] = std::make_pair(OpArgDocConvertNaNsToAir, ConvertNaNsToAir);
@@ -475,6 +487,7 @@ known_ops_t Known_Operations(){
     out["LogScale"] = std::make_pair(OpArgDocLogScale, LogScale);
     out["MapTableToParameters"] = std::make_pair(OpArgDocMapTableToParameters, MapTableToParameters);
     out["MakeMeshesConvex"] = std::make_pair(OpArgDocMakeMeshesConvex, MakeMeshesConvex);
+    out["MakeMeshesManifold"] = std::make_pair(OpArgDocMakeMeshesManifold, MakeMeshesManifold);
     out["MaskParameters"] = std::make_pair(OpArgDocMaskParameters, MaskParameters);
     out["MaskVerbosity"] = std::make_pair(OpArgDocMaskVerbosity, MaskVerbosity);
     out["MaxMinPixels"] = std::make_pair(OpArgDocMaxMinPixels, MaxMinPixels);
@@ -596,10 +609,8 @@ known_ops_t Known_Operations(){
 #ifdef DCMA_USE_CGAL
     out["BCCAExtractRadiomicFeatures"] = std::make_pair(OpArgDocBCCAExtractRadiomicFeatures, BCCAExtractRadiomicFeatures);
     out["ContourBooleanOperations"] = std::make_pair(OpArgDocContourBooleanOperations, ContourBooleanOperations);
-    out["ConvertMeshesToContours"] = std::make_pair(OpArgDocConvertMeshesToContours, ConvertMeshesToContours);
     out["DumpROISurfaceMeshes"] = std::make_pair(OpArgDocDumpROISurfaceMeshes, DumpROISurfaceMeshes);
     out["ExtractRadiomicFeatures"] = std::make_pair(OpArgDocExtractRadiomicFeatures, ExtractRadiomicFeatures);
-    out["MakeMeshesManifold"] = std::make_pair(OpArgDocMakeMeshesManifold, MakeMeshesManifold);
     out["MinkowskiSum3D"] = std::make_pair(OpArgDocMinkowskiSum3D, MinkowskiSum3D);
     out["SeamContours"] = std::make_pair(OpArgDocSeamContours, SeamContours);
 #endif // DCMA_USE_CGAL
@@ -614,51 +625,88 @@ known_ops_t Known_Operations(){
     return out;
 }
 
-known_ops_t Known_Operations_and_Aliases(){
-    auto out = Known_Operations();
-
-    // Create a separate map for all listed aliases.
-    known_ops_t aliases;
-    for(const auto &p : out){
-        const auto op_name = p.first;
-        auto OpDocs = p.second.first();
-        for(const auto &alias : OpDocs.aliases){
-            // Wrap the canonical functor to rewrite aliases to both include the canonical name and exclude the alias.
-            op_doc_func_t l_op_doc = [op_name,alias,OpDocs](){
-                auto l_docs = OpDocs;
-                l_docs.aliases.push_back(op_name);
-                l_docs.aliases.remove(alias);
-                return l_docs;
-            };
-
-            aliases[alias] = std::make_pair(l_op_doc, p.second.second);
-        }
-    }
+namespace {
 
-    out.merge(aliases);
-    return out;
-}
+struct op_registry_entry_t {
+    std::string name; // The canonical operation name.
+    OperationDoc docs;
+    op_func_t func;
+};
 
-std::map<std::string, std::string> Operation_Lexicon(){
-    // Prepare a lexicon (suitable for an Explicator instance) for performing fuzzy operation name matching.
-    auto op_name_mapping = Known_Operations();
+// A process-wide index of the known operations.
+//
+// Building it requires generating the documentation for every operation, so it is built once, on first use, and is
+// immutable afterward. It can therefore be shared between threads without locking.
+struct op_registry_t {
+    known_ops_t ops;
+    known_ops_t ops_and_aliases;
+    std::map<std::string, std::string> lexicon; // Names and aliases --> canonical names.
+
+    std::list<op_registry_entry_t> entries;
+    std::unordered_map<std::string, const op_registry_entry_t *> by_name; // Names and aliases --> entries.
+};
+
+const op_registry_t &
+Operation_Registry(){
+    static const op_registry_t registry = [](){
+        op_registry_t r;
+        r.ops = Build_Known_Operations();
+        r.ops_and_aliases = r.ops;
+
+        for(const auto &p : r.ops){
+            const auto &op_name = p.first;
+            r.entries.push_back( op_registry_entry_t{ op_name, p.second.first(), p.second.second } );
+            const auto &OpDocs = r.entries.back().docs;
+
+            r.lexicon[op_name] = op_name;
+            for(const auto &alias : OpDocs.aliases){
+                r.lexicon[alias] = op_name;
+
+                // Wrap the canonical functor to rewrite aliases to both include the canonical name and exclude the alias.
+                op_doc_func_t l_op_doc = [op_name,alias,OpDocs](){
+                    auto l_docs = OpDocs;
+                    l_docs.aliases.push_back(op_name);
+                    l_docs.aliases.remove(alias);
+                    return l_docs;
+                };
+                r.ops_and_aliases.emplace(alias, std::make_pair(l_op_doc, p.second.second));
+            }
+        }
 
-    std::map<std::string, std::string> op_name_lex;
-    for(const auto &op_func : op_name_mapping){
-        const auto op_name = op_func.first;
-        op_name_lex[op_name] = op_name;
+        // Explicit mappings go here.
 
-        auto OpDocs = op_func.second.first();
-        for(const auto &alias : OpDocs.aliases){
-            op_name_lex[alias] = op_name;
+        // ... TODO ...
+
+        // Serve the cached documentation rather than regenerating it.
+        //
+        // Note: entries are stored in a list, so their addresses remain valid when the registry is moved.
+        std::map<std::string, const op_registry_entry_t *> canonical;
+        for(const auto &entry : r.entries){
+            canonical[entry.name] = &entry;
+            r.ops.at(entry.name).first = [e = &entry](){ return e->docs; };
+            r.ops_and_aliases.at(entry.name).first = r.ops.at(entry.name).first;
         }
-    }
+        for(const auto &[name, op_name] : r.lexicon){
+            r.by_name[name] = canonical.at(op_name);
+        }
+        return r;
+    }();
+    return registry;
+}
 
-    // Explicit mappings go here.
+} // namespace
 
-    // ... TODO ...
+known_ops_t Known_Operations(){
+    return Operation_Registry().ops;
+}
 
-    return op_name_lex;
+known_ops_t Known_Operations_and_Aliases(){
+    return Operation_Registry().ops_and_aliases;
+}
+
+std::map<std::string, std::string> Operation_Lexicon(){
+    // Prepare a lexicon (suitable for an Explicator instance) for performing fuzzy operation name matching.
+    return Operation_Registry().lexicon;
 }
 
 static
@@ -766,77 +814,476 @@ known_ops_tags_t Get_Unique_Tags(const known_ops_t &kos){
 }
 
 
-bool Operation_Dispatcher( Drover &DICOM_data,
-                           std::map<std::string,std::string> &InvocationMetadata,
-                           const std::string &FilenameLex,
-                           const std::list<OperationArgPkg> &Operations ){
+static
+compiled_operation_t
+Resolve_Operation( const OperationArgPkg &OptArgs ){
+    const auto &registry = Operation_Registry();
+    auto optargs = OptArgs;
+
+    // Exact names and aliases are looked up directly. Otherwise, estimate the canonical name and issue a warning.
+    const auto user_op_name = optargs.getName();
+    const op_registry_entry_t *entry = nullptr;
+    if(const auto it = registry.by_name.find(user_op_name); it != std::end(registry.by_name)){
+        entry = it->second;
+
+    }else{
+        std::string canonical_op_name;
+        {
+            // Fuzzy matching is comparatively rare and the matcher is stateful, so a single shared instance is used.
+            static std::mutex m;
+            std::lock_guard<std::mutex> lock(m);
+            static Explicator op_name_X( registry.lexicon );
+            canonical_op_name = op_name_X(user_op_name);
+            if( op_name_X.last_best_score < 1.0 ){
+                YLOGWARN("Selecting operation '" << canonical_op_name << "' because '" << user_op_name << "' not understood");
+            }
+        }
 
-    auto op_name_mapping = Known_Operations();
-    Explicator op_name_X( Operation_Lexicon() );
+        for(const auto &e : registry.entries){
+            if(boost::iequals(e.name, canonical_op_name)){
+                entry = &e;
+                break;
+            }
+        }
+    }
+    if(entry == nullptr){
+        throw std::invalid_argument("No operation matched '" + optargs.getName() + "'");
+    }
 
-    try{
-        for(const auto &OptArgs : Operations){
-            auto optargs = OptArgs;
+    // Attempt to insert all expected, documented parameters with the default value.
+    //
+    // Note that existing keys will not be replaced.
+    for(const auto &r : entry->docs.args){
+        if(r.expected) optargs.insert( r.name, r.default_val );
+    }
+    compiled_operation_t out;
+    out.name = entry->name;
+    out.docs = &(entry->docs);
+    out.func = entry->func;
+    std::as_const(optargs).visit_opts([&out](const std::string &/*key*/, const std::string &val){
+        if(val.find('$') != std::string::npos) out.has_macros = true;
+        return;
+    });
+    out.optargs = std::move(optargs);
+    return out;
+}
 
-            // Find or estimate the canonical name. If not an exact match, issue a warning.
-            const auto user_op_name = optargs.getName();
-            const auto canonical_op_name = op_name_X(user_op_name);
-            if( op_name_X.last_best_score < 1.0 ){
-                YLOGWARN("Selecting operation '" << canonical_op_name << "' because '" << user_op_name << "' not understood");
+// Report arguments that are not documented, and values that are not among an exhaustive list of documented options.
+static
+void
+Validate_Operation_Arguments( const compiled_operation_t &op,
+                              std::list<std::string> &diagnostics ){
+    icase_map_t<const OperationArgDoc *> documented(icase_str_lt);
+    for(const auto &a : op.docs->args){
+        documented[a.name] = &a;
+    }
+
+    op.optargs.visit_opts([&](const std::string &key, const std::string &val){
+        const auto it = documented.find(key);
+        if(it == std::end(documented)){
+            diagnostics.emplace_back("Operation '" + op.name + "' does not accept argument '" + key + "'");
+            return;
+        }
+
+        // Values containing macros can only be checked after expansion.
+        const auto &doc = *(it->second);
+        if( (doc.samples == OpArgSamples::Exhaustive)
+        &&  !doc.examples.empty()
+        &&  (val.find('$') == std::string::npos) ){
+            const bool is_option = std::any_of( std::begin(doc.examples), std::end(doc.examples),
+                                                [&val](const std::string &e){ return boost::iequals(e, val); } );
+            if(!is_option){
+                diagnostics.emplace_back("Operation '" + op.name + "' argument '" + key + "' value '" + val
+                                         + "' is not one of the documented options");
+            }
+        }
+        return;
+    });
+    return;
+}
+
+static
+void
+Expand_Operation_Macros( OperationArgPkg &optargs,
+                         const std::map<std::string,std::string> &InvocationMetadata ){
+    // Perform macro replacement using the parameter table.
+
+    // First, try replace required-replacement macros like '$$xyz'.
+    // If these cannot be replaced, do not proceed.
+    optargs.visit_opts([&InvocationMetadata](const std::string &key, std::string &val){
+        const std::string required_macro_symbol = "$$";
+        val = ExpandMacros(val, InvocationMetadata, required_macro_symbol);
+
+        const auto pos = val.find(required_macro_symbol);
+        if(pos != std::string::npos){
+            throw std::runtime_error("Unable to replace required macro for key '$$" + key + "'");
+        }
+        return;
+    });
+
+    // Second, replace '$' macros, which might need to be passed through to the operation
+    // to be properly expanded.
+    optargs.visit_opts([&InvocationMetadata](const std::string &/*key*/, std::string &val){
+        val = ExpandMacros(val, InvocationMetadata, "$");
+        return;
+    });
+    return;
+}
+
+// The resources an operation is documented to access.
+struct op_footprint_t {
+    std::string name;
+    std::set<drover_member_t> reads;
+    std::set<drover_member_t> writes;
+
+    // Whether the reads and writes are known. Otherwise the operation might access any Drover member.
+    bool is_documented = false;
+
+    // Barriers might access anything (including the invocation metadata), so they never run concurrently.
+    bool is_barrier = true;
+};
+
+static
+op_footprint_t
+Infer_Operation_Footprint( const compiled_operation_t &op ){
+    // An operation is only considered for concurrent execution when every argument that selects data documents its
+    // flow (i.e., ingress or egress). By documenting flows, an operation asserts that it accesses only the selected
+    // data. Operations that do not document flows are conservatively treated as barriers.
+    op_footprint_t out;
+    out.name = op.name;
+
+    // Operations with children can run arbitrary sub-operations.
+    if(!op.optargs.getChildren().empty()) return out;
+
+    // Operations that access the invocation metadata are barriers, but their Drover access can still be documented.
+    bool accesses_metadata = false;
+    bool only_parameter_table = false;
+    for(const auto &tag : op.docs->tags){
+        if( (tag == "category: meta")
+        ||  (tag == "category: control flow")
+        ||  (tag == "category: interactive") ){
+            return out;
+        }
+        if(tag == "category: parameter table"){
+            accesses_metadata = true;
+            only_parameter_table = true;
+        }
+        if(tag == "category: metadata"){
+            accesses_metadata = true;
+        }
+    }
+
+    const std::list<std::pair<std::string, drover_member_t>> selector_suffixes = {
+        { "ImageSelection",      drover_member_t::images },
+        { "PointSelection",      drover_member_t::points },
+        { "MeshSelection",       drover_member_t::meshes },
+        { "RTPlanSelection",     drover_member_t::rtplans },
+        { "LineSelection",       drover_member_t::lsamps },
+        { "LineSampleSelection", drover_member_t::lsamps },
+        { "LSampSelection",      drover_member_t::lsamps },
+        { "TransformSelection",  drover_member_t::transforms },
+        { "WarpSelection",       drover_member_t::transforms },
+        { "TableSelection",      drover_member_t::tables },
+        { "ROILabelRegex",       drover_member_t::contours },
+        { "ROISelection",        drover_member_t::contours },
+    };
+    for(const auto &arg : op.docs->args){
+        std::optional<drover_member_t> resource;
+        for(const auto &[suffix, r] : selector_suffixes){
+            if(boost::algorithm::ends_with(arg.name, suffix)){
+                resource = r;
+                break;
+            }
+        }
+        if( !resource
+        &&  boost::algorithm::ends_with(arg.name, "Selection") ){
+            return out; // An unrecognized selector.
+        }
+        if(!resource) continue;
+
+        if(arg.flow == OpArgFlow::Ingress){
+            out.reads.insert(resource.value());
+        }else if(arg.flow == OpArgFlow::Egress){
+            out.writes.insert(resource.value());
+        }else if(arg.flow == OpArgFlow::IngressEgress){
+            out.reads.insert(resource.value());
+            out.writes.insert(resource.value());
+        }else{
+            return out; // Undocumented flow.
+        }
+    }
+
+    // Operations without any selectors could access anything, except for those that only access the parameter table.
+    const bool selects_data = !(out.reads.empty() && out.writes.empty());
+    out.is_documented = selects_data || only_parameter_table;
+    out.is_barrier = !selects_data || accesses_metadata;
+    return out;
+}
+
+static
+bool
+Footprints_Conflict( const op_footprint_t &a,
+                     const op_footprint_t &b ){
+    if(a.is_barrier || b.is_barrier) return true;
+
+    // Instances of the same operation may contend for external resources, such as default output filenames.
+    if(a.name == b.name) return true;
+
+    const auto overlap = [](const std::set<drover_member_t> &x, const std::set<drover_member_t> &y) -> bool {
+        return std::any_of( std::begin(x), std::end(x),
+                            [&y](drover_member_t r) -> bool { return (y.count(r) != 0); } );
+    };
+    return overlap(a.writes, b.writes)
+        || overlap(a.writes, b.reads)
+        || overlap(a.reads, b.writes);
+}
+
+// Count the objects in each Drover member, for profiling. When a set of resources is provided, only those members are
+// counted; members outside an operation's footprint might be concurrently modified by other operations.
+static
+drover_counts_t
+Count_Drover_Objects( const Drover &DICOM_data,
+                      const std::set<drover_member_t> *resources = nullptr ){
+    const auto wanted = [&](drover_member_t r) -> bool {
+        return (resources == nullptr) || (resources->count(r) != 0);
+    };
+
+    drover_counts_t out;
+    if(wanted(drover_member_t::contours)){
+        out["contours"] = (DICOM_data.contour_data == nullptr) ? 0 : static_cast<int64_t>(DICOM_data.contour_data->ccs.size());
+    }
+    if(wanted(drover_member_t::images)) out["images"] = static_cast<int64_t>(DICOM_data.image_data.size());
+    if(wanted(drover_member_t::points)) out["points"] = static_cast<int64_t>(DICOM_data.point_data.size());
+    if(wanted(drover_member_t::meshes)) out["meshes"] = static_cast<int64_t>(DICOM_data.smesh_data.size());
+    if(wanted(drover_member_t::rtplans)) out["rtplans"] = static_cast<int64_t>(DICOM_data.rtplan_data.size());
+    if(wanted(drover_member_t::lsamps)) out["lsamps"] = static_cast<int64_t>(DICOM_data.lsamp_data.size());
+    if(wanted(drover_member_t::transforms)) out["transforms"] = static_cast<int64_t>(DICOM_data.trans_data.size());
+    if(wanted(drover_member_t::tables)) out["tables"] = static_cast<int64_t>(DICOM_data.table_data.size());
+    return out;
+}
+
+// Run a single operation. If the operation runs concurrently with others, its footprint should be provided.
+static
+void
+Run_Operation( const compiled_operation_t &op,
+               Drover &DICOM_data,
+               std::map<std::string,std::string> &InvocationMetadata,
+               const std::string &FilenameLex,
+               const op_footprint_t *footprint = nullptr ){
+    YLOGINFO("Performing operation '" << op.name << "' now..");
+    op.optargs.visit_opts([](const std::string &key, const std::string &val){
+        YLOGDEBUG("  Parameter '" << key << "' = '" << val << "'");
+        return;
+    });
+
+    const bool profiling = Operation_Profiling_Enabled();
+    std::set<drover_member_t> resources;
+    if(footprint != nullptr){
+        resources = footprint->reads;
+        resources.insert( std::begin(footprint->writes), std::end(footprint->writes) );
+    }
+    const auto *resources_ptr = (footprint == nullptr) ? nullptr : &resources;
+
+    Operation_Profile_Scope profile( op.name,
+                                     profiling ? Count_Drover_Objects(DICOM_data, resources_ptr) : drover_counts_t() );
+    const bool res = op.func(DICOM_data,
+                             op.optargs,
+                             InvocationMetadata,
+                             FilenameLex);
+    profile.finish( res, profiling ? Count_Drover_Objects(DICOM_data, resources_ptr) : drover_counts_t() );
+    if(!res) throw std::runtime_error("Truthiness is false");
+    return;
+}
+
+// Run a group of non-barrier operations, concurrently where their footprints permit.
+//
+// Each operation depends on every earlier operation in the group with a conflicting footprint. Operations without
+// outstanding dependencies are dispatched to the thread pool as soon as their dependencies complete. Every operation
+// sees the same copy of the invocation metadata, and modifications are merged afterward in the original order, so
+// the outcome does not depend on scheduling.
+static
+void
+Run_Operations_Concurrently( Drover &DICOM_data,
+                             std::map<std::string,std::string> &InvocationMetadata,
+                             const std::string &FilenameLex,
+                             std::vector<compiled_operation_t> &ops,
+                             const std::vector<op_footprint_t> &footprints,
+                             unsigned int n_workers ){
+    const size_t N = ops.size();
+
+    const auto snapshot = InvocationMetadata;
+    for(auto &op : ops){
+        if(op.has_macros) Expand_Operation_Macros(op.optargs, snapshot);
+    }
+    std::vector<std::map<std::string,std::string>> metadata(N, snapshot);
+
+    std::vector<std::vector<size_t>> dependents(N);
+    std::vector<size_t> n_deps(N, 0);
+    for(size_t j = 0; j < N; ++j){
+        for(size_t i = 0; i < j; ++i){
+            if(Footprints_Conflict(footprints[i], footprints[j])){
+                dependents[i].push_back(j);
+                ++n_deps[j];
             }
+        }
+    }
 
-            bool WasFound = false;
-            for(const auto &op_func : op_name_mapping){
-                if(boost::iequals(op_func.first, canonical_op_name)){
-                    WasFound = true;
-
-                    // Attempt to insert all expected, documented parameters with the default value.
-                    //
-                    // Note that existing keys will not be replaced.
-                    auto OpDocs = op_func.second.first();
-                    for(const auto &r : OpDocs.args){
-                        if(r.expected) optargs.insert( r.name, r.default_val );
-                    }
-
-                    // Perform macro replacement using the parameter table.
-
-                    // First, try replace required-replacement macros like '$$xyz'.
-                    // If these cannot be replaced, do not proceed.
-                    optargs.visit_opts([&InvocationMetadata](const std::string &key, std::string &val){
-                        const std::string required_macro_symbol = "$$";
-                        val = ExpandMacros(val, InvocationMetadata, required_macro_symbol);
-
-                        const auto pos = val.find(required_macro_symbol);
-                        if(pos != std::string::npos){
-                            throw std::runtime_error("Unable to replace required macro for key '$$" + key + "'");
-                        }
-                        return;
-                    });
-
-                    // Second, replace '$' macros, which might need to be passed through to the operation
-                    // to be properly expanded.
-                    optargs.visit_opts([&InvocationMetadata](const std::string &/*key*/, std::string &val){
-                        val = ExpandMacros(val, InvocationMetadata, "$");
-                        return;
-                    });
-
-
-                    YLOGINFO("Performing operation '" << op_func.first << "' now..");
-                    optargs.visit_opts([](const std::string &key, const std::string &val){
-                        YLOGDEBUG("  Parameter '" << key << "' = '" << val << "'");
-                        return;
-                    });
-
-                    const bool res = op_func.second.second(DICOM_data,
-                                                           optargs,
-                                                           InvocationMetadata,
-                                                           FilenameLex);
-                    if(!res) throw std::runtime_error("Truthiness is false");
-
-                    break;
+    std::vector<std::exception_ptr> eptrs(N);
+    std::vector<bool> launched(N, false);
+    {
+        std::mutex m;
+        std::condition_variable cv;
+        std::list<size_t> completed;
+
+        work_queue<std::function<void(void)>> wq( std::clamp<unsigned int>(n_workers, 1U, static_cast<unsigned int>(N)) );
+        const auto launch = [&](size_t k) -> void {
+            launched[k] = true;
+            wq.submit_task([&,k]() -> void {
+                try{
+                    Run_Operation(ops[k], DICOM_data, metadata[k], FilenameLex, &(footprints[k]));
+                }catch(...){
+                    eptrs[k] = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    completed.push_back(k);
                 }
+                cv.notify_all();
+            });
+        };
+
+        std::unique_lock<std::mutex> lock(m);
+        size_t n_launched = 0;
+        for(size_t k = 0; k < N; ++k){
+            if(n_deps[k] == 0){
+                launch(k);
+                ++n_launched;
+            }
+        }
+
+        // Release dependents as operations complete. After a failure, no further operations are started.
+        bool failed = false;
+        size_t n_completed = 0;
+        while(n_completed < n_launched){
+            cv.wait(lock, [&]() -> bool { return !completed.empty(); });
+            const auto k = completed.front();
+            completed.pop_front();
+            ++n_completed;
+
+            if(eptrs[k]) failed = true;
+            if(failed) continue;
+            for(const auto j : dependents[k]){
+                if(--n_deps[j] == 0){
+                    launch(j);
+                    ++n_launched;
+                }
+            }
+        }
+    } // Wait for all tasks to complete.
+
+    // Merge metadata modifications in the original order.
+    for(size_t k = 0; k < N; ++k){
+        if(!launched[k]) continue;
+        for(const auto &kv : metadata[k]){
+            const auto it = snapshot.find(kv.first);
+            if( (it == std::end(snapshot))
+            ||  (it->second != kv.second) ){
+                InvocationMetadata[kv.first] = kv.second;
+            }
+        }
+        for(const auto &kv : snapshot){
+            if(metadata[k].count(kv.first) == 0){
+                InvocationMetadata.erase(kv.first);
+            }
+        }
+    }
+
+    // Report the earliest failure.
+    for(const auto &eptr : eptrs){
+        if(eptr) std::rethrow_exception(eptr);
+    }
+    return;
+}
+
+
+operation_plan_t Compile_Operations( const std::list<OperationArgPkg> &Operations,
+                                     std::list<std::string> *diagnostics ){
+    operation_plan_t out;
+    for(const auto &OptArgs : Operations){
+        out.emplace_back( Resolve_Operation(OptArgs) );
+        if(diagnostics != nullptr){
+            Validate_Operation_Arguments(out.back(), *diagnostics);
+        }
+
+        // Children are checked to report problems before anything runs, but they are compiled and run by their parent
+        // operation. Failures are not fatal here since some parents (e.g., Ignore) tolerate failing children.
+        if(diagnostics != nullptr){
+            try{
+                Compile_Operations(OptArgs.getChildren(), diagnostics);
+            }catch(const std::exception &e){
+                diagnostics->emplace_back(e.what());
+            }
+        }
+    }
+    return out;
+}
+
+
+bool Execute_Operations( Drover &DICOM_data,
+                         std::map<std::string,std::string> &InvocationMetadata,
+                         const std::string &FilenameLex,
+                         const operation_plan_t &plan ){
+
+    // Operations are run one at a time in the order provided, unless the 'DispatcherThreads' invocation metadata key
+    // is set greater than one (e.g., '-m DispatcherThreads=8'). In that case, consecutive operations that document
+    // disjoint data access are run concurrently. Operations that do not document their data access act as barriers.
+    unsigned int n_workers = 1;
+    if(auto it = InvocationMetadata.find("DispatcherThreads"); it != std::end(InvocationMetadata)){
+        try{
+            const auto requested = std::stol(it->second);
+            if(0 < requested) n_workers = static_cast<unsigned int>(requested);
+        }catch(const std::exception &){
+            YLOGWARN("Unable to parse DispatcherThreads = '" << it->second << "', using default");
+        }
+    }
+
+    try{
+        if(n_workers <= 1){
+            for(const auto &op : plan){
+                if(!op.has_macros){
+                    Run_Operation(op, DICOM_data, InvocationMetadata, FilenameLex);
+                    continue;
+                }
+                auto l_op = op;
+                Expand_Operation_Macros(l_op.optargs, InvocationMetadata);
+                Run_Operation(l_op, DICOM_data, InvocationMetadata, FilenameLex);
+            }
+
+        }else{
+            auto it = std::begin(plan);
+            while(it != std::end(plan)){
+                auto footprint = Infer_Operation_Footprint(*it);
+                if(footprint.is_barrier){
+                    auto l_op = *it;
+                    if(l_op.has_macros) Expand_Operation_Macros(l_op.optargs, InvocationMetadata);
+                    Run_Operation(l_op, DICOM_data, InvocationMetadata, FilenameLex);
+                    ++it;
+                    continue;
+                }
+
+                // Gather the following non-barrier operations.
+                std::vector<compiled_operation_t> group;
+                std::vector<op_footprint_t> footprints;
+                group.emplace_back(*it);
+                footprints.emplace_back(std::move(footprint));
+                for(++it; it != std::end(plan); ++it){
+                    auto next_footprint = Infer_Operation_Footprint(*it);
+                    if(next_footprint.is_barrier) break;
+                    group.emplace_back(*it);
+                    footprints.emplace_back(std::move(next_footprint));
+                }
+                Run_Operations_Concurrently(DICOM_data, InvocationMetadata, FilenameLex, group, footprints, n_workers);
             }
-            if(!WasFound) throw std::invalid_argument("No operation matched '" + optargs.getName() + "'");
         }
     }catch(const std::exception &e){
         YLOGWARN("Analysis failed: '" << e.what() << "'. Aborting remaining analyses");
@@ -845,3 +1292,33 @@ bool Operation_Dispatcher( Drover &DICOM_data,
 
     return true;
 }
+
+
+bool Operation_Dispatcher( Drover &DICOM_data,
+                           std::map<std::string,std::string> &InvocationMetadata,
+                           const std::string &FilenameLex,
+                           const std::list<OperationArgPkg> &Operations ){
+    operation_plan_t plan;
+    try{
+        plan = Compile_Operations(Operations);
+    }catch(const std::exception &e){
+        YLOGWARN("Analysis failed: '" << e.what() << "'. Aborting remaining analyses");
+        return false;
+    }
+    return Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan);
+}
+
+
+std::set<drover_member_t> Operations_Modified_Members(const std::list<OperationArgPkg> &Operations){
+    std::set<drover_member_t> out;
+    for(const auto &OptArgs : Operations){
+        try{
+            const auto footprint = Infer_Operation_Footprint( Resolve_Operation(OptArgs) );
+            if(!footprint.is_documented) return All_Drover_Members();
+            out.insert( std::begin(footprint.writes), std::end(footprint.writes) );
+        }catch(const std::exception &){
+            return All_Drover_Members();
+        }
+    }
+    return out;
+}
@@ -37,3 +37,33 @@ bool Operation_Dispatcher( Drover &DICOM_data,
                            const std::string &FilenameLex,
                            const std::list<OperationArgPkg> &Operations);
 
+
+// An operation that has been matched with an implementation, ready to be run repeatedly.
+struct compiled_operation_t {
+    std::string name; // The canonical operation name.
+    const OperationDoc *docs = nullptr; // Owned by the operation registry.
+    op_func_t func;
+    OperationArgPkg optargs; // The user-provided arguments, supplemented with documented defaults.
+    bool has_macros = false; // Whether any argument needs macro expansion before each invocation.
+
+    compiled_operation_t() : optargs("unspecified") {};
+};
+
+using operation_plan_t = std::list<compiled_operation_t>;
+
+// Resolve operation names and apply default arguments once, so the result can be executed many times. Throws if any
+// operation cannot be resolved. If diagnostics are requested, children are also checked, and unresolvable children,
+// unrecognized arguments, and values outside an exhaustive list of documented options are reported.
+operation_plan_t Compile_Operations( const std::list<OperationArgPkg> &Operations,
+                                     std::list<std::string> *diagnostics = nullptr );
+
+// Run a compiled plan. Equivalent to Operation_Dispatcher(), but name resolution is not repeated.
+bool Execute_Operations( Drover &DICOM_data,
+                         std::map<std::string,std::string> &InvocationMetadata,
+                         const std::string &FilenameLex,
+                         const operation_plan_t &plan );
+
+
+// The Drover members that the given operations might modify in place. A member is only omitted when every operation
+// documents that it does not modify that member.
+std::set<drover_member_t> Operations_Modified_Members(const std::list<OperationArgPkg> &Operations);
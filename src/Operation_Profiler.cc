@@ -0,0 +1,213 @@
+//Operation_Profiler.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file records per-operation telemetry and writes it as a Chrome trace.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    #include <sys/resource.h>
+#endif
+
+#include "YgorLog.h"
+
+#include "Operation_Profiler.h"
+
+namespace {
+
+struct op_record_t {
+    std::string name;
+    int64_t tid = 0;
+    int64_t depth = 0;
+    int64_t start_wall_us = 0;
+    int64_t wall_us = 0;
+    double cpu_ms = 0.0;
+    int64_t peak_rss_delta_kb = 0;
+    bool success = false;
+    drover_counts_t counts_before;
+    drover_counts_t counts_after;
+};
+
+std::atomic<bool> profiling_enabled{false};
+
+std::mutex profile_mutex; // Guards the following.
+std::filesystem::path profile_filename;
+std::list<op_record_t> profile_records;
+std::map<std::thread::id, int64_t> profile_tids;
+
+// Nesting depth of operations on the current thread.
+thread_local int64_t profile_depth = 0;
+
+const auto profile_epoch = std::chrono::steady_clock::now();
+
+int64_t wall_time_us(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - profile_epoch).count();
+}
+
+// CPU time consumed by the whole process. This includes any threads an operation launches, but also any concurrently
+// running operations.
+double cpu_time_ms(){
+#if !defined(_WIN32) && !defined(_WIN64)
+    struct rusage ru;
+    if(::getrusage(RUSAGE_SELF, &ru) == 0){
+        const auto to_ms = [](const struct timeval &tv) -> double {
+            return static_cast<double>(tv.tv_sec) * 1000.0 + static_cast<double>(tv.tv_usec) / 1000.0;
+        };
+        return to_ms(ru.ru_utime) + to_ms(ru.ru_stime);
+    }
+#endif
+    return 1000.0 * static_cast<double>(std::clock()) / static_cast<double>(CLOCKS_PER_SEC);
+}
+
+// The peak resident set size of the process, in KiB. Zero if unavailable.
+int64_t peak_rss_kb(){
+#if !defined(_WIN32) && !defined(_WIN64)
+    struct rusage ru;
+    if(::getrusage(RUSAGE_SELF, &ru) == 0){
+#if defined(__APPLE__)
+        return static_cast<int64_t>(ru.ru_maxrss) / 1024; // Reported in bytes.
+#else
+        return static_cast<int64_t>(ru.ru_maxrss); // Reported in KiB.
+#endif
+    }
+#endif
+    return 0;
+}
+
+std::string json_escape(const std::string &in){
+    std::ostringstream ss;
+    for(const unsigned char c : in){
+        if(c == '"'){
+            ss << "\\\"";
+        }else if(c == '\\'){
+            ss << "\\\\";
+        }else if(c < 0x20){
+            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        }else{
+            ss << c;
+        }
+    }
+    return ss.str();
+}
+
+} // namespace
+
+
+void Enable_Operation_Profiling(const std::filesystem::path &trace_filename){
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    profile_filename = trace_filename;
+    profiling_enabled = true;
+    return;
+}
+
+bool Operation_Profiling_Enabled(){
+    return profiling_enabled;
+}
+
+
+Operation_Profile_Scope::Operation_Profile_Scope(const std::string &name, const drover_counts_t &counts_before){
+    if(!profiling_enabled) return;
+
+    this->active = true;
+    this->name = name;
+    this->depth = profile_depth++;
+    this->counts_before = counts_before;
+    this->start_peak_rss_kb = peak_rss_kb();
+    this->start_cpu_ms = cpu_time_ms();
+    this->start_wall_us = wall_time_us();
+}
+
+Operation_Profile_Scope::~Operation_Profile_Scope(){
+    if(this->active && !this->finished){
+        try{
+            this->record(false, {});
+        }catch(...){ }
+    }
+}
+
+void Operation_Profile_Scope::finish(bool success, const drover_counts_t &counts_after){
+    if(this->active && !this->finished){
+        this->record(success, counts_after);
+    }
+    return;
+}
+
+void Operation_Profile_Scope::record(bool success, const drover_counts_t &counts_after){
+    this->finished = true;
+    --profile_depth;
+
+    op_record_t r;
+    r.name = this->name;
+    r.depth = this->depth;
+    r.start_wall_us = this->start_wall_us;
+    r.wall_us = wall_time_us() - this->start_wall_us;
+    r.cpu_ms = cpu_time_ms() - this->start_cpu_ms;
+    r.peak_rss_delta_kb = peak_rss_kb() - this->start_peak_rss_kb;
+    r.success = success;
+    r.counts_before = this->counts_before;
+    r.counts_after = counts_after;
+
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    const auto tid_it = profile_tids.emplace(std::this_thread::get_id(), static_cast<int64_t>(profile_tids.size())).first;
+    r.tid = tid_it->second;
+    profile_records.emplace_back(std::move(r));
+    return;
+}
+
+
+bool Write_Operation_Profile(){
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    if(!profiling_enabled) return false;
+
+    std::ofstream of(profile_filename, std::ios::out | std::ios::trunc);
+    if(!of){
+        YLOGWARN("Unable to open profile trace file '" << profile_filename.string() << "' for writing");
+        return false;
+    }
+
+    // Each invocation is a 'complete' event. Times are in microseconds.
+    of << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for(const auto &r : profile_records){
+        of << (first ? "\n" : ",\n");
+        first = false;
+        of << "{\"name\":\"" << json_escape(r.name) << "\""
+           << ",\"cat\":\"operation\",\"ph\":\"X\",\"pid\":0"
+           << ",\"tid\":" << r.tid
+           << ",\"ts\":" << r.start_wall_us
+           << ",\"dur\":" << r.wall_us
+           << ",\"args\":{"
+           << "\"success\":" << (r.success ? "true" : "false")
+           << ",\"depth\":" << r.depth
+           << ",\"cpu_time_ms\":" << std::fixed << std::setprecision(3) << r.cpu_ms << std::defaultfloat
+           << ",\"peak_rss_delta_kb\":" << r.peak_rss_delta_kb;
+        for(const auto &c : r.counts_before){
+            of << ",\"" << json_escape(c.first) << "_before\":" << c.second;
+        }
+        for(const auto &c : r.counts_after){
+            of << ",\"" << json_escape(c.first) << "_after\":" << c.second;
+        }
+        of << "}}";
+    }
+    of << "\n]}\n";
+    of.flush();
+    if(!of){
+        YLOGWARN("Unable to write profile trace file '" << profile_filename.string() << "'");
+        return false;
+    }
+    YLOGINFO("Wrote profile trace with " << profile_records.size() << " records to '" << profile_filename.string() << "'");
+    return true;
+}
+
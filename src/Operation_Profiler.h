@@ -0,0 +1,53 @@
+//Operation_Profiler.h.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+// Per-operation telemetry. When enabled, the dispatcher records every operation invocation, including the children of
+// meta-operations like For, Repeat, While, ForEachDistinct, and Transaction. Wall time, CPU time, the change in peak
+// resident set size, and the number of objects in each Drover member before and after the operation are recorded.
+//
+// Records are written in the Chrome 'Trace Event Format' (JSON), which can be viewed with chrome://tracing or
+// Perfetto, or parsed directly.
+
+// Enable profiling. Records are written to the given file by Write_Operation_Profile().
+void Enable_Operation_Profiling(const std::filesystem::path &trace_filename);
+
+bool Operation_Profiling_Enabled();
+
+// Object counts, keyed by Drover member name.
+using drover_counts_t = std::map<std::string, int64_t>;
+
+// Records a single operation invocation. Create immediately before the operation runs, and call finish() afterward.
+// If finish() is never called (e.g., because the operation threw), the invocation is recorded as failed.
+// Does nothing if profiling is disabled.
+class Operation_Profile_Scope {
+    private:
+        bool active = false;
+        bool finished = false;
+        std::string name;
+        int64_t depth = 0;
+        int64_t start_wall_us = 0;
+        double start_cpu_ms = 0.0;
+        int64_t start_peak_rss_kb = 0;
+        drover_counts_t counts_before;
+
+        void record(bool success, const drover_counts_t &counts_after);
+
+    public:
+        Operation_Profile_Scope(const std::string &name, const drover_counts_t &counts_before);
+        ~Operation_Profile_Scope();
+
+        Operation_Profile_Scope(const Operation_Profile_Scope &) = delete;
+        Operation_Profile_Scope &operator=(const Operation_Profile_Scope &) = delete;
+
+        void finish(bool success, const drover_counts_t &counts_after);
+};
+
+// Write all records collected so far. Returns false if the trace could not be written.
+bool Write_Operation_Profile();
+
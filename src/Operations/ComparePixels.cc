@@ -45,6 +45,12 @@ OperationDoc OpArgDocComparePixels(){
         " image adjacency can be precomputed and the analysis will be faster. If not, image adjacency"
         " must be evaluated for every voxel."
     );
+    out.notes.emplace_back(
+        "If the reference image array forms a regular grid (i.e., regularly-spaced images with identical"
+        " geometry), a faster implementation is used that searches reference voxels in order of"
+        " increasing distance and stops as soon as the distance-to-agreement cannot be improved."
+        " Test images are processed in parallel."
+    );
     out.notes.emplace_back(
         "The distance-to-agreement comparison will tend to overestimate the distance, especially"
         " when the DTA value is low, because voxel size effects will dominate the estimation."
@@ -434,6 +440,8 @@ bool ComparePixels(Drover &DICOM_data,
         ud.gamma_terminate_when_max_exceeded = GammaTerminateAboveOne;
         //ud.gamma_terminated_early = std::nextafter(1.0, std::numeric_limits<double>::infinity());
 
+        ud.ref_grid_index = (*( RIAs.front() ))->get_voxel_grid_index();
+
         if(!(*iap_it)->imagecoll.Compute_Images( ComputeCompareImages, 
                                                  RIARL, cc_ROIs, &ud )){
             throw std::runtime_error("Unable to compare images.");
@@ -14,6 +14,7 @@
 #include <string>    
 #include <utility>            //Needed for std::pair.
 #include <vector>
+#include <filesystem>
 #include <cstdint>
 
 #include "YgorImages.h"
@@ -23,6 +24,7 @@
 #include "YgorStats.h"        //Needed for Stats:: namespace.
 #include "YgorString.h"       //Needed for GetFirstRegex(...)
 #include "YgorMathIOOFF.h"
+#include "YgorFilesDirs.h"
 
 #include "Explicator.h"       //Needed for Explicator class.
 
@@ -55,6 +57,9 @@ OperationDoc OpArgDocConvertImageToMeshes(){
         "This routine requires images to be regular (i.e., exactly abut nearest adjacent images without"
         " any overlap)."
     );
+    out.notes.emplace_back(
+        "Meshes written directly to file are not added to the Surface_Mesh stack, and do not carry any metadata."
+    );
 
     out.args.emplace_back();
     out.args.back() = IAWhitelistOpArgDoc();
@@ -131,6 +136,64 @@ OperationDoc OpArgDocConvertImageToMeshes(){
     out.args.back().expected = true;
     out.args.back().examples = { "unspecified", "body", "air", "bone", "invalid", "above_zero", "below_5.3" };
 
+
+    out.args.emplace_back();
+    out.args.back().name = "Streaming";
+    out.args.back().desc = "Controls whether the streaming implementation of marching cubes is used."
+                           " The streaming implementation processes a slab of adjacent images at a time, so memory"
+                           " use is proportional to the slab size rather than the number of images."
+                           " It is useful for large image volumes that produce very large meshes."
+                           " The resulting mesh is equivalent, but vertices and faces are ordered differently."
+                           " This option only applies to the pixel-based methods.";
+    out.args.back().default_val = "false";
+    out.args.back().expected = true;
+    out.args.back().examples = { "true", "false" };
+    out.args.back().samples = OpArgSamples::Exhaustive;
+
+
+    out.args.emplace_back();
+    out.args.back().name = "SlabImages";
+    out.args.back().desc = "The number of images processed together by the streaming implementation."
+                           " Memory use grows with this number, but so does the amount of work that can be"
+                           " performed in parallel."
+                           " This option is ignored unless the streaming implementation is used.";
+    out.args.back().default_val = "16";
+    out.args.back().expected = true;
+    out.args.back().examples = { "1", "4", "16", "64" };
+
+
+    out.args.emplace_back();
+    out.args.back().name = "Filename";
+    out.args.back().desc = "If non-empty, meshes are written directly to this file as they are generated rather than"
+                           " being appended to the Surface_Mesh stack. This implies the streaming implementation,"
+                           " and avoids holding the entire mesh in memory."
+                           " Files with a '.stl' extension are written in STL format; otherwise files are written in"
+                           " Stanford Polygon File ('PLY') format and a '.ply' extension is added if necessary."
+                           " Existing files will not be overwritten."
+                           " If multiple image arrays are selected, each will be written to a separate file;"
+                           " the name of each will be derived from the user-provided filename"
+                           " by appending a sequentially increasing counter between the file's stem name and extension."
+                           " This option only applies to the pixel-based methods.";
+    out.args.back().default_val = "";
+    out.args.back().expected = true;
+    out.args.back().examples = { "",
+                                 "surface_mesh.ply",
+                                 "/path/to/some/surface_mesh.stl" };
+    out.args.back().mimetype = "text/plain";
+
+
+    out.args.emplace_back();
+    out.args.back().name = "Variant";
+    out.args.back().desc = "Controls whether files are written in the binary or ASCII file format variants."
+                           " Binary files will generally be smaller, and therefore faster to write,"
+                           " but may be less portable."
+                           " This option is ignored unless a filename is provided.";
+    out.args.back().default_val = "binary";
+    out.args.back().expected = true;
+    out.args.back().examples = { "ascii",
+                                 "binary" };
+    out.args.back().samples = OpArgSamples::Exhaustive;
+
     return out;
 }
 
@@ -150,6 +213,10 @@ bool ConvertImageToMeshes(Drover &DICOM_data,
     const auto ChannelStr = OptArgs.getValueStr("Channel").value();
     const auto MethodStr = OptArgs.getValueStr("Method").value();
     const auto MeshLabel = OptArgs.getValueStr("MeshLabel").value();
+    const auto StreamingStr = OptArgs.getValueStr("Streaming").value();
+    const auto SlabImages = std::stol( OptArgs.getValueStr("SlabImages").value() );
+    auto FilenameStr = OptArgs.getValueStr("Filename").value();
+    const auto VariantStr = OptArgs.getValueStr("Variant").value();
 
     //-----------------------------------------------------------------------------------------------------------------
     const auto NormalizedMeshLabel = X(MeshLabel);
@@ -170,9 +237,44 @@ bool ConvertImageToMeshes(Drover &DICOM_data,
     const auto marching_regex = Compile_Regex("^ma?r?c?h?i?n?g?$");
     const auto geom_regex = Compile_Regex("^ge?o?m?e?t?r?[iy]?c?a?l?$");
 
+    const auto regex_true = Compile_Regex("^tr?u?e?$");
+    const auto regex_ascii = Compile_Regex("^as?c?i?i?$");
+    const auto regex_binary = Compile_Regex("^bi?n?a?r?y?$");
+
+    const bool write_to_file = !FilenameStr.empty();
+    const bool Streaming = write_to_file || std::regex_match(StreamingStr, regex_true);
+
+    bool as_binary = false;
+    if(false){
+    }else if(std::regex_match(VariantStr, regex_ascii)){
+        as_binary = false;
+    }else if(std::regex_match(VariantStr, regex_binary)){
+        as_binary = true;
+    }else{
+        throw std::invalid_argument("Variant not understood. Refusing to continue.");
+    }
+
+    if(SlabImages < 1){
+        throw std::invalid_argument("SlabImages must be positive. Refusing to continue.");
+    }
+
+    // Prepare filename and prototype in case multiple files need to be written.
+    const auto regex_stl = Compile_Regex("^[.][sS][tT][lL]$");
+    const bool as_STL = std::regex_match(std::filesystem::path(FilenameStr).extension().string(), regex_stl);
+    const std::string required_file_extension = as_STL ? ".stl" : ".ply";
+    const int64_t n_of_digit_pads = 6;
+    const auto suffixless_fullpath = std::filesystem::path(FilenameStr).replace_extension().string();
+    if(write_to_file){
+        FilenameStr = suffixless_fullpath + required_file_extension;
+    }
+
     //Iterate over each requested image_array. Each image is processed independently, so a thread pool is used.
     auto IAs_all = All_IAs( DICOM_data );
     auto IAs = Whitelist( IAs_all, ImageSelectionStr );
+    if( write_to_file
+    &&  std::regex_match(MethodStr, geom_regex) ){
+        throw std::invalid_argument("Meshes can only be written directly to file for pixel-based methods. Refusing to continue.");
+    }
     for(auto & iap_it : IAs){
         // The mesh will inheret image metadata.
         auto ia_metadata = (*iap_it)->imagecoll.get_common_metadata({});
@@ -300,14 +402,50 @@ bool ConvertImageToMeshes(Drover &DICOM_data,
             }
             // Note: meshing parameter MutateOpts are irrelevant since we supply our own mask.
             auto meshing_params = dcma_surface_meshes::Parameters();
-            auto output_mesh = dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes( 
-                                                            mask_imgs,
-                                                            inclusion_threshold, 
-                                                            below_is_interior,
-                                                            meshing_params );
+            meshing_params.SlabImages = SlabImages;
+
+            if(write_to_file){
+                auto FN = FilenameStr;
+                if( (1 < IAs.size())
+                ||  std::filesystem::exists(FN) ){
+                    FN = Get_Unique_Sequential_Filename(suffixless_fullpath + "_", n_of_digit_pads, required_file_extension);
+                }
+
+                std::ofstream FO(FN, std::ios::out | std::ios::binary);
+                if(!FO){
+                    throw std::runtime_error("Unable to open file for writing. Cannot continue.");
+                }
+                auto sink = as_STL ? dcma_surface_meshes::make_STL_mesh_sink(FO, as_binary)
+                                   : dcma_surface_meshes::make_PLY_mesh_sink(FO, as_binary);
+                dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes( mask_imgs,
+                                                                           inclusion_threshold,
+                                                                           below_is_interior,
+                                                                           *sink,
+                                                                           meshing_params );
+                FO.flush();
+                if(!FO){
+                    throw std::runtime_error("Unable to write surface mesh to file. Cannot continue.");
+                }
+                YLOGINFO("Surface mesh written to '" << FN << "'");
+                continue;
+            }
 
             DICOM_data.smesh_data.emplace_back( std::make_unique<Surface_Mesh>() );
-            DICOM_data.smesh_data.back()->meshes = output_mesh;
+            if(Streaming){
+                dcma_surface_meshes::fv_mesh_sink sink(DICOM_data.smesh_data.back()->meshes);
+                dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes( mask_imgs,
+                                                                           inclusion_threshold,
+                                                                           below_is_interior,
+                                                                           sink,
+                                                                           meshing_params );
+            }else{
+                auto output_mesh = dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes( 
+                                                                mask_imgs,
+                                                                inclusion_threshold, 
+                                                                below_is_interior,
+                                                                meshing_params );
+                DICOM_data.smesh_data.back()->meshes = output_mesh;
+            }
 
         // Geometrical methods.
         }else if( std::regex_match(MethodStr, geom_regex) ){
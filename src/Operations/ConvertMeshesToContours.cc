@@ -24,7 +24,6 @@
 #include "YgorLog.h"
 #include "YgorStats.h"        //Needed for Stats:: namespace.
 #include "YgorString.h"       //Needed for GetFirstRegex(...)
-#include "YgorMathIOOFF.h"
 
 #include "../Structs.h"
 #include "../Regex_Selectors.h"
@@ -32,13 +31,6 @@
 
 #include "ConvertMeshesToContours.h"
 
-#ifdef DCMA_USE_CGAL
-#else
-    #error "Attempted to compile without CGAL support, which is required."
-#endif
-
-#include "../Surface_Meshes.h"
-
 
 OperationDoc OpArgDocConvertMeshesToContours(){
     OperationDoc out;
@@ -51,7 +43,8 @@ OperationDoc OpArgDocConvertMeshesToContours(){
         "This operation constructs ROI contours by slicing the given meshes on a set of image planes.";
         
     out.notes.emplace_back(
-        "Surface meshes should represent polyhedra."
+        "Surface meshes should be closed and their faces should share vertices, otherwise the contours may be open."
+        " Meshes need not be manifold."
     );
     out.notes.emplace_back(
         "This routine does **not** require images to be regular, rectilinear, or even contiguous."
@@ -60,7 +53,8 @@ OperationDoc OpArgDocConvertMeshesToContours(){
         "Images and meshes are unaltered. Existing contours are ignored and unaltered."
     );
     out.notes.emplace_back(
-        "Contour orientation is (likely) not guaranteed to be consistent in this routine."
+        "If mesh faces are oriented outward, contours are oriented counter-clockwise when viewed along the image"
+        " plane normal, and holes are oriented clockwise."
     );
         
 
@@ -122,34 +116,18 @@ bool ConvertMeshesToContours(Drover &DICOM_data,
     int64_t completed = 0;
     int64_t N_new_contours = 0;
     for(auto & smp_it : SMs){
-        // Convert to a CGAL mesh.
-        std::stringstream ss;
-        if(!WriteFVSMeshToOFF( (*smp_it)->meshes, ss )){
-            throw std::runtime_error("Unable to write mesh in OFF format. Cannot continue.");
-        }
-
-        dcma_surface_meshes::Polyhedron surface_mesh;
-        if(!( ss >> surface_mesh )){
-            throw std::runtime_error("Mesh could not be treated as a polyhedron. (Is it manifold?)");
-        }
-        
-        // Use a method robust to non-manifold meshes.
-        //
-        // Note: If you need to use this, hide it behind a toggle parameter.
-        //       Proceeding with a manifold mesh can cause lots of issues later.
-        //dcma_surface_meshes::Polyhedron surface_mesh = dcma_surface_meshes::FVSMeshToPolyhedron((*smp_it)->meshes);
+        // The BVH is cached alongside the mesh, so it is only rebuilt when the mesh changes.
+        const auto bvh = (*smp_it)->get_face_bvh();
 
         for(auto & iap_it : IAs){
             for(const auto &animg : (*iap_it)->imagecoll.images){
                 // Slice the mesh along the image plane.
-                auto lcc = polyhedron_processing::Slice_Polyhedron( surface_mesh, 
-                                                                    {{ animg.image_plane() }} );
+                auto lcc = bvh->slice( animg.image_plane() );
 
                 N_new_contours += lcc.contours.size();
 
                 // Tag the contours with metadata.
                 for(auto &cop : lcc.contours){
-                    cop.closed = true;
                     cop.metadata["ROIName"] = ROILabel;
                     cop.metadata["NormalizedROIName"] = NormalizedROILabel;
                     cop.metadata["Description"] = "Sliced surface mesh";
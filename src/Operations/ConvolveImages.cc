@@ -1,6 +1,10 @@
 //ConvolveImages.cc - A part of DICOMautomaton 2019. Written by hal clark.
 
+#include <algorithm>
 #include <any>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <optional>
 #include <functional>
 #include <iterator>
@@ -12,6 +16,7 @@
 #include <numeric>        //Needed for std::inner_product().
 #include <string>    
 #include <cstdint>
+#include <vector>
 
 #include "YgorImages.h"
 #include "YgorString.h"       //Needed for GetFirstRegex(...)
@@ -19,6 +24,8 @@
 
 #include "../Structs.h"
 #include "../Regex_Selectors.h"
+#include "../Thread_Pool.h"
+#include "../FFT.h"
 #include "../YgorImages_Functors/ConvenienceRoutines.h"
 #include "../YgorImages_Functors/Grouping/Misc_Functors.h"
 #include "../YgorImages_Functors/Compute/Volumetric_Neighbourhood_Sampler.h"
@@ -53,6 +60,11 @@ OperationDoc OpArgDocConvolveImages(){
          " the average voxel intensity. However, for pattern matching the kernel need not"
          " be normalized (though it may make interpretting partial matches easier.)"
     );
+    out.notes.emplace_back(
+         "Large kernels are automatically applied in the frequency domain using fast Fourier transforms, which is"
+         " much faster than direct evaluation. Results are equivalent, apart from floating-point rounding."
+         " Direct evaluation is used when all channels are selected or when the images contain non-finite voxels."
+    );
     
     out.args.emplace_back();
     out.args.back() = IAWhitelistOpArgDoc();
@@ -122,6 +134,155 @@ OperationDoc OpArgDocConvolveImages(){
     return out;
 }
 
+// Apply the kernel in the frequency domain, producing the same result as ComputeVolumetricNeighbourhoodSampler with a
+// Selection neighbourhood spanning the kernel. Voxels whose neighbourhood extends beyond the image array are set to NaN.
+//
+// Returns false without modifying the images if they are not suited to this approach (e.g., they contain non-finite
+// voxels, or the kernel is small enough that direct evaluation is faster).
+static
+bool
+Convolve_Images_Via_FFT( planar_image_collection<float,double> &imagecoll,
+                         const std::vector<double> &kernel,
+                         const volume_dims_t &kernel_dims,
+                         const volume_dims_t &kernel_centre,
+                         bool pattern_match,
+                         int64_t channel,
+                         const vec3<double> &orientation_normal,
+                         std::list<std::reference_wrapper<contour_collection<double>>> ccsl,
+                         const std::string &description ){
+    if( (channel < 0) || imagecoll.images.empty() ) return false;
+
+    std::list<std::reference_wrapper<planar_image<float,double>>> selected_imgs;
+    for(auto &img : imagecoll.images){
+        selected_imgs.push_back( std::ref(img) );
+    }
+    if(!Images_Form_Rectilinear_Grid(selected_imgs)) return false;
+
+    planar_image_adjacency<float,double> img_adj( {}, { { std::ref(imagecoll) } }, orientation_normal );
+    if(img_adj.int_to_img.size() != imagecoll.images.size()) return false;
+
+    const int64_t rows = imagecoll.images.front().rows;
+    const int64_t cols = imagecoll.images.front().columns;
+    const volume_dims_t dims = { static_cast<int64_t>(img_adj.int_to_img.size()), rows, cols };
+    if(!Prefer_FFT_Correlation(dims, kernel_dims)) return false;
+
+    // Gather the voxels in adjacency order.
+    std::vector<double> vol;
+    vol.reserve(static_cast<size_t>(dims[0] * rows * cols));
+    int64_t expected_num = 0;
+    for(const auto &p : img_adj.int_to_img){
+        if(p.first != expected_num++) return false;
+        const auto &img = img_adj.index_to_image(p.first).get();
+        if( (img.rows != rows)
+        ||  (img.columns != cols)
+        ||  (img.channels <= channel) ) return false;
+        for(int64_t r = 0; r < rows; ++r){
+            for(int64_t c = 0; c < cols; ++c){
+                const auto val = img.value(r, c, channel);
+                if(!std::isfinite(val)) return false;
+                vol.emplace_back(static_cast<double>(val));
+            }
+        }
+    }
+
+    YLOGINFO("Applying " << kernel_dims[0] << "x" << kernel_dims[1] << "x" << kernel_dims[2]
+             << " kernel in the frequency domain");
+    auto res = Correlate_Volume_FFT(vol, dims, kernel, kernel_dims, kernel_centre);
+
+    if(pattern_match){
+        // Expand the Euclidean distance as sum(s^2) - 2 sum(s k) + sum(k^2). The sum(s^2) term is the box sum of
+        // squared voxel values over the neighbourhood, which is evaluated using a summed-volume table.
+        const int64_t R1 = rows + 1;
+        const int64_t C1 = cols + 1;
+        std::vector<double> svt(static_cast<size_t>((dims[0] + 1) * R1 * C1), 0.0);
+        const auto svt_at = [&](int64_t z, int64_t r, int64_t c) -> double & {
+            return svt[(z * R1 + r) * C1 + c];
+        };
+        for(int64_t z = 0; z < dims[0]; ++z){
+            for(int64_t r = 0; r < rows; ++r){
+                for(int64_t c = 0; c < cols; ++c){
+                    const auto v = vol[(z * rows + r) * cols + c];
+                    svt_at(z+1, r+1, c+1) = v * v
+                                          + svt_at(z, r+1, c+1) + svt_at(z+1, r, c+1) + svt_at(z+1, r+1, c)
+                                          - svt_at(z, r, c+1) - svt_at(z, r+1, c) - svt_at(z+1, r, c)
+                                          + svt_at(z, r, c);
+                }
+            }
+        }
+
+        double kk = 0.0;
+        for(const auto &k : kernel) kk += k * k;
+
+        for(int64_t z = 0; z < dims[0]; ++z){
+            const auto z0 = std::clamp<int64_t>(z - kernel_centre[0], 0, dims[0]);
+            const auto z1 = std::clamp<int64_t>(z - kernel_centre[0] + kernel_dims[0], 0, dims[0]);
+            for(int64_t r = 0; r < rows; ++r){
+                const auto r0 = std::clamp<int64_t>(r - kernel_centre[1], 0, rows);
+                const auto r1 = std::clamp<int64_t>(r - kernel_centre[1] + kernel_dims[1], 0, rows);
+                for(int64_t c = 0; c < cols; ++c){
+                    const auto c0 = std::clamp<int64_t>(c - kernel_centre[2], 0, cols);
+                    const auto c1 = std::clamp<int64_t>(c - kernel_centre[2] + kernel_dims[2], 0, cols);
+                    const auto ss = svt_at(z1, r1, c1)
+                                  - svt_at(z0, r1, c1) - svt_at(z1, r0, c1) - svt_at(z1, r1, c0)
+                                  + svt_at(z0, r0, c1) + svt_at(z0, r1, c0) + svt_at(z1, r0, c0)
+                                  - svt_at(z0, r0, c0);
+                    auto &v = res[(z * rows + r) * cols + c];
+                    v = std::sqrt( std::max(0.0, ss - 2.0 * v + kk) );
+                }
+            }
+        }
+    }
+
+    // Voxels with incomplete neighbourhoods are NaN, matching direct evaluation.
+    const auto is_complete = [&](int64_t p, size_t d){
+        return (kernel_centre[d] <= p) && ((p + kernel_dims[d] - 1 - kernel_centre[d]) < dims[d]);
+    };
+
+    Mutate_Voxels_Opts mv_opts;
+    mv_opts.editstyle      = Mutate_Voxels_Opts::EditStyle::InPlace;
+    mv_opts.inclusivity    = Mutate_Voxels_Opts::Inclusivity::Centre;
+    mv_opts.contouroverlap = Mutate_Voxels_Opts::ContourOverlap::Ignore;
+    mv_opts.aggregate      = Mutate_Voxels_Opts::Aggregate::First;
+    mv_opts.adjacency      = Mutate_Voxels_Opts::Adjacency::SingleVoxel;
+    mv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
+
+    work_queue<std::function<void(void)>> wq;
+    for(auto &img : imagecoll.images){
+        std::reference_wrapper< planar_image<float, double>> img_refw( std::ref(img) );
+        const auto z = img_adj.image_to_index(img_refw);
+        wq.submit_task([&,img_refw,z]() -> void {
+            const bool z_complete = is_complete(z, 0);
+            auto f_bounded = [&](int64_t E_row, int64_t E_col, int64_t E_chnl,
+                                 std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
+                                 std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
+                                 float &voxel_val) {
+                if(E_chnl != channel) return;
+                if( !z_complete
+                ||  !is_complete(E_row, 1)
+                ||  !is_complete(E_col, 2) ){
+                    voxel_val = std::numeric_limits<float>::quiet_NaN();
+                }else{
+                    voxel_val = static_cast<float>( res[(z * rows + E_row) * cols + E_col] );
+                }
+                return;
+            };
+
+            Mutate_Voxels<float,double>( img_refw,
+                                         { img_refw },
+                                         ccsl,
+                                         mv_opts,
+                                         f_bounded );
+
+            if(!description.empty()){
+                UpdateImageDescription( img_refw, description );
+            }
+            UpdateImageWindowCentreWidth( img_refw );
+        });
+    } // Wait for all tasks to complete.
+
+    return true;
+}
+
 bool ConvolveImages(Drover &DICOM_data,
                       const OperationArgPkg& OptArgs,
                       std::map<std::string, std::string>& /*InvocationMetadata*/,
@@ -211,6 +372,10 @@ bool ConvolveImages(Drover &DICOM_data,
             const auto d_c = k_columns / 2;
             const auto d_i = k_imgs / 2;
 
+            // The same kernel with (image, row, column) ordering, for frequency-domain evaluation.
+            const volume_dims_t k_dims = { k_imgs, k_rows, k_columns };
+            std::vector<double> k_volume(static_cast<size_t>(k_imgs * k_rows * k_columns), 0.0);
+
             for(int64_t r = 0; r < k_rows; ++r){
                 for(int64_t c = 0; c < k_columns; ++c){
                     for(int64_t i = 0; i < k_imgs; ++i){
@@ -223,6 +388,7 @@ bool ConvolveImages(Drover &DICOM_data,
                         const auto l_img_refw = img_adj.index_to_image(i_num);
                         const auto val = l_img_refw.get().value(r, c, Channel);
                         k_values.emplace_back( static_cast<float>(val) );
+                        k_volume[(i * k_rows + r) * k_columns + c] = static_cast<double>(val);
                     }
                 }
             }
@@ -269,6 +435,24 @@ bool ConvolveImages(Drover &DICOM_data,
                 throw std::logic_error("Requested operation is not understood. Cannot continue.");
             }
 
+            // Large kernels are more efficiently applied in the frequency domain. Convolution is correlation with the
+            // spatially inverted kernel.
+            {
+                volume_dims_t k_centre = { d_i, d_r, d_c };
+                auto l_k_volume = k_volume;
+                if(op_is_conv){
+                    std::reverse( std::begin(l_k_volume), std::end(l_k_volume) );
+                    for(size_t d = 0; d < 3; ++d) k_centre[d] = k_dims[d] - 1 - k_centre[d];
+                }
+                const bool finite_kernel = std::all_of( std::begin(l_k_volume), std::end(l_k_volume),
+                                                        [](double v){ return std::isfinite(v); } );
+                if( finite_kernel
+                &&  Convolve_Images_Via_FFT( (*iap_it)->imagecoll, l_k_volume, k_dims, k_centre, op_is_mtch,
+                                             Channel, orientation_normal, cc_ROIs, ud.description ) ){
+                    continue;
+                }
+            }
+
             if(!ud.voxel_triplets.empty()){
                 YLOGINFO("Neighbourhood comprises " << ud.voxel_triplets.size() << " neighbours");
             }
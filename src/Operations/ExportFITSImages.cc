@@ -52,6 +52,7 @@ OperationDoc OpArgDocExportFITSImages(){
     out.args.emplace_back();
     out.args.back() = IAWhitelistOpArgDoc();
     out.args.back().name = "ImageSelection";
+    out.args.back().flow = OpArgFlow::Ingress;
     out.args.back().default_val = "last";
    
 
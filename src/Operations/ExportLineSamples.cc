@@ -46,6 +46,7 @@ OperationDoc OpArgDocExportLineSamples(){
     out.args.emplace_back();
     out.args.back() = LSWhitelistOpArgDoc();
     out.args.back().name = "LineSelection";
+    out.args.back().flow = OpArgFlow::Ingress;
     out.args.back().default_val = "last";
    
 
@@ -54,6 +54,7 @@ OperationDoc OpArgDocExportWarps(){
     out.args.emplace_back();
     out.args.back() = T3WhitelistOpArgDoc();
     out.args.back().name = "TransformSelection";
+    out.args.back().flow = OpArgFlow::Ingress;
     out.args.back().default_val = "last";
     out.args.back().desc = "The transformation that will be exported. "_s
                          + out.args.back().desc;
@@ -206,6 +206,8 @@ bool For(Drover &DICOM_data,
         orig_val = get_as<std::string>(InvocationMetadata, KeyOpt.value());
     }
 
+    const auto plan = Compile_Operations(OptArgs.getChildren());
+
     bool ret = true;
     if(false){
     }else if(use_discrete){
@@ -224,7 +226,7 @@ bool For(Drover &DICOM_data,
             YLOGDEBUG("Looping with counter = '" << t << "'");
             if(KeyOpt) InvocationMetadata[KeyOpt.value()] = t;
 
-            ret = Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, OptArgs.getChildren());
+            ret = Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan);
             if(!ret) break;
         }
 
@@ -243,7 +245,7 @@ bool For(Drover &DICOM_data,
             YLOGDEBUG("Looping with counter = " << i);
             if(KeyOpt) InvocationMetadata[KeyOpt.value()] = to_string_max_precision(i);
 
-            ret = Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, OptArgs.getChildren());
+            ret = Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan);
             if(!ret) break;
         }
 
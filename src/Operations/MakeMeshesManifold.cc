@@ -24,20 +24,12 @@
 #include "YgorLog.h"
 #include "YgorStats.h"        //Needed for Stats:: namespace.
 #include "YgorString.h"       //Needed for GetFirstRegex(...)
-#include "YgorMathIOOFF.h"
 
 #include "../Structs.h"
 #include "../Regex_Selectors.h"
 #include "../Thread_Pool.h"
 #include "MakeMeshesManifold.h"
 
-#ifdef DCMA_USE_CGAL
-#else
-    #error "Attempted to compile without CGAL support, which is required."
-#endif
-
-#include "../Surface_Meshes.h"
-
 
 OperationDoc OpArgDocMakeMeshesManifold(){
     OperationDoc out;
@@ -53,10 +45,15 @@ OperationDoc OpArgDocMakeMeshesManifold(){
         "This routine will invalidate any imbued special attributes from the original mesh."
     );
     out.notes.emplace_back(
-        "It may not be possible to accomplish manifold-ness."
+        "Faces are triangulated. Edges shared by more than two faces are separated, and vertices joining separate"
+        " fans of faces are duplicated."
+    );
+    out.notes.emplace_back(
+        "Face winding is made consistent where possible, and closed components are oriented outward."
     );
     out.notes.emplace_back(
-        "Mesh features (vertices, faces, edges) may disappear in this routine."
+        "Mesh features (vertices, faces, edges) may disappear in this routine. For example, degenerate faces and"
+        " unused vertices are removed."
     );
         
 
@@ -98,40 +95,20 @@ bool MakeMeshesManifold(Drover &DICOM_data,
     for(auto & smp_it : SMs){
 
         DICOM_data.smesh_data.emplace_back( std::make_shared<Surface_Mesh>() );
-
-        // Attempt to convert directly to a polyhedron.
-        std::stringstream ss;
-        if(!WriteFVSMeshToOFF( (*smp_it)->meshes, ss )){
-            throw std::runtime_error("Unable to write mesh in OFF format. Cannot continue.");
-        }
-
-
-
-        dcma_surface_meshes::Polyhedron surface_mesh;
-        if(ss >> surface_mesh){
-            // Mesh was manifold, so no conversion is necessary. Store the mesh.
-            *(DICOM_data.smesh_data.back()) = *(*smp_it);
-
-        }else{
-            // Mesh is likely non-manifold, but some other issue could have been encountered.
-            // Attempt a conversion using a method robust to non-manifold meshes.
-            surface_mesh = dcma_surface_meshes::FVSMeshToPolyhedron((*smp_it)->meshes);
-
-            // Success. Convert back and store the mesh.
-            std::stringstream ss_o;
-            if(!( ss_o << surface_mesh )){
-                throw std::runtime_error("Remeshed mesh could still not be treated as a polyhedron. Cannot continue.");
-            }
-
-            if(!ReadFVSMeshFromOFF( DICOM_data.smesh_data.back()->meshes, ss_o )){
-                throw std::runtime_error("Unable to read mesh in OFF format. Cannot continue.");
-            }
-            DICOM_data.smesh_data.back()->meshes.metadata = (*smp_it)->meshes.metadata;
-
-        }
+        auto &manifold = DICOM_data.smesh_data.back();
+
+        // Constructing a half-edge mesh performs the necessary repairs.
+        auto hem = (*smp_it)->take_half_edge_mesh();
+        hem.orient_outward();
+        manifold->meshes.metadata = (*smp_it)->meshes.metadata;
+        manifold->set_from_half_edge_mesh(std::move(hem));
+        YLOGINFO("Mesh with " << (*smp_it)->meshes.vertices.size() << " vertices and "
+              << (*smp_it)->meshes.faces.size() << " faces became "
+              << manifold->meshes.vertices.size() << " vertices and "
+              << manifold->meshes.faces.size() << " faces");
 
         // Updated the metadata.
-        DICOM_data.smesh_data.back()->meshes.metadata["MeshLabel"] = MeshLabel;
+        manifold->meshes.metadata["MeshLabel"] = MeshLabel;
         
         ++completed;
         YLOGINFO("Completed " << completed << " of " << sm_count
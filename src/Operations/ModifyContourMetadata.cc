@@ -33,16 +33,19 @@ OperationDoc OpArgDocModifyContourMetadata(){
     out.args.emplace_back();
     out.args.back() = NCWhitelistOpArgDoc();
     out.args.back().name = "NormalizedROILabelRegex";
+    out.args.back().flow = OpArgFlow::IngressEgress;
     out.args.back().default_val = ".*";
 
     out.args.emplace_back();
     out.args.back() = RCWhitelistOpArgDoc();
     out.args.back().name = "ROILabelRegex";
+    out.args.back().flow = OpArgFlow::IngressEgress;
     out.args.back().default_val = ".*";
 
     out.args.emplace_back();
     out.args.back() = CCWhitelistOpArgDoc();
     out.args.back().name = "ROISelection";
+    out.args.back().flow = OpArgFlow::IngressEgress;
     out.args.back().default_val = "all";
 
     out.args.emplace_back();
@@ -33,6 +33,7 @@ OperationDoc OpArgDocModifyPointMetadata(){
     out.args.emplace_back();
     out.args.back() = PCWhitelistOpArgDoc();
     out.args.back().name = "PointSelection";
+    out.args.back().flow = OpArgFlow::IngressEgress;
     out.args.back().default_val = "last";
 
     out.args.emplace_back();
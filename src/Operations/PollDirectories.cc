@@ -161,6 +161,7 @@ bool PollDirectories(Drover &DICOM_data,
     if(OptArgs.getChildren().empty()){
         YLOGWARN("No children operations specified; files will be loaded but not processed");
     }
+    const auto children_plan = Compile_Operations(OptArgs.getChildren());
     if(PollInterval < 0){
         throw std::invalid_argument("Polling interval is invalid. Cannot continue.");
     }
@@ -456,9 +457,8 @@ bool PollDirectories(Drover &DICOM_data,
             // Merge the loaded files into the current Drover class.
             DICOM_data.Consume(DD_work);
 
-            auto children = OptArgs.getChildren();
-            if(!children.empty()){
-                const auto res = Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, children);
+            if(!children_plan.empty()){
+                const auto res = Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, children_plan);
                 if(!res){
                     return false;
                 }
@@ -7,7 +7,9 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <sstream>
 #include <stdexcept>
 #include <string>    
 #include <vector>
@@ -46,6 +48,46 @@ using namespace ::apache::thrift::transport;
 using namespace ::apache::thrift::server;
 
 class ReceiverHandler : virtual public ::dcma::rpc::ReceiverIf {
+  private:
+    // Compiled scripts, keyed by script text, so repeated requests skip parsing and operation name resolution.
+    std::mutex plan_cache_mutex;
+    std::map<std::string, std::shared_ptr<const operation_plan_t>> plan_cache;
+    const size_t plan_cache_max_size = 64;
+
+    std::shared_ptr<const operation_plan_t>
+    get_plan(const std::string &script){
+        {
+            std::lock_guard<std::mutex> lock(this->plan_cache_mutex);
+            const auto it = this->plan_cache.find(script);
+            if(it != std::end(this->plan_cache)) return it->second;
+        }
+
+        std::list<script_feedback_t> feedback;
+        std::stringstream ss( script );
+        std::list<OperationArgPkg> op_list;
+        if(!Load_DCMA_Script( ss, feedback, op_list )){
+            YLOGWARN("Parsing script failed");
+            return nullptr;
+        }
+
+        std::shared_ptr<const operation_plan_t> plan;
+        std::list<std::string> diagnostics;
+        try{
+            plan = std::make_shared<const operation_plan_t>( Compile_Operations(op_list, &diagnostics) );
+        }catch(const std::exception &e){
+            YLOGWARN("Compiling script failed: '" << e.what() << "'");
+            return nullptr;
+        }
+        for(const auto &d : diagnostics){
+            YLOGWARN(d);
+        }
+
+        std::lock_guard<std::mutex> lock(this->plan_cache_mutex);
+        if(this->plan_cache_max_size <= this->plan_cache.size()) this->plan_cache.clear();
+        this->plan_cache[script] = plan;
+        return plan;
+    }
+
   public:
     ReceiverHandler() {
         YLOGINFO("RPC initialization complete, awaiting procedure calls");
@@ -124,18 +166,13 @@ class ReceiverHandler : virtual public ::dcma::rpc::ReceiverIf {
 
         // Execute the script.
         YLOGINFO("Executing script");
-        std::list<script_feedback_t> feedback;
-        std::stringstream ss( l_script );
-        std::list<OperationArgPkg> op_list;
-        bool l_ret = Load_DCMA_Script( ss, feedback, op_list );
-        if(!l_ret){
-            YLOGWARN("Parsing script failed");
-
-        }else{
-            l_ret = Operation_Dispatcher(l_DICOM_data,
-                                         l_InvocationMetadata,
-                                         l_FilenameLex,
-                                         op_list);
+        const auto plan = this->get_plan(l_script);
+        bool l_ret = static_cast<bool>(plan);
+        if(l_ret){
+            l_ret = Execute_Operations(l_DICOM_data,
+                                       l_InvocationMetadata,
+                                       l_FilenameLex,
+                                       *plan);
         }
         if(!l_ret){
             YLOGWARN("Script execution failed");
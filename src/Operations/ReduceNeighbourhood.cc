@@ -17,6 +17,7 @@
 #include "../YgorImages_Functors/ConvenienceRoutines.h"
 #include "../YgorImages_Functors/Grouping/Misc_Functors.h"
 #include "../YgorImages_Functors/Compute/Volumetric_Neighbourhood_Sampler.h"
+#include "../YgorImages_Functors/Compute/Volumetric_Rank_Filter.h"
 #include "ReduceNeighbourhood.h"
 #include "YgorImages.h"
 #include "YgorString.h"       //Needed for GetFirstRegex(...)
@@ -40,6 +41,12 @@ OperationDoc OpArgDocReduceNeighbourhood(){
     out.notes.emplace_back(
         "The provided image collection must be rectilinear."
     );
+    out.notes.emplace_back(
+        "Order-statistic reductions (e.g., 'min', 'median', 'max', 'percentile01', and the logical reducers) on"
+        " regular grids are evaluated incrementally as the neighbourhood slides along each row, which permits"
+        " large neighbourhoods. In this case NaN voxels, and voxels beyond the edges of the image array, are"
+        " omitted from the neighbourhood."
+    );
     out.notes.emplace_back(
         "This operation can be used to compute core 3D morphology operations (erosion and dilation)"
         " as well as composite operations like opening (i.e., erosion followed by dilation),"
@@ -286,6 +293,10 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
     auto IAs = Whitelist( IAs_all, ImageSelectionStr );
     for(auto & iap_it : IAs){
 
+        // Order-statistic reductions, which can be evaluated incrementally.
+        using rank_red_t = ComputeVolumetricRankFilterUserData::Reduction;
+        std::optional<rank_red_t> rank_reduction;
+
         ComputeVolumetricNeighbourhoodSamplerUserData ud;
         ud.channel = Channel;
         ud.maximum_distance = MaxDistance;
@@ -540,10 +551,12 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
             ud.f_reduce = [](float, std::vector<float> &shtl, vec3<double>) -> float {
                               return Stats::Min(shtl);
                           };
+            rank_reduction = rank_red_t::Min;
         }else if( std::regex_match(ReductionStr, regex_median) ){
             ud.f_reduce = [](float, std::vector<float> &shtl, vec3<double>) -> float {
                               return Stats::Median(shtl);
                           };
+            rank_reduction = rank_red_t::Median;
         }else if( std::regex_match(ReductionStr, regex_mean) ){
             ud.f_reduce = [](float, std::vector<float> &shtl, vec3<double>) -> float {
                               return Stats::Mean(shtl);
@@ -553,6 +566,7 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
             ud.f_reduce = [](float, std::vector<float> &shtl, vec3<double>) -> float {
                               return Stats::Max(shtl);
                           };
+            rank_reduction = rank_red_t::Max;
 
         }else if( std::regex_match(ReductionStr, regex_geomean) ){
             const auto nan = std::numeric_limits<double>::quiet_NaN();
@@ -611,6 +625,7 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
                               } 
                               return f;
                           };
+            rank_reduction = rank_red_t::Percentile01;
 
         }else if( std::regex_match(ReductionStr, regex_is_min_nan) ){
             const auto machine_eps = std::sqrt( std::numeric_limits<float>::epsilon() );
@@ -619,6 +634,7 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
                               const auto diff = std::abs(v - min);
                               return (diff < machine_eps) ? std::numeric_limits<float>::quiet_NaN() : v;
                           };
+            rank_reduction = rank_red_t::IsMinNaN;
         }else if( std::regex_match(ReductionStr, regex_is_max_nan) ){
             const auto machine_eps = std::sqrt( std::numeric_limits<float>::epsilon() );
             ud.f_reduce = [=](float v, std::vector<float> &shtl, vec3<double>) -> float {
@@ -626,6 +642,7 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
                               const auto diff = std::abs(v - max);
                               return (diff < machine_eps) ? std::numeric_limits<float>::quiet_NaN() : v;
                           };
+            rank_reduction = rank_red_t::IsMaxNaN;
 
         }else if( std::regex_match(ReductionStr, regex_is_min) ){
             const auto machine_eps = std::sqrt( std::numeric_limits<float>::epsilon() );
@@ -634,6 +651,7 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
                               const auto diff = std::abs(v - min);
                               return (diff < machine_eps) ? 1.0f : 0.0f;
                           };
+            rank_reduction = rank_red_t::IsMin;
         }else if( std::regex_match(ReductionStr, regex_is_max) ){
             const auto machine_eps = std::sqrt( std::numeric_limits<float>::epsilon() );
             ud.f_reduce = [=](float v, std::vector<float> &shtl, vec3<double>) -> float {
@@ -641,6 +659,7 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
                               const auto diff = std::abs(v - max);
                               return (diff < machine_eps) ? 1.0f : 0.0f;
                           };
+            rank_reduction = rank_red_t::IsMax;
 
         }else{
             throw std::invalid_argument("Reduction argument '"_s + ReductionStr + "' is not valid");
@@ -650,6 +669,33 @@ bool ReduceNeighbourhood(Drover &DICOM_data,
             YLOGINFO("Neighbourhood comprises " << ud.voxel_triplets.size() << " neighbours");
         }
 
+        // Regular-grid fast paths share the image array's cached voxel grid index.
+        const auto grid_index = (*iap_it)->get_voxel_grid_index();
+        ud.grid_index = grid_index;
+
+        if( rank_reduction
+        &&  Volumetric_Rank_Filter_Supported((*iap_it)->imagecoll, grid_index) ){
+            using nbh_t = ComputeVolumetricNeighbourhoodSamplerUserData::Neighbourhood;
+            using rank_nbh_t = ComputeVolumetricRankFilterUserData::Neighbourhood;
+
+            ComputeVolumetricRankFilterUserData rud;
+            rud.neighbourhood = (ud.neighbourhood == nbh_t::Spherical) ? rank_nbh_t::Spherical
+                              : (ud.neighbourhood == nbh_t::Cubic)     ? rank_nbh_t::Cubic
+                                                                       : rank_nbh_t::Selection;
+            rud.maximum_distance = ud.maximum_distance;
+            rud.voxel_triplets = ud.voxel_triplets;
+            rud.reduction = rank_reduction.value();
+            rud.channel = ud.channel;
+            rud.description = ud.description;
+            rud.grid_index = grid_index;
+
+            if(!(*iap_it)->imagecoll.Compute_Images( ComputeVolumetricRankFilter,
+                                                     {}, cc_ROIs, &rud )){
+                throw std::runtime_error("Unable to reduce voxel neighbourhood.");
+            }
+            continue;
+        }
+
         if(!(*iap_it)->imagecoll.Compute_Images( ComputeVolumetricNeighbourhoodSampler, 
                                                  {}, cc_ROIs, &ud )){
             throw std::runtime_error("Unable to reduce voxel neighbourhood.");
@@ -116,6 +116,36 @@ OperationDoc OpArgDocRegisterImagesDemons(){
     out.args.back().expected = true;
     out.args.back().examples = { "0.0001", "0.001", "0.01" };
 
+    out.args.emplace_back();
+    out.args.back().name = "PyramidLevels";
+    out.args.back().desc = "The number of levels in the coarse-to-fine (multi-resolution) image pyramid."
+                           " Each coarser level is smoothed and downsampled by a factor of two along axes that are"
+                           " large enough. Registration begins at the coarsest level, and the deformation field is"
+                           " upsampled to initialize each finer level. Coarse levels are inexpensive and help capture"
+                           " large deformations, so fewer full-resolution iterations are typically needed."
+                           " A value of 1 disables the pyramid.";
+    out.args.back().default_val = "1";
+    out.args.back().expected = true;
+    out.args.back().examples = { "1", "2", "3", "4" };
+
+    out.args.emplace_back();
+    out.args.back().name = "LevelMaxIterations";
+    out.args.back().desc = "A comma-separated list of the maximum number of iterations to perform at each pyramid"
+                           " level, ordered from the coarsest level to the finest (full resolution) level."
+                           " Levels without an entry use MaxIterations.";
+    out.args.back().default_val = "";
+    out.args.back().expected = false;
+    out.args.back().examples = { "100,50,25", "200,100" };
+
+    out.args.emplace_back();
+    out.args.back().name = "LevelConvergenceThresholds";
+    out.args.back().desc = "A comma-separated list of convergence thresholds for each pyramid level, ordered from"
+                           " the coarsest level to the finest (full resolution) level."
+                           " Levels without an entry use ConvergenceThreshold.";
+    out.args.back().default_val = "";
+    out.args.back().expected = false;
+    out.args.back().examples = { "0.01,0.001,0.0001", "0.01,0.001" };
+
     out.args.emplace_back();
     out.args.back().name = "DeformationFieldSmoothingSigma";
     out.args.back().desc = "The standard deviation (in DICOM units, mm) of the Gaussian kernel used to smooth"
@@ -240,6 +270,9 @@ bool RegisterImagesDemons(Drover &DICOM_data,
     const auto FixedImageSelectionStr = OptArgs.getValueStr("FixedImageSelection").value();
     const auto MaxIterations = std::stol(OptArgs.getValueStr("MaxIterations").value());
     const auto ConvergenceThreshold = std::stod(OptArgs.getValueStr("ConvergenceThreshold").value());
+    const auto PyramidLevels = std::stol(OptArgs.getValueStr("PyramidLevels").value());
+    const auto LevelMaxIterationsOpt = OptArgs.getValueStr("LevelMaxIterations");
+    const auto LevelConvergenceThresholdsOpt = OptArgs.getValueStr("LevelConvergenceThresholds");
     const auto DeformationFieldSmoothingSigma = std::stod(OptArgs.getValueStr("DeformationFieldSmoothingSigma").value());
     const auto UpdateFieldSmoothingSigma = std::stod(OptArgs.getValueStr("UpdateFieldSmoothingSigma").value());
     const auto UseDiffeomorphicStr = OptArgs.getValueStr("UseDiffeomorphic").value();
@@ -322,6 +355,35 @@ bool RegisterImagesDemons(Drover &DICOM_data,
     AlignViaDemonsParams params;
     params.max_iterations = MaxIterations;
     params.convergence_threshold = ConvergenceThreshold;
+    params.pyramid_levels = PyramidLevels;
+
+    // Per-level entries are matched to levels by position, so empty entries (e.g., from doubled or trailing commas)
+    // are rejected rather than skipped.
+    const auto parse_level_list = [](const std::string &name, const std::string &list, const auto &parse){
+        using value_t = decltype(parse(std::string()));
+        std::vector<value_t> out;
+        if(Canonicalize_String2(list, CANONICALIZE::TRIM_ENDS).empty()) return out;
+        for(auto t : SplitStringToVector(list, ',', 'd')){
+            t = Canonicalize_String2(t, CANONICALIZE::TRIM_ENDS);
+            std::optional<value_t> v;
+            try{
+                if(!t.empty()) v = parse(t);
+            }catch(const std::exception &){ }
+            if(!v){
+                throw std::invalid_argument(name + ": unable to parse entry '" + t + "' in '" + list + "'");
+            }
+            out.push_back(v.value());
+        }
+        return out;
+    };
+    if(LevelMaxIterationsOpt){
+        params.level_max_iterations = parse_level_list("LevelMaxIterations", LevelMaxIterationsOpt.value(),
+                                                       [](const std::string &t){ return static_cast<int64_t>(std::stoll(t)); });
+    }
+    if(LevelConvergenceThresholdsOpt){
+        params.level_convergence_thresholds = parse_level_list("LevelConvergenceThresholds", LevelConvergenceThresholdsOpt.value(),
+                                                               [](const std::string &t){ return std::stod(t); });
+    }
     params.deformation_field_smoothing_sigma = DeformationFieldSmoothingSigma;
     params.update_field_smoothing_sigma = UpdateFieldSmoothingSigma;
     params.use_diffeomorphic = UseDiffeomorphic;
@@ -355,6 +417,7 @@ bool RegisterImagesDemons(Drover &DICOM_data,
     transform->metadata["UseDiffeomorphic"] = UseDiffeomorphic ? "true" : "false";
     transform->metadata["UseHistogramMatching"] = UseHistogramMatching ? "true" : "false";
     transform->metadata["MaxIterations"] = std::to_string(MaxIterations);
+    transform->metadata["PyramidLevels"] = std::to_string(PyramidLevels);
     transform->metadata["DeformationFieldSmoothingSigma"] = std::to_string(DeformationFieldSmoothingSigma);
 
     // Add to the Drover.
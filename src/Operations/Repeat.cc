@@ -84,8 +84,9 @@ bool Repeat(Drover &DICOM_data,
 
     YLOGINFO("Repeating " << OptArgs.getChildren().size() << " immediate children operations " << N << " times");
 
+    const auto plan = Compile_Operations(OptArgs.getChildren());
     for(int64_t i = 0; i < N; ++i){
-        if(!Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, OptArgs.getChildren())){
+        if(!Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan)){
             throw std::runtime_error("Child operation failed");
         }
     }
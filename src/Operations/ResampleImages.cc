@@ -199,6 +199,7 @@ bool ResampleImages(Drover &DICOM_data,
     ud.inc_upper_threshold = ImgUpperThreshold;
     ud.inc_nan = IncludeNaN;
     ud.inaccessible_val = InaccessibleValue;
+    ud.ref_grid_indices.push_back( (*( IAs.front() ))->get_voxel_grid_index() );
 
     ud.f_reduce = []( std::vector<float> &vals, 
                       vec3<double>                ) -> float {
@@ -18,6 +18,7 @@
 
 #include "../Structs.h"
 #include "../Regex_Selectors.h"
+#include "../Voxel_Kernels.h"
 #include "../YgorImages_Functors/ConvenienceRoutines.h"
 #include "../YgorImages_Functors/Grouping/Misc_Functors.h"
 #include "../YgorImages_Functors/Processing/Partitioned_Image_Voxel_Visitor_Mutator.h"
@@ -176,13 +177,9 @@ bool ScalePixels(Drover &DICOM_data,
             throw std::invalid_argument("Inclusivity argument '"_s + InclusivityStr + "' is not valid");
         }
 
-        ud.f_bounded = [&](int64_t, int64_t, int64_t chan,
-                           std::reference_wrapper<planar_image<float,double>>,
-                           std::reference_wrapper<planar_image<float,double>>,
-                           float &val) {
-            if( (Channel < 0) || (Channel == chan) ){
-                val *= ScaleFactor;
-            }
+        ud.kernel_channel = Channel;
+        ud.k_bounded = [&](float *x, int64_t n, int64_t stride) {
+            voxel_kernels::Scale(x, n, stride, ScaleFactor);
             return;
         };
 
@@ -1,6 +1,7 @@
 //SimplifySurfaceMeshes.cc - A part of DICOMautomaton 2022, 2026. Written by hal clark.
 
 #include <algorithm>
+#include <cmath>
 #include <optional>
 #include <fstream>
 #include <iterator>
@@ -56,8 +57,9 @@ OperationDoc OpArgDocSimplifySurfaceMeshes(){
     out.args.emplace_back();
     out.args.back().name = "Method";
     out.args.back().desc = "Controls which simplification algorithm is used."
-                           " Currently supported are 'flat'"
-                           " and 'remesh'"
+                           " Currently supported are 'flat',"
+                           " 'remesh',"
+                           " and 'quadric'"
                            "."
                            "\n\n"
                            "'flat' removes vertices when the immediate surrounding patch is uniformly"
@@ -74,11 +76,20 @@ OperationDoc OpArgDocSimplifySurfaceMeshes(){
                            " effectively simplify the mesh."
                            " This is a general-purpose simplification algorithm that works well on"
                            " a variety of meshes."
+                           "\n\n"
+                           "'quadric' repeatedly collapses the edge whose removal least alters the surface, as"
+                           " measured by the quadric error metric (Garland and Heckbert, 1997), until the target"
+                           " face count is reached. Mesh boundaries are preserved where possible."
+                           " Faces are triangulated, and non-manifold edges and vertices are separated."
+                           " Vertex and face attributes are discarded."
+                           " This algorithm targets a face count rather than an edge length, and concentrates"
+                           " faces in regions of high curvature."
                            "";
     out.args.back().default_val = "remesh";
     out.args.back().expected = true;
     out.args.back().examples = { "flat",
                                  "remesh",
+                                 "quadric",
                                  };
     out.args.back().samples = OpArgSamples::Exhaustive;
 
@@ -103,6 +114,16 @@ OperationDoc OpArgDocSimplifySurfaceMeshes(){
     out.args.back().examples = { "1", "3", "5", "10" };
 
 
+    out.args.emplace_back();
+    out.args.back().name = "TargetFaceFraction";
+    out.args.back().desc = "Needed for 'quadric' algorithm."
+                           " The number of faces to retain, as a fraction of the number of (triangulated) faces"
+                           " in the original mesh.";
+    out.args.back().default_val = "0.25";
+    out.args.back().expected = true;
+    out.args.back().examples = { "0.1", "0.25", "0.5", "0.9" };
+
+
     out.args.emplace_back();
     out.args.back().name = "ToleranceDistance";
     out.args.back().desc = "Needed for 'flat' algorithm."
@@ -154,12 +175,18 @@ bool SimplifySurfaceMeshes(Drover &DICOM_data,
 
     const auto TargetEdgeLength = std::stod(OptArgs.getValueStr("TargetEdgeLength").value());
     const auto MeshIterations = std::stol(OptArgs.getValueStr("Iterations").value());
+    const auto TargetFaceFraction = std::stod(OptArgs.getValueStr("TargetFaceFraction").value());
     const auto ToleranceDistance = std::stod(OptArgs.getValueStr("ToleranceDistance").value());
     const auto MinAlignAngle = std::stod(OptArgs.getValueStr("MinAlignAngle").value());
 
     //-----------------------------------------------------------------------------------------------------------------
     const auto regex_remesh = Compile_Regex("^re?m?e?s?h?$");
     const auto regex_flat = Compile_Regex("^fl?a?t?$");
+    const auto regex_quadric = Compile_Regex("^qu?a?d?r?i?c?$");
+
+    if( !(0.0 <= TargetFaceFraction) || !(TargetFaceFraction <= 1.0) ){
+        throw std::invalid_argument("TargetFaceFraction must be within [0,1]");
+    }
 
     auto SMs_all = All_SMs( DICOM_data );
     auto SMs = Whitelist( SMs_all, MeshSelectionStr );
@@ -185,6 +212,23 @@ bool SimplifySurfaceMeshes(Drover &DICOM_data,
             (*smp_it)->meshes.recreate_involved_face_index();
             (*smp_it)->meshes.metadata = orig_metadata;
 
+        }else if(std::regex_match(MethodStr, regex_quadric)){
+            auto hem = (*smp_it)->take_half_edge_mesh();
+            const auto N_faces = hem.face_count();
+            const auto target = static_cast<int64_t>(std::round(TargetFaceFraction * static_cast<double>(N_faces)));
+            const auto N_collapsed = hem.simplify(target);
+            (*smp_it)->set_from_half_edge_mesh(std::move(hem));
+
+            // Collapses merge vertices and remove faces, so per-element attributes no longer correspond.
+            if( !(*smp_it)->vertex_attributes.empty()
+            ||  !(*smp_it)->face_attributes.empty() ){
+                YLOGWARN("Discarding vertex and face attributes, which are invalidated by simplification");
+            }
+            (*smp_it)->vertex_attributes.clear();
+            (*smp_it)->face_attributes.clear();
+            YLOGINFO("Collapsed " << N_collapsed << " edges, reducing " << N_faces << " faces to "
+                  << (*smp_it)->meshes.faces.size());
+
         }else{
             throw std::invalid_argument("Method argument '"_s + MethodStr + "' is not valid");
         }
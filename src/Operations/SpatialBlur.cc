@@ -37,9 +37,12 @@ OperationDoc OpArgDocSpatialBlur(){
     out.args.emplace_back();
     out.args.back().name = "Estimator";
     out.args.back().desc = "Controls the (in-plane) blur estimator to use."
-                      " Options are currently: box_3x3, box_5x5, gaussian_3x3, gaussian_5x5, and gaussian_open."
-                      " The latter (gaussian_open) is adaptive and requires a supplementary parameter that controls"
-                      " the number of adjacent pixels to consider. The former ('...3x3' and '...5x5') are 'fixed'"
+                      " Options are currently: box_3x3, box_5x5, gaussian_3x3, gaussian_5x5, gaussian_open, and"
+                      " gaussian_recursive."
+                      " The latter (gaussian_open and gaussian_recursive) are adaptive and require a supplementary"
+                      " parameter that controls the width of the Gaussian. The gaussian_recursive estimator"
+                      " approximates a Gaussian with a cost that does not depend on sigma, so it is preferred for"
+                      " large sigma. The former ('...3x3' and '...5x5') are 'fixed'"
                       " estimators that use a convolution kernel with a fixed size (3x3 or 5x5 pixel neighbourhoods)."
                       " All estimators operate in 'pixel-space' and are ignorant about the image spatial extent."
                       " All estimators are normalized, and thus won't significantly affect the pixel magnitude scale.";
@@ -49,14 +52,16 @@ OperationDoc OpArgDocSpatialBlur(){
                             "box_5x5",
                             "gaussian_3x3",
                             "gaussian_5x5",
-                            "gaussian_open" };
+                            "gaussian_open",
+                            "gaussian_recursive" };
 
     out.args.emplace_back();
     out.args.back().name = "GaussianOpenSigma";
-    out.args.back().desc = "Controls the number of neighbours to consider (only) when using the gaussian_open estimator."
+    out.args.back().desc = "Controls the number of neighbours to consider (only) when using the gaussian_open estimator,"
+                      " or the width of the gaussian_recursive estimator. Sigma is in pixel units."
                       " The number of pixels is computed automatically to accommodate the specified sigma"
-                      " (currently ignored pixels have 3*sigma or less weighting). Be aware this operation can take"
-                      " an enormous amount of time, since the pixel neighbourhoods quickly grow large.";
+                      " (currently ignored pixels have 3*sigma or less weighting). The gaussian_open estimator is"
+                      " applied separably, so the cost grows linearly with sigma.";
     out.args.back().default_val = "1.5";
     out.args.back().expected = true;
     out.args.back().examples = { "0.5",
@@ -84,6 +89,7 @@ bool SpatialBlur(Drover &DICOM_data,
     const auto regex_gau3x3 = Compile_Regex("^ga?u?s?s?i?a?n?_?3x?3?$");
     const auto regex_gau5x5 = Compile_Regex("^ga?u?s?s?i?a?n?_?5x?5?$");
     const auto regex_gauopn = Compile_Regex("^ga?u?s?s?i?a?n?_?op?e?n?$");
+    const auto regex_gaurec = Compile_Regex("^ga?u?s?s?i?a?n?_?re?c?u?r?s?i?v?e?$");
 
 
     auto IAs_all = All_IAs( DICOM_data );
@@ -102,6 +108,8 @@ bool SpatialBlur(Drover &DICOM_data,
             ud.estimator = BlurEstimator::gaussian_5x5;
         }else if( std::regex_match(EstimatorStr, regex_gauopn) ){
             ud.estimator = BlurEstimator::gaussian_open;
+        }else if( std::regex_match(EstimatorStr, regex_gaurec) ){
+            ud.estimator = BlurEstimator::gaussian_recursive;
         }else{
             throw std::invalid_argument("Estimator argument '"_s + EstimatorStr + "' is not valid");
         }
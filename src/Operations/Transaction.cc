@@ -45,7 +45,9 @@ OperationDoc OpArgDocTransaction(){
         " Side-effects will therefore be committed immediately, regardless of whether the transaction succeeds."
     );
     out.notes.emplace_back(
-        "This operation duplicates the full internal data state, so can be memory-intensive."
+        "Only the parts of the internal data state that children operations might modify are duplicated; the rest"
+        " is shared with the snapshot. Children operations that do not document which data they modify will cause the"
+        " full internal data state to be duplicated, which can be memory-intensive."
     );
 
     return out;
@@ -68,8 +70,8 @@ bool Transaction(Drover &DICOM_data,
         YLOGWARN("No children operations specified, forgoing transaction");
     }else{
 
-        // Copy Drover and other relevant internal state.
-        const auto orig_DICOM_data = DICOM_data.Deep_Copy();
+        // Copy Drover and other relevant internal state. Only the members the children might modify are copied.
+        const auto orig_DICOM_data = DICOM_data.Deep_Copy( Operations_Modified_Members(children) );
         const auto orig_InvocationMetadata = InvocationMetadata;
 
         // Perform children operations.
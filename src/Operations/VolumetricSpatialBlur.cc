@@ -33,6 +33,8 @@ OperationDoc OpArgDocVolumetricSpatialBlur(){
 
     out.notes.emplace_back(
         "The provided image collection must be rectilinear."
+        " Image collections that form a regular grid are blurred considerably faster, and are required for"
+        " the 'GaussianOpen' and 'GaussianRecursive' estimators."
     );
 
     out.args.emplace_back();
@@ -72,16 +74,36 @@ OperationDoc OpArgDocVolumetricSpatialBlur(){
     out.args.emplace_back();
     out.args.back().name = "Estimator";
     out.args.back().desc = "Controls which type of blur is computed."
-                           " Currently, 'Gaussian' refers to a fixed sigma=1 (in pixel coordinates, not DICOM units)"
+                           " 'Gaussian' refers to a fixed sigma=1 (in pixel coordinates, not DICOM units)"
                            " Gaussian blur that extends for 3*sigma thus providing a 7x7x7 window."
                            " Note that applying this kernel N times will approximate a Gaussian with sigma=N."
+                           " 'GaussianOpen' refers to a Gaussian blur with a user-specified sigma (in DICOM units)"
+                           " that extends for 3*sigma, so cost grows with sigma."
+                           " 'GaussianRecursive' refers to a recursive approximation of a Gaussian blur with a"
+                           " user-specified sigma (in DICOM units) whose cost does not depend on sigma, which is"
+                           " preferred for large sigma."
                            " Also note that boundary voxels will cause accessible voxels within the same window to be more"
                            " heavily weighted. Try avoid boundaries or add extra margins if possible.";
     out.args.back().default_val = "Gaussian";
     out.args.back().expected = true;
-    out.args.back().examples = { "Gaussian" };
+    out.args.back().examples = { "Gaussian",
+                                 "GaussianOpen",
+                                 "GaussianRecursive" };
     out.args.back().samples = OpArgSamples::Exhaustive;
 
+
+    out.args.emplace_back();
+    out.args.back().name = "Sigma";
+    out.args.back().desc = "The Gaussian sigma, in DICOM units (i.e., mm)."
+                           " This parameter is only used by the 'GaussianOpen' and 'GaussianRecursive' estimators."
+                           " Voxel spacing is taken into account, so anisotropic voxels are blurred isotropically.";
+    out.args.back().default_val = "1.0";
+    out.args.back().expected = true;
+    out.args.back().examples = { "0.5",
+                                 "1.0",
+                                 "2.5",
+                                 "10.0" };
+
     return out;
 }
 
@@ -100,9 +122,12 @@ bool VolumetricSpatialBlur(Drover &DICOM_data,
     const auto Channel = std::stol( OptArgs.getValueStr("Channel").value() );
 
     const auto EstimatorStr = OptArgs.getValueStr("Estimator").value();
+    const auto Sigma = std::stod( OptArgs.getValueStr("Sigma").value() );
 
     //-----------------------------------------------------------------------------------------------------------------
     const auto regex_gauss = Compile_Regex("^ga?u?s?s?i?a?n?$");
+    const auto regex_gauss_open = Compile_Regex("^ga?u?s?s?i?a?n?_?op?e?n?$");
+    const auto regex_gauss_rec = Compile_Regex("^ga?u?s?s?i?a?n?_?re?c?u?r?s?i?v?e?$");
 
     auto cc_all = All_CCs( DICOM_data );
     auto cc_ROIs = Whitelist( cc_all, ROILabelRegex, NormalizedROILabelRegex, ROISelection );
@@ -117,11 +142,17 @@ bool VolumetricSpatialBlur(Drover &DICOM_data,
         // Planar derivatives.
         ComputeVolumetricSpatialBlurUserData ud;
         ud.channel = Channel;
+        ud.gaussian_sigma = Sigma;
         if(std::regex_match(EstimatorStr, regex_gauss)){
             ud.estimator = VolumetricSpatialBlurEstimator::Gaussian;
+        }else if(std::regex_match(EstimatorStr, regex_gauss_open)){
+            ud.estimator = VolumetricSpatialBlurEstimator::GaussianOpen;
+        }else if(std::regex_match(EstimatorStr, regex_gauss_rec)){
+            ud.estimator = VolumetricSpatialBlurEstimator::GaussianRecursive;
         }else{
             throw std::invalid_argument("Estimator not understood. Refusing to continue.");
         }
+        ud.grid_index = (*iap_it)->get_voxel_grid_index();
 
         if(!(*iap_it)->imagecoll.Compute_Images( ComputeVolumetricSpatialBlur,
                                                  {}, cc_ROIs, &ud )){
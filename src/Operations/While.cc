@@ -90,15 +90,18 @@ bool While(Drover &DICOM_data,
     if(!children.empty()) child_condition.splice( std::end(child_condition), children, std::begin(children) );
     child_body.splice( std::end(child_body), children );
 
+    const auto plan_condition = Compile_Operations(child_condition);
+    const auto plan_body = Compile_Operations(child_body);
+
     bool condition = false;
     int64_t i = 0;
     while(true){
         if( (0 <= N) && (N <= i++) ) return false;
 
-        condition = Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, child_condition);
+        condition = Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan_condition);
         if(!condition) break;
 
-        if(!Operation_Dispatcher(DICOM_data, InvocationMetadata, FilenameLex, child_body)){
+        if(!Execute_Operations(DICOM_data, InvocationMetadata, FilenameLex, plan_body)){
             // Treat false truthiness in the body operations as a break statement, to continue execution.
             return true;
         }
@@ -0,0 +1,406 @@
+//ROI_Span_Masks.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file provides run-length (row span) masks describing which voxels of an image are bounded by contours.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "ROI_Span_Masks.h"
+
+
+bool roi_span_mask::contains(int64_t row, int64_t col) const {
+    if( (row < 0) || (this->rows <= row)
+    ||  (col < 0) || (this->cols <= col) ) return false;
+    const auto beg = std::next(std::begin(this->spans), this->row_offsets.at(row));
+    const auto end = std::next(std::begin(this->spans), this->row_offsets.at(row + 1));
+    const auto it = std::upper_bound(beg, end, col, [](int64_t c, const voxel_row_span &s){ return c < s.col_begin; });
+    return (it != beg) && (col < std::prev(it)->col_end);
+}
+
+int64_t roi_span_mask::count() const {
+    int64_t N = 0;
+    for(const auto &s : this->spans) N += (s.col_end - s.col_begin);
+    return N;
+}
+
+
+namespace {
+
+// Half-open column intervals [begin, end), ordered and disjoint.
+using intervals_t = std::vector<std::pair<int64_t, int64_t>>;
+
+// A contour projected onto the image plane, in fractional (row, column) voxel coordinates.
+struct projected_polygon {
+    std::vector<double> y; // Row coordinate.
+    std::vector<double> x; // Column coordinate.
+    double y_min = 0.0;
+    double y_max = 0.0;
+};
+
+// Collect the column coordinates where the polygon edges cross the horizontal lines y = k + offset for k in
+// [k_min, k_max]. Crossings are sorted. Vertices are assigned to the half-open edges so each crossing is counted once.
+std::vector<std::vector<double>> scanline_crossings(const projected_polygon &poly,
+                                                    double offset,
+                                                    int64_t k_min,
+                                                    int64_t k_max){
+    std::vector<std::vector<double>> out;
+    if(k_max < k_min) return out;
+    out.resize(static_cast<size_t>(k_max - k_min + 1));
+
+    const auto N = poly.y.size();
+    for(size_t i = 0; i < N; ++i){
+        const auto j = (i + 1) % N;
+        const auto ya = poly.y[i];
+        const auto yb = poly.y[j];
+        if(ya == yb) continue;
+        const auto lo = std::min(ya, yb);
+        const auto hi = std::max(ya, yb);
+
+        // Lines with lo <= (k + offset) < hi.
+        const auto k_lo = std::max(k_min, static_cast<int64_t>(std::ceil(lo - offset)));
+        const auto k_hi = std::min(k_max, static_cast<int64_t>(std::ceil(hi - offset)) - 1);
+        const auto dxdy = (poly.x[j] - poly.x[i]) / (yb - ya);
+        for(int64_t k = k_lo; k <= k_hi; ++k){
+            const auto y = static_cast<double>(k) + offset;
+            out[static_cast<size_t>(k - k_min)].push_back( poly.x[i] + (y - ya) * dxdy );
+        }
+    }
+    for(auto &xs : out) std::sort(std::begin(xs), std::end(xs));
+    return out;
+}
+
+// Convert sorted crossings to the intervals of integer j in [0, n) for which (j + shift) is interior (even-odd rule).
+intervals_t crossings_to_intervals(const std::vector<double> &xs, double shift, int64_t n){
+    intervals_t out;
+    for(size_t i = 0; (i + 1) < xs.size(); i += 2){
+        const auto b = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(xs[i] - shift)), 0, n);
+        const auto e = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(xs[i + 1] - shift)), 0, n);
+        if(b < e) out.emplace_back(b, e);
+    }
+    return out;
+}
+
+intervals_t merge_intervals(intervals_t A){
+    std::sort(std::begin(A), std::end(A));
+    intervals_t out;
+    for(const auto &i : A){
+        if(!out.empty() && (i.first <= out.back().second)){
+            out.back().second = std::max(out.back().second, i.second);
+        }else{
+            out.push_back(i);
+        }
+    }
+    return out;
+}
+
+intervals_t intersect_intervals(const intervals_t &A, const intervals_t &B){
+    intervals_t out;
+    auto a = std::begin(A);
+    auto b = std::begin(B);
+    while( (a != std::end(A)) && (b != std::end(B)) ){
+        const auto lo = std::max(a->first, b->first);
+        const auto hi = std::min(a->second, b->second);
+        if(lo < hi) out.emplace_back(lo, hi);
+        if(a->second < b->second){
+            ++a;
+        }else{
+            ++b;
+        }
+    }
+    return out;
+}
+
+// Cache of masks.
+struct mask_key {
+    std::array<double, 15> geometry;
+    int64_t rows;
+    int64_t cols;
+    uint64_t fingerprint;
+    Mutate_Voxels_Opts::Inclusivity inclusivity;
+    Mutate_Voxels_Opts::ContourOverlap contouroverlap;
+
+    bool operator<(const mask_key &rhs) const {
+        return std::tie(this->fingerprint, this->rows, this->cols, this->geometry, this->inclusivity, this->contouroverlap)
+             < std::tie(rhs.fingerprint, rhs.rows, rhs.cols, rhs.geometry, rhs.inclusivity, rhs.contouroverlap);
+    }
+};
+
+using lru_t = std::list<std::pair<mask_key, std::shared_ptr<const roi_span_mask>>>;
+
+// The maximum size of the masks held in the cache, in bytes.
+constexpr int64_t max_cached_bytes = 100'000'000;
+
+// The approximate memory used by a cached mask, including its row offsets.
+int64_t cached_mask_bytes(const roi_span_mask &mask){
+    return static_cast<int64_t>( sizeof(roi_span_mask)
+                               + mask.spans.size() * sizeof(voxel_row_span)
+                               + mask.row_offsets.size() * sizeof(int64_t) );
+}
+
+std::mutex cache_mutex;
+lru_t cache_lru; // Most-recently used at the front.
+std::map<mask_key, lru_t::iterator> cache_index;
+int64_t cached_bytes = 0;
+
+} // namespace
+
+
+roi_span_mask Rasterize_ROI_Span_Mask( const planar_image<float,double> &img,
+                                       const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl,
+                                       Mutate_Voxels_Opts::Inclusivity inclusivity,
+                                       Mutate_Voxels_Opts::ContourOverlap contouroverlap ){
+    roi_span_mask out;
+    out.rows = std::max<int64_t>(0, img.rows);
+    out.cols = std::max<int64_t>(0, img.columns);
+    out.row_offsets.assign(static_cast<size_t>(out.rows + 1), 0);
+    if( (out.rows == 0) || (out.cols == 0) ) return out;
+
+    const auto rows = out.rows;
+    const auto cols = out.cols;
+    const auto origin = img.anchor + img.offset;
+
+    // Weighted interval endpoints for each row. The weights are accumulated and compared to the overlap criteria.
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> events(static_cast<size_t>(rows));
+
+    for(const auto &cc_refw : ccsl){
+        for(const auto &contour : cc_refw.get().contours){
+            if(contour.points.size() < 3) continue;
+            if(!img.encompasses_contour_of_points(contour)) continue;
+
+            // Project onto the image plane. Columns run along the row unit vector and rows along the column unit vector.
+            projected_polygon poly;
+            for(const auto &p : contour.points){
+                const auto d = p - origin;
+                poly.x.push_back( d.Dot(img.row_unit) / img.pxl_dx );
+                poly.y.push_back( d.Dot(img.col_unit) / img.pxl_dy );
+            }
+            poly.y_min = *std::min_element(std::begin(poly.y), std::end(poly.y));
+            poly.y_max = *std::max_element(std::begin(poly.y), std::end(poly.y));
+
+            int64_t weight = 1;
+            if(contouroverlap == Mutate_Voxels_Opts::ContourOverlap::HonourOppositeOrientations){
+                double area = 0.0;
+                const auto N = poly.x.size();
+                for(size_t i = 0; i < N; ++i){
+                    const auto j = (i + 1) % N;
+                    area += poly.x[i] * poly.y[j] - poly.x[j] * poly.y[i];
+                }
+                weight = (area < 0.0) ? -1 : 1;
+            }
+
+            const auto add = [&](int64_t row, const intervals_t &intervals){
+                for(const auto &i : intervals){
+                    events[static_cast<size_t>(row)].emplace_back(i.first, weight);
+                    events[static_cast<size_t>(row)].emplace_back(i.second, -weight);
+                }
+            };
+
+            if(inclusivity == Mutate_Voxels_Opts::Inclusivity::Centre){
+                // Scanlines through voxel centres.
+                const auto r_min = std::max<int64_t>(0, static_cast<int64_t>(std::ceil(poly.y_min)));
+                const auto r_max = std::min<int64_t>(rows - 1, static_cast<int64_t>(std::floor(poly.y_max)));
+                const auto crossings = scanline_crossings(poly, 0.0, r_min, r_max);
+                for(int64_t r = r_min; r <= r_max; ++r){
+                    add(r, crossings_to_intervals(crossings[static_cast<size_t>(r - r_min)], 0.0, cols));
+                }
+
+            }else{
+                // Scanlines through voxel corners. Corner (i, j) is located at (i - 0.5, j - 0.5).
+                const auto i_min = std::max<int64_t>(0, static_cast<int64_t>(std::ceil(poly.y_min + 0.5)));
+                const auto i_max = std::min<int64_t>(rows, static_cast<int64_t>(std::floor(poly.y_max + 0.5)));
+                const auto crossings = scanline_crossings(poly, -0.5, i_min, i_max);
+                const auto corners = [&](int64_t i) -> intervals_t {
+                    if( (i < i_min) || (i_max < i) ) return {};
+                    // Intervals can touch when the contour dips out between two adjacent corners.
+                    return merge_intervals( crossings_to_intervals(crossings[static_cast<size_t>(i - i_min)], -0.5, cols + 1) );
+                };
+
+                const auto r_min = std::max<int64_t>(0, i_min - 1);
+                const auto r_max = std::min<int64_t>(rows - 1, i_max);
+                for(int64_t r = r_min; r <= r_max; ++r){
+                    const auto above = corners(r);
+                    const auto below = corners(r + 1);
+                    intervals_t voxels;
+                    if(inclusivity == Mutate_Voxels_Opts::Inclusivity::Inclusive){
+                        // Any corner: voxel c has corners c and c+1.
+                        auto any = above;
+                        any.insert(std::end(any), std::begin(below), std::end(below));
+                        for(const auto &i : merge_intervals(any)){
+                            voxels.emplace_back(std::max<int64_t>(0, i.first - 1), std::min<int64_t>(cols, i.second));
+                        }
+                        voxels = merge_intervals(voxels);
+                    }else{
+                        // All corners.
+                        for(const auto &i : intersect_intervals(above, below)){
+                            const auto e = std::min<int64_t>(cols, i.second - 1);
+                            if(i.first < e) voxels.emplace_back(i.first, e);
+                        }
+                    }
+                    add(r, voxels);
+                }
+            }
+        }
+    }
+
+    // Sweep the events in each row, emitting spans wherever the accumulated weight satisfies the overlap criteria.
+    const auto is_bounded = [contouroverlap](int64_t w) -> bool {
+        if(contouroverlap == Mutate_Voxels_Opts::ContourOverlap::ImplicitOrientations){
+            return (w % 2) != 0;
+        }else if(contouroverlap == Mutate_Voxels_Opts::ContourOverlap::HonourOppositeOrientations){
+            return (w != 0);
+        }
+        return (0 < w);
+    };
+    for(int64_t r = 0; r < rows; ++r){
+        out.row_offsets[static_cast<size_t>(r)] = static_cast<int64_t>(out.spans.size());
+        auto &e = events[static_cast<size_t>(r)];
+        std::sort(std::begin(e), std::end(e));
+
+        int64_t w = 0;
+        size_t i = 0;
+        while(i < e.size()){
+            const auto c = e[i].first;
+            while( (i < e.size()) && (e[i].first == c) ){
+                w += e[i].second;
+                ++i;
+            }
+            const auto c_next = (i < e.size()) ? e[i].first : cols;
+            if( (c < c_next) && is_bounded(w) ){
+                if( !out.spans.empty()
+                &&  (out.spans.back().row == r)
+                &&  (out.spans.back().col_end == c) ){
+                    out.spans.back().col_end = c_next;
+                }else{
+                    out.spans.push_back({ r, c, c_next });
+                }
+            }
+        }
+    }
+    out.row_offsets[static_cast<size_t>(rows)] = static_cast<int64_t>(out.spans.size());
+    return out;
+}
+
+uint64_t Contour_Fingerprint( const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl ){
+    // FNV-1a.
+    uint64_t h = 14695981039346656037ULL;
+    const auto digest = [&](uint64_t v){
+        for(int64_t i = 0; i < 8; ++i){
+            h ^= (v >> (8 * i)) & 0xFFULL;
+            h *= 1099511628211ULL;
+        }
+    };
+    const auto digest_double = [&](double d){
+        uint64_t v = 0;
+        std::memcpy(&v, &d, sizeof(v));
+        digest(v);
+    };
+
+    digest(static_cast<uint64_t>(ccsl.size()));
+    for(const auto &cc_refw : ccsl){
+        digest(static_cast<uint64_t>(cc_refw.get().contours.size()));
+        for(const auto &contour : cc_refw.get().contours){
+            digest(static_cast<uint64_t>(contour.points.size()));
+            digest(contour.closed ? 1ULL : 0ULL);
+            for(const auto &p : contour.points){
+                digest_double(p.x);
+                digest_double(p.y);
+                digest_double(p.z);
+            }
+        }
+    }
+    return h;
+}
+
+std::shared_ptr<const roi_span_mask> Get_ROI_Span_Mask( const planar_image<float,double> &img,
+                                                        const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl,
+                                                        Mutate_Voxels_Opts::Inclusivity inclusivity,
+                                                        Mutate_Voxels_Opts::ContourOverlap contouroverlap ){
+    return Get_ROI_Span_Mask(img, ccsl, inclusivity, contouroverlap, Contour_Fingerprint(ccsl));
+}
+
+std::shared_ptr<const roi_span_mask> Get_ROI_Span_Mask( const planar_image<float,double> &img,
+                                                        const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl,
+                                                        Mutate_Voxels_Opts::Inclusivity inclusivity,
+                                                        Mutate_Voxels_Opts::ContourOverlap contouroverlap,
+                                                        uint64_t contour_fingerprint ){
+    mask_key key;
+    key.geometry = {{ img.anchor.x, img.anchor.y, img.anchor.z,
+                      img.offset.x, img.offset.y, img.offset.z,
+                      img.row_unit.x, img.row_unit.y, img.row_unit.z,
+                      img.col_unit.x, img.col_unit.y, img.col_unit.z,
+                      img.pxl_dx, img.pxl_dy, img.pxl_dz }};
+    key.rows = img.rows;
+    key.cols = img.columns;
+    key.fingerprint = contour_fingerprint;
+    key.inclusivity = inclusivity;
+    key.contouroverlap = contouroverlap;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = cache_index.find(key);
+        if(it != std::end(cache_index)){
+            cache_lru.splice(std::begin(cache_lru), cache_lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Rasterize without holding the lock. Concurrent requests for the same mask may both rasterize it, but the results
+    // are identical.
+    auto mask = std::make_shared<const roi_span_mask>( Rasterize_ROI_Span_Mask(img, ccsl, inclusivity, contouroverlap) );
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if(cache_index.count(key) == 0){
+        cache_lru.emplace_front(key, mask);
+        cache_index[key] = std::begin(cache_lru);
+        cached_bytes += cached_mask_bytes(*mask);
+        while( (max_cached_bytes < cached_bytes)
+           &&  (1 < cache_lru.size()) ){
+            cached_bytes -= cached_mask_bytes(*(cache_lru.back().second));
+            cache_index.erase(cache_lru.back().first);
+            cache_lru.pop_back();
+        }
+    }
+    return mask;
+}
+
+void Clear_ROI_Span_Mask_Cache(){
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache_index.clear();
+    cache_lru.clear();
+    cached_bytes = 0;
+    return;
+}
+
+std::vector<voxel_row_span> Complement_Row_Spans( const std::vector<voxel_row_span> &spans,
+                                                  int64_t rows,
+                                                  int64_t cols ){
+    std::vector<voxel_row_span> out;
+    if( (rows <= 0) || (cols <= 0) ) return out;
+
+    auto it = std::begin(spans);
+    for(int64_t r = 0; r < rows; ++r){
+        int64_t c = 0;
+        for( ; (it != std::end(spans)) && (it->row == r); ++it){
+            if(c < it->col_begin) out.push_back({ r, c, it->col_begin });
+            c = std::max(c, it->col_end);
+        }
+        if(c < cols) out.push_back({ r, c, cols });
+    }
+    return out;
+}
+
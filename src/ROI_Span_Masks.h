@@ -0,0 +1,82 @@
+//ROI_Span_Masks.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// Run-length (row span) masks describing which voxels of an image are bounded by contours.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+
+// A run of voxels [col_begin, col_end) within a single image row.
+struct voxel_row_span {
+    int64_t row = 0;
+    int64_t col_begin = 0;
+    int64_t col_end = 0;
+};
+
+// The voxels of an image that are bounded by contours.
+struct roi_span_mask {
+    int64_t rows = 0;
+    int64_t cols = 0;
+
+    // Disjoint spans, ordered by row and then column.
+    std::vector<voxel_row_span> spans;
+
+    // The spans of row r are spans[row_offsets[r]] up to (but excluding) spans[row_offsets[r+1]].
+    std::vector<int64_t> row_offsets;
+
+    bool contains(int64_t row, int64_t col) const;
+
+    // The number of bounded voxels.
+    int64_t count() const;
+};
+
+// Rasterize the contours onto the image grid using scanlines. Contours are projected orthogonally onto the image plane,
+// and only contours that the image encompasses are considered.
+//
+// Inclusivity and contour overlap mirror Mutate_Voxels:
+//   - Centre considers only the voxel centre, Inclusive considers a voxel bounded if any (planar) corner is bounded,
+//     and Exclusive considers a voxel bounded only if all corners are bounded. Corners are evaluated per contour.
+//   - Ignore bounds voxels within any contour, HonourOppositeOrientations bounds voxels with a non-zero net count of
+//     oriented contours (so oppositely-oriented contours cancel), and ImplicitOrientations bounds voxels within an odd
+//     number of contours.
+roi_span_mask Rasterize_ROI_Span_Mask( const planar_image<float,double> &img,
+                                       const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl,
+                                       Mutate_Voxels_Opts::Inclusivity inclusivity,
+                                       Mutate_Voxels_Opts::ContourOverlap contouroverlap );
+
+// A hash of the contour vertices, used to identify cached masks. Any alteration to the contours changes the hash.
+uint64_t Contour_Fingerprint( const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl );
+
+// Retrieve a mask from the process-wide cache, rasterizing it if needed. Masks are keyed on the image geometry, the
+// contour fingerprint, and the options, so altering either the image geometry or the contours will not return a stale
+// mask. The cache is bounded and the least-recently used masks are evicted. This routine is thread-safe.
+//
+// The contour fingerprint can be provided when the same contours are used for many images.
+std::shared_ptr<const roi_span_mask> Get_ROI_Span_Mask( const planar_image<float,double> &img,
+                                                        const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl,
+                                                        Mutate_Voxels_Opts::Inclusivity inclusivity,
+                                                        Mutate_Voxels_Opts::ContourOverlap contouroverlap );
+
+std::shared_ptr<const roi_span_mask> Get_ROI_Span_Mask( const planar_image<float,double> &img,
+                                                        const std::list<std::reference_wrapper<contour_collection<double>>> &ccsl,
+                                                        Mutate_Voxels_Opts::Inclusivity inclusivity,
+                                                        Mutate_Voxels_Opts::ContourOverlap contouroverlap,
+                                                        uint64_t contour_fingerprint );
+
+// Purge all cached masks.
+void Clear_ROI_Span_Mask_Cache();
+
+// Row spans covering the voxels NOT covered by the given (ordered) spans.
+std::vector<voxel_row_span> Complement_Row_Spans( const std::vector<voxel_row_span> &spans,
+                                                  int64_t rows,
+                                                  int64_t cols );
+
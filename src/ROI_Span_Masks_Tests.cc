@@ -0,0 +1,162 @@
+//ROI_Span_Masks_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the ROI span masks defined in ROI_Span_Masks.cc.
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "ROI_Span_Masks.h"
+
+
+static
+planar_image<float,double>
+make_image(int64_t rows, int64_t cols){
+    planar_image<float,double> img;
+    img.init_orientation(vec3<double>(1.0, 0.0, 0.0), vec3<double>(0.0, 1.0, 0.0));
+    img.init_buffer(rows, cols, 1);
+    img.init_spatial(1.0, 1.0, 1.0, vec3<double>(0.0, 0.0, 0.0), vec3<double>(0.0, 0.0, 0.0));
+    return img;
+}
+
+// An axis-aligned rectangle in the z = 0 plane. Orientation is reversed if requested.
+static
+contour_of_points<double>
+make_rectangle(double x_min, double y_min, double x_max, double y_max, bool reversed = false){
+    contour_of_points<double> c;
+    c.closed = true;
+    c.points.emplace_back(x_min, y_min, 0.0);
+    c.points.emplace_back(x_max, y_min, 0.0);
+    c.points.emplace_back(x_max, y_max, 0.0);
+    c.points.emplace_back(x_min, y_max, 0.0);
+    if(reversed) c.points.reverse();
+    return c;
+}
+
+
+TEST_CASE( "Rasterize_ROI_Span_Mask" ){
+    auto img = make_image(10, 10);
+    using incl_t = Mutate_Voxels_Opts::Inclusivity;
+    using overlap_t = Mutate_Voxels_Opts::ContourOverlap;
+
+    SUBCASE("inclusivity"){
+        // Voxel (row, col) is centred at (x = col, y = row).
+        contour_collection<double> cc;
+        cc.contours.push_back( make_rectangle(1.2, 2.2, 4.2, 5.2) );
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(cc) };
+
+        const auto centre = Rasterize_ROI_Span_Mask(img, ccsl, incl_t::Centre, overlap_t::Ignore);
+        REQUIRE( centre.count() == 9 );
+        REQUIRE( centre.contains(3, 2) );
+        REQUIRE( centre.contains(5, 4) );
+        REQUIRE( !centre.contains(2, 2) );
+        REQUIRE( !centre.contains(3, 5) );
+        REQUIRE( centre.row_offsets.size() == 11 );
+
+        const auto inclusive = Rasterize_ROI_Span_Mask(img, ccsl, incl_t::Inclusive, overlap_t::Ignore);
+        REQUIRE( inclusive.count() == 16 );
+        REQUIRE( inclusive.contains(2, 1) );
+        REQUIRE( inclusive.contains(5, 4) );
+        REQUIRE( !inclusive.contains(6, 4) );
+
+        const auto exclusive = Rasterize_ROI_Span_Mask(img, ccsl, incl_t::Exclusive, overlap_t::Ignore);
+        REQUIRE( exclusive.count() == 4 );
+        REQUIRE( exclusive.contains(3, 2) );
+        REQUIRE( exclusive.contains(4, 3) );
+        REQUIRE( !exclusive.contains(5, 4) );
+    }
+
+    SUBCASE("contour overlap"){
+        contour_collection<double> opposite;
+        opposite.contours.push_back( make_rectangle(0.2, 0.2, 6.2, 6.2) );
+        opposite.contours.push_back( make_rectangle(2.2, 2.2, 4.2, 4.2, true) );
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl_opposite = { std::ref(opposite) };
+
+        contour_collection<double> same;
+        same.contours.push_back( make_rectangle(0.2, 0.2, 6.2, 6.2) );
+        same.contours.push_back( make_rectangle(2.2, 2.2, 4.2, 4.2) );
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl_same = { std::ref(same) };
+
+        REQUIRE( Rasterize_ROI_Span_Mask(img, ccsl_opposite, incl_t::Centre, overlap_t::Ignore).count() == 36 );
+        REQUIRE( Rasterize_ROI_Span_Mask(img, ccsl_opposite, incl_t::Centre, overlap_t::HonourOppositeOrientations).count() == 32 );
+        REQUIRE( Rasterize_ROI_Span_Mask(img, ccsl_opposite, incl_t::Centre, overlap_t::ImplicitOrientations).count() == 32 );
+
+        REQUIRE( Rasterize_ROI_Span_Mask(img, ccsl_same, incl_t::Centre, overlap_t::HonourOppositeOrientations).count() == 36 );
+        REQUIRE( Rasterize_ROI_Span_Mask(img, ccsl_same, incl_t::Centre, overlap_t::ImplicitOrientations).count() == 32 );
+    }
+
+    SUBCASE("non-convex contours match point-in-polygon tests"){
+        contour_of_points<double> c;
+        c.closed = true;
+        c.points.emplace_back(0.3, 0.7, 0.0);
+        c.points.emplace_back(8.6, 1.1, 0.0);
+        c.points.emplace_back(4.1, 4.4, 0.0);
+        c.points.emplace_back(8.9, 8.3, 0.0);
+        c.points.emplace_back(1.4, 7.9, 0.0);
+        contour_collection<double> cc;
+        cc.contours.push_back(c);
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(cc) };
+
+        // Even-odd ray test.
+        const auto inside = [&](double x, double y){
+            bool in = false;
+            const std::vector<vec3<double>> P(std::begin(c.points), std::end(c.points));
+            for(size_t i = 0, j = P.size() - 1; i < P.size(); j = i++){
+                if( ((P[i].y <= y) != (P[j].y <= y))
+                &&  (x < (P[j].x - P[i].x) * (y - P[i].y) / (P[j].y - P[i].y) + P[i].x) ) in = !in;
+            }
+            return in;
+        };
+
+        const auto mask = Rasterize_ROI_Span_Mask(img, ccsl, incl_t::Centre, overlap_t::Ignore);
+        int64_t N = 0;
+        for(int64_t r = 0; r < img.rows; ++r){
+            for(int64_t col = 0; col < img.columns; ++col){
+                const bool expected = inside(static_cast<double>(col), static_cast<double>(r));
+                REQUIRE( mask.contains(r, col) == expected );
+                if(expected) ++N;
+            }
+        }
+        REQUIRE( mask.count() == N );
+    }
+
+    SUBCASE("cached masks are reused until the contours change"){
+        Clear_ROI_Span_Mask_Cache();
+        contour_collection<double> cc;
+        cc.contours.push_back( make_rectangle(1.2, 2.2, 4.2, 5.2) );
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(cc) };
+
+        const auto A = Get_ROI_Span_Mask(img, ccsl, incl_t::Centre, overlap_t::Ignore);
+        const auto B = Get_ROI_Span_Mask(img, ccsl, incl_t::Centre, overlap_t::Ignore);
+        REQUIRE( (A == B) );
+
+        const auto C = Get_ROI_Span_Mask(img, ccsl, incl_t::Inclusive, overlap_t::Ignore);
+        REQUIRE( (A != C) );
+
+        cc.contours.back().points.front().x = 0.2;
+        const auto D = Get_ROI_Span_Mask(img, ccsl, incl_t::Centre, overlap_t::Ignore);
+        REQUIRE( (A != D) );
+        REQUIRE( A->count() == 9 );
+        REQUIRE( D->count() != 9 );
+        Clear_ROI_Span_Mask_Cache();
+    }
+}
+
+TEST_CASE( "Complement_Row_Spans" ){
+    const std::vector<voxel_row_span> spans = { { 0, 0, 2 }, { 0, 4, 5 }, { 2, 1, 3 } };
+    const auto comp = Complement_Row_Spans(spans, 3, 5);
+    REQUIRE( comp.size() == 4 );
+    REQUIRE( (comp[0].row == 0 && comp[0].col_begin == 2 && comp[0].col_end == 4) );
+    REQUIRE( (comp[1].row == 1 && comp[1].col_begin == 0 && comp[1].col_end == 5) );
+    REQUIRE( (comp[2].row == 2 && comp[2].col_begin == 0 && comp[2].col_end == 1) );
+    REQUIRE( (comp[3].row == 2 && comp[3].col_begin == 3 && comp[3].col_end == 5) );
+
+    REQUIRE( Complement_Row_Spans(comp, 3, 5).size() == spans.size() );
+}
+
@@ -1,8 +1,8 @@
 // SYCL_Fallback.h.
 
-// This is a *mock*, minimal, CPU-only implementation of SYCL.hpp.
+// This is a minimal, CPU-only implementation of SYCL.hpp.
 // It is meant to help compile and run SYCL code when the compiler or toolchain lacks support.
-// Code compiled with this mock header will NOT have any runtime support.
+// Kernels are executed synchronously on a work-stealing thread pool; there is no device or asynchronous runtime.
 // Based on the SYCL 2020 standard (but missing a lot of functionality!).
 
 #ifndef SYCL_FALLBACK_HPP
@@ -21,6 +21,13 @@
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
 
 #include "YgorThreadPool.h"
 
@@ -116,6 +123,9 @@ struct item {
         : r(range_val), i(id_val) {}
 
     id<Dims> get_id() const { return i; }
+    size_t get_id(int d) const { return i[d]; }
+    size_t operator[](int d) const { return i[d]; }
+    operator id<Dims>() const { return i; }
     range<Dims> get_range() const { return r; }
     size_t get_linear_id() const {
         size_t idx = 0;
@@ -212,66 +222,666 @@ template <typename T, int Dims>
 accessor(buffer<T, Dims>&, handler&) -> accessor<T, Dims, access::mode::read_write, access::target::global_buffer>;
 
 
+// =============================================================================
+// Work-groups: nd_range, nd_item, group, h_item
+// =============================================================================
+
+template <int Dims>
+struct nd_range {
+    range<Dims> global;
+    range<Dims> local;
+
+    nd_range(range<Dims> global_val, range<Dims> local_val)
+        : global(global_val), local(local_val) {}
+
+    range<Dims> get_global_range() const { return global; }
+    range<Dims> get_local_range() const { return local; }
+    range<Dims> get_group_range() const {
+        range<Dims> out = global;
+        for (int d = 0; d < Dims; ++d) out.dims[d] = (local[d] == 0) ? 0 : (global[d] / local[d]);
+        return out;
+    }
+};
+
+namespace detail {
+    template <int Dims>
+    size_t linearize(const id<Dims> &i, const range<Dims> &r) {
+        size_t idx = 0;
+        for (int d = 0; d < Dims; ++d) idx = idx * r[d] + i[d];
+        return idx;
+    }
+}
+
+// Work-items of an nd_range.
+//
+// All work-items of a work-group are executed sequentially by a single worker, so work-group local memory can be used
+// as per-group scratch space. Group barriers are NOT supported; kernels that need work-items to synchronize should use
+// the hierarchical form (handler::parallel_for_work_group), where each parallel_for_work_item call completes before
+// the next begins.
+template <int Dims>
+class nd_item {
+    id<Dims> global_id;
+    id<Dims> local_id;
+    id<Dims> group_id;
+    nd_range<Dims> r;
+
+public:
+    nd_item(nd_range<Dims> r_val, id<Dims> global_val, id<Dims> local_val, id<Dims> group_val)
+        : global_id(global_val), local_id(local_val), group_id(group_val), r(r_val) {}
+
+    id<Dims> get_global_id() const { return global_id; }
+    size_t get_global_id(int d) const { return global_id[d]; }
+    size_t get_global_linear_id() const { return detail::linearize(global_id, r.get_global_range()); }
+
+    id<Dims> get_local_id() const { return local_id; }
+    size_t get_local_id(int d) const { return local_id[d]; }
+    size_t get_local_linear_id() const { return detail::linearize(local_id, r.get_local_range()); }
+
+    size_t get_group(int d) const { return group_id[d]; }
+    size_t get_group_linear_id() const { return detail::linearize(group_id, r.get_group_range()); }
+
+    range<Dims> get_global_range() const { return r.get_global_range(); }
+    range<Dims> get_local_range() const { return r.get_local_range(); }
+    range<Dims> get_group_range() const { return r.get_group_range(); }
+    nd_range<Dims> get_nd_range() const { return r; }
+
+    void barrier() const {
+        throw std::logic_error("Work-group barriers are not supported by the SYCL fallback; use parallel_for_work_group instead");
+    }
+};
+
+// A work-item within a hierarchical work-group.
+template <int Dims>
+class h_item {
+    id<Dims> global_id;
+    id<Dims> local_id;
+    range<Dims> global_r;
+    range<Dims> local_r;
+
+public:
+    h_item(id<Dims> global_val, id<Dims> local_val, range<Dims> global_range, range<Dims> local_range)
+        : global_id(global_val), local_id(local_val), global_r(global_range), local_r(local_range) {}
+
+    id<Dims> get_global_id() const { return global_id; }
+    size_t get_global_id(int d) const { return global_id[d]; }
+    id<Dims> get_local_id() const { return local_id; }
+    size_t get_local_id(int d) const { return local_id[d]; }
+    range<Dims> get_global_range() const { return global_r; }
+    range<Dims> get_local_range() const { return local_r; }
+};
+
+// A work-group of the hierarchical form. Variables declared in the work-group scope act as work-group local memory,
+// and each parallel_for_work_item call acts as a barrier.
+template <int Dims>
+class group {
+    id<Dims> group_id;
+    range<Dims> group_r;
+    range<Dims> local_r;
+
+public:
+    group(id<Dims> group_val, range<Dims> group_range, range<Dims> local_range)
+        : group_id(group_val), group_r(group_range), local_r(local_range) {}
+
+    id<Dims> get_group_id() const { return group_id; }
+    size_t get_group_id(int d) const { return group_id[d]; }
+    size_t get_group_linear_id() const { return detail::linearize(group_id, group_r); }
+    range<Dims> get_group_range() const { return group_r; }
+    range<Dims> get_local_range() const { return local_r; }
+
+    template <typename Func>
+    void parallel_for_work_item(Func f) const {
+        range<Dims> global_r = group_r;
+        for (int d = 0; d < Dims; ++d) global_r.dims[d] = group_r[d] * local_r[d];
+
+        std::array<size_t, Dims> local{};
+        std::array<size_t, Dims> global{};
+        for (int d = 0; d < Dims; ++d) global[d] = group_id[d] * local_r[d];
+        if (local_r.size() == 0) return;
+        while (true) {
+            f(h_item<Dims>(id<Dims>(global), id<Dims>(local), global_r, local_r));
+
+            // Advance the local index in row-major order.
+            int d = Dims - 1;
+            for (; 0 <= d; --d) {
+                ++local[d];
+                ++global[d];
+                if (local[d] < local_r[d]) break;
+                global[d] -= local[d];
+                local[d] = 0;
+            }
+            if (d < 0) break;
+        }
+    }
+};
+
+
+// =============================================================================
+// Reductions
+// =============================================================================
+
+template <typename T = void>
+struct plus {
+    T operator()(const T &a, const T &b) const { return a + b; }
+};
+template <>
+struct plus<void> {
+    template <typename T, typename U>
+    auto operator()(const T &a, const U &b) const { return a + b; }
+};
+
+template <typename T = void>
+struct multiplies {
+    T operator()(const T &a, const T &b) const { return a * b; }
+};
+template <>
+struct multiplies<void> {
+    template <typename T, typename U>
+    auto operator()(const T &a, const U &b) const { return a * b; }
+};
+
+template <typename T = void>
+struct minimum {
+    T operator()(const T &a, const T &b) const { return (b < a) ? b : a; }
+};
+template <>
+struct minimum<void> {
+    template <typename T>
+    T operator()(const T &a, const T &b) const { return (b < a) ? b : a; }
+};
+
+template <typename T = void>
+struct maximum {
+    T operator()(const T &a, const T &b) const { return (a < b) ? b : a; }
+};
+template <>
+struct maximum<void> {
+    template <typename T>
+    T operator()(const T &a, const T &b) const { return (a < b) ? b : a; }
+};
+
+namespace detail {
+    template <typename Op, template <typename> class Family>
+    struct is_family : std::false_type {};
+    template <template <typename> class Family, typename U>
+    struct is_family<Family<U>, Family> : std::true_type {};
+}
+
+template <typename BinaryOperation, typename T>
+struct has_known_identity
+    : std::bool_constant< std::is_arithmetic_v<T>
+                       && ( detail::is_family<BinaryOperation, plus>::value
+                         || detail::is_family<BinaryOperation, multiplies>::value
+                         || detail::is_family<BinaryOperation, minimum>::value
+                         || detail::is_family<BinaryOperation, maximum>::value ) > {};
+
+template <typename BinaryOperation, typename T>
+struct known_identity {
+    static constexpr T compute() {
+        if constexpr (detail::is_family<BinaryOperation, multiplies>::value) {
+            return T(1);
+        } else if constexpr (detail::is_family<BinaryOperation, minimum>::value) {
+            return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                        : std::numeric_limits<T>::max();
+        } else if constexpr (detail::is_family<BinaryOperation, maximum>::value) {
+            return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                        : std::numeric_limits<T>::lowest();
+        }
+        return T(0);
+    }
+    static constexpr T value = compute();
+};
+
+namespace property {
+    namespace reduction {
+        // Discard the original value of the reduction variable instead of combining it with the result.
+        struct initialize_to_identity {};
+    }
+}
+
+class property_list {
+    bool init_to_identity = false;
+
+public:
+    property_list() = default;
+    property_list(property::reduction::initialize_to_identity) : init_to_identity(true) {}
+
+    template <typename Property>
+    bool has_property() const {
+        if constexpr (std::is_same_v<Property, property::reduction::initialize_to_identity>) {
+            return init_to_identity;
+        }
+        return false;
+    }
+};
+
+// The per-worker view of a reduction variable that is passed to kernels.
+template <typename T, typename BinaryOperation>
+class reducer {
+    T value;
+    BinaryOperation combiner;
+
+    template <typename, typename> friend struct reduction_descriptor;
+
+public:
+    reducer(const T &identity_val, BinaryOperation op) : value(identity_val), combiner(op) {}
+    reducer(const reducer &) = delete;
+    reducer(reducer &&) = default;
+    reducer &operator=(const reducer &) = delete;
+
+    reducer &combine(const T &v) {
+        value = combiner(value, v);
+        return *this;
+    }
+
+    template <typename Op = BinaryOperation, std::enable_if_t<detail::is_family<Op, plus>::value, int> = 0>
+    reducer &operator+=(const T &v) { return this->combine(v); }
+
+    template <typename Op = BinaryOperation, std::enable_if_t<detail::is_family<Op, plus>::value, int> = 0>
+    reducer &operator++() { return this->combine(T(1)); }
+
+    template <typename Op = BinaryOperation, std::enable_if_t<detail::is_family<Op, multiplies>::value, int> = 0>
+    reducer &operator*=(const T &v) { return this->combine(v); }
+};
+
+// A reduction variable, as created by sycl::reduction. Only USM (pointer) reduction variables are supported.
+template <typename T, typename BinaryOperation>
+struct reduction_descriptor {
+    using value_type = T;
+    using reducer_type = reducer<T, BinaryOperation>;
+
+    T *var;
+    T identity;
+    BinaryOperation combiner;
+    bool initialize_to_identity;
+
+    reducer_type make_reducer() const { return reducer_type(identity, combiner); }
+    static const T &partial(const reducer_type &r) { return r.value; }
+};
+
+template <typename T, typename BinaryOperation>
+reduction_descriptor<T, BinaryOperation>
+reduction(T *var, BinaryOperation combiner, const property_list &props = {}) {
+    static_assert(has_known_identity<BinaryOperation, T>::value,
+                  "An identity must be provided for reductions with this combiner");
+    return { var, known_identity<BinaryOperation, T>::value, combiner,
+             props.has_property<property::reduction::initialize_to_identity>() };
+}
+
+template <typename T, typename BinaryOperation>
+reduction_descriptor<T, BinaryOperation>
+reduction(T *var, const T &identity, BinaryOperation combiner, const property_list &props = {}) {
+    return { var, identity, combiner, props.has_property<property::reduction::initialize_to_identity>() };
+}
+
+
 // =============================================================================
 // Execution Model: handler, queue
 // =============================================================================
 
+namespace detail {
+
+    template <typename T>
+    struct is_reduction_descriptor : std::false_type {};
+    template <typename T, typename BinaryOperation>
+    struct is_reduction_descriptor<reduction_descriptor<T, BinaryOperation>> : std::true_type {};
+
+    // The index of the worker executing the current kernel within its launch. Used to locate work-group local memory.
+    inline thread_local size_t current_participant = 0;
+
+    // Whether the current thread is executing a kernel. Nested launches are executed inline by the calling worker.
+    inline thread_local bool inside_kernel = false;
+
+    // Work-group local memory, with one block per worker of a launch.
+    class local_memory_base {
+    public:
+        virtual ~local_memory_base() = default;
+        virtual void allocate(size_t participants) = 0;
+    };
+
+    // A contiguous run of tiles [begin, end) owned by one worker. The bounds are packed into a single word so the owner
+    // (taking tiles from the front) and thieves (taking the back half) can update them with compare-and-swap. Tiles
+    // are never returned, so a packed value with tiles remaining is never reused.
+    class alignas(64) tile_span {
+        std::atomic<uint64_t> span{0};
+
+        static uint64_t pack(uint64_t b, uint64_t e) { return (b << 32) | e; }
+
+    public:
+        void reset(uint64_t b, uint64_t e) { span.store(pack(b, e), std::memory_order_release); }
+
+        bool pop(uint64_t &tile) {
+            uint64_t s = span.load(std::memory_order_acquire);
+            while (true) {
+                const uint64_t b = s >> 32;
+                const uint64_t e = s & 0xFFFFFFFFULL;
+                if (e <= b) return false;
+                if (span.compare_exchange_weak(s, pack(b + 1, e), std::memory_order_acq_rel)) {
+                    tile = b;
+                    return true;
+                }
+            }
+        }
+
+        bool steal(uint64_t &stolen_b, uint64_t &stolen_e) {
+            uint64_t s = span.load(std::memory_order_acquire);
+            while (true) {
+                const uint64_t b = s >> 32;
+                const uint64_t e = s & 0xFFFFFFFFULL;
+                if (e <= b) return false;
+                const uint64_t mid = b + (e - b) / 2;
+                if (span.compare_exchange_weak(s, pack(b, mid), std::memory_order_acq_rel)) {
+                    stolen_b = mid;
+                    stolen_e = e;
+                    return true;
+                }
+            }
+        }
+    };
+
+    // The shared state of a launch. Workers that start after all tiles have been claimed find no work and exit without
+    // touching the (possibly expired) kernel.
+    struct launch_state {
+        size_t participants = 1;
+        size_t total = 0;
+        std::unique_ptr<tile_span[]> spans;
+        std::function<void(size_t)> body;
+
+        std::atomic<size_t> completed{0};
+        std::atomic<bool> cancelled{false};
+        std::mutex m;
+        std::condition_variable cv;
+        std::exception_ptr error = nullptr;
+
+        void participate(size_t p) {
+            const auto prev_participant = current_participant;
+            const auto prev_inside = inside_kernel;
+            current_participant = p;
+            inside_kernel = true;
+
+            size_t n_done = 0;
+            uint64_t tile = 0;
+            while (true) {
+                while (spans[p].pop(tile)) {
+                    if (!cancelled.load(std::memory_order_relaxed)) {
+                        try {
+                            body(static_cast<size_t>(tile));
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(m);
+                            if (!error) error = std::current_exception();
+                            cancelled.store(true);
+                        }
+                    }
+                    ++n_done;
+                }
+
+                // Steal half of the remaining tiles from the first worker found to have any.
+                bool stolen = false;
+                for (size_t i = 1; (i < participants) && !stolen; ++i) {
+                    uint64_t b = 0;
+                    uint64_t e = 0;
+                    if (spans[(p + i) % participants].steal(b, e)) {
+                        spans[p].reset(b, e);
+                        stolen = true;
+                    }
+                }
+                if (!stolen) break;
+            }
+
+            current_participant = prev_participant;
+            inside_kernel = prev_inside;
+            if ((0 < n_done) && ((completed.fetch_add(n_done) + n_done) == total)) {
+                std::lock_guard<std::mutex> lock(m);
+                cv.notify_all();
+            }
+        }
+    };
+
+    // Partitioning of an iteration space into tiles. The space is viewed as 'rows' rows of 'inner' contiguous items,
+    // where rows span all but the last dimension. Tiles hold whole rows when there are enough of them, and otherwise
+    // split rows into segments, so items within a tile can be visited without any per-item division.
+    struct row_tiling {
+        size_t rows = 0;
+        size_t inner = 0;
+        size_t rows_per_tile = 1;
+        size_t segment = 1;
+        size_t segments = 1;
+        size_t tiles = 0;
+
+        row_tiling(size_t rows_val, size_t inner_val, size_t desired_tiles)
+            : rows(rows_val), inner(inner_val) {
+            if ((rows == 0) || (inner == 0)) return;
+            desired_tiles = std::max<size_t>(desired_tiles, 1U);
+            if (desired_tiles <= rows) {
+                this->rows_per_tile = (rows + desired_tiles - 1) / desired_tiles;
+                this->segment = inner;
+                this->segments = 1;
+            } else {
+                this->rows_per_tile = 1;
+                const size_t wanted = std::min(inner, (desired_tiles + rows - 1) / rows);
+                this->segment = (inner + wanted - 1) / wanted;
+                this->segments = (inner + this->segment - 1) / this->segment;
+            }
+            this->tiles = ((rows + this->rows_per_tile - 1) / this->rows_per_tile) * this->segments;
+        }
+
+        // Visit f(id) for every index of the tile in row-major order.
+        template <int Dims, typename Func>
+        void for_each(const range<Dims> &r, size_t tile, Func &&f) const {
+            const size_t row_b = (tile / this->segments) * this->rows_per_tile;
+            const size_t row_e = std::min(this->rows, row_b + this->rows_per_tile);
+            const size_t col_b = (tile % this->segments) * this->segment;
+            const size_t col_e = std::min(this->inner, col_b + this->segment);
+
+            if constexpr (Dims == 1) {
+                for (size_t k = col_b; k < col_e; ++k) f(id<1>(k));
+            } else if constexpr (Dims == 2) {
+                for (size_t i = row_b; i < row_e; ++i) {
+                    for (size_t k = col_b; k < col_e; ++k) f(id<2>(i, k));
+                }
+            } else {
+                static_assert(Dims == 3, "Only 1-3 dimensional ranges are supported");
+                size_t i = row_b / r[1];
+                size_t j = row_b % r[1];
+                for (size_t row = row_b; row < row_e; ++row) {
+                    for (size_t k = col_b; k < col_e; ++k) f(id<3>(i, j, k));
+                    if (++j == r[1]) {
+                        j = 0;
+                        ++i;
+                    }
+                }
+            }
+        }
+    };
+
+    template <int Dims>
+    row_tiling make_tiling(const range<Dims> &r, size_t desired_tiles) {
+        return row_tiling(r.size() / std::max<size_t>(r[Dims - 1], 1U), r[Dims - 1], desired_tiles);
+    }
+
+    // Invoke a kernel with either an item or an id, followed by any reducers.
+    template <int Dims, typename Func, typename... Reducers>
+    void invoke_kernel(Func &kernel, const range<Dims> &r, const id<Dims> &idx, Reducers &... reducers) {
+        if constexpr (std::is_invocable_v<Func &, item<Dims>, Reducers &...>) {
+            kernel(item<Dims>(r, idx), reducers...);
+        } else {
+            kernel(idx, reducers...);
+        }
+    }
+
+    template <size_t I, typename Partials, typename Reduction>
+    void finalize_reduction(const Partials &partials, Reduction &red) {
+        auto acc = red.identity;
+        for (const auto &p : partials) acc = red.combiner(acc, std::get<I>(p));
+        *red.var = red.initialize_to_identity ? acc : red.combiner(*red.var, acc);
+    }
+
+    template <typename Partials, size_t... Is, typename... Reductions>
+    void finalize_reductions(const Partials &partials, std::index_sequence<Is...>, Reductions &... reds) {
+        (finalize_reduction<Is>(partials, reds), ...);
+    }
+
+} // namespace detail
+
+// Command group handler.
+//
+// Kernels are executed on the CPU. The iteration space is divided into tiles (many more than there are workers), and
+// each worker begins with a contiguous share of the tiles. Workers that run out of tiles steal half of the remaining
+// tiles from another worker, so uneven kernels stay balanced. Reductions are accumulated per tile and combined in tile
+// order, so results do not depend on scheduling.
 class handler {
     work_queue<std::function<void(void)>>* task_queue = nullptr;
     size_t worker_hint = 1;
+    std::vector<std::shared_ptr<detail::local_memory_base>> local_memory;
 
-    template <typename Submitter>
-    void run_chunks(size_t total_work_items, Submitter submitter){
-        constexpr size_t chunks_per_worker = 4U;
-        if(total_work_items == 0){
-            return;
-        }
+    // The number of tiles to create per worker. More tiles improve balance but add scheduling overhead.
+    static constexpr size_t tiles_per_worker = 16U;
+
+    size_t desired_tiles() const {
+        return std::max<size_t>(this->worker_hint, 1U) * tiles_per_worker;
+    }
 
-        const size_t desired_chunks = std::min(total_work_items, std::max<size_t>(worker_hint * chunks_per_worker, 1U));
-        if((task_queue == nullptr) || (desired_chunks <= 1U)){
-            submitter(0U, total_work_items);
+    // Execute body(tile) for every tile, returning once all tiles have completed.
+    void run_tiles(size_t n_tiles, const std::function<void(size_t)> &body) {
+        if (n_tiles == 0) {
             return;
         }
 
-        std::mutex completion_mutex;
-        std::condition_variable completion_cv;
-        size_t completed_chunks = 0;
-        std::mutex exception_mutex;
-        std::exception_ptr captured_exception = nullptr;
-
-        for(size_t chunk = 0; chunk < desired_chunks; ++chunk){
-            const size_t begin = (total_work_items * chunk) / desired_chunks;
-            const size_t end = (total_work_items * (chunk + 1U)) / desired_chunks;
-            if(begin >= end){
-                std::lock_guard<std::mutex> lock(completion_mutex);
-                ++completed_chunks;
-                continue;
+        const size_t participants = std::min(n_tiles, std::max<size_t>(this->worker_hint, 1U));
+        for (auto &m : this->local_memory) m->allocate(participants);
+
+        // Run inline when there is nothing to parallelize, or from within a kernel, since the workers might all be
+        // occupied by the enclosing launch.
+        if ((this->task_queue == nullptr) || (participants <= 1U) || detail::inside_kernel) {
+            const auto prev_participant = detail::current_participant;
+            const auto prev_inside = detail::inside_kernel;
+            detail::current_participant = 0;
+            detail::inside_kernel = true;
+            try {
+                for (size_t t = 0; t < n_tiles; ++t) body(t);
+            } catch (...) {
+                detail::current_participant = prev_participant;
+                detail::inside_kernel = prev_inside;
+                throw;
             }
+            detail::current_participant = prev_participant;
+            detail::inside_kernel = prev_inside;
+            return;
+        }
+        if (static_cast<uint64_t>(0xFFFFFFFFULL) < static_cast<uint64_t>(n_tiles)) {
+            throw std::length_error("Too many tiles for the SYCL fallback scheduler");
+        }
 
-            task_queue->submit_task([&, begin, end](){
-                try{
-                    submitter(begin, end);
-                }catch(...){
-                    std::lock_guard<std::mutex> lock(exception_mutex);
-                    if(!captured_exception){
-                        captured_exception = std::current_exception();
-                    }
-                }
-                std::lock_guard<std::mutex> lock(completion_mutex);
-                ++completed_chunks;
-                completion_cv.notify_one();
+        auto state = std::make_shared<detail::launch_state>();
+        state->participants = participants;
+        state->total = n_tiles;
+        state->body = body;
+        state->spans = std::make_unique<detail::tile_span[]>(participants);
+        for (size_t p = 0; p < participants; ++p) {
+            state->spans[p].reset((n_tiles * p) / participants, (n_tiles * (p + 1U)) / participants);
+        }
+        for (size_t p = 0; p < participants; ++p) {
+            this->task_queue->submit_task([state, p]() {
+                state->participate(p);
             });
         }
 
-        std::unique_lock<std::mutex> lock(completion_mutex);
-        completion_cv.wait(lock, [&](){ return completed_chunks == desired_chunks; });
+        std::unique_lock<std::mutex> lock(state->m);
+        state->cv.wait(lock, [&]() { return state->completed.load() == state->total; });
+        const auto error = std::move(state->error);
+        state->error = nullptr;
         lock.unlock();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
 
-        if(captured_exception){
-            std::rethrow_exception(captured_exception);
+    template <int Dims, typename Func, typename... Reductions>
+    void launch(const range<Dims> &r, Func &kernel, Reductions &... reds) {
+        static_assert((detail::is_reduction_descriptor<std::decay_t<Reductions>>::value && ...),
+                      "Only sycl::reduction arguments may precede the kernel");
+        const auto tiling = detail::make_tiling(r, this->desired_tiles());
+
+        if constexpr (sizeof...(Reductions) == 0) {
+            this->run_tiles(tiling.tiles, [&](size_t t) {
+                tiling.for_each(r, t, [&](const id<Dims> &idx) {
+                    detail::invoke_kernel(kernel, r, idx);
+                });
+            });
+        } else {
+            using partial_t = std::tuple<typename std::decay_t<Reductions>::value_type...>;
+            std::vector<partial_t> partials(tiling.tiles, partial_t(reds.identity...));
+            this->run_tiles(tiling.tiles, [&](size_t t) {
+                std::tuple<typename std::decay_t<Reductions>::reducer_type...> reducers(reds.make_reducer()...);
+                tiling.for_each(r, t, [&](const id<Dims> &idx) {
+                    std::apply([&](auto &... rs) { detail::invoke_kernel(kernel, r, idx, rs...); }, reducers);
+                });
+                partials[t] = std::apply([](const auto &... rs) {
+                    return partial_t(std::decay_t<Reductions>::partial(rs)...);
+                }, reducers);
+            });
+            detail::finalize_reductions(partials, std::index_sequence_for<Reductions...>{}, reds...);
         }
     }
 
+    template <int Dims, typename Func, typename... Reductions>
+    void launch(const nd_range<Dims> &ndr, Func &kernel, Reductions &... reds) {
+        static_assert((detail::is_reduction_descriptor<std::decay_t<Reductions>>::value && ...),
+                      "Only sycl::reduction arguments may precede the kernel");
+        const auto local_r = ndr.get_local_range();
+        for (int d = 0; d < Dims; ++d) {
+            if ((local_r[d] == 0) || ((ndr.global[d] % local_r[d]) != 0)) {
+                throw std::invalid_argument("Global range must be divisible by a non-zero local range");
+            }
+        }
+        const auto group_r = ndr.get_group_range();
+        const auto tiling = detail::make_tiling(group_r, this->desired_tiles());
+
+        // Visit every work-item of every work-group within the tile, one work-group at a time.
+        const auto visit = [&](size_t t, auto &&f) {
+            tiling.for_each(group_r, t, [&](const id<Dims> &group_id) {
+                const range<Dims> one_group = local_r;
+                detail::make_tiling(one_group, 1U).for_each(one_group, 0U, [&](const id<Dims> &local_id) {
+                    std::array<size_t, Dims> global{};
+                    for (int d = 0; d < Dims; ++d) global[d] = group_id[d] * local_r[d] + local_id[d];
+                    f(nd_item<Dims>(ndr, id<Dims>(global), local_id, group_id));
+                });
+            });
+        };
+
+        if constexpr (sizeof...(Reductions) == 0) {
+            this->run_tiles(tiling.tiles, [&](size_t t) {
+                visit(t, [&](const nd_item<Dims> &it) { kernel(it); });
+            });
+        } else {
+            using partial_t = std::tuple<typename std::decay_t<Reductions>::value_type...>;
+            std::vector<partial_t> partials(tiling.tiles, partial_t(reds.identity...));
+            this->run_tiles(tiling.tiles, [&](size_t t) {
+                std::tuple<typename std::decay_t<Reductions>::reducer_type...> reducers(reds.make_reducer()...);
+                visit(t, [&](const nd_item<Dims> &it) {
+                    std::apply([&](auto &... rs) { kernel(it, rs...); }, reducers);
+                });
+                partials[t] = std::apply([](const auto &... rs) {
+                    return partial_t(std::decay_t<Reductions>::partial(rs)...);
+                }, reducers);
+            });
+            detail::finalize_reductions(partials, std::index_sequence_for<Reductions...>{}, reds...);
+        }
+    }
+
+    // Separate the trailing kernel from the leading reductions.
+    template <typename Range, typename... Rest>
+    void dispatch(const Range &r, Rest &&... rest) {
+        static_assert(0 < sizeof...(Rest), "A kernel is required");
+        auto args = std::forward_as_tuple(std::forward<Rest>(rest)...);
+        this->dispatch_split(r, args, std::make_index_sequence<sizeof...(Rest) - 1>{});
+    }
+
+    template <typename Range, typename Args, size_t... Is>
+    void dispatch_split(const Range &r, Args &args, std::index_sequence<Is...>) {
+        auto &kernel = std::get<sizeof...(Is)>(args);
+        this->launch(r, kernel, std::get<Is>(args)...);
+    }
+
 public:
     handler() = default;
 
@@ -284,61 +894,88 @@ public:
         // No-op in synchronous CPU fallback
     }
 
+    // Used by local_accessor to request work-group local memory for the next launch.
+    void register_local_memory(std::shared_ptr<detail::local_memory_base> m) {
+        this->local_memory.emplace_back(std::move(m));
+    }
+
     // --- PARALLEL FOR IMPLEMENTATIONS ---
+    //
+    // The kernel is the final argument, and may be preceded by sycl::reduction arguments. Kernels accept an id or item
+    // (or an nd_item for nd_ranges), followed by one reducer per reduction.
 
-    // 1D
-    template <typename KernelName = void, typename Func>
-    void parallel_for(range<1> r, Func kernel) {
-        this->run_chunks(r[0], [&](size_t begin, size_t end){
-            for (size_t i = begin; i < end; ++i) {
-                if constexpr (std::is_invocable_v<Func, item<1>>) {
-                    kernel(item<1>(r, id<1>(i)));
-                } else {
-                    kernel(id<1>(i));
-                }
-            }
-        });
+    template <typename KernelName = void, typename... Rest>
+    void parallel_for(range<1> r, Rest &&... rest) {
+        this->dispatch(r, std::forward<Rest>(rest)...);
+    }
+    template <typename KernelName = void, typename... Rest>
+    void parallel_for(range<2> r, Rest &&... rest) {
+        this->dispatch(r, std::forward<Rest>(rest)...);
+    }
+    template <typename KernelName = void, typename... Rest>
+    void parallel_for(range<3> r, Rest &&... rest) {
+        this->dispatch(r, std::forward<Rest>(rest)...);
+    }
+    template <typename KernelName = void, int Dims, typename... Rest>
+    void parallel_for(nd_range<Dims> r, Rest &&... rest) {
+        this->dispatch(r, std::forward<Rest>(rest)...);
     }
 
-    // 2D
-    template <typename KernelName = void, typename Func>
-    void parallel_for(range<2> r, Func kernel) {
-        const size_t total = r[0] * r[1];
-        this->run_chunks(total, [&](size_t begin, size_t end){
-            for (size_t linear = begin; linear < end; ++linear) {
-                const size_t i = linear / r[1];
-                const size_t j = linear % r[1];
-                id<2> idx(i, j);
-                if constexpr (std::is_invocable_v<Func, item<2>>) {
-                    kernel(item<2>(r, idx));
-                } else {
-                    kernel(idx);
-                }
-            }
+    // Hierarchical parallelism. The kernel is invoked once per work-group with a sycl::group.
+    template <typename KernelName = void, int Dims, typename Func>
+    void parallel_for_work_group(range<Dims> n_groups, range<Dims> group_size, Func kernel) {
+        const auto tiling = detail::make_tiling(n_groups, this->desired_tiles());
+        this->run_tiles(tiling.tiles, [&](size_t t) {
+            tiling.for_each(n_groups, t, [&](const id<Dims> &group_id) {
+                kernel(group<Dims>(group_id, n_groups, group_size));
+            });
         });
     }
+    template <typename KernelName = void, int Dims, typename Func>
+    void parallel_for_work_group(range<Dims> n_groups, Func kernel) {
+        range<Dims> group_size = n_groups;
+        for (int d = 0; d < Dims; ++d) group_size.dims[d] = 1;
+        this->parallel_for_work_group<KernelName>(n_groups, group_size, kernel);
+    }
+};
 
-    // 3D
-    template <typename KernelName = void, typename Func>
-    void parallel_for(range<3> r, Func kernel) {
-        const size_t row_size = r[2];
-        const size_t plane_size = r[1] * r[2];
-        const size_t total = r[0] * plane_size;
-        this->run_chunks(total, [&](size_t begin, size_t end){
-            for (size_t linear = begin; linear < end; ++linear) {
-                const size_t i = linear / plane_size;
-                const size_t rem = linear % plane_size;
-                const size_t j = rem / row_size;
-                const size_t k = rem % row_size;
-                id<3> idx(i, j, k);
-                if constexpr (std::is_invocable_v<Func, item<3>>) {
-                    kernel(item<3>(r, idx));
-                } else {
-                    kernel(idx);
-                }
-            }
-        });
+// Work-group local memory. Within a kernel, each work-group sees its own block, which is reused by subsequent
+// work-groups on the same worker and is not initialized.
+template <typename T, int Dims = 1>
+class local_accessor {
+    struct storage : detail::local_memory_base {
+        size_t count = 0;
+        std::vector<std::vector<T>> blocks;
+
+        void allocate(size_t participants) override {
+            this->blocks.assign(participants, std::vector<T>(this->count));
+        }
+    };
+
+    std::shared_ptr<storage> mem;
+    range<Dims> r;
+
+public:
+    local_accessor(range<Dims> r_val, handler &h) : mem(std::make_shared<storage>()), r(r_val) {
+        this->mem->count = r_val.size();
+        h.register_local_memory(this->mem);
+    }
+
+    T* get_pointer() const {
+        return this->mem->blocks.at(detail::current_participant).data();
     }
+
+    T& operator[](size_t index) const {
+        return this->get_pointer()[index];
+    }
+    T& operator[](id<Dims> index) const {
+        size_t idx = 0;
+        for (int d = 0; d < Dims; ++d) idx = idx * r[d] + index[d];
+        return this->get_pointer()[idx];
+    }
+
+    range<Dims> get_range() const { return r; }
+    size_t size() const { return r.size(); }
 };
 
 class queue {
@@ -375,20 +1012,25 @@ public:
         // No-op: execution is already done and no async backend exists.
     }
 
-    template <typename Func>
-    void parallel_for(range<1> r, Func kernel){
+    template <typename KernelName = void, typename... Rest>
+    void parallel_for(range<1> r, Rest &&... rest){
         handler h(this->task_queue.get(), this->worker_count);
-        h.parallel_for(r, kernel);
+        h.parallel_for<KernelName>(r, std::forward<Rest>(rest)...);
     }
-    template <typename Func>
-    void parallel_for(range<2> r, Func kernel){
+    template <typename KernelName = void, typename... Rest>
+    void parallel_for(range<2> r, Rest &&... rest){
         handler h(this->task_queue.get(), this->worker_count);
-        h.parallel_for(r, kernel);
+        h.parallel_for<KernelName>(r, std::forward<Rest>(rest)...);
     }
-    template <typename Func>
-    void parallel_for(range<3> r, Func kernel){
+    template <typename KernelName = void, typename... Rest>
+    void parallel_for(range<3> r, Rest &&... rest){
+        handler h(this->task_queue.get(), this->worker_count);
+        h.parallel_for<KernelName>(r, std::forward<Rest>(rest)...);
+    }
+    template <typename KernelName = void, int Dims, typename... Rest>
+    void parallel_for(nd_range<Dims> r, Rest &&... rest){
         handler h(this->task_queue.get(), this->worker_count);
-        h.parallel_for(r, kernel);
+        h.parallel_for<KernelName>(r, std::forward<Rest>(rest)...);
     }
 
     // Other helpers
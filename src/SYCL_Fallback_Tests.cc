@@ -7,6 +7,9 @@
 #include <set>
 #include <mutex>
 #include <thread>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
 
 #include "doctest20251212/doctest.h"
 
@@ -194,3 +197,203 @@ TEST_CASE("SYCL Sampled Image Nearest and Linear Modes") {
     sycl::sampled_image<float, 3> linear_img(data.data(), 2, 2, 1, 1, linear_sampler);
     CHECK(linear_img.read(0.5, 0.5, 0.0).x == doctest::Approx(15.0f));
 }
+
+TEST_CASE("SYCL Tiled Iteration Visits Each Index Exactly Once") {
+    work_queue<std::function<void(void)>> pool(4U);
+    sycl::handler h(&pool, 4U);
+
+    for(const auto &r : { sycl::range<3>(3, 5, 7), sycl::range<3>(1, 1, 1000), sycl::range<3>(1000, 1, 1), sycl::range<3>(2, 0, 3) }){
+        std::vector<std::atomic<int>> counts(r.size());
+        for(auto &v : counts) v.store(0);
+        h.parallel_for(r, [&](sycl::id<3> idx) {
+            counts[(idx[0] * r[1] + idx[1]) * r[2] + idx[2]].fetch_add(1);
+        });
+        size_t n_incorrect = 0;
+        for(const auto &v : counts) n_incorrect += (v.load() == 1) ? 0U : 1U;
+        CHECK(n_incorrect == 0U);
+    }
+
+    const size_t rows = 3;
+    const size_t cols = 517;
+    std::vector<std::atomic<int>> counts(rows * cols);
+    for(auto &v : counts) v.store(0);
+    h.parallel_for(sycl::range<2>(rows, cols), [&](sycl::item<2> it) {
+        counts[it.get_linear_id()].fetch_add(1);
+    });
+    size_t n_incorrect = 0;
+    for(const auto &v : counts) n_incorrect += (v.load() == 1) ? 0U : 1U;
+    CHECK(n_incorrect == 0U);
+}
+
+TEST_CASE("SYCL Reductions") {
+    work_queue<std::function<void(void)>> pool(4U);
+    sycl::handler h(&pool, 4U);
+    const size_t N = 10000;
+
+    SUBCASE("the original value is combined unless initialize_to_identity is requested"){
+        int64_t sum = 5;
+        h.parallel_for(sycl::range<1>(N), sycl::reduction(&sum, sycl::plus<int64_t>()), [=](sycl::id<1> i, auto &r) {
+            r += static_cast<int64_t>(i[0]);
+        });
+        CHECK(sum == static_cast<int64_t>(5 + N * (N - 1) / 2));
+
+        h.parallel_for(sycl::range<1>(N),
+                       sycl::reduction(&sum, sycl::plus<>(), { sycl::property::reduction::initialize_to_identity() }),
+                       [=](sycl::id<1>, auto &r) {
+            ++r;
+        });
+        CHECK(sum == static_cast<int64_t>(N));
+    }
+
+    SUBCASE("multiple reductions over a 3D range"){
+        double lo = 0.0;
+        double hi = 0.0;
+        int64_t count = 0;
+        h.parallel_for(sycl::range<3>(7, 11, 13),
+                       sycl::reduction(&lo, sycl::minimum<double>(), { sycl::property::reduction::initialize_to_identity() }),
+                       sycl::reduction(&hi, sycl::maximum<double>(), { sycl::property::reduction::initialize_to_identity() }),
+                       sycl::reduction(&count, sycl::plus<int64_t>()),
+                       [=](sycl::id<3> i, auto &r_lo, auto &r_hi, auto &r_count) {
+            const double v = static_cast<double>(i[0]) - static_cast<double>(i[1]) * static_cast<double>(i[2]);
+            r_lo.combine(v);
+            r_hi.combine(v);
+            r_count += 1;
+        });
+        CHECK(lo == doctest::Approx(-120.0));
+        CHECK(hi == doctest::Approx(6.0));
+        CHECK(count == 7 * 11 * 13);
+    }
+
+    SUBCASE("custom combiners with an explicit identity"){
+        uint32_t bits = 0;
+        h.parallel_for(sycl::range<1>(32), sycl::reduction(&bits, 0U, [](uint32_t a, uint32_t b){ return a | b; }),
+                       [=](sycl::id<1> i, auto &r) {
+            r.combine(static_cast<uint32_t>(1U) << i[0]);
+        });
+        CHECK(bits == 0xFFFFFFFFU);
+    }
+
+    SUBCASE("floating-point results do not depend on scheduling"){
+        std::vector<float> data(N);
+        for(size_t i = 0; i < N; ++i) data[i] = 1.0f / static_cast<float>(i + 1);
+        const auto sum_once = [&]() {
+            float sum = 0.0f;
+            h.parallel_for(sycl::range<1>(N), sycl::reduction(&sum, sycl::plus<float>()), [&](sycl::id<1> i, auto &r) {
+                r += data[i[0]];
+            });
+            return sum;
+        };
+        const float first = sum_once();
+        for(int i = 0; i < 10; ++i) CHECK(sum_once() == first);
+    }
+}
+
+TEST_CASE("SYCL nd_range With Work-Group Local Memory") {
+    work_queue<std::function<void(void)>> pool(4U);
+    const size_t rows = 8;
+    const size_t cols = 12;
+    std::vector<int> ids(rows * cols, -1);
+    std::vector<int> group_counts(6, 0);
+
+    sycl::handler h(&pool, 4U);
+    sycl::local_accessor<int, 1> scratch(sycl::range<1>(1), h);
+    h.parallel_for(sycl::nd_range<2>(sycl::range<2>(rows, cols), sycl::range<2>(4, 4)), [=, &ids, &group_counts](sycl::nd_item<2> it) {
+        const auto g = it.get_global_id();
+        ids[g[0] * cols + g[1]] = static_cast<int>(it.get_group(0) * 10 + it.get_group(1));
+
+        // Work-items of a group run sequentially on one worker, so the scratch space is private to the group.
+        if(it.get_local_linear_id() == 0) scratch[0] = 0;
+        scratch[0] += 1;
+        if(it.get_local_linear_id() + 1 == it.get_local_range().size()){
+            group_counts[it.get_group_linear_id()] = scratch[0];
+        }
+    });
+
+    CHECK(ids[0] == 0);
+    CHECK(ids[5 * cols + 9] == 12);
+    CHECK(ids[rows * cols - 1] == 12);
+    for(const auto &c : group_counts) CHECK(c == 16);
+
+    int64_t sum = 0;
+    h.parallel_for(sycl::nd_range<1>(sycl::range<1>(64), sycl::range<1>(8)), sycl::reduction(&sum, sycl::plus<int64_t>()),
+                   [=](sycl::nd_item<1> it, auto &r) {
+        r += static_cast<int64_t>(it.get_local_id(0));
+    });
+    CHECK(sum == 8 * 28);
+
+    CHECK_THROWS(h.parallel_for(sycl::nd_range<1>(sycl::range<1>(10), sycl::range<1>(4)), [=](sycl::nd_item<1>) {}));
+    CHECK_THROWS(h.parallel_for(sycl::nd_range<1>(sycl::range<1>(8), sycl::range<1>(4)), [=](sycl::nd_item<1> it) {
+        it.barrier();
+    }));
+}
+
+TEST_CASE("SYCL Hierarchical Work-Groups") {
+    work_queue<std::function<void(void)>> pool(4U);
+    sycl::handler h(&pool, 4U);
+    const size_t n_groups = 16;
+    const size_t group_size = 32;
+    std::vector<int> input(n_groups * group_size);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<int> output(n_groups * group_size, 0);
+
+    // Each work-item outputs the group sum minus its own value, which requires the first phase to complete first.
+    h.parallel_for_work_group(sycl::range<1>(n_groups), sycl::range<1>(group_size), [&](sycl::group<1> g) {
+        std::vector<int> local(group_size);
+        g.parallel_for_work_item([&](sycl::h_item<1> it) {
+            local[it.get_local_id(0)] = input[it.get_global_id(0)];
+        });
+        g.parallel_for_work_item([&](sycl::h_item<1> it) {
+            output[it.get_global_id(0)] = std::accumulate(local.begin(), local.end(), 0) - local[it.get_local_id(0)];
+        });
+    });
+
+    const int first_group_sum = static_cast<int>(group_size * (group_size - 1) / 2);
+    CHECK(output[0] == first_group_sum);
+    CHECK(output[1] == first_group_sum - 1);
+    const int last = static_cast<int>(n_groups * group_size - 1);
+    CHECK(output[last] == (first_group_sum + static_cast<int>((n_groups - 1) * group_size * group_size)) - last);
+}
+
+TEST_CASE("SYCL Uneven Kernels Are Balanced By Work Stealing") {
+    work_queue<std::function<void(void)>> pool(4U);
+    sycl::handler h(&pool, 4U);
+    const size_t N = 256;
+    std::vector<std::atomic<int>> counts(N);
+    for(auto &v : counts) v.store(0);
+    std::set<std::thread::id> thread_ids;
+    std::mutex thread_ids_mutex;
+
+    // All of the expensive items are initially assigned to the first worker.
+    h.parallel_for(sycl::range<1>(N), [&](sycl::id<1> i) {
+        if(i[0] < N / 8){
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::lock_guard<std::mutex> lock(thread_ids_mutex);
+            thread_ids.insert(std::this_thread::get_id());
+        }
+        counts[i[0]].fetch_add(1);
+    });
+
+    size_t n_incorrect = 0;
+    for(const auto &v : counts) n_incorrect += (v.load() == 1) ? 0U : 1U;
+    CHECK(n_incorrect == 0U);
+    CHECK(thread_ids.size() > 1U);
+}
+
+TEST_CASE("SYCL Kernel Exceptions And Nested Launches") {
+    work_queue<std::function<void(void)>> pool(4U);
+    sycl::handler h(&pool, 4U);
+
+    CHECK_THROWS_AS(h.parallel_for(sycl::range<1>(1000), [](sycl::id<1> i) {
+        if(i[0] == 17) throw std::runtime_error("kernel failure");
+    }), std::runtime_error);
+
+    // The handler remains usable, and kernels can launch nested kernels without exhausting the workers.
+    std::atomic<int64_t> total{0};
+    h.parallel_for(sycl::range<1>(16), [&](sycl::id<1>) {
+        sycl::handler inner(&pool, 4U);
+        inner.parallel_for(sycl::range<1>(100), [&](sycl::id<1> j) {
+            total.fetch_add(static_cast<int64_t>(j[0]));
+        });
+    });
+    CHECK(total.load() == 16 * 4950);
+}
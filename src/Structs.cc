@@ -4,14 +4,19 @@
 #include <array>
 #include <cmath>
 #include <cstdint>   //For int64_t.
+#include <exception>
 #include <optional>
 #include <functional>
 #include <initializer_list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>   //For std::pair.
 #include <vector>
 #include <variant>
@@ -32,6 +37,8 @@
 #include "Structs.h"
 #include "Tables.h"
 #include "Dose_Meld.h"
+#include "ROI_Span_Masks.h"
+#include "Thread_Pool.h"
 
 //This is a mapping from the segmentation history to a human-readable description.
 // Try avoid using commas or tabs to make dumping as csv easier. This should in
@@ -533,10 +540,18 @@ Image_Array::Image_Array(const Image_Array &rhs){
 Image_Array & Image_Array::operator=(const Image_Array &rhs){
     if(this != &rhs){
         this->imagecoll  = rhs.imagecoll;
+        std::lock_guard<std::mutex> lock(this->voxel_grid_index_lock);
+        this->voxel_grid_index_cache.reset();
     }
     return *this;
 }
 
+std::shared_ptr<const voxel_grid_index<float,double>> Image_Array::get_voxel_grid_index(){
+    std::lock_guard<std::mutex> lock(this->voxel_grid_index_lock);
+    this->voxel_grid_index_cache = Current_Voxel_Grid_Index(this->voxel_grid_index_cache, this->imagecoll);
+    return this->voxel_grid_index_cache;
+}
+
 //---------------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------- Point_Cloud ------------------------------------------------------
 //---------------------------------------------------------------------------------------------------------------------------
@@ -925,10 +940,38 @@ Surface_Mesh & Surface_Mesh::operator=(const Surface_Mesh &rhs){
         this->meshes            = rhs.meshes;
         this->vertex_attributes = rhs.vertex_attributes;
         this->face_attributes   = rhs.face_attributes;
+
+        std::lock_guard<std::mutex> lock(rhs.face_bvh_lock);
+        this->face_bvh = rhs.face_bvh;
     }
     return *this;
 }
 
+std::shared_ptr<const dcma_surface_meshes::face_bvh> Surface_Mesh::get_face_bvh() const {
+    const auto fp = dcma_surface_meshes::face_bvh::fingerprint(this->meshes);
+
+    std::lock_guard<std::mutex> lock(this->face_bvh_lock);
+    if( !this->face_bvh
+    ||  (this->face_bvh->mesh_fingerprint() != fp) ){
+        this->face_bvh = std::make_shared<const dcma_surface_meshes::face_bvh>(this->meshes);
+    }
+    return this->face_bvh;
+}
+
+dcma_surface_meshes::half_edge_mesh Surface_Mesh::take_half_edge_mesh() const {
+    return dcma_surface_meshes::half_edge_mesh(this->meshes);
+}
+
+void Surface_Mesh::set_from_half_edge_mesh(dcma_surface_meshes::half_edge_mesh &&hem){
+    // Take ownership so the half-edge mesh is released once it has been converted.
+    auto l_hem = std::move(hem);
+    l_hem.compact();
+    auto fv = l_hem.to_fv_surface_mesh();
+    this->meshes.vertices = std::move(fv.vertices);
+    this->meshes.faces = std::move(fv.faces);
+    this->meshes.recreate_involved_face_index();
+}
+
 //---------------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------- Line_Sample ------------------------------------------------------
 //---------------------------------------------------------------------------------------------------------------------------
@@ -1041,6 +1084,17 @@ drover_bnded_dose_stat_moments_map_t drover_bnded_dose_stat_moments_map_factory(
 }
 
 
+std::set<drover_member_t> All_Drover_Members(){
+    return { drover_member_t::contours,
+             drover_member_t::images,
+             drover_member_t::points,
+             drover_member_t::meshes,
+             drover_member_t::rtplans,
+             drover_member_t::lsamps,
+             drover_member_t::transforms,
+             drover_member_t::tables };
+}
+
 
 //Constructors.
 Drover::Drover() = default;
@@ -1062,6 +1116,174 @@ void Drover::operator=(const Drover &rhs){
     return;
 }
 
+void bounded_dose_stats::digest(double dose){
+    if(!std::isfinite(dose)) return;
+
+    ++this->count;
+    if(dose < this->min) this->min = dose;
+    if(this->max < dose) this->max = dose;
+
+    // Welford's running mean and sum of squared deviations.
+    const auto delta = dose - this->mean;
+    this->mean += delta / static_cast<double>(this->count);
+    this->m2 += delta * (dose - this->mean);
+
+    const auto bin_f = (dose <= 0.0) ? 0.0 : std::ceil(dose / this->bin_width);
+    if(!(bin_f < 1.0E9)){
+        throw std::runtime_error("Dose exceeds the histogram capacity. Refusing to continue.");
+    }
+    const auto bin = static_cast<size_t>(bin_f);
+    if(this->histogram.size() <= bin) this->histogram.resize(bin + 1, 0);
+    ++(this->histogram[bin]);
+    return;
+}
+
+void bounded_dose_stats::merge(const bounded_dose_stats &other){
+    if(other.count == 0) return;
+    if(this->bin_width != other.bin_width){
+        throw std::invalid_argument("Histogram bin widths differ. Cannot merge.");
+    }
+
+    const auto n_a = static_cast<double>(this->count);
+    const auto n_b = static_cast<double>(other.count);
+    const auto n = n_a + n_b;
+    const auto delta = other.mean - this->mean;
+    this->mean += delta * (n_b / n);
+    this->m2   += other.m2 + delta * delta * (n_a * n_b / n);
+    this->count += other.count;
+    this->min = std::min(this->min, other.min);
+    this->max = std::max(this->max, other.max);
+
+    if(this->histogram.size() < other.histogram.size()) this->histogram.resize(other.histogram.size(), 0);
+    for(size_t i = 0; i < other.histogram.size(); ++i) this->histogram[i] += other.histogram[i];
+
+    for(const auto &m : other.cent_moms) this->cent_moms[m.first] += m.second;
+    return;
+}
+
+double bounded_dose_stats::variance() const {
+    if(this->count == 0) return std::numeric_limits<double>::quiet_NaN();
+    return this->m2 / static_cast<double>(this->count);
+}
+
+std::map<double,double> bounded_dose_stats::cumulative_dvh() const {
+    std::map<double,double> out;
+    if(this->count == 0) return out;
+
+    // The voxels receiving more than k*bin_width are those in bins k+1 and above.
+    int64_t exceeding = this->count;
+    for(size_t k = 0; ; ++k){
+        if(k < this->histogram.size()) exceeding -= this->histogram[k];
+        out[static_cast<double>(k) * this->bin_width] = static_cast<double>(exceeding) / static_cast<double>(this->count);
+        if(exceeding <= 0) break;
+    }
+    return out;
+}
+
+std::vector<std::pair<bnded_dose_map_key_t, bounded_dose_stats>>
+Drover::Bounded_Dose_Stats(const bounded_dose_opts &opts) const {
+    //This routine visits the dose voxels bounded by each contour collection exactly once, accumulating statistics
+    // without retaining the voxels. Contour membership is determined with (cached) scanline-rasterized masks, so each
+    // contour collection is rasterized once per dose slice rather than testing every voxel against every contour.
+    //
+    // Voxels are considered bounded if their centre is within any contour of the collection. Only the first channel is
+    // considered. Non-finite voxels are ignored.
+    std::vector<std::pair<bnded_dose_map_key_t, bounded_dose_stats>> out;
+    if( !std::isfinite(opts.bin_width)
+    ||  (opts.bin_width <= 0.0) ){
+        throw std::invalid_argument("Histogram bin width must be positive and finite.");
+    }
+
+    auto d = Isolate_Dose_Data(*this);
+    if(!d.Has_Contour_Data() || !d.Has_Image_Data()){
+        YLOGERR("Attempted to use bounded dose routine, but we do not have contours and/or dose");
+    }
+
+    auto dose_data = d.image_data;
+    if(1 < dose_data.size()){
+        dose_data = Meld_Image_Data(d.image_data);
+        if(dose_data.size() != 1){
+            YLOGERR("This routine cannot handle multiple dose data which cannot be melded. This has " << dose_data.size());
+        }
+    }
+
+    for(auto cc_it = this->contour_data->ccs.begin(); cc_it != this->contour_data->ccs.end(); ++cc_it){
+        out.emplace_back(cc_it, bounded_dose_stats());
+        out.back().second.bin_width = opts.bin_width;
+    }
+
+    // Each contour collection is reduced independently, so no synchronization is needed.
+    std::vector<std::exception_ptr> errors(out.size());
+    {
+        work_queue<std::function<void(void)>> wq;
+        for(size_t i = 0; i < out.size(); ++i){
+            wq.submit_task([&,i]() -> void {
+                try{
+                    auto cc_it = out[i].first;
+                    auto &stats = out[i].second;
+
+                    std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(*cc_it) };
+                    const auto fingerprint = Contour_Fingerprint(ccsl);
+                    const auto centroid = (opts.centralized_moments) ? cc_it->Centroid() : vec3<double>();
+                    std::array<double, 125> moments;
+                    moments.fill(0.0);
+
+                    for(const auto &dd : dose_data){
+                        if(dd == nullptr) continue;
+                        for(const auto &img : dd->imagecoll.images){
+                            if(img.channels <= 0) continue;
+
+                            const auto mask = Get_ROI_Span_Mask( img, ccsl,
+                                                                 Mutate_Voxels_Opts::Inclusivity::Centre,
+                                                                 Mutate_Voxels_Opts::ContourOverlap::Ignore,
+                                                                 fingerprint );
+                            const auto grid_factor = img.pxl_dx * img.pxl_dy * img.pxl_dz;
+                            for(const auto &s : mask->spans){
+                                for(int64_t col = s.col_begin; col < s.col_end; ++col){
+                                    const auto dose = static_cast<double>(img.value(s.row, col, 0));
+                                    if(!std::isfinite(dose)) continue;
+                                    stats.digest(dose);
+
+                                    if(opts.centralized_moments){
+                                        const auto dr = img.position(s.row, col) - centroid;
+                                        std::array<double, 5> px, py, pz;
+                                        px[0] = py[0] = pz[0] = 1.0;
+                                        for(size_t k = 1; k < 5; ++k){
+                                            px[k] = px[k-1] * dr.x;
+                                            py[k] = py[k-1] * dr.y;
+                                            pz[k] = pz[k-1] * dr.z;
+                                        }
+                                        const auto w = dose * grid_factor;
+                                        for(size_t p = 0; p < 5; ++p) for(size_t q = 0; q < 5; ++q) for(size_t r = 0; r < 5; ++r){
+                                            moments[(p * 5 + q) * 5 + r] += px[p] * py[q] * pz[r] * w;
+                                        }
+                                    }
+
+                                    if(opts.voxel_visitor) opts.voxel_visitor(i, img, s.row, col, dose);
+                                }
+                            }
+                        }
+                    }
+
+                    if( opts.centralized_moments
+                    &&  (0 < stats.count) ){
+                        for(int p = 0; p < 5; ++p) for(int q = 0; q < 5; ++q) for(int r = 0; r < 5; ++r){
+                            stats.cent_moms[{p,q,r}] = moments[(p * 5 + q) * 5 + r];
+                        }
+                    }
+                }catch(...){
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+    } // Wait for the tasks to complete.
+    for(const auto &e : errors){
+        if(e) std::rethrow_exception(e);
+    }
+
+    return out;
+}
+
 void Drover::Bounded_Dose_General( std::list<double> *pixel_doses, 
                                    drover_bnded_dose_bulk_doses_map_t *bulk_doses, //NOTE: similar to pixel_doses but not all grouped together...
                                    drover_bnded_dose_mean_dose_map_t *mean_doses, 
@@ -1069,12 +1291,9 @@ void Drover::Bounded_Dose_General( std::list<double> *pixel_doses,
                                    drover_bnded_dose_pos_dose_map_t *pos_doses,
                                    const std::function<bool(bnded_dose_pos_dose_tup_t)>& Fselection,
                                    drover_bnded_dose_stat_moments_map_t *cent_moms ) const {
-    //This function is a general routine for working with pixels bounded by contour data. It *might* be better to stick it in 
-    // the contour or pixel classes, but it seems better (at the moment) to place it in the Drover class, where we have clearly
-    // indicated which contour, which dose pixels, and which CT data we want to work with.
-    //
-    //This function should (probably) only be called internally. Use the wrapper member functions. There is no reason why one
-    // couldn't use this function, however, so do whatever you want to!
+    //This function is a general routine for working with pixels bounded by contour data. It is a compatibility layer
+    // over Drover::Bounded_Dose_Stats(). Summary quantities are accumulated in a single streaming pass; only the
+    // per-voxel outputs (pixel_doses, bulk_doses, and pos_doses) retain voxels, and only when requested.
     //
     //Output options:
     //  std::list<double> *pixel_doses;            <-- Holds the each voxel's dose. Discards spatial info about voxels.
@@ -1082,7 +1301,8 @@ void Drover::Bounded_Dose_General( std::list<double> *pixel_doses,
     //  ....many more implemented...   They should be fairly self-describing...
     //
     // Pass a pointer to the desired container to compute the desired quantities.
-    auto d = Isolate_Dose_Data(*this);
+    //
+    // Note: contour collections are processed concurrently, so Fselection may be invoked concurrently.
 
     //----------------------------------------- Sanity/Safety Checks ----------------------------------------
     if((pixel_doses == nullptr) && (mean_doses == nullptr) && (min_max_doses == nullptr) 
@@ -1090,7 +1310,7 @@ void Drover::Bounded_Dose_General( std::list<double> *pixel_doses,
         YLOGWARN("No valid output pointers provided. Nothing will be computed");
         return;
     }
-    if(!d.Has_Contour_Data() || !d.Has_Image_Data()){
+    if(!this->Has_Contour_Data()){
         YLOGERR("Attempted to use bounded dose routine, but we do not have contours and/or dose");
     }
     if((pixel_doses != nullptr) && !pixel_doses->empty()){
@@ -1119,190 +1339,60 @@ void Drover::Bounded_Dose_General( std::list<double> *pixel_doses,
     }
     if((cent_moms != nullptr) && !cent_moms->empty()){
         YLOGWARN("Requesting centralized moments with a non-empty container. Emptying prior to continuing - we require the working space");
-        //Since we have to normalize them at the end, we have to begin with empty space.
-    }
-
-    std::list<std::shared_ptr<Image_Array>> dose_data_to_use(d.image_data);
-    if((min_max_doses != nullptr) && (d.image_data.size() > 1)){ //Only dose data meld when needed. Moments, for instance, probably don't need to be melded!
-        dose_data_to_use = Meld_Image_Data(d.image_data);
-        if(dose_data_to_use.size() != 1){
-            YLOGERR("This routine cannot handle multiple dose data which cannot be melded. This has " << dose_data_to_use.size());
-        }
+        cent_moms->clear();
+    }
+
+    bounded_dose_opts opts;
+    opts.centralized_moments = (cent_moms != nullptr);
+
+    //Per-voxel outputs are staged separately for each contour collection, since collections are processed concurrently.
+    const auto N_ccs = this->contour_data->ccs.size();
+    std::vector<std::list<double>> staged_doses( ((pixel_doses != nullptr) || (bulk_doses != nullptr)) ? N_ccs : 0 );
+    std::vector<std::list<bnded_dose_pos_dose_tup_t>> staged_pos_doses( (pos_doses != nullptr) ? N_ccs : 0 );
+    if( !staged_doses.empty() || !staged_pos_doses.empty() ){
+        opts.voxel_visitor = [&](size_t cc_index,
+                                 const planar_image<float,double> &img,
+                                 int64_t row,
+                                 int64_t col,
+                                 double dose) -> void {
+            if(!staged_doses.empty()) staged_doses[cc_index].push_back(dose);
+            if(!staged_pos_doses.empty()){
+                const vec3<double> r_dx = img.row_unit*img.pxl_dx*0.5;
+                const vec3<double> r_dy = img.col_unit*img.pxl_dy*0.5;
+                const auto tup = std::make_tuple(img.position(row,col), r_dx, r_dy, dose, row, col);
+                if(Fselection(tup)) staged_pos_doses[cc_index].push_back(tup);
+            }
+            return;
+        };
     }
 
+    const auto stats = this->Bounded_Dose_Stats(opts);
+    for(size_t i = 0; i < stats.size(); ++i){
+        const auto cc_it = stats[i].first;
+        const auto &s = stats[i].second;
 
-    //This is currently ONLY used if (cent_moms != nullptr).
-    auto cc_centroids = drover_bnded_dose_centroid_map_factory();
-
-    for(auto cc_it = this->contour_data->ccs.begin(); cc_it != this->contour_data->ccs.end(); ++cc_it){
-        //Push back zeros for the output mean_doses so we can += our results to it. Probably not necessary.
-        if(mean_doses != nullptr) (*mean_doses)[cc_it] = 0.0;
-
-        //Push back impossible values for min/max doses. These will get replaced or will flag an error.
-        if(min_max_doses != nullptr) (*min_max_doses)[cc_it] = std::pair<double,double>(1E99, -1E99); //min, max.
-
-        //Pre-compute centroids for each cc. We do this because we end up looping over cc's and they are fairly costly.
-        if(cent_moms != nullptr) cc_centroids[cc_it] = cc_it->Centroid();
-    }
-
-    //This is used to store info about total accumulated dose and total number of voxels within the contours. 
-    // It can be used to compute the mean doses.
-    // map<cc_iter, pair<Total dose (in unscaled integer units), Number of voxels>>.
-    auto accumulated_dose = drover_bnded_dose_accm_dose_map_factory();
+        if(mean_doses != nullptr) (*mean_doses)[cc_it] = s.mean; // Zero if there are no voxels.
 
-    //Loop over the attached dose datasets (NOT the dose slices!). It is implied that we have to sum up doses 
-    // from each attached data in order to find the total (actual) dose.
-    //
-    //NOTE: Should I get rid of the idea of cycling through multiple dose data? The only way we get here is if the data
-    // cannot be melded... This is probably not a worthwhile feature to keep in this code.
-    for(auto & dd_it : dose_data_to_use){
-        //Clear the accumulation map/initialize the elements.
-        for(auto cc_it = this->contour_data->ccs.begin(); cc_it != this->contour_data->ccs.end(); ++cc_it){
-            accumulated_dose[cc_it] = std::pair<int64_t,int64_t>(0,0);
+        //Impossible values for min/max doses flag an absence of voxels.
+        if(min_max_doses != nullptr){
+            (*min_max_doses)[cc_it] = (0 < s.count) ? std::make_pair(s.min, s.max)
+                                                    : std::pair<double,double>(1E99, -1E99); //min, max.
         }
-
-        //We now loop through all dose frames (slices) and accumulate dose within the contour bounds.
-        for(auto & image : dd_it->imagecoll.images){
-            //Note: i_it is something like std::list<planar_image<T,R>>::iterator.
-    
-            for(auto cc_it = this->contour_data->ccs.begin(); cc_it != this->contour_data->ccs.end(); ++cc_it){
-
-                for(auto c_it = cc_it->contours.begin(); c_it != cc_it->contours.end(); ++c_it){
-                    if(c_it->points.size() < 3) continue;
-
-                    const auto filtering_avg_point = c_it->First_N_Point_Avg(3); //Average_Point(); //Just need a point at the correct height, somewhere inside contour.
-                    if(!image.sandwiches_point_within_top_bottom_planes(filtering_avg_point)) continue;
- 
-                    //Now we have a contour of points and pixel data (note: we can ignore the z components for both) 
-                    // which may or may not lie within the contour. This is called the 'Point-in-polygon' problem and is
-                    // a well-known problem. Unfortunately, it can be a costly problem to solve. We will bound the contour with
-                    // a cartesian bounding box (in the XY plane) and poll each point. We can immediately ignore points outside the box.
-                    // This will save a considerable amount of time for small contours within a large volume, and probably won't greatly
-                    // slow the large contour/large volume case too much.
-                    //
-                    // We then examine line crossings. For a regular polygon, whether or not the number of line crossings (from the point
-                    // to infinity (in this case - the edge of the box)) is even or odd will determine whether or not the point is within
-                    // the contour. I *believe* there would be an issue if the contour would wrap around and touch exactly on some segment
-                    // (like a "C" where the two sharp edges touch to form an "O".) ***BEWARE*** that this is most likely the case!
-                    //
-                    // See http://www.visibone.com/inpoly/ (Accessed Jan 2012,) 
-                    //     http://paulbourke.net/geometry/insidepoly/ (January 2012,)
-                    //     http://stackoverflow.com/questions/217578/point-in-polygon-aka-hit-test (January 2012).
-                    //     NOTE: Some web servers/web applications used to have to implement this routine to deal with image maps. 
-                    //           Check their sources for leads if looking/scrounging for code. I would like a fully 3D version!
-                    //
-                    //     |---------------------|
-                    //     | /-----\  /--------\ |
-                    //     | |     |__|        / |
-                    //     |/                 /  |
-                    //     ||   X            /   |
-                    //     | \______________/    |
-                    //     |---------------------|
-                    //
-                    const contour_of_points<double> BB(c_it->Bounding_Box_Along(vec3<double>(1.0,0.0,0.0)));
-                    const float alrgnum(1E30);
-                    float min_x = alrgnum, max_x = -alrgnum;
-                    float min_y = alrgnum, max_y = -alrgnum;
-                    for(const auto & point : BB.points){
-                        if(point.x < min_x) min_x = point.x;
-                        if(point.x > max_x) max_x = point.x;
-                        if(point.y < min_y) min_y = point.y;
-                        if(point.y > max_y) max_y = point.y;
-                    }
-                    if((min_x == alrgnum) || (min_y == alrgnum) || (max_x == -alrgnum) || (max_y == -alrgnum)){
-                        YLOGERR("Unable to find a reasonable bounding box around this contour");
-                    }
-    
-                    //Now cycle through every pixel in the plane. This is kind of a shit way to do this, but then again this entire program is basically
-                    // a shit way to do it. I would like to have had more time to properly fix/plan/think about what I've got here...  -h
-                    for(int64_t i=0; i<image.rows; ++i)  for(int64_t j=0; j<image.columns; ++j){
-                        const auto pos = image.position(i,j);
-                        const float X = pos.x, Y = pos.y;
-    
-                        //Check if it is outside the bounding box.
-                        if(!isininc(min_x,X,max_x) || !isininc(min_y,Y,max_y)) continue;
-    
-                        bool is_in_the_polygon = false;
-                        auto p_j = --(c_it->points.end());
-                        for(auto p_i = c_it->points.begin(); p_i != c_it->points.end(); p_j = (p_i++)){
-                            //If the points cross a line, we simply toggle the 'bool is_in_the_polygon.'
-                            if( ((p_i->y <= Y) && (Y < p_j->y)) || ((p_j->y <= Y) && (Y < p_i->y)) ){ 
-                                const auto B = (p_j->x - p_i->x)*(Y - p_i->y)/(p_j->y - p_i->y);
-                                if(X < (B + p_i->x)){
-                                    is_in_the_polygon = !is_in_the_polygon;
-                                }
-                            }
-                        }
-
-                        if(is_in_the_polygon){
-                            //-----------------------------------------------------------------------------------------------------------------------
-                            //YLOGINFO("Bounding box (x,y)min (x,y)max = (" << min_x << "," << min_y << ") (" << max_x << "," << max_y << ")");
-                            //YLOGINFO("Point has (X,Y) = " << X << " " << Y);
-
-                            //NOTE: Remember: this is some integer representing dose. If we want a clamped [0:1] 
-                            // value, we would use the clamped_channel(...) member instead!
-                            const auto pointval = static_cast<int64_t>(image.value(i,j,0)); //Greyscale or R channel. We assume the channels satisfy: R = G = B.
-                            const auto pointdose = static_cast<double>(pointval); 
-
-                            if(mean_doses != nullptr){
-                                accumulated_dose[cc_it].first  += pointval;
-                                accumulated_dose[cc_it].second += 1;
-                            }
-                            if(bulk_doses != nullptr){
-                                (*bulk_doses)[cc_it].push_back(pointdose);
-                            }
-
-                            if(pixel_doses != nullptr){
-                                pixel_doses->push_back(pointdose); 
-                            }
-
-                            if(min_max_doses != nullptr){
-                                if(pointdose < (*min_max_doses)[cc_it].first)  (*min_max_doses)[cc_it].first  = pointdose; //min.
-                                if(pointdose > (*min_max_doses)[cc_it].second) (*min_max_doses)[cc_it].second = pointdose; //max.
-                            }
-
-                            if(pos_doses != nullptr){
-                                const vec3<double> r_dx = image.row_unit*image.pxl_dx*0.5;
-                                const vec3<double> r_dy = image.col_unit*image.pxl_dy*0.5;
-                                const auto tup = std::make_tuple(pos, r_dx, r_dy, pointdose, i, j);
-
-                                if(Fselection(tup)) (*pos_doses)[cc_it].push_back(tup);
-                            }
-                            if(cent_moms != nullptr){ //Centralized moments. This routine requires a centroid for each cc.
-                                const auto cc_centroid = cc_centroids[cc_it];
-                                for(int p = 0; p < 5; ++p) for(int q = 0; q < 5; ++q) for(int r = 0; r < 5; ++r){
-                                    //const std::array<int,3> triplet = {p,q,r};
-                                    const auto spatial = pow(pos.x-cc_centroid.x,p)*pow(pos.y-cc_centroid.y,q)*pow(pos.z-cc_centroid.z,r);
-                                    const auto grid_factor = image.pxl_dx * image.pxl_dy * image.pxl_dz;
-                                    (*cent_moms)[cc_it][{p,q,r}] += spatial*pointdose*grid_factor;
-                                }
-                            }
-
-                            //-----------------------------------------------------------------------------------------------------------------------
-                        }
-                    }
-                }
-            }
+        if( (cent_moms != nullptr) && (0 < s.count) ){
+            (*cent_moms)[cc_it] = s.cent_moms;
         }
-
-        //Determine the mean dose if required.
-        if(mean_doses != nullptr){
-            for(auto & it : accumulated_dose){
-                //If there were no voxels within the contour then we have nothing to do.
-                if(it.second.second == 0) continue;
-
-                const auto cc_iter = it.first;
-                const auto ttldose = static_cast<double>(it.second.first);
-                const auto numvxls = static_cast<double>(it.second.second);
-
-                if(ttldose < 0.0) YLOGERR("Total dose was negative (" << ttldose << "). This is not possible");
-                if(numvxls < 0.0) YLOGERR("Total number of voxels was negative (" << numvxls << "). This is not possible");
-
-                (*mean_doses)[cc_iter] += (ttldose/numvxls); //This dose is now in Gy (cGy?)
+        if( !staged_doses.empty() && !staged_doses[i].empty() ){
+            if(pixel_doses != nullptr){
+                pixel_doses->insert(pixel_doses->end(), staged_doses[i].begin(), staged_doses[i].end());
+            }
+            if(bulk_doses != nullptr){
+                (*bulk_doses)[cc_it].splice( (*bulk_doses)[cc_it].end(), staged_doses[i] );
             }
         }
-    }//Loop over the distinct dose file data.
-
+        if( !staged_pos_doses.empty() && !staged_pos_doses[i].empty() ){
+            (*pos_doses)[cc_it] = std::move(staged_pos_doses[i]);
+        }
+    }
 
     //Verification.
     if(min_max_doses != nullptr){
@@ -1512,18 +1602,20 @@ Drover Drover::Segment_Contours_Heuristically(const std::function<bool(bnded_dos
 }
 
 std::pair<double,double> Drover::Bounded_Dose_Limits() const {
-    std::list<double> doses;
-    this->Bounded_Dose_General(&doses,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr);
-    if(doses.empty()) return std::pair<double,double>(-1.0,-1.0);
+    bounded_dose_stats pooled;
+    for(const auto &cc_stats : this->Bounded_Dose_Stats()) pooled.merge(cc_stats.second);
+    if(pooled.count == 0) return std::pair<double,double>(-1.0,-1.0);
 
-    return std::pair<double,double>(*std::min_element(doses.begin(),doses.end()), *std::max_element(doses.begin(),doses.end()));
+    return std::pair<double,double>(pooled.min, pooled.max);
 }
 
 std::map<double,double>  Drover::Get_DVH() const {
-    std::map<double,double> output;
+    //The voxels of all contour collections are pooled. The DVH is sampled every 0.5 (Gy or cGy?).
+    bounded_dose_stats pooled;
+    for(const auto &cc_stats : this->Bounded_Dose_Stats()) pooled.merge(cc_stats.second);
 
-    std::list<double> pixel_doses = this->Bounded_Dose_Bulk_Values();
-    if(pixel_doses.empty()){
+    if(pooled.count == 0){
+        std::map<double,double> output;
         //YLOGERR("Unable to compute DVH: There was no data in the pixel_doses structure!");
         YLOGWARN("Asked to compute DVH when no voxels appear to have any dose. This is physically possible, but please be sure it is what you expected");
         //Could be due to:
@@ -1533,21 +1625,7 @@ std::map<double,double>  Drover::Get_DVH() const {
         output[0.0] = 0.0; //Nothing over 0Gy is delivered to any voxel (0% of volume).
         return output;
     }
-
-    double cumulative;
-    double test_dose = 0.0;
-    do{
-        cumulative = 0.0;
-        for(double & pixel_dose : pixel_doses){
-            if(pixel_dose > test_dose) cumulative += 1.0;
-        }
-
-        const auto dose = test_dose;
-        const auto frac = static_cast<double>(cumulative) / static_cast<double>(pixel_doses.size());
-        output[dose] = frac;
-        test_dose += 0.5;
-    }while(cumulative != 0.0);
-    return output;
+    return pooled.cumulative_dvh();
 }
 
 Drover Drover::Duplicate(std::shared_ptr<Contour_Data> in) const {
@@ -1561,17 +1639,33 @@ Drover Drover::Duplicate(const Drover &in) const {
 }
 
 Drover Drover::Deep_Copy() const {
-    Drover out;
-    if(this->contour_data != nullptr){
+    return this->Deep_Copy( All_Drover_Members() );
+}
+
+Drover Drover::Deep_Copy(const std::set<drover_member_t> &members) const {
+    Drover out(*this); // Shares all objects.
+
+    const auto copy_member = [&members](auto &l, drover_member_t m) -> void {
+        if(members.count(m) == 0) return;
+        for(auto& x : l){
+            if(x != nullptr){
+                x = std::make_shared<typename std::decay_t<decltype(x)>::element_type>(*x);
+            }
+        }
+        return;
+    };
+
+    if( (members.count(drover_member_t::contours) != 0)
+    &&  (this->contour_data != nullptr) ){
         out.contour_data = this->contour_data->Duplicate();
     }
-    for(const auto& x : this->image_data) out.image_data.emplace_back(std::make_shared<Image_Array>(*x));
-    for(const auto& x : this->point_data) out.point_data.emplace_back(std::make_shared<Point_Cloud>(*x));
-    for(const auto& x : this->smesh_data) out.smesh_data.emplace_back(std::make_shared<Surface_Mesh>(*x));
-    for(const auto& x : this->rtplan_data) out.rtplan_data.emplace_back(std::make_shared<RTPlan>(*x));
-    for(const auto& x : this->lsamp_data) out.lsamp_data.emplace_back(std::make_shared<Line_Sample>(*x));
-    for(const auto& x : this->trans_data) out.trans_data.emplace_back(std::make_shared<Transform3>(*x));
-    for(const auto& x : this->table_data) out.table_data.emplace_back(std::make_shared<Sparse_Table>(*x));
+    copy_member(out.image_data, drover_member_t::images);
+    copy_member(out.point_data, drover_member_t::points);
+    copy_member(out.smesh_data, drover_member_t::meshes);
+    copy_member(out.rtplan_data, drover_member_t::rtplans);
+    copy_member(out.lsamp_data, drover_member_t::lsamps);
+    copy_member(out.trans_data, drover_member_t::transforms);
+    copy_member(out.table_data, drover_member_t::tables);
     return out;
 }
 
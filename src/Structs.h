@@ -3,11 +3,14 @@
 #pragma once
 
 #include <array>
+#include <functional>
+#include <limits>
 #include <optional>
 #include <initializer_list>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
@@ -27,6 +30,9 @@
 #include "Alignment_Rigid.h"
 #include "Alignment_TPSRPM.h"
 #include "Alignment_Field.h"
+#include "Voxel_Volume.h"
+#include "Mesh_BVH.h"
+#include "Mesh_Half_Edge.h"
 
 
 //This should be turned into an enum, I think. Or at least reordered numerically.
@@ -130,6 +136,17 @@ class Image_Array { //: public Base_Array {
 
         //Member functions.
         Image_Array & operator=(const Image_Array &rhs); //Performs a deep copy (unless copying self).
+
+        // Index the images as a regular voxel grid. Returns nullptr if the images do not form a regular grid.
+        //
+        // The index is cached and only rebuilt when images are added, removed, or repositioned. It does not copy voxel
+        // values; use Marshal_To_Voxel_Volume() to get contiguous storage. Safe to call concurrently, provided the
+        // images are not being altered.
+        std::shared_ptr<const voxel_grid_index<float,double>> get_voxel_grid_index();
+
+    private:
+        std::mutex voxel_grid_index_lock;
+        std::shared_ptr<const voxel_grid_index<float,double>> voxel_grid_index_cache;
 };
 
 
@@ -165,6 +182,21 @@ class Surface_Mesh {
 
         //Member functions.
         Surface_Mesh & operator=(const Surface_Mesh &rhs); //Performs a deep copy (unless copying self).
+
+        // Returns a bounding volume hierarchy over the mesh faces. It is built on first use and rebuilt whenever the
+        // mesh has changed since. Safe to call concurrently, provided the mesh is not being altered.
+        std::shared_ptr<const dcma_surface_meshes::face_bvh> get_face_bvh() const;
+
+        // Returns a half-edge representation of the mesh for editing.
+        dcma_surface_meshes::half_edge_mesh take_half_edge_mesh() const;
+
+        // Replaces the mesh vertices and faces with those of the half-edge mesh, which is consumed.
+        // Metadata is retained, but vertex and face attributes are not updated.
+        void set_from_half_edge_mesh(dcma_surface_meshes::half_edge_mesh &&hem);
+
+    private:
+        mutable std::mutex face_bvh_lock;
+        mutable std::shared_ptr<const dcma_surface_meshes::face_bvh> face_bvh;
 };
 
 
@@ -424,6 +456,64 @@ drover_bnded_dose_min_mean_median_max_dose_map_t drover_bnded_dose_min_mean_medi
 drover_bnded_dose_pos_dose_map_t                 drover_bnded_dose_pos_dose_map_factory();
 drover_bnded_dose_stat_moments_map_t             drover_bnded_dose_stat_moments_map_factory();
 
+// Streaming statistics for the dose voxels bounded by a contour collection. Voxels are digested one at a time and are
+// not retained, so memory use does not depend on the number of voxels.
+struct bounded_dose_stats {
+    int64_t count = 0;  // The number of (finite) bounded voxels.
+    double min  = std::numeric_limits<double>::infinity();
+    double max  = -std::numeric_limits<double>::infinity();
+    double mean = 0.0;
+    double m2   = 0.0;  // Sum of squared deviations from the mean.
+
+    // Differential dose histogram with fixed-width bins. Bin 0 holds doses <= 0 and bin i > 0 holds doses within
+    // ((i-1)*bin_width, i*bin_width]. Bins are appended as needed.
+    double bin_width = 0.5;
+    std::vector<int64_t> histogram;
+
+    // Dose-weighted spatial moments about the collection's centroid, keyed on the exponents {p,q,r}. Only populated
+    // when requested.
+    std::map<std::array<int,3>,double> cent_moms;
+
+    void digest(double dose);
+
+    // Combine with statistics accumulated separately. Histogram bin widths must match.
+    void merge(const bounded_dose_stats &other);
+
+    double variance() const; // Population variance. NaN if there are no voxels.
+
+    // Cumulative DVH sampled at the bin edges: the fraction of voxels receiving more than each dose. Sampling stops at
+    // the first dose that no voxel exceeds.
+    std::map<double,double> cumulative_dvh() const;
+};
+
+struct bounded_dose_opts {
+    double bin_width = 0.5;
+    bool centralized_moments = false;
+
+    // Optional visitor invoked for each bounded voxel with the contour collection's position in Contour_Data::ccs.
+    // Contour collections are processed concurrently, so the visitor must be safe to invoke concurrently for
+    // different collections. Voxels of a given collection are visited sequentially.
+    std::function<void(size_t cc_index,
+                       const planar_image<float,double> &img,
+                       int64_t row,
+                       int64_t col,
+                       double dose)> voxel_visitor;
+};
+
+// Identifies the Drover data members, e.g., to denote which members an operation accesses.
+enum class drover_member_t {
+    contours,
+    images,
+    points,
+    meshes,
+    rtplans,
+    lsamps,
+    transforms,
+    tables,
+};
+
+std::set<drover_member_t> All_Drover_Members();
+
 class Drover {
     public:
 
@@ -442,6 +532,13 @@ class Drover {
     
         //Member functions.
         void operator = (const Drover &rhs);
+
+        // Single-pass dose statistics for each contour collection, in the order of Contour_Data::ccs. Dose arrays are
+        // melded first, and contour collections are processed in parallel. The Bounded_Dose_* routines below are
+        // implemented with this routine.
+        std::vector<std::pair<bnded_dose_map_key_t, bounded_dose_stats>>
+        Bounded_Dose_Stats(const bounded_dose_opts &opts = bounded_dose_opts()) const;
+
         void Bounded_Dose_General( std::list<double> *pixel_doses, 
                                    drover_bnded_dose_bulk_doses_map_t *bulk_doses, //NOTE: Similar to pixel_doses, but not all in a single bunch.
                                    drover_bnded_dose_mean_dose_map_t *mean_doses, 
@@ -467,6 +564,10 @@ class Drover {
         Drover Duplicate(const Contour_Data &in) const; 
         Drover Duplicate(const Drover &in) const;
         Drover Deep_Copy() const; // Make a deep copy of *this.
+
+        // Make a copy of *this that deep-copies only the specified members. Objects in the other members are shared,
+        // so this is a cheap snapshot when only the specified members will be modified.
+        Drover Deep_Copy(const std::set<drover_member_t> &members) const;
         void Swap(Drover &in);
     
         bool Has_Contour_Data() const;
@@ -0,0 +1,282 @@
+//Structs_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the core data structures and routines defined in Structs.cc and Voxel_Volume.h.
+// These tests are separated into their own file because Structs_obj is linked into shared libraries which don't
+// include doctest implementation.
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "Structs.h"
+#include "Voxel_Volume.h"
+
+#include "Test_Image_Fixtures.h"
+
+
+TEST_CASE( "voxel grid index orders slices and round-trips voxel values" ){
+    auto coll = make_regular_grid(3, 2, 4, 1.0,
+        [](int64_t slice, int64_t row, int64_t col){
+            return static_cast<float>(slice * 100 + row * 10 + col);
+        });
+
+    // Shuffle the slices; the index should recover the spatial order.
+    coll.images.splice(std::begin(coll.images), coll.images, std::prev(std::end(coll.images)));
+
+    auto index = Index_Voxel_Grid(coll);
+    REQUIRE(index);
+    CHECK(index->frames == 1);
+    CHECK(index->slices == 3);
+    CHECK(index->rows == 2);
+    CHECK(index->cols == 4);
+    CHECK(index->is_current(coll));
+
+    auto vol = Marshal_To_Voxel_Volume<double>(index.value());
+    REQUIRE(vol.data.size() == 24);
+    for(int64_t z = 0; z < 3; ++z){
+        CHECK(vol.value(0, z, 1, 2, 0) == doctest::Approx(static_cast<double>(z * 100 + 12)));
+        CHECK(vol.position(z, 0, 0).distance(index->image(0, z).position(0, 0)) < 1E-9);
+    }
+
+    SUBCASE("modified volumes are written back in place"){
+        for(auto &v : vol.data) v = -v;
+        Marshal_From_Voxel_Volume(vol, index.value());
+        CHECK(index->image(0, 2).value(1, 3, 0) == doctest::Approx(-213.0f));
+        CHECK(index->is_current(coll));
+    }
+
+    SUBCASE("coincident images are treated as frames"){
+        auto frames = make_regular_grid(3, 2, 4, 1.0,
+            [](int64_t, int64_t, int64_t){ return 1.0f; });
+        coll.images.splice(std::end(coll.images), frames.images);
+        auto index_4d = Index_Voxel_Grid(coll);
+        REQUIRE(index_4d);
+        CHECK(index_4d->frames == 2);
+        CHECK(index_4d->slices == 3);
+        CHECK(index_4d->image(1, 0).value(0, 0, 0) == doctest::Approx(1.0f));
+    }
+
+    SUBCASE("irregular spacing is rejected"){
+        coll.images.back().offset += vec3<double>(0.0, 0.0, 0.5);
+        CHECK(!index->is_current(coll));
+        CHECK(!Index_Voxel_Grid(coll));
+    }
+
+    SUBCASE("spacing and orientation changes are detected"){
+        // The first voxel of each image does not move, but the steps do.
+        for(auto &img : coll.images) img.pxl_dx *= 2.0;
+        CHECK(!index->is_current(coll));
+        for(auto &img : coll.images) img.pxl_dx *= 0.5;
+        CHECK(index->is_current(coll));
+
+        for(auto &img : coll.images) img.pxl_dz *= 2.0;
+        CHECK(!index->is_current(coll));
+        for(auto &img : coll.images) img.pxl_dz *= 0.5;
+
+        for(auto &img : coll.images) img.init_orientation(vec3<double>(0.0, 1.0, 0.0), vec3<double>(1.0, 0.0, 0.0));
+        CHECK(!index->is_current(coll));
+    }
+
+    SUBCASE("indices can be rebound to a copy of the collection"){
+        auto copy = coll;
+        const auto rebound = index->rebind(coll, copy);
+        REQUIRE(rebound);
+        CHECK(rebound->is_current(copy));
+        CHECK(!rebound->is_current(coll));
+        for(int64_t z = 0; z < 3; ++z){
+            CHECK(rebound->image(0, z).value(1, 2, 0) == doctest::Approx(index->image(0, z).value(1, 2, 0)));
+        }
+
+        copy.images.pop_back();
+        CHECK(!index->rebind(coll, copy));
+    }
+}
+
+TEST_CASE( "Image_Array voxel grid index cache" ){
+    Image_Array ia;
+    ia.imagecoll = make_regular_grid(4, 3, 3, 1.0,
+        [](int64_t slice, int64_t row, int64_t col){
+            return static_cast<float>(slice + row + col);
+        });
+
+    const auto index = ia.get_voxel_grid_index();
+    REQUIRE(index != nullptr);
+    CHECK(index->slices == 4);
+
+    SUBCASE("the index is reused while the geometry is unchanged"){
+        ia.imagecoll.images.front().reference(0, 0, 0) = 100.0f;
+        CHECK(ia.get_voxel_grid_index() == index);
+        CHECK(Current_Voxel_Grid_Index(index, ia.imagecoll) == index);
+    }
+
+    SUBCASE("the index is rebuilt when images are added or removed"){
+        ia.imagecoll.images.pop_back();
+        const auto rebuilt = ia.get_voxel_grid_index();
+        REQUIRE(rebuilt != nullptr);
+        CHECK(rebuilt != index);
+        CHECK(rebuilt->slices == 3);
+        CHECK(ia.get_voxel_grid_index() == rebuilt);
+    }
+
+    SUBCASE("irregular grids are not indexed"){
+        ia.imagecoll.images.back().offset += vec3<double>(0.0, 0.0, 0.5);
+        CHECK(ia.get_voxel_grid_index() == nullptr);
+    }
+
+    SUBCASE("copies do not share the index"){
+        Image_Array copy(ia);
+        const auto copy_index = copy.get_voxel_grid_index();
+        REQUIRE(copy_index != nullptr);
+        CHECK(copy_index != index);
+        CHECK(copy_index->is_current(copy.imagecoll));
+    }
+
+    SUBCASE("concurrent callers receive a current index"){
+        ia.imagecoll.images.pop_back();
+        std::vector<std::shared_ptr<const voxel_grid_index<float,double>>> indices(8);
+        {
+            std::vector<std::thread> threads;
+            for(auto &out : indices){
+                threads.emplace_back([&ia, &out](){ out = ia.get_voxel_grid_index(); });
+            }
+            for(auto &t : threads) t.join();
+        }
+        for(const auto &out : indices){
+            REQUIRE(out != nullptr);
+            CHECK(out->slices == 3);
+            CHECK(out->is_current(ia.imagecoll));
+        }
+    }
+}
+
+
+// Axis-aligned rectangles, one in the plane of each slice, appended to the given collection.
+static void
+add_rectangles(contour_collection<double> &cc, int64_t slices, double x_min, double y_min, double x_max, double y_max){
+    for(int64_t slice = 0; slice < slices; ++slice){
+        const auto z = static_cast<double>(slice);
+        contour_of_points<double> c;
+        c.closed = true;
+        c.points.emplace_back(x_min, y_min, z);
+        c.points.emplace_back(x_max, y_min, z);
+        c.points.emplace_back(x_max, y_max, z);
+        c.points.emplace_back(x_min, y_max, z);
+        cc.contours.push_back(c);
+    }
+    return;
+}
+
+// The cumulative DVH computed by scanning the dose in 0.5 steps, which is how Drover::Get_DVH() was originally
+// implemented.
+static std::map<double,double>
+reference_dvh(const std::list<double> &doses){
+    std::map<double,double> out;
+    double cumulative;
+    double test_dose = 0.0;
+    do{
+        cumulative = 0.0;
+        for(const auto &dose : doses){
+            if(dose > test_dose) cumulative += 1.0;
+        }
+        out[test_dose] = cumulative / static_cast<double>(doses.size());
+        test_dose += 0.5;
+    }while(cumulative != 0.0);
+    return out;
+}
+
+TEST_CASE( "Drover bounded dose statistics and DVH" ){
+    // Voxel (slice, row, col) is centred at (x = col, y = row, z = slice). Doses are multiples of 0.25, so some voxels
+    // lie exactly on the DVH sample doses and truncation would be noticed.
+    const int64_t S = 3;
+    const int64_t R = 6;
+    const int64_t C = 7;
+    const auto dose_fn = [](int64_t slice, int64_t row, int64_t col){
+        return 0.25f * static_cast<float>((slice * 7 + row * 3 + col * 5) % 13);
+    };
+    const auto make_dose_array = [&](const std::function<float(int64_t, int64_t, int64_t)> &f){
+        auto ia = std::make_shared<Image_Array>();
+        ia->imagecoll = make_regular_grid(S, R, C, 1.0, f);
+        for(auto &img : ia->imagecoll.images) img.metadata["Modality"] = "RTDOSE";
+        return ia;
+    };
+
+    Drover d;
+    d.image_data.push_back(make_dose_array(dose_fn));
+    d.Ensure_Contour_Data_Allocated();
+    d.contour_data->ccs.emplace_back();
+    auto &cc = d.contour_data->ccs.back();
+
+    // Rows 2-4 and columns 1-4.
+    add_rectangles(cc, S, 0.5, 1.5, 4.5, 4.5);
+    std::function<bool(int64_t, int64_t)> is_bounded = [](int64_t row, int64_t col){
+        return (2 <= row) && (row <= 4) && (1 <= col) && (col <= 4);
+    };
+    std::function<float(int64_t, int64_t, int64_t)> expected_dose_fn = dose_fn;
+
+    SUBCASE("a single contour per slice"){}
+
+    SUBCASE("overlapping contours count each voxel once"){
+        // Rows 1-3 and columns 3-5, overlapping the first rectangle.
+        add_rectangles(cc, S, 2.5, 0.5, 5.5, 3.5);
+        is_bounded = [](int64_t row, int64_t col){
+            return ((2 <= row) && (row <= 4) && (1 <= col) && (col <= 4))
+                || ((1 <= row) && (row <= 3) && (3 <= col) && (col <= 5));
+        };
+    }
+
+    SUBCASE("multiple dose arrays are melded without truncation"){
+        const auto other_dose_fn = [](int64_t slice, int64_t row, int64_t col){
+            return 0.25f * static_cast<float>((slice + row + col) % 5) + 0.5f;
+        };
+        d.image_data.push_back(make_dose_array(other_dose_fn));
+        expected_dose_fn = [=](int64_t slice, int64_t row, int64_t col){
+            return dose_fn(slice, row, col) + other_dose_fn(slice, row, col);
+        };
+    }
+
+    std::list<double> expected_doses;
+    for(int64_t slice = 0; slice < S; ++slice){
+        for(int64_t row = 0; row < R; ++row){
+            for(int64_t col = 0; col < C; ++col){
+                if(is_bounded(row, col)) expected_doses.push_back(static_cast<double>(expected_dose_fn(slice, row, col)));
+            }
+        }
+    }
+    REQUIRE(!expected_doses.empty());
+
+    const auto stats = d.Bounded_Dose_Stats();
+    REQUIRE(stats.size() == 1);
+    CHECK(stats.front().second.count == static_cast<int64_t>(expected_doses.size()));
+
+    double sum = 0.0;
+    for(const auto &dose : expected_doses) sum += dose;
+    const auto mean = sum / static_cast<double>(expected_doses.size());
+    double sq_dev = 0.0;
+    for(const auto &dose : expected_doses) sq_dev += (dose - mean) * (dose - mean);
+    CHECK(stats.front().second.mean == doctest::Approx(mean));
+    CHECK(stats.front().second.variance() == doctest::Approx(sq_dev / static_cast<double>(expected_doses.size())));
+
+    const auto limits = d.Bounded_Dose_Limits();
+    CHECK(limits.first == doctest::Approx(*std::min_element(std::begin(expected_doses), std::end(expected_doses))));
+    CHECK(limits.second == doctest::Approx(*std::max_element(std::begin(expected_doses), std::end(expected_doses))));
+
+    const auto dvh = d.Get_DVH();
+    const auto expected_dvh = reference_dvh(expected_doses);
+    REQUIRE(dvh.size() == expected_dvh.size());
+    for(auto it = std::begin(dvh), e_it = std::begin(expected_dvh); it != std::end(dvh); ++it, ++e_it){
+        CHECK(it->first == doctest::Approx(e_it->first));
+        CHECK(it->second == doctest::Approx(e_it->second));
+    }
+}
@@ -14,6 +14,12 @@
 #include <limits>
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
 
 #include <utility>            //Needed for std::pair.
 #include <algorithm>
@@ -66,6 +72,7 @@
 #include "Thread_Pool.h"
 #include "Structs.h"
 #include "CSG_SDF.h"
+#include "CSG_SDF_Tape.h"
 
 #include "YgorImages_Functors/Grouping/Misc_Functors.h"
 #include "YgorImages_Functors/Processing/Partitioned_Image_Voxel_Visitor_Mutator.h"
@@ -76,6 +83,399 @@
 // ----------------------------------------------- Pure contour meshing -----------------------------------------------
 namespace dcma_surface_meshes {
 
+// Each level of refinement is evaluated as a single batch.
+//
+// Marching Cube edges with an endpoint in a filled block never cross the surface, so the filled values only determine
+// corner inclusion (which is exact) and are never used to interpolate vertices.
+void
+Sample_SDF_Lattice(const csg::sdf::compiled_sdf &sdf,
+                   double lipschitz,
+                   double threshold,
+                   double edge_margin,
+                   sdf_lattice &lat){
+    struct block {
+        int64_t r0, r1; // Rows [r0,r1).
+        int64_t c0, c1; // Columns [c0,c1).
+    };
+    const auto is_leaf = [](const block &b){
+        return ((b.r1 - b.r0) <= 2) && ((b.c1 - b.c0) <= 2);
+    };
+
+    std::vector<block> blocks;
+    if((0 < lat.N_rows) && (0 < lat.N_cols)) blocks.push_back({ 0, lat.N_rows, 0, lat.N_cols });
+    std::vector<block> refined;
+    std::vector<vec3<double>> pos;
+    std::vector<double> vals;
+    while(!blocks.empty()){
+        // Leaf blocks are sampled at every point, all others only at the centre.
+        pos.clear();
+        for(const auto &b : blocks){
+            if(is_leaf(b)){
+                for(int64_t r = b.r0; r < b.r1; ++r){
+                    for(int64_t c = b.c0; c < b.c1; ++c){
+                        pos.emplace_back( lat.position(static_cast<double>(r), static_cast<double>(c)) );
+                    }
+                }
+            }else{
+                pos.emplace_back( lat.position( 0.5 * static_cast<double>(b.r0 + b.r1 - 1),
+                                                0.5 * static_cast<double>(b.c0 + b.c1 - 1) ) );
+            }
+        }
+        vals.resize(pos.size());
+        sdf.evaluate(pos.data(), vals.data(), static_cast<int64_t>(pos.size()));
+
+        refined.clear();
+        auto v_it = std::cbegin(vals);
+        for(const auto &b : blocks){
+            if(is_leaf(b)){
+                for(int64_t r = b.r0; r < b.r1; ++r){
+                    for(int64_t c = b.c0; c < b.c1; ++c){
+                        lat.vals[r * lat.N_cols + c] = *(v_it++);
+                    }
+                }
+                continue;
+            }
+
+            const auto nr = b.r1 - b.r0;
+            const auto nc = b.c1 - b.c0;
+            const auto dr = lat.row_step * static_cast<double>(nr - 1);
+            const auto dc = lat.col_step * static_cast<double>(nc - 1);
+            const auto half_diag = 0.5 * std::max<double>( (dr + dc).length(), (dr - dc).length() );
+            const auto d = *(v_it++) - threshold;
+            if( !std::isnan(d)
+            &&  ((lipschitz * (half_diag + edge_margin)) < std::abs(d)) ){
+                const auto bound = threshold + std::copysign(std::abs(d) - lipschitz * half_diag, d);
+                for(int64_t r = b.r0; r < b.r1; ++r){
+                    std::fill( std::next(std::begin(lat.vals), r * lat.N_cols + b.c0),
+                               std::next(std::begin(lat.vals), r * lat.N_cols + b.c1), bound );
+                }
+                continue;
+            }
+
+            const auto rm = (nr <= 2) ? b.r1 : (b.r0 + nr / 2);
+            const auto cm = (nc <= 2) ? b.c1 : (b.c0 + nc / 2);
+            for(const auto &l_b : { block{ b.r0, rm, b.c0, cm }, block{ b.r0, rm, cm, b.c1 },
+                                    block{ rm, b.r1, b.c0, cm }, block{ rm, b.r1, cm, b.c1 } }){
+                if((l_b.r0 < l_b.r1) && (l_b.c0 < l_b.c1)) refined.push_back(l_b);
+            }
+        }
+        std::swap(blocks, refined);
+    }
+    return;
+}
+
+// Marching Cubes lookup tables, shared by the in-memory and streaming implementations.
+//
+// NOTE: These tables come from the public domain implementation credited below.
+
+// Use a curb vertex inclusivity int (8 bits) to determine which (of 12) edges are intersected by the ROI surface.
+static const std::array<int32_t, 256> aiCubeEdgeFlags { {
+    0b000000000000, 0b000100001001, 0b001000000011, 0b001100001010, 0b010000000110, 0b010100001111, 0b011000000101,
+    0b011100001100, 0b100000001100, 0b100100000101, 0b101000001111, 0b101100000110, 0b110000001010, 0b110100000011,
+    0b111000001001, 0b111100000000, 0b000110010000, 0b000010011001, 0b001110010011, 0b001010011010, 0b010110010110,
+    0b010010011111, 0b011110010101, 0b011010011100, 0b100110011100, 0b100010010101, 0b101110011111, 0b101010010110,
+    0b110110011010, 0b110010010011, 0b111110011001, 0b111010010000, 0b001000110000, 0b001100111001, 0b000000110011,
+    0b000100111010, 0b011000110110, 0b011100111111, 0b010000110101, 0b010100111100, 0b101000111100, 0b101100110101,
+    0b100000111111, 0b100100110110, 0b111000111010, 0b111100110011, 0b110000111001, 0b110100110000, 0b001110100000,
+    0b001010101001, 0b000110100011, 0b000010101010, 0b011110100110, 0b011010101111, 0b010110100101, 0b010010101100,
+    0b101110101100, 0b101010100101, 0b100110101111, 0b100010100110, 0b111110101010, 0b111010100011, 0b110110101001,
+    0b110010100000, 0b010001100000, 0b010101101001, 0b011001100011, 0b011101101010, 0b000001100110, 0b000101101111,
+    0b001001100101, 0b001101101100, 0b110001101100, 0b110101100101, 0b111001101111, 0b111101100110, 0b100001101010,
+    0b100101100011, 0b101001101001, 0b101101100000, 0b010111110000, 0b010011111001, 0b011111110011, 0b011011111010,
+    0b000111110110, 0b000011111111, 0b001111110101, 0b001011111100, 0b110111111100, 0b110011110101, 0b111111111111,
+    0b111011110110, 0b100111111010, 0b100011110011, 0b101111111001, 0b101011110000, 0b011001010000, 0b011101011001,
+    0b010001010011, 0b010101011010, 0b001001010110, 0b001101011111, 0b000001010101, 0b000101011100, 0b111001011100,
+    0b111101010101, 0b110001011111, 0b110101010110, 0b101001011010, 0b101101010011, 0b100001011001, 0b100101010000,
+    0b011111000000, 0b011011001001, 0b010111000011, 0b010011001010, 0b001111000110, 0b001011001111, 0b000111000101,
+    0b000011001100, 0b111111001100, 0b111011000101, 0b110111001111, 0b110011000110, 0b101111001010, 0b101011000011,
+    0b100111001001, 0b100011000000, 0b100011000000, 0b100111001001, 0b101011000011, 0b101111001010, 0b110011000110,
+    0b110111001111, 0b111011000101, 0b111111001100, 0b000011001100, 0b000111000101, 0b001011001111, 0b001111000110,
+    0b010011001010, 0b010111000011, 0b011011001001, 0b011111000000, 0b100101010000, 0b100001011001, 0b101101010011,
+    0b101001011010, 0b110101010110, 0b110001011111, 0b111101010101, 0b111001011100, 0b000101011100, 0b000001010101,
+    0b001101011111, 0b001001010110, 0b010101011010, 0b010001010011, 0b011101011001, 0b011001010000, 0b101011110000,
+    0b101111111001, 0b100011110011, 0b100111111010, 0b111011110110, 0b111111111111, 0b110011110101, 0b110111111100,
+    0b001011111100, 0b001111110101, 0b000011111111, 0b000111110110, 0b011011111010, 0b011111110011, 0b010011111001,
+    0b010111110000, 0b101101100000, 0b101001101001, 0b100101100011, 0b100001101010, 0b111101100110, 0b111001101111,
+    0b110101100101, 0b110001101100, 0b001101101100, 0b001001100101, 0b000101101111, 0b000001100110, 0b011101101010,
+    0b011001100011, 0b010101101001, 0b010001100000, 0b110010100000, 0b110110101001, 0b111010100011, 0b111110101010,
+    0b100010100110, 0b100110101111, 0b101010100101, 0b101110101100, 0b010010101100, 0b010110100101, 0b011010101111,
+    0b011110100110, 0b000010101010, 0b000110100011, 0b001010101001, 0b001110100000, 0b110100110000, 0b110000111001,
+    0b111100110011, 0b111000111010, 0b100100110110, 0b100000111111, 0b101100110101, 0b101000111100, 0b010100111100,
+    0b010000110101, 0b011100111111, 0b011000110110, 0b000100111010, 0b000000110011, 0b001100111001, 0b001000110000,
+    0b111010010000, 0b111110011001, 0b110010010011, 0b110110011010, 0b101010010110, 0b101110011111, 0b100010010101,
+    0b100110011100, 0b011010011100, 0b011110010101, 0b010010011111, 0b010110010110, 0b001010011010, 0b001110010011,
+    0b000010011001, 0b000110010000, 0b111100000000, 0b111000001001, 0b110100000011, 0b110000001010, 0b101100000110,
+    0b101000001111, 0b100100000101, 0b100000001100, 0b011100001100, 0b011000000101, 0b010100001111, 0b010000000110,
+    0b001100001010, 0b001000000011, 0b000100001001, 0b000000000000
+} };
+
+// Determine which triangulation (0-5 triangles) is needed given the edge-surface intersections.
+static const std::array< std::array<int32_t, 16>, 256> a2iTriangleConnectionTable  { {
+       { -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  1,  9,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  8,  3,    9,  8,  1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  3,    1,  2, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  2, 10,    0,  2,  9,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  8,  3,    2, 10,  8,   10,  9,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3, 11,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0, 11,  2,    8, 11,  0,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  9,  0,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1, 11,  2,    1,  9, 11,    9,  8, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3, 10,  1,   11, 10,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0, 10,  1,    0,  8, 10,    8, 11, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  9,  0,    3, 11,  9,   11, 10,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  8, 10,   10,  8, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  7,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  3,  0,    7,  3,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  1,  9,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  1,  9,    4,  7,  1,    7,  3,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 10,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  4,  7,    3,  0,  4,    1,  2, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  2, 10,    9,  0,  2,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2, 10,  9,    2,  9,  7,    2,  7,  3,    7,  9,  4,   -1, -1, -1,   -1 },
+       {  8,  4,  7,    3, 11,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 11,  4,  7,   11,  2,  4,    2,  0,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  0,  1,    8,  4,  7,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  7, 11,    9,  4, 11,    9, 11,  2,    9,  2,  1,   -1, -1, -1,   -1 },
+       {  3, 10,  1,    3, 11, 10,    7,  8,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1, 11, 10,    1,  4, 11,    1,  0,  4,    7, 11,  4,   -1, -1, -1,   -1 },
+       {  4,  7,  8,    9,  0, 11,    9, 11, 10,   11,  0,  3,   -1, -1, -1,   -1 },
+       {  4,  7, 11,    4, 11,  9,    9, 11, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  5,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  5,  4,    0,  8,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  5,  4,    1,  5,  0,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  5,  4,    8,  3,  5,    3,  1,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 10,    9,  5,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  0,  8,    1,  2, 10,    4,  9,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5,  2, 10,    5,  4,  2,    4,  0,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2, 10,  5,    3,  2,  5,    3,  5,  4,    3,  4,  8,   -1, -1, -1,   -1 },
+       {  9,  5,  4,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0, 11,  2,    0,  8, 11,    4,  9,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  5,  4,    0,  1,  5,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  1,  5,    2,  5,  8,    2,  8, 11,    4,  8,  5,   -1, -1, -1,   -1 },
+       { 10,  3, 11,   10,  1,  3,    9,  5,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  9,  5,    0,  8,  1,    8, 10,  1,    8, 11, 10,   -1, -1, -1,   -1 },
+       {  5,  4,  0,    5,  0, 11,    5, 11, 10,   11,  0,  3,   -1, -1, -1,   -1 },
+       {  5,  4,  8,    5,  8, 10,   10,  8, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  7,  8,    5,  7,  9,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  3,  0,    9,  5,  3,    5,  7,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  7,  8,    0,  1,  7,    1,  5,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  5,  3,    3,  5,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  7,  8,    9,  5,  7,   10,  1,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  1,  2,    9,  5,  0,    5,  3,  0,    5,  7,  3,   -1, -1, -1,   -1 },
+       {  8,  0,  2,    8,  2,  5,    8,  5,  7,   10,  5,  2,   -1, -1, -1,   -1 },
+       {  2, 10,  5,    2,  5,  3,    3,  5,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  7,  9,  5,    7,  8,  9,    3, 11,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  5,  7,    9,  7,  2,    9,  2,  0,    2,  7, 11,   -1, -1, -1,   -1 },
+       {  2,  3, 11,    0,  1,  8,    1,  7,  8,    1,  5,  7,   -1, -1, -1,   -1 },
+       { 11,  2,  1,   11,  1,  7,    7,  1,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  5,  8,    8,  5,  7,   10,  1,  3,   10,  3, 11,   -1, -1, -1,   -1 },
+       {  5,  7,  0,    5,  0,  9,    7, 11,  0,    1,  0, 10,   11, 10,  0,   -1 },
+       { 11, 10,  0,   11,  0,  3,   10,  5,  0,    8,  0,  7,    5,  7,  0,   -1 },
+       { 11, 10,  5,    7, 11,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  3,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  0,  1,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  8,  3,    1,  9,  8,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  6,  5,    2,  6,  1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  6,  5,    1,  2,  6,    3,  0,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  6,  5,    9,  0,  6,    0,  2,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5,  9,  8,    5,  8,  2,    5,  2,  6,    3,  2,  8,   -1, -1, -1,   -1 },
+       {  2,  3, 11,   10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 11,  0,  8,   11,  2,  0,   10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  1,  9,    2,  3, 11,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5, 10,  6,    1,  9,  2,    9, 11,  2,    9,  8, 11,   -1, -1, -1,   -1 },
+       {  6,  3, 11,    6,  5,  3,    5,  1,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8, 11,    0, 11,  5,    0,  5,  1,    5, 11,  6,   -1, -1, -1,   -1 },
+       {  3, 11,  6,    0,  3,  6,    0,  6,  5,    0,  5,  9,   -1, -1, -1,   -1 },
+       {  6,  5,  9,    6,  9, 11,   11,  9,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5, 10,  6,    4,  7,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  3,  0,    4,  7,  3,    6,  5, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  9,  0,    5, 10,  6,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  6,  5,    1,  9,  7,    1,  7,  3,    7,  9,  4,   -1, -1, -1,   -1 },
+       {  6,  1,  2,    6,  5,  1,    4,  7,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2,  5,    5,  2,  6,    3,  0,  4,    3,  4,  7,   -1, -1, -1,   -1 },
+       {  8,  4,  7,    9,  0,  5,    0,  6,  5,    0,  2,  6,   -1, -1, -1,   -1 },
+       {  7,  3,  9,    7,  9,  4,    3,  2,  9,    5,  9,  6,    2,  6,  9,   -1 },
+       {  3, 11,  2,    7,  8,  4,   10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5, 10,  6,    4,  7,  2,    4,  2,  0,    2,  7, 11,   -1, -1, -1,   -1 },
+       {  0,  1,  9,    4,  7,  8,    2,  3, 11,    5, 10,  6,   -1, -1, -1,   -1 },
+       {  9,  2,  1,    9, 11,  2,    9,  4, 11,    7, 11,  4,    5, 10,  6,   -1 },
+       {  8,  4,  7,    3, 11,  5,    3,  5,  1,    5, 11,  6,   -1, -1, -1,   -1 },
+       {  5,  1, 11,    5, 11,  6,    1,  0, 11,    7, 11,  4,    0,  4, 11,   -1 },
+       {  0,  5,  9,    0,  6,  5,    0,  3,  6,   11,  6,  3,    8,  4,  7,   -1 },
+       {  6,  5,  9,    6,  9, 11,    4,  7,  9,    7, 11,  9,   -1, -1, -1,   -1 },
+       { 10,  4,  9,    6,  4, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4, 10,  6,    4,  9, 10,    0,  8,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  0,  1,   10,  6,  0,    6,  4,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  3,  1,    8,  1,  6,    8,  6,  4,    6,  1, 10,   -1, -1, -1,   -1 },
+       {  1,  4,  9,    1,  2,  4,    2,  6,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  0,  8,    1,  2,  9,    2,  4,  9,    2,  6,  4,   -1, -1, -1,   -1 },
+       {  0,  2,  4,    4,  2,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  3,  2,    8,  2,  4,    4,  2,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  4,  9,   10,  6,  4,   11,  2,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  2,    2,  8, 11,    4,  9, 10,    4, 10,  6,   -1, -1, -1,   -1 },
+       {  3, 11,  2,    0,  1,  6,    0,  6,  4,    6,  1, 10,   -1, -1, -1,   -1 },
+       {  6,  4,  1,    6,  1, 10,    4,  8,  1,    2,  1, 11,    8, 11,  1,   -1 },
+       {  9,  6,  4,    9,  3,  6,    9,  1,  3,   11,  6,  3,   -1, -1, -1,   -1 },
+       {  8, 11,  1,    8,  1,  0,   11,  6,  1,    9,  1,  4,    6,  4,  1,   -1 },
+       {  3, 11,  6,    3,  6,  0,    0,  6,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  6,  4,  8,   11,  6,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  7, 10,  6,    7,  8, 10,    8,  9, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  7,  3,    0, 10,  7,    0,  9, 10,    6,  7, 10,   -1, -1, -1,   -1 },
+       { 10,  6,  7,    1, 10,  7,    1,  7,  8,    1,  8,  0,   -1, -1, -1,   -1 },
+       { 10,  6,  7,   10,  7,  1,    1,  7,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2,  6,    1,  6,  8,    1,  8,  9,    8,  6,  7,   -1, -1, -1,   -1 },
+       {  2,  6,  9,    2,  9,  1,    6,  7,  9,    0,  9,  3,    7,  3,  9,   -1 },
+       {  7,  8,  0,    7,  0,  6,    6,  0,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  7,  3,  2,    6,  7,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  3, 11,   10,  6,  8,   10,  8,  9,    8,  6,  7,   -1, -1, -1,   -1 },
+       {  2,  0,  7,    2,  7, 11,    0,  9,  7,    6,  7, 10,    9, 10,  7,   -1 },
+       {  1,  8,  0,    1,  7,  8,    1, 10,  7,    6,  7, 10,    2,  3, 11,   -1 },
+       { 11,  2,  1,   11,  1,  7,   10,  6,  1,    6,  7,  1,   -1, -1, -1,   -1 },
+       {  8,  9,  6,    8,  6,  7,    9,  1,  6,   11,  6,  3,    1,  3,  6,   -1 },
+       {  0,  9,  1,   11,  6,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  7,  8,  0,    7,  0,  6,    3, 11,  0,   11,  6,  0,   -1, -1, -1,   -1 },
+       {  7, 11,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  0,  8,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  1,  9,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  1,  9,    8,  3,  1,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  1,  2,    6, 11,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 10,    3,  0,  8,    6, 11,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  9,  0,    2, 10,  9,    6, 11,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  6, 11,  7,    2, 10,  3,   10,  8,  3,   10,  9,  8,   -1, -1, -1,   -1 },
+       {  7,  2,  3,    6,  2,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  7,  0,  8,    7,  6,  0,    6,  2,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  7,  6,    2,  3,  7,    0,  1,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  6,  2,    1,  8,  6,    1,  9,  8,    8,  7,  6,   -1, -1, -1,   -1 },
+       { 10,  7,  6,   10,  1,  7,    1,  3,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  7,  6,    1,  7, 10,    1,  8,  7,    1,  0,  8,   -1, -1, -1,   -1 },
+       {  0,  3,  7,    0,  7, 10,    0, 10,  9,    6, 10,  7,   -1, -1, -1,   -1 },
+       {  7,  6, 10,    7, 10,  8,    8, 10,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  6,  8,  4,   11,  8,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  6, 11,    3,  0,  6,    0,  4,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  6, 11,    8,  4,  6,    9,  0,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  4,  6,    9,  6,  3,    9,  3,  1,   11,  3,  6,   -1, -1, -1,   -1 },
+       {  6,  8,  4,    6, 11,  8,    2, 10,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 10,    3,  0, 11,    0,  6, 11,    0,  4,  6,   -1, -1, -1,   -1 },
+       {  4, 11,  8,    4,  6, 11,    0,  2,  9,    2, 10,  9,   -1, -1, -1,   -1 },
+       { 10,  9,  3,   10,  3,  2,    9,  4,  3,   11,  3,  6,    4,  6,  3,   -1 },
+       {  8,  2,  3,    8,  4,  2,    4,  6,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  4,  2,    4,  6,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  9,  0,    2,  3,  4,    2,  4,  6,    4,  3,  8,   -1, -1, -1,   -1 },
+       {  1,  9,  4,    1,  4,  2,    2,  4,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  1,  3,    8,  6,  1,    8,  4,  6,    6, 10,  1,   -1, -1, -1,   -1 },
+       { 10,  1,  0,   10,  0,  6,    6,  0,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  6,  3,    4,  3,  8,    6, 10,  3,    0,  3,  9,   10,  9,  3,   -1 },
+       { 10,  9,  4,    6, 10,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  9,  5,    7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  3,    4,  9,  5,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5,  0,  1,    5,  4,  0,    7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 11,  7,  6,    8,  3,  4,    3,  5,  4,    3,  1,  5,   -1, -1, -1,   -1 },
+       {  9,  5,  4,   10,  1,  2,    7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  6, 11,  7,    1,  2, 10,    0,  8,  3,    4,  9,  5,   -1, -1, -1,   -1 },
+       {  7,  6, 11,    5,  4, 10,    4,  2, 10,    4,  0,  2,   -1, -1, -1,   -1 },
+       {  3,  4,  8,    3,  5,  4,    3,  2,  5,   10,  5,  2,   11,  7,  6,   -1 },
+       {  7,  2,  3,    7,  6,  2,    5,  4,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  5,  4,    0,  8,  6,    0,  6,  2,    6,  8,  7,   -1, -1, -1,   -1 },
+       {  3,  6,  2,    3,  7,  6,    1,  5,  0,    5,  4,  0,   -1, -1, -1,   -1 },
+       {  6,  2,  8,    6,  8,  7,    2,  1,  8,    4,  8,  5,    1,  5,  8,   -1 },
+       {  9,  5,  4,   10,  1,  6,    1,  7,  6,    1,  3,  7,   -1, -1, -1,   -1 },
+       {  1,  6, 10,    1,  7,  6,    1,  0,  7,    8,  7,  0,    9,  5,  4,   -1 },
+       {  4,  0, 10,    4, 10,  5,    0,  3, 10,    6, 10,  7,    3,  7, 10,   -1 },
+       {  7,  6, 10,    7, 10,  8,    5,  4, 10,    4,  8, 10,   -1, -1, -1,   -1 },
+       {  6,  9,  5,    6, 11,  9,   11,  8,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  6, 11,    0,  6,  3,    0,  5,  6,    0,  9,  5,   -1, -1, -1,   -1 },
+       {  0, 11,  8,    0,  5, 11,    0,  1,  5,    5,  6, 11,   -1, -1, -1,   -1 },
+       {  6, 11,  3,    6,  3,  5,    5,  3,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 10,    9,  5, 11,    9, 11,  8,   11,  5,  6,   -1, -1, -1,   -1 },
+       {  0, 11,  3,    0,  6, 11,    0,  9,  6,    5,  6,  9,    1,  2, 10,   -1 },
+       { 11,  8,  5,   11,  5,  6,    8,  0,  5,   10,  5,  2,    0,  2,  5,   -1 },
+       {  6, 11,  3,    6,  3,  5,    2, 10,  3,   10,  5,  3,   -1, -1, -1,   -1 },
+       {  5,  8,  9,    5,  2,  8,    5,  6,  2,    3,  8,  2,   -1, -1, -1,   -1 },
+       {  9,  5,  6,    9,  6,  0,    0,  6,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  5,  8,    1,  8,  0,    5,  6,  8,    3,  8,  2,    6,  2,  8,   -1 },
+       {  1,  5,  6,    2,  1,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  3,  6,    1,  6, 10,    3,  8,  6,    5,  6,  9,    8,  9,  6,   -1 },
+       { 10,  1,  0,   10,  0,  6,    9,  5,  0,    5,  6,  0,   -1, -1, -1,   -1 },
+       {  0,  3,  8,    5,  6, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  5,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 11,  5, 10,    7,  5, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 11,  5, 10,   11,  7,  5,    8,  3,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5, 11,  7,    5, 10, 11,    1,  9,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 10,  7,  5,   10, 11,  7,    9,  8,  1,    8,  3,  1,   -1, -1, -1,   -1 },
+       { 11,  1,  2,   11,  7,  1,    7,  5,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  3,    1,  2,  7,    1,  7,  5,    7,  2, 11,   -1, -1, -1,   -1 },
+       {  9,  7,  5,    9,  2,  7,    9,  0,  2,    2, 11,  7,   -1, -1, -1,   -1 },
+       {  7,  5,  2,    7,  2, 11,    5,  9,  2,    3,  2,  8,    9,  8,  2,   -1 },
+       {  2,  5, 10,    2,  3,  5,    3,  7,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  2,  0,    8,  5,  2,    8,  7,  5,   10,  2,  5,   -1, -1, -1,   -1 },
+       {  9,  0,  1,    5, 10,  3,    5,  3,  7,    3, 10,  2,   -1, -1, -1,   -1 },
+       {  9,  8,  2,    9,  2,  1,    8,  7,  2,   10,  2,  5,    7,  5,  2,   -1 },
+       {  1,  3,  5,    3,  7,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  7,    0,  7,  1,    1,  7,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  0,  3,    9,  3,  5,    5,  3,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9,  8,  7,    5,  9,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5,  8,  4,    5, 10,  8,   10, 11,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  5,  0,  4,    5, 11,  0,    5, 10, 11,   11,  3,  0,   -1, -1, -1,   -1 },
+       {  0,  1,  9,    8,  4, 10,    8, 10, 11,   10,  4,  5,   -1, -1, -1,   -1 },
+       { 10, 11,  4,   10,  4,  5,   11,  3,  4,    9,  4,  1,    3,  1,  4,   -1 },
+       {  2,  5,  1,    2,  8,  5,    2, 11,  8,    4,  5,  8,   -1, -1, -1,   -1 },
+       {  0,  4, 11,    0, 11,  3,    4,  5, 11,    2, 11,  1,    5,  1, 11,   -1 },
+       {  0,  2,  5,    0,  5,  9,    2, 11,  5,    4,  5,  8,   11,  8,  5,   -1 },
+       {  9,  4,  5,    2, 11,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  5, 10,    3,  5,  2,    3,  4,  5,    3,  8,  4,   -1, -1, -1,   -1 },
+       {  5, 10,  2,    5,  2,  4,    4,  2,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3, 10,  2,    3,  5, 10,    3,  8,  5,    4,  5,  8,    0,  1,  9,   -1 },
+       {  5, 10,  2,    5,  2,  4,    1,  9,  2,    9,  4,  2,   -1, -1, -1,   -1 },
+       {  8,  4,  5,    8,  5,  3,    3,  5,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  4,  5,    1,  0,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  8,  4,  5,    8,  5,  3,    9,  0,  5,    0,  3,  5,   -1, -1, -1,   -1 },
+       {  9,  4,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4, 11,  7,    4,  9, 11,    9, 10, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  8,  3,    4,  9,  7,    9, 11,  7,    9, 10, 11,   -1, -1, -1,   -1 },
+       {  1, 10, 11,    1, 11,  4,    1,  4,  0,    7,  4, 11,   -1, -1, -1,   -1 },
+       {  3,  1,  4,    3,  4,  8,    1, 10,  4,    7,  4, 11,   10, 11,  4,   -1 },
+       {  4, 11,  7,    9, 11,  4,    9,  2, 11,    9,  1,  2,   -1, -1, -1,   -1 },
+       {  9,  7,  4,    9, 11,  7,    9,  1, 11,    2, 11,  1,    0,  8,  3,   -1 },
+       { 11,  7,  4,   11,  4,  2,    2,  4,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { 11,  7,  4,   11,  4,  2,    8,  3,  4,    3,  2,  4,   -1, -1, -1,   -1 },
+       {  2,  9, 10,    2,  7,  9,    2,  3,  7,    7,  4,  9,   -1, -1, -1,   -1 },
+       {  9, 10,  7,    9,  7,  4,   10,  2,  7,    8,  7,  0,    2,  0,  7,   -1 },
+       {  3,  7, 10,    3, 10,  2,    7,  4, 10,    1, 10,  0,    4,  0, 10,   -1 },
+       {  1, 10,  2,    8,  7,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  9,  1,    4,  1,  7,    7,  1,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  9,  1,    4,  1,  7,    0,  8,  1,    8,  7,  1,   -1, -1, -1,   -1 },
+       {  4,  0,  3,    7,  4,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  4,  8,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9, 10,  8,   10, 11,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  0,  9,    3,  9, 11,   11,  9, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  1, 10,    0, 10,  8,    8, 10, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  1, 10,   11,  3, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  2, 11,    1, 11,  9,    9, 11,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  0,  9,    3,  9, 11,    1,  2,  9,    2, 11,  9,   -1, -1, -1,   -1 },
+       {  0,  2, 11,    8,  0, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  3,  2, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  3,  8,    2,  8, 10,   10,  8,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  9, 10,  2,    0,  9,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  2,  3,  8,    2,  8, 10,    0,  1,  8,    1, 10,  8,   -1, -1, -1,   -1 },
+       {  1, 10,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  1,  3,  8,    9,  1,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  9,  1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       {  0,  3,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
+       { -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 }
+} };
+
+// Convert an edge index to the corner vertex indices for a cube.
+static const std::array< std::array<int32_t, 2>, 12> a2iEdgeConnection { {
+    {0, 1}, {1, 2}, {2, 3}, {3, 0},  // Bottom face.
+    {4, 5}, {5, 6}, {6, 7}, {7, 4},  // Top face.
+    {0, 4}, {1, 5}, {2, 6}, {3, 7}   // Side faces.
+} };
+
 // Marching Cubes core implementation. This routine must be fed an image volume.
 //
 // NOTE: This implementation borrows from the public domain implementation available at
@@ -117,314 +517,6 @@ Marching_Cubes_Implementation(
 
     // ============================================== Marching Cubes ================================================
 
-    // Use a curb vertex inclusivity int (8 bits) to determine which (of 12) edges are intersected by the ROI surface.
-    std::array<int32_t, 256> aiCubeEdgeFlags { {
-        0b000000000000, 0b000100001001, 0b001000000011, 0b001100001010, 0b010000000110, 0b010100001111, 0b011000000101,
-        0b011100001100, 0b100000001100, 0b100100000101, 0b101000001111, 0b101100000110, 0b110000001010, 0b110100000011,
-        0b111000001001, 0b111100000000, 0b000110010000, 0b000010011001, 0b001110010011, 0b001010011010, 0b010110010110,
-        0b010010011111, 0b011110010101, 0b011010011100, 0b100110011100, 0b100010010101, 0b101110011111, 0b101010010110,
-        0b110110011010, 0b110010010011, 0b111110011001, 0b111010010000, 0b001000110000, 0b001100111001, 0b000000110011,
-        0b000100111010, 0b011000110110, 0b011100111111, 0b010000110101, 0b010100111100, 0b101000111100, 0b101100110101,
-        0b100000111111, 0b100100110110, 0b111000111010, 0b111100110011, 0b110000111001, 0b110100110000, 0b001110100000,
-        0b001010101001, 0b000110100011, 0b000010101010, 0b011110100110, 0b011010101111, 0b010110100101, 0b010010101100,
-        0b101110101100, 0b101010100101, 0b100110101111, 0b100010100110, 0b111110101010, 0b111010100011, 0b110110101001,
-        0b110010100000, 0b010001100000, 0b010101101001, 0b011001100011, 0b011101101010, 0b000001100110, 0b000101101111,
-        0b001001100101, 0b001101101100, 0b110001101100, 0b110101100101, 0b111001101111, 0b111101100110, 0b100001101010,
-        0b100101100011, 0b101001101001, 0b101101100000, 0b010111110000, 0b010011111001, 0b011111110011, 0b011011111010,
-        0b000111110110, 0b000011111111, 0b001111110101, 0b001011111100, 0b110111111100, 0b110011110101, 0b111111111111,
-        0b111011110110, 0b100111111010, 0b100011110011, 0b101111111001, 0b101011110000, 0b011001010000, 0b011101011001,
-        0b010001010011, 0b010101011010, 0b001001010110, 0b001101011111, 0b000001010101, 0b000101011100, 0b111001011100,
-        0b111101010101, 0b110001011111, 0b110101010110, 0b101001011010, 0b101101010011, 0b100001011001, 0b100101010000,
-        0b011111000000, 0b011011001001, 0b010111000011, 0b010011001010, 0b001111000110, 0b001011001111, 0b000111000101,
-        0b000011001100, 0b111111001100, 0b111011000101, 0b110111001111, 0b110011000110, 0b101111001010, 0b101011000011,
-        0b100111001001, 0b100011000000, 0b100011000000, 0b100111001001, 0b101011000011, 0b101111001010, 0b110011000110,
-        0b110111001111, 0b111011000101, 0b111111001100, 0b000011001100, 0b000111000101, 0b001011001111, 0b001111000110,
-        0b010011001010, 0b010111000011, 0b011011001001, 0b011111000000, 0b100101010000, 0b100001011001, 0b101101010011,
-        0b101001011010, 0b110101010110, 0b110001011111, 0b111101010101, 0b111001011100, 0b000101011100, 0b000001010101,
-        0b001101011111, 0b001001010110, 0b010101011010, 0b010001010011, 0b011101011001, 0b011001010000, 0b101011110000,
-        0b101111111001, 0b100011110011, 0b100111111010, 0b111011110110, 0b111111111111, 0b110011110101, 0b110111111100,
-        0b001011111100, 0b001111110101, 0b000011111111, 0b000111110110, 0b011011111010, 0b011111110011, 0b010011111001,
-        0b010111110000, 0b101101100000, 0b101001101001, 0b100101100011, 0b100001101010, 0b111101100110, 0b111001101111,
-        0b110101100101, 0b110001101100, 0b001101101100, 0b001001100101, 0b000101101111, 0b000001100110, 0b011101101010,
-        0b011001100011, 0b010101101001, 0b010001100000, 0b110010100000, 0b110110101001, 0b111010100011, 0b111110101010,
-        0b100010100110, 0b100110101111, 0b101010100101, 0b101110101100, 0b010010101100, 0b010110100101, 0b011010101111,
-        0b011110100110, 0b000010101010, 0b000110100011, 0b001010101001, 0b001110100000, 0b110100110000, 0b110000111001,
-        0b111100110011, 0b111000111010, 0b100100110110, 0b100000111111, 0b101100110101, 0b101000111100, 0b010100111100,
-        0b010000110101, 0b011100111111, 0b011000110110, 0b000100111010, 0b000000110011, 0b001100111001, 0b001000110000,
-        0b111010010000, 0b111110011001, 0b110010010011, 0b110110011010, 0b101010010110, 0b101110011111, 0b100010010101,
-        0b100110011100, 0b011010011100, 0b011110010101, 0b010010011111, 0b010110010110, 0b001010011010, 0b001110010011,
-        0b000010011001, 0b000110010000, 0b111100000000, 0b111000001001, 0b110100000011, 0b110000001010, 0b101100000110,
-        0b101000001111, 0b100100000101, 0b100000001100, 0b011100001100, 0b011000000101, 0b010100001111, 0b010000000110,
-        0b001100001010, 0b001000000011, 0b000100001001, 0b000000000000
-    } };
-
-    // Determine which triangulation (0-5 triangles) is needed given the edge-surface intersections.
-    std::array< std::array<int32_t, 16>, 256> a2iTriangleConnectionTable  { {
-           { -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  1,  9,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  8,  3,    9,  8,  1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  3,    1,  2, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  2, 10,    0,  2,  9,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  8,  3,    2, 10,  8,   10,  9,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3, 11,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0, 11,  2,    8, 11,  0,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  9,  0,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1, 11,  2,    1,  9, 11,    9,  8, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3, 10,  1,   11, 10,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0, 10,  1,    0,  8, 10,    8, 11, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  9,  0,    3, 11,  9,   11, 10,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  8, 10,   10,  8, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  7,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  3,  0,    7,  3,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  1,  9,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  1,  9,    4,  7,  1,    7,  3,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 10,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  4,  7,    3,  0,  4,    1,  2, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  2, 10,    9,  0,  2,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2, 10,  9,    2,  9,  7,    2,  7,  3,    7,  9,  4,   -1, -1, -1,   -1 },
-           {  8,  4,  7,    3, 11,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 11,  4,  7,   11,  2,  4,    2,  0,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  0,  1,    8,  4,  7,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  7, 11,    9,  4, 11,    9, 11,  2,    9,  2,  1,   -1, -1, -1,   -1 },
-           {  3, 10,  1,    3, 11, 10,    7,  8,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1, 11, 10,    1,  4, 11,    1,  0,  4,    7, 11,  4,   -1, -1, -1,   -1 },
-           {  4,  7,  8,    9,  0, 11,    9, 11, 10,   11,  0,  3,   -1, -1, -1,   -1 },
-           {  4,  7, 11,    4, 11,  9,    9, 11, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  5,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  5,  4,    0,  8,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  5,  4,    1,  5,  0,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  5,  4,    8,  3,  5,    3,  1,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 10,    9,  5,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  0,  8,    1,  2, 10,    4,  9,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5,  2, 10,    5,  4,  2,    4,  0,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2, 10,  5,    3,  2,  5,    3,  5,  4,    3,  4,  8,   -1, -1, -1,   -1 },
-           {  9,  5,  4,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0, 11,  2,    0,  8, 11,    4,  9,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  5,  4,    0,  1,  5,    2,  3, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  1,  5,    2,  5,  8,    2,  8, 11,    4,  8,  5,   -1, -1, -1,   -1 },
-           { 10,  3, 11,   10,  1,  3,    9,  5,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  9,  5,    0,  8,  1,    8, 10,  1,    8, 11, 10,   -1, -1, -1,   -1 },
-           {  5,  4,  0,    5,  0, 11,    5, 11, 10,   11,  0,  3,   -1, -1, -1,   -1 },
-           {  5,  4,  8,    5,  8, 10,   10,  8, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  7,  8,    5,  7,  9,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  3,  0,    9,  5,  3,    5,  7,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  7,  8,    0,  1,  7,    1,  5,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  5,  3,    3,  5,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  7,  8,    9,  5,  7,   10,  1,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  1,  2,    9,  5,  0,    5,  3,  0,    5,  7,  3,   -1, -1, -1,   -1 },
-           {  8,  0,  2,    8,  2,  5,    8,  5,  7,   10,  5,  2,   -1, -1, -1,   -1 },
-           {  2, 10,  5,    2,  5,  3,    3,  5,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  7,  9,  5,    7,  8,  9,    3, 11,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  5,  7,    9,  7,  2,    9,  2,  0,    2,  7, 11,   -1, -1, -1,   -1 },
-           {  2,  3, 11,    0,  1,  8,    1,  7,  8,    1,  5,  7,   -1, -1, -1,   -1 },
-           { 11,  2,  1,   11,  1,  7,    7,  1,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  5,  8,    8,  5,  7,   10,  1,  3,   10,  3, 11,   -1, -1, -1,   -1 },
-           {  5,  7,  0,    5,  0,  9,    7, 11,  0,    1,  0, 10,   11, 10,  0,   -1 },
-           { 11, 10,  0,   11,  0,  3,   10,  5,  0,    8,  0,  7,    5,  7,  0,   -1 },
-           { 11, 10,  5,    7, 11,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  3,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  0,  1,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  8,  3,    1,  9,  8,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  6,  5,    2,  6,  1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  6,  5,    1,  2,  6,    3,  0,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  6,  5,    9,  0,  6,    0,  2,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5,  9,  8,    5,  8,  2,    5,  2,  6,    3,  2,  8,   -1, -1, -1,   -1 },
-           {  2,  3, 11,   10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 11,  0,  8,   11,  2,  0,   10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  1,  9,    2,  3, 11,    5, 10,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5, 10,  6,    1,  9,  2,    9, 11,  2,    9,  8, 11,   -1, -1, -1,   -1 },
-           {  6,  3, 11,    6,  5,  3,    5,  1,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8, 11,    0, 11,  5,    0,  5,  1,    5, 11,  6,   -1, -1, -1,   -1 },
-           {  3, 11,  6,    0,  3,  6,    0,  6,  5,    0,  5,  9,   -1, -1, -1,   -1 },
-           {  6,  5,  9,    6,  9, 11,   11,  9,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5, 10,  6,    4,  7,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  3,  0,    4,  7,  3,    6,  5, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  9,  0,    5, 10,  6,    8,  4,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  6,  5,    1,  9,  7,    1,  7,  3,    7,  9,  4,   -1, -1, -1,   -1 },
-           {  6,  1,  2,    6,  5,  1,    4,  7,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2,  5,    5,  2,  6,    3,  0,  4,    3,  4,  7,   -1, -1, -1,   -1 },
-           {  8,  4,  7,    9,  0,  5,    0,  6,  5,    0,  2,  6,   -1, -1, -1,   -1 },
-           {  7,  3,  9,    7,  9,  4,    3,  2,  9,    5,  9,  6,    2,  6,  9,   -1 },
-           {  3, 11,  2,    7,  8,  4,   10,  6,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5, 10,  6,    4,  7,  2,    4,  2,  0,    2,  7, 11,   -1, -1, -1,   -1 },
-           {  0,  1,  9,    4,  7,  8,    2,  3, 11,    5, 10,  6,   -1, -1, -1,   -1 },
-           {  9,  2,  1,    9, 11,  2,    9,  4, 11,    7, 11,  4,    5, 10,  6,   -1 },
-           {  8,  4,  7,    3, 11,  5,    3,  5,  1,    5, 11,  6,   -1, -1, -1,   -1 },
-           {  5,  1, 11,    5, 11,  6,    1,  0, 11,    7, 11,  4,    0,  4, 11,   -1 },
-           {  0,  5,  9,    0,  6,  5,    0,  3,  6,   11,  6,  3,    8,  4,  7,   -1 },
-           {  6,  5,  9,    6,  9, 11,    4,  7,  9,    7, 11,  9,   -1, -1, -1,   -1 },
-           { 10,  4,  9,    6,  4, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4, 10,  6,    4,  9, 10,    0,  8,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  0,  1,   10,  6,  0,    6,  4,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  3,  1,    8,  1,  6,    8,  6,  4,    6,  1, 10,   -1, -1, -1,   -1 },
-           {  1,  4,  9,    1,  2,  4,    2,  6,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  0,  8,    1,  2,  9,    2,  4,  9,    2,  6,  4,   -1, -1, -1,   -1 },
-           {  0,  2,  4,    4,  2,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  3,  2,    8,  2,  4,    4,  2,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  4,  9,   10,  6,  4,   11,  2,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  2,    2,  8, 11,    4,  9, 10,    4, 10,  6,   -1, -1, -1,   -1 },
-           {  3, 11,  2,    0,  1,  6,    0,  6,  4,    6,  1, 10,   -1, -1, -1,   -1 },
-           {  6,  4,  1,    6,  1, 10,    4,  8,  1,    2,  1, 11,    8, 11,  1,   -1 },
-           {  9,  6,  4,    9,  3,  6,    9,  1,  3,   11,  6,  3,   -1, -1, -1,   -1 },
-           {  8, 11,  1,    8,  1,  0,   11,  6,  1,    9,  1,  4,    6,  4,  1,   -1 },
-           {  3, 11,  6,    3,  6,  0,    0,  6,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  6,  4,  8,   11,  6,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  7, 10,  6,    7,  8, 10,    8,  9, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  7,  3,    0, 10,  7,    0,  9, 10,    6,  7, 10,   -1, -1, -1,   -1 },
-           { 10,  6,  7,    1, 10,  7,    1,  7,  8,    1,  8,  0,   -1, -1, -1,   -1 },
-           { 10,  6,  7,   10,  7,  1,    1,  7,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2,  6,    1,  6,  8,    1,  8,  9,    8,  6,  7,   -1, -1, -1,   -1 },
-           {  2,  6,  9,    2,  9,  1,    6,  7,  9,    0,  9,  3,    7,  3,  9,   -1 },
-           {  7,  8,  0,    7,  0,  6,    6,  0,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  7,  3,  2,    6,  7,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  3, 11,   10,  6,  8,   10,  8,  9,    8,  6,  7,   -1, -1, -1,   -1 },
-           {  2,  0,  7,    2,  7, 11,    0,  9,  7,    6,  7, 10,    9, 10,  7,   -1 },
-           {  1,  8,  0,    1,  7,  8,    1, 10,  7,    6,  7, 10,    2,  3, 11,   -1 },
-           { 11,  2,  1,   11,  1,  7,   10,  6,  1,    6,  7,  1,   -1, -1, -1,   -1 },
-           {  8,  9,  6,    8,  6,  7,    9,  1,  6,   11,  6,  3,    1,  3,  6,   -1 },
-           {  0,  9,  1,   11,  6,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  7,  8,  0,    7,  0,  6,    3, 11,  0,   11,  6,  0,   -1, -1, -1,   -1 },
-           {  7, 11,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  0,  8,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  1,  9,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  1,  9,    8,  3,  1,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  1,  2,    6, 11,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 10,    3,  0,  8,    6, 11,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  9,  0,    2, 10,  9,    6, 11,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  6, 11,  7,    2, 10,  3,   10,  8,  3,   10,  9,  8,   -1, -1, -1,   -1 },
-           {  7,  2,  3,    6,  2,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  7,  0,  8,    7,  6,  0,    6,  2,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  7,  6,    2,  3,  7,    0,  1,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  6,  2,    1,  8,  6,    1,  9,  8,    8,  7,  6,   -1, -1, -1,   -1 },
-           { 10,  7,  6,   10,  1,  7,    1,  3,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  7,  6,    1,  7, 10,    1,  8,  7,    1,  0,  8,   -1, -1, -1,   -1 },
-           {  0,  3,  7,    0,  7, 10,    0, 10,  9,    6, 10,  7,   -1, -1, -1,   -1 },
-           {  7,  6, 10,    7, 10,  8,    8, 10,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  6,  8,  4,   11,  8,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  6, 11,    3,  0,  6,    0,  4,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  6, 11,    8,  4,  6,    9,  0,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  4,  6,    9,  6,  3,    9,  3,  1,   11,  3,  6,   -1, -1, -1,   -1 },
-           {  6,  8,  4,    6, 11,  8,    2, 10,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 10,    3,  0, 11,    0,  6, 11,    0,  4,  6,   -1, -1, -1,   -1 },
-           {  4, 11,  8,    4,  6, 11,    0,  2,  9,    2, 10,  9,   -1, -1, -1,   -1 },
-           { 10,  9,  3,   10,  3,  2,    9,  4,  3,   11,  3,  6,    4,  6,  3,   -1 },
-           {  8,  2,  3,    8,  4,  2,    4,  6,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  4,  2,    4,  6,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  9,  0,    2,  3,  4,    2,  4,  6,    4,  3,  8,   -1, -1, -1,   -1 },
-           {  1,  9,  4,    1,  4,  2,    2,  4,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  1,  3,    8,  6,  1,    8,  4,  6,    6, 10,  1,   -1, -1, -1,   -1 },
-           { 10,  1,  0,   10,  0,  6,    6,  0,  4,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  6,  3,    4,  3,  8,    6, 10,  3,    0,  3,  9,   10,  9,  3,   -1 },
-           { 10,  9,  4,    6, 10,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  9,  5,    7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  3,    4,  9,  5,   11,  7,  6,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5,  0,  1,    5,  4,  0,    7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 11,  7,  6,    8,  3,  4,    3,  5,  4,    3,  1,  5,   -1, -1, -1,   -1 },
-           {  9,  5,  4,   10,  1,  2,    7,  6, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  6, 11,  7,    1,  2, 10,    0,  8,  3,    4,  9,  5,   -1, -1, -1,   -1 },
-           {  7,  6, 11,    5,  4, 10,    4,  2, 10,    4,  0,  2,   -1, -1, -1,   -1 },
-           {  3,  4,  8,    3,  5,  4,    3,  2,  5,   10,  5,  2,   11,  7,  6,   -1 },
-           {  7,  2,  3,    7,  6,  2,    5,  4,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  5,  4,    0,  8,  6,    0,  6,  2,    6,  8,  7,   -1, -1, -1,   -1 },
-           {  3,  6,  2,    3,  7,  6,    1,  5,  0,    5,  4,  0,   -1, -1, -1,   -1 },
-           {  6,  2,  8,    6,  8,  7,    2,  1,  8,    4,  8,  5,    1,  5,  8,   -1 },
-           {  9,  5,  4,   10,  1,  6,    1,  7,  6,    1,  3,  7,   -1, -1, -1,   -1 },
-           {  1,  6, 10,    1,  7,  6,    1,  0,  7,    8,  7,  0,    9,  5,  4,   -1 },
-           {  4,  0, 10,    4, 10,  5,    0,  3, 10,    6, 10,  7,    3,  7, 10,   -1 },
-           {  7,  6, 10,    7, 10,  8,    5,  4, 10,    4,  8, 10,   -1, -1, -1,   -1 },
-           {  6,  9,  5,    6, 11,  9,   11,  8,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  6, 11,    0,  6,  3,    0,  5,  6,    0,  9,  5,   -1, -1, -1,   -1 },
-           {  0, 11,  8,    0,  5, 11,    0,  1,  5,    5,  6, 11,   -1, -1, -1,   -1 },
-           {  6, 11,  3,    6,  3,  5,    5,  3,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 10,    9,  5, 11,    9, 11,  8,   11,  5,  6,   -1, -1, -1,   -1 },
-           {  0, 11,  3,    0,  6, 11,    0,  9,  6,    5,  6,  9,    1,  2, 10,   -1 },
-           { 11,  8,  5,   11,  5,  6,    8,  0,  5,   10,  5,  2,    0,  2,  5,   -1 },
-           {  6, 11,  3,    6,  3,  5,    2, 10,  3,   10,  5,  3,   -1, -1, -1,   -1 },
-           {  5,  8,  9,    5,  2,  8,    5,  6,  2,    3,  8,  2,   -1, -1, -1,   -1 },
-           {  9,  5,  6,    9,  6,  0,    0,  6,  2,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  5,  8,    1,  8,  0,    5,  6,  8,    3,  8,  2,    6,  2,  8,   -1 },
-           {  1,  5,  6,    2,  1,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  3,  6,    1,  6, 10,    3,  8,  6,    5,  6,  9,    8,  9,  6,   -1 },
-           { 10,  1,  0,   10,  0,  6,    9,  5,  0,    5,  6,  0,   -1, -1, -1,   -1 },
-           {  0,  3,  8,    5,  6, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  5,  6,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 11,  5, 10,    7,  5, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 11,  5, 10,   11,  7,  5,    8,  3,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5, 11,  7,    5, 10, 11,    1,  9,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 10,  7,  5,   10, 11,  7,    9,  8,  1,    8,  3,  1,   -1, -1, -1,   -1 },
-           { 11,  1,  2,   11,  7,  1,    7,  5,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  3,    1,  2,  7,    1,  7,  5,    7,  2, 11,   -1, -1, -1,   -1 },
-           {  9,  7,  5,    9,  2,  7,    9,  0,  2,    2, 11,  7,   -1, -1, -1,   -1 },
-           {  7,  5,  2,    7,  2, 11,    5,  9,  2,    3,  2,  8,    9,  8,  2,   -1 },
-           {  2,  5, 10,    2,  3,  5,    3,  7,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  2,  0,    8,  5,  2,    8,  7,  5,   10,  2,  5,   -1, -1, -1,   -1 },
-           {  9,  0,  1,    5, 10,  3,    5,  3,  7,    3, 10,  2,   -1, -1, -1,   -1 },
-           {  9,  8,  2,    9,  2,  1,    8,  7,  2,   10,  2,  5,    7,  5,  2,   -1 },
-           {  1,  3,  5,    3,  7,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  7,    0,  7,  1,    1,  7,  5,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  0,  3,    9,  3,  5,    5,  3,  7,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9,  8,  7,    5,  9,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5,  8,  4,    5, 10,  8,   10, 11,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  5,  0,  4,    5, 11,  0,    5, 10, 11,   11,  3,  0,   -1, -1, -1,   -1 },
-           {  0,  1,  9,    8,  4, 10,    8, 10, 11,   10,  4,  5,   -1, -1, -1,   -1 },
-           { 10, 11,  4,   10,  4,  5,   11,  3,  4,    9,  4,  1,    3,  1,  4,   -1 },
-           {  2,  5,  1,    2,  8,  5,    2, 11,  8,    4,  5,  8,   -1, -1, -1,   -1 },
-           {  0,  4, 11,    0, 11,  3,    4,  5, 11,    2, 11,  1,    5,  1, 11,   -1 },
-           {  0,  2,  5,    0,  5,  9,    2, 11,  5,    4,  5,  8,   11,  8,  5,   -1 },
-           {  9,  4,  5,    2, 11,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  5, 10,    3,  5,  2,    3,  4,  5,    3,  8,  4,   -1, -1, -1,   -1 },
-           {  5, 10,  2,    5,  2,  4,    4,  2,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3, 10,  2,    3,  5, 10,    3,  8,  5,    4,  5,  8,    0,  1,  9,   -1 },
-           {  5, 10,  2,    5,  2,  4,    1,  9,  2,    9,  4,  2,   -1, -1, -1,   -1 },
-           {  8,  4,  5,    8,  5,  3,    3,  5,  1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  4,  5,    1,  0,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  8,  4,  5,    8,  5,  3,    9,  0,  5,    0,  3,  5,   -1, -1, -1,   -1 },
-           {  9,  4,  5,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4, 11,  7,    4,  9, 11,    9, 10, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  8,  3,    4,  9,  7,    9, 11,  7,    9, 10, 11,   -1, -1, -1,   -1 },
-           {  1, 10, 11,    1, 11,  4,    1,  4,  0,    7,  4, 11,   -1, -1, -1,   -1 },
-           {  3,  1,  4,    3,  4,  8,    1, 10,  4,    7,  4, 11,   10, 11,  4,   -1 },
-           {  4, 11,  7,    9, 11,  4,    9,  2, 11,    9,  1,  2,   -1, -1, -1,   -1 },
-           {  9,  7,  4,    9, 11,  7,    9,  1, 11,    2, 11,  1,    0,  8,  3,   -1 },
-           { 11,  7,  4,   11,  4,  2,    2,  4,  0,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { 11,  7,  4,   11,  4,  2,    8,  3,  4,    3,  2,  4,   -1, -1, -1,   -1 },
-           {  2,  9, 10,    2,  7,  9,    2,  3,  7,    7,  4,  9,   -1, -1, -1,   -1 },
-           {  9, 10,  7,    9,  7,  4,   10,  2,  7,    8,  7,  0,    2,  0,  7,   -1 },
-           {  3,  7, 10,    3, 10,  2,    7,  4, 10,    1, 10,  0,    4,  0, 10,   -1 },
-           {  1, 10,  2,    8,  7,  4,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  9,  1,    4,  1,  7,    7,  1,  3,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  9,  1,    4,  1,  7,    0,  8,  1,    8,  7,  1,   -1, -1, -1,   -1 },
-           {  4,  0,  3,    7,  4,  3,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  4,  8,  7,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9, 10,  8,   10, 11,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  0,  9,    3,  9, 11,   11,  9, 10,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  1, 10,    0, 10,  8,    8, 10, 11,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  1, 10,   11,  3, 10,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  2, 11,    1, 11,  9,    9, 11,  8,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  0,  9,    3,  9, 11,    1,  2,  9,    2, 11,  9,   -1, -1, -1,   -1 },
-           {  0,  2, 11,    8,  0, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  3,  2, 11,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  3,  8,    2,  8, 10,   10,  8,  9,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  9, 10,  2,    0,  9,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  2,  3,  8,    2,  8, 10,    0,  1,  8,    1, 10,  8,   -1, -1, -1,   -1 },
-           {  1, 10,  2,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  1,  3,  8,    9,  1,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  9,  1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           {  0,  3,  8,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 },
-           { -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1, -1, -1,   -1 }
-    } };
-
-    // Convert an edge index to the corner vertex indices for a cube.
-    const std::array< std::array<int32_t, 2>, 12> a2iEdgeConnection { {
-        {0, 1}, {1, 2}, {2, 3}, {3, 0},  // Bottom face.
-        {4, 5}, {5, 6}, {6, 7}, {7, 4},  // Top face.
-        {0, 4}, {1, 5}, {2, 6}, {3, 7}   // Side faces.
-    } };
-
     // Storage for partially-connected meshes within the plane of a single image.
     // Data is processed one image at a time and we only merge meshes and de-duplicate out-of-plane vertices afterward.
     struct per_img_fv_mesh_t {
@@ -441,6 +533,69 @@ Marching_Cubes_Implementation(
     for(int64_t i = img_num_min; i <= img_num_max; ++i){
         per_img_fv_mesh[i - img_num_min].vscor.emplace_back(0);
     }
+
+    // Sample the signed distance function, if provided, on the lattice of Marching Cube voxel corners.
+    //
+    // Each image has a layer of (N_rows + 1) x (N_cols + 1) corners in the image plane and a layer offset by pxl_dz,
+    // which is shared with the next image's layer whenever they coincide. Each corner is evaluated at most once,
+    // rather than once for each of the (up to eight) cubes it belongs to.
+    std::vector<sdf_lattice> sdf_layers;
+    std::vector<std::pair<int64_t, int64_t>> sdf_img_layers; // The {lower, upper} layer for each shifted img num.
+    if(has_signed_dist_func){
+        const auto lipschitz = csg::sdf::lipschitz_bound(*sdf);
+        const csg::sdf::compiled_sdf sdf_tape(sdf);
+        std::vector<double> edge_margins;
+
+        const auto add_layer = [&](const planar_image<float,double> &img, const vec3<double> &shift){
+            sdf_lattice lat;
+            lat.origin = img.anchor + img.offset + shift;
+            lat.row_step = img.col_unit.unit() * img.pxl_dy;
+            lat.col_step = img.row_unit.unit() * img.pxl_dx;
+            lat.N_rows = img.rows + 1;
+            lat.N_cols = img.columns + 1;
+            lat.vals.resize(lat.N_rows * lat.N_cols);
+            sdf_layers.emplace_back(lat);
+            edge_margins.emplace_back( std::max<double>({ img.pxl_dx, img.pxl_dy, img.pxl_dz }) );
+            return static_cast<int64_t>(sdf_layers.size()) - 1L;
+        };
+
+        for(int64_t i = img_num_min; i <= img_num_max; ++i){
+            add_layer(img_adj.index_to_image(i).get(), zero3);
+        }
+        for(int64_t i = img_num_min; i <= img_num_max; ++i){
+            const auto &img = img_adj.index_to_image(i).get();
+            const auto l_lower = i - img_num_min;
+            const auto dz = img.ortho_unit() * img.pxl_dz;
+            const auto tol = std::min<double>({ img.pxl_dx, img.pxl_dy, img.pxl_dz }) * 1E-9;
+
+            int64_t l_upper = -1;
+            if(img_adj.index_present(i + 1)){
+                const auto &l = sdf_layers[l_lower];
+                const auto &u = sdf_layers[l_lower + 1];
+                if( (l.N_rows == u.N_rows)
+                &&  (l.N_cols == u.N_cols)
+                &&  ((l.origin + dz).distance(u.origin) <= tol)
+                &&  (l.row_step.distance(u.row_step) <= tol)
+                &&  (l.col_step.distance(u.col_step) <= tol) ){
+                    l_upper = l_lower + 1;
+                }
+            }
+            if(l_upper < 0) l_upper = add_layer(img, dz);
+            sdf_img_layers.emplace_back(l_lower, l_upper);
+        }
+
+        YLOGINFO("Sampling signed distance function on " << sdf_layers.size() << " layers");
+        {
+            work_queue<std::function<void(void)>> wq;
+            for(size_t l = 0; l < sdf_layers.size(); ++l){
+                wq.submit_task([&, l]() -> void {
+                    auto &lat = sdf_layers[l];
+                    Sample_SDF_Lattice(sdf_tape, lipschitz, inclusion_threshold, edge_margins[l], lat);
+                });
+            }
+        } // Wait for all tasks to complete.
+    }
+
     const auto vscor_index = [](int64_t N_rows, int64_t N_cols, 
                                 int64_t drow, int64_t dcol) -> int64_t {
         return N_cols * drow + dcol; // 2D index.
@@ -607,22 +762,36 @@ Marching_Cubes_Implementation(
                     const auto col_p1 = (col+1);
                     const auto col_is_adj = (col_p1 < N_cols);
 
+                    // Corner values must follow a2fVertexOffset: corner 1 is displaced along row_unit (i.e., to the
+                    // next column) and corner 3 is displaced along col_unit (i.e., to the next row).
                     afCubeValue[0] = img_refw.get().value(row, col, 0);
-                    afCubeValue[1] = (row_is_adj)                             ? img_refw.get().value(row_p1, col, 0)    : ExteriorVal;
+                    afCubeValue[1] = (col_is_adj)                             ? img_refw.get().value(row, col_p1, 0)    : ExteriorVal;
                     afCubeValue[2] = (row_is_adj && col_is_adj)               ? img_refw.get().value(row_p1, col_p1, 0) : ExteriorVal;
-                    afCubeValue[3] = (col_is_adj)                             ? img_refw.get().value(row, col_p1, 0)    : ExteriorVal;
+                    afCubeValue[3] = (row_is_adj)                             ? img_refw.get().value(row_p1, col, 0)    : ExteriorVal;
                     afCubeValue[4] = (img_is_adj)                             ? img_p1.get().value(row, col, 0)         : ExteriorVal;
-                    afCubeValue[5] = (row_is_adj && img_is_adj)               ? img_p1.get().value(row_p1, col, 0)      : ExteriorVal;
+                    afCubeValue[5] = (col_is_adj && img_is_adj)               ? img_p1.get().value(row, col_p1, 0)      : ExteriorVal;
                     afCubeValue[6] = (row_is_adj && col_is_adj && img_is_adj) ? img_p1.get().value(row_p1, col_p1, 0)   : ExteriorVal;
-                    afCubeValue[7] = (col_is_adj && img_is_adj)               ? img_p1.get().value(row, col_p1, 0)      : ExteriorVal;
+                    afCubeValue[7] = (row_is_adj && img_is_adj)               ? img_p1.get().value(row_p1, col, 0)      : ExteriorVal;
 
                 // Use the provided signed distance function to 'override' the image voxel intensities.
                 //
                 // This approach is slow but extremely flexible for meshing complicated shapes (e.g., Booleans).
                 }else{
-                    for(int32_t corner = 0; corner < 8; ++corner){
-                        afCubeValue[corner] = sdf->evaluate_sdf(pos + a2fVertexOffset[corner]);
-                    }
+                    const auto &[l_lower, l_upper] = sdf_img_layers[shifted_img_num];
+                    const auto &lower = sdf_layers[l_lower];
+                    const auto &upper = sdf_layers[l_upper];
+                    const auto l_i = (row * lower.N_cols) + col;
+                    const auto u_i = (row * upper.N_cols) + col;
+
+                    // Corner offsets follow a2fVertexOffset: +col, +col +row, +row for each layer.
+                    afCubeValue[0] = lower.vals[l_i];
+                    afCubeValue[1] = lower.vals[l_i + 1];
+                    afCubeValue[2] = lower.vals[l_i + lower.N_cols + 1];
+                    afCubeValue[3] = lower.vals[l_i + lower.N_cols];
+                    afCubeValue[4] = upper.vals[u_i];
+                    afCubeValue[5] = upper.vals[u_i + 1];
+                    afCubeValue[6] = upper.vals[u_i + upper.N_cols + 1];
+                    afCubeValue[7] = upper.vals[u_i + upper.N_cols];
                 }
                 
                 // Convert vertex inclusion to a bitmask.
@@ -799,8 +968,8 @@ Marching_Cubes_Implementation(
         return;
     };
 
-    // NOTE: if lower memory use is needed, we can further break down the traversal order and eagerly purge sidecar
-    // information (e.g., vscor for completely deduplicated submeshes).
+    // NOTE: if lower memory use is needed, use the streaming implementation below, which only retains the sidecar
+    //       information for the slab of images currently being processed.
     YLOGINFO("Extracting odd-numbered image meshes");
     {
         work_queue<std::function<void(void)>> wq;
@@ -1370,6 +1539,468 @@ Estimate_Surface_Mesh_Marching_Cubes(
                                           params );
 }
 
+// ------------------------------------------ Streaming Marching Cubes ------------------------------------------------
+
+fv_mesh_sink::fv_mesh_sink(fv_surface_mesh<double, uint64_t> &m) : mesh(m), first_vertex(m.vertices.size()) {}
+
+void fv_mesh_sink::add_vertex(const vec3<double> &v){
+    this->mesh.vertices.emplace_back(v);
+    return;
+}
+
+void fv_mesh_sink::add_face(uint64_t a, uint64_t b, uint64_t c){
+    this->mesh.faces.emplace_back( std::vector<uint64_t>{{ this->first_vertex + a,
+                                                           this->first_vertex + b,
+                                                           this->first_vertex + c }} );
+    return;
+}
+
+namespace {
+
+// An anonymous temporary file, which is removed when closed.
+struct spool_file {
+    std::FILE *f;
+
+    spool_file() : f(std::tmpfile()) {
+        if(this->f == nullptr){
+            throw std::runtime_error("Unable to create temporary file. Cannot continue.");
+        }
+    }
+    spool_file(const spool_file &) = delete;
+    spool_file& operator=(const spool_file &) = delete;
+    ~spool_file(){
+        std::fclose(this->f);
+    }
+
+    void write(const std::string &s){
+        if(std::fwrite(s.data(), 1, s.size(), this->f) != s.size()){
+            throw std::runtime_error("Unable to write to temporary file. Cannot continue.");
+        }
+        return;
+    }
+
+    void copy_to(std::ostream &os){
+        std::rewind(this->f);
+        std::array<char, 65536> buf;
+        size_t n = 0;
+        while(0 < (n = std::fread(buf.data(), 1, buf.size(), this->f))){
+            os.write(buf.data(), static_cast<std::streamsize>(n));
+        }
+        if(std::ferror(this->f) || !os){
+            throw std::runtime_error("Unable to copy temporary file. Cannot continue.");
+        }
+        return;
+    }
+};
+
+// Append the bytes of a value in little-endian order, regardless of the host byte order.
+template <class U, class T>
+void append_little_endian(std::string &out, T x){
+    static_assert(sizeof(U) == sizeof(T), "Types must have the same size");
+    U u;
+    std::memcpy(&u, &x, sizeof(u));
+    for(size_t i = 0; i < sizeof(u); ++i){
+        out.push_back( static_cast<char>((u >> (8 * i)) & 0xFF) );
+    }
+    return;
+}
+
+std::string format_ascii_coords(const vec3<double> &v){
+    std::array<char, 96> buf;
+    const auto n = std::snprintf(buf.data(), buf.size(), "%.17g %.17g %.17g", v.x, v.y, v.z);
+    return std::string(buf.data(), static_cast<size_t>(n));
+}
+
+struct PLY_mesh_sink : public mesh_sink {
+    std::ostream &os;
+    bool as_binary;
+    spool_file verts;
+    spool_file faces;
+    uint64_t N_verts = 0;
+    uint64_t N_faces = 0;
+    std::string buf;
+
+    PLY_mesh_sink(std::ostream &os, bool as_binary) : os(os), as_binary(as_binary) {}
+
+    void add_vertex(const vec3<double> &v) override {
+        buf.clear();
+        if(as_binary){
+            append_little_endian<uint64_t>(buf, v.x);
+            append_little_endian<uint64_t>(buf, v.y);
+            append_little_endian<uint64_t>(buf, v.z);
+        }else{
+            buf = format_ascii_coords(v) + "\n";
+        }
+        verts.write(buf);
+        ++N_verts;
+        return;
+    }
+
+    void add_face(uint64_t a, uint64_t b, uint64_t c) override {
+        if(std::numeric_limits<uint32_t>::max() < std::max<uint64_t>({ a, b, c })){
+            throw std::runtime_error("Too many vertices to write in PLY format. Cannot continue.");
+        }
+        buf.clear();
+        if(as_binary){
+            buf.push_back( static_cast<char>(3) );
+            append_little_endian<uint32_t>(buf, static_cast<uint32_t>(a));
+            append_little_endian<uint32_t>(buf, static_cast<uint32_t>(b));
+            append_little_endian<uint32_t>(buf, static_cast<uint32_t>(c));
+        }else{
+            buf = "3 " + std::to_string(a) + " " + std::to_string(b) + " " + std::to_string(c) + "\n";
+        }
+        faces.write(buf);
+        ++N_faces;
+        return;
+    }
+
+    void finish() override {
+        os << "ply\n"
+           << "format " << (as_binary ? "binary_little_endian" : "ascii") << " 1.0\n"
+           << "element vertex " << N_verts << "\n"
+           << "property double x\n"
+           << "property double y\n"
+           << "property double z\n"
+           << "element face " << N_faces << "\n"
+           << "property list uchar uint vertex_indices\n"
+           << "end_header\n";
+        verts.copy_to(os);
+        faces.copy_to(os);
+        os.flush();
+        return;
+    }
+};
+
+struct STL_mesh_sink : public mesh_sink {
+    std::ostream &os;
+    bool as_binary;
+    std::unique_ptr<spool_file> facets; // Only needed for binary files.
+    std::deque<vec3<double>> verts;
+    uint64_t first_vertex = 0; // The index of the first retained vertex.
+    uint64_t N_facets = 0;
+    std::string buf;
+
+    STL_mesh_sink(std::ostream &os, bool as_binary) : os(os), as_binary(as_binary) {
+        if(as_binary){
+            facets = std::make_unique<spool_file>();
+        }else{
+            os << "solid dicomautomaton\n";
+        }
+    }
+
+    void add_vertex(const vec3<double> &v) override {
+        verts.emplace_back(v);
+        return;
+    }
+
+    void add_face(uint64_t a, uint64_t b, uint64_t c) override {
+        const auto &A = verts.at(a - first_vertex);
+        const auto &B = verts.at(b - first_vertex);
+        const auto &C = verts.at(c - first_vertex);
+        const auto cross = (B - A).Cross(C - A);
+        const auto length = cross.length();
+        const auto N = (0.0 < length) ? cross / length : vec3<double>(0.0, 0.0, 0.0);
+
+        buf.clear();
+        if(as_binary){
+            for(const auto &v : { N, A, B, C }){
+                append_little_endian<uint32_t>(buf, static_cast<float>(v.x));
+                append_little_endian<uint32_t>(buf, static_cast<float>(v.y));
+                append_little_endian<uint32_t>(buf, static_cast<float>(v.z));
+            }
+            append_little_endian<uint16_t>(buf, static_cast<uint16_t>(0)); // Attribute byte count.
+            facets->write(buf);
+        }else{
+            os << "facet normal " << format_ascii_coords(N) << "\n"
+               << "  outer loop\n"
+               << "    vertex " << format_ascii_coords(A) << "\n"
+               << "    vertex " << format_ascii_coords(B) << "\n"
+               << "    vertex " << format_ascii_coords(C) << "\n"
+               << "  endloop\n"
+               << "endfacet\n";
+        }
+        ++N_facets;
+        return;
+    }
+
+    void release_vertices(uint64_t n) override {
+        while( (first_vertex < n) && !verts.empty() ){
+            verts.pop_front();
+            ++first_vertex;
+        }
+        return;
+    }
+
+    void finish() override {
+        if(as_binary){
+            if(std::numeric_limits<uint32_t>::max() < N_facets){
+                throw std::runtime_error("Too many faces to write in binary STL format. Cannot continue.");
+            }
+            const std::string header = "DICOMautomaton binary STL"; // Must not begin with 'solid'.
+            buf.assign(80, ' ');
+            buf.replace(0, header.size(), header);
+            append_little_endian<uint32_t>(buf, static_cast<uint32_t>(N_facets));
+            os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            facets->copy_to(os);
+        }else{
+            os << "endsolid dicomautomaton\n";
+        }
+        os.flush();
+        return;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<mesh_sink>
+make_PLY_mesh_sink(std::ostream &os, bool as_binary){
+    return std::make_unique<PLY_mesh_sink>(os, as_binary);
+}
+
+std::unique_ptr<mesh_sink>
+make_STL_mesh_sink(std::ostream &os, bool as_binary){
+    return std::make_unique<STL_mesh_sink>(os, as_binary);
+}
+
+// This sub-routine performs the Marching Cubes algorithm for the provided images, streaming the mesh to a sink.
+//
+// Vertices lie on the edges of a lattice with one point per voxel (plus a layer of 'exterior' points past the last
+// row, column, and image). Each vertex is identified by the lattice edge it lies on, or by a lattice point if the
+// surface crosses within the merge tolerance of the point. This identifies shared vertices exactly, without comparing
+// positions, so cubes can be processed in any order and only the vertices on the most recent lattice layer need to be
+// retained between slabs.
+//
+// Cube layers within a slab are processed in parallel, and then vertices and faces are assigned sequentially in
+// image order so the output does not depend on scheduling.
+//
+void
+Estimate_Surface_Mesh_Marching_Cubes(
+        const std::list<std::reference_wrapper<planar_image<float,double>>>& grid_imgs,
+        double inclusion_threshold, // The voxel value threshold demarcating surface 'interior' and 'exterior.'
+        bool below_is_interior,  // Controls how the inclusion_threshold is interpretted.
+                                 // If true, anything <= is considered to be interior to the surface.
+                                 // If false, anything >= is considered to be interior to the surface.
+        mesh_sink &sink,
+        Parameters params ){
+
+    if(grid_imgs.empty()){
+        throw std::invalid_argument("An insufficient number of images was provided. Cannot continue.");
+    }
+    if(!Images_Form_Rectilinear_Grid(grid_imgs)){
+        throw std::logic_error("Grid images do not form a rectilinear grid. Cannot continue");
+    }
+
+    const double ExteriorVal = inclusion_threshold + (below_is_interior ? 1.0 : -1.0);
+    const auto GridZ = grid_imgs.front().get().image_plane().N_0;
+    planar_image_adjacency<float,double> img_adj( grid_imgs, {}, GridZ );
+    const auto [img_num_min, img_num_max] = img_adj.get_min_max_indices();
+
+    const auto &img_0 = img_adj.index_to_image(img_num_min).get();
+    const auto N_rows = img_0.rows;
+    const auto N_cols = img_0.columns;
+    const auto N_layers = (img_num_max - img_num_min) + 1; // Number of cube layers, one above each image.
+    for(int64_t i = img_num_min; i <= img_num_max; ++i){
+        const auto &img = img_adj.index_to_image(i).get();
+        if( (N_rows != img.rows)
+        ||  (N_cols != img.columns) ){
+            throw std::invalid_argument("Regular grids are required for this algorithm -- images must all have the same number of rows and columns");
+        }
+    }
+
+    const auto pxl_dx = img_0.pxl_dx;
+    const auto pxl_dy = img_0.pxl_dy;
+    const auto pxl_dz = img_0.pxl_dz;
+    const auto img_unit = img_0.ortho_unit();
+
+    // Tolerance for merging vertices with lattice points, which matches the in-memory implementation.
+    constexpr auto machine_eps = std::numeric_limits<double>::epsilon();
+    const auto dvec3_tol = std::max<double>(
+                               std::min<double>( { pxl_dx, pxl_dy, pxl_dz } ) * 1E-4,
+                               std::sqrt(machine_eps) * 100.0 ); // Guard against pxl_dz = 0.
+
+    // Lattice points and edges. Each point has three edges (along row_unit, col_unit, and img_unit), and a lattice
+    // point itself is referred to as the fourth 'edge.'
+    const auto N_lattice_rows = N_rows + 1;
+    const auto N_lattice_cols = N_cols + 1;
+    const auto N_layer_points = static_cast<uint64_t>(N_lattice_rows * N_lattice_cols);
+    const auto edge_key = [&](int64_t layer, int64_t row, int64_t col, int64_t axis) -> uint64_t {
+        return (( static_cast<uint64_t>(layer) * N_lattice_rows + row) * N_lattice_cols + col) * 4U + axis;
+    };
+    const auto key_layer = [&](uint64_t key) -> int64_t {
+        return static_cast<int64_t>((key / 4U) / N_layer_points);
+    };
+
+    const auto lattice_value = [&](int64_t layer, int64_t row, int64_t col) -> double {
+        const auto i = img_num_min + layer;
+        if( (row < N_rows)
+        &&  (col < N_cols)
+        &&  img_adj.index_present(i) ){
+            return img_adj.index_to_image(i).get().value(row, col, 0);
+        }
+        return ExteriorVal;
+    };
+    const auto lattice_position = [&](int64_t layer, int64_t row, int64_t col) -> vec3<double> {
+        const auto i = img_num_min + layer;
+        if(img_adj.index_present(i)){
+            return img_adj.index_to_image(i).get().position(row, col);
+        }
+        return img_adj.index_to_image(i - 1).get().position(row, col) + img_unit * pxl_dz;
+    };
+
+    // Cube corners as {layer, row, col} offsets. These match a2fVertexOffset in the in-memory implementation.
+    const std::array< std::array<int64_t, 3>, 8> corner_offsets { {
+        {0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0},
+        {1, 0, 0}, {1, 0, 1}, {1, 1, 1}, {1, 1, 0}
+    } };
+
+    // The corners of each edge, ordered so the second corner is displaced along the positive lattice direction.
+    const std::array< std::array<int32_t, 3>, 12> edge_corners_axis { {
+        {0, 1, 0}, {1, 2, 1}, {3, 2, 0}, {0, 3, 1},  // Bottom face.
+        {4, 5, 0}, {5, 6, 1}, {7, 6, 0}, {4, 7, 1},  // Top face.
+        {0, 4, 2}, {1, 5, 2}, {2, 6, 2}, {3, 7, 2}   // Side faces.
+    } };
+    const std::array<double, 3> axis_length { { pxl_dx, pxl_dy, pxl_dz } };
+
+    // Faces generated in one cube layer, referring to vertices by lattice edge.
+    struct cube_layer_t {
+        std::vector<std::array<uint64_t, 3>> faces;
+        std::unordered_map<uint64_t, vec3<double>> verts;
+    };
+
+    const auto extract_cube_layer = [&](int64_t layer, cube_layer_t &out) -> void {
+        for(int64_t row = 0; row < N_rows; ++row){
+            for(int64_t col = 0; col < N_cols; ++col){
+                std::array<double, 8> afCubeValue;
+                for(int32_t corner = 0; corner < 8; ++corner){
+                    const auto &o = corner_offsets[corner];
+                    afCubeValue[corner] = lattice_value(layer + o[0], row + o[1], col + o[2]);
+                }
+
+                int32_t iFlagIndex = 0;
+                for(int32_t corner = 0; corner < 8; ++corner){
+                    if(below_is_interior){
+                        if(afCubeValue[corner] <= inclusion_threshold) iFlagIndex |= (1 << corner);
+                    }else{
+                        if(afCubeValue[corner] >= inclusion_threshold) iFlagIndex |= (1 << corner);
+                    }
+                }
+                const int32_t iEdgeFlags = aiCubeEdgeFlags[iFlagIndex];
+                if(iEdgeFlags == 0) continue;
+
+                // Identify the vertex on each involved edge.
+                std::array<uint64_t, 12> asEdgeKey;
+                for(int32_t edge = 0; edge < 12; ++edge){
+                    if(!(iEdgeFlags & (1 << edge))) continue;
+
+                    const auto [corner_A, corner_B, axis] = edge_corners_axis[edge];
+                    const auto &o_A = corner_offsets[corner_A];
+                    const auto &o_B = corner_offsets[corner_B];
+                    const double value_A = afCubeValue[corner_A];
+                    const double value_B = afCubeValue[corner_B];
+
+                    const double lin_interp = (inclusion_threshold - value_A) / (value_B - value_A);
+                    const double surf_dl = std::isfinite(lin_interp) ? lin_interp : static_cast<double>(0.5);
+                    if(!isininc(0.0,surf_dl,1.0)){
+                        throw std::logic_error("Interpolation of surface-edge intersection failed. Refusing to continue");
+                    }
+
+                    const auto length = axis_length[axis];
+                    uint64_t key = 0;
+                    vec3<double> pos;
+                    if((surf_dl * length) < dvec3_tol){
+                        key = edge_key(layer + o_A[0], row + o_A[1], col + o_A[2], 3);
+                        if(out.verts.count(key) == 0) pos = lattice_position(layer + o_A[0], row + o_A[1], col + o_A[2]);
+                    }else if(((1.0 - surf_dl) * length) < dvec3_tol){
+                        key = edge_key(layer + o_B[0], row + o_B[1], col + o_B[2], 3);
+                        if(out.verts.count(key) == 0) pos = lattice_position(layer + o_B[0], row + o_B[1], col + o_B[2]);
+                    }else{
+                        key = edge_key(layer + o_A[0], row + o_A[1], col + o_A[2], axis);
+                        if(out.verts.count(key) == 0){
+                            const auto A = lattice_position(layer + o_A[0], row + o_A[1], col + o_A[2]);
+                            const auto B = lattice_position(layer + o_B[0], row + o_B[1], col + o_B[2]);
+                            pos = A + (B - A) * surf_dl;
+                        }
+                    }
+                    out.verts.emplace(key, pos);
+                    asEdgeKey[edge] = key;
+                }
+
+                for(int32_t tri = 0; tri < 5; ++tri){
+                    if(a2iTriangleConnectionTable[iFlagIndex][3*tri] < 0) break;
+
+                    const auto A = asEdgeKey[ a2iTriangleConnectionTable[iFlagIndex][3*tri + 0] ];
+                    const auto B = asEdgeKey[ a2iTriangleConnectionTable[iFlagIndex][3*tri + 1] ];
+                    const auto C = asEdgeKey[ a2iTriangleConnectionTable[iFlagIndex][3*tri + 2] ];
+
+                    // Faces with merged vertices are degenerate and can be omitted without creating holes.
+                    if( (A == B) || (A == C) || (B == C) ) continue;
+
+                    // The table orders vertices clockwise when viewed from outside.
+                    out.faces.push_back({{ A, C, B }});
+                }
+            }
+        }
+        return;
+    };
+
+    const auto N_slab = std::max<int64_t>(1, params.SlabImages);
+
+    // Assigned vertex numbers, grouped by lattice layer so they can be discarded when they are no longer reachable.
+    std::map<int64_t, std::unordered_map<uint64_t, uint64_t>> vert_nums;
+    uint64_t N_verts = 0;
+    uint64_t N_faces = 0;
+
+    std::vector<cube_layer_t> slab;
+    for(int64_t slab_begin = 0; slab_begin < N_layers; slab_begin += N_slab){
+        const auto slab_end = std::min(N_layers, slab_begin + N_slab);
+        slab.clear();
+        slab.resize(slab_end - slab_begin);
+        {
+            work_queue<std::function<void(void)>> wq;
+            for(int64_t layer = slab_begin; layer < slab_end; ++layer){
+                wq.submit_task([&, layer]() -> void {
+                    extract_cube_layer(layer, slab[layer - slab_begin]);
+                });
+            }
+        } // Wait for all tasks to complete.
+
+        for(int64_t layer = slab_begin; layer < slab_end; ++layer){
+            auto &cl = slab[layer - slab_begin];
+            const auto N_verts_prev = N_verts;
+            for(const auto &face : cl.faces){
+                std::array<uint64_t, 3> nums;
+                for(size_t i = 0; i < nums.size(); ++i){
+                    auto &m = vert_nums[ key_layer(face[i]) ];
+                    const auto [it, inserted] = m.emplace(face[i], N_verts);
+                    if(inserted){
+                        sink.add_vertex( cl.verts.at(face[i]) );
+                        ++N_verts;
+                    }
+                    nums[i] = it->second;
+                }
+                sink.add_face(nums[0], nums[1], nums[2]);
+                ++N_faces;
+            }
+            cl = cube_layer_t();
+
+            // Only the next lattice layer is shared with later cube layers.
+            while( !vert_nums.empty()
+            &&     (vert_nums.begin()->first <= layer) ){
+                vert_nums.erase(vert_nums.begin());
+            }
+            sink.release_vertices(N_verts_prev);
+        }
+
+        YLOGINFO("Completed " << slab_end << " of " << N_layers
+              << " --> " << static_cast<int>(1000.0*(slab_end)/N_layers)/10.0 << "% done");
+    }
+    sink.finish();
+
+    YLOGINFO("The triangulated surface has " << N_verts << " vertices"
+             " and " << N_faces << " faces");
+    return;
+}
+
 // This sub-routine assumes ROI contours are 'cylindrically' extruded 2D polygons with a fixed separation.
 // ROI inclusivity is separately pre-computed before surface probing by generating an inclusivity mask on a
 // custom-fitted planar image collection. This is done for performance purposes and so inclusivity and surface
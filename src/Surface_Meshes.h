@@ -5,8 +5,12 @@
 #include <string>
 #include <utility>
 #include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
 
 #include "CSG_SDF.h"
+#include "CSG_SDF_Tape.h"
 
 #ifdef DCMA_USE_CGAL
     #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
@@ -44,8 +48,49 @@ namespace dcma_surface_meshes {
         //   mesh should be nearly identical to the input contours. Note that meshes with high quality will generally have too
         //   many vertices to reasonably dilate or erode.
         ReproductionQuality RQ = ReproductionQuality::High;
+
+        // The number of images processed together by the streaming Marching Cubes implementation. Memory use grows
+        // with this number, but so does the amount of work that can be performed in parallel.
+        int64_t SlabImages = 16;
+    };
+
+    // Receives the vertices and faces of a mesh as they are generated.
+    //
+    // Vertices are numbered sequentially, starting at zero, in the order they are received. Faces only refer to
+    // vertices that have already been received.
+    struct mesh_sink {
+        virtual ~mesh_sink() = default;
+
+        virtual void add_vertex(const vec3<double> &v) = 0;
+        virtual void add_face(uint64_t a, uint64_t b, uint64_t c) = 0;
+
+        // Faces received afterward will not refer to any vertex numbered below n.
+        virtual void release_vertices(uint64_t /*n*/){}
+
+        // Called once, after all vertices and faces have been received.
+        virtual void finish(){}
     };
 
+    // Appends vertices and faces to a mesh. Vertices already in the mesh are left as-is.
+    struct fv_mesh_sink : public mesh_sink {
+        fv_surface_mesh<double, uint64_t> &mesh;
+        uint64_t first_vertex;
+
+        explicit fv_mesh_sink(fv_surface_mesh<double, uint64_t> &mesh);
+        void add_vertex(const vec3<double> &v) override;
+        void add_face(uint64_t a, uint64_t b, uint64_t c) override;
+    };
+
+    // Writes vertices and faces to a stream in PLY or STL format.
+    //
+    // Both formats require element counts before the elements, so PLY elements and binary STL facets are spooled to
+    // temporary files until finish() is called. STL sinks only retain vertices until they are released.
+    std::unique_ptr<mesh_sink>
+    make_PLY_mesh_sink(std::ostream &os, bool as_binary);
+
+    std::unique_ptr<mesh_sink>
+    make_STL_mesh_sink(std::ostream &os, bool as_binary);
+
     fv_surface_mesh<double, uint64_t>
     Estimate_Surface_Mesh_Marching_Cubes(
             const std::list<std::reference_wrapper<contour_collection<double>>>& cc_ROIs,
@@ -70,6 +115,47 @@ namespace dcma_surface_meshes {
                                      // If false, anything >= is considered to be interior to the surface.
             Parameters p );
 
+    // Streaming variant of the above, which passes the mesh to a sink as it is generated.
+    //
+    // Images are processed in slabs of p.SlabImages adjacent images, so memory use is proportional to the slab size
+    // rather than the number of images. Faces are oriented outward (as determined by the threshold) without a separate
+    // orientation pass. Vertices and faces are ordered differently than the non-streaming variant.
+    void
+    Estimate_Surface_Mesh_Marching_Cubes(
+            const std::list<std::reference_wrapper<planar_image<float,double>>>& grid_imgs,
+            double inclusion_threshold,
+            bool below_is_interior,
+            mesh_sink &sink,
+            Parameters p );
+
+    // A planar lattice of signed distance function samples.
+    struct sdf_lattice {
+        vec3<double> origin;   // Position of lattice point (0,0).
+        vec3<double> row_step; // Displacement between adjacent lattice rows.
+        vec3<double> col_step; // Displacement between adjacent lattice columns.
+        int64_t N_rows = 0;
+        int64_t N_cols = 0;
+        std::vector<double> vals; // Row-major. Must hold N_rows * N_cols values.
+
+        vec3<double> position(double row, double col) const {
+            return this->origin + this->row_step * row + this->col_step * col;
+        }
+    };
+
+    // Sample the signed distance function at the lattice points.
+    //
+    // Blocks of points are bounded using a single evaluation at the block centre, since the SDF changes by at most
+    // 'lipschitz' per unit distance. Blocks that lie entirely on one side of the threshold, even when expanded by
+    // 'edge_margin', are filled with a conservative bound instead of being sampled. Otherwise the block is split and
+    // refined, so only a narrow band of points near the surface are evaluated individually.
+    void
+    Sample_SDF_Lattice(
+            const csg::sdf::compiled_sdf &sdf,
+            double lipschitz,
+            double threshold,
+            double edge_margin,
+            sdf_lattice &lat );
+
 #ifdef DCMA_USE_CGAL
     using Kernel = CGAL::Exact_predicates_inexact_constructions_kernel;
     using Polyhedron = CGAL::Polyhedron_3<Kernel>;
@@ -0,0 +1,341 @@
+//Surface_Meshes_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the Marching Cubes and signed distance function sampling routines defined in
+// Surface_Meshes.cc.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "CSG_SDF.h"
+#include "CSG_SDF_Tape.h"
+#include "Surface_Meshes.h"
+
+
+// A stack of images containing a sphere-like distance field centred in the volume.
+static
+planar_image_collection<float,double>
+make_sphere_stack(int64_t slices, int64_t rows, int64_t cols, const vec3<double> &pxl, bool as_mask, double radius){
+    const vec3<double> centre( 0.5 * pxl.x * static_cast<double>(cols),
+                               0.5 * pxl.y * static_cast<double>(rows),
+                               0.5 * pxl.z * static_cast<double>(slices) );
+    planar_image_collection<float,double> coll;
+    for(int64_t z = 0; z < slices; ++z){
+        planar_image<float,double> img;
+        img.init_orientation(vec3<double>(1.0, 0.0, 0.0), vec3<double>(0.0, 1.0, 0.0));
+        img.init_buffer(rows, cols, 1);
+        img.init_spatial(pxl.x, pxl.y, pxl.z, vec3<double>(0.0, 0.0, 0.0), vec3<double>(0.0, 0.0, pxl.z * static_cast<double>(z)));
+        for(int64_t r = 0; r < rows; ++r){
+            for(int64_t c = 0; c < cols; ++c){
+                const auto p = img.position(r, c) - centre;
+                const auto d = p.length() + 0.3 * std::sin(p.x);
+                img.reference(r, c, 0) = static_cast<float>( as_mask ? ((d <= radius) ? 1.0 : 0.0) : d );
+            }
+        }
+        coll.images.push_back(img);
+    }
+    return coll;
+}
+
+static
+std::list<std::reference_wrapper<planar_image<float,double>>>
+as_refs(planar_image_collection<float,double> &coll){
+    std::list<std::reference_wrapper<planar_image<float,double>>> out;
+    for(auto &img : coll.images) out.emplace_back(std::ref(img));
+    return out;
+}
+
+// Require the mesh to be closed and consistently oriented, with every vertex used, and return the signed volume.
+static
+double
+require_closed_and_oriented(const fv_surface_mesh<double, uint64_t> &mesh){
+    std::map<std::pair<uint64_t, uint64_t>, int64_t> half_edges;
+    std::vector<bool> used(mesh.vertices.size(), false);
+    double volume = 0.0;
+    for(const auto &f : mesh.faces){
+        REQUIRE( f.size() == 3 );
+        for(size_t i = 0; i < 3; ++i){
+            half_edges[{ f[i], f[(i + 1) % 3] }] += 1;
+            used.at(f[i]) = true;
+        }
+        const auto &A = mesh.vertices.at(f[0]);
+        const auto &B = mesh.vertices.at(f[1]);
+        const auto &C = mesh.vertices.at(f[2]);
+        volume += A.Dot(B.Cross(C)) / 6.0;
+    }
+    for(const auto &[e, n] : half_edges){
+        REQUIRE( n == 1 );
+        REQUIRE( half_edges.count({ e.second, e.first }) == 1 );
+    }
+    for(const auto b : used) REQUIRE( b );
+    return volume;
+}
+
+// The number of distinct (undirected) edges.
+static
+int64_t
+count_edges(const fv_surface_mesh<double, uint64_t> &mesh){
+    std::set<std::pair<uint64_t, uint64_t>> edges;
+    for(const auto &f : mesh.faces){
+        for(size_t i = 0; i < f.size(); ++i){
+            const auto A = f[i];
+            const auto B = f[(i + 1) % f.size()];
+            edges.insert({ std::min(A, B), std::max(A, B) });
+        }
+    }
+    return static_cast<int64_t>(edges.size());
+}
+
+
+// A non-trivial signed distance function: a chamfered union of a sphere and a rotated box, extruded from a plane.
+static
+std::shared_ptr<csg::sdf::node>
+make_chamfered_extrusion(){
+    auto ball = std::make_shared<csg::sdf::shape::sphere>(4.0);
+    auto moved = std::make_shared<csg::sdf::op::translate>(vec3<double>(2.5, -1.0, 0.0));
+    moved->children.emplace_back(ball);
+
+    auto box = std::make_shared<csg::sdf::shape::aa_box>(vec3<double>(5.0, 1.5, 3.0));
+    auto turned = std::make_shared<csg::sdf::op::rotate>(vec3<double>(0.0, 0.0, 1.0), 0.6);
+    turned->children.emplace_back(box);
+
+    auto joined = std::make_shared<csg::sdf::op::chamfer_join>(1.2);
+    joined->children.emplace_back(moved);
+    joined->children.emplace_back(turned);
+
+    auto extruded = std::make_shared<csg::sdf::op::extrude>(2.5, plane<double>(vec3<double>(0.0, 0.0, 0.5),
+                                                                             vec3<double>(0.0, 0.0, 1.0)));
+    extruded->children.emplace_back(joined);
+    return extruded;
+}
+
+// Forwards to another tree, but hides it from the Lipschitz analysis so that every lattice point is evaluated.
+struct opaque_node : public csg::sdf::node {
+    std::shared_ptr<csg::sdf::node> wrapped;
+
+    double evaluate_sdf(const vec3<double>& pos) const override {
+        return this->wrapped->evaluate_sdf(pos);
+    }
+    csg::sdf::aa_bbox evaluate_aa_bbox() const override {
+        return this->wrapped->evaluate_aa_bbox();
+    }
+};
+
+
+TEST_CASE( "Estimate_Surface_Mesh_Marching_Cubes streaming" ){
+    const vec3<double> pxl(0.9, 1.1, 1.3);
+    const double radius = 7.3;
+    const double expected_volume = 4.0 / 3.0 * M_PI * std::pow(radius, 3.0);
+    dcma_surface_meshes::Parameters params;
+
+    SUBCASE("surfaces are closed, oriented outward, and independent of the slab size"){
+        auto coll = make_sphere_stack(22, 24, 27, pxl, false, radius);
+        auto imgs = as_refs(coll);
+        imgs.reverse(); // Image order should not matter.
+
+        std::vector<fv_surface_mesh<double, uint64_t>> meshes;
+        for(const int64_t slab : { 1, 5, 64 }){
+            params.SlabImages = slab;
+            meshes.emplace_back();
+            dcma_surface_meshes::fv_mesh_sink sink(meshes.back());
+            dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, radius, true, sink, params);
+
+            const auto volume = require_closed_and_oriented(meshes.back());
+            REQUIRE( volume == doctest::Approx(expected_volume).epsilon(0.03) );
+        }
+        REQUIRE( meshes[0].vertices == meshes[1].vertices );
+        REQUIRE( meshes[0].faces == meshes[2].faces );
+
+        // Inverting the threshold sense should not change the orientation.
+        for(auto &img : coll.images){
+            for(auto &v : img.data) v = -v;
+        }
+        fv_surface_mesh<double, uint64_t> inverted;
+        dcma_surface_meshes::fv_mesh_sink sink(inverted);
+        dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, -radius, false, sink, params);
+        REQUIRE( require_closed_and_oriented(inverted) == doctest::Approx(expected_volume).epsilon(0.03) );
+    }
+
+    SUBCASE("vertices coinciding with voxel centres are merged"){
+        // The threshold is reached exactly at voxel centres, so every vertex lies on the lattice.
+        auto coll = make_sphere_stack(15, 14, 13, pxl, true, 4.5);
+        auto imgs = as_refs(coll);
+        fv_surface_mesh<double, uint64_t> mesh;
+        dcma_surface_meshes::fv_mesh_sink sink(mesh);
+        dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, 1.0, false, sink, params);
+        REQUIRE( 0 < mesh.faces.size() );
+        REQUIRE( 0.0 < require_closed_and_oriented(mesh) );
+    }
+
+    SUBCASE("meshes can be written directly to PLY and STL"){
+        auto coll = make_sphere_stack(12, 12, 12, vec3<double>(1.0, 1.0, 1.0), false, 4.0);
+        auto imgs = as_refs(coll);
+        params.SlabImages = 2;
+
+        fv_surface_mesh<double, uint64_t> mesh;
+        dcma_surface_meshes::fv_mesh_sink sink(mesh);
+        dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, 4.0, true, sink, params);
+        const auto N_verts = mesh.vertices.size();
+        const auto N_faces = mesh.faces.size();
+
+        for(const bool as_binary : { false, true }){
+            std::stringstream ply;
+            auto ply_sink = dcma_surface_meshes::make_PLY_mesh_sink(ply, as_binary);
+            dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, 4.0, true, *ply_sink, params);
+
+            const auto s = ply.str();
+            REQUIRE( s.find("element vertex " + std::to_string(N_verts) + "\n") != std::string::npos );
+            REQUIRE( s.find("element face " + std::to_string(N_faces) + "\n") != std::string::npos );
+            const auto body = s.size() - (s.find("end_header\n") + 11);
+            if(as_binary){
+                REQUIRE( body == (N_verts * 24 + N_faces * 13) );
+            }
+
+            std::stringstream stl;
+            auto stl_sink = dcma_surface_meshes::make_STL_mesh_sink(stl, as_binary);
+            dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, 4.0, true, *stl_sink, params);
+            if(as_binary){
+                REQUIRE( stl.str().size() == (84 + N_faces * 50) );
+            }else{
+                const auto t = stl.str();
+                size_t N_facets = 0;
+                for(auto p = t.find("facet normal"); p != std::string::npos; p = t.find("facet normal", p + 1)) ++N_facets;
+                REQUIRE( N_facets == N_faces );
+                REQUIRE( t.rfind("solid", 0) == 0 );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Estimate_Surface_Mesh_Marching_Cubes in-memory and streaming meshes agree" ){
+    // Anisotropic voxels, an asymmetric field, and differing row and column counts, so that any mismatch between
+    // voxel corner values and corner positions would alter the surface.
+    const vec3<double> pxl(0.7, 1.2, 1.1);
+    const double radius = 6.1;
+    dcma_surface_meshes::Parameters params;
+    params.SlabImages = 3;
+
+    auto coll = make_sphere_stack(17, 19, 23, pxl, false, radius);
+    auto imgs = as_refs(coll);
+
+    for(const bool below_is_interior : { true, false }){
+        if(!below_is_interior){
+            for(auto &img : coll.images){
+                for(auto &v : img.data) v = -v;
+            }
+        }
+        const auto threshold = below_is_interior ? radius : -radius;
+
+        const auto in_memory = dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, threshold, below_is_interior, params);
+        fv_surface_mesh<double, uint64_t> streamed;
+        dcma_surface_meshes::fv_mesh_sink sink(streamed);
+        dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(imgs, threshold, below_is_interior, sink, params);
+
+        const auto in_memory_volume = require_closed_and_oriented(in_memory);
+        const auto streamed_volume = require_closed_and_oriented(streamed);
+        REQUIRE( 0.0 < in_memory_volume );
+        REQUIRE( in_memory_volume == doctest::Approx(streamed_volume).epsilon(1E-9) );
+
+        REQUIRE( in_memory.vertices.size() == streamed.vertices.size() );
+        REQUIRE( in_memory.faces.size() == streamed.faces.size() );
+        const auto N_edges = count_edges(in_memory);
+        REQUIRE( N_edges == count_edges(streamed) );
+
+        // A single closed surface with the topology of a sphere.
+        const auto euler = static_cast<int64_t>(in_memory.vertices.size()) - N_edges + static_cast<int64_t>(in_memory.faces.size());
+        REQUIRE( euler == 2 );
+    }
+}
+
+TEST_CASE( "Sample_SDF_Lattice" ){
+    const auto sdf = make_chamfered_extrusion();
+    const csg::sdf::compiled_sdf tape(sdf);
+    const auto lipschitz = csg::sdf::lipschitz_bound(*sdf);
+    REQUIRE( lipschitz == doctest::Approx(std::sqrt(2.0)) );
+
+    // Oblique steps, so the lattice is not aligned with the shape or the coordinate axes.
+    const vec3<double> row_step(0.05, 0.4, 0.0);
+    const vec3<double> col_step(0.44, 0.0, 0.05);
+    const double edge_margin = 0.45;
+    const std::vector<vec3<double>> neighbours{{ row_step, row_step * -1.0, col_step, col_step * -1.0,
+                                                 vec3<double>(0.0, 0.0, edge_margin), vec3<double>(0.0, 0.0, -edge_margin) }};
+
+    SUBCASE("filled points are conservative and never border the surface"){
+        for(const double threshold : { 0.0, 0.7 }){
+            for(const double z : { -1.7, 0.5, 2.1, 30.0 }){
+                dcma_surface_meshes::sdf_lattice lat;
+                lat.origin = vec3<double>(-9.0, -8.0, z);
+                lat.row_step = row_step;
+                lat.col_step = col_step;
+                lat.N_rows = 45;
+                lat.N_cols = 41;
+                lat.vals.resize(lat.N_rows * lat.N_cols);
+                dcma_surface_meshes::Sample_SDF_Lattice(tape, lipschitz, threshold, edge_margin, lat);
+
+                // Every point is either evaluated exactly, or filled with a conservative bound on the same side of the
+                // threshold as every point within the edge margin, so no Marching Cube edge from a filled point crosses
+                // the surface.
+                int64_t N_exact = 0;
+                int64_t N_filled = 0;
+                for(int64_t r = 0; r < lat.N_rows; ++r){
+                    for(int64_t c = 0; c < lat.N_cols; ++c){
+                        const auto p = lat.position(static_cast<double>(r), static_cast<double>(c));
+                        const auto expected = sdf->evaluate_sdf(p) - threshold;
+                        const auto sampled = lat.vals.at(r * lat.N_cols + c) - threshold;
+                        if(std::abs(sampled - expected) <= 1E-9 * (1.0 + std::abs(expected))){
+                            ++N_exact;
+                            continue;
+                        }
+                        ++N_filled;
+                        REQUIRE( 0.0 < sampled * expected );
+                        REQUIRE( std::abs(sampled) <= std::abs(expected) );
+                        for(const auto &dp : neighbours){
+                            REQUIRE( 0.0 < (sdf->evaluate_sdf(p + dp) - threshold) * expected );
+                        }
+                    }
+                }
+                REQUIRE( (N_exact + N_filled) == (lat.N_rows * lat.N_cols) );
+                if(z < 10.0){
+                    // The surface crosses the layer, so only a narrow band around it should be evaluated.
+                    REQUIRE( 0 < N_exact );
+                    REQUIRE( 0 < N_filled );
+                }else{
+                    REQUIRE( N_exact == 0 );
+                }
+            }
+        }
+    }
+
+    SUBCASE("meshes match those sampled exactly at every corner"){
+        auto opaque = std::make_shared<opaque_node>();
+        opaque->wrapped = sdf;
+        REQUIRE( std::isinf(csg::sdf::lipschitz_bound(*opaque)) );
+
+        dcma_surface_meshes::Parameters params;
+        const vec3<double> res(0.35, 0.4, 0.3);
+        const auto narrow = dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(sdf, res, 0.0, true, params);
+        const auto brute = dcma_surface_meshes::Estimate_Surface_Mesh_Marching_Cubes(opaque, res, 0.0, true, params);
+
+        const auto narrow_volume = require_closed_and_oriented(narrow);
+        const auto brute_volume = require_closed_and_oriented(brute);
+        REQUIRE( 0.0 < narrow_volume );
+        REQUIRE( narrow_volume == doctest::Approx(brute_volume).epsilon(1E-9) );
+        REQUIRE( narrow.vertices.size() == brute.vertices.size() );
+        REQUIRE( narrow.faces.size() == brute.faces.size() );
+        REQUIRE( count_edges(narrow) == count_edges(brute) );
+    }
+}
@@ -0,0 +1,52 @@
+//Test_Image_Fixtures.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains image and contour fixtures shared by the unit tests.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+
+// A regular grid with voxel (slice, row, col) centred at (x = col, y = row, z = slice * pxl_dz).
+//
+// Voxel values are provided by 'value_fn', which is called once for each voxel in slice, row, column order.
+inline planar_image_collection<float, double>
+make_regular_grid(int64_t slices, int64_t rows, int64_t cols, double pxl_dz,
+                  const std::function<float(int64_t, int64_t, int64_t)> &value_fn){
+    planar_image_collection<float, double> coll;
+    for(int64_t slice = 0; slice < slices; ++slice){
+        planar_image<float, double> img;
+        img.init_orientation(vec3<double>(1.0, 0.0, 0.0), vec3<double>(0.0, 1.0, 0.0));
+        img.init_buffer(rows, cols, 1);
+        img.init_spatial(1.0, 1.0, pxl_dz, vec3<double>(0.0, 0.0, 0.0),
+                                           vec3<double>(0.0, 0.0, static_cast<double>(slice) * pxl_dz));
+        for(int64_t row = 0; row < rows; ++row){
+            for(int64_t col = 0; col < cols; ++col){
+                img.reference(row, col, 0) = value_fn(slice, row, col);
+            }
+        }
+        coll.images.push_back(img);
+    }
+    return coll;
+}
+
+// Axis-aligned rectangles, one in the plane of each slice of a regular grid (see make_regular_grid).
+inline contour_collection<double>
+make_roi(int64_t slices, double pxl_dz, double x_min, double y_min, double x_max, double y_max){
+    contour_collection<double> cc;
+    for(int64_t slice = 0; slice < slices; ++slice){
+        const auto z = static_cast<double>(slice) * pxl_dz;
+        contour_of_points<double> c;
+        c.closed = true;
+        c.points.emplace_back(x_min, y_min, z);
+        c.points.emplace_back(x_max, y_min, z);
+        c.points.emplace_back(x_max, y_max, z);
+        c.points.emplace_back(x_min, y_max, z);
+        cc.contours.push_back(c);
+    }
+    return cc;
+}
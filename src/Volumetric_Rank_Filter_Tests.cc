@@ -0,0 +1,214 @@
+//Volumetric_Rank_Filter_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the sliding-histogram rank filter defined in
+// YgorImages_Functors/Compute/Volumetric_Rank_Filter.cc. Results are compared against the general neighbourhood
+// sampler, which collects and reduces each neighbourhood directly.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "YgorImages_Functors/Compute/Volumetric_Neighbourhood_Sampler.h"
+#include "YgorImages_Functors/Compute/Volumetric_Rank_Filter.h"
+
+#include "Test_Image_Fixtures.h"
+
+
+// A regular grid (see make_regular_grid).
+//
+// Voxel values are small integers, so neighbourhoods contain duplicates, and roughly one voxel in twelve is NaN.
+static planar_image_collection<float, double>
+make_test_image_collection(int64_t slices, int64_t rows, int64_t cols, double pxl_dz){
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> val_dist(0, 9);
+    std::uniform_int_distribution<int> nan_dist(0, 11);
+    return make_regular_grid(slices, rows, cols, pxl_dz, [&](int64_t, int64_t, int64_t) -> float {
+        return (nan_dist(gen) == 0) ? std::numeric_limits<float>::quiet_NaN()
+                                    : static_cast<float>(val_dist(gen));
+    });
+}
+
+// Reductions for the neighbourhood sampler. NaNs are omitted from the neighbourhood, as in the rank filter.
+static std::function<float(float, std::vector<float> &, vec3<double>)>
+reference_reduction(ComputeVolumetricRankFilterUserData::Reduction reduction){
+    using red_t = ComputeVolumetricRankFilterUserData::Reduction;
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto machine_eps = std::sqrt( std::numeric_limits<float>::epsilon() );
+
+    return [=](float v, std::vector<float> &shtl, vec3<double>) -> float {
+        shtl.erase( std::remove_if(std::begin(shtl), std::end(shtl), [](float x){ return std::isnan(x); }),
+                    std::end(shtl) );
+        std::sort(std::begin(shtl), std::end(shtl));
+        const auto n = static_cast<int64_t>(shtl.size());
+        const auto min = (0 < n) ? shtl.front() : nan;
+        const auto max = (0 < n) ? shtl.back() : nan;
+
+        if(reduction == red_t::Min) return min;
+        if(reduction == red_t::Max) return max;
+        if(reduction == red_t::Median){
+            if(n == 0) return nan;
+            return ((n % 2) == 1) ? shtl[n / 2]
+                                  : (shtl[n / 2 - 1] + shtl[n / 2]) / 2.0f;
+        }
+        if(reduction == red_t::Percentile01){
+            if(std::isnan(v)) return v;
+            const auto bounds = std::equal_range(std::begin(shtl), std::end(shtl), v);
+            if(bounds.first == bounds.second) return nan;
+            const auto N_lhs = static_cast<int64_t>( std::distance(std::begin(shtl), bounds.first) );
+            const auto N_rhs = static_cast<int64_t>( std::distance(std::begin(shtl), bounds.second) ) - 1;
+            return 0.5 * static_cast<float>(N_rhs + N_lhs) / (static_cast<float>(n) - 1.0);
+        }
+        if(reduction == red_t::IsMin) return (std::abs(v - min) < machine_eps) ? 1.0f : 0.0f;
+        if(reduction == red_t::IsMax) return (std::abs(v - max) < machine_eps) ? 1.0f : 0.0f;
+        if(reduction == red_t::IsMinNaN) return (std::abs(v - min) < machine_eps) ? nan : v;
+        if(reduction == red_t::IsMaxNaN) return (std::abs(v - max) < machine_eps) ? nan : v;
+        return nan;
+    };
+}
+
+// Apply both the rank filter and the neighbourhood sampler to copies of the images, and require identical results.
+static void
+compare_with_sampler(const planar_image_collection<float, double> &orig,
+                     contour_collection<double> &roi,
+                     ComputeVolumetricRankFilterUserData::Neighbourhood neighbourhood,
+                     double maximum_distance,
+                     const std::vector<std::array<int64_t, 3>> &voxel_triplets = {}){
+    using red_t = ComputeVolumetricRankFilterUserData::Reduction;
+    using nbh_t = ComputeVolumetricRankFilterUserData::Neighbourhood;
+    using snbh_t = ComputeVolumetricNeighbourhoodSamplerUserData::Neighbourhood;
+    std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(roi) };
+
+    for(const auto reduction : { red_t::Min, red_t::Max, red_t::Median, red_t::Percentile01,
+                                 red_t::IsMin, red_t::IsMax, red_t::IsMinNaN, red_t::IsMaxNaN }){
+        CAPTURE(static_cast<int>(reduction));
+
+        auto rank_coll = orig;
+        ComputeVolumetricRankFilterUserData rud;
+        rud.neighbourhood = neighbourhood;
+        rud.maximum_distance = maximum_distance;
+        rud.voxel_triplets = voxel_triplets;
+        rud.reduction = reduction;
+        REQUIRE(Volumetric_Rank_Filter_Supported(rank_coll));
+        REQUIRE(ComputeVolumetricRankFilter(rank_coll, {}, ccsl, &rud));
+
+        auto ref_coll = orig;
+        ComputeVolumetricNeighbourhoodSamplerUserData ud;
+        ud.neighbourhood = (neighbourhood == nbh_t::Spherical) ? snbh_t::Spherical
+                         : (neighbourhood == nbh_t::Cubic)     ? snbh_t::Cubic
+                                                               : snbh_t::Selection;
+        ud.maximum_distance = maximum_distance;
+        ud.voxel_triplets = voxel_triplets;
+        ud.f_reduce = reference_reduction(reduction);
+        REQUIRE(ComputeVolumetricNeighbourhoodSampler(ref_coll, {}, ccsl, &ud));
+
+        int64_t mismatches = 0;
+        auto rank_it = std::begin(rank_coll.images);
+        for(const auto &ref_img : ref_coll.images){
+            for(int64_t row = 0; row < ref_img.rows; ++row){
+                for(int64_t col = 0; col < ref_img.columns; ++col){
+                    const auto expected = ref_img.value(row, col, 0);
+                    const auto actual = rank_it->value(row, col, 0);
+                    const bool agree = (std::isnan(expected) && std::isnan(actual))
+                                    || (std::abs(expected - actual) < 1.0E-5f);
+                    if(!agree) ++mismatches;
+                }
+            }
+            ++rank_it;
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+
+TEST_CASE( "ComputeVolumetricRankFilter matches ComputeVolumetricNeighbourhoodSampler" ){
+    const int64_t S = 5;
+    const int64_t R = 7;
+    const int64_t C = 9;
+    const double pxl_dz = 1.5;
+    const auto orig = make_test_image_collection(S, R, C, pxl_dz);
+    using nbh_t = ComputeVolumetricRankFilterUserData::Neighbourhood;
+
+    // Every voxel, so neighbourhoods are clipped at the edges of the grid.
+    auto whole_roi = make_roi(S, pxl_dz, -0.6, -0.6, static_cast<double>(C) - 0.4, static_cast<double>(R) - 0.4);
+
+    // Interior voxels only, so rows are entered and exited away from the edges of the grid.
+    auto inner_roi = make_roi(S, pxl_dz, 1.6, 0.6, static_cast<double>(C) - 2.4, static_cast<double>(R) - 1.4);
+
+    SUBCASE("spherical neighbourhoods"){
+        compare_with_sampler(orig, whole_roi, nbh_t::Spherical, 1.6);
+        compare_with_sampler(orig, whole_roi, nbh_t::Spherical, 2.3);
+        compare_with_sampler(orig, inner_roi, nbh_t::Spherical, 2.3);
+    }
+
+    SUBCASE("cubic neighbourhoods"){
+        compare_with_sampler(orig, whole_roi, nbh_t::Cubic, 1.0);
+        compare_with_sampler(orig, whole_roi, nbh_t::Cubic, 2.0);
+        compare_with_sampler(orig, inner_roi, nbh_t::Cubic, 2.0);
+    }
+
+    SUBCASE("voxel selections"){
+        std::vector<std::array<int64_t, 3>> triplets;
+        for(int64_t i = -1; i <= 1; ++i){
+            for(int64_t j = -1; j <= 1; ++j){
+                for(int64_t k = -1; k <= 1; ++k){
+                    triplets.push_back({i, j, k});
+                }
+            }
+        }
+        compare_with_sampler(orig, whole_roi, nbh_t::Selection, 0.0, triplets);
+    }
+}
+
+TEST_CASE( "ComputeVolumetricRankFilter edge and NaN voxels" ){
+    // Voxel values increase with (slice, row, col), so the extremes of each neighbourhood are at its corners.
+    auto coll = make_test_image_collection(3, 4, 4, 1.0);
+    for(auto &img : coll.images){
+        const auto slice = static_cast<int64_t>(std::round(img.position(0, 0).z));
+        for(int64_t row = 0; row < 4; ++row){
+            for(int64_t col = 0; col < 4; ++col){
+                img.reference(row, col, 0) = static_cast<float>(slice * 100 + row * 10 + col);
+            }
+        }
+    }
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    coll.images.front().reference(0, 1, 0) = nan;
+    auto roi = make_roi(3, 1.0, -0.6, -0.6, 3.6, 3.6);
+    std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(roi) };
+
+    ComputeVolumetricRankFilterUserData rud;
+    rud.neighbourhood = ComputeVolumetricRankFilterUserData::Neighbourhood::Cubic;
+    rud.maximum_distance = 1.0;
+
+    SUBCASE("corner voxels only see voxels within the grid"){
+        rud.reduction = ComputeVolumetricRankFilterUserData::Reduction::Max;
+        REQUIRE(ComputeVolumetricRankFilter(coll, {}, ccsl, &rud));
+        CHECK(coll.images.front().value(0, 0, 0) == doctest::Approx(111.0f));
+        CHECK(coll.images.back().value(3, 3, 0) == doctest::Approx(233.0f));
+    }
+
+    SUBCASE("NaN voxels are omitted from neighbourhoods"){
+        rud.reduction = ComputeVolumetricRankFilterUserData::Reduction::Median;
+        rud.maximum_distance = 0.0;
+        REQUIRE(ComputeVolumetricRankFilter(coll, {}, ccsl, &rud));
+        CHECK(std::isnan(coll.images.front().value(0, 1, 0)));
+        CHECK(coll.images.front().value(0, 0, 0) == doctest::Approx(0.0f));
+
+        rud.maximum_distance = 1.0;
+        rud.reduction = ComputeVolumetricRankFilterUserData::Reduction::Min;
+        REQUIRE(ComputeVolumetricRankFilter(coll, {}, ccsl, &rud));
+        CHECK(coll.images.front().value(0, 1, 0) == doctest::Approx(0.0f));
+    }
+}
+
@@ -0,0 +1,145 @@
+//Volumetric_Spatial_Blur_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the volumetric blur defined in YgorImages_Functors/Compute/Volumetric_Spatial_Blur.cc.
+// The regular-grid implementation is compared against successive directional passes of the general neighbourhood
+// sampler, which was how the fixed Gaussian blur was originally computed.
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+#include "YgorImages_Functors/Compute/Volumetric_Neighbourhood_Sampler.h"
+#include "YgorImages_Functors/Compute/Volumetric_Spatial_Blur.h"
+
+#include "Test_Image_Fixtures.h"
+
+
+// A regular grid with unit voxel spacing (see make_regular_grid).
+//
+// Voxel values are random, and roughly one voxel in twenty is NaN.
+static planar_image_collection<float, double>
+make_test_image_collection(int64_t slices, int64_t rows, int64_t cols){
+    std::mt19937 gen(54321);
+    std::uniform_real_distribution<float> val_dist(-10.0f, 10.0f);
+    std::uniform_int_distribution<int> nan_dist(0, 19);
+    return make_regular_grid(slices, rows, cols, 1.0, [&](int64_t, int64_t, int64_t) -> float {
+        return (nan_dist(gen) == 0) ? std::numeric_limits<float>::quiet_NaN()
+                                    : val_dist(gen);
+    });
+}
+
+// The fixed 7-voxel Gaussian, applied as three successive row, column, and ortho passes of the neighbourhood sampler.
+static void
+reference_blur(planar_image_collection<float, double> &coll,
+               std::list<std::reference_wrapper<contour_collection<double>>> ccsl){
+    const std::array<double, 7> weights = { 0.006, 0.061, 0.242, 0.382, 0.242, 0.061, 0.006 };
+    auto f_reduce = [=](float, std::vector<float> &shtl, vec3<double>) -> float {
+        double f = 0.0;
+        double w = 0.0;
+        for(size_t i = 0; i < weights.size(); ++i){
+            if(std::isfinite(shtl[i])){
+                w += weights[i];
+                f += weights[i] * shtl[i];
+            }
+        }
+        return (w < 1E-3) ? std::numeric_limits<float>::quiet_NaN()
+                          : static_cast<float>(f / w);
+    };
+
+    for(int64_t axis = 0; axis < 3; ++axis){
+        ComputeVolumetricNeighbourhoodSamplerUserData ud;
+        ud.neighbourhood = ComputeVolumetricNeighbourhoodSamplerUserData::Neighbourhood::Selection;
+        ud.f_reduce = f_reduce;
+        for(int64_t k = -3; k <= 3; ++k){
+            std::array<int64_t, 3> triplet = { 0, 0, 0 };
+            triplet[axis] = k;
+            ud.voxel_triplets.push_back(triplet);
+        }
+        REQUIRE(coll.Compute_Images( ComputeVolumetricNeighbourhoodSampler, {}, ccsl, &ud ));
+    }
+    return;
+}
+
+static void
+require_same_voxels(const planar_image_collection<float, double> &A,
+                    const planar_image_collection<float, double> &B){
+    REQUIRE(A.images.size() == B.images.size());
+    auto b_it = std::begin(B.images);
+    for(const auto &a : A.images){
+        const auto &b = *(b_it++);
+        for(int64_t row = 0; row < a.rows; ++row){
+            for(int64_t col = 0; col < a.columns; ++col){
+                const auto va = a.value(row, col, 0);
+                const auto vb = b.value(row, col, 0);
+                REQUIRE(std::isnan(va) == std::isnan(vb));
+                if(!std::isnan(va)) REQUIRE(va == doctest::Approx(vb).epsilon(1E-4));
+            }
+        }
+    }
+    return;
+}
+
+
+TEST_CASE( "volumetric Gaussian blur matches successive sampler passes" ){
+    const int64_t S = 9;
+    const int64_t R = 10;
+    const int64_t C = 11;
+    const auto orig = make_test_image_collection(S, R, C);
+
+    SUBCASE("ROI covering the whole volume"){
+        auto roi = make_roi(S, 1.0, -1.0, -1.0, static_cast<double>(C), static_cast<double>(R));
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(roi) };
+
+        auto expected = orig;
+        reference_blur(expected, ccsl);
+
+        auto actual = orig;
+        ComputeVolumetricSpatialBlurUserData ud;
+        ud.estimator = VolumetricSpatialBlurEstimator::Gaussian;
+        REQUIRE(actual.Compute_Images( ComputeVolumetricSpatialBlur, {}, ccsl, &ud ));
+        require_same_voxels(actual, expected);
+    }
+
+    SUBCASE("ROI boundary within the volume"){
+        // Voxels outside the ROI are not altered by any pass, so their original values feed every pass.
+        auto roi = make_roi(S, 1.0, 2.5, 1.5, 7.5, 6.5);
+        std::list<std::reference_wrapper<contour_collection<double>>> ccsl = { std::ref(roi) };
+
+        auto expected = orig;
+        reference_blur(expected, ccsl);
+
+        auto actual = orig;
+        ComputeVolumetricSpatialBlurUserData ud;
+        ud.estimator = VolumetricSpatialBlurEstimator::Gaussian;
+        REQUIRE(actual.Compute_Images( ComputeVolumetricSpatialBlur, {}, ccsl, &ud ));
+        require_same_voxels(actual, expected);
+
+        // Voxels outside the ROI retain their original values.
+        auto o_it = std::begin(orig.images);
+        for(const auto &img : actual.images){
+            const auto &o = *(o_it++);
+            for(int64_t row = 0; row < R; ++row){
+                for(int64_t col = 0; col < C; ++col){
+                    const bool inside = (3 <= col) && (col <= 7) && (2 <= row) && (row <= 6);
+                    if(inside) continue;
+                    const auto v = img.value(row, col, 0);
+                    const auto ov = o.value(row, col, 0);
+                    REQUIRE(std::isnan(v) == std::isnan(ov));
+                    if(!std::isnan(v)) REQUIRE(v == ov);
+                }
+            }
+        }
+    }
+}
+
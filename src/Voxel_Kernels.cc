@@ -0,0 +1,231 @@
+//Voxel_Kernels.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file provides vectorized kernels for simple per-voxel transformations.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "YgorImages.h"
+
+#include "Voxel_Kernels.h"
+
+// Kernels are compiled once for the baseline instruction set and, where supported, once more for AVX2. The latter is
+// selected at runtime if the processor supports it. FMA is deliberately not enabled so that contraction cannot alter
+// results. On other architectures (e.g., aarch64, where NEON is part of the baseline) only the baseline is used.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define DCMA_VOXEL_KERNELS_AVX2
+    #define DCMA_VOXEL_KERNEL_BODY inline __attribute__((always_inline))
+#else
+    #define DCMA_VOXEL_KERNEL_BODY inline
+#endif
+
+
+namespace voxel_kernels {
+namespace {
+
+// Kernel bodies for contiguous samples. Branches are written as selections so they can be vectorized.
+DCMA_VOXEL_KERNEL_BODY void negate_body(float *x, int64_t n){
+    for(int64_t i = 0; i < n; ++i) x[i] = -x[i];
+}
+
+DCMA_VOXEL_KERNEL_BODY void scale_body(float *x, int64_t n, double factor){
+    for(int64_t i = 0; i < n; ++i) x[i] = static_cast<float>(static_cast<double>(x[i]) * factor);
+}
+
+DCMA_VOXEL_KERNEL_BODY void replace_non_finite_body(float *x, int64_t n, float replacement){
+    // Equivalent to std::isfinite(), but expressed as a comparison. NaNs compare false.
+    const float largest = std::numeric_limits<float>::max();
+    for(int64_t i = 0; i < n; ++i) x[i] = (std::abs(x[i]) <= largest) ? x[i] : replacement;
+}
+
+DCMA_VOXEL_KERNEL_BODY void log_positive_body(float *x, int64_t n){
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for(int64_t i = 0; i < n; ++i) x[i] = (0.0f < x[i]) ? std::log(x[i]) : nan;
+}
+
+DCMA_VOXEL_KERNEL_BODY void linear_quadratic_body(float *x, int64_t n, double a, double b){
+    for(int64_t i = 0; i < n; ++i){
+        const float v = x[i];
+        const double d = static_cast<double>(v);
+        const float q = static_cast<float>(d * (a + b * d));
+        x[i] = (0.0f < v) ? q : v;
+    }
+}
+
+DCMA_VOXEL_KERNEL_BODY void min_max_body(const float *x, int64_t n, float &min, float &max){
+    float l_min = min;
+    float l_max = max;
+    for(int64_t i = 0; i < n; ++i){
+        l_min = (x[i] < l_min) ? x[i] : l_min;
+        l_max = (l_max < x[i]) ? x[i] : l_max;
+    }
+    min = l_min;
+    max = l_max;
+}
+
+struct kernel_table {
+    const char *name;
+    void (*negate)(float *, int64_t);
+    void (*scale)(float *, int64_t, double);
+    void (*replace_non_finite)(float *, int64_t, float);
+    void (*log_positive)(float *, int64_t);
+    void (*linear_quadratic)(float *, int64_t, double, double);
+    void (*min_max)(const float *, int64_t, float &, float &);
+};
+
+void negate_baseline(float *x, int64_t n){ negate_body(x, n); }
+void scale_baseline(float *x, int64_t n, double factor){ scale_body(x, n, factor); }
+void replace_non_finite_baseline(float *x, int64_t n, float r){ replace_non_finite_body(x, n, r); }
+void log_positive_baseline(float *x, int64_t n){ log_positive_body(x, n); }
+void linear_quadratic_baseline(float *x, int64_t n, double a, double b){ linear_quadratic_body(x, n, a, b); }
+void min_max_baseline(const float *x, int64_t n, float &min, float &max){ min_max_body(x, n, min, max); }
+
+#if defined(DCMA_VOXEL_KERNELS_AVX2)
+__attribute__((target("avx2"))) void negate_avx2(float *x, int64_t n){ negate_body(x, n); }
+__attribute__((target("avx2"))) void scale_avx2(float *x, int64_t n, double factor){ scale_body(x, n, factor); }
+__attribute__((target("avx2"))) void replace_non_finite_avx2(float *x, int64_t n, float r){ replace_non_finite_body(x, n, r); }
+__attribute__((target("avx2"))) void log_positive_avx2(float *x, int64_t n){ log_positive_body(x, n); }
+
+// The compiler will not if-convert the selection in linear_quadratic_body() under strict floating-point semantics, so
+// it is written explicitly.
+__attribute__((target("avx2"))) void linear_quadratic_avx2(float *x, int64_t n, double a, double b){
+    const __m256d v_a = _mm256_set1_pd(a);
+    const __m256d v_b = _mm256_set1_pd(b);
+    const __m128 zero = _mm_setzero_ps();
+    int64_t i = 0;
+    for( ; (i + 4) <= n; i += 4){
+        const __m128 v = _mm_loadu_ps(x + i);
+        const __m256d d = _mm256_cvtps_pd(v);
+        const __m256d q = _mm256_mul_pd(d, _mm256_add_pd(v_a, _mm256_mul_pd(v_b, d)));
+        const __m128 is_positive = _mm_cmplt_ps(zero, v);
+        _mm_storeu_ps(x + i, _mm_blendv_ps(v, _mm256_cvtpd_ps(q), is_positive));
+    }
+    linear_quadratic_body(x + i, n - i, a, b);
+}
+
+// Likewise for the min/max reduction, which would otherwise require relaxed floating-point semantics. The comparisons
+// match min_max_body(), so NaNs are ignored.
+__attribute__((target("avx2"))) void min_max_avx2(const float *x, int64_t n, float &min, float &max){
+    __m256 v_min = _mm256_set1_ps(min);
+    __m256 v_max = _mm256_set1_ps(max);
+    int64_t i = 0;
+    for( ; (i + 8) <= n; i += 8){
+        const __m256 v = _mm256_loadu_ps(x + i);
+        v_min = _mm256_min_ps(v, v_min); // (v < v_min) ? v : v_min.
+        v_max = _mm256_max_ps(v, v_max); // (v_max < v) ? v : v_max.
+    }
+    alignas(32) std::array<float, 8> l_min;
+    alignas(32) std::array<float, 8> l_max;
+    _mm256_store_ps(l_min.data(), v_min);
+    _mm256_store_ps(l_max.data(), v_max);
+    for(int64_t j = 0; j < 8; ++j){
+        min = (l_min[j] < min) ? l_min[j] : min;
+        max = (max < l_max[j]) ? l_max[j] : max;
+    }
+    min_max_body(x + i, n - i, min, max);
+}
+#endif
+
+const kernel_table &active_kernels(){
+    static const kernel_table kernels = []() -> kernel_table {
+#if defined(DCMA_VOXEL_KERNELS_AVX2)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")){
+            return { "AVX2", &negate_avx2, &scale_avx2, &replace_non_finite_avx2,
+                     &log_positive_avx2, &linear_quadratic_avx2, &min_max_avx2 };
+        }
+#endif
+        return { "baseline", &negate_baseline, &scale_baseline, &replace_non_finite_baseline,
+                 &log_positive_baseline, &linear_quadratic_baseline, &min_max_baseline };
+    }();
+    return kernels;
+}
+
+} // namespace
+
+
+std::string Instruction_Set(){
+    return active_kernels().name;
+}
+
+void Negate(float *x, int64_t n, int64_t stride){
+    if(n <= 0) return;
+    if(stride == 1){
+        active_kernels().negate(x, n);
+    }else{
+        Transform(x, n, stride, [](float v){ return -v; });
+    }
+    return;
+}
+
+void Scale(float *x, int64_t n, int64_t stride, double factor){
+    if(n <= 0) return;
+    if(stride == 1){
+        active_kernels().scale(x, n, factor);
+    }else{
+        Transform(x, n, stride, [=](float v){ return static_cast<float>(static_cast<double>(v) * factor); });
+    }
+    return;
+}
+
+void Replace_Non_Finite(float *x, int64_t n, int64_t stride, float replacement){
+    if(n <= 0) return;
+    if(stride == 1){
+        active_kernels().replace_non_finite(x, n, replacement);
+    }else{
+        Transform(x, n, stride, [=](float v){ return std::isfinite(v) ? v : replacement; });
+    }
+    return;
+}
+
+void Log_Positive(float *x, int64_t n, int64_t stride){
+    if(n <= 0) return;
+    if(stride == 1){
+        active_kernels().log_positive(x, n);
+    }else{
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        Transform(x, n, stride, [=](float v){ return (0.0f < v) ? std::log(v) : nan; });
+    }
+    return;
+}
+
+void Linear_Quadratic(float *x, int64_t n, int64_t stride, double a, double b){
+    if(n <= 0) return;
+    if(stride == 1){
+        active_kernels().linear_quadratic(x, n, a, b);
+    }else{
+        Transform(x, n, stride, [=](float v){
+            const double d = static_cast<double>(v);
+            return (0.0f < v) ? static_cast<float>(d * (a + b * d)) : v;
+        });
+    }
+    return;
+}
+
+std::pair<float, float> Min_Max(const float *x, int64_t n, int64_t stride){
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+    if(n <= 0) return { min, max };
+    if(stride == 1){
+        active_kernels().min_max(x, n, min, max);
+    }else{
+        for(int64_t i = 0; i < n; ++i){
+            const auto v = x[i * stride];
+            min = (v < min) ? v : min;
+            max = (max < v) ? v : max;
+        }
+    }
+
+    return { min, max };
+}
+
+} // namespace voxel_kernels
+
@@ -0,0 +1,90 @@
+//Voxel_Kernels.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// Vectorized kernels for simple per-voxel transformations, and row spans for applying them within ROIs.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "YgorImages.h"
+
+#include "ROI_Span_Masks.h"
+
+
+namespace voxel_kernels {
+
+// Kernels operate in-place on 'n' samples spaced 'stride' samples apart. Contiguous samples (i.e., stride == 1) are
+// processed with the widest instruction set available at runtime, which is selected once per process. All instruction
+// sets produce identical results.
+//
+// Samples are transformed independently of their position, so an entire image buffer (all rows, columns, and
+// channels) can be passed as a single contiguous run when every voxel is to be transformed.
+
+// The name of the instruction set selected for contiguous samples, e.g., "AVX2" or "baseline".
+std::string Instruction_Set();
+
+// x <- -x.
+void Negate(float *x, int64_t n, int64_t stride = 1);
+
+// x <- x * factor, evaluated in double precision.
+void Scale(float *x, int64_t n, int64_t stride, double factor);
+
+// x <- replacement for non-finite x.
+void Replace_Non_Finite(float *x, int64_t n, int64_t stride, float replacement);
+
+// x <- log(x) for positive x, NaN otherwise.
+void Log_Positive(float *x, int64_t n, int64_t stride = 1);
+
+// x <- x * (a + b * x) for positive x, evaluated in double precision. Other samples are unaltered.
+void Linear_Quadratic(float *x, int64_t n, int64_t stride, double a, double b);
+
+// The minimum and maximum of the samples, ignoring NaNs. If there are no such samples, min > max.
+std::pair<float, float> Min_Max(const float *x, int64_t n, int64_t stride = 1);
+
+
+// Apply a scalar function to the samples in-place. Intended for transformations without a dedicated kernel. Only the
+// baseline instruction set is used.
+template <class F>
+void Transform(float *x, int64_t n, int64_t stride, F f){
+    if(stride == 1){
+        for(int64_t i = 0; i < n; ++i) x[i] = f(x[i]);
+    }else{
+        for(int64_t i = 0; i < n; ++i) x[i * stride] = f(x[i * stride]);
+    }
+    return;
+}
+
+// Invoke 'k(x, n, stride)' for the samples of the given channel within each span. If the channel is negative, all
+// channels are visited, and contiguous channels are visited together.
+template <class K>
+void For_Each_Span(planar_image<float,double> &img,
+                   const std::vector<voxel_row_span> &spans,
+                   int64_t channel,
+                   K k){
+    if( (img.rows <= 0) || (img.columns <= 0) || (img.channels <= 0) ) return;
+    const int64_t col_stride = (1 < img.columns) ? (img.index(0, 1, 0) - img.index(0, 0, 0)) : img.channels;
+    const int64_t chn_stride = (1 < img.channels) ? (img.index(0, 0, 1) - img.index(0, 0, 0)) : 1;
+    const bool interleaved = (chn_stride == 1) && (col_stride == img.channels);
+
+    float *data = img.data.data();
+    for(const auto &s : spans){
+        const auto n = s.col_end - s.col_begin;
+        if(n <= 0) continue;
+        if( (channel < 0) && interleaved ){
+            k(data + img.index(s.row, s.col_begin, 0), n * img.channels, static_cast<int64_t>(1));
+        }else{
+            for(int64_t chn = 0; chn < img.channels; ++chn){
+                if( (0 <= channel) && (chn != channel) ) continue;
+                k(data + img.index(s.row, s.col_begin, chn), n, col_stride);
+            }
+        }
+    }
+    return;
+}
+
+} // namespace voxel_kernels
+
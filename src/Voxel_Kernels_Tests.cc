@@ -0,0 +1,87 @@
+//Voxel_Kernels_Tests.cc - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// This file contains unit tests for the voxel kernels defined in Voxel_Kernels.cc.
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "doctest20251212/doctest.h"
+
+#include "Voxel_Kernels.h"
+
+
+// Compare samples bitwise, treating all NaNs as equal.
+static
+bool
+same_samples(const std::vector<float> &A, const std::vector<float> &B){
+    if(A.size() != B.size()) return false;
+    for(size_t i = 0; i < A.size(); ++i){
+        if(std::isnan(A[i]) && std::isnan(B[i])) continue;
+        if(A[i] != B[i]) return false;
+    }
+    return true;
+}
+
+
+TEST_CASE( "voxel_kernels" ){
+    std::mt19937 re(24680);
+    std::uniform_real_distribution<float> rd(-100.0f, 100.0f);
+
+    // Odd lengths exercise the scalar remainders of vectorized loops.
+    const int64_t n = 1'003;
+    std::vector<float> x;
+    for(int64_t i = 0; i < n; ++i) x.push_back(rd(re));
+    x[3] = std::numeric_limits<float>::quiet_NaN();
+    x[10] = std::numeric_limits<float>::infinity();
+    x[11] = -std::numeric_limits<float>::infinity();
+    x[12] = 0.0f;
+    x[13] = -0.0f;
+
+    REQUIRE( !voxel_kernels::Instruction_Set().empty() );
+
+    SUBCASE("contiguous and strided samples match scalar evaluation"){
+        const auto check = [&](auto kernel, auto scalar){
+            for(const int64_t stride : { 1, 3 }){
+                std::vector<float> y = x;
+                std::vector<float> expected = x;
+                const int64_t m = (n + stride - 1) / stride;
+                kernel(y.data(), m, stride);
+                for(int64_t i = 0; i < m; ++i) expected[i * stride] = scalar(x[i * stride]);
+                REQUIRE( same_samples(y, expected) );
+            }
+        };
+
+        check( [](float *p, int64_t m, int64_t s){ voxel_kernels::Negate(p, m, s); },
+               [](float v){ return -v; } );
+        check( [](float *p, int64_t m, int64_t s){ voxel_kernels::Scale(p, m, s, 1.23E-5); },
+               [](float v){ return static_cast<float>(static_cast<double>(v) * 1.23E-5); } );
+        check( [](float *p, int64_t m, int64_t s){ voxel_kernels::Replace_Non_Finite(p, m, s, -1024.0f); },
+               [](float v){ return std::isfinite(v) ? v : -1024.0f; } );
+        check( [](float *p, int64_t m, int64_t s){ voxel_kernels::Log_Positive(p, m, s); },
+               [](float v){ return (0.0f < v) ? std::log(v) : std::numeric_limits<float>::quiet_NaN(); } );
+        check( [](float *p, int64_t m, int64_t s){ voxel_kernels::Linear_Quadratic(p, m, s, 1.0, 0.1); },
+               [](float v){
+                   const double d = static_cast<double>(v);
+                   return (0.0f < v) ? static_cast<float>(d * (1.0 + 0.1 * d)) : v;
+               } );
+    }
+
+    SUBCASE("Min_Max ignores NaNs"){
+        const auto [min, max] = voxel_kernels::Min_Max(x.data(), n);
+        REQUIRE( min == -std::numeric_limits<float>::infinity() );
+        REQUIRE( max == std::numeric_limits<float>::infinity() );
+
+        std::vector<float> y = { std::numeric_limits<float>::quiet_NaN(), 2.0f, -3.0f, 1.0f };
+        const auto [y_min, y_max] = voxel_kernels::Min_Max(y.data(), 2, 2);
+        REQUIRE( y_min == -3.0f );
+        REQUIRE( y_max == -3.0f );
+
+        std::vector<float> z = { std::numeric_limits<float>::quiet_NaN() };
+        const auto [z_min, z_max] = voxel_kernels::Min_Max(z.data(), 1);
+        REQUIRE( z_max < z_min );
+    }
+}
+
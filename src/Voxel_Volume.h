@@ -0,0 +1,359 @@
+//Voxel_Volume.h - A part of DICOMautomaton 2026. Written by hal clark.
+//
+// Contiguous voxel storage for image collections that form a regular grid.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+
+// Copy the voxels of an image into a contiguous buffer with (row, column, channel) ordering, channel fastest.
+//
+// Images that already store voxels in this order are copied in bulk.
+template <class T, class R, class U>
+void copy_image_to_buffer(const planar_image<T,R> &img, U *dest){
+    const int64_t N = img.rows * img.columns * img.channels;
+    const bool is_row_major = (img.index(img.rows - 1, img.columns - 1, img.channels - 1) == (N - 1))
+                           && ((img.columns < 2) || (img.index(0, 1, 0) == img.channels))
+                           && ((img.rows < 2) || (img.index(1, 0, 0) == img.columns * img.channels));
+    if(is_row_major && (static_cast<int64_t>(img.data.size()) == N)){
+        std::transform( std::begin(img.data), std::end(img.data), dest,
+                        [](const T &v) -> U { return static_cast<U>(v); } );
+        return;
+    }
+    for(int64_t r = 0; r < img.rows; ++r){
+        for(int64_t c = 0; c < img.columns; ++c){
+            for(int64_t ch = 0; ch < img.channels; ++ch){
+                *(dest++) = static_cast<U>(img.value(r, c, ch));
+            }
+        }
+    }
+    return;
+}
+
+// Copy voxels from a contiguous buffer with (row, column, channel) ordering into an image with matching dimensions.
+template <class T, class R, class U>
+void copy_buffer_to_image(const U *src, planar_image<T,R> &img){
+    const int64_t N = img.rows * img.columns * img.channels;
+    const bool is_row_major = (img.index(img.rows - 1, img.columns - 1, img.channels - 1) == (N - 1))
+                           && ((img.columns < 2) || (img.index(0, 1, 0) == img.channels))
+                           && ((img.rows < 2) || (img.index(1, 0, 0) == img.columns * img.channels));
+    if(is_row_major && (static_cast<int64_t>(img.data.size()) == N)){
+        std::transform( src, src + N, std::begin(img.data),
+                        [](const U &v) -> T { return static_cast<T>(v); } );
+        return;
+    }
+    for(int64_t r = 0; r < img.rows; ++r){
+        for(int64_t c = 0; c < img.columns; ++c){
+            for(int64_t ch = 0; ch < img.channels; ++ch){
+                img.reference(r, c, ch) = static_cast<T>(*(src++));
+            }
+        }
+    }
+    return;
+}
+
+
+// An index that maps the images of a planar_image_collection onto a regular voxel grid.
+//
+// All images must have the same orientation, dimensions, and voxel sizes, and be stacked at regular intervals along
+// the image normal. Images that share a position are treated as successive frames (e.g., time points), in the order
+// they appear in the collection, so 4D data is supported when every position has the same number of images.
+//
+// The index refers to images by pointer and does not copy voxel values. It remains valid as long as images are not
+// added, removed, or repositioned, which can be cheaply verified with is_current().
+template <class T, class R>
+struct voxel_grid_index {
+    int64_t frames = 0;
+    int64_t slices = 0;
+    int64_t rows = 0;
+    int64_t cols = 0;
+    int64_t channels = 0;
+
+    // Position of voxel (slice, row, column) = origin + slice_step * slice + row_step * row + col_step * column.
+    // Steps along dimensions with a single voxel are zero.
+    vec3<R> origin;
+    vec3<R> slice_step;
+    vec3<R> row_step;
+    vec3<R> col_step;
+
+    // Images in (frame, slice) order, slices fastest.
+    std::vector<planar_image<T,R> *> images;
+
+    // The geometry of each image when indexed, for detecting changes.
+    struct image_geometry {
+        vec3<R> origin; // Position of the first voxel.
+        R pxl_dx;
+        R pxl_dy;
+        R pxl_dz;
+        vec3<R> row_unit;
+        vec3<R> col_unit;
+
+        explicit image_geometry(const planar_image<T,R> &img)
+            : origin(img.position(0, 0)),
+              pxl_dx(img.pxl_dx), pxl_dy(img.pxl_dy), pxl_dz(img.pxl_dz),
+              row_unit(img.row_unit), col_unit(img.col_unit) {}
+
+        bool matches(const planar_image<T,R> &img) const {
+            return (this->pxl_dx == img.pxl_dx)
+                && (this->pxl_dy == img.pxl_dy)
+                && (this->pxl_dz == img.pxl_dz)
+                && (this->row_unit == img.row_unit)
+                && (this->col_unit == img.col_unit)
+                && (this->origin == img.position(0, 0));
+        }
+    };
+    std::vector<image_geometry> image_geometries;
+
+    planar_image<T,R> &
+    image(int64_t frame, int64_t slice) const {
+        return *(this->images.at(static_cast<size_t>(frame * this->slices + slice)));
+    }
+
+    // Returns the (frame, slice) of the given image, if it is indexed.
+    std::optional<std::pair<int64_t, int64_t>>
+    locate(const planar_image<T,R> *img) const {
+        const auto it = std::find( std::begin(this->images), std::end(this->images), img );
+        if(it == std::end(this->images)) return {};
+        const auto n = static_cast<int64_t>(std::distance(std::begin(this->images), it));
+        return std::make_pair(n / this->slices, n % this->slices);
+    }
+
+    vec3<R>
+    position(int64_t slice, int64_t row, int64_t col) const {
+        return this->origin + this->slice_step * static_cast<R>(slice)
+                            + this->row_step * static_cast<R>(row)
+                            + this->col_step * static_cast<R>(col);
+    }
+
+    // Whether the collection still consists of exactly the indexed images with unchanged geometry.
+    // Voxel values are not considered.
+    bool
+    is_current(const planar_image_collection<T,R> &coll) const {
+        if(coll.images.size() != this->images.size()) return false;
+        std::map<const planar_image<T,R> *, size_t> order;
+        for(size_t i = 0; i < this->images.size(); ++i) order[this->images[i]] = i;
+
+        for(const auto &img : coll.images){
+            const auto it = order.find(&img);
+            if(it == std::end(order)) return false;
+            if( (img.rows != this->rows)
+            ||  (img.columns != this->cols)
+            ||  (img.channels != this->channels) ) return false;
+            if(!this->image_geometries[it->second].matches(img)) return false;
+        }
+        return true;
+    }
+
+    // An equivalent index that refers to the corresponding images of 'to', which must list its images in the same
+    // order as 'from' (e.g., a copy of 'from'). Returns an empty optional if the index is not current for 'from'.
+    std::optional<voxel_grid_index>
+    rebind(const planar_image_collection<T,R> &from, planar_image_collection<T,R> &to) const {
+        if( !this->is_current(from)
+        ||  (from.images.size() != to.images.size()) ) return {};
+
+        std::map<const planar_image<T,R> *, planar_image<T,R> *> counterpart;
+        auto to_it = std::begin(to.images);
+        for(const auto &img : from.images) counterpart[&img] = &*(to_it++);
+
+        voxel_grid_index out = *this;
+        for(auto &img_ptr : out.images) img_ptr = counterpart.at(img_ptr);
+        return out;
+    }
+};
+
+// Attempt to index the images as a regular voxel grid. Returns an empty optional if they do not form one.
+template <class T, class R>
+std::optional<voxel_grid_index<T,R>>
+Index_Voxel_Grid(planar_image_collection<T,R> &coll, R eps = static_cast<R>(1E-3)){
+    if(coll.images.empty()) return {};
+
+    const auto &img0 = coll.images.front();
+    if( (img0.rows <= 0) || (img0.columns <= 0) || (img0.channels <= 0) ) return {};
+    const auto ortho = img0.ortho_unit();
+    const auto p0 = img0.position(0, 0);
+
+    // Group images by their position along the normal, preserving the collection order within each group.
+    std::list<std::pair<R, std::vector<planar_image<T,R> *>>> groups;
+    for(auto &img : coll.images){
+        if( (img.rows != img0.rows)
+        ||  (img.columns != img0.columns)
+        ||  (img.channels != img0.channels)
+        ||  (std::abs(img.pxl_dx - img0.pxl_dx) > eps)
+        ||  (std::abs(img.pxl_dy - img0.pxl_dy) > eps)
+        ||  (img.row_unit.distance(img0.row_unit) > eps)
+        ||  (img.col_unit.distance(img0.col_unit) > eps) ){
+            return {};
+        }
+
+        // Images must be coplanar or stacked directly along the normal.
+        const auto dp = img.position(0, 0) - p0;
+        const auto along = dp.Dot(ortho);
+        if((dp - ortho * along).length() > eps) return {};
+
+        auto it = std::find_if( std::begin(groups), std::end(groups),
+                                [&](const auto &g){ return (std::abs(g.first - along) <= eps); } );
+        if(it == std::end(groups)){
+            groups.emplace_back(along, std::vector<planar_image<T,R> *>{});
+            it = std::prev(std::end(groups));
+        }
+        it->second.push_back(&img);
+    }
+    groups.sort([](const auto &a, const auto &b){ return (a.first < b.first); });
+
+    voxel_grid_index<T,R> out;
+    out.frames = static_cast<int64_t>(groups.front().second.size());
+    out.slices = static_cast<int64_t>(groups.size());
+    out.rows = img0.rows;
+    out.cols = img0.columns;
+    out.channels = img0.channels;
+
+    // Ensure the slices are regularly spaced and every slice has the same number of frames.
+    const R spacing = (out.slices < 2) ? static_cast<R>(0) : (std::next(std::begin(groups))->first - groups.front().first);
+    int64_t z = 0;
+    for(const auto &g : groups){
+        if(static_cast<int64_t>(g.second.size()) != out.frames) return {};
+        if(std::abs((g.first - groups.front().first) - spacing * static_cast<R>(z)) > eps) return {};
+        ++z;
+    }
+
+    const auto &first = *(groups.front().second.front());
+    out.origin = first.position(0, 0);
+    out.slice_step = ortho * spacing;
+    out.row_step = first.position(std::min<int64_t>(1, out.rows - 1), 0) - out.origin;
+    out.col_step = first.position(0, std::min<int64_t>(1, out.cols - 1)) - out.origin;
+
+    out.images.resize(static_cast<size_t>(out.frames * out.slices), nullptr);
+    z = 0;
+    for(const auto &g : groups){
+        for(int64_t f = 0; f < out.frames; ++f){
+            out.images[static_cast<size_t>(f * out.slices + z)] = g.second[static_cast<size_t>(f)];
+        }
+        ++z;
+    }
+    for(const auto *img : out.images) out.image_geometries.emplace_back(*img);
+    return out;
+}
+
+// Reuse the given index if it is current for the collection, e.g., one cached by Image_Array::get_voxel_grid_index().
+// Otherwise the collection is indexed anew. Returns nullptr if the images do not form a regular grid.
+template <class T, class R>
+std::shared_ptr<const voxel_grid_index<T,R>>
+Current_Voxel_Grid_Index(const std::shared_ptr<const voxel_grid_index<T,R>> &index,
+                         planar_image_collection<T,R> &coll){
+    if( (index != nullptr)
+    &&  index->is_current(coll) ){
+        return index;
+    }
+    if(auto l_index = Index_Voxel_Grid(coll)){
+        return std::make_shared<const voxel_grid_index<T,R>>(std::move(l_index.value()));
+    }
+    return nullptr;
+}
+
+
+// A dense, contiguous voxel volume with (frame, slice, row, column, channel) ordering, channel fastest.
+//
+// Volumes are derived from, and written back to, image collections via a voxel_grid_index. Neighbouring voxels can be
+// reached with fixed strides, avoiding list traversal and per-voxel position lookups.
+template <class T>
+struct voxel_volume {
+    int64_t frames = 0;
+    int64_t slices = 0;
+    int64_t rows = 0;
+    int64_t cols = 0;
+    int64_t channels = 0;
+
+    vec3<double> origin;
+    vec3<double> slice_step;
+    vec3<double> row_step;
+    vec3<double> col_step;
+
+    std::vector<T> data;
+
+    int64_t col_stride() const { return this->channels; }
+    int64_t row_stride() const { return this->cols * this->channels; }
+    int64_t slice_stride() const { return this->rows * this->cols * this->channels; }
+    int64_t frame_stride() const { return this->slices * this->rows * this->cols * this->channels; }
+
+    size_t index(int64_t frame, int64_t slice, int64_t row, int64_t col, int64_t chnl) const {
+        return static_cast<size_t>( frame * this->frame_stride()
+                                  + slice * this->slice_stride()
+                                  + row * this->row_stride()
+                                  + col * this->col_stride()
+                                  + chnl );
+    }
+
+    T &reference(int64_t frame, int64_t slice, int64_t row, int64_t col, int64_t chnl){
+        return this->data[this->index(frame, slice, row, col, chnl)];
+    }
+    T value(int64_t frame, int64_t slice, int64_t row, int64_t col, int64_t chnl) const {
+        return this->data[this->index(frame, slice, row, col, chnl)];
+    }
+
+    vec3<double> position(int64_t slice, int64_t row, int64_t col) const {
+        return this->origin + this->slice_step * static_cast<double>(slice)
+                            + this->row_step * static_cast<double>(row)
+                            + this->col_step * static_cast<double>(col);
+    }
+};
+
+// Copy the indexed images into a contiguous volume.
+template <class U, class T, class R>
+voxel_volume<U>
+Marshal_To_Voxel_Volume(const voxel_grid_index<T,R> &index){
+    voxel_volume<U> out;
+    out.frames = index.frames;
+    out.slices = index.slices;
+    out.rows = index.rows;
+    out.cols = index.cols;
+    out.channels = index.channels;
+    const auto to_double = [](const vec3<R> &v){
+        return vec3<double>( static_cast<double>(v.x), static_cast<double>(v.y), static_cast<double>(v.z) );
+    };
+    out.origin = to_double(index.origin);
+    out.slice_step = to_double(index.slice_step);
+    out.row_step = to_double(index.row_step);
+    out.col_step = to_double(index.col_step);
+
+    out.data.resize(static_cast<size_t>(out.frames * out.frame_stride()));
+    for(int64_t f = 0; f < out.frames; ++f){
+        for(int64_t z = 0; z < out.slices; ++z){
+            copy_image_to_buffer(index.image(f, z), out.data.data() + out.index(f, z, 0, 0, 0));
+        }
+    }
+    return out;
+}
+
+// Copy a volume's voxel values back into the indexed images. Only voxel values are modified.
+template <class U, class T, class R>
+void
+Marshal_From_Voxel_Volume(const voxel_volume<U> &vol, const voxel_grid_index<T,R> &index){
+    if( (vol.frames != index.frames)
+    ||  (vol.slices != index.slices)
+    ||  (vol.rows != index.rows)
+    ||  (vol.cols != index.cols)
+    ||  (vol.channels != index.channels) ){
+        throw std::invalid_argument("Voxel volume dimensions do not match the image grid");
+    }
+    for(int64_t f = 0; f < vol.frames; ++f){
+        for(int64_t z = 0; z < vol.slices; ++z){
+            copy_buffer_to_image(vol.data.data() + vol.index(f, z, 0, 0, 0), index.image(f, z));
+        }
+    }
+    return;
+}
+
@@ -8,7 +8,10 @@
 #include <map>
 #include <ostream>
 #include <stdexcept>
+#include <string>
+#include <cstdint>
 
+#include "../../ROI_Span_Masks.h"
 #include "../Grouping/Misc_Functors.h"
 #include "AccumulatePixelDistributions.h"
 #include "YgorImages.h"
@@ -100,13 +103,9 @@ bool AccumulatePixelDistributions(planar_image_collection<float,double> &imageco
         }
 
         planar_image<float,double> &img = std::ref(*selected_imgs.front());
-        //Loop over the rois, rows, columns, channels, and finally any selected images (if applicable).
-        const auto row_unit   = img.row_unit;
-        const auto col_unit   = img.col_unit;
-        const auto ortho_unit = img.ortho_unit();
-    
-        //Loop over the ccsl, rois, rows, columns, channels, and finally any selected images (if applicable).
-        //for(const auto &roi : rois){
+
+        // Group the contours within the spatial extent of the image by ROI name.
+        std::map<std::string, contour_collection<double>> named_ccs;
         for(auto &ccs : ccsl){
             for(auto & contour : ccs.get().contours){
                 if(contour.points.empty()) continue;
@@ -117,88 +116,32 @@ bool AccumulatePixelDistributions(planar_image_collection<float,double> &imageco
                     YLOGWARN("Missing necessary tags for reporting analysis results. Cannot continue");
                     return false;
                 }
-                
-        /*
-                //Construct a bounding box to reduce computational demand of checking every voxel.
-                auto BBox = roi_it->Bounding_Box_Along(row_unit, 1.0);
-                auto BBoxBestFitPlane = BBox.Least_Squares_Best_Fit_Plane(vec3<double>(0.0,0.0,1.0));
-                auto BBoxProjectedContour = BBox.Project_Onto_Plane_Orthogonally(BBoxBestFitPlane);
-                const bool BBoxAlreadyProjected = true;
-        */
-        
-                //Prepare a contour for fast is-point-within-the-polygon checking.
-                auto BestFitPlane = contour.Least_Squares_Best_Fit_Plane(ortho_unit);
-                auto ProjectedContour = contour.Project_Onto_Plane_Orthogonally(BestFitPlane);
-                const bool AlreadyProjected = true;
-        
-                for(auto row = 0; row < img.rows; ++row){
-                    for(auto col = 0; col < img.columns; ++col){
-                        //Figure out the spatial location of the present voxel.
-                        const auto point = img.position(row,col);
-        
-        /*
-                        //Check if within the bounding box. It will generally be cheaper than the full contour (4 points vs. ? points).
-                        auto BBoxProjectedPoint = BBoxBestFitPlane.Project_Onto_Plane_Orthogonally(point);
-                        if(!BBoxProjectedContour.Is_Point_In_Polygon_Projected_Orthogonally(BBoxBestFitPlane,
-                                                                                            BBoxProjectedPoint,
-                                                                                            BBoxAlreadyProjected)) continue;
-        */
-        
-                        //Perform a more detailed check to see if we are in the ROI.
-                        auto ProjectedPoint = BestFitPlane.Project_Onto_Plane_Orthogonally(point);
-                        if(ProjectedContour.Is_Point_In_Polygon_Projected_Orthogonally(BestFitPlane,
-                                                                                       ProjectedPoint,
-                                                                                       AlreadyProjected)){
-                            for(auto chan = 0; chan < img.channels; ++chan){
-                                //Cycle over the grouped images, accumulating the voxel intensity.
-                                double combined_voxel_intensity = 0.0;
-                                for(auto & img_it : selected_imgs){
-
-                                    //Collect the datum of voxels and nearby voxels for an average.
-                                    std::list<double> in_pixs;
-                                    const auto boxr = 0;
-                                    const auto min_datum = 1;
-                                    for(auto lrow = (row-boxr); lrow <= (row+boxr); ++lrow){
-                                        for(auto lcol = (col-boxr); lcol <= (col+boxr); ++lcol){
-                                            //Check if the coordinates are legal and in the ROI.
-                                            if( !isininc(0,lrow,img_it->rows-1) || !isininc(0,lcol,img_it->columns-1) ) continue;
-        
-                                            //const auto boxpoint = first_img_it->spatial_location(row,col);  //For standard contours(?).
-                                            //const auto neighbourpoint = vec3<double>(lrow*1.0, lcol*1.0, SliceLocation*1.0);  //For the pixel integer contours.
-                                            const auto neighbourpoint = img.position(lrow,lcol);
-                                            auto ProjectedNeighbourPoint = BestFitPlane.Project_Onto_Plane_Orthogonally(neighbourpoint);
-                                            if(!ProjectedContour.Is_Point_In_Polygon_Projected_Orthogonally(BestFitPlane,
-                                                                                                            ProjectedNeighbourPoint,
-                                                                                                            AlreadyProjected)) continue;
-                                            const auto val = static_cast<double>(img_it->value(lrow, lcol, chan));
-                                            in_pixs.push_back(val);
-                                        }
-                                    }
-                                    if(in_pixs.size() < min_datum) continue; //If contours are too narrow so that there is too few datum for meaningful results.
-                                    const auto combined_val = Stats::Sum(in_pixs);
-                                    combined_voxel_intensity += combined_val;
-                                }
-        
-                                // --------------- Incorporate the data into the user_data struct ------------------
-                                user_data_s->accumulated_voxels[ ROIName.value() ].emplace_back(combined_voxel_intensity);
-        
-                                // ----------------------------------------------------------------------------
-        
-                            }//Loop over channels.
-        
-                        //If we're in the bounding box but not the ROI, do something.
-                        }else{
-                            //for(auto chan = 0; chan < first_img_it->channels; ++chan){
-                            //    const auto curr_val = working.value(row, col, chan);
-                            //    if(curr_val != 0) YLOGERR("There are overlapping ROI bboxes. This code currently cannot handle this. "
-                            //                              "You will need to run the functor individually on the overlapping ROIs.");
-                            //    working.reference(row, col, chan) = static_cast<float>(10);
-                            //}
-                        } // If is in ROI or ROI bbox.
-                    } //Loop over cols
-                } //Loop over rows
-            } //Loop over ROIs.
-        } //Loop over contour_collections.
+                named_ccs[ ROIName.value() ].contours.push_back(contour);
+            }
+        }
+
+        // Visit the voxels bounded by each ROI. Masks are cached, so images sharing a geometry with previously-visited
+        // images are not rasterized again. Voxels bounded by several contours of the same ROI are only counted once.
+        for(auto &named_cc : named_ccs){
+            std::list<std::reference_wrapper<contour_collection<double>>> roi_ccsl = { std::ref(named_cc.second) };
+            const auto mask = Get_ROI_Span_Mask( img, roi_ccsl,
+                                                 Mutate_Voxels_Opts::Inclusivity::Centre,
+                                                 Mutate_Voxels_Opts::ContourOverlap::Ignore );
+
+            auto &accumulated = user_data_s->accumulated_voxels[ named_cc.first ];
+            for(const auto &s : mask->spans){
+                for(int64_t col = s.col_begin; col < s.col_end; ++col){
+                    for(int64_t chan = 0; chan < img.channels; ++chan){
+                        //Cycle over the grouped images, accumulating the voxel intensity.
+                        double combined_voxel_intensity = 0.0;
+                        for(auto & img_it : selected_imgs){
+                            combined_voxel_intensity += static_cast<double>(img_it->value(s.row, col, chan));
+                        }
+                        accumulated.emplace_back(combined_voxel_intensity);
+                    }
+                }
+            }
+        }
 
     }
 
@@ -11,6 +11,10 @@
 #include <ostream>
 #include <stdexcept>
 #include <cstdint>
+#include <array>
+#include <cmath>
+#include <mutex>
+#include <vector>
 
 #include "YgorClustering.hpp"
 
@@ -21,11 +25,287 @@
 #include "YgorStats.h"       //Needed for Stats:: namespace.
 
 #include "../../Thread_Pool.h"
+#include "../../Voxel_Volume.h"
 #include "../Grouping/Misc_Functors.h"
 #include "../ConvenienceRoutines.h"
 #include "Compare_Images.h"
 
 
+namespace {
+
+// A reference image array that forms a regular grid, with a single channel copied into contiguous storage so that
+// voxel values and positions can be sampled without image lookups.
+struct reference_grid_t {
+    voxel_grid_index<float,double> grid;
+    std::vector<float> vals; // (slice, row, column) ordering, column fastest.
+
+    reference_grid_t(const voxel_grid_index<float,double> &grid, int64_t channel) : grid(grid) {
+        this->vals.reserve(static_cast<size_t>(grid.slices * grid.rows * grid.cols));
+        for(int64_t z = 0; z < grid.slices; ++z){
+            const auto &img = grid.image(0, z);
+            for(int64_t r = 0; r < grid.rows; ++r){
+                for(int64_t c = 0; c < grid.cols; ++c){
+                    this->vals.push_back( img.value(r, c, channel) );
+                }
+            }
+        }
+    }
+
+    bool contains(int64_t z, int64_t r, int64_t c) const {
+        return (0 <= z) && (z < this->grid.slices)
+            && (0 <= r) && (r < this->grid.rows)
+            && (0 <= c) && (c < this->grid.cols);
+    }
+
+    float value(int64_t z, int64_t r, int64_t c) const {
+        return this->vals[static_cast<size_t>((z * this->grid.rows + r) * this->grid.cols + c)];
+    }
+
+    vec3<double> position(int64_t z, int64_t r, int64_t c) const {
+        return this->grid.position(z, r, c);
+    }
+
+    // The voxel nearest to the given position, if the position is within the grid (including half a voxel margin).
+    std::optional<std::array<int64_t, 3>> nearest(const vec3<double> &pos) const {
+        const auto rel = pos - this->grid.origin;
+        const auto project = [&](const vec3<double> &step) -> double {
+            const auto l2 = step.Dot(step);
+            return (l2 <= 0.0) ? 0.0 : std::round(rel.Dot(step) / l2);
+        };
+        const auto z = project(this->grid.slice_step);
+        const auto r = project(this->grid.row_step);
+        const auto c = project(this->grid.col_step);
+        if( !std::isfinite(z) || !std::isfinite(r) || !std::isfinite(c) ) return {};
+        const std::array<int64_t, 3> out = {{ static_cast<int64_t>(z), static_cast<int64_t>(r), static_cast<int64_t>(c) }};
+        if(!this->contains(out[0], out[1], out[2])) return {};
+        return out;
+    }
+};
+
+// A search stencil offset, in (slice, row, column) voxel units, along with its length in DICOM units.
+struct stencil_offset_t {
+    int64_t dz;
+    int64_t dr;
+    int64_t dc;
+    double dist;
+};
+
+// All offsets within the given radius, sorted by increasing length. Returns an empty optional if the stencil would be
+// unreasonably large.
+std::optional<std::vector<stencil_offset_t>>
+Sorted_Search_Stencil(const voxel_grid_index<float,double> &grid, double radius){
+    const auto extent = [&](const vec3<double> &step, int64_t N) -> int64_t {
+        const auto l = step.length();
+        if(l <= 0.0) return 0;
+        return static_cast<int64_t>( std::min<double>( std::ceil(radius / l), static_cast<double>(N - 1) ) );
+    };
+    const auto nz = extent(grid.slice_step, grid.slices);
+    const auto nr = extent(grid.row_step, grid.rows);
+    const auto nc = extent(grid.col_step, grid.cols);
+    const auto N = (2 * nz + 1) * (2 * nr + 1) * (2 * nc + 1);
+    if(50'000'000 < N) return {};
+
+    std::vector<stencil_offset_t> out;
+    for(int64_t dz = -nz; dz <= nz; ++dz){
+        for(int64_t dr = -nr; dr <= nr; ++dr){
+            for(int64_t dc = -nc; dc <= nc; ++dc){
+                const auto dist = ( grid.slice_step * static_cast<double>(dz)
+                                  + grid.row_step * static_cast<double>(dr)
+                                  + grid.col_step * static_cast<double>(dc) ).length();
+                if(dist <= radius) out.push_back({ dz, dr, dc, dist });
+            }
+        }
+    }
+    std::stable_sort( std::begin(out), std::end(out),
+                      [](const stencil_offset_t &a, const stencil_offset_t &b){ return (a.dist < b.dist); } );
+    return out;
+}
+
+// A reference voxel value and position.
+struct reference_sample_t {
+    double val;
+    vec3<double> pos;
+};
+
+// Refine the DTA by interpolating between a reference voxel and its neighbours to find where the edit voxel value is
+// reached. 'sample' returns the reference voxel at (image number, row, column), or nothing if there is no such voxel.
+// Dist is reduced if a closer point is found.
+template <class F_sample>
+void
+Refine_DTA_Via_Interpolation(const F_sample &sample,
+                             ComputeCompareImagesUserData::InterpolationMethod interpolation_method,
+                             int64_t l_num, int64_t l_row, int64_t l_col,
+                             double adj_img_val,
+                             const vec3<double> &adj_vox_pos,
+                             double edit_val,
+                             const vec3<double> &pos,
+                             double &Dist){
+    const bool is_lower = (adj_img_val < edit_val);
+    const bool is_higher = (edit_val < adj_img_val);
+
+    // Sample the (6) 3D nearest neighbours and interpolate between them if necessary.
+    // 
+    // Note that this technique merely interpolates along the edges of the voxel-to-voxel grid.
+    // It is robust and comparable in speed to no interpolation.
+    if( (interpolation_method == ComputeCompareImagesUserData::InterpolationMethod::NN)
+    ||  (interpolation_method == ComputeCompareImagesUserData::InterpolationMethod::NNN) ){
+
+        // In pixel coordinates, these points are all a distance of sqrt(1)=1 from the centre voxel.
+        constexpr std::array<std::array<int64_t, 3>, 6> nn_triplets = {{
+                { -1,  0,  0 },
+                {  1,  0,  0 },
+                {  0, -1,  0 },
+                {  0,  1,  0 },
+                {  0,  0, -1 },
+                {  0,  0,  1 }
+        }};
+
+        for(const auto &triplets : nn_triplets){
+            const auto nn = sample(l_num + triplets[2], l_row + triplets[0], l_col + triplets[1]);
+            if(!nn) continue;
+            const auto nn_val = nn->val;
+
+            // Skip this neighbour if it does not complement the central voxel and therefore cannot be interpolated to
+            // the target value.
+            const bool nn_is_lower = (nn_val < edit_val);
+            const bool nn_is_higher = (edit_val < nn_val);
+            if( !( (is_higher && nn_is_lower) || (is_lower && nn_is_higher) ) ) continue;
+
+            // Determine the 3D point at which the target value is reached.
+            const auto &nn_pos = nn->pos;
+            const auto nn_v_unit = (adj_vox_pos - nn_pos).unit();
+            if( ! nn_v_unit.isfinite() ){
+                throw std::logic_error("Diagonal and centre overlap. Cannot continue.");
+            }
+
+            // Since either:
+            //    adj_img_val <= edit_val <= nn_val
+            // or
+            //    adj_img_val >= edit_val >= nn_val
+            // then
+            //   |adj_img_val - nn_val| >= |edit_val - nn_val|.
+            // so we can use this to scale the translation from nn to adj_img.
+            const auto dR = nn_pos.distance( adj_vox_pos );
+            const auto d_target = std::abs(edit_val - nn_val);
+            const auto d_val = std::abs(adj_img_val - nn_val);
+            const auto R_target = nn_pos + (nn_v_unit * dR * d_target / d_val);
+
+            const auto R_dist = R_target.distance(pos);
+            if(R_dist < Dist) Dist = R_dist;
+        }
+    }
+
+    // Sample the (12) 3D next-nearest neighbours and interpolate between them if necessary.
+    // 
+    // Note that this technique interpolates the planar diagonal along the edges of the voxel-to-voxel grid.
+    // It requires solving a quadratic polynomial and is therefore more computationally demanding.
+    // Numerical difficulties are also amplified, which results in lower accuracy than nearest-neighbour
+    // interpolation.
+    if(interpolation_method == ComputeCompareImagesUserData::InterpolationMethod::NNN){
+        // In pixel coordinates, these points are all sqrt(2) distance from the centre voxel.
+        // The following triplets come in packs of triplets: the first triplet is the diagonal position
+        // and the second and third triplets are corners which are needed for interpolation.
+        //
+        // As you can see, the corners can be summed to give the diagonals; they could also be decomposed
+        // this way, but it seemed easier to just write them all out.
+        constexpr std::array<std::array<std::array<int64_t, 3>, 3>, 12> nnn_triplets = {{
+                {{ { -1,  0, -1 },   {  0,  0, -1 },  { -1,  0,  0 } }},
+                {{ {  0, -1, -1 },   {  0,  0, -1 },  {  0, -1,  0 } }},
+                {{ {  0,  1, -1 },   {  0,  0, -1 },  {  0,  1,  0 } }},
+                {{ {  1,  0, -1 },   {  0,  0, -1 },  {  1,  0,  0 } }},
+
+                {{ { -1, -1,  0 },   {  0, -1,  0 },  { -1,  0,  0 } }},
+                {{ { -1,  1,  0 },   {  0,  1,  0 },  { -1,  0,  0 } }},
+                {{ {  1, -1,  0 },   {  0, -1,  0 },  {  1,  0,  0 } }},
+                {{ {  1,  1,  0 },   {  0,  1,  0 },  {  1,  0,  0 } }},
+
+                {{ { -1,  0,  1 },   {  0,  0,  1 },  { -1,  0,  0 } }},
+                {{ {  0, -1,  1 },   {  0,  0,  1 },  {  0, -1,  0 } }},
+                {{ {  0,  1,  1 },   {  0,  0,  1 },  {  0,  1,  0 } }},
+                {{ {  1,  0,  1 },   {  0,  0,  1 },  {  1,  0,  0 } }}
+        }};
+
+        for(const auto &t_triplets : nnn_triplets){
+            const auto diag = sample(l_num + t_triplets[0][2], l_row + t_triplets[0][0], l_col + t_triplets[0][1]);
+            const auto cA = sample(l_num + t_triplets[1][2], l_row + t_triplets[1][0], l_col + t_triplets[1][1]);
+            const auto cB = sample(l_num + t_triplets[2][2], l_row + t_triplets[2][0], l_col + t_triplets[2][1]);
+            if(!diag || !cA || !cB) continue;
+            const auto diag_val = diag->val;
+
+            // Skip this neighbour if it does not complement the central voxel and therefore cannot be interpolated to
+            // the target value.
+            const bool diag_is_lower = (diag_val < edit_val);
+            const bool diag_is_higher = (edit_val < diag_val);
+            if( !( (is_higher && diag_is_lower) || (is_lower && diag_is_higher) ) ) continue;
+
+            // Determine the 3D point at which the target value is reached.
+            const auto a = adj_img_val - edit_val;
+            const auto b = (cA->val - adj_img_val) + (cB->val - adj_img_val);
+            const auto d = diag_val + adj_img_val - cA->val - cB->val;
+
+            const auto x_a = (-b + std::sqrt( b*b - 4.0*d*a ) ) / (2.0 * d);
+            const auto x_b = (-b - std::sqrt( b*b - 4.0*d*a ) ) / (2.0 * d);
+            if(!std::isfinite(x_a) && !std::isfinite(x_b)) continue;
+
+            auto x = (isininc(0.0, x_a, 1.0)) ? x_a : x_b;
+
+            if( !(isininc(0.0, x_a, 1.0)) && !(isininc(0.0, x_b, 1.0)) ){
+                // This is probably a numerical error. Accept values slightly beyond the limits.
+                const auto x_a_c = std::clamp<double>(x_a, 0.0, 1.0);
+                const auto x_b_c = std::clamp<double>(x_b, 0.0, 1.0);
+                x = (std::abs(x_a - x_a_c) < std::abs(x_b - x_b_c)) ? x_a_c : x_b_c;
+            }
+
+            if( (isininc(0.0, x_a, 1.0)) && (isininc(0.0, x_b, 1.0)) ){
+                // This is probably a numerical error. Accept the value closest to the middle of the range since the
+                // phony root is likely to hover around the range extrema.
+                x = (std::abs(x_a - 0.5) < std::abs(x_b - 0.5)) ? x_a : x_b;
+            }
+
+            const auto diag_v = (diag->pos - adj_vox_pos);
+            if( ! diag_v.isfinite() ){
+                throw std::logic_error("Diagonal and centre overlap. Cannot continue.");
+            }
+
+            const auto R_target = adj_vox_pos + (diag_v * x);
+            const auto R_dist = R_target.distance(pos);
+            if(R_dist < Dist) Dist = R_dist;
+        }
+    }
+    return;
+}
+
+// The voxel value for the requested comparison, given the discrepancy and DTA. When computing the gamma index, the
+// voxel is tallied in 'count', and also in 'passed' if gamma < 1.
+double
+Comparison_Result(const ComputeCompareImagesUserData &ud,
+                  double Disc,
+                  double Dist,
+                  double inaccessible_val,
+                  int64_t &passed,
+                  int64_t &count){
+    if(ud.comparison_method == ComputeCompareImagesUserData::ComparisonMethod::Discrepancy){
+        return Disc;
+
+    }else if(ud.comparison_method == ComputeCompareImagesUserData::ComparisonMethod::DTA){
+        return std::isfinite(Dist) ? Dist : inaccessible_val;
+
+    }else if(ud.comparison_method == ComputeCompareImagesUserData::ComparisonMethod::GammaIndex){
+        count += 1;
+        if(std::isfinite(Dist) && std::isfinite(Disc)){
+            const auto gamma = std::sqrt( std::pow(Dist / ud.gamma_DTA_threshold, 2.0)
+                                        + std::pow(Disc / ud.gamma_Dis_threshold, 2.0) );
+            if(gamma < 1.0) passed += 1;
+            return gamma;
+        }
+        return inaccessible_val;
+    }
+    throw std::logic_error("Unrecognized comparison operation requested. Refusing to continue.");
+}
+
+} // namespace
+
+
 bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
                           std::list<std::reference_wrapper<planar_image_collection<float,double>>> external_imgs,
                           std::list<std::reference_wrapper<contour_collection<double>>> ccsl,
@@ -49,6 +329,14 @@ bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
     // For the fastest and most accurate results, test and reference image arrays should exactly align. However, it is not
     // necessary. Ii test and reference image arrays are aligned, image adjacency is precomputed. Otherwise image
     // adjacency is evaluated for every voxel.
+    //
+    // If the reference image array forms a regular grid, reference voxels are instead sampled from contiguous storage
+    // and the DTA search visits voxels in order of increasing distance, which permits terminating the search as soon as
+    // the DTA can no longer be improved. This is considerably faster, but voxels are visited in a different order so
+    // the straddle-based estimates (see below) can differ slightly. The search also never visits voxels beyond the
+    // cut-offs, whereas the general implementation completes each rectangular wavefront. So failing voxels can be
+    // labelled differently (e.g., NaN or gamma_terminated_early rather than a finite gamma > 1). All of these labels
+    // indicate failure, so pass rates are not affected.
 
 
     //We require a valid ComputeCompareImagesUserData struct packed into the user_data.
@@ -143,7 +431,206 @@ bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
     mv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
 
 
-    std::mutex passing_counter; // Used to tally the gamma passing rate.
+    // If the reference images form a regular grid, search for agreement using a precomputed, sorted-distance stencil.
+    //
+    // The stencil visits reference voxels in order of increasing distance, so the search can stop as soon as no
+    // further voxel could improve the DTA, rather than after completing each rectangular wavefront. Reference voxel
+    // values are copied into contiguous storage so that neighbours can be sampled directly.
+    std::optional<reference_grid_t> ref_grid;
+    std::vector<stencil_offset_t> stencil;
+    if( (ud_channel >= 0)
+    &&  user_data_s->use_regular_grid_search ){
+        const auto grid = Current_Voxel_Grid_Index(user_data_s->ref_grid_index, external_imgs.front().get());
+        if( grid
+        &&  (grid->frames == 1)
+        &&  (ud_channel < grid->channels) ){
+            const auto &img0 = grid->image(0, 0);
+            const auto max_interp_dist = std::hypot( img0.pxl_dx, img0.pxl_dy, img0.pxl_dz );
+            auto search_dist = user_data_s->DTA_max;
+            if(user_data_s->gamma_terminate_when_max_exceeded){
+                search_dist = std::min(search_dist, user_data_s->gamma_DTA_threshold);
+            }
+            if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::Discrepancy){
+                search_dist = 0.0;
+            }
+
+            // Offsets are relative to the reference voxel nearest each voxel, which is at most max_interp_dist away.
+            // The stencil extends somewhat beyond the search cut-off so the search is always terminated explicitly.
+            auto l_stencil = Sorted_Search_Stencil(*grid, search_dist + 3.0 * max_interp_dist);
+            if(l_stencil){
+                stencil = std::move(l_stencil.value());
+                ref_grid.emplace(*grid, ud_channel);
+            }
+        }
+    }
+    if(ref_grid){
+        const auto &ref = ref_grid.value();
+        const auto &img0 = ref.grid.image(0, 0);
+        const auto pxl_dl = std::max<double>( std::min<double>({ img0.pxl_dx, img0.pxl_dy, img0.pxl_dz }), 10.0 * machine_eps );
+        const auto max_interp_dist = std::hypot( img0.pxl_dx, img0.pxl_dy, img0.pxl_dz );
+
+        std::mutex saver_printer; // Who gets to print to the console, iterate the counters, and tally the passing rate.
+        int64_t completed = 0;
+        const int64_t img_count = imagecoll.images.size();
+
+        // Each task handles a slab of the edited image array (i.e., a single image).
+        work_queue<std::function<void(void)>> wq;
+        for(auto &img : imagecoll.images){
+            std::reference_wrapper< planar_image<float, double>> img_refw( std::ref(img) );
+
+            wq.submit_task([&,img_refw]() -> void {
+                int64_t l_passed = 0;
+                int64_t l_count = 0;
+
+                auto f_bounded = [&,img_refw](int64_t E_row, int64_t E_col, int64_t channel,
+                                              std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
+                                              std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
+                                              float &voxel_val) {
+                    if( !isininc( user_data_s->inc_lower_threshold, voxel_val, user_data_s->inc_upper_threshold) ){
+                        return; // No-op if outside of the thresholds.
+                    }
+                    if( channel != ud_channel){
+                        return; // No-op if this is the wrong channel.
+                    }
+                    const auto edit_val = voxel_val;
+                    const auto pos = img_refw.get().position(E_row, E_col);
+
+                    // Locate the nearest reference voxel.
+                    const auto nearest = ref.nearest(pos);
+                    if(!nearest){
+                        voxel_val = inaccessible_val; // Cannot assess this voxel.
+                        return;
+                    }
+                    const auto R_num = nearest.value()[0];
+                    const auto R_row = nearest.value()[1];
+                    const auto R_col = nearest.value()[2];
+
+                    // Verify if the voxel needs to be compared.
+                    const auto ring_0_val = ref.value(R_num, R_row, R_col);
+                    if(!isininc( user_data_s->ref_img_inc_lower_threshold, ring_0_val, user_data_s->ref_img_inc_upper_threshold)){
+                        voxel_val = inaccessible_val;
+                        return;
+                    }
+
+                    // Ensure the voxel position in the edit image and reference image match reasonably.
+                    const auto ring_0_dist = ref.position(R_num, R_row, R_col).distance(pos);
+                    if(ring_0_dist > pxl_dl){
+                        voxel_val = inaccessible_val;
+                        return;
+                    }
+
+                    // Perform a discrepancy comparison.
+                    const auto Disc = estimate_discrepancy(edit_val, ring_0_val);
+
+                    // If computing the gamma index, check if we can avoid a costly DTA search.
+                    if( (user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::GammaIndex) 
+                    &&  (user_data_s->gamma_terminate_when_max_exceeded)
+                    &&  (Disc > user_data_s->gamma_Dis_threshold) ){
+                        voxel_val = user_data_s->gamma_terminated_early;
+                        return;
+                    }
+
+                    // Perform a DTA analysis IFF needed.
+                    double Dist = std::numeric_limits<double>::infinity();
+                    if( (user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::DTA)
+                    ||  ( (user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::GammaIndex)
+                          && std::isfinite(Disc) ) ){
+
+                        bool encountered_lower = false;  // Whether a voxel lower than required was found.
+                        bool encountered_higher = false; // Whether a voxel higher than required was found.
+                        for(const auto &o : stencil){
+                            // The closest any remaining voxel can be.
+                            const auto nearest_dist = o.dist - ring_0_dist;
+
+                            if((Dist + max_interp_dist) < nearest_dist){
+                                // It is now impossible to improve the DTA because the remaining voxels will all
+                                // necessarily be further away. So terminate the search.
+                                break;
+                            }
+                            if(nearest_dist > (user_data_s->DTA_max + max_interp_dist)){
+                                break; // Terminate the search if the user has instructed so.
+                            }
+                            if( (user_data_s->gamma_terminate_when_max_exceeded)
+                            &&  (nearest_dist > (user_data_s->gamma_DTA_threshold + max_interp_dist)) ){
+                                voxel_val = user_data_s->gamma_terminated_early;
+                                return;
+                            }
+
+                            const auto l_num = R_num + o.dz;
+                            const auto l_row = R_row + o.dr;
+                            const auto l_col = R_col + o.dc;
+                            if(!ref.contains(l_num, l_row, l_col)) continue;
+
+                            const auto adj_img_val = ref.value(l_num, l_row, l_col);
+                            const auto adj_vox_pos = ref.position(l_num, l_row, l_col);
+                            const auto adj_vox_dist = adj_vox_pos.distance(pos);
+
+                            // Check if voxel values have been seen both above and below the desired value. See the
+                            // general implementation below for details.
+                            const bool is_lower = (adj_img_val < edit_val);
+                            const bool is_higher = (edit_val < adj_img_val);
+                            encountered_lower = encountered_lower || is_lower;
+                            encountered_higher = encountered_higher || is_higher;
+                            if( ( encountered_lower && is_higher )
+                            ||  ( encountered_higher && is_lower ) ){
+                                const auto worst_case_straddle_dist = adj_vox_dist + max_interp_dist;
+                                if(worst_case_straddle_dist < Dist){
+                                    Dist = worst_case_straddle_dist;
+                                }
+                            }
+
+                            if( ( std::abs(adj_img_val - edit_val) < user_data_s->DTA_vox_val_eq_abs )
+                            ||  ( relative_diff(adj_img_val, edit_val) < user_data_s->DTA_vox_val_eq_reldiff ) ){
+                                if(adj_vox_dist < Dist){
+                                    Dist = adj_vox_dist;
+                                }
+
+                            }else if(adj_vox_dist < (Dist + max_interp_dist)){
+                                auto sample = [&](int64_t n_img, int64_t n_row, int64_t n_col) -> std::optional<reference_sample_t> {
+                                    if(!ref.contains(n_img, n_row, n_col)) return {};
+                                    return reference_sample_t{ ref.value(n_img, n_row, n_col), ref.position(n_img, n_row, n_col) };
+                                };
+                                Refine_DTA_Via_Interpolation( sample, user_data_s->interpolation_method,
+                                                              l_num, l_row, l_col, adj_img_val, adj_vox_pos,
+                                                              edit_val, pos, Dist );
+                            }
+                        }
+                    }
+
+                    // Assign the voxel a value.
+                    voxel_val = Comparison_Result( *user_data_s, Disc, Dist, inaccessible_val, l_passed, l_count );
+                    return;
+                };
+
+                Mutate_Voxels<float,double>( img_refw,
+                                             { img_refw },
+                                             ccsl, 
+                                             mv_opts, 
+                                             f_bounded );
+
+                if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::Discrepancy){
+                    UpdateImageDescription( img_refw, "Compared (discrepancy)" );
+                }else if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::DTA){
+                    UpdateImageDescription( img_refw, "Compared (DTA)" );
+                }else if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::GammaIndex){
+                    UpdateImageDescription( img_refw, "Compared (gamma-index)" );
+                }
+                UpdateImageWindowCentreWidth( img_refw );
+
+                //Report operation progress and tally the passing counts.
+                {
+                    std::lock_guard<std::mutex> lock(saver_printer);
+                    user_data_s->passed += l_passed;
+                    user_data_s->count += l_count;
+                    ++completed;
+                    YLOGINFO("Completed " << completed << " of " << img_count
+                          << " --> " << static_cast<int>(1000.0*(completed)/img_count)/10.0 << "% done");
+                }
+            }); // thread pool task closure.
+        }
+        return true;
+    }
+
 
     std::mutex saver_printer; // Who gets to save generated contours, print to the console, and iterate the counter.
     int64_t completed = 0;
@@ -170,6 +657,8 @@ bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
                                                                     : std::addressof(overlapping_img_refws.front().get());
             if(overlapping_img_refws.empty()) YLOGWARN("No wholly overlapping reference images found, using slower per-voxel sampling");
 
+            int64_t l_passed = 0;
+            int64_t l_count = 0;
 
             auto f_bounded = [&,img_refw](int64_t E_row, int64_t E_col, int64_t channel,
                                           std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
@@ -359,195 +848,17 @@ bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
                                         // certain amount.
                                         }else if(adj_vox_dist < (Dist + max_interp_dist)){
 
-                                            // Sample the (6) 3D nearest neighbours and interpolate between them if necessary.
-                                            // 
-                                            // Note that this technique merely interpolates along the edges of the voxel-to-voxel grid.
-                                            // It is robust and comparable in speed to no interpolation.
-                                            if( (user_data_s->interpolation_method == ComputeCompareImagesUserData::InterpolationMethod::NN)
-                                            ||  (user_data_s->interpolation_method == ComputeCompareImagesUserData::InterpolationMethod::NNN) ){
-
-                                                // In pixel coordinates, these points are all a distance of sqrt(1)=1 from the centre voxel.
-                                                std::array<std::array<int64_t, 3>, 6> nn_triplets = {{
-                                                        { -1,  0,  0 },
-                                                        {  1,  0,  0 },
-                                                        {  0, -1,  0 },
-                                                        {  0,  1,  0 },
-                                                        {  0,  0, -1 },
-                                                        {  0,  0,  1 }
-                                                }};
-
-                                                for(const auto &triplets : nn_triplets){
-                                                    const auto nn_row = l_row + triplets[0];
-                                                    const auto nn_col = l_col + triplets[1];
-                                                    const auto nn_img = l_num + triplets[2];
-
-                                                    if(img_adj.index_present(nn_img)
-                                                    && isininc(0, nn_row, adj_img_ptr->rows - 1L)
-                                                    && isininc(0, nn_col, adj_img_ptr->columns - 1L) ){
-                                                    
-                                                        auto nn_img_refw = img_adj.index_to_image(nn_img);
-                                                        const auto nn_val = nn_img_refw.get().value(nn_row, nn_col, channel);
-
-                                                        const bool nn_is_lower = (nn_val < edit_val);
-                                                        const bool nn_is_higher = (edit_val < nn_val);
-
-                                                        // Skip this neighbour if it does not complement the central
-                                                        // voxel and therefore cannot be interpolated to the target
-                                                        // value.
-                                                        //if( !( (nn_is_lower || is_lower) && (nn_is_higher || is_higher) ) ) continue;
-                                                        // equiv to:  (?)
-                                                        if( !( (is_higher && nn_is_lower) || (is_lower && nn_is_higher) ) ) continue;
-
-                                                        // Determine the 3D point at which the target value is reached.
-                                                        const auto nn_pos = nn_img_refw.get().position(nn_row, nn_col);
-                                                        const auto nn_v_unit = (adj_vox_pos - nn_pos).unit();
-                                                        //if( ! nn_v_unit.isfinite() ) continue;
-                                                        if( ! nn_v_unit.isfinite() ){
-                                                            throw std::logic_error("Diagonal and centre overlap. Cannot continue.");
-                                                        }
-
-                                                        // Abandon the calculation if the point is on the wrong side of
-                                                        // the centre voxel (and thus the interpolation will necessarily
-                                                        // be further away than the centre voxel).
-                                                        //if( (pos - nn_pos).Dot(nn_v_unit) <= 0.0 ) continue;
-                                                        //if( (pos - nn_pos).Dot(nn_v_unit) >= 0.0 ) continue;
-
-                                                        // Since either:
-                                                        //    adj_img_val <= edit_val <= nn_val
-                                                        // or
-                                                        //    adj_img_val >= edit_val >= nn_val
-                                                        // then
-                                                        //   |adj_img_val - nn_val| >= |edit_val - nn_val|.
-                                                        // so we can use this to scale the translation from nn to adj_img.
-                                                        const auto dR = nn_pos.distance( adj_vox_pos );
-                                                        const auto d_target = std::abs(edit_val - nn_val);
-                                                        const auto d_val = std::abs(adj_img_val - nn_val);
-                                                        const auto R_target = nn_pos + (nn_v_unit * dR * d_target / d_val);
-
-                                                        const auto R_dist = R_target.distance(pos);
-                                                        if(R_dist < Dist) Dist = R_dist;
-                                                    } // If: triplet is valid.
-                                                } // Loop over adjacent neighbours.
-                                            } // If: using NN interpolation.
-                                            
-                                            // Sample the (12) 3D next-nearest neighbours and interpolate between them if necessary.
-                                            // 
-                                            // Note that this technique interpolates the planar diagonal along the edges of the voxel-to-voxel grid.
-                                            // It requires solving a quadratic polynomial and is therefore more computationally demanding.
-                                            // Numerical difficulties are also amplified, which results in lower accuracy than nearest-neighbour
-                                            // interpolation.
-                                            if(user_data_s->interpolation_method == ComputeCompareImagesUserData::InterpolationMethod::NNN){
-                                                //In pixel coordinates, these points are all sqrt(2) distance from the centre voxel.
-                                                // The following triplets come in packs of triplets: the first triplet is the diagonal position
-                                                // and the second and third triplets are corners which are needed for interpolation.
-                                                //
-                                                // As you can see, the corners can be summed to give the diagonals; they could also be decomposed
-                                                // this way, but it seemed easier to just write them all out.
-                                                std::array<std::array<std::array<int64_t, 3>, 3>, 12> nnn_triplets = {{
-                                                        {{ { -1,  0, -1 },   {  0,  0, -1 },  { -1,  0,  0 } }},
-                                                        {{ {  0, -1, -1 },   {  0,  0, -1 },  {  0, -1,  0 } }},
-                                                        {{ {  0,  1, -1 },   {  0,  0, -1 },  {  0,  1,  0 } }},
-                                                        {{ {  1,  0, -1 },   {  0,  0, -1 },  {  1,  0,  0 } }},
-                                                                        
-                                                        {{ { -1, -1,  0 },   {  0, -1,  0 },  { -1,  0,  0 } }},
-                                                        {{ { -1,  1,  0 },   {  0,  1,  0 },  { -1,  0,  0 } }},
-                                                        {{ {  1, -1,  0 },   {  0, -1,  0 },  {  1,  0,  0 } }},
-                                                        {{ {  1,  1,  0 },   {  0,  1,  0 },  {  1,  0,  0 } }},
-                                                                        
-                                                        {{ { -1,  0,  1 },   {  0,  0,  1 },  { -1,  0,  0 } }},
-                                                        {{ {  0, -1,  1 },   {  0,  0,  1 },  {  0, -1,  0 } }},
-                                                        {{ {  0,  1,  1 },   {  0,  0,  1 },  {  0,  1,  0 } }},
-                                                        {{ {  1,  0,  1 },   {  0,  0,  1 },  {  1,  0,  0 } }}
-                                                }};
-
-                                                for(const auto &t_triplets : nnn_triplets){
-                                                    const auto diag_row = l_row + t_triplets[0][0];  // Diagonal.
-                                                    const auto diag_col = l_col + t_triplets[0][1];
-                                                    const auto diag_img = l_num + t_triplets[0][2];
-
-                                                    const auto cA_row = l_row + t_triplets[1][0];  // Corner A.
-                                                    const auto cA_col = l_col + t_triplets[1][1];
-                                                    const auto cA_img = l_num + t_triplets[1][2];
-
-                                                    const auto cB_row = l_row + t_triplets[2][0];  // Corner B.
-                                                    const auto cB_col = l_col + t_triplets[2][1];
-                                                    const auto cB_img = l_num + t_triplets[2][2];  
-
-                                                    if(img_adj.index_present(diag_img)
-                                                    && img_adj.index_present(cA_img)
-                                                    && img_adj.index_present(cB_img)
-                                                    && isininc(0, diag_row, adj_img_ptr->rows - 1L)
-                                                    && isininc(0, diag_col, adj_img_ptr->columns - 1L)
-                                                    && isininc(0, cA_row,   adj_img_ptr->rows - 1L)
-                                                    && isininc(0, cA_col,   adj_img_ptr->columns - 1L)
-                                                    && isininc(0, cB_row,   adj_img_ptr->rows - 1L)
-                                                    && isininc(0, cB_col,   adj_img_ptr->columns - 1L) ){
-                                                    
-                                                        auto diag_img_refw = img_adj.index_to_image(diag_img);
-                                                        const auto diag_val = diag_img_refw.get().value(diag_row, diag_col, channel);
-
-                                                        const bool diag_is_lower = (diag_val < edit_val);
-                                                        const bool diag_is_higher = (edit_val < diag_val);
-
-                                                        // Skip this neighbour if it does not complement the central
-                                                        // voxel and therefore cannot be interpolated to the target
-                                                        // value.
-                                                        if( !( (is_higher && diag_is_lower) || (is_lower && diag_is_higher) ) ) continue;
-
-                                                        auto cA_img_refw  = img_adj.index_to_image(cA_img);
-                                                        auto cB_img_refw  = img_adj.index_to_image(cB_img);
-                                                        const auto cA_val = cA_img_refw.get().value(cA_row, cA_col, channel);
-                                                        const auto cB_val = cB_img_refw.get().value(cB_row, cB_col, channel);
-
-                                                        // Determine the 3D point at which the target value is reached.
-                                                        const auto a = adj_img_val - edit_val;
-                                                        const auto b = (cA_val - adj_img_val) + (cB_val - adj_img_val);
-                                                        const auto d = diag_val + adj_img_val - cA_val - cB_val;
-
-                                                        const auto x_a = (-b + std::sqrt( b*b - 4.0*d*a ) ) / (2.0 * d);
-                                                        const auto x_b = (-b - std::sqrt( b*b - 4.0*d*a ) ) / (2.0 * d);
-                                                        if(!std::isfinite(x_a) && !std::isfinite(x_b)) continue;
-
-                                                        auto x = (isininc(0.0, x_a, 1.0)) ? x_a : x_b;
-
-                                                        if( !(isininc(0.0, x_a, 1.0)) && !(isininc(0.0, x_b, 1.0)) ){
-                                                            // This is probably a numerical error. Accept values slightly
-                                                            // beyond the limits.
-                                                            const auto x_a_c = std::clamp<double>(x_a, 0.0, 1.0);
-                                                            const auto x_b_c = std::clamp<double>(x_b, 0.0, 1.0);
-                                                            x = (std::abs(x_a - x_a_c) < std::abs(x_b - x_b_c)) ? x_a_c : x_b_c;
-                                                        }
-
-                                                        if( (isininc(0.0, x_a, 1.0)) && (isininc(0.0, x_b, 1.0)) ){
-                                                            // This is probably a numerical error. Accept the value closest
-                                                            // to the middle of the range since the phony root is likely to
-                                                            // hover around the range extrema.
-                                                            x = (std::abs(x_a - 0.5) < std::abs(x_b - 0.5)) ? x_a : x_b;
-                                                        }
-
-                                                        const auto diag_pos = diag_img_refw.get().position(diag_row, diag_col);
-                                                        const auto diag_v = (diag_pos - adj_vox_pos);
-                                                        if( ! diag_v.isfinite() ){
-                                                            throw std::logic_error("Diagonal and centre overlap. Cannot continue.");
-                                                        }
-
-                                                        // Abandon the calculation if the point is on the wrong side of
-                                                        // the centre voxel (and thus the interpolation will necessarily
-                                                        // be further away than the centre voxel).
-                                                        //if( (pos - diag_pos).Dot(diag_v_unit) <= 0.0 ) continue;
-                                                        //if( (pos - diag_pos).Dot(diag_v_unit) >= 0.0 ) continue;
-
-                                                        const auto R_target = adj_vox_pos + (diag_v * x);
-                                                        const auto R_dist = R_target.distance(pos);
-                                                        if(R_dist < Dist){
-                                                            Dist = R_dist;
-                                                        }
-
-                                                    } // If: triplet is valid.
-                                                } // Loop over adjacent neighbours.
-                                            } // If: using NNN interpolation.
-
-
+                                            auto sample = [&](int64_t n_img, int64_t n_row, int64_t n_col) -> std::optional<reference_sample_t> {
+                                                if( !img_adj.index_present(n_img)
+                                                ||  !isininc(0, n_row, adj_img_ptr->rows - 1L)
+                                                ||  !isininc(0, n_col, adj_img_ptr->columns - 1L) ) return {};
+                                                const auto n_img_refw = img_adj.index_to_image(n_img);
+                                                return reference_sample_t{ n_img_refw.get().value(n_row, n_col, channel),
+                                                                           n_img_refw.get().position(n_row, n_col) };
+                                            };
+                                            Refine_DTA_Via_Interpolation( sample, user_data_s->interpolation_method,
+                                                                          l_num, l_row, l_col, adj_img_val, adj_vox_pos,
+                                                                          edit_val, pos, Dist );
                                         } // If-else: avoid interpolating neighbours.
                                     } // Loop: j.
                                 } // Loop: i.
@@ -585,32 +896,7 @@ bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
                     }
 
                     // Assign the voxel a value.
-                    if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::Discrepancy){
-                        voxel_val = Disc;
-
-                    }else if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::DTA){
-                        if(std::isfinite(Dist)){
-                            voxel_val = Dist;
-                        }else{
-                            voxel_val = inaccessible_val;
-                        }
-
-                    }else if(user_data_s->comparison_method == ComputeCompareImagesUserData::ComparisonMethod::GammaIndex){
-                        std::lock_guard<std::mutex> lock(passing_counter);
-                        user_data_s->count += 1;
-
-                        if(std::isfinite(Dist) && std::isfinite(Disc)){
-                            voxel_val = std::sqrt( std::pow(Dist / user_data_s->gamma_DTA_threshold, 2.0)
-                                                 + std::pow(Disc / user_data_s->gamma_Dis_threshold, 2.0) );
-
-                            if(voxel_val < 1.0) user_data_s->passed += 1;
-                        }else{
-                            voxel_val = inaccessible_val;
-                        }
-
-                    }else{
-                        throw std::logic_error("Unrecognized comparison operation requested. Refusing to continue.");
-                    }
+                    voxel_val = Comparison_Result( *user_data_s, Disc, Dist, inaccessible_val, l_passed, l_count );
                     return;
                 }while(false);
                 return;
@@ -631,9 +917,11 @@ bool ComputeCompareImages(planar_image_collection<float,double> &imagecoll,
             }
             UpdateImageWindowCentreWidth( img_refw );
 
-            //Report operation progress.
+            //Report operation progress and tally the passing counts.
             {
                 std::lock_guard<std::mutex> lock(saver_printer);
+                user_data_s->passed += l_passed;
+                user_data_s->count += l_count;
                 ++completed;
                 YLOGINFO("Completed " << completed << " of " << img_count
                       << " --> " << static_cast<int>(1000.0*(completed)/img_count)/10.0 << "% done");
@@ -6,10 +6,12 @@
 #include <functional>
 #include <limits>
 #include <list>
+#include <memory>
 #include <cstdint>
 
 
 template <class T, class R> class planar_image_collection;
+template <class T, class R> struct voxel_grid_index;
 template <class T> class contour_collection;
 
 struct ComputeCompareImagesUserData {
@@ -133,6 +135,14 @@ struct ComputeCompareImagesUserData {
     double gamma_terminate_when_max_exceeded = true;
     double gamma_terminated_early = std::nextafter(1.0, std::numeric_limits<double>::infinity());
 
+    // An index of the reference images, e.g., from Image_Array::get_voxel_grid_index(). Optional, and only consulted
+    // by the regular-grid search. A stale index is ignored and the reference images are indexed anew.
+    std::shared_ptr<const voxel_grid_index<float,double>> ref_grid_index;
+
+    // Whether to search reference images that form a regular grid via contiguous storage and a sorted-distance
+    // stencil. If false, the general implementation is always used, which is mainly useful for validation.
+    bool use_regular_grid_search = true;
+
     // Outgoing gamma passing counts.
     //
     // These can be read by the caller after performing a gamma analysis.
@@ -14,6 +14,7 @@
 
 #include "../../Thread_Pool.h"
 #include "../../Metadata.h"
+#include "../../ROI_Span_Masks.h"
 #include "../Grouping/Misc_Functors.h"
 #include "../ConvenienceRoutines.h"
 #include "Extract_Histograms.h"
@@ -102,6 +103,35 @@ bool ComputeExtractHistograms(planar_image_collection<float,double> &imagecoll,
         }
     }
 
+    // Each logical partition is rasterized once per distinct image geometry, and the masks are shared by both passes
+    // below. Only the voxels that satisfy the user's criteria are visited.
+    std::map<std::string, uint64_t> fingerprints;
+    for(const auto &named_ccsl : named_ccsls) fingerprints[named_ccsl.first] = Contour_Fingerprint(named_ccsl.second);
+
+    const auto visit_bounded_voxels = [&](const planar_image<float,double> &img,
+                                          const std::pair<const std::string, ccsl_t> &named_ccsl,
+                                          const auto &f) -> void {
+        const auto mask = Get_ROI_Span_Mask( img, named_ccsl.second,
+                                             user_data_s->mutation_opts.inclusivity,
+                                             user_data_s->mutation_opts.contouroverlap,
+                                             fingerprints.at(named_ccsl.first) );
+        for(const auto &s : mask->spans){
+            for(int64_t col = s.col_begin; col < s.col_end; ++col){
+                for(int64_t chn = 0; chn < img.channels; ++chn){
+                    if( (0 <= user_data_s->channel) && (user_data_s->channel != chn) ) continue;
+
+                    const auto voxel_val = img.value(s.row, col, chn);
+                    if( std::isfinite(voxel_val)  // Ignore infinite and NaN voxels.
+                    &&  (user_data_s->lower_threshold <= voxel_val)
+                    &&  (voxel_val <= user_data_s->upper_threshold) ){
+                        f(voxel_val);
+                    }
+                }
+            }
+        }
+        return;
+    };
+
     // Determine voxel value extrema for each logical partition.
     std::map<std::string,               // ROIName.
              std::pair<double,          // Minimum voxel value (within the user's inclusive range).
@@ -124,27 +154,10 @@ bool ComputeExtractHistograms(planar_image_collection<float,double> &imagecoll,
                     double local_minimum = std::numeric_limits<double>::infinity();
                     double local_maximum = -local_minimum;
 
-                    auto f_bounded = [&](int64_t /*E_row*/, 
-                                         int64_t /*E_col*/,
-                                         int64_t channel,
-                                         std::reference_wrapper<planar_image<float,double>> /*l_img_refw*/,
-                                         std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                                         float &voxel_val) {
-                        if( ( (user_data_s->channel < 0) || (user_data_s->channel == channel))
-                        &&  std::isfinite(voxel_val)  // Ignore infinite and NaN voxels.
-                        &&  (user_data_s->lower_threshold <= voxel_val)
-                        &&  (voxel_val <= user_data_s->upper_threshold) ){
-                            if(voxel_val < local_minimum) local_minimum = voxel_val;
-                            if(local_maximum < voxel_val) local_maximum = voxel_val;
-                        }
-                        return;
-                    };
-
-                    Mutate_Voxels<float,double>( img_refw,
-                                                 { img_refw },
-                                                 named_ccsl.second, 
-                                                 user_data_s->mutation_opts, 
-                                                 f_bounded );
+                    visit_bounded_voxels( img_refw.get(), named_ccsl, [&](float voxel_val) -> void {
+                        if(voxel_val < local_minimum) local_minimum = voxel_val;
+                        if(local_maximum < voxel_val) local_maximum = voxel_val;
+                    });
 
                     // Merge the results.
                     if( std::isfinite(local_minimum) 
@@ -281,34 +294,15 @@ bool ComputeExtractHistograms(planar_image_collection<float,double> &imagecoll,
                         return;
                     };
 
-                    auto f_bounded = [&](int64_t /*E_row*/, 
-                                         int64_t /*E_col*/,
-                                         int64_t channel,
-                                         std::reference_wrapper<planar_image<float,double>> /*l_img_refw*/,
-                                         std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                                         float &voxel_val){
-
-                        if( ( (user_data_s->channel < 0) || (user_data_s->channel == channel))
-                        &&  std::isfinite(voxel_val)  // Ignore infinite and NaN voxels.
-                        &&  (user_data_s->lower_threshold <= voxel_val)
-                        &&  (voxel_val <= user_data_s->upper_threshold) ){
-
-                            const auto d_low = voxel_val - voxel_min;
-                            const auto bin_N = std::clamp<size_t>( static_cast<size_t>( std::floor(d_low/bin_width) ),
-                                                                   static_cast<size_t>(0),
-                                                                   static_cast<size_t>(bin_count-1) );
-                            //raw_diff_hist.at(bin_N)[2] += pxl_vol;
-                            shuttle.push_back(bin_N);
-                            if(N_shuttle == shuttle.size()) add_counts();
-                        }
-                        return;
-                    };
-
-                    Mutate_Voxels<float,double>( img_refw,
-                                                 { img_refw },
-                                                 named_ccsl.second, 
-                                                 user_data_s->mutation_opts, 
-                                                 f_bounded );
+                    visit_bounded_voxels( img_refw.get(), named_ccsl, [&](float voxel_val) -> void {
+                        const auto d_low = voxel_val - voxel_min;
+                        const auto bin_N = std::clamp<size_t>( static_cast<size_t>( std::floor(d_low/bin_width) ),
+                                                               static_cast<size_t>(0),
+                                                               static_cast<size_t>(bin_count-1) );
+                        //raw_diff_hist.at(bin_N)[2] += pxl_vol;
+                        shuttle.push_back(bin_N);
+                        if(N_shuttle == shuttle.size()) add_counts();
+                    });
 
                     add_counts(); // Commit all remaining bins from the shuttle.
                 } // Loop over all named ccs.
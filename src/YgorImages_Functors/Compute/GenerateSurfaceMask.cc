@@ -12,6 +12,7 @@
 #include <utility>
 #include <cstdint>
 
+#include "../../ROI_Span_Masks.h"
 #include "../../Thread_Pool.h"
 #include "../Grouping/Misc_Functors.h"
 #include "GenerateSurfaceMask.h"
@@ -36,10 +37,8 @@ bool ComputeGenerateSurfaceMask(planar_image_collection<float,double> &imagecoll
     // originally defined on OR -- even better -- to generate a custom grid that more tightly bound the ROI(s) but
     // is guaranteed to leave a margin around it for capturing the surface.
     //
-    // This routine treats all ROIs as though they belong to a single entity. Therefore, contours should not overlap or
-    // provide conflicting information. For example, if there are two parotid contours overlapping an image slice and a
-    // given voxel is inside one but not the other; in such case the results are undefined. (It might be the case that
-    // only the first ROI will be considered, but you should not rely on this behaviour!)
+    // This routine treats all ROIs as though they belong to a single entity. Voxels inside any contour are considered
+    // to be inside the entity, so overlapping contours are merged.
     //
     // Only the first channel will be altered.
     //
@@ -90,11 +89,6 @@ bool ComputeGenerateSurfaceMask(planar_image_collection<float,double> &imagecoll
         }
 
         planar_image<float,double> &img = std::ref(*selected_imgs.front());
-        //Loop over the rois, rows, columns, channels, and finally any selected images.
-        const auto row_unit   = img.row_unit;
-        const auto col_unit   = img.col_unit;
-        const auto ortho_unit = img.ortho_unit();
-   
         img.fill_pixels( 0, std::numeric_limits<float>::quiet_NaN() );
         
         //Find the (ranked) nearest images (above and below, if there are any) for later use.
@@ -124,6 +118,27 @@ bool ComputeGenerateSurfaceMask(planar_image_collection<float,double> &imagecoll
             continue;
         }
 
+        //Rasterize the contours once for this image and the neighbouring images. Images without any contours provide no
+        // information about the surface, so no mask is provided for them.
+        const auto fingerprint = Contour_Fingerprint(cc_select);
+        const auto get_mask = [&](const planar_image<float,double> &limg) -> std::shared_ptr<const roi_span_mask> {
+            for(auto &ccs : cc_select){
+                for(auto & contour : ccs.get().contours){
+                    if( !contour.points.empty()
+                    &&  limg.encompasses_contour_of_points(contour) ){
+                        return Get_ROI_Span_Mask( limg, cc_select,
+                                                  Mutate_Voxels_Opts::Inclusivity::Centre,
+                                                  Mutate_Voxels_Opts::ContourOverlap::Ignore,
+                                                  fingerprint );
+                    }
+                }
+            }
+            return nullptr;
+        };
+        const auto img_mask   = get_mask(img);
+        const auto above_mask = above.empty() ? nullptr : get_mask(*(above.front()));
+        const auto below_mask = below.empty() ? nullptr : get_mask(*(below.front()));
+
         //Loop over the pixels of the image.
         {
             work_queue<std::function<void(void)>> wq;
@@ -133,37 +148,22 @@ bool ComputeGenerateSurfaceMask(planar_image_collection<float,double> &imagecoll
                         const auto point = img.position(row,col);
 
                         //Check if there are any ROI's this voxel is inside. 
-                        bool is_in_an_roi = false;
-                        for(auto &ccs : cc_select){
-                            for(auto & contour : ccs.get().contours){
-                                if(contour.points.empty()) continue;
-                                if(! img.encompasses_contour_of_points(contour)) continue;
-
-                                //Prepare a contour for fast is-point-within-the-polygon checking.
-                                auto BestFitPlane = contour.Least_Squares_Best_Fit_Plane(ortho_unit);
-                                auto ProjectedContour = contour.Project_Onto_Plane_Orthogonally(BestFitPlane);
-                                const bool AlreadyProjected = true;
-                
-                                auto ProjectedPoint = BestFitPlane.Project_Onto_Plane_Orthogonally(point);
-                                is_in_an_roi = ProjectedContour.Is_Point_In_Polygon_Projected_Orthogonally(BestFitPlane,
-                                                                                                           ProjectedPoint,
-                                                                                                           AlreadyProjected);
-                                if(is_in_an_roi) break;
-                            }
-                            if(is_in_an_roi) break;
-                        }
+                        const bool is_in_an_roi = (img_mask != nullptr) && img_mask->contains(row, col);
                         img.reference(row, col, 0) =  (is_in_an_roi) ? (user_data_s->interior_val)
                                                                      : (user_data_s->background_val);
 
                         //Create a lambda routine that takes an image and checks in-plane if any neighbours are (!is_in_an_roi).
                         auto check_inclusion = [&](const planar_image<float,double> &limg,
+                                                   const std::shared_ptr<const roi_span_mask> &lmask,
                                                    int64_t boxr ) -> bool {
+                                if(lmask == nullptr) return false;
 
                                 //Project the original image's position onto the plane of this image, so we know where the central
                                 // neighbour point is.
                                 const auto limg_plane = limg.image_plane();
                                 const auto lpoint = limg_plane.Project_Onto_Plane_Orthogonally(point);
                                 const int64_t lindx = limg.index(lpoint, 0);
+                                if(lindx < 0) return false;
                                 const auto rcc = limg.row_column_channel_from_index(lindx);
                                 const auto lrow = std::get<0>(rcc);
                                 const auto lcol = std::get<1>(rcc);
@@ -172,38 +172,20 @@ bool ComputeGenerateSurfaceMask(planar_image_collection<float,double> &imagecoll
                                     for(auto bcol = (lcol-boxr); bcol <= (lcol+boxr); ++bcol){
                                         //Check if the coordinates are legal and in the ROI.
                                         if( !isininc(0,brow,limg.rows-1) || !isininc(0,bcol,limg.columns-1) ) continue;
-                                        const auto bpoint = limg.position(brow, bcol);
-
-                                        for(auto &ccs : cc_select){
-                                            for(auto & contour : ccs.get().contours){
-                                                if(contour.points.empty()) continue;
-                                                if(! limg.encompasses_contour_of_points(contour)) continue;
-
-                                                //Prepare a contour for fast is-point-within-the-polygon checking.
-                                                auto BestFitPlane = contour.Least_Squares_Best_Fit_Plane(ortho_unit);
-                                                auto ProjectedContour = contour.Project_Onto_Plane_Orthogonally(BestFitPlane);
-                                                const bool AlreadyProjected = true;
-                                
-                                                auto ProjectedPoint = BestFitPlane.Project_Onto_Plane_Orthogonally(bpoint);
-                                                const auto bis_in_an_roi = ProjectedContour.Is_Point_In_Polygon_Projected_Orthogonally(BestFitPlane,
-                                                                                                                                       ProjectedPoint,
-                                                                                                                                       AlreadyProjected);
-                                                if(bis_in_an_roi != is_in_an_roi) return true;
-                                            }
-                                        }
+                                        if(lmask->contains(brow, bcol) != is_in_an_roi) return true;
                                     }
                                 }
                                 return false; //No point (!is_in_an_roi) was found.
                         };
 
 
-                        if(check_inclusion(img, 1)){
+                        if(check_inclusion(img, img_mask, 1)){
                             img.reference(row, col, 0) = user_data_s->surface_val;
 
                         //Apply the check to the nearest neighbouring image slices.
-                        }else if( !above.empty() && check_inclusion(*(above.front()), 0) ){
+                        }else if( !above.empty() && check_inclusion(*(above.front()), above_mask, 0) ){
                             img.reference(row, col, 0) = user_data_s->surface_val;
-                        }else if( !below.empty() && check_inclusion(*(below.front()), 0) ){
+                        }else if( !below.empty() && check_inclusion(*(below.front()), below_mask, 0) ){
                             img.reference(row, col, 0) = user_data_s->surface_val;
                         }
                     }
@@ -13,6 +13,7 @@
 #include <cstdint>
 
 #include "../../Thread_Pool.h"
+#include "../../Image_Resampling.h"
 #include "../Grouping/Misc_Functors.h"
 #include "../ConvenienceRoutines.h"
 #include "Interpolate_Image_Slices.h"
@@ -110,6 +111,15 @@ bool ComputeInterpolateImageSlices(planar_image_collection<float,double> &imagec
         return false;
     }
 
+    // If the reference images form a regular grid, in-plane interpolation can be performed a row at a time using a
+    // precomputed affine mapping rather than searching for the neighbouring planes of each voxel. Slices are clamped to
+    // mirror the constant extrapolation beyond the outermost planes.
+    std::optional<resampling_grid> grid;
+    if(!ImagesAreRectilinear && (external_imgs.size() == 1)){
+        grid = Prepare_Resampling_Grid(external_imgs.front().get());
+        if(grid) grid->clamp_slices = true;
+    }
+
 /*
     Mutate_Voxels_Opts mv_opts;
     mv_opts.editstyle      = Mutate_Voxels_Opts::EditStyle::InPlace;
@@ -217,6 +227,9 @@ bool ComputeInterpolateImageSlices(planar_image_collection<float,double> &imagec
 
             // If all images are NOT rectilinear, then in-plane interpolation is needed because the voxel
             // coordinates will differ in general..
+            }else if(grid){
+                Resample_Image(grid.value(), img_refw.get(), ud_channel, std::numeric_limits<float>::quiet_NaN());
+
             }else{
                 for(auto row = 0; row < N_rows; ++row){
                     for(auto col = 0; col < N_columns; ++col){
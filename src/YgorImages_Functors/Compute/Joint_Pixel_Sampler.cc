@@ -12,8 +12,11 @@
 #include <stdexcept>
 #include <mutex>
 #include <cstdint>
+#include <vector>
 
 #include "../../Thread_Pool.h"
+#include "../../Image_Resampling.h"
+#include "../../ROI_Span_Masks.h"
 #include "../Grouping/Misc_Functors.h"
 #include "../ConvenienceRoutines.h"
 #include "Joint_Pixel_Sampler.h"
@@ -102,6 +105,63 @@ bool ComputeJointPixelSampler(planar_image_collection<float,double> &imagecoll,
     mv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
 
 
+    // Reference arrays that form regular grids can be interpolated a row at a time using a precomputed affine mapping,
+    // which avoids image lookups for each voxel. This is only possible if every reference array forms a regular grid.
+    std::vector<resampling_grid> grids;
+    if(user_data_s->sampling_method == ComputeJointPixelSamplerUserData::SamplingMethod::LinearInterpolation){
+        size_t ref_num = 0;
+        for(auto & picrw : external_imgs){
+            const auto grid_index = (ref_num < user_data_s->ref_grid_indices.size())
+                                  ? user_data_s->ref_grid_indices[ref_num] : nullptr;
+            ++ref_num;
+            auto grid = Prepare_Resampling_Grid(picrw.get(), grid_index);
+            if(!grid){
+                YLOGDEBUG("Reference images do not form a regular grid; using per-voxel sampling");
+                grids.clear();
+                break;
+            }
+            grids.emplace_back( std::move(grid.value()) );
+        }
+    }
+
+    // Visit the selected voxels row span by row span, resampling each reference grid along the span.
+    const auto sample_grid_rows = [&](planar_image<float,double> &img) -> void {
+        const auto mask = Get_ROI_Span_Mask(img, ccsl, mv_opts.inclusivity, mv_opts.contouroverlap);
+
+        std::vector<std::vector<float>> sampled( grids.size(), std::vector<float>(img.columns) );
+        std::vector<float> vals;
+        for(const auto &s : mask->spans){
+            const auto N = s.col_end - s.col_begin;
+            for(int64_t chnl = 0; chnl < img.channels; ++chnl){
+                if( (ud_channel >= 0) && (chnl != ud_channel) ) continue;
+
+                for(size_t i = 0; i < grids.size(); ++i){
+                    Resample_Row( grids[i], img, s.row, s.col_begin, s.col_end, chnl,
+                                  user_data_s->inaccessible_val, sampled[i].data() );
+                }
+
+                for(int64_t k = 0; k < N; ++k){
+                    const auto col = s.col_begin + k;
+                    float &voxel_val = img.reference(s.row, col, chnl);
+                    const bool is_nan = std::isnan(voxel_val);
+                    if( !user_data_s->inc_nan && is_nan ) continue;
+                    if( !is_nan
+                    &&  !isininc( user_data_s->inc_lower_threshold, voxel_val, user_data_s->inc_upper_threshold) ) continue;
+
+                    vals.clear();
+                    vals.emplace_back(voxel_val);
+                    for(const auto &row_vals : sampled) vals.emplace_back( row_vals[k] );
+
+                    try{
+                        voxel_val = user_data_s->f_reduce( vals, img.position(s.row, col) );
+                    }catch(const std::exception &){
+                        voxel_val = user_data_s->inaccessible_val;
+                    }
+                }
+            }
+        }
+    };
+
     std::mutex passing_counter; // Used to tally the gamma passing rate.
 
     std::mutex saver_printer; // Who gets to save generated contours, print to the console, and iterate the counter.
@@ -113,156 +173,162 @@ bool ComputeJointPixelSampler(planar_image_collection<float,double> &imagecoll,
         std::reference_wrapper< planar_image<float, double>> img_refw( std::ref(img) );
 
         wq.submit_task([&,img_refw]() -> void {
-            const auto orientation_normal = img_refw.get().image_plane().N_0.unit();
-
-            // Prepare adjacency lists for each external image array.
-            std::list< planar_image_adjacency<float,double> > img_adj_l;
-            for(auto & picrw : external_imgs){
-                decltype(external_imgs) shtl;
-                shtl.emplace_back(picrw);
-                std::list< std::reference_wrapper< planar_image<float,double> > > empty;
-                img_adj_l.emplace_back( empty, shtl, orientation_normal );
-            }
+            if(!grids.empty()){
+                // Regular reference grids are sampled directly, so image adjacency is not needed.
+                sample_grid_rows(img_refw.get());
+
+            }else{
+                const auto orientation_normal = img_refw.get().image_plane().N_0.unit();
+
+                // Prepare adjacency lists for each external image array.
+                std::list< planar_image_adjacency<float,double> > img_adj_l;
+                for(auto & picrw : external_imgs){
+                    decltype(external_imgs) shtl;
+                    shtl.emplace_back(picrw);
+                    std::list< std::reference_wrapper< planar_image<float,double> > > empty;
+                    img_adj_l.emplace_back( empty, shtl, orientation_normal );
+                }
+
+                // Identify the reference images which wholly overlap with the image to edit, if any.
+                //
+                // This arrangement is common in many scenarios and can be exploited to reduce costly checks for each voxel.
+                // If no overlapping image is found, another lookup is performed for each voxel (which is much slower).
+                using img_ptr_t = planar_image<float,double> *;
+                std::list<img_ptr_t> int_img_ptr_l;
+                bool envel_overlap = true; // Images that are enveloped, but may have different spatial characteristics.
+                bool exact_overlap = true; // Images which have same spatial layout, number of rows and columns, etc.
+                for(const auto & img_adj : img_adj_l){
+                    auto overlapping_img_refws = img_adj.get_wholly_overlapping_images(img_refw);
+                    if(!overlapping_img_refws.empty()){
+                        int_img_ptr_l.emplace_back( std::addressof(overlapping_img_refws.front().get()) );
+
+                        if( (img_refw.get().rows == overlapping_img_refws.front().get().rows)
+                        &&  (img_refw.get().columns == overlapping_img_refws.front().get().columns)
+                        //&&  (img_refw.get().channels == overlapping_img_refws.front().get().channels)
+                        &&  (0.99 < img_refw.get().row_unit.Dot(overlapping_img_refws.front().get().row_unit))
+                        &&  (0.99 < img_refw.get().col_unit.Dot(overlapping_img_refws.front().get().col_unit)) ){
+                            // exact_overlap *= 1.0;
+                        }else{
+                            exact_overlap = false;
+                        }
 
-            // Identify the reference images which wholly overlap with the image to edit, if any.
-            //
-            // This arrangement is common in many scenarios and can be exploited to reduce costly checks for each voxel.
-            // If no overlapping image is found, another lookup is performed for each voxel (which is much slower).
-            using img_ptr_t = planar_image<float,double> *;
-            std::list<img_ptr_t> int_img_ptr_l;
-            bool envel_overlap = true; // Images that are enveloped, but may have different spatial characteristics.
-            bool exact_overlap = true; // Images which have same spatial layout, number of rows and columns, etc.
-            for(const auto & img_adj : img_adj_l){
-                auto overlapping_img_refws = img_adj.get_wholly_overlapping_images(img_refw);
-                if(!overlapping_img_refws.empty()){
-                    int_img_ptr_l.emplace_back( std::addressof(overlapping_img_refws.front().get()) );
-
-                    if( (img_refw.get().rows == overlapping_img_refws.front().get().rows)
-                    &&  (img_refw.get().columns == overlapping_img_refws.front().get().columns)
-                    //&&  (img_refw.get().channels == overlapping_img_refws.front().get().channels)
-                    &&  (0.99 < img_refw.get().row_unit.Dot(overlapping_img_refws.front().get().row_unit))
-                    &&  (0.99 < img_refw.get().col_unit.Dot(overlapping_img_refws.front().get().col_unit)) ){
-                        // exact_overlap *= 1.0;
                     }else{
+                        int_img_ptr_l.emplace_back( nullptr );
+                        envel_overlap = false;
                         exact_overlap = false;
                     }
-
-                }else{
-                    int_img_ptr_l.emplace_back( nullptr );
-                    envel_overlap = false;
-                    exact_overlap = false;
                 }
-            }
-            if(!envel_overlap){
-                std::lock_guard<std::mutex> lock(saver_printer);
-                YLOGDEBUG("Reference images do not all envelop-overlap; using slow per-voxel sampling");
-            }
-            if(envel_overlap && !exact_overlap){
-                std::lock_guard<std::mutex> lock(saver_printer);
-                YLOGDEBUG("Reference images do not all exact-overlap; using per-image sampling");
-            }
-
-            auto f_bounded = [&](int64_t E_row,  // "edit-image" row.
-                                 int64_t E_col,  // "edit-image" column.
-                                 int64_t channel, 
-                                 std::reference_wrapper<planar_image<float,double>> img_refw, 
-                                 std::reference_wrapper<planar_image<float,double>>, 
-                                 float &voxel_val) {
-                const bool is_nan = std::isnan(voxel_val);
-                if( !user_data_s->inc_nan && is_nan ){
-                    return; // No-op since NaN encountered when not allowing them.
-                }
-                if( !is_nan
-                &&  !isininc( user_data_s->inc_lower_threshold, voxel_val, user_data_s->inc_upper_threshold) ){
-                    return; // No-op if outside of the thresholds.
+                if(!envel_overlap){
+                    std::lock_guard<std::mutex> lock(saver_printer);
+                    YLOGDEBUG("Reference images do not all envelop-overlap; using slow per-voxel sampling");
                 }
-                if( (ud_channel >= 0) && (channel != ud_channel) ){
-                    return; // No-op if this is the wrong channel.
+                if(envel_overlap && !exact_overlap){
+                    std::lock_guard<std::mutex> lock(saver_printer);
+                    YLOGDEBUG("Reference images do not all exact-overlap; using per-image sampling");
                 }
 
-                // Tabulate all reference images sampled in order.
-                std::vector<float> vals;
-                vals.emplace_back(voxel_val);
+                auto f_bounded = [&](int64_t E_row,  // "edit-image" row.
+                                     int64_t E_col,  // "edit-image" column.
+                                     int64_t channel, 
+                                     std::reference_wrapper<planar_image<float,double>> img_refw, 
+                                     std::reference_wrapper<planar_image<float,double>>, 
+                                     float &voxel_val) {
+                    const bool is_nan = std::isnan(voxel_val);
+                    if( !user_data_s->inc_nan && is_nan ){
+                        return; // No-op since NaN encountered when not allowing them.
+                    }
+                    if( !is_nan
+                    &&  !isininc( user_data_s->inc_lower_threshold, voxel_val, user_data_s->inc_upper_threshold) ){
+                        return; // No-op if outside of the thresholds.
+                    }
+                    if( (ud_channel >= 0) && (channel != ud_channel) ){
+                        return; // No-op if this is the wrong channel.
+                    }
 
-                // Default the output to an invalid voxel value.
-                voxel_val = user_data_s->inaccessible_val;
+                    // Tabulate all reference images sampled in order.
+                    std::vector<float> vals;
+                    vals.emplace_back(voxel_val);
 
-                // Get the position of the voxel in the image to edit.
-                const auto pos = img_refw.get().position(E_row, E_col);
+                    // Default the output to an invalid voxel value.
+                    voxel_val = user_data_s->inaccessible_val;
 
-                // Sample each external image volume.
-                const size_t N_ext_img_arrs = int_img_ptr_l.size();
-                for(size_t i = 0; i < N_ext_img_arrs; ++i){                               // TODO: replace this dual iteration with iteration over a list of a class that combines both items (paired).
-                    auto int_img_it = std::next( std::begin(int_img_ptr_l), i );
-                    auto img_adj_it = std::next( std::begin(img_adj_l), i );
+                    // Get the position of the voxel in the image to edit.
+                    const auto pos = img_refw.get().position(E_row, E_col);
 
-                    // Sample the image.
-                    if(exact_overlap){
-                        if((*(int_img_it))->channels <= channel){
-                            vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
-                            continue;
-                        }
+                    // Sample each external image volume.
+                    const size_t N_ext_img_arrs = int_img_ptr_l.size();
+                    for(size_t i = 0; i < N_ext_img_arrs; ++i){                               // TODO: replace this dual iteration with iteration over a list of a class that combines both items (paired).
+                        auto int_img_it = std::next( std::begin(int_img_ptr_l), i );
+                        auto img_adj_it = std::next( std::begin(img_adj_l), i );
 
-                        try{
-                            vals.emplace_back( (*(int_img_it))->value(E_row, E_col, channel) );
-                        }catch(const std::exception &){
-                            vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
-                            continue;
-                        }
+                        // Sample the image.
+                        if(exact_overlap){
+                            if((*(int_img_it))->channels <= channel){
+                                vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
+                                continue;
+                            }
 
-                    }else if(user_data_s->sampling_method == ComputeJointPixelSamplerUserData::SamplingMethod::NearestVoxel){
-                        // If no wholly overlapping image was previously identified, perform a lookup for this specific voxel.
-                        // 
-                        // Note: this is a costly pathway, but is necessary if images are disaligned.
-                        img_ptr_t l_int_img_ptr = *(int_img_it); // De-reference the iterator to get the pointer..
-                        if(l_int_img_ptr == nullptr){
                             try{
-                                l_int_img_ptr = std::addressof( img_adj_it->position_to_image(pos).get() );
+                                vals.emplace_back( (*(int_img_it))->value(E_row, E_col, channel) );
                             }catch(const std::exception &){
                                 vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
                                 continue;
                             }
-                        }
 
-                        // Ensure the image supports the specified channel.
-                        if(l_int_img_ptr->channels <= channel){
-                            vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
-                            continue;
-                        }
+                        }else if(user_data_s->sampling_method == ComputeJointPixelSamplerUserData::SamplingMethod::NearestVoxel){
+                            // If no wholly overlapping image was previously identified, perform a lookup for this specific voxel.
+                            // 
+                            // Note: this is a costly pathway, but is necessary if images are disaligned.
+                            img_ptr_t l_int_img_ptr = *(int_img_it); // De-reference the iterator to get the pointer..
+                            if(l_int_img_ptr == nullptr){
+                                try{
+                                    l_int_img_ptr = std::addressof( img_adj_it->position_to_image(pos).get() );
+                                }catch(const std::exception &){
+                                    vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
+                                    continue;
+                                }
+                            }
 
-                        // Calculate the index in the intersecting image.
-                        const auto index = l_int_img_ptr->index(pos, channel);
-                        if(index < 0){ // If not valid, ignore the voxel.
-                            vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
-                            continue;
-                        }
+                            // Ensure the image supports the specified channel.
+                            if(l_int_img_ptr->channels <= channel){
+                                vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
+                                continue;
+                            }
 
-                        const auto sampled_val = l_int_img_ptr->value(index);
-                        vals.emplace_back( sampled_val );
+                            // Calculate the index in the intersecting image.
+                            const auto index = l_int_img_ptr->index(pos, channel);
+                            if(index < 0){ // If not valid, ignore the voxel.
+                                vals.emplace_back(user_data_s->inaccessible_val); // Cannot access this voxel.
+                                continue;
+                            }
 
-                    }else if(user_data_s->sampling_method == ComputeJointPixelSamplerUserData::SamplingMethod::LinearInterpolation){
-                        const auto sampled_val = img_adj_it->trilinearly_interpolate(pos, channel, user_data_s->inaccessible_val);
-                        vals.emplace_back( sampled_val );
+                            const auto sampled_val = l_int_img_ptr->value(index);
+                            vals.emplace_back( sampled_val );
 
-                    }else{
-                        throw std::runtime_error("Sampling method not understood. Cannot continue.");
+                        }else if(user_data_s->sampling_method == ComputeJointPixelSamplerUserData::SamplingMethod::LinearInterpolation){
+                            const auto sampled_val = img_adj_it->trilinearly_interpolate(pos, channel, user_data_s->inaccessible_val);
+                            vals.emplace_back( sampled_val );
+
+                        }else{
+                            throw std::runtime_error("Sampling method not understood. Cannot continue.");
+                        }
                     }
-                }
 
-                // Apply the user's functor.
-                try{
-                    voxel_val = user_data_s->f_reduce( vals, pos );
-                }catch(const std::exception &){ 
-                    voxel_val = user_data_s->inaccessible_val;
-                }
-                return;
-            };
-
-            Mutate_Voxels<float,double>( img_refw,
-                                         { img_refw },
-                                         ccsl, 
-                                         mv_opts, 
-                                         f_bounded );
+                    // Apply the user's functor.
+                    try{
+                        voxel_val = user_data_s->f_reduce( vals, pos );
+                    }catch(const std::exception &){ 
+                        voxel_val = user_data_s->inaccessible_val;
+                    }
+                    return;
+                };
+
+                Mutate_Voxels<float,double>( img_refw,
+                                             { img_refw },
+                                             ccsl, 
+                                             mv_opts, 
+                                             f_bounded );
+            }
 
             UpdateImageDescription( img_refw, user_data_s->description );
             UpdateImageWindowCentreWidth( img_refw );
@@ -5,6 +5,7 @@
 #include <functional>
 #include <limits>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -12,6 +13,7 @@
 #include "YgorMath.h"
 
 template <class T, class R> class planar_image_collection;
+template <class T, class R> struct voxel_grid_index;
 template <class T> class contour_collection;
 
 struct ComputeJointPixelSamplerUserData {
@@ -62,6 +64,14 @@ struct ComputeJointPixelSamplerUserData {
                                  // location of the image to edit's voxel centre.
     } sampling_method = SamplingMethod::LinearInterpolation;
 
+    // -----------------------------
+    // Indices of the reference images, e.g., from Image_Array::get_voxel_grid_index(), in the same order as the
+    // reference image collections.
+    //
+    // Note: Optional. Indices only help linear interpolation, and missing or stale entries are rebuilt from the
+    //       corresponding reference images.
+    std::vector<std::shared_ptr<const voxel_grid_index<float,double>>> ref_grid_indices;
+
     // -----------------------------
     // Outgoing image description to imbue.
     std::string description;
@@ -13,6 +13,7 @@
 #include <cstdint>
 
 #include "../../Thread_Pool.h"
+#include "../../Voxel_Volume.h"
 #include "../Grouping/Misc_Functors.h"
 #include "../ConvenienceRoutines.h"
 #include "Volumetric_Neighbourhood_Sampler.h"
@@ -79,6 +80,18 @@ bool ComputeVolumetricNeighbourhoodSampler(planar_image_collection<float,double>
     }
     const bool is_regular_grid = Images_Form_Regular_Grid(selected_imgs);
 
+    // Cubic neighbourhoods on a regular grid are sampled from contiguous storage, which avoids per-voxel image lookups.
+    std::optional<voxel_grid_index<float,double>> ref_grid;
+    voxel_volume<float> ref_vol;
+    if( is_regular_grid
+    &&  (user_data_s->neighbourhood == ComputeVolumetricNeighbourhoodSamplerUserData::Neighbourhood::Cubic) ){
+        // The reference images are a copy of the images to edit, so an index of the latter can be reused.
+        if(const auto grid_ptr = Current_Voxel_Grid_Index(user_data_s->grid_index, imagecoll)){
+            ref_grid = grid_ptr->rebind(imagecoll, ref_imagecoll);
+        }
+        if(ref_grid) ref_vol = Marshal_To_Voxel_Volume<float>(ref_grid.value());
+    }
+
     const auto orientation_normal = Average_Contour_Normals(ccsl);
     planar_image_adjacency<float,double> img_adj( {}, { { std::ref(ref_imagecoll) } }, orientation_normal );
 
@@ -111,6 +124,9 @@ bool ComputeVolumetricNeighbourhoodSampler(planar_image_collection<float,double>
             }
             auto ref_img_refw = overlapping_img_refws.front();
 
+            std::optional<std::pair<int64_t, int64_t>> R_frame_slice;
+            if(ref_grid) R_frame_slice = ref_grid->locate( &(ref_img_refw.get()) );
+
             const auto pxl_dx = ref_img_refw.get().pxl_dx;
             const auto pxl_dy = ref_img_refw.get().pxl_dy;
             const auto pxl_dz = ref_img_refw.get().pxl_dz;
@@ -231,17 +247,35 @@ bool ComputeVolumetricNeighbourhoodSampler(planar_image_collection<float,double>
                     const int64_t l_col_min = std::max<int64_t>( R_col - dy_u, 0L );
                     const int64_t l_col_max = std::min<int64_t>( R_col + dy_u, ref_img_refw.get().columns - 1L );
 
-                    const int64_t l_img_min = (R_num - dz_u);
-                    const int64_t l_img_max = (R_num + dz_u);
+                    if(R_frame_slice){
+                        const auto R_frame = R_frame_slice->first;
+                        const auto R_slice = R_frame_slice->second;
+                        const int64_t l_slice_min = std::max<int64_t>( R_slice - dz_u, 0L );
+                        const int64_t l_slice_max = std::min<int64_t>( R_slice + dz_u, ref_vol.slices - 1L );
+                        const auto col_stride = ref_vol.col_stride();
+
+                        for(int64_t l_slice = l_slice_min; l_slice <= l_slice_max; ++l_slice){
+                            for(int64_t l_row = l_row_min; l_row <= l_row_max; ++l_row){
+                                const float *p = ref_vol.data.data() + ref_vol.index(R_frame, l_slice, l_row, l_col_min, channel);
+                                for(int64_t l_col = l_col_min; l_col <= l_col_max; ++l_col, p += col_stride){
+                                    shtl.emplace_back( *p );
+                                }
+                            }
+                        }
+
+                    }else{
+                        const int64_t l_img_min = (R_num - dz_u);
+                        const int64_t l_img_max = (R_num + dz_u);
 
-                    for(int64_t l_img = l_img_min; l_img <= l_img_max; ++l_img){
-                        if(!img_adj.index_present(l_img)) continue; // This adjacent image does not exist.
-                        auto adj_img_refw = img_adj.index_to_image(l_img);
+                        for(int64_t l_img = l_img_min; l_img <= l_img_max; ++l_img){
+                            if(!img_adj.index_present(l_img)) continue; // This adjacent image does not exist.
+                            auto adj_img_refw = img_adj.index_to_image(l_img);
 
-                        for(int64_t l_row = l_row_min; l_row <= l_row_max; ++l_row){
-                            for(int64_t l_col = l_col_min; l_col <= l_col_max; ++l_col){
-                                const auto adj_vox_val = adj_img_refw.get().value(l_row, l_col, channel);
-                                shtl.emplace_back( adj_vox_val ) ;
+                            for(int64_t l_row = l_row_min; l_row <= l_row_max; ++l_row){
+                                for(int64_t l_col = l_col_min; l_col <= l_col_max; ++l_col){
+                                    const auto adj_vox_val = adj_img_refw.get().value(l_row, l_col, channel);
+                                    shtl.emplace_back( adj_vox_val ) ;
+                                }
                             }
                         }
                     }
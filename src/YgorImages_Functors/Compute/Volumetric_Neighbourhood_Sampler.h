@@ -7,6 +7,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -17,6 +18,7 @@
 #include "YgorLog.h"
 
 template <class T, class R> class planar_image_collection;
+template <class T, class R> struct voxel_grid_index;
 template <class T> class contour_collection;
 
 struct ComputeVolumetricNeighbourhoodSamplerUserData {
@@ -67,6 +69,13 @@ struct ComputeVolumetricNeighbourhoodSamplerUserData {
         return v; // Effectively does nothing.
     };
 
+    // -----------------------------
+    // An index of the images to edit, e.g., from Image_Array::get_voxel_grid_index().
+    //
+    // Note: Optional. It is only consulted for cubic neighbourhoods, where it is rebound to the copy of the images
+    //       that neighbourhoods are read from. A stale index is rebuilt from the images.
+    std::shared_ptr<const voxel_grid_index<float,double>> grid_index;
+
     // -----------------------------
     // Outgoing image description to imbue.
     std::string description;
@@ -0,0 +1,411 @@
+//Volumetric_Rank_Filter.cc.
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../../Thread_Pool.h"
+#include "../../Voxel_Volume.h"
+#include "../Grouping/Misc_Functors.h"
+#include "../ConvenienceRoutines.h"
+#include "Volumetric_Rank_Filter.h"
+#include "YgorImages.h"
+#include "YgorMath.h"
+#include "YgorMisc.h"
+#include "YgorLog.h"
+
+
+namespace {
+
+// A contiguous run of neighbourhood voxels along the column axis.
+struct neighbourhood_run_t {
+    int64_t d_slice;
+    int64_t d_row;
+    int64_t d_col_lo;
+    int64_t d_col_hi;
+};
+
+// A Fenwick (binary indexed) tree of counts over value ranks, supporting insertion, removal, and order-statistic
+// queries in logarithmic time.
+class rank_histogram {
+    private:
+        std::vector<int32_t> tree;
+        int64_t top_bit = 0;
+        int64_t total = 0;
+
+    public:
+        explicit rank_histogram(int64_t n_ranks) : tree(static_cast<size_t>(n_ranks + 1), 0) {
+            top_bit = 1;
+            while((top_bit * 2) <= n_ranks) top_bit *= 2;
+        }
+
+        void add(int64_t rank, int32_t delta){
+            this->total += delta;
+            const auto N = static_cast<int64_t>(this->tree.size());
+            for(int64_t i = rank + 1; i < N; i += (i & -i)) this->tree[i] += delta;
+        }
+
+        int64_t count() const {
+            return this->total;
+        }
+
+        // The number of entries with a rank lower than the given rank.
+        int64_t count_below(int64_t rank) const {
+            int64_t out = 0;
+            for(int64_t i = rank; 0 < i; i -= (i & -i)) out += this->tree[i];
+            return out;
+        }
+
+        // The rank of the k-th smallest entry (zero-based). The histogram must contain more than k entries.
+        int64_t kth(int64_t k) const {
+            const auto N = static_cast<int64_t>(this->tree.size());
+            int64_t pos = 0;
+            for(int64_t step = this->top_bit; 0 < step; step /= 2){
+                if( ((pos + step) < N) && (this->tree[pos + step] <= k) ){
+                    pos += step;
+                    k -= this->tree[pos];
+                }
+            }
+            return pos;
+        }
+};
+
+// Express the neighbourhood as runs of (slice, row, column) offsets.
+std::vector<neighbourhood_run_t>
+Neighbourhood_Runs( const ComputeVolumetricRankFilterUserData &ud,
+                    const voxel_grid_index<float,double> &grid,
+                    const vec3<double> &orientation_normal ){
+    using nbh_t = ComputeVolumetricRankFilterUserData::Neighbourhood;
+    std::set<std::array<int64_t, 3>> offsets;
+
+    if(ud.neighbourhood == nbh_t::Spherical){
+        const auto machine_eps = std::sqrt(std::numeric_limits<double>::epsilon());
+        const auto extent = [&](const vec3<double> &step){
+            const auto l = step.length();
+            return (l <= 0.0) ? int64_t(0) : static_cast<int64_t>(std::floor(ud.maximum_distance / l + machine_eps));
+        };
+        const auto ds = extent(grid.slice_step);
+        const auto dr = extent(grid.row_step);
+        const auto dc = extent(grid.col_step);
+        for(int64_t i = -ds; i <= ds; ++i){
+            for(int64_t j = -dr; j <= dr; ++j){
+                for(int64_t k = -dc; k <= dc; ++k){
+                    const auto dist = ( grid.slice_step * static_cast<double>(i)
+                                      + grid.row_step * static_cast<double>(j)
+                                      + grid.col_step * static_cast<double>(k) ).length();
+                    if(dist <= ud.maximum_distance) offsets.insert({i, j, k});
+                }
+            }
+        }
+
+    }else if(ud.neighbourhood == nbh_t::Cubic){
+        // Note: The neighbouring voxel CENTRE must be within the maximum distance.
+        const auto &img = grid.image(0, 0);
+        const auto dr = static_cast<int64_t>( std::floor( ud.maximum_distance / img.pxl_dx ) );
+        const auto dc = static_cast<int64_t>( std::floor( ud.maximum_distance / img.pxl_dy ) );
+        const auto ds = static_cast<int64_t>( std::floor( ud.maximum_distance / img.pxl_dz ) );
+        for(int64_t i = -ds; i <= ds; ++i){
+            for(int64_t j = -dr; j <= dr; ++j){
+                for(int64_t k = -dc; k <= dc; ++k){
+                    offsets.insert({i, j, k});
+                }
+            }
+        }
+
+    }else if(ud.neighbourhood == nbh_t::Selection){
+        // Image offsets are relative to the order of images along the contour normal, which might oppose the grid.
+        const int64_t sign = (grid.image(0, 0).ortho_unit().Dot(orientation_normal) < 0.0) ? -1 : 1;
+        for(const auto &t : ud.voxel_triplets){
+            offsets.insert({t[2] * sign, t[0], t[1]});
+        }
+
+    }else{
+        throw std::logic_error("Neighbourhood argument not understood.");
+    }
+
+    // Merge adjacent column offsets into runs. The set is ordered by slice, then row, then column.
+    std::vector<neighbourhood_run_t> runs;
+    for(const auto &o : offsets){
+        if( !runs.empty()
+        &&  (runs.back().d_slice == o[0])
+        &&  (runs.back().d_row == o[1])
+        &&  (runs.back().d_col_hi + 1 == o[2]) ){
+            runs.back().d_col_hi = o[2];
+        }else{
+            runs.push_back({o[0], o[1], o[2], o[2]});
+        }
+    }
+    return runs;
+}
+
+} // namespace
+
+
+bool Volumetric_Rank_Filter_Supported(planar_image_collection<float,double> &imagecoll,
+                                      const std::shared_ptr<const voxel_grid_index<float,double>> &grid_index){
+    const auto grid = Current_Voxel_Grid_Index(grid_index, imagecoll);
+    return grid && (grid->frames == 1);
+}
+
+
+bool ComputeVolumetricRankFilter(planar_image_collection<float,double> &imagecoll,
+                      std::list<std::reference_wrapper<planar_image_collection<float,double>>> /*external_imgs*/,
+                      std::list<std::reference_wrapper<contour_collection<double>>> ccsl,
+                      std::any user_data ){
+
+    // This routine computes order statistics of each voxel's neighbourhood. A rank histogram is maintained as the
+    // neighbourhood slides along each row: for each run of the neighbourhood, the voxel leaving the run is removed and
+    // the voxel entering the run is added. Voxel values are replaced by their rank within a slab of nearby images so
+    // the histogram is exact and its size is bounded.
+    //
+    // Note: Because walking all voxels in 3D will inevitably be costly, contours are used to limit the computation.
+    //
+
+    //We require a valid ComputeVolumetricRankFilterUserData struct packed into the user_data.
+    ComputeVolumetricRankFilterUserData *user_data_s;
+    try{
+        user_data_s = std::any_cast<ComputeVolumetricRankFilterUserData *>(user_data);
+    }catch(const std::exception &e){
+        YLOGWARN("Unable to cast user_data to appropriate format. Cannot continue with computation");
+        return false;
+    }
+
+    if( ccsl.empty() ){
+        YLOGWARN("Missing needed contour information. Cannot continue with computation");
+        return false;
+    }
+
+    const auto grid_ptr = Current_Voxel_Grid_Index(user_data_s->grid_index, imagecoll);
+    if( !grid_ptr
+    ||  (grid_ptr->frames != 1) ){
+        YLOGWARN("Images do not form a regular grid. Cannot continue");
+        return false;
+    }
+    const auto &grid = *grid_ptr;
+    const int64_t S = grid.slices;
+    const int64_t R = grid.rows;
+    const int64_t C = grid.cols;
+
+    const auto orientation_normal = Average_Contour_Normals(ccsl);
+    const auto runs = Neighbourhood_Runs(*user_data_s, grid, orientation_normal);
+    if(runs.empty()){
+        throw std::invalid_argument("Neighbourhood contains no voxels. Cannot continue.");
+    }
+    int64_t d_slice_max = 0;
+    for(const auto &run : runs) d_slice_max = std::max<int64_t>(d_slice_max, std::abs(run.d_slice));
+
+    std::vector<int64_t> channels;
+    if(user_data_s->channel < 0){
+        for(int64_t ch = 0; ch < grid.channels; ++ch) channels.push_back(ch);
+    }else if(user_data_s->channel < grid.channels){
+        channels.push_back(user_data_s->channel);
+    }
+
+    Mutate_Voxels_Opts mv_opts;
+    mv_opts.editstyle      = Mutate_Voxels_Opts::EditStyle::InPlace;
+    mv_opts.inclusivity    = Mutate_Voxels_Opts::Inclusivity::Centre;
+    mv_opts.contouroverlap = Mutate_Voxels_Opts::ContourOverlap::Ignore;
+    mv_opts.aggregate      = Mutate_Voxels_Opts::Aggregate::First;
+    mv_opts.adjacency      = Mutate_Voxels_Opts::Adjacency::SingleVoxel;
+    mv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
+
+    // Identify the voxels that will be modified.
+    std::vector<uint8_t> mask(static_cast<size_t>(S * R * C), 0);
+    {
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t z = 0; z < S; ++z){
+            wq.submit_task([&,z]() -> void {
+                auto img_refw = std::ref(grid.image(0, z));
+                auto f_bounded = [&](int64_t E_row, int64_t E_col, int64_t /*channel*/,
+                                     std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
+                                     std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
+                                     float &/*voxel_val*/) {
+                    mask[(z * R + E_row) * C + E_col] = 1;
+                    return;
+                };
+                Mutate_Voxels<float,double>( img_refw, { img_refw }, ccsl, mv_opts, f_bounded );
+            });
+        }
+    } // Wait for all tasks to complete.
+
+    using red_t = ComputeVolumetricRankFilterUserData::Reduction;
+    const auto reduction = user_data_s->reduction;
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto machine_eps = std::sqrt( std::numeric_limits<float>::epsilon() );
+
+    std::map<int64_t, std::vector<float>> results;
+    for(const auto ch : channels){
+        // Pristine copy of the voxel values.
+        std::vector<float> vol(static_cast<size_t>(S * R * C));
+        for(int64_t z = 0; z < S; ++z){
+            const auto &img = grid.image(0, z);
+            for(int64_t r = 0; r < R; ++r){
+                for(int64_t c = 0; c < C; ++c){
+                    vol[(z * R + r) * C + c] = img.value(r, c, ch);
+                }
+            }
+        }
+        auto &res = results[ch];
+        res.assign(vol.size(), nan);
+
+        work_queue<std::function<void(void)>> wq;
+        for(int64_t z = 0; z < S; ++z){
+            const auto z_beg = mask.begin() + z * R * C;
+            if(std::find(z_beg, z_beg + R * C, 1) == (z_beg + R * C)) continue;
+
+            wq.submit_task([&,z]() -> void {
+                // Rank the values within the slab of images the neighbourhood can reach.
+                const int64_t z_lo = std::max<int64_t>(0, z - d_slice_max);
+                const int64_t z_hi = std::min<int64_t>(S - 1, z + d_slice_max);
+                const auto slab_beg = vol.begin() + z_lo * R * C;
+                const auto slab_end = vol.begin() + (z_hi + 1) * R * C;
+
+                std::vector<float> uniq;
+                uniq.reserve(static_cast<size_t>(std::distance(slab_beg, slab_end)));
+                std::copy_if(slab_beg, slab_end, std::back_inserter(uniq), [](float v){ return !std::isnan(v); });
+                std::sort(std::begin(uniq), std::end(uniq));
+                uniq.erase( std::unique(std::begin(uniq), std::end(uniq)), std::end(uniq) );
+
+                std::vector<int32_t> ranks(static_cast<size_t>(std::distance(slab_beg, slab_end)), -1);
+                std::transform(slab_beg, slab_end, std::begin(ranks), [&](float v) -> int32_t {
+                    if(std::isnan(v)) return -1;
+                    return static_cast<int32_t>(std::distance(std::begin(uniq),
+                                                std::lower_bound(std::begin(uniq), std::end(uniq), v)));
+                });
+                const auto rank_at = [&](int64_t l_z, int64_t l_r, int64_t l_c) -> int32_t {
+                    return ranks[((l_z - z_lo) * R + l_r) * C + l_c];
+                };
+
+                rank_histogram hist(static_cast<int64_t>(uniq.size()));
+                const auto update_run = [&](const neighbourhood_run_t &run, int64_t r, int64_t c_lo, int64_t c_hi, int32_t delta){
+                    const auto l_z = z + run.d_slice;
+                    const auto l_r = r + run.d_row;
+                    if( (l_z < 0) || (S <= l_z) || (l_r < 0) || (R <= l_r) ) return;
+                    for(int64_t l_c = std::max<int64_t>(0, c_lo); l_c <= std::min<int64_t>(C - 1, c_hi); ++l_c){
+                        const auto rank = rank_at(l_z, l_r, l_c);
+                        if(0 <= rank) hist.add(rank, delta);
+                    }
+                };
+
+                for(int64_t r = 0; r < R; ++r){
+                    const auto row_beg = mask.begin() + (z * R + r) * C;
+                    const auto first = std::find(row_beg, row_beg + C, 1);
+                    if(first == (row_beg + C)) continue;
+                    const auto c_first = static_cast<int64_t>(std::distance(row_beg, first));
+                    int64_t c_last = C - 1;
+                    while(row_beg[c_last] == 0) --c_last;
+
+                    for(const auto &run : runs){
+                        update_run(run, r, c_first + run.d_col_lo, c_first + run.d_col_hi, 1);
+                    }
+                    for(int64_t c = c_first; c <= c_last; ++c){
+                        if(c != c_first){
+                            for(const auto &run : runs){
+                                update_run(run, r, c - 1 + run.d_col_lo, c - 1 + run.d_col_lo, -1);
+                                update_run(run, r, c + run.d_col_hi, c + run.d_col_hi, 1);
+                            }
+                        }
+                        if(row_beg[c] == 0) continue;
+
+                        const auto n = hist.count();
+                        const auto v = vol[(z * R + r) * C + c];
+                        const auto kth = [&](int64_t k){ return uniq[hist.kth(k)]; };
+                        const auto min = (0 < n) ? kth(0) : nan;
+                        const auto max = (0 < n) ? kth(n - 1) : nan;
+
+                        float out = nan;
+                        if(reduction == red_t::Min){
+                            out = min;
+                        }else if(reduction == red_t::Max){
+                            out = max;
+                        }else if(reduction == red_t::Median){
+                            if(0 < n){
+                                out = ((n % 2) == 1) ? kth(n / 2)
+                                                     : (kth(n / 2 - 1) + kth(n / 2)) / 2.0f;
+                            }
+                        }else if(reduction == red_t::Percentile01){
+                            // Duplicate values use the middle position.
+                            out = v;
+                            if(!std::isnan(v)){
+                                out = nan;
+                                const auto rank = rank_at(z, r, c);
+                                const auto N_lhs = hist.count_below(rank);
+                                const auto N_le = hist.count_below(rank + 1);
+                                if( (0 < n) && (N_lhs != N_le) ){
+                                    const auto N_rhs = N_le - 1;
+                                    out = 0.5 * static_cast<float>(N_rhs + N_lhs) / (static_cast<float>(n) - 1.0);
+                                }
+                            }
+                        }else if(reduction == red_t::IsMin){
+                            out = (std::abs(v - min) < machine_eps) ? 1.0f : 0.0f;
+                        }else if(reduction == red_t::IsMax){
+                            out = (std::abs(v - max) < machine_eps) ? 1.0f : 0.0f;
+                        }else if(reduction == red_t::IsMinNaN){
+                            out = (std::abs(v - min) < machine_eps) ? nan : v;
+                        }else if(reduction == red_t::IsMaxNaN){
+                            out = (std::abs(v - max) < machine_eps) ? nan : v;
+                        }else{
+                            throw std::logic_error("Reduction not understood.");
+                        }
+                        res[(z * R + r) * C + c] = out;
+                    }
+
+                    // Empty the histogram for the next row.
+                    for(const auto &run : runs){
+                        update_run(run, r, c_last + run.d_col_lo, c_last + run.d_col_hi, -1);
+                    }
+                }
+            });
+        } // Wait for all tasks to complete.
+    }
+
+    // Write the results.
+    std::mutex saver_printer;
+    int64_t completed = 0;
+    work_queue<std::function<void(void)>> wq;
+    for(int64_t z = 0; z < S; ++z){
+        wq.submit_task([&,z]() -> void {
+            auto img_refw = std::ref(grid.image(0, z));
+            auto f_bounded = [&](int64_t E_row, int64_t E_col, int64_t channel,
+                                 std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
+                                 std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
+                                 float &voxel_val) {
+                const auto it = results.find(channel);
+                if(it == std::end(results)) return;
+                voxel_val = it->second[(z * R + E_row) * C + E_col];
+                return;
+            };
+            Mutate_Voxels<float,double>( img_refw, { img_refw }, ccsl, mv_opts, f_bounded );
+
+            if(!(user_data_s->description.empty())){
+                UpdateImageDescription( img_refw, user_data_s->description );
+            }
+            UpdateImageWindowCentreWidth( img_refw );
+
+            //Report operation progress.
+            {
+                std::lock_guard<std::mutex> lock(saver_printer);
+                ++completed;
+                YLOGINFO("Completed " << completed << " of " << S
+                      << " --> " << static_cast<int>(1000.0*(completed)/S)/10.0 << "% done");
+            }
+        });
+    }
+
+    return true;
+}
+
@@ -0,0 +1,84 @@
+//Volumetric_Rank_Filter.h.
+#pragma once
+
+#include <any>
+#include <array>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "YgorImages.h"
+#include "YgorMath.h"
+
+template <class T, class R> class planar_image_collection;
+template <class T, class R> struct voxel_grid_index;
+template <class T> class contour_collection;
+
+// Order-statistic (rank) filters over a voxel neighbourhood, such as median, min, and max filters.
+//
+// This functor produces the same result as ComputeVolumetricNeighbourhoodSampler with an order-statistic reduction, but
+// updates a running rank histogram incrementally as the neighbourhood slides along each row instead of collecting and
+// sorting every neighbourhood. Per-voxel cost grows with the neighbourhood's cross-section rather than its volume.
+//
+// Note: The image collection must form a regular grid. See Volumetric_Rank_Filter_Supported().
+//
+// Note: NaN voxels, and voxels outside the image collection, are omitted from the neighbourhood.
+struct ComputeVolumetricRankFilterUserData {
+
+    // The type of neighbourhood to use. These mirror the neighbourhoods of ComputeVolumetricNeighbourhoodSampler.
+    enum class
+    Neighbourhood {
+        Spherical, // Spherically-bound neighbourhood.
+        Cubic,     // Cubically-bound neighbourhood.
+        Selection, // Specific-voxel sampling via list of integer triplets.
+    } neighbourhood = Neighbourhood::Spherical;
+
+    // The maximum distance (in DICOM units; mm) from the voxel centre to neighbouring voxel centres.
+    //
+    // Note: Applicable only for spherical and cubic neighbourhoods.
+    double maximum_distance = 3.0;
+
+    // Voxels relative to the current voxel (in integer voxel coordinates), ordered like: (row, column, image).
+    //
+    // Note: Applicable only for specific-voxel sampling.
+    std::vector<std::array<int64_t, 3>> voxel_triplets;
+
+    // The reduction to apply.
+    enum class
+    Reduction {
+        Min,
+        Max,
+        Median,
+        Percentile01, // The percentile the voxel occupies within its neighbourhood, scaled to [0,1].
+        IsMin,        // 1.0 if the voxel is the neighbourhood minimum, 0.0 otherwise.
+        IsMax,        // 1.0 if the voxel is the neighbourhood maximum, 0.0 otherwise.
+        IsMinNaN,     // NaN if the voxel is the neighbourhood minimum, unaltered otherwise.
+        IsMaxNaN,     // NaN if the voxel is the neighbourhood maximum, unaltered otherwise.
+    } reduction = Reduction::Median;
+
+    // The channel to consider. Negative values will use all channels.
+    int64_t channel = -1;
+
+    // An index of the images to edit, e.g., from Image_Array::get_voxel_grid_index(). Optional. The sliding histogram
+    // walks the rows of this grid; a missing or stale index is rebuilt from the images.
+    std::shared_ptr<const voxel_grid_index<float,double>> grid_index;
+
+    // Outgoing image description to imbue.
+    std::string description;
+
+};
+
+// Whether the image collection is suited to ComputeVolumetricRankFilter, i.e., whether it forms a regular grid with a
+// single image at each position. An index of the images can optionally be provided, as for the user data.
+bool Volumetric_Rank_Filter_Supported(planar_image_collection<float,double> &,
+                                      const std::shared_ptr<const voxel_grid_index<float,double>> &grid_index = nullptr);
+
+bool ComputeVolumetricRankFilter(planar_image_collection<float,double> &,
+                          std::list<std::reference_wrapper<planar_image_collection<float,double>>>,
+                          std::list<std::reference_wrapper<contour_collection<double>>>,
+                          std::any ud );
+
@@ -6,10 +6,13 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <iterator>
 #include <algorithm>
 #include <random>
 #include <ostream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include <cstdint>
 
 #include "YgorImages.h"
@@ -20,6 +23,8 @@
 
 #include "YgorClustering.hpp"
 #include "../../Thread_Pool.h"
+#include "../../Voxel_Volume.h"
+#include "../../Gaussian_Filter.h"
 #include "../Grouping/Misc_Functors.h"
 #include "../ConvenienceRoutines.h"
 #include "Volumetric_Neighbourhood_Sampler.h"
@@ -32,15 +37,20 @@ bool ComputeVolumetricSpatialBlur(planar_image_collection<float,double> &imageco
                       std::list<std::reference_wrapper<contour_collection<double>>> ccsl,
                       std::any user_data ){
 
-    // This routine computes 3D blurs. Currently, only Gaussians are supported. Specifically, a 1-sigma Gaussian (in
-    // pixel units, not DICOM units) with a fixed 3*sigma extent. This blur is separable and is thus applied in three
-    // directions successively. The spacing between adjacent voxels is not taken into account, so voxels should have
-    // isotropic dimensions (or the blur will be non-isotropic). The effective window considered by this Gaussian is
-    // 7x7x7 voxels. If voxels are inaccessible or non-finite they will be ignored and other voxels in the neighbourhood
-    // will be more heavily weighted.
+    // This routine computes 3D blurs. Currently, only Gaussians are supported. The 'Gaussian' estimator is a 1-sigma
+    // Gaussian (in pixel units, not DICOM units) with a fixed 3*sigma extent. The spacing between adjacent voxels is not
+    // taken into account, so voxels should have isotropic dimensions (or the blur will be non-isotropic). The effective
+    // window considered by this Gaussian is 7x7x7 voxels. The 'GaussianOpen' and 'GaussianRecursive' estimators use a
+    // user-specified sigma in DICOM units, so voxel spacing is taken into account. The former truncates at 3*sigma,
+    // and the latter uses a recursive approximation whose cost does not depend on sigma.
+    //
+    // All of these blurs are separable and are thus applied in three directions successively. If voxels are
+    // inaccessible or non-finite they will be ignored and other voxels in the neighbourhood will be more heavily
+    // weighted.
     //
     // Note: The provided image collection must be rectilinear. This requirement comes foremost from a limitation of the
-    // implementation. 
+    // implementation. Regular grids are blurred via a contiguous copy of the voxels, which is considerably faster.
+    // Only the 'Gaussian' estimator is supported for other rectilinear collections.
     //
 
     //We require a valid ComputeVolumetricSpatialBlurUserData struct packed into the user_data.
@@ -57,7 +67,119 @@ bool ComputeVolumetricSpatialBlur(planar_image_collection<float,double> &imageco
         return false;
     }
 
-    if(user_data_s->estimator == VolumetricSpatialBlurEstimator::Gaussian){
+    const auto estimator = user_data_s->estimator;
+    if( (estimator != VolumetricSpatialBlurEstimator::Gaussian)
+    &&  (estimator != VolumetricSpatialBlurEstimator::GaussianOpen)
+    &&  (estimator != VolumetricSpatialBlurEstimator::GaussianRecursive) ){
+        throw std::invalid_argument("Unrecognized user-provided estimator argument.");
+    }
+
+    const auto grid_ptr = Current_Voxel_Grid_Index(user_data_s->grid_index, imagecoll);
+    if(grid_ptr){
+        const auto &grid = *grid_ptr;
+
+        // Note: The following weights come from the 1D Gaussian with sigma=1 integrated over the length of each voxel.
+        const std::vector<double> fixed_weights = { 0.006, 0.061, 0.242, 0.382, 0.242, 0.061, 0.006 };
+        const auto make_filter = [&](const vec3<double> &step) -> gaussian_line_filter {
+            if(estimator == VolumetricSpatialBlurEstimator::Gaussian){
+                return gaussian_line_filter(fixed_weights);
+            }
+            const auto method = (estimator == VolumetricSpatialBlurEstimator::GaussianRecursive)
+                              ? gaussian_line_filter::method::Recursive
+                              : gaussian_line_filter::method::Explicit;
+            const auto spacing = step.length();
+            if(spacing <= 0.0) return gaussian_line_filter();
+            return gaussian_line_filter(user_data_s->gaussian_sigma / spacing, method);
+        };
+
+        const auto f_slices = make_filter(grid.slice_step);
+        const auto f_rows   = make_filter(grid.row_step);
+        const auto f_cols   = make_filter(grid.col_step);
+
+        // Identify the voxels within the ROIs. Only these voxels are altered.
+        Mutate_Voxels_Opts mv_opts;
+        mv_opts.editstyle      = Mutate_Voxels_Opts::EditStyle::InPlace;
+        mv_opts.inclusivity    = Mutate_Voxels_Opts::Inclusivity::Centre;
+        mv_opts.contouroverlap = Mutate_Voxels_Opts::ContourOverlap::Ignore;
+        mv_opts.aggregate      = Mutate_Voxels_Opts::Aggregate::First;
+        mv_opts.adjacency      = Mutate_Voxels_Opts::Adjacency::SingleVoxel;
+        mv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
+
+        const int64_t N_voxels = grid.frames * grid.slices * grid.rows * grid.cols;
+        std::vector<uint8_t> roi_mask(static_cast<size_t>(N_voxels), 0);
+        const auto mask_index = [&](int64_t f, int64_t z, int64_t row, int64_t col) -> size_t {
+            return static_cast<size_t>(((f * grid.slices + z) * grid.rows + row) * grid.cols + col);
+        };
+        {
+            work_queue<std::function<void(void)>> wq;
+            for(int64_t f = 0; f < grid.frames; ++f){
+                for(int64_t z = 0; z < grid.slices; ++z){
+                    wq.submit_task([&,f,z]() -> void {
+                        auto img_refw = std::ref(grid.image(f, z));
+                        auto f_bounded = [&](int64_t E_row, int64_t E_col, int64_t /*channel*/,
+                                             std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
+                                             std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
+                                             float &/*voxel_val*/) {
+                            roi_mask[mask_index(f, z, E_row, E_col)] = 1;
+                            return;
+                        };
+                        Mutate_Voxels<float,double>( img_refw, { img_refw }, ccsl, mv_opts, f_bounded );
+                    });
+                }
+            }
+        } // Wait for all tasks to complete.
+        const bool whole_volume = std::all_of(std::begin(roi_mask), std::end(roi_mask),
+                                              [](uint8_t m){ return (m != 0); });
+
+        auto vol = Marshal_To_Voxel_Volume<float>(grid);
+        if(whole_volume){
+            YLOGINFO("Convolving along all three directions now..");
+            Gaussian_Blur_Volume(vol, f_slices, f_rows, f_cols);
+
+        }else{
+            // Each pass only alters voxels within the ROIs, so voxels outside the ROIs contribute their original values
+            // to every pass.
+            const gaussian_line_filter identity;
+            const auto blur_within_rois = [&](const gaussian_line_filter &along_slices,
+                                              const gaussian_line_filter &along_rows,
+                                              const gaussian_line_filter &along_cols){
+                auto blurred = vol;
+                Gaussian_Blur_Volume(blurred, along_slices, along_rows, along_cols);
+                for(int64_t i = 0; i < N_voxels; ++i){
+                    if(roi_mask[static_cast<size_t>(i)] == 0) continue;
+                    const auto beg = static_cast<size_t>(i * vol.channels);
+                    std::copy( std::next(std::begin(blurred.data), beg),
+                               std::next(std::begin(blurred.data), beg + vol.channels),
+                               std::next(std::begin(vol.data), beg) );
+                }
+            };
+
+            YLOGINFO("Convolving row-aligned direction now..");
+            blur_within_rois(identity, f_rows, identity);
+            YLOGINFO("Convolving column-aligned direction now..");
+            blur_within_rois(identity, identity, f_cols);
+            YLOGINFO("Convolving ortho-aligned direction now..");
+            blur_within_rois(f_slices, identity, identity);
+        }
+
+        for(int64_t f = 0; f < grid.frames; ++f){
+            for(int64_t z = 0; z < grid.slices; ++z){
+                auto &img = grid.image(f, z);
+                for(int64_t row = 0; row < grid.rows; ++row){
+                    for(int64_t col = 0; col < grid.cols; ++col){
+                        if(roi_mask[mask_index(f, z, row, col)] == 0) continue;
+                        for(int64_t chnl = 0; chnl < vol.channels; ++chnl){
+                            if( (user_data_s->channel < 0)
+                            ||  (user_data_s->channel == chnl) ){
+                                img.reference(row, col, chnl) = vol.value(f, z, row, col, chnl);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    }else if(estimator == VolumetricSpatialBlurEstimator::Gaussian){
         auto f_reduce = [](float, std::vector<float> &shtl, vec3<double>) -> float {
                           double f = 0.0;
                           double w = 0.0;
@@ -171,21 +293,28 @@ bool ComputeVolumetricSpatialBlur(planar_image_collection<float,double> &imageco
         }
 
     }else{
-        throw std::invalid_argument("Unrecognized user-provided estimator argument.");
+        throw std::invalid_argument("Images do not form a regular grid. Only the fixed Gaussian estimator is supported.");
     }
 
 
     //Update the image metadata. 
     std::string img_desc;
-    if(user_data_s->estimator == VolumetricSpatialBlurEstimator::Gaussian){
+    if(estimator == VolumetricSpatialBlurEstimator::Gaussian){
+        img_desc += "volumetric Gaussian blurred";
+        img_desc += " (in pixel coord.s)";
+
+    }else if(estimator == VolumetricSpatialBlurEstimator::GaussianOpen){
         img_desc += "volumetric Gaussian blurred";
+        img_desc += " (sigma=" + std::to_string(user_data_s->gaussian_sigma) + ")";
+
+    }else if(estimator == VolumetricSpatialBlurEstimator::GaussianRecursive){
+        img_desc += "volumetric recursive Gaussian blurred";
+        img_desc += " (sigma=" + std::to_string(user_data_s->gaussian_sigma) + ")";
 
     }else{
         throw std::invalid_argument("Unrecognized user-provided estimator");
     }
 
-    img_desc += " (in pixel coord.s)";
-
     for(auto &img : imagecoll.images){
         UpdateImageDescription( std::ref(img), img_desc );
         UpdateImageWindowCentreWidth( std::ref(img) );
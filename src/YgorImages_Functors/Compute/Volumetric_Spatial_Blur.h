@@ -4,15 +4,19 @@
 #include <any>
 #include <functional>
 #include <list>
+#include <memory>
 #include <cstdint>
 
 
 template <class T, class R> class planar_image_collection;
+template <class T, class R> struct voxel_grid_index;
 template <class T> class contour_collection;
 
 typedef enum { // Controls which blur is computed.
 
-    Gaussian // Numerically-approximated Gaussian with fixed (3-sigma) extent.
+    Gaussian,          // Numerically-approximated Gaussian with fixed (3-sigma) extent.
+    GaussianOpen,      // Gaussian with user-specified sigma and fixed (3-sigma) extent.
+    GaussianRecursive  // Recursive approximation of a Gaussian with user-specified sigma.
 
 } VolumetricSpatialBlurEstimator;
 
@@ -20,6 +24,13 @@ struct ComputeVolumetricSpatialBlurUserData {
 
     VolumetricSpatialBlurEstimator estimator = VolumetricSpatialBlurEstimator::Gaussian;
 
+    // The Gaussian sigma, in DICOM units (mm). Only used for the GaussianOpen and GaussianRecursive estimators.
+    double gaussian_sigma = 1.0;
+
+    // An index of the images to blur, e.g., from Image_Array::get_voxel_grid_index(). Optional. The separable passes
+    // run along the rows, columns, and slices of this grid; a missing or stale index is rebuilt from the images.
+    std::shared_ptr<const voxel_grid_index<float,double>> grid_index;
+
     // The channel to analyze. If negative, all channels are analyzed.
     int64_t channel = -1;
 
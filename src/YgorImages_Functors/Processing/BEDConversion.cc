@@ -9,6 +9,7 @@
 #include <cstdint>
 
 #include "../../BED_Conversion.h"
+#include "../../Voxel_Kernels.h"
 #include "../ConvenienceRoutines.h"
 #include "BEDConversion.h"
 #include "YgorImages.h"
@@ -45,16 +46,10 @@ bool BEDConversion(planar_image_collection<float,double>::images_list_it_t first
         return false;
     }
 
-    Mutate_Voxels_Opts ebv_opts;
-    ebv_opts.editstyle      = Mutate_Voxels_Opts::EditStyle::InPlace;
-    ebv_opts.inclusivity    = Mutate_Voxels_Opts::Inclusivity::Centre;
-    ebv_opts.contouroverlap = Mutate_Voxels_Opts::ContourOverlap::Ignore;
-    ebv_opts.aggregate      = Mutate_Voxels_Opts::Aggregate::First;
-    ebv_opts.adjacency      = Mutate_Voxels_Opts::Adjacency::SingleVoxel;
-    ebv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
-
-    Mutate_Voxels_Functor<float,double> f_bounded;
-    Mutate_Voxels_Functor<float,double> f_unbounded;
+    // Kernels applied to runs of voxels (x, n, stride) that are bounded, or NOT bounded, by the contours. Voxels without
+    // dose are not altered.
+    std::function<void(float *, int64_t, int64_t)> k_bounded;
+    std::function<void(float *, int64_t, int64_t)> k_unbounded;
 
     if(user_data_s->model == BEDConversionUserData::Model::BEDSimpleLinearQuadratic){
         if(user_data_s->NumberOfFractions <= 0){
@@ -65,27 +60,16 @@ bool BEDConversion(planar_image_collection<float,double>::images_list_it_t first
             throw std::invalid_argument("AlphaBetaRatioLate not specified or invalid.");
         }
 
-        f_bounded = [=](int64_t /*row*/, int64_t /*col*/, int64_t /*channel*/,
-                        std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                        std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                        float &voxel_val) {
-            if(voxel_val <= 0.0) return; // No-op if there is no dose.
-
-            const auto D_voxel = voxel_val;
-            const auto BED = BEDabr_from_n_D_abr(user_data_s->NumberOfFractions, D_voxel, user_data_s->AlphaBetaRatioEarly).val;
-            voxel_val = BED;
+        // BED = D * (1 + (D/n)/abr), which is quadratic in D.
+        const auto n = user_data_s->NumberOfFractions;
+        const auto abr_early = user_data_s->AlphaBetaRatioEarly;
+        const auto abr_late = user_data_s->AlphaBetaRatioLate;
+        k_bounded = [=](float *x, int64_t N, int64_t stride) {
+            voxel_kernels::Linear_Quadratic(x, N, stride, 1.0, 1.0 / (n * abr_early));
             return;
         };
-
-        f_unbounded = [=](int64_t /*row*/, int64_t /*col*/, int64_t /*channel*/,
-                          std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                          std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                          float &voxel_val) {
-            if(voxel_val <= 0.0) return; // No-op if there is no dose.
-
-            const auto D_voxel = voxel_val;
-            const auto BED = BEDabr_from_n_D_abr(user_data_s->NumberOfFractions, D_voxel, user_data_s->AlphaBetaRatioLate).val;
-            voxel_val = BED;
+        k_unbounded = [=](float *x, int64_t N, int64_t stride) {
+            voxel_kernels::Linear_Quadratic(x, N, stride, 1.0, 1.0 / (n * abr_late));
             return;
         };
 
@@ -106,31 +90,17 @@ bool BEDConversion(planar_image_collection<float,double>::images_list_it_t first
             throw std::invalid_argument("AlphaBetaRatioLate not specified or invalid.");
         }
 
-        f_bounded = [=](int64_t /*row*/, int64_t /*col*/, int64_t /*channel*/,
-                        std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                        std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                        float &voxel_val) {
-            if(voxel_val <= 0.0) return; // No-op if there is no dose.
-
-            const auto D_voxel = voxel_val;
-            const auto numer = D_voxel * ( (D_voxel / user_data_s->NumberOfFractions) + user_data_s->AlphaBetaRatioEarly );
-            const auto denom = (user_data_s->TargetDosePerFraction + user_data_s->AlphaBetaRatioEarly );
-            const auto EQD = numer / denom;
-            voxel_val = EQD;
+        // EQD = D * ((D/n) + abr) / (d + abr), which is quadratic in D.
+        const auto n = user_data_s->NumberOfFractions;
+        const auto d = user_data_s->TargetDosePerFraction;
+        const auto abr_early = user_data_s->AlphaBetaRatioEarly;
+        const auto abr_late = user_data_s->AlphaBetaRatioLate;
+        k_bounded = [=](float *x, int64_t N, int64_t stride) {
+            voxel_kernels::Linear_Quadratic(x, N, stride, abr_early / (d + abr_early), 1.0 / (n * (d + abr_early)));
             return;
         };
-
-        f_unbounded = [=](int64_t /*row*/, int64_t /*col*/, int64_t /*channel*/,
-                          std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                          std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                          float &voxel_val) {
-            if(voxel_val <= 0.0) return; // No-op if there is no dose.
-
-            const auto D_voxel = voxel_val;
-            const auto numer = D_voxel * ( (D_voxel / user_data_s->NumberOfFractions) + user_data_s->AlphaBetaRatioLate );
-            const auto denom = (user_data_s->TargetDosePerFraction + user_data_s->AlphaBetaRatioLate );
-            const auto EQD = numer / denom;
-            voxel_val = EQD;
+        k_unbounded = [=](float *x, int64_t N, int64_t stride) {
+            voxel_kernels::Linear_Quadratic(x, N, stride, abr_late / (d + abr_late), 1.0 / (n * (d + abr_late)));
             return;
         };
 
@@ -171,33 +141,22 @@ bool BEDConversion(planar_image_collection<float,double>::images_list_it_t first
             EQD_n = EQD_D / user_data_s->TargetDosePerFraction;
         }
 
-        f_bounded = [=](int64_t /*row*/, int64_t /*col*/, int64_t /*channel*/,
-                        std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                        std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                        float &voxel_val) {
-            if(voxel_val <= 0.0) return; // No-op if there is no dose.
-
-            BEDabr BED_voxel;
-            BED_voxel = BEDabr_from_n_D_abr(user_data_s->NumberOfFractions,
-                                            voxel_val,
-                                            user_data_s->AlphaBetaRatioEarly);
-            voxel_val = D_from_n_BEDabr(EQD_n, BED_voxel);
-            return;
-        };
-
-        f_unbounded = [=](int64_t /*row*/, int64_t /*col*/, int64_t /*channel*/,
-                          std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                          std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                          float &voxel_val) {
-            if(voxel_val <= 0.0) return; // No-op if there is no dose.
-
-            BEDabr BED_voxel;
-            BED_voxel = BEDabr_from_n_D_abr(user_data_s->NumberOfFractions,
-                                            voxel_val,
-                                            user_data_s->AlphaBetaRatioLate);
-            voxel_val = D_from_n_BEDabr(EQD_n, BED_voxel);
-            return;
+        const auto pinned_lq = [=](double abr){
+            return [=](float *x, int64_t N, int64_t stride) {
+                voxel_kernels::Transform(x, N, stride, [=](float voxel_val) -> float {
+                    if(voxel_val <= 0.0) return voxel_val; // No-op if there is no dose.
+
+                    BEDabr BED_voxel;
+                    BED_voxel = BEDabr_from_n_D_abr(user_data_s->NumberOfFractions,
+                                                    voxel_val,
+                                                    abr);
+                    return static_cast<float>(D_from_n_BEDabr(EQD_n, BED_voxel));
+                });
+                return;
+            };
         };
+        k_bounded = pinned_lq(user_data_s->AlphaBetaRatioEarly);
+        k_unbounded = pinned_lq(user_data_s->AlphaBetaRatioLate);
 
         first_img_it->metadata["EQDx_PrescriptionDose"] = std::to_string(user_data_s->PrescriptionDose);
         first_img_it->metadata["EQDx_NumberOfFractions"] = std::to_string(user_data_s->NumberOfFractions);
@@ -212,15 +171,13 @@ bool BEDConversion(planar_image_collection<float,double>::images_list_it_t first
         throw std::invalid_argument("Model not specified or invalid.");
     }
 
-    std::list<std::reference_wrapper<planar_image<float,double>>> selected_imgs;
-    for(auto &img_it : selected_img_its) selected_imgs.push_back( std::ref(*img_it) );
-
-    Mutate_Voxels<float,double>( std::ref(*first_img_it),
-                                 selected_imgs, 
-                                 ccsl, 
-                                 ebv_opts, 
-                                 f_bounded,
-                                 f_unbounded );
+    const auto mask = Get_ROI_Span_Mask( *first_img_it, ccsl,
+                                         Mutate_Voxels_Opts::Inclusivity::Centre,
+                                         Mutate_Voxels_Opts::ContourOverlap::Ignore );
+    const auto &bounded = mask->spans;
+    const auto unbounded = Complement_Row_Spans( bounded, first_img_it->rows, first_img_it->columns );
+    voxel_kernels::For_Each_Span( *first_img_it, bounded, -1, k_bounded );
+    voxel_kernels::For_Each_Span( *first_img_it, unbounded, -1, k_unbounded );
 
     //Alter the first image's metadata to reflect that averaging has occurred. You might want to consider
     // a selective whitelist approach so that unique IDs are not duplicated accidentally.
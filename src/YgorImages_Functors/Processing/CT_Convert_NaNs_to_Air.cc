@@ -4,6 +4,7 @@
 #include <functional>
 #include <list>
 
+#include "../../Voxel_Kernels.h"
 #include "../ConvenienceRoutines.h"
 #include "YgorImages.h"
 #include "YgorMisc.h"
@@ -30,19 +31,13 @@ bool CTNaNsToAir(planar_image_collection<float,double>::images_list_it_t first_i
     //Record the min and max actual pixel values for windowing purposes.
     Stats::Running_MinMax<float> minmax_pixel;
 
-    //Loop over the rows, columns, channels, and finally selected_images in the time course.
-    for(auto row = 0; row < first_img_it->rows; ++row){
-        for(auto col = 0; col < first_img_it->columns; ++col){
-            for(auto chan = 0; chan < first_img_it->channels; ++chan){
-
-                const auto val = first_img_it->value(row, col, chan);
-                const auto newval = std::isfinite(val) ? val : -1024.0f;
-                first_img_it->reference(row, col, chan) = newval;
-                minmax_pixel.Digest(newval);
-
-            }//Loop over channels.
-        } //Loop over cols
-    } //Loop over rows
+    auto &data = first_img_it->data;
+    voxel_kernels::Replace_Non_Finite(data.data(), static_cast<int64_t>(data.size()), 1, -1024.0f);
+    const auto [min, max] = voxel_kernels::Min_Max(data.data(), static_cast<int64_t>(data.size()));
+    if(min <= max){
+        minmax_pixel.Digest(min);
+        minmax_pixel.Digest(max);
+    }
 
     UpdateImageDescription( std::ref(*first_img_it), "NaN Pixel Filtered" );
     UpdateImageWindowCentreWidth( std::ref(*first_img_it), minmax_pixel );
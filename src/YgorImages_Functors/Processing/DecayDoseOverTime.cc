@@ -7,6 +7,7 @@
 #include <cstdint>
 
 #include "../../BED_Conversion.h"
+#include "../../ROI_Span_Masks.h"
 #include "../ConvenienceRoutines.h"
 #include "DecayDoseOverTime.h"
 #include "YgorImages.h"
@@ -66,32 +67,10 @@ bool DecayDoseOverTime(planar_image_collection<float,double>::images_list_it_t f
                      2.8 + std::exp(0.139177 * (user_data_s->TemporalGapMonths - 12.0)) ;
     const double r_exp = 1.0 / (1.0 + r);
 
-    //Record the min and max (outgoing) pixel values for windowing purposes.
-    Mutate_Voxels_Opts ebv_opts;
-    ebv_opts.editstyle      = Mutate_Voxels_Opts::EditStyle::InPlace; // Note: the mask scheme below requires in-place in order to decay with a single pass.
-    ebv_opts.inclusivity    = Mutate_Voxels_Opts::Inclusivity::Inclusive;
-    ebv_opts.contouroverlap = Mutate_Voxels_Opts::ContourOverlap::HonourOppositeOrientations;
-    ebv_opts.aggregate      = Mutate_Voxels_Opts::Aggregate::Mean;
-    ebv_opts.adjacency      = Mutate_Voxels_Opts::Adjacency::SingleVoxel;
-    ebv_opts.maskmod        = Mutate_Voxels_Opts::MaskMod::Noop;
-
-    auto f_bounded = [=](int64_t row, int64_t col, int64_t channel,
-                         std::reference_wrapper<planar_image<float,double>> /*img_refw*/,
-                         std::reference_wrapper<planar_image<float,double>> /*mask_img_refw*/,
-                         float &voxel_val) {
-
-        // First, check if the mask is set for this voxel. If it is, do NOT re-process.
-        // It means the voxel has been processed in a previous decay operation (e.g., for another overlapping ROI) and
-        // should not be decayed again.
-        const auto mask_val = first_img_it->value(row, col, 1);
-        if(mask_val != 0.0) return;
-
-        // If the voxel is in the mask channel, disregard it.
-        if(channel == 1) return;
-
-        // Otherwise, perform the decay and then mark the mask.
+    // Decay the dose in a single voxel.
+    const auto decay = [=](float voxel_val) -> float {
         if(user_data_s->model == DecayDoseOverTimeMethod::Halve){
-            voxel_val *= 0.5;
+            return voxel_val * 0.5f;
 
         }else if(user_data_s->model == DecayDoseOverTimeMethod::Jones_and_Grant_2014){
             const auto BED_abr_c1 = BEDabr_from_n_D_abr(user_data_s->Course1NumberOfFractions, 
@@ -107,36 +86,31 @@ bool DecayDoseOverTime(planar_image_collection<float,double>::images_list_it_t f
 
                 const auto D_c1_eff = D_from_n_BEDabr(user_data_s->Course1NumberOfFractions,
                                                       BED_abr_c1_eff);
-                voxel_val = D_c1_eff;
-
-                //Debugging/validation:
-                //if( ((row == 0) && (col == 19)) || ( (row == 9) && (col == 9)) ){
-                //    YLOGINFO("BED_abr_tol    = " << BED_abr_tol.val);
-                //    YLOGINFO("r              = " << r);
-                //    YLOGINFO("r_exp          = " << r_exp);
-                //    YLOGINFO("Dincoming      = " << voxel_val);
-                //    YLOGINFO("BED_abr_c1     = " << BED_abr_c1.val);
-                //    YLOGINFO("BED_ratio      = " << BED_ratio);
-                //    YLOGINFO("BED_C1_eff     = " << BED_abr_c1_eff.val);
-                //    YLOGINFO("Doutgoing      = " << D_c1_eff);
-                //}
+                return static_cast<float>(D_c1_eff);
             }
-
-        }else{
-            throw std::logic_error("Provided an invalid model. Cannot continue.");
+            return voxel_val;
         }
-        first_img_it->reference(row, col, 1) = 1.0;
-        return;
+        throw std::logic_error("Provided an invalid model. Cannot continue.");
     };
 
-    std::list<std::reference_wrapper<planar_image<float,double>>> selected_imgs;
-    for(auto &img_it : selected_img_its) selected_imgs.push_back( std::ref(*img_it) );
-
-    Mutate_Voxels<float,double>( std::ref(*first_img_it),
-                                 selected_imgs, 
-                                 ccsl, 
-                                 ebv_opts, 
-                                 f_bounded );
+    // Voxels are visited in runs rather than individually. Channel 0 holds the dose and channel 1 holds the mask.
+    //
+    // First, check if the mask is set for each voxel. If it is, do NOT re-process.
+    // It means the voxel has been processed in a previous decay operation (e.g., for another overlapping ROI) and
+    // should not be decayed again. Otherwise, perform the decay and then mark the mask.
+    const auto mask = Get_ROI_Span_Mask( *first_img_it, ccsl,
+                                         Mutate_Voxels_Opts::Inclusivity::Inclusive,
+                                         Mutate_Voxels_Opts::ContourOverlap::HonourOppositeOrientations );
+    for(const auto &s : mask->spans){
+        for(int64_t col = s.col_begin; col < s.col_end; ++col){
+            float &mask_val = first_img_it->reference(s.row, col, 1);
+            if(mask_val != 0.0) continue;
+
+            float &voxel_val = first_img_it->reference(s.row, col, 0);
+            voxel_val = decay(voxel_val);
+            mask_val = 1.0;
+        }
+    }
 
     //Alter the first image's metadata to reflect that averaging has occurred. You might want to consider
     // a selective whitelist approach so that unique IDs are not duplicated accidentally.
@@ -5,7 +5,10 @@
 #include <list>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "../../Voxel_Volume.h"
+#include "../../Gaussian_Filter.h"
 #include "../ConvenienceRoutines.h"
 #include "In_Image_Plane_Blur.h"
 #include "YgorImages.h"
@@ -40,9 +43,24 @@ bool InPlaneImageBlur(
     //Record the min and max actual pixel values for windowing purposes.
     Stats::Running_MinMax<float> minmax_pixel;
 
-    //There is a dedicated function for non-fixed ("open") Gaussian blur.
-    if(user_data_s->estimator == BlurEstimator::gaussian_open){
-        working.Gaussian_Pixel_Blur({ }, user_data_s->gaussian_sigma);
+    //Non-fixed Gaussians are separable, so they are applied along rows and then columns.
+    if( (user_data_s->estimator == BlurEstimator::gaussian_open)
+    ||  (user_data_s->estimator == BlurEstimator::gaussian_recursive) ){
+        const auto method = (user_data_s->estimator == BlurEstimator::gaussian_recursive)
+                          ? gaussian_line_filter::method::Recursive
+                          : gaussian_line_filter::method::Explicit;
+        const gaussian_line_filter filter(user_data_s->gaussian_sigma, method);
+
+        voxel_volume<float> vol;
+        vol.frames = 1;
+        vol.slices = 1;
+        vol.rows = working.rows;
+        vol.cols = working.columns;
+        vol.channels = working.channels;
+        vol.data.resize(static_cast<size_t>(vol.frame_stride()));
+        copy_image_to_buffer(working, vol.data.data());
+        Gaussian_Blur_Slice(vol, 0, 0, filter, filter);
+        copy_buffer_to_image(vol.data.data(), working);
 
         //Loop over the rows, columns, and channels.
         for(auto row = 0; row < working.rows; ++row){
@@ -106,6 +124,11 @@ bool InPlaneImageBlur(
         img_desc += std::to_string(user_data_s->gaussian_sigma);
         img_desc += ")";
 
+    }else if(user_data_s->estimator == BlurEstimator::gaussian_recursive){
+        img_desc += "Gaussian blur (recursive; sigma=";
+        img_desc += std::to_string(user_data_s->gaussian_sigma);
+        img_desc += ")";
+
     }else{
         throw std::invalid_argument("Unrecognized user-provided blur estimator.");
     }
@@ -21,7 +21,8 @@ typedef enum { // Controls which estimator is used to approximate the blur opera
     gaussian_5x5,
 
     //Non-fixed (adaptive) estimators.
-    gaussian_open
+    gaussian_open,
+    gaussian_recursive
 
 } BlurEstimator;
 
@@ -30,7 +31,7 @@ struct InPlaneImageBlurUserData {
     BlurEstimator estimator = BlurEstimator::gaussian_open;
 
     //Parameters for non-fixed estimators.
-    double gaussian_sigma = 1.5; // sigma in pixel coordinates.
+    double gaussian_sigma = 1.5; // sigma in pixel coordinates. Used by gaussian_open and gaussian_recursive.
 
 };
 
@@ -6,6 +6,7 @@
 #include <list>
 #include <stdexcept>
 
+#include "../../Voxel_Kernels.h"
 #include "../ConvenienceRoutines.h"
 #include "YgorImages.h"
 #include "YgorStats.h"       //Needed for Stats:: namespace.
@@ -27,20 +28,14 @@ bool LogScalePixels(planar_image_collection<float,double>::images_list_it_t firs
     //Record the min and max (outgoing) pixel values for windowing purposes.
     Stats::Running_MinMax<float> minmax_pixel;
 
-    //Loop over the rows, columns, and channels.
-    for(auto row = 0; row < first_img_it->rows; ++row){
-        for(auto col = 0; col < first_img_it->columns; ++col){
-            for(auto chan = 0; chan < first_img_it->channels; ++chan){
-                const auto pixel_val = first_img_it->value(row, col, chan);
-                first_img_it->reference(row, col, chan) = std::numeric_limits<float>::quiet_NaN();
-                if(pixel_val > static_cast<float>(0)){
-                    const auto newval = std::log(pixel_val);
-                    first_img_it->reference(row, col, chan) = newval;
-                    minmax_pixel.Digest(newval);
-                }
-            }//Loop over channels.
-        } //Loop over cols
-    } //Loop over rows
+    //Non-positive voxels become NaN and are thus omitted from the min and max.
+    auto &data = first_img_it->data;
+    voxel_kernels::Log_Positive(data.data(), static_cast<int64_t>(data.size()));
+    const auto [min, max] = voxel_kernels::Min_Max(data.data(), static_cast<int64_t>(data.size()));
+    if(min <= max){
+        minmax_pixel.Digest(min);
+        minmax_pixel.Digest(max);
+    }
 
     UpdateImageDescription( std::ref(*first_img_it), "Log-Scaled" );
     UpdateImageWindowCentreWidth( std::ref(*first_img_it), minmax_pixel );
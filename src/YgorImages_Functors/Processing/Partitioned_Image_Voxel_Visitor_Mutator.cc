@@ -4,6 +4,7 @@
 #include <list>
 #include <stdexcept>
 
+#include "../../Voxel_Kernels.h"
 #include "../ConvenienceRoutines.h"
 #include "Partitioned_Image_Voxel_Visitor_Mutator.h"
 #include "YgorImages.h"
@@ -35,26 +36,48 @@ bool PartitionedImageVoxelVisitorMutator(planar_image_collection<float,double>::
         return false;
     }
     
-    if( !user_data_s->f_bounded
-    &&  !user_data_s->f_unbounded
-    &&  !user_data_s->f_visitor ){
+    const bool has_functors = user_data_s->f_bounded
+                           || user_data_s->f_unbounded
+                           || user_data_s->f_visitor;
+    const bool has_kernels = user_data_s->k_bounded
+                          || user_data_s->k_unbounded;
+    if(!has_functors && !has_kernels){
         throw std::invalid_argument("Nothing to do; no valid operation provided. Refusing to continue.");
     }
+    if(has_functors && has_kernels){
+        throw std::invalid_argument("Voxel functors and kernels cannot be combined. Refusing to continue.");
+    }
     
     if(ccsl.empty()){
         throw std::invalid_argument("No contours provided. Cannot continue");
     }
 
-    std::list<std::reference_wrapper<planar_image<float,double>>> selected_imgs;
-    for(auto &img_it : selected_img_its) selected_imgs.push_back( std::ref(*img_it) );
-
-    Mutate_Voxels<float,double>( std::ref(*first_img_it),
-                                 selected_imgs, 
-                                 ccsl, 
-                                 user_data_s->mutation_opts, 
-                                 user_data_s->f_bounded,
-                                 user_data_s->f_unbounded,
-                                 user_data_s->f_visitor );
+    if(has_kernels){
+        // Determine which voxels are bounded once, and then apply the kernels to whole runs of voxels.
+        const auto mask = Get_ROI_Span_Mask( *first_img_it, ccsl,
+                                             user_data_s->mutation_opts.inclusivity,
+                                             user_data_s->mutation_opts.contouroverlap );
+        const auto &bounded = mask->spans;
+        if(user_data_s->k_bounded){
+            voxel_kernels::For_Each_Span( *first_img_it, bounded, user_data_s->kernel_channel, user_data_s->k_bounded );
+        }
+        if(user_data_s->k_unbounded){
+            const auto unbounded = Complement_Row_Spans(bounded, first_img_it->rows, first_img_it->columns);
+            voxel_kernels::For_Each_Span( *first_img_it, unbounded, user_data_s->kernel_channel, user_data_s->k_unbounded );
+        }
+
+    }else{
+        std::list<std::reference_wrapper<planar_image<float,double>>> selected_imgs;
+        for(auto &img_it : selected_img_its) selected_imgs.push_back( std::ref(*img_it) );
+
+        Mutate_Voxels<float,double>( std::ref(*first_img_it),
+                                     selected_imgs, 
+                                     ccsl, 
+                                     user_data_s->mutation_opts, 
+                                     user_data_s->f_bounded,
+                                     user_data_s->f_unbounded,
+                                     user_data_s->f_visitor );
+    }
 
 
     //Alter the first image's metadata to reflect that averaging has occurred. You might want to consider
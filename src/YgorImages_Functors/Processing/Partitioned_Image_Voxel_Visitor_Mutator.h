@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <any>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <list>
@@ -26,6 +27,12 @@ struct PartitionedImageVoxelVisitorMutatorUserData {
     Mutate_Voxels_Functor<float,double> f_bounded;   // Applied to voxels bounded by contours.
     Mutate_Voxels_Functor<float,double> f_unbounded; // Applied to voxels NOT bounded by contours.
     Mutate_Voxels_Functor<float,double> f_visitor;   // Applied to all voxels.
+
+    // Kernels applied to runs of voxels, e.g., from voxel_kernels. These avoid per-voxel callbacks, but cannot be
+    // combined with the functors above. Only the inclusivity and contour overlap mutation options are honoured.
+    std::function<void(float *, int64_t, int64_t)> k_bounded;   // Applied to (x, n, stride) bounded by contours.
+    std::function<void(float *, int64_t, int64_t)> k_unbounded; // Applied to (x, n, stride) NOT bounded by contours.
+    int64_t kernel_channel = -1; // The channel kernels are applied to. Negative values apply to all channels.
     
     std::string description; // If non-empty, used to update image metadata.
 };